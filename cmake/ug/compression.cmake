@@ -0,0 +1,58 @@
+# Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+# Author: Stephan Grein
+# 
+# This file is part of UG4.
+# 
+# UG4 is free software: you can redistribute it and/or modify it under the
+# terms of the GNU Lesser General Public License version 3 (as published by the
+# Free Software Foundation) with the following additional attribution
+# requirements (according to LGPL/GPL v3 §7):
+# 
+# (1) The following notice must be displayed in the Appropriate Legal Notices
+# of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+# 
+# (2) The following notice must be displayed at a prominent place in the
+# terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+# 
+# (3) The following bibliography is recommended for citation and must be
+# preserved in all covered files:
+# "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+#   parallel geometric multigrid solver on hierarchically distributed grids.
+#   Computing and visualization in science 16, 4 (2013), 151-164"
+# "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+#   flexible software system for simulating pde based models on high performance
+#   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+# 
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+
+# included from ug_includes.cmake
+########################################
+# ZLIB and ZSTD
+# used to read compressed grid files, e.g. .ugx.gz or .ugx.zst
+if(USE_ZLIB)
+	find_package(ZLIB)
+	if(ZLIB_FOUND)
+		MESSAGE(STATUS "Info: Using zlib (${ZLIB_LIBRARIES})")
+		add_definitions(-DUG_ZLIB)
+		include_directories(${ZLIB_INCLUDE_DIRS})
+		set(linkLibraries ${linkLibraries} ${ZLIB_LIBRARIES})
+	else(ZLIB_FOUND)
+		message(FATAL_ERROR "ERROR: USE_ZLIB is enabled, but zlib couldn't be found.")
+	endif(ZLIB_FOUND)
+endif(USE_ZLIB)
+
+if(USE_ZSTD)
+	find_path(ZSTD_INCLUDE_DIR NAMES zstd.h)
+	find_library(ZSTD_LIBRARIES NAMES zstd)
+	if(ZSTD_INCLUDE_DIR AND ZSTD_LIBRARIES)
+		MESSAGE(STATUS "Info: Using zstd (${ZSTD_LIBRARIES})")
+		add_definitions(-DUG_ZSTD)
+		include_directories(${ZSTD_INCLUDE_DIR})
+		set(linkLibraries ${linkLibraries} ${ZSTD_LIBRARIES})
+	else(ZSTD_INCLUDE_DIR AND ZSTD_LIBRARIES)
+		message(FATAL_ERROR "ERROR: USE_ZSTD is enabled, but zstd couldn't be found.")
+	endif(ZSTD_INCLUDE_DIR AND ZSTD_LIBRARIES)
+endif(USE_ZSTD)
@@ -185,6 +185,8 @@ option(POSIX "If enabled and available, some additional functionality may be ava
 option(CRS_ALGEBRA "Use the CRS Sparse Matrix" OFF)
 option(CPU_ALGEBRA "Use the old CPU Sparse Matrix" ON)
 option(INTERNAL_MEMTRACKER "Internal Memory Tracker" OFF)
+option(USE_ZLIB "Enables reading of gzip compressed grid files. Valid options are ON, OFF" OFF)
+option(USE_ZSTD "Enables reading of zstd compressed grid files. Valid options are ON, OFF" OFF)
 
 if(APPLE)
 	option(USE_LUA2C "Use LUA2C" ON)
@@ -272,6 +274,8 @@ message(STATUS "Info: EMBEDDED_PLUGINS   ${EMBEDDED_PLUGINS} (options are: ON, O
 message(STATUS "Info: COMPILE_INFO       ${COMPILE_INFO} (options are: ON, OFF)")
 message(STATUS "Info: USE_LUA2C          ${USE_LUA2C} (options are: ON, OFF)")
 message(STATUS "Info: USE_LUAJIT         ${USE_LUAJIT} (options are: ON, OFF)")
+message(STATUS "Info: USE_ZLIB           ${USE_ZLIB} (options are: ON, OFF)")
+message(STATUS "Info: USE_ZSTD           ${USE_ZSTD} (options are: ON, OFF)")
 message(STATUS "")
 message(STATUS "Info: External libraries (path which contains the library or ON if you used uginstall):")
 message(STATUS "Info: TETGEN:   ${TETGEN}")
@@ -433,6 +437,8 @@ include(${UG_ROOT_CMAKE_PATH}/ug/lua2c.cmake)
 include(${UG_ROOT_CMAKE_PATH}/ug/luajit.cmake)
 # JSON
 include(${UG_ROOT_CMAKE_PATH}/ug/json.cmake)
+# ZLIB, ZSTD
+include(${UG_ROOT_CMAKE_PATH}/ug/compression.cmake)
 
 ########################################
 # buildAlgebra
@@ -524,6 +530,9 @@ endif(buildCompileInfo)
 ########################################
 if(POSIX)
 	add_definitions(-DUG_POSIX)
+#	used e.g. by the background writer of checkpoints
+	find_package(Threads)
+	set(linkLibraries ${linkLibraries} ${CMAKE_THREAD_LIBS_INIT})
 endif(POSIX)
 
 ########################################
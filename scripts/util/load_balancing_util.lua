@@ -129,7 +129,7 @@ function balancer.ParseParameters()
 	balancer.staticProcHierarchy = balancer.staticProcHierarchy or util.HasParamOption("-staticProcHierarchy")
 	
 	balancer.partitioner		= util.GetParam("-partitioner", balancer.partitioner,
-									"Options: parmetis, bisection, dynBisection. The partitioner which will be used during repartitioning.")
+									"Options: parmetis, bisection, dynBisection, sfc, multilevel. The partitioner which will be used during repartitioning.")
 									
 	balancer.parametersParsed = true
 end
@@ -201,6 +201,21 @@ function balancer.CreateLoadBalancer(domain)
 		elseif(balancer.partitioner == "dynBisection") then
 			partitioner = Partitioner_DynamicBisection(domain)
 			partitioner:set_verbose(false)
+		elseif(balancer.partitioner == "sfc") then
+			partitioner = Partitioner_SFC(domain)
+			if balancer.balanceWeights ~= nil then
+				partitioner:set_balance_weights(balancer.balanceWeights)
+			end
+			partitioner:set_verbose(false)
+		elseif(balancer.partitioner == "multilevel") then
+			partitioner = Partitioner_Multilevel(domain)
+			if balancer.balanceWeights ~= nil then
+				partitioner:set_balance_weights(balancer.balanceWeights)
+			end
+			if balancer.communicationWeights ~= nil then
+				partitioner:set_communication_weights(balancer.communicationWeights)
+			end
+			partitioner:set_verbose(false)
 		else
 			print("ERROR: Unknown partitioner specified in balancer.CreateLoadBalancer")
 			exit()
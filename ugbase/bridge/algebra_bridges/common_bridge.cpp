@@ -63,6 +63,8 @@
 #include "matrix_diagonal.h"
 
 #include "lib_algebra/operator/energy_convergence_check.h"
+#include "lib_algebra/algebra_common/block_kernel_benchmark.h"
+#include "lib_algebra/operator/linear_solver/block_solver_benchmark.h"
 
 using namespace std;
 
@@ -497,6 +499,23 @@ static void Common(Registry& reg, string grp)
 			.add_method("compose_file_path", &T::leave_section)
 			.set_construct_as_smart_pointer(true);
 	}
+
+//	block kernel benchmark
+	{
+		reg.add_function("BenchmarkBlockKernels",
+				static_cast<void (*)(int, size_t, size_t)>(&BenchmarkBlockKernels), grp,
+				"", "blockSize#gridSize#numReps",
+				"compares SpMV, Jacobi, Gauss-Seidel and ILU kernels of CPUBlockAlgebra<blockSize> "
+				"(blockSize = 2, 3, 4 or 6) with CPUAlgebra on a coupled gridSize^2 system");
+	}
+
+//	multiple right-hand side solver benchmark
+	{
+		reg.add_function("BenchmarkMultiRHSSolvers", &BenchmarkMultiRHSSolvers, grp,
+				"", "gridSize#numRHS#restart",
+				"compares separate CG and GMRES solves with BlockCG and BlockGMRES "
+				"for numRHS right-hand sides of a 2d Laplacian on a gridSize^2 grid");
+	}
 }
 
 }; // end Functionality
@@ -169,6 +169,25 @@ static void Algebra(Registry& reg, string grp)
 		reg.add_class_to_group(name, "Jacobi", tag);
 	}
 
+//	Chebyshev
+	{
+		typedef Chebyshev<TAlgebra> T;
+		typedef IPreconditioner<TAlgebra> TBase;
+		string name = string("Chebyshev").append(suffix);
+		reg.add_class_<T,TBase>(name, grp, "Chebyshev polynomial smoother (Jacobi preconditioned)")
+			.add_constructor()
+			.template add_constructor<void (*)(int)>("degree")
+			.add_method("set_degree", &T::set_degree, "", "degree", "sets the degree of the Chebyshev polynomial (default 3)")
+			.add_method("set_eigenvalue_ratio", &T::set_eigenvalue_ratio, "", "ratio", "sets lambda_max/lambda_min of the smoothed spectral interval (default 30)")
+			.add_method("set_safety_factor", &T::set_safety_factor, "", "safety", "sets the factor the estimated largest eigenvalue is multiplied with (default 1.1)")
+			.add_method("set_power_iterations", &T::set_power_iterations, "", "numIter", "sets the number of power iterations for the eigenvalue estimate (default 10)")
+			.add_method("set_max_eigenvalue", &T::set_max_eigenvalue, "", "lambdaMax", "sets the largest eigenvalue of D^{-1}A, disables the estimation")
+			.add_method("max_eigenvalue", &T::max_eigenvalue, "lambdaMax", "", "returns the largest eigenvalue of D^{-1}A used")
+			.add_method("set_block", &T::set_block, "", "block", "if true, use block diagonal (default), else scalar diagonal")
+			.set_construct_as_smart_pointer(true);
+		reg.add_class_to_group(name, "Chebyshev", tag);
+	}
+
 //	GaussSeidelBase
 	{
 		typedef GaussSeidelBase<TAlgebra> T;
@@ -248,10 +267,28 @@ static void Algebra(Registry& reg, string grp)
 						"set whether preprocessing (notably, LU factorization) is to be disabled - usable when the operator has not changed; use with care")
 			.add_method("enable_consistent_interfaces", &T::enable_consistent_interfaces, "", "enable", "Make Matrix consistent for connections in interfaces.")
 			.add_method("enable_overlap", &T::enable_overlap, "", "enable", "Enables matrix overlap. This also means that interfaces are consistent.")
+			.add_method("set_fill_level", &T::set_fill_level, "", "p", "sets the level of fill-in, i.e. ILU(p). default 0")
 			.set_construct_as_smart_pointer(true);
 		reg.add_class_to_group(name, "ILU", tag);
 	}
 
+//	Overlapping Schwarz
+	{
+		typedef OverlappingSchwarz<TAlgebra> T;
+		typedef IPreconditioner<TAlgebra> TBase;
+		string name = string("OverlappingSchwarz").append(suffix);
+		reg.add_class_<T,TBase>(name, grp, "Overlapping (restricted) additive Schwarz with ILU(p) subdomain solves")
+			.add_constructor()
+			.add_method("set_num_subdomains", &T::set_num_subdomains, "", "num", "number of subdomains per process, solved in parallel with OpenMP")
+			.add_method("set_overlap", &T::set_overlap, "", "numLayers", "number of layers of overlap between subdomains. default 1")
+			.add_method("set_restricted", &T::set_restricted, "", "bRestricted", "restricted additive Schwarz (true, default) or additive Schwarz")
+			.add_method("set_fill_level", &T::set_fill_level, "", "p", "sets the level of fill-in of the subdomain ILU(p). default 0")
+			.add_method("set_sort_eps", &T::set_sort_eps, "", "eps")
+			.add_method("set_inversion_eps", &T::set_inversion_eps, "", "eps")
+			.set_construct_as_smart_pointer(true);
+		reg.add_class_to_group(name, "OverlappingSchwarz", tag);
+	}
+
 //	ILU Threshold
 	{
 		typedef ILUTPreconditioner<TAlgebra> T;
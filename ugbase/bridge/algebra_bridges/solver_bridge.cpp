@@ -47,8 +47,12 @@
 #include "lib_algebra/operator/linear_solver/auto_linear_solver.h"
 #include "lib_algebra/operator/linear_solver/analyzing_solver.h"
 #include "lib_algebra/operator/linear_solver/cg.h"
+#include "lib_algebra/operator/linear_solver/deflated_cg.h"
 #include "lib_algebra/operator/linear_solver/bicgstab.h"
 #include "lib_algebra/operator/linear_solver/gmres.h"
+#include "lib_algebra/operator/linear_solver/gcrodr.h"
+#include "lib_algebra/operator/linear_solver/block_cg.h"
+#include "lib_algebra/operator/linear_solver/block_gmres.h"
 #include "lib_algebra/operator/linear_solver/lu.h"
 #include "lib_algebra/operator/linear_solver/agglomerating_solver.h"
 #include "lib_algebra/operator/linear_solver/debug_iterator.h"
@@ -217,6 +221,26 @@ static void Algebra(Registry& reg, string grp)
 		reg.add_class_to_group(name, "CG", tag);
 	}
 
+	// 	Deflated CG Solver
+	{
+		typedef DeflatedCG<vector_type> T;
+		typedef IPreconditionedLinearOperatorInverse<vector_type> TBase;
+		string name = string("DeflatedCG").append(suffix);
+		reg.add_class_<T,TBase>(name, grp, "Deflated Conjugate Gradient Solver, recycling Ritz vectors for sequences of systems")
+			.add_constructor()
+			. ADD_CONSTRUCTOR( (SmartPtr<ILinearIterator<vector_type,vector_type> > ) )("precond")
+			. ADD_CONSTRUCTOR( (SmartPtr<ILinearIterator<vector_type,vector_type> >, SmartPtr<IConvergenceCheck<vector_type> >) )("precond#convCheck")
+			.add_method("set_num_deflation_vectors", &T::set_num_deflation_vectors, "", "k", "sets the maximal number of deflation vectors kept between solves")
+			.add_method("set_num_stored_directions", &T::set_num_stored_directions, "", "l", "sets the number of search directions stored per solve")
+			.add_method("set_update_deflation_space", &T::set_update_deflation_space, "", "bUpdate", "if false, the deflation space is frozen")
+			.add_method("clear_deflation_space", &T::clear_deflation_space)
+			.add_method("num_deflation_vectors", &T::num_deflation_vectors)
+			.add_method("add_postprocess_corr", &T::add_postprocess_corr, "adds a postprocess of the corrections", "op")
+			.add_method("remove_postprocess_corr", &T::remove_postprocess_corr, "removes a postprocess of the corrections", "op")
+			.set_construct_as_smart_pointer(true);
+		reg.add_class_to_group(name, "DeflatedCG", tag);
+	}
+
 // 	BiCGStab Solver
 	{
 		typedef BiCGStab<vector_type> T;
@@ -247,6 +271,70 @@ static void Algebra(Registry& reg, string grp)
 		reg.add_class_to_group(name, "GMRES", tag);
 	}
 
+// 	GCRODR Solver
+	{
+		typedef GCRODR<vector_type> T;
+		typedef IPreconditionedLinearOperatorInverse<vector_type> TBase;
+		string name = string("GCRODR").append(suffix);
+		reg.add_class_<T,TBase>(name, grp, "GCRO-DR Solver, GMRES recycling harmonic Ritz vectors for sequences of systems")
+			.ADD_CONSTRUCTOR( (size_t restart, size_t numRecycle) )("restart#numRecycle")
+			.add_method("set_update_recycle_space", &T::set_update_recycle_space, "", "bUpdate", "if false, the recycle space is frozen")
+			.add_method("clear_recycle_space", &T::clear_recycle_space)
+			.add_method("num_recycle_vectors", &T::num_recycle_vectors)
+			.add_method("add_postprocess_corr", &T::add_postprocess_corr, "adds a postprocess of the corrections", "op")
+			.add_method("remove_postprocess_corr", &T::remove_postprocess_corr, "removes a postprocess of the corrections", "op")
+			.set_construct_as_smart_pointer(true);
+		reg.add_class_to_group(name, "GCRODR", tag);
+	}
+
+//	MultiVector
+	{
+		typedef MultiVector<vector_type> T;
+		string name = string("MultiVector").append(suffix);
+		reg.add_class_<T>(name, grp, "Set of vectors, e.g. several right-hand sides")
+			.add_constructor()
+			.add_method("push_back", &T::push_back, "", "vector", "adds a vector (no copy)")
+			.add_method("clear", &T::clear)
+			.add_method("num_vectors", &T::num_vectors)
+			.add_method("vec", &T::vec, "vector", "index")
+			.set_construct_as_smart_pointer(true);
+		reg.add_class_to_group(name, "MultiVector", tag);
+	}
+
+// 	Block CG Solver
+	{
+		typedef BlockCG<TAlgebra> T;
+		string name = string("BlockCG").append(suffix);
+		reg.add_class_<T>(name, grp, "Block Conjugate Gradient Solver for several right-hand sides")
+			.add_constructor()
+			. ADD_CONSTRUCTOR( (SmartPtr<ILinearIterator<vector_type,vector_type> >, SmartPtr<IConvergenceCheck<vector_type> >) )("precond#convCheck")
+			.add_method("set_preconditioner", &T::set_preconditioner, "", "precond")
+			.add_method("set_convergence_check", &T::set_convergence_check, "", "convCheck", "the convergence check is cloned for every right-hand side")
+			.add_method("init", &T::init, "success", "A")
+			.add_method("apply", &T::apply, "success", "X#B", "solves A*X = B")
+			.add_method("step", &T::step)
+			.add_method("config_string", &T::config_string)
+			.set_construct_as_smart_pointer(true);
+		reg.add_class_to_group(name, "BlockCG", tag);
+	}
+
+// 	Block GMRES Solver
+	{
+		typedef BlockGMRES<TAlgebra> T;
+		string name = string("BlockGMRES").append(suffix);
+		reg.add_class_<T>(name, grp, "Block GMRES Solver for several right-hand sides")
+			.ADD_CONSTRUCTOR( (size_t restart) )("restart")
+			. ADD_CONSTRUCTOR( (size_t restart, SmartPtr<ILinearIterator<vector_type,vector_type> >, SmartPtr<IConvergenceCheck<vector_type> >) )("restart#precond#convCheck")
+			.add_method("set_preconditioner", &T::set_preconditioner, "", "precond")
+			.add_method("set_convergence_check", &T::set_convergence_check, "", "convCheck", "the convergence check is cloned for every right-hand side")
+			.add_method("init", &T::init, "success", "A")
+			.add_method("apply", &T::apply, "success", "X#B", "solves A*X = B")
+			.add_method("step", &T::step)
+			.add_method("config_string", &T::config_string)
+			.set_construct_as_smart_pointer(true);
+		reg.add_class_to_group(name, "BlockGMRES", tag);
+	}
+
 // 	LU Solver
 	{
 		typedef LU<TAlgebra> T;
@@ -61,6 +61,7 @@
 #include "lib_disc/operator/non_linear_operator/nl_jacobi/nl_jacobi.h"
 #include "lib_disc/operator/composite_conv_check.h"
 #include "lib_disc/spatial_disc/local_to_global/local_to_global_mapper.h"
+#include "lib_disc/spatial_disc/implicit_level_assemble.h"
 
 using namespace std;
 
@@ -607,6 +608,24 @@ static void Common(Registry& reg, string parentGroup)
 		string name = string("INewtonUpdate");
 		reg.add_class_<T>(name, grp);
 	}
+
+#ifdef UG_CPU_1
+//	assembling on virtual levels (one unknown per vertex)
+	{
+		std::string grp = parentGroup; grp.append("/Discretization");
+		typedef CPUAlgebra::matrix_type matrix_type;
+		typedef CPUAlgebra::vector_type vector_type;
+		reg.add_function("AssembleDiffusionOnImplicitLevel",
+						 static_cast<void (*)(matrix_type&, vector_type&, const ImplicitUniformRefinement&, int, number, number, number)>(
+							 &ug::AssembleDiffusionOnImplicitLevel<CPUAlgebra>), grp,
+						 "", "A#b#implicitRefinement#lvl#diffusion#reaction#source",
+						 "assembles a linear diffusion-reaction problem on a virtual level");
+		reg.add_function("SaveImplicitLevelVectorToVTU",
+						 &ug::SaveImplicitLevelVectorToVTU<vector_type>, grp,
+						 "success", "filename#implicitRefinement#lvl#u#name",
+						 "writes a virtual level with per vertex data to a vtu file");
+	}
+#endif
 }
 
 }; // end Functionality
@@ -509,6 +509,8 @@ static void Domain(Registry& reg, string grp)
 			.add_method("domain", static_cast<SmartPtr<TDomain> (T::*)()>(&T::domain))
 			.add_method("surface_view", static_cast<ConstSmartPtr<SurfaceView> (T::*)() const>(&T::surface_view))
 			.add_method("get_dim", &T::get_dim)
+			.add_method("set_sfc_order", &T::set_sfc_order, "", "type|selection|value=[\"hilbert\",\"morton\",\"none\"]",
+						"Orders the dofs along a space filling curve, also after each grid change")
 			.set_construct_as_smart_pointer(true);
 		reg.add_class_to_group(name, "ApproximationSpace", tag);
 	}
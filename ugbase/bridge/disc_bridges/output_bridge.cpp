@@ -47,6 +47,7 @@
 
 #include "lib_disc/io/vtkoutput.h"
 #include "lib_disc/io/vtk_export_ho.h"
+#include "lib_disc/io/checkpoint.h"
 #include "common/profiler/profiler.h"
 
 #include "../util_overloaded.h"
@@ -156,6 +157,8 @@ static void DomainAlgebra(Registry& reg, string grp)
 			.add_method("set_conn_viewer_output", &T::set_conn_viewer_output, "", "bCVOutput")
 			.add_method("set_conn_viewer_indices", &T::set_conn_viewer_indices, "", "bIndicesOutput")
 			.add_method("set_print_consistent",  &T::set_print_consistent, "", "printConsistent")
+			.add_method("set_vtk_async", &T::set_vtk_async, "", "queueDepth", "number of vtk files written in the background (0: synchronous output)")
+			.add_method("wait_vtk_output", &T::wait_vtk_output)
 		    .add_method("set_grid_level", &T::set_grid_level, "Sets the grid level", "GridLevel")
 			.set_construct_as_smart_pointer(true);
 		reg.add_class_to_group(name, "GridFunctionDebugWriter", tag);
@@ -241,6 +244,71 @@ static void DomainAlgebra(Registry& reg, string grp)
 		reg.add_function("SaveVectorCSV",
 						 &SaveVectorCSV<function_type>, grp, "", "b#filename|save-dialog");
 	}
+
+//	Checkpoints
+	{
+		typedef CheckpointWriter<TDomain> T;
+		reg.get_class_<T>()
+			.add_method("add", &T::template add<function_type>, "", "name#gridFunction",
+						"adds a snapshot of the grid function to the current checkpoint");
+	}
+	{
+		typedef CheckpointReader<TDomain> T;
+		reg.get_class_<T>()
+			.add_method("read", &T::template read<function_type>, "", "name#gridFunction",
+						"restores the values of the grid function from the checkpoint");
+	}
+}
+
+/**
+ * Function called for the registration of Domain dependent parts.
+ * All Functions and Classes depending on the Domain
+ * are to be placed here when registering. The method is called for all
+ * available Domain types, based on the current build options.
+ *
+ * @param reg				registry
+ * @param parentGroup		group for sorting of functionality
+ */
+template <typename TDomain>
+static void Domain(Registry& reg, string grp)
+{
+	string suffix = GetDomainSuffix<TDomain>();
+	string tag = GetDomainTag<TDomain>();
+
+//	CheckpointWriter
+	{
+		typedef CheckpointWriter<TDomain> T;
+		string name = string("CheckpointWriter").append(suffix);
+		reg.add_class_<T>(name, grp)
+			.template add_constructor<void (*)(SmartPtr<TDomain>)>("domain")
+			.add_method("set_compression", &T::set_compression, "", "method",
+						"sets the compression method: none, zlib or zstd")
+			.add_method("set_compression_level", &T::set_compression_level, "", "level")
+			.add_method("begin_checkpoint", &T::begin_checkpoint, "", "filename",
+						"takes a snapshot of the domain")
+			.add_method("add_number", &T::add_number, "", "name#value")
+			.add_method("end_checkpoint", &T::end_checkpoint, "", "",
+						"writes the checkpoint on a background thread")
+			.add_method("wait", &T::wait, "", "",
+						"blocks until the last checkpoint has been written")
+			.set_construct_as_smart_pointer(true);
+		reg.add_class_to_group(name, "CheckpointWriter", tag);
+	}
+
+//	CheckpointReader
+	{
+		typedef CheckpointReader<TDomain> T;
+		string name = string("CheckpointReader").append(suffix);
+		reg.add_class_<T>(name, grp)
+			.template add_constructor<void (*)(SmartPtr<TDomain>)>("domain")
+			.add_method("read_domain", &T::read_domain, "", "filename",
+						"restores the domain from a checkpoint written on the same number of processes")
+			.add_method("has_grid_function", &T::has_grid_function, "", "name")
+			.add_method("has_number", &T::has_number, "", "name")
+			.add_method("read_number", &T::read_number, "", "name")
+			.set_construct_as_smart_pointer(true);
+		reg.add_class_to_group(name, "CheckpointReader", tag);
+	}
 }
 
 /**
@@ -287,6 +355,12 @@ static void Dimension(Registry& reg, string grp)
 			.add_method("set_write_grid", static_cast<void (T::*)(bool)>(&T::set_write_grid))
 			.add_method("set_write_subset_indices", static_cast<void (T::*)(bool)>(&T::set_write_subset_indices))
 			.add_method("set_write_proc_ranks", static_cast<void (T::*)(bool)>(&T::set_write_proc_ranks))
+			.add_method("set_aggregation", &T::set_aggregation, "", "numProcsPerFile", "number of processes whose pieces are written to one common vtu file")
+			.add_method("set_compression", &T::set_compression, "", "method", "compression of binary data: 'none' or 'zlib'")
+			.add_method("set_compression_level", &T::set_compression_level, "", "level")
+			.add_method("set_reuse_grid", &T::set_reuse_grid, "", "bReuse", "if true, time steps are written as XDMF time series which stores the grid only when it changed")
+			.add_method("set_async", &T::set_async, "", "queueDepth", "number of vtu files written in the background (0: synchronous output)")
+			.add_method("wait", &T::wait)
 			.set_construct_as_smart_pointer(true);
 		reg.add_class_to_group(name, "VTKOutput", tag);
 	}
@@ -329,6 +403,7 @@ void RegisterBridge_Output(Registry& reg, string grp)
 	try{
 		RegisterCommon<Functionality>(reg,grp);
 		RegisterDimensionDependent<Functionality>(reg,grp);
+		RegisterDomainDependent<Functionality>(reg,grp);
 		RegisterDomainAlgebraDependent<Functionality>(reg,grp);
 	}
 	UG_REGISTRY_CATCH_THROW(grp);
@@ -462,6 +462,11 @@ static void Domain(Registry& reg, string grp)
 					"", "Domain # Filename # procID | load-dialog | endings=[\"ugx\"]; description=\"*.ugx-Files\" # Number Refinements",
 					"Loads a domain", "No help");
 
+//	LoadAndDistributeDomain
+	reg.add_function("LoadAndDistributeDomain", &LoadAndDistributeDomain<TDomain>, grp,
+					"", "Domain # Filename | load-dialog | endings=[\"ugb\"]; description=\"*.ugb-Files\"",
+					"Loads a domain from a ugb file in parallel and distributes it onto all processes", "No help");
+
 //	LoadAndRefineDomain
 	reg.add_function("LoadAndRefineDomain", &LoadAndRefineDomain<TDomain>, grp,
 					"", "Domain # Filename # NumRefines | load-dialog | endings=[\"ugx\"]; description=\"*.ugx-Files\" # Number Refinements",
@@ -567,6 +572,8 @@ static void Common(Registry& reg, string grp)
 			.add_method("refinement_projector", &T::refinement_projector,
 						"projector", "")
 			.add_method("geometry3d", &T::geometry3d, "geometry3d", "")
+			.add_method("set_sfc_order", &T::set_sfc_order, "", "type|selection|value=[\"hilbert\",\"morton\",\"none\"]",
+						"Orders the grid elements along a space filling curve, also after each grid change")
 			.set_construct_as_smart_pointer(true);
 	}
 
@@ -47,6 +47,8 @@
 	#include "lib_grid/parallelization/load_balancer.h"
 	#include "lib_grid/parallelization/load_balancer_util.h"
 	#include "lib_grid/parallelization/partitioner_dynamic_bisection.h"
+	#include "lib_grid/parallelization/partitioner_sfc.h"
+	#include "lib_grid/parallelization/partitioner_multilevel.h"
 	#include "lib_grid/parallelization/balance_weights_ref_marks.h"
 	#include "lib_grid/parallelization/partition_pre_processors/replace_coordinate.h"
 	#include "lib_grid/parallelization/partition_post_processors/smooth_partition_bounds.h"
@@ -197,6 +199,58 @@ static void RegisterDynamicBisectionPartitioner(
 	reg.add_class_to_group(name, clsGrpName, GetDomainTag<TDomain>());
 }
 
+template <class TDomain, class TPartitioner>
+static void RegisterSFCPartitioner(
+	Registry& reg,
+	string name,
+	string grpName,
+	string clsGrpName)
+{
+	reg.add_class_<TPartitioner, IPartitioner>(name, grpName)
+		.template add_constructor<void (*)(TDomain&)>()
+		.add_method("set_subset_handler",
+			&TPartitioner::set_subset_handler)
+		.add_method("set_curve",
+			&TPartitioner::set_curve, "", "curve")
+		.add_method("curve",
+			&TPartitioner::curve)
+		.add_method("enable_migration_minimization",
+			&TPartitioner::enable_migration_minimization)
+		.add_method("migration_minimization_enabled",
+			&TPartitioner::migration_minimization_enabled)
+		.set_construct_as_smart_pointer(true);
+
+	reg.add_class_to_group(name, clsGrpName, GetDomainTag<TDomain>());
+}
+
+template <class TDomain, class TPartitioner>
+static void RegisterMultilevelPartitioner(
+	Registry& reg,
+	string name,
+	string grpName,
+	string clsGrpName)
+{
+	reg.add_class_<TPartitioner, IPartitioner>(name, grpName)
+		.template add_constructor<void (*)(TDomain&)>()
+		.add_method("set_subset_handler",
+			&TPartitioner::set_subset_handler)
+		.add_method("set_imbalance_tolerance",
+			&TPartitioner::set_imbalance_tolerance, "", "tolerance")
+		.add_method("imbalance_tolerance",
+			&TPartitioner::imbalance_tolerance)
+		.add_method("set_max_gathered_vertices",
+			&TPartitioner::set_max_gathered_vertices, "", "num")
+		.add_method("max_gathered_vertices",
+			&TPartitioner::max_gathered_vertices)
+		.add_method("set_num_refinement_passes",
+			&TPartitioner::set_num_refinement_passes, "", "num")
+		.add_method("num_refinement_passes",
+			&TPartitioner::num_refinement_passes)
+		.set_construct_as_smart_pointer(true);
+
+	reg.add_class_to_group(name, clsGrpName, GetDomainTag<TDomain>());
+}
+
 template <class TDomain, class elem_t>
 static void RegisterSmoothPartitionBounds(
 	Registry& reg,
@@ -332,6 +386,22 @@ static void Common(Registry& reg, string grp) {
 			grp,
 			"Partitioner_DynamicBisection");
 
+		RegisterSFCPartitioner<
+				TDomain,
+				DomainPartitioner<TDomain, Partitioner_SFC<Edge, 1> > >(
+			reg,
+			"EdgePartitioner_SFC1d",
+			grp,
+			"Partitioner_SFC");
+
+		RegisterMultilevelPartitioner<
+				TDomain,
+				DomainPartitioner<TDomain, Partitioner_Multilevel<Edge, 1> > >(
+			reg,
+			"EdgePartitioner_Multilevel1d",
+			grp,
+			"Partitioner_Multilevel");
+
 
 		RegisterSmoothPartitionBounds<TDomain, Edge>(
 			reg,
@@ -358,6 +428,22 @@ static void Common(Registry& reg, string grp) {
 			grp,
 			"ManifoldPartitioner_DynamicBisection");
 
+		RegisterSFCPartitioner<
+				TDomain,
+				DomainPartitioner<TDomain, Partitioner_SFC<Edge, 2> > >(
+			reg,
+			"EdgePartitioner_SFC2d",
+			grp,
+			"ManifoldPartitioner_SFC");
+
+		RegisterMultilevelPartitioner<
+				TDomain,
+				DomainPartitioner<TDomain, Partitioner_Multilevel<Edge, 2> > >(
+			reg,
+			"EdgePartitioner_Multilevel2d",
+			grp,
+			"ManifoldPartitioner_Multilevel");
+
 		RegisterDynamicBisectionPartitioner<
 				TDomain,
 				DomainPartitioner<TDomain, Partitioner_DynamicBisection<Face, 2> > >(
@@ -366,6 +452,22 @@ static void Common(Registry& reg, string grp) {
 			grp,
 			"Partitioner_DynamicBisection");
 
+		RegisterSFCPartitioner<
+				TDomain,
+				DomainPartitioner<TDomain, Partitioner_SFC<Face, 2> > >(
+			reg,
+			"FacePartitioner_SFC2d",
+			grp,
+			"Partitioner_SFC");
+
+		RegisterMultilevelPartitioner<
+				TDomain,
+				DomainPartitioner<TDomain, Partitioner_Multilevel<Face, 2> > >(
+			reg,
+			"FacePartitioner_Multilevel2d",
+			grp,
+			"Partitioner_Multilevel");
+
 		RegisterSmoothPartitionBounds<TDomain, Face>(
 			reg,
 			"SmoothPartitionBounds2d",
@@ -391,6 +493,22 @@ static void Common(Registry& reg, string grp) {
 			grp,
 			"HyperManifoldPartitioner_DynamicBisection");
 
+		RegisterSFCPartitioner<
+				TDomain,
+				DomainPartitioner<TDomain, Partitioner_SFC<Edge, 3> > >(
+			reg,
+			"EdgePartitioner_SFC3d",
+			grp,
+			"HyperManifoldPartitioner_SFC");
+
+		RegisterMultilevelPartitioner<
+				TDomain,
+				DomainPartitioner<TDomain, Partitioner_Multilevel<Edge, 3> > >(
+			reg,
+			"EdgePartitioner_Multilevel3d",
+			grp,
+			"HyperManifoldPartitioner_Multilevel");
+
 		RegisterDynamicBisectionPartitioner<
 				TDomain,
 				DomainPartitioner<TDomain, Partitioner_DynamicBisection<Face, 3> > >(
@@ -399,6 +517,22 @@ static void Common(Registry& reg, string grp) {
 			grp,
 			"ManifoldPartitioner_DynamicBisection");
 
+		RegisterSFCPartitioner<
+				TDomain,
+				DomainPartitioner<TDomain, Partitioner_SFC<Face, 3> > >(
+			reg,
+			"FacePartitioner_SFC3d",
+			grp,
+			"ManifoldPartitioner_SFC");
+
+		RegisterMultilevelPartitioner<
+				TDomain,
+				DomainPartitioner<TDomain, Partitioner_Multilevel<Face, 3> > >(
+			reg,
+			"FacePartitioner_Multilevel3d",
+			grp,
+			"ManifoldPartitioner_Multilevel");
+
 		RegisterDynamicBisectionPartitioner<
 				TDomain,
 				DomainPartitioner<TDomain, Partitioner_DynamicBisection<Volume, 3> > >(
@@ -407,6 +541,22 @@ static void Common(Registry& reg, string grp) {
 			grp,
 			"Partitioner_DynamicBisection");
 
+		RegisterSFCPartitioner<
+				TDomain,
+				DomainPartitioner<TDomain, Partitioner_SFC<Volume, 3> > >(
+			reg,
+			"VolumePartitioner_SFC3d",
+			grp,
+			"Partitioner_SFC");
+
+		RegisterMultilevelPartitioner<
+				TDomain,
+				DomainPartitioner<TDomain, Partitioner_Multilevel<Volume, 3> > >(
+			reg,
+			"VolumePartitioner_Multilevel3d",
+			grp,
+			"Partitioner_Multilevel");
+
 		RegisterSmoothPartitionBounds<TDomain, Volume>(
 			reg,
 			"SmoothPartitionBounds3d",
@@ -99,6 +99,13 @@ void RegisterGridBridge_Grid(Registry& reg, string parentGroup)
 		.add_method("reserve_edges", &Grid::reserve<Edge>, "", "num")
 		.add_method("reserve_faces", &Grid::reserve<Face>, "", "num")
 		.add_method("reserve_volumes", &Grid::reserve<Volume>, "", "num")
+		.add_method("freeze_topology", &Grid::freeze_topology)
+		.add_method("thaw_topology", &Grid::thaw_topology)
+		.add_method("topology_is_frozen", &Grid::topology_is_frozen)
+		.add_method("set_vertex_tuple_hash", &Grid::set_vertex_tuple_hash, "", "enable")
+		.add_method("has_vertex_tuple_hash", &Grid::has_vertex_tuple_hash)
+		.add_method("defragment", static_cast<void (Grid::*)()>(&Grid::defragment))
+		.add_method("compact_memory", &Grid::compact_memory)
 		.set_construct_as_smart_pointer(true);
 
 //	MultiGrid
@@ -33,6 +33,7 @@
 #include "grid_bridges.h"
 #include "common/space_partitioning/ntree_traverser.h"
 #include "lib_grid/algorithms/debug_util.h"
+#include "lib_grid/algorithms/unit_tests/check_associated_elements.h"
 #include "lib_grid/refinement/hanging_node_refiner_grid.h"
 #include "lib_grid/algorithms/space_partitioning/lg_ntree.h"
 #include "lib_grid/file_io/file_io.h"
@@ -100,7 +101,10 @@ void RegisterGridBridge_Misc(Registry& reg, string parentGroup)
 	string grp = parentGroup;
 	reg.add_function("PrintGridElementNumbers", static_cast<void (*)(MultiGrid&)>(&PrintGridElementNumbers), grp)
 		.add_function("PrintGridElementNumbers", static_cast<void (*)(Grid&)>(&PrintGridElementNumbers), grp)
-		.add_function("PrintAttachmentInfo", &PrintAttachmentInfo, grp);
+		.add_function("PrintAttachmentInfo", &PrintAttachmentInfo, grp)
+		.add_function("PrintGridMemoryUsage", &PrintGridMemoryUsage, grp)
+		.add_function("CheckDefragment", &CheckDefragment, grp)
+		.add_function("CheckBulkCreation", &grid_unit_tests::CheckBulkCreation, grp);
 
 	reg.add_function("TestNTree", &TestNTree, grp);
 }
@@ -38,6 +38,7 @@
 #include "lib_grid/refinement/global_subdivision_multi_grid_refiner.h"
 #include "lib_grid/refinement/hanging_node_refiner_grid.h"
 #include "lib_grid/refinement/hanging_node_refiner_multi_grid.h"
+#include "lib_grid/refinement/implicit_uniform_refinement.h"
 #include "lib_grid/refinement/projectors/projectors.h"
 #include "lib_grid/algorithms/subdivision/subdivision_loop.h"
 #include "lib_grid/file_io/file_io.h"
@@ -63,6 +64,12 @@ bool CreateHierarchy(MultiGrid& mg, size_t numRefs)
 	return true;
 }
 
+bool SaveImplicitLevelToVTU(const char* filename,
+							const ImplicitUniformRefinement& iur, int lvl)
+{
+	return ug::SaveImplicitLevelToVTU(filename, iur, lvl);
+}
+
 bool CreateSmoothHierarchy(MultiGrid& mg, size_t numRefs)
 {
 	PROFILE_FUNC_GROUP("grid");
@@ -224,6 +231,8 @@ void RegisterGridBridge_Refinement(Registry& reg, string parentGroup)
 	reg.add_class_<IRefiner>("IRefiner", grp)
 		.add_method("refine", &IRefiner::refine)
 		.add_method("coarsen", &IRefiner::coarsen)
+		.add_method("enable_compaction_after_coarsening", &IRefiner::enable_compaction_after_coarsening, "", "enable")
+		.add_method("compaction_after_coarsening_enabled", &IRefiner::compaction_after_coarsening_enabled)
 		.add_method("save_marks_to_file", &IRefiner::save_marks_to_file, "", "filename")
 		.add_method("set_adjusted_marks_debug_filename", &IRefiner::set_adjusted_marks_debug_filename, "", "filename")
 		.add_method("mark_neighborhood",
@@ -264,6 +273,8 @@ void RegisterGridBridge_Refinement(Registry& reg, string parentGroup)
 		.add_constructor()
 		.add_method("assign_grid", static_cast<void (GlobalMultiGridRefiner::*)(MultiGrid&)>(&GlobalMultiGridRefiner::assign_grid),
 				"", "mg")
+		.add_method("enable_threaded_refinement", &GlobalMultiGridRefiner::enable_threaded_refinement, "", "enable")
+		.add_method("threaded_refinement_enabled", &GlobalMultiGridRefiner::threaded_refinement_enabled)
 		.set_construct_as_smart_pointer(true);
 
 	{
@@ -319,6 +330,16 @@ void RegisterGridBridge_Refinement(Registry& reg, string parentGroup)
 			.set_construct_as_smart_pointer(true);
 	}
 
+//	ImplicitUniformRefinement
+	reg.add_class_<ImplicitUniformRefinement>("ImplicitUniformRefinement", grp)
+		.add_constructor()
+		.add_method("init", &ImplicitUniformRefinement::init, "", "geometry#numLevels")
+		.add_method("num_levels", &ImplicitUniformRefinement::num_levels)
+		.add_method("num_vertices", &ImplicitUniformRefinement::num_vertices, "", "lvl")
+		.add_method("num_elements", &ImplicitUniformRefinement::num_elements, "", "lvl")
+		.add_method("memory_consumption", &ImplicitUniformRefinement::memory_consumption)
+		.set_construct_as_smart_pointer(true);
+
 //	parallel refinement
 #ifdef UG_PARALLEL
 	reg.add_class_<ParallelHangingNodeRefiner_MultiGrid, HangingNodeRefiner_MultiGrid>
@@ -337,7 +358,11 @@ void RegisterGridBridge_Refinement(Registry& reg, string parentGroup)
 
 //	refinement
 	reg.add_function("CreateHierarchy", &CreateHierarchy, grp)
-		.add_function("CreateSmoothHierarchy", &CreateSmoothHierarchy, grp);
+		.add_function("CreateSmoothHierarchy", &CreateSmoothHierarchy, grp)
+		.add_function("SaveImplicitLevelToVTU",
+				static_cast<bool (*)(const char*, const ImplicitUniformRefinement&, int)>(
+					&SaveImplicitLevelToVTU),
+				grp, "success", "filename#implicitRefinement#lvl");
 }
 
 }//	end of namespace
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+
+#ifndef __H__UG__COMMON__ALIGNED_ALLOCATOR__
+#define __H__UG__COMMON__ALIGNED_ALLOCATOR__
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <stdint.h>
+
+namespace ug{
+
+///	STL allocator which aligns the allocated memory to the given boundary
+/**	Useful for arrays which shall be processed with vector instructions,
+ * e.g. std::vector<number, AlignedAllocator<number> >. The default alignment
+ * of 64 bytes matches the cache line size of most current processors and is
+ * sufficient for all common vector extensions.
+ *
+ * Alignment has to be a power of two and a multiple of sizeof(void*).
+ */
+template <class T, std::size_t Alignment = 64>
+class AlignedAllocator
+{
+	public:
+		typedef T					value_type;
+		typedef T*					pointer;
+		typedef const T*			const_pointer;
+		typedef T&					reference;
+		typedef const T&			const_reference;
+		typedef std::size_t			size_type;
+		typedef std::ptrdiff_t		difference_type;
+
+		template <class U>
+		struct rebind	{typedef AlignedAllocator<U, Alignment> other;};
+
+		static const std::size_t alignment = Alignment;
+
+		AlignedAllocator()	{}
+		AlignedAllocator(const AlignedAllocator&)	{}
+		template <class U>
+		AlignedAllocator(const AlignedAllocator<U, Alignment>&)	{}
+
+		pointer address(reference x) const				{return &x;}
+		const_pointer address(const_reference x) const	{return &x;}
+
+		size_type max_size() const	{return (size_type(-1) - Alignment) / sizeof(T);}
+
+	///	allocates memory for n objects. The returned address is a multiple of Alignment.
+	/**	The memory is over-allocated and the offset to the original block
+	 * is stored directly in front of the returned address.*/
+		pointer allocate(size_type n, const void* = 0)
+		{
+			if(n == 0)
+				return NULL;
+			if(n > max_size())
+				throw std::bad_alloc();
+
+			void* raw = std::malloc(n * sizeof(T) + Alignment + sizeof(void*));
+			if(!raw)
+				throw std::bad_alloc();
+
+			uintptr_t addr = reinterpret_cast<uintptr_t>(raw) + sizeof(void*);
+			addr = (addr + Alignment - 1) & ~(uintptr_t)(Alignment - 1);
+			reinterpret_cast<void**>(addr)[-1] = raw;
+			return reinterpret_cast<pointer>(addr);
+		}
+
+		void deallocate(pointer p, size_type)
+		{
+			if(p)
+				std::free(reinterpret_cast<void**>(p)[-1]);
+		}
+
+		void construct(pointer p, const T& val)	{new(static_cast<void*>(p)) T(val);}
+		void destroy(pointer p)					{p->~T();}
+};
+
+template <class T, class U, std::size_t Alignment>
+inline bool operator == (const AlignedAllocator<T, Alignment>&,
+						 const AlignedAllocator<U, Alignment>&)
+{return true;}
+
+template <class T, class U, std::size_t Alignment>
+inline bool operator != (const AlignedAllocator<T, Alignment>&,
+						 const AlignedAllocator<U, Alignment>&)
+{return false;}
+
+}//	end of namespace
+
+#endif
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#include <cstdlib>
+#include <new>
+#include "slab_allocator.h"
+#include "common/assert.h"
+
+namespace ug{
+
+namespace{
+//	blocks are aligned like doubles and pointers
+const std::size_t SLAB_BLOCK_ALIGNMENT =
+		sizeof(double) > sizeof(void*) ? sizeof(double) : sizeof(void*);
+
+inline std::size_t AlignBlockSize(std::size_t size)
+{
+	return ((size + SLAB_BLOCK_ALIGNMENT - 1) / SLAB_BLOCK_ALIGNMENT)
+		   * SLAB_BLOCK_ALIGNMENT;
+}
+
+void* AllocateSlab()
+{
+	void* slab;
+	#ifdef _WIN32
+		slab = _aligned_malloc(SlabAllocator::SLAB_SIZE, SlabAllocator::SLAB_SIZE);
+	#else
+		if(posix_memalign(&slab, SlabAllocator::SLAB_SIZE, SlabAllocator::SLAB_SIZE) != 0)
+			slab = NULL;
+	#endif
+	if(!slab)
+		throw std::bad_alloc();
+	return slab;
+}
+
+void FreeSlab(void* slab)
+{
+	#ifdef _WIN32
+		_aligned_free(slab);
+	#else
+		free(slab);
+	#endif
+}
+}
+
+SlabAllocator::
+SlabAllocator(std::size_t blockSize) :
+	m_bumpPtr(NULL),
+	m_bumpEnd(NULL),
+	m_freeList(NULL),
+	m_numAllocated(0)
+{
+	if(blockSize < sizeof(FreeBlock))
+		blockSize = sizeof(FreeBlock);
+	m_blockSize = AlignBlockSize(blockSize);
+	UG_ASSERT(m_blockSize <= SLAB_SIZE / 4,
+			  "Block size " << blockSize << " is too large for a SlabAllocator");
+	m_blocksPerSlab = (SLAB_SIZE - AlignBlockSize(sizeof(SlabHeader))) / m_blockSize;
+}
+
+SlabAllocator::
+~SlabAllocator()
+{
+	release_all();
+}
+
+void* SlabAllocator::
+allocate()
+{
+	++m_numAllocated;
+
+	if(m_freeList){
+		FreeBlock* b = m_freeList;
+		m_freeList = b->next;
+		++header(b)->numUsed;
+		return b;
+	}
+
+	if(m_bumpPtr == m_bumpEnd)
+		create_slab();
+
+	void* p = m_bumpPtr;
+	m_bumpPtr += m_blockSize;
+	++header(p)->numUsed;
+	return p;
+}
+
+void SlabAllocator::
+deallocate(void* p)
+{
+	UG_ASSERT(owner(p) == this, "Block was not allocated by this SlabAllocator");
+	FreeBlock* b = static_cast<FreeBlock*>(p);
+	b->next = m_freeList;
+	m_freeList = b;
+	--header(p)->numUsed;
+	--m_numAllocated;
+}
+
+bool SlabAllocator::
+release_if_unused()
+{
+	if(m_numAllocated > 0)
+		return false;
+	release_all();
+	return true;
+}
+
+std::size_t SlabAllocator::
+release_unused_slabs()
+{
+	const std::size_t numSlabs = m_slabs.size();
+	if(numSlabs == 0)
+		return 0;
+
+	if(m_numAllocated == 0){
+		release_all();
+		return numSlabs;
+	}
+
+	bool anyUnused = false;
+	for(std::size_t i = 0; i < numSlabs; ++i){
+		if(header(m_slabs[i])->numUsed == 0){
+			anyUnused = true;
+			break;
+		}
+	}
+	if(!anyUnused)
+		return 0;
+
+//	remove the blocks of unused slabs from the free list before releasing them
+	FreeBlock* freeList = NULL;
+	FreeBlock** tail = &freeList;
+	for(FreeBlock* b = m_freeList; b; b = b->next){
+		if(header(b)->numUsed > 0){
+			*tail = b;
+			tail = &b->next;
+		}
+	}
+	*tail = NULL;
+	m_freeList = freeList;
+
+	std::size_t numKept = 0;
+	for(std::size_t i = 0; i < numSlabs; ++i){
+		unsigned char* slab = m_slabs[i];
+		if(header(slab)->numUsed > 0)
+			m_slabs[numKept++] = slab;
+		else
+			release_slab(slab);
+	}
+	m_slabs.resize(numKept);
+
+	return numSlabs - numKept;
+}
+
+void SlabAllocator::
+create_slab()
+{
+	unsigned char* slab = static_cast<unsigned char*>(AllocateSlab());
+	SlabHeader* h = reinterpret_cast<SlabHeader*>(slab);
+	h->owner = this;
+	h->numUsed = 0;
+	m_slabs.push_back(slab);
+	m_bumpPtr = slab + AlignBlockSize(sizeof(SlabHeader));
+	m_bumpEnd = m_bumpPtr + m_blocksPerSlab * m_blockSize;
+}
+
+void SlabAllocator::
+release_slab(unsigned char* slab)
+{
+//	the remaining blocks of the current slab can't be handed out anymore
+	if(m_bumpEnd && header(m_bumpEnd - m_blockSize) == header(slab))
+		m_bumpPtr = m_bumpEnd = NULL;
+	FreeSlab(slab);
+}
+
+void SlabAllocator::
+release_all()
+{
+	for(std::size_t i = 0; i < m_slabs.size(); ++i)
+		FreeSlab(m_slabs[i]);
+	m_slabs.clear();
+	m_bumpPtr = m_bumpEnd = NULL;
+	m_freeList = NULL;
+	m_numAllocated = 0;
+}
+
+}//	end of namespace
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__COMMON__SLAB_ALLOCATOR__
+#define __H__UG__COMMON__SLAB_ALLOCATOR__
+
+#include <cstddef>
+#include <vector>
+
+namespace ug{
+
+///	Allocates blocks of one fixed size from aligned slabs of SLAB_SIZE bytes.
+/**	Blocks are handed out from the most recently created slab in address order,
+ * so that objects which are created one after another lie next to each other
+ * in memory. Released blocks are kept in a free list and are reused by later
+ * allocations.
+ *
+ * Each slab starts with a small header which refers to the allocator and
+ * counts the blocks in use. The allocator which owns a block can thus be
+ * found from the block address alone (see owner()) and a slab can be returned
+ * to the system as soon as its last block was released.
+ *
+ * Memory is returned to the system through release_unused_slabs(), as a whole
+ * through release_if_unused() (if no block is in use) or in the destructor.
+ *
+ * The allocator is not thread safe.
+ */
+class SlabAllocator
+{
+	public:
+	///	size and alignment of each slab in bytes
+		static const std::size_t SLAB_SIZE = 16384;
+
+	///	blockSize may not exceed a quarter of SLAB_SIZE
+		SlabAllocator(std::size_t blockSize);
+
+	///	releases all slabs. Blocks which are still in use become invalid.
+		~SlabAllocator();
+
+		void* allocate();
+
+	///	p has to be a block which was allocated by this instance.
+		void deallocate(void* p);
+
+	///	returns the allocator which allocated the block p
+		static SlabAllocator* owner(const void* p)	{return header(p)->owner;}
+
+	///	releases all slabs if no block is in use. Returns true if so.
+		bool release_if_unused();
+
+	///	releases all slabs of which no block is in use. Returns their number.
+	/**	If blocks are still in use, this requires a pass over the free list.*/
+		std::size_t release_unused_slabs();
+
+	///	size of each block in bytes (the requested size rounded up to the alignment)
+		std::size_t block_size() const		{return m_blockSize;}
+
+	///	number of blocks which are currently in use
+		std::size_t num_allocated() const	{return m_numAllocated;}
+
+	///	number of blocks which fit into the slabs that are currently held
+		std::size_t capacity() const		{return m_slabs.size() * m_blocksPerSlab;}
+
+		std::size_t num_slabs() const		{return m_slabs.size();}
+
+	///	number of bytes held by the allocator (used and unused)
+		std::size_t memory_reserved() const	{return m_slabs.size() * SLAB_SIZE;}
+
+	private:
+	//	not copyable
+		SlabAllocator(const SlabAllocator&);
+		SlabAllocator& operator=(const SlabAllocator&);
+
+		struct SlabHeader
+		{
+			SlabAllocator*	owner;
+			std::size_t		numUsed;
+		};
+
+		struct FreeBlock
+		{
+			FreeBlock* next;
+		};
+
+		static SlabHeader* header(const void* p)
+		{
+			return reinterpret_cast<SlabHeader*>(
+					reinterpret_cast<std::size_t>(p) & ~(SLAB_SIZE - 1));
+		}
+
+		void create_slab();
+		void release_slab(unsigned char* slab);
+		void release_all();
+
+	private:
+		std::size_t					m_blockSize;
+		std::size_t					m_blocksPerSlab;
+
+		std::vector<unsigned char*>	m_slabs;
+		unsigned char*				m_bumpPtr;
+		unsigned char*				m_bumpEnd;
+		FreeBlock*					m_freeList;
+
+		std::size_t					m_numAllocated;
+};
+
+}//	end of namespace
+
+#endif
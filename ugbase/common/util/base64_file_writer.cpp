@@ -31,6 +31,7 @@
  */
 
 #include "common/util/base64_file_writer.h"
+#include "common/types.h"
 
 // for base64 encoding with boost
 #include <boost/archive/iterators/transform_width.hpp>
@@ -43,6 +44,10 @@
 #include "common/error.h"
 #include "common/assert.h"
 
+#ifdef UG_ZLIB
+	#include <zlib.h>
+#endif
+
 using namespace std;
 
 /**
@@ -70,13 +75,7 @@ Base64FileWriter::fmtflag Base64FileWriter::format() const {
 Base64FileWriter& Base64FileWriter::operator<<(const fmtflag format)
 {
 	PROFILE_FUNC();
-
-	// forceful flushing of encoder's internal input buffer is necessary
-	// if we are switching formats.
-	if (format != m_currFormat && m_numBytesWritten > 0) {
-		flushInputBuffer(true);
-	}
-	m_currFormat = format;
+	switch_format(format);
 	return *this;
 }
 
@@ -128,18 +127,26 @@ Base64FileWriter& Base64FileWriter::operator<<(size_t value)
 }
 
 Base64FileWriter::Base64FileWriter() :
+	m_pStream(&m_fStream),
 	m_currFormat(base64_ascii),
 	m_inBuffer(ios_base::binary | ios_base::out | ios_base::in),
 	m_lastInputByteSize(0),
-	m_numBytesWritten(0)
+	m_numBytesWritten(0),
+	m_bRecording(false),
+	m_bCompress(false),
+	m_compressionLevel(6)
 {}
 
 Base64FileWriter::Base64FileWriter(const char* filename,
 		const ios_base::openmode mode) :
+	m_pStream(&m_fStream),
 	m_currFormat(base64_ascii),
 	m_inBuffer(ios_base::binary | ios_base::out | ios_base::in),
 	m_lastInputByteSize(0),
-	m_numBytesWritten(0)
+	m_numBytesWritten(0),
+	m_bRecording(false),
+	m_bCompress(false),
+	m_compressionLevel(6)
 {
 	PROFILE_FUNC();
 
@@ -149,7 +156,8 @@ Base64FileWriter::Base64FileWriter(const char* filename,
 Base64FileWriter::~Base64FileWriter()
 {
 	flushInputBuffer(true);
-	m_fStream.close();
+	if (m_fStream.is_open())
+		m_fStream.close();
 }
 
 void Base64FileWriter::open(const char *filename,
@@ -171,6 +179,70 @@ void Base64FileWriter::open(const char *filename,
 	} else if (!m_fStream.good()) {
 		UG_THROW( "Can not write to output file: " << filename);
 	}
+	m_pStream = &m_fStream;
+	m_bRecording = false;
+}
+
+void Base64FileWriter::open_memory()
+{
+	m_memStream.str("");
+	m_memStream.clear();
+	m_pStream = &m_memStream;
+	m_bRecording = false;
+}
+
+void Base64FileWriter::open_recording()
+{
+	m_recording.chunks.clear();
+	m_pStream = &m_memStream;
+	m_bRecording = true;
+}
+
+void Base64FileWriter::take_recording(Recording& recOut)
+{
+	recOut.chunks.clear();
+	recOut.chunks.swap(m_recording.chunks);
+	recOut.compress = m_bCompress;
+	recOut.compressionLevel = m_compressionLevel;
+}
+
+void Base64FileWriter::write_recording(const Recording& rec, const char* filename)
+{
+	Base64FileWriter writer;
+	writer.open(filename);
+	writer.set_compression(rec.compress, rec.compressionLevel);
+
+	for (size_t i = 0; i < rec.chunks.size(); ++i) {
+		writer.switch_format(rec.chunks[i].first);
+		writer.write_raw(rec.chunks[i].second);
+	}
+
+	writer.flushInputBuffer(true);
+	writer.m_fStream.close();
+	if (writer.m_fStream.fail()) {
+		UG_THROW("Could not write output file: " << filename);
+	}
+}
+
+string Base64FileWriter::memory_content() const
+{
+	return m_memStream.str();
+}
+
+void Base64FileWriter::set_compression(bool enable, int level)
+{
+#ifndef UG_ZLIB
+	if (enable) {
+		UG_THROW("Base64FileWriter: Compression requires zlib support. "
+				 "Please build with USE_ZLIB=ON.");
+	}
+#endif
+	if (level < 0 || level > 9) {
+		UG_THROW("Base64FileWriter: Invalid compression level " << level
+				 << ". Valid levels are 0 to 9.");
+	}
+	m_bCompress = enable;
+	m_compressionLevel = level;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -182,6 +254,11 @@ template <typename T>
 void Base64FileWriter::dispatch(const T& value)
 {
 //	PROFILE_FUNC(); // this profile node is too small
+	if (m_bRecording) {
+		record(value);
+		return;
+	}
+
 	assertFileOpen();
 
 	switch ( m_currFormat ) {
@@ -208,13 +285,68 @@ void Base64FileWriter::dispatch(const T& value)
 		}
 		case normal:
 			// nothing to do here, almost
-			m_fStream << value;
+			*m_pStream << value;
+			break;
+	}
+}
+
+template <typename T>
+void Base64FileWriter::record(const T& value)
+{
+	// a new chunk is started on every format switch, so that the encoded
+	// blocks of the recording equal the ones written directly
+	if (m_recording.chunks.empty()
+		|| m_recording.chunks.back().first != m_currFormat)
+		m_recording.chunks.push_back(make_pair(m_currFormat, string()));
+
+	string& chunk = m_recording.chunks.back().second;
+	if (m_currFormat == base64_binary)
+		chunk.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	else {
+		m_recStream.str("");
+		m_recStream << value;
+		chunk.append(m_recStream.str());
+	}
+}
+
+void Base64FileWriter::switch_format(const fmtflag format)
+{
+	// forceful flushing of encoder's internal input buffer is necessary
+	// if we are switching formats.
+	if (format != m_currFormat && m_numBytesWritten > 0) {
+		flushInputBuffer(true);
+	}
+	m_currFormat = format;
+}
+
+void Base64FileWriter::write_raw(const string& data)
+{
+	switch ( m_currFormat ) {
+		case base64_ascii:
+			m_inBuffer.write(data.c_str(), data.size());
+			m_numBytesWritten = m_inBuffer.tellp();
+			m_lastInputByteSize = sizeof(char);
+			flushInputBuffer();
+			break;
+		case base64_binary:
+			m_inBuffer.write(data.c_str(), data.size());
+			m_numBytesWritten += data.size();
+			m_lastInputByteSize = sizeof(char);
+			flushInputBuffer();
+			break;
+		case normal:
+			m_pStream->write(data.c_str(), data.size());
 			break;
 	}
 }
 
 inline void Base64FileWriter::assertFileOpen()
 {
+	if (m_pStream == &m_memStream) {
+		if (m_memStream.bad())
+			UG_THROW( "Memory stream is not writeable." );
+		return;
+	}
 	if (m_fStream.bad() || !m_fStream.is_open()) {
 		UG_THROW( "File stream is not open." );
 	}
@@ -224,6 +356,13 @@ void Base64FileWriter::flushInputBuffer(bool force)
 {
 //	PROFILE_FUNC(); // this profile node is too small
 
+	// a compressed block can only be written as a whole
+	if (m_bCompress && m_currFormat == base64_binary) {
+		if (force)
+			flushCompressedBlock();
+		return;
+	}
+
 	size_t buff_len = 0;
 	// amount of elements to flush at once
 	const uint elements_to_flush = 12;
@@ -263,7 +402,7 @@ void Base64FileWriter::flushInputBuffer(bool force)
 
 		// encode buff in base64
 		copy(base64_text(buff), base64_text(buff + buff_len),
-				boost::archive::iterators::ostream_iterator<char>(m_fStream));
+				boost::archive::iterators::ostream_iterator<char>(*m_pStream));
 	}
 
 	size_t rest_len = m_numBytesWritten - buff_len;
@@ -299,7 +438,7 @@ void Base64FileWriter::flushInputBuffer(bool force)
 
 	if (force) {
 		for(uint i = 0; i < paddChars; ++i)
-			m_fStream << '=';
+			*m_pStream << '=';
 
 		// resetting num bytes written and bytes in block
 		m_numBytesWritten = 0;
@@ -309,6 +448,76 @@ void Base64FileWriter::flushInputBuffer(bool force)
 	}
 }
 
+void Base64FileWriter::writeEncoded(const char* data, size_t size)
+{
+	const size_t paddChars = (3 - size % 3) % 3;
+	if (size > 0) {
+		// enlarge the buffer by # paddChars because boost reads beyond buffer
+		m_tmpBuff.assign(data, data + size);
+		m_tmpBuff.resize(size + paddChars, 0x0);
+		const char* buff = &m_tmpBuff[0];
+		copy(base64_text(buff), base64_text(buff + size),
+				boost::archive::iterators::ostream_iterator<char>(*m_pStream));
+	}
+	for (size_t i = 0; i < paddChars; ++i)
+		*m_pStream << '=';
+}
+
+void Base64FileWriter::flushCompressedBlock()
+{
+#ifdef UG_ZLIB
+	// no profiling here: the function is also used by write_recording, which
+	// may run on a background thread
+	// uncompressed size of the sub blocks (the default of vtkZLibDataCompressor)
+	const size_t blockSize = 32768;
+
+	// read the whole block and reset the input buffer
+	vector<char> raw(m_numBytesWritten);
+	if (!raw.empty()) {
+		m_inBuffer.read(&raw[0], raw.size());
+		if (!m_inBuffer.good()) {
+			UG_THROW("failed to read from input buffer");
+		}
+	}
+	m_inBuffer.str("");
+	m_inBuffer.seekp(0, ios_base::beg);
+	m_inBuffer.seekg(0, ios_base::beg);
+	m_numBytesWritten = 0;
+
+	// skip the size header of the uncompressed array
+	const size_t headerSize = std::min(raw.size(), sizeof(uint32));
+	const size_t dataSize = raw.size() - headerSize;
+	const Bytef* data = reinterpret_cast<const Bytef*>(raw.empty() ? NULL : &raw[0] + headerSize);
+
+	// header: number of blocks, block size, size of the last partial block and
+	// the compressed sizes of all blocks
+	const size_t numBlocks = (dataSize + blockSize - 1) / blockSize;
+	vector<uint32> header(3 + numBlocks);
+	header[0] = (uint32) numBlocks;
+	header[1] = (uint32) blockSize;
+	header[2] = (uint32) (dataSize % blockSize);
+
+	vector<char> compressed;
+	for (size_t b = 0; b < numBlocks; ++b) {
+		const size_t len = std::min(blockSize, dataSize - b * blockSize);
+		uLongf compLen = compressBound((uLong) len);
+		const size_t pos = compressed.size();
+		compressed.resize(pos + compLen);
+		if (compress2(reinterpret_cast<Bytef*>(&compressed[pos]), &compLen,
+					  data + b * blockSize, (uLong) len, m_compressionLevel) != Z_OK) {
+			UG_THROW("Base64FileWriter: zlib compression failed.");
+		}
+		compressed.resize(pos + compLen);
+		header[3 + b] = (uint32) compLen;
+	}
+
+	// header and data are encoded separately
+	writeEncoded(reinterpret_cast<const char*>(&header[0]),
+				 header.size() * sizeof(uint32));
+	writeEncoded(compressed.empty() ? NULL : &compressed[0], compressed.size());
+#endif
+}
+
 void Base64FileWriter::close()
 {
 	PROFILE_FUNC();
@@ -317,6 +526,8 @@ void Base64FileWriter::close()
 	flushInputBuffer(true);
 
 	// only when this is done, close the file stream
+	if (m_pStream != &m_fStream)
+		return;
 	m_fStream.close();
 	UG_ASSERT(m_fStream.good(), "could not close output file.");
 }
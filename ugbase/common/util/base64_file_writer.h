@@ -87,6 +87,17 @@ public:
 		normal
 	};
 
+	/**
+	 * \brief Unencoded output of a writer, see open_recording()
+	 */
+	struct Recording {
+		//! written data, split at format switches
+		std::vector<std::pair<fmtflag, std::string> > chunks;
+		//! compression settings of the recording writer
+		bool compress;
+		int compressionLevel;
+	};
+
 	//////////////////////////////////////////////////////////////////////////
 	Base64FileWriter();
 
@@ -112,6 +123,56 @@ public:
 	void open(const char *filename,
 			const std::ios_base::openmode mode = std::ios_base::out );
 
+	/**
+	 * \brief Directs all following output into an internal memory buffer
+	 * \details Instead of a file, the encoded data is collected in memory.
+	 *   After close() it can be retrieved using memory_content().
+	 */
+	void open_memory();
+
+	/**
+	 * \brief returns the data written since open_memory() was called
+	 */
+	std::string memory_content() const;
+
+	/**
+	 * \brief Records all following output in memory without encoding it
+	 * \details The data passed to the writer is stored as is. After close(),
+	 *   the recording can be taken by take_recording() and be written by
+	 *   write_recording(), which does the base64 encoding and compression.
+	 */
+	void open_recording();
+
+	/**
+	 * \brief Moves the data recorded since open_recording() to recOut
+	 */
+	void take_recording(Recording& recOut);
+
+	/**
+	 * \brief Encodes recorded data and writes it to the given file
+	 * \details The file content equals the one of a writer that would have
+	 *   received the recorded data directly. As this function neither logs nor
+	 *   uses the profiler, it may be called from a background thread.
+	 * \throws UGError if the file can not be written
+	 */
+	static void write_recording(const Recording& rec, const char* filename);
+
+	/**
+	 * \brief Enables zlib compression of binary blocks
+	 * \details If enabled, every block written in base64_binary format (i.e.
+	 *   all data between switching to base64_binary and switching away from
+	 *   it) is compressed in the layout of vtkZLibDataCompressor. The first four
+	 *   bytes of a block are interpreted as the UInt32 size header of an
+	 *   uncompressed VTK data array. They are replaced by the header of the
+	 *   compressed sub blocks, which is base64 encoded separately from the
+	 *   compressed data.
+	 * \param enable whether binary blocks shall be compressed
+	 * \param level  zlib compression level (0-9)
+	 * \throws UGError if a compression is requested, but UG was compiled
+	 *   without zlib support
+	 */
+	void set_compression(bool enable, int level = 6);
+
 	/**
 	 * \brief gets the current set format
 	 */
@@ -150,10 +211,34 @@ private:
 	template <typename T>
 	void dispatch(const T& value);
 
+	/**
+	 * \brief Appends the given data to the recording in the current format
+	 */
+	template <typename T>
+	void record(const T& value);
+
+	/**
+	 * \brief Sets the current format, flushing the encoder's buffer if needed
+	 */
+	void switch_format(const fmtflag format);
+
+	/**
+	 * \brief Writes raw (already converted) data in the current format
+	 */
+	void write_raw(const std::string& data);
+
 	/**
 	 * \brief File stream to write everything to
 	 */
 	std::fstream m_fStream;
+	/**
+	 * \brief Memory stream used instead of the file stream, see open_memory()
+	 */
+	std::stringstream m_memStream;
+	/**
+	 * \brief The stream all output goes to (either m_fStream or m_memStream)
+	 */
+	std::ostream* m_pStream;
 	/**
 	 * \brief Current write format (\c base64 or \c normal)
 	 */
@@ -184,6 +269,41 @@ private:
 	 */
 	void flushInputBuffer(bool force = false);
 
+	/**
+	 * \brief Compresses and writes the whole content of the input buffer
+	 */
+	void flushCompressedBlock();
+
+	/**
+	 * \brief Base64 encodes the given data and writes it including padding
+	 */
+	void writeEncoded(const char* data, size_t size);
+
+	/**
+	 * \brief whether output is recorded instead of written, see open_recording()
+	 */
+	bool m_bRecording;
+
+	/**
+	 * \brief recorded output
+	 */
+	Recording m_recording;
+
+	/**
+	 * \brief stream used to convert values to text while recording
+	 */
+	std::ostringstream m_recStream;
+
+	/**
+	 * \brief whether binary blocks are zlib compressed
+	 */
+	bool m_bCompress;
+
+	/**
+	 * \brief zlib compression level of binary blocks
+	 */
+	int m_compressionLevel;
+
 	/**
 	 * \brief Check on readiness of the file stream
 	 * \throws UGError if either the filestream's \c badbit is set or the file
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+#ifndef __H__UG__LIB_ALGEBRA__ALGEBRA_COMMON__BLOCK_KERNEL_BENCHMARK__
+#define __H__UG__LIB_ALGEBRA__ALGEBRA_COMMON__BLOCK_KERNEL_BENCHMARK__
+
+#include <vector>
+#include <iomanip>
+#include "common/log.h"
+#include "common/stopwatch.h"
+#include "lib_algebra/cpu_algebra/sparsematrix.h"
+#include "lib_algebra/cpu_algebra/vector.h"
+#include "lib_algebra/algebra_common/core_smoothers.h"
+#include "lib_algebra/operator/preconditioner/ilu.h"
+
+namespace ug{
+
+/// \addtogroup lib_algebra
+///	@{
+
+///	coefficients of the node diagonal block and of the couplings to neighbor nodes
+template<size_t TBlockSize>
+void CreateBlockBenchmarkCoefficients(std::vector<double>& diagBlock, std::vector<double>& offDiag)
+{
+	const size_t N = TBlockSize;
+	diagBlock.resize(N*N);
+	offDiag.resize(N*N);
+	for(size_t r = 0; r < N; ++r)
+		for(size_t c = 0; c < N; ++c)
+		{
+			diagBlock[r*N+c] = (r == c) ? 4.0 + 2.0*N : 1.0/(1.0 + r + 2.0*c);
+			offDiag[r*N+c] = (r == c) ? -1.0 : -0.1/(1.0 + r + c);
+		}
+}
+
+/**
+ * Fills Ablock and Ascalar with a coupled system of TBlockSize unknowns per node
+ * on a gridSize x gridSize 5-point stencil. All unknowns of a node are coupled
+ * to each other and to all unknowns of the neighbor nodes, so that both
+ * formats store the same number of nonzeros. Ablock stores the system in point-block form, Ascalar stores the
+ * same system in scalar form with unknown k of node i at row i*TBlockSize+k.
+ */
+template<size_t TBlockSize, typename TBlockMatrix, typename TScalarMatrix>
+void CreateBlockBenchmarkSystem(TBlockMatrix& Ablock, TScalarMatrix& Ascalar, size_t gridSize)
+{
+	const size_t N = TBlockSize;
+	const size_t n = gridSize*gridSize;
+	std::vector<double> diagBlock, offDiag;
+	CreateBlockBenchmarkCoefficients<TBlockSize>(diagBlock, offDiag);
+
+	Ablock.resize_and_clear(n, n);
+	Ascalar.resize_and_clear(n*N, n*N);
+
+	for(size_t y = 0; y < gridSize; ++y)
+		for(size_t x = 0; x < gridSize; ++x)
+		{
+			const size_t i = y*gridSize + x;
+			std::vector<size_t> neighbors;
+			if(y > 0) neighbors.push_back(i - gridSize);
+			if(x > 0) neighbors.push_back(i - 1);
+			if(x+1 < gridSize) neighbors.push_back(i + 1);
+			if(y+1 < gridSize) neighbors.push_back(i + gridSize);
+
+			typename TBlockMatrix::value_type& d = Ablock(i, i);
+			for(size_t r = 0; r < N; ++r)
+				for(size_t c = 0; c < N; ++c)
+				{
+					d(r, c) = diagBlock[r*N+c];
+					Ascalar(i*N+r, i*N+c) = diagBlock[r*N+c];
+				}
+
+			for(size_t k = 0; k < neighbors.size(); ++k)
+			{
+				const size_t j = neighbors[k];
+				typename TBlockMatrix::value_type& o = Ablock(i, j);
+				for(size_t r = 0; r < N; ++r)
+					for(size_t c = 0; c < N; ++c)
+					{
+						o(r, c) = offDiag[r*N+c];
+						Ascalar(i*N+r, j*N+c) = offDiag[r*N+c];
+					}
+			}
+		}
+
+	Ablock.defragment();
+	Ascalar.defragment();
+}
+
+/**
+ * Measures the runtime of the algebra kernels for a coupled system with
+ * TBlockSize unknowns per node (see CreateBlockBenchmarkSystem), once stored
+ * in the point-block format of CPUBlockAlgebra<TBlockSize> and once stored in
+ * the scalar format of CPUAlgebra. Timed are the matrix-vector product,
+ * the (block) Jacobi step, the (block) Gauss-Seidel step, the ILU
+ * factorization and the ILU application. The results are written to the log.
+ *
+ * \param[in]	gridSize	number of nodes per direction (gridSize^2 nodes)
+ * \param[in]	numReps		number of repetitions of each apply kernel
+ */
+template<size_t TBlockSize>
+void BenchmarkBlockKernels(size_t gridSize, size_t numReps)
+{
+	typedef DenseMatrix<FixedArray2<double, TBlockSize, TBlockSize> > block_type;
+	typedef SparseMatrix<block_type> block_matrix_type;
+	typedef Vector<DenseVector<FixedArray1<double, TBlockSize> > > block_vector_type;
+	typedef typename block_traits<block_type>::inverse_type block_inverse_type;
+	typedef SparseMatrix<double> scalar_matrix_type;
+	typedef Vector<double> scalar_vector_type;
+
+	const size_t N = TBlockSize;
+	const size_t n = gridSize*gridSize;
+	if(numReps == 0) numReps = 1;
+
+	block_matrix_type A;
+	scalar_matrix_type As;
+	CreateBlockBenchmarkSystem<TBlockSize>(A, As, gridSize);
+
+	block_vector_type x(n), b(n), c(n), h(n);
+	scalar_vector_type xs(n*N), bs(n*N), cs(n*N), hs(n*N);
+	x.set_random(-1.0, 1.0);
+	for(size_t i = 0; i < n; ++i)
+		for(size_t k = 0; k < N; ++k)
+			xs[i*N+k] = x[i][k];
+
+	double tBlock[5], tScalar[5], t;
+
+//	SpMV: b = A*x
+	t = get_clock_s();
+	for(size_t rep = 0; rep < numReps; ++rep) A.apply(b, x);
+	tBlock[0] = (get_clock_s() - t) / numReps;
+
+	t = get_clock_s();
+	for(size_t rep = 0; rep < numReps; ++rep) As.apply(bs, xs);
+	tScalar[0] = (get_clock_s() - t) / numReps;
+
+//	check that both formats compute the same matrix-vector product
+	double maxDiff = 0.0;
+	for(size_t i = 0; i < n; ++i)
+		for(size_t k = 0; k < N; ++k)
+			maxDiff = std::max(maxDiff, fabs(b[i][k] - bs[i*N+k]));
+
+//	Jacobi: c = D^{-1} b (inverse of block diagonal resp. of diagonal)
+	std::vector<block_inverse_type> diagInv(n);
+	for(size_t i = 0; i < n; ++i) GetInverse(diagInv[i], A(i,i));
+	std::vector<double> diagInvS(n*N);
+	for(size_t i = 0; i < n*N; ++i) diagInvS[i] = 1.0/As(i,i);
+
+	t = get_clock_s();
+	for(size_t rep = 0; rep < numReps; ++rep)
+		for(size_t i = 0; i < n; ++i)
+			MatMult(c[i], 1.0, diagInv[i], b[i]);
+	tBlock[1] = (get_clock_s() - t) / numReps;
+
+	t = get_clock_s();
+	for(size_t rep = 0; rep < numReps; ++rep)
+		for(size_t i = 0; i < n*N; ++i)
+			cs[i] = diagInvS[i] * bs[i];
+	tScalar[1] = (get_clock_s() - t) / numReps;
+
+//	Gauss-Seidel
+	t = get_clock_s();
+	for(size_t rep = 0; rep < numReps; ++rep) gs_step_LL(A, c, b, 1.0);
+	tBlock[2] = (get_clock_s() - t) / numReps;
+
+	t = get_clock_s();
+	for(size_t rep = 0; rep < numReps; ++rep) gs_step_LL(As, cs, bs, 1.0);
+	tScalar[2] = (get_clock_s() - t) / numReps;
+
+//	ILU factorization (in place, A and As are overwritten)
+	t = get_clock_s();
+	FactorizeILU(A);
+	tBlock[3] = get_clock_s() - t;
+
+	t = get_clock_s();
+	FactorizeILU(As);
+	tScalar[3] = get_clock_s() - t;
+
+//	ILU application: c = U^{-1} L^{-1} b
+	t = get_clock_s();
+	for(size_t rep = 0; rep < numReps; ++rep)
+	{
+		invert_L(A, h, b);
+		invert_U(A, c, h);
+	}
+	tBlock[4] = (get_clock_s() - t) / numReps;
+
+	t = get_clock_s();
+	for(size_t rep = 0; rep < numReps; ++rep)
+	{
+		invert_L(As, hs, bs);
+		invert_U(As, cs, hs);
+	}
+	tScalar[4] = (get_clock_s() - t) / numReps;
+
+	const char* kernels[5] = {"SpMV", "Jacobi step", "GS step", "ILU factorize", "ILU apply"};
+	UG_LOG("BenchmarkBlockKernels: block size " << N << ", " << n << " nodes, "
+			<< A.total_num_connections() << " block entries, " << numReps << " repetitions\n");
+	UG_LOG(std::setw(16) << "kernel" << std::setw(16) << "block [ms]"
+			<< std::setw(16) << "scalar [ms]" << std::setw(12) << "speedup" << "\n");
+	for(size_t k = 0; k < 5; ++k)
+		UG_LOG(std::setw(16) << kernels[k] << std::setw(16) << 1e3*tBlock[k]
+				<< std::setw(16) << 1e3*tScalar[k] << std::setw(12)
+				<< (tBlock[k] > 0.0 ? tScalar[k]/tBlock[k] : 0.0) << "\n");
+	UG_LOG("max. difference of SpMV results (block vs. scalar): " << maxDiff << "\n");
+}
+
+///	runs BenchmarkBlockKernels for the block sizes 2, 3, 4 and 6
+inline void BenchmarkBlockKernels(int blockSize, size_t gridSize, size_t numReps)
+{
+	switch(blockSize)
+	{
+		case 2: BenchmarkBlockKernels<2>(gridSize, numReps); break;
+		case 3: BenchmarkBlockKernels<3>(gridSize, numReps); break;
+		case 4: BenchmarkBlockKernels<4>(gridSize, numReps); break;
+		case 6: BenchmarkBlockKernels<6>(gridSize, numReps); break;
+		default: UG_THROW("BenchmarkBlockKernels: block size " << blockSize
+					<< " not supported, use 2, 3, 4 or 6.");
+	}
+}
+
+/// @}
+
+} // end namespace ug
+
+#endif /* __H__UG__LIB_ALGEBRA__ALGEBRA_COMMON__BLOCK_KERNEL_BENCHMARK__ */
@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__LIB_ALGEBRA__ALGEBRA_COMMON__MULTI_VECTOR__
+#define __H__UG__LIB_ALGEBRA__ALGEBRA_COMMON__MULTI_VECTOR__
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "common/common.h"
+#include "common/util/smart_pointer.h"
+#include "common/profiler/profiler.h"
+#include "lib_algebra/small_algebra/blocks.h"
+#include "lib_algebra/common/operations_vec.h"
+#ifdef UG_PARALLEL
+	#include "lib_algebra/parallelization/parallelization.h"
+#endif
+
+namespace ug{
+
+///	a set of vectors with the same layout, e.g. several right-hand sides
+/**
+ * The vectors are stored as individual vectors, so that every column can be
+ * passed to the usual single-vector interfaces (preconditioners, debug
+ * writers, ...). The block operations below (MultiVecProd, MultiVecNorms,
+ * MatMultMulti) work on all columns at once and need a single global
+ * reduction resp. a single sweep over the matrix.
+ *
+ * \tparam	TVector		vector type
+ */
+template <typename TVector>
+class MultiVector
+{
+	public:
+	///	vector type
+		typedef TVector vector_type;
+
+	public:
+	///	empty constructor
+		MultiVector() {}
+
+	///	creates k (uninitialized) vectors with the layout of a given vector
+		MultiVector(const vector_type& pattern, size_t k) {resize(pattern, k);}
+
+	///	resizes to k vectors with the layout of a given vector
+		void resize(const vector_type& pattern, size_t k)
+		{
+			m_vVec.resize(k);
+			for(size_t j = 0; j < k; ++j)
+				m_vVec[j] = pattern.clone_without_values();
+		}
+
+	///	adds a vector (no copy is made)
+		void push_back(SmartPtr<vector_type> spVec) {m_vVec.push_back(spVec);}
+
+	///	removes all vectors
+		void clear() {m_vVec.clear();}
+
+	///	number of vectors
+		size_t num_vectors() const {return m_vVec.size();}
+
+	///	access to a vector
+	/// \{
+		vector_type& operator[](size_t j) {return *m_vVec[j];}
+		const vector_type& operator[](size_t j) const {return *m_vVec[j];}
+	/// \}
+
+	///	returns the smart pointer to a vector
+		SmartPtr<vector_type> vec(size_t j) {return m_vVec[j];}
+
+	///	creates a deep copy
+		SmartPtr<MultiVector<vector_type> > clone() const
+		{
+			SmartPtr<MultiVector<vector_type> > sp(new MultiVector<vector_type>);
+			for(size_t j = 0; j < m_vVec.size(); ++j)
+				sp->push_back(m_vVec[j]->clone());
+			return sp;
+		}
+
+	///	returns pointers to all vectors (as needed by SparseMatrix::apply_multi)
+	/// \{
+		std::vector<vector_type*> pointers()
+		{
+			std::vector<vector_type*> v(m_vVec.size());
+			for(size_t j = 0; j < v.size(); ++j) v[j] = m_vVec[j].get();
+			return v;
+		}
+		std::vector<const vector_type*> const_pointers() const
+		{
+			std::vector<const vector_type*> v(m_vVec.size());
+			for(size_t j = 0; j < v.size(); ++j) v[j] = m_vVec[j].get();
+			return v;
+		}
+	/// \}
+
+	protected:
+		std::vector<SmartPtr<vector_type> > m_vVec;
+};
+
+namespace multi_vector_detail{
+
+///	sums the local values over all processes (no-op in serial)
+template <typename TVector>
+inline void AllreduceSum(const TVector& v, std::vector<number>& vLocal)
+{
+#ifdef UG_PARALLEL
+	if(vLocal.empty() || v.layouts()->proc_comm().empty()) return;
+	std::vector<number> vGlobal(vLocal.size());
+	v.layouts()->proc_comm().allreduce(&vLocal[0], &vGlobal[0], (int)vLocal.size(),
+	                                   PCL_DT_DOUBLE, PCL_RO_SUM);
+	vLocal.swap(vGlobal);
+#endif
+}
+
+///	checks that the storage types admit a dot product without communication
+template <typename TVector>
+inline void CheckProdStorageType(const TVector& a, const TVector& b)
+{
+#ifdef UG_PARALLEL
+	if(!((a.has_storage_type(PST_ADDITIVE) && b.has_storage_type(PST_CONSISTENT))
+		|| (a.has_storage_type(PST_CONSISTENT) && b.has_storage_type(PST_ADDITIVE))
+		|| (a.has_storage_type(PST_UNIQUE) && b.has_storage_type(PST_UNIQUE))))
+		UG_THROW("MultiVecProd: Inadequate storage types (" << a.get_storage_type()
+		         << ", " << b.get_storage_type() << "), needed are additive/consistent "
+		         "or unique/unique.");
+#endif
+}
+
+} // end namespace multi_vector_detail
+
+///	number of rows processed at once by the block operations (cache blocking)
+const size_t MULTI_VECTOR_CHUNK_SIZE = 512;
+
+///	computes M = X^T Y with a single global reduction (row-major, X.num_vectors() x Y.num_vectors())
+/**
+ * The storage types of X and Y must be additive/consistent or unique/unique.
+ * The rows are processed in chunks, so that all products are computed with a
+ * single pass over the vectors.
+ */
+template <typename TVector>
+void MultiVecProd(std::vector<number>& M, const MultiVector<TVector>& X,
+                  const MultiVector<TVector>& Y)
+{
+	PROFILE_FUNC_GROUP("algebra");
+	const size_t nx = X.num_vectors(), ny = Y.num_vectors();
+	M.assign(nx*ny, 0.0);
+	if(nx == 0 || ny == 0) return;
+
+	for(size_t a = 0; a < nx; ++a)
+		for(size_t b = 0; b < ny; ++b)
+			multi_vector_detail::CheckProdStorageType(X[a], Y[b]);
+
+	const size_t n = X[0].size();
+	for(size_t i0 = 0; i0 < n; i0 += MULTI_VECTOR_CHUNK_SIZE)
+	{
+		const size_t i1 = std::min(n, i0 + MULTI_VECTOR_CHUNK_SIZE);
+		for(size_t a = 0; a < nx; ++a)
+		{
+			const TVector& x = X[a];
+			for(size_t b = 0; b < ny; ++b)
+			{
+				const TVector& y = Y[b];
+				double s = 0.0;
+				for(size_t i = i0; i < i1; ++i)
+					VecProdAdd(x[i], y[i], s);
+				M[a*ny+b] += s;
+			}
+		}
+	}
+
+	multi_vector_detail::AllreduceSum(X[0], M);
+}
+
+///	computes Y[j] := Y[j] + alpha * sum_i C(i,j) X[i] (C row-major, X.num_vectors() x Y.num_vectors())
+/**
+ * The rows are processed in chunks, so that all updates are computed with a
+ * single pass over the vectors.
+ */
+template <typename TVector>
+void MultiVecScaleAppend(MultiVector<TVector>& Y, number alpha,
+                         const MultiVector<TVector>& X, const std::vector<number>& C)
+{
+	PROFILE_FUNC_GROUP("algebra");
+	const size_t nx = X.num_vectors(), ny = Y.num_vectors();
+	UG_COND_THROW(C.size() != nx*ny, "MultiVecScaleAppend: wrong size of coefficients.");
+	if(nx == 0 || ny == 0) return;
+
+	const size_t n = Y[0].size();
+	for(size_t i0 = 0; i0 < n; i0 += MULTI_VECTOR_CHUNK_SIZE)
+	{
+		const size_t i1 = std::min(n, i0 + MULTI_VECTOR_CHUNK_SIZE);
+		for(size_t b = 0; b < ny; ++b)
+		{
+			TVector& y = Y[b];
+			for(size_t a = 0; a < nx; ++a)
+			{
+				const number c = alpha * C[a*ny+b];
+				if(c == 0.0) continue;
+				const TVector& x = X[a];
+				for(size_t i = i0; i < i1; ++i)
+					VecScaleAdd(y[i], 1.0, y[i], c, x[i]);
+			}
+		}
+	}
+
+#ifdef UG_PARALLEL
+	uint mask = X[0].get_storage_mask();
+	for(size_t a = 1; a < nx; ++a) mask &= X[a].get_storage_mask();
+	for(size_t b = 0; b < ny; ++b)
+	{
+		const uint m = mask & Y[b].get_storage_mask();
+		UG_COND_THROW(m == 0, "MultiVecScaleAppend: incompatible storage types.");
+		Y[b].set_storage_type(m);
+	}
+#endif
+}
+
+///	computes the euclidean norms of all vectors with a single global reduction
+/**
+ * In parallel, the vectors are changed to unique storage type.
+ */
+template <typename TVector>
+void MultiVecNorms(std::vector<number>& vNorm, MultiVector<TVector>& X)
+{
+	PROFILE_FUNC_GROUP("algebra");
+	vNorm.assign(X.num_vectors(), 0.0);
+	if(vNorm.empty()) return;
+
+	for(size_t j = 0; j < X.num_vectors(); ++j)
+	{
+		TVector& x = X[j];
+#ifdef UG_PARALLEL
+		if(!x.change_storage_type(PST_UNIQUE))
+			UG_THROW("MultiVecNorms: Cannot change storage type to unique.");
+#endif
+		double s = 0.0;
+		for(size_t i = 0; i < x.size(); ++i)
+			s += BlockNorm2(x[i]);
+		vNorm[j] = s;
+	}
+
+	multi_vector_detail::AllreduceSum(X[0], vNorm);
+	for(size_t j = 0; j < vNorm.size(); ++j)
+		vNorm[j] = std::sqrt(vNorm[j]);
+}
+
+///	computes an orthonormal basis of the span of m vectors from their Gram matrix
+/**
+ * Given the symmetric positive semi-definite Gram matrix G (m x m, row-major)
+ * of the vectors X (w.r.t. some inner product), the Cholesky factorization
+ * G = L L^T is computed. Columns with a (numerically) vanishing pivot depend
+ * linearly on the previous ones and are skipped. For the n kept columns
+ *
+ * - C (m x n, row-major) contains the coefficients of the orthonormal basis
+ *   X C, i.e. C = L^{-T} on the kept columns,
+ * - S (n x m, row-major) contains the coefficients of the vectors X in this
+ *   basis, i.e. X = (X C) S up to the dropped components.
+ *
+ * \returns	the number n of kept columns
+ */
+inline size_t CholeskyOrthonormalBasis(std::vector<number>& C, std::vector<number>& S,
+                                       const std::vector<number>& G, size_t m)
+{
+	std::vector<size_t> vKeep;
+	std::vector<number> L(m*m, 0.0);
+
+//	Cholesky factorization, columns with a vanishing pivot are skipped
+	for(size_t j = 0; j < m; ++j)
+	{
+		const number diag = G[j*m+j];
+		number d = diag;
+		for(size_t a = 0; a < vKeep.size(); ++a)
+			d -= L[j*m+vKeep[a]]*L[j*m+vKeep[a]];
+		if(!(d > 1e-12*diag) || d <= 0.0) continue;
+		d = std::sqrt(d);
+		L[j*m+j] = d;
+		for(size_t i = j+1; i < m; ++i)
+		{
+			number s = 0.5*(G[i*m+j] + G[j*m+i]);
+			for(size_t a = 0; a < vKeep.size(); ++a)
+				s -= L[i*m+vKeep[a]]*L[j*m+vKeep[a]];
+			L[i*m+j] = s/d;
+		}
+		vKeep.push_back(j);
+	}
+
+	const size_t n = vKeep.size();
+	C.assign(m*n, 0.0);
+	S.assign(n*m, 0.0);
+	if(n == 0) return 0;
+
+//	T := L^{-T} on the kept columns (upper triangular)
+	std::vector<number> T(n*n, 0.0);
+	for(size_t b = 0; b < n; ++b)
+	{
+	//	solve L^T t = e_b, t is zero below entry b
+		T[b*n+b] = 1.0 / L[vKeep[b]*m+vKeep[b]];
+		for(size_t a = b; a-- > 0; )
+		{
+			number sum = 0.0;
+			for(size_t c = a+1; c <= b; ++c)
+				sum += L[vKeep[c]*m+vKeep[a]] * T[c*n+b];
+			T[a*n+b] = -sum / L[vKeep[a]*m+vKeep[a]];
+		}
+	}
+
+	for(size_t a = 0; a < n; ++a)
+		for(size_t b = 0; b < n; ++b)
+			C[vKeep[a]*n+b] = T[a*n+b];
+
+//	S := L^T on the kept rows
+	for(size_t a = 0; a < n; ++a)
+		for(size_t j = vKeep[a]; j < m; ++j)
+			S[a*m+j] = L[j*m+vKeep[a]];
+
+	return n;
+}
+
+///	computes Y = A X for all vectors in one sweep over the matrix (SpMM)
+template <typename TMatrix, typename TVector>
+void MatMultMulti(MultiVector<TVector>& Y, const TMatrix& A, const MultiVector<TVector>& X)
+{
+	PROFILE_FUNC_GROUP("algebra");
+	UG_COND_THROW(Y.num_vectors() != X.num_vectors(),
+	              "MatMultMulti: number of vectors does not match.");
+	if(X.num_vectors() == 0) return;
+
+#ifdef UG_PARALLEL
+	ParallelStorageType type = GetMultType(A, X[0]);
+	for(size_t j = 1; j < X.num_vectors(); ++j)
+		UG_COND_THROW(GetMultType(A, X[j]) != type,
+		              "MatMultMulti: all vectors must have the same storage type.");
+#endif
+
+	A.apply_multi(Y.pointers(), 1.0, X.const_pointers());
+
+#ifdef UG_PARALLEL
+	for(size_t j = 0; j < Y.num_vectors(); ++j)
+		Y[j].set_storage_type(type);
+#endif
+}
+
+} // end namespace ug
+
+#endif /* __H__UG__LIB_ALGEBRA__ALGEBRA_COMMON__MULTI_VECTOR__ */
@@ -176,6 +176,15 @@ public:
 	void apply_transposed_ignore_zero_rows(vector_t &dest,
 			const number &beta1, const vector_t &w1) const;
 
+	//! calculate vDest[j] = beta1*A*vW1[j] for all j in one sweep over the matrix (SpMM)
+	/**
+	 * Each matrix row is loaded once and applied to all vectors, so that the
+	 * memory traffic for A is shared by all vectors.
+	 */
+	template<typename vector_t>
+	void apply_multi(const std::vector<vector_t*> &vDest,
+			const number &beta1, const std::vector<const vector_t*> &vW1) const;
+
 	// DEPRECATED!
 	//! calculate res = A x
 		// apply is deprecated because of axpy(res, 0.0, res, 1.0, beta, w1)
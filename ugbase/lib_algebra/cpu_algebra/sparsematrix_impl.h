@@ -307,6 +307,35 @@ void SparseMatrix<T>::apply_transposed_ignore_zero_rows(vector_t &dest,
 }
 
 
+template<typename T>
+template<typename vector_t>
+void SparseMatrix<T>::apply_multi(const std::vector<vector_t*> &vDest,
+		const number &beta1, const std::vector<const vector_t*> &vW1) const
+{
+	PROFILE_SPMATRIX(SparseMatrix_apply_multi);
+	check_fragmentation();
+	UG_ASSERT(vDest.size() == vW1.size(), "number of vectors must match");
+	const size_t k = vDest.size();
+	for(size_t i=0; i < num_rows(); i++)
+	{
+		const size_t rowStartIt=rowStart[i];
+		const size_t itEnd=rowEnd[i];
+		for(size_t j=0; j < k; j++)
+		{
+			typename vector_t::value_type &d = (*vDest[j])[i];
+			const vector_t &w1 = *vW1[j];
+			if(rowStartIt == itEnd)
+			{
+				d = 0.0;
+				continue;
+			}
+			MatMult(d, beta1, values[rowStartIt], w1[cols[rowStartIt]]);
+			for(size_t rowIt=rowStartIt+1; rowIt != itEnd; ++rowIt)
+				MatMultAdd(d, 1.0, d, beta1, values[rowIt], w1[cols[rowIt]]);
+		}
+	}
+}
+
 template<typename T>
 void SparseMatrix<T>::set(double a)
 {
@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__LIB_DISC__OPERATOR__LINEAR_SOLVER__BLOCK_CG__
+#define __H__UG__LIB_DISC__OPERATOR__LINEAR_SOLVER__BLOCK_CG__
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "lib_algebra/algebra_common/multi_vector.h"
+#include "lib_algebra/operator/interface/linear_iterator.h"
+#include "lib_algebra/operator/interface/matrix_operator.h"
+#include "lib_algebra/operator/convergence_check.h"
+#include "common/profiler/profiler.h"
+#ifdef UG_PARALLEL
+	#include "lib_algebra/parallelization/parallelization.h"
+#endif
+
+namespace ug{
+
+///	the block CG method for several right-hand sides
+/**
+ * This class implements the preconditioned block CG method for A*X = B,
+ * where B contains k right-hand sides of the same symmetric positive
+ * definite matrix A. All right-hand sides share a single Krylov space, so
+ * that each iteration
+ *
+ * - applies A to all search directions in one sweep over the matrix (SpMM),
+ * - needs only three global reductions, independent of k.
+ *
+ * The search directions are kept A-orthonormal (by a Cholesky factorization
+ * of P^T A P), linearly dependent directions and directions of converged
+ * right-hand sides are dropped. Thus the method does not break down when
+ * the residuals become (numerically) dependent.
+ *
+ * The convergence check is cloned for every right-hand side, so that each
+ * right-hand side is checked with the same criteria as in a single solve.
+ *
+ * For detailed description of the algorithm, please refer to:
+ *
+ * - O'Leary, "The block conjugate gradient algorithm and related methods",
+ *   Linear Algebra Appl. 29 (1980), pp. 293-322
+ * - Dubrulle, "Retooling the method of block conjugate gradients",
+ *   Electron. Trans. Numer. Anal. 12 (2001), pp. 216-233
+ *
+ * \tparam 	TAlgebra		algebra type
+ */
+template <typename TAlgebra>
+class BlockCG
+{
+	public:
+	///	Algebra type
+		typedef TAlgebra algebra_type;
+
+	///	Vector type
+		typedef typename TAlgebra::vector_type vector_type;
+
+	///	Matrix type
+		typedef typename TAlgebra::matrix_type matrix_type;
+
+	///	Matrix Operator type
+		typedef MatrixOperator<matrix_type, vector_type> matrix_operator_type;
+
+	///	Multi vector type
+		typedef MultiVector<vector_type> multi_vector_type;
+
+	public:
+	///	constructor setting convergence check to (100, 1e-12, 1e-12, true)
+		BlockCG()
+			: m_spConvCheck(new StdConvCheck<vector_type>(100, 1e-12, 1e-12, true)),
+			  m_step(0)
+		{}
+
+	///	constructor setting the preconditioner and the convergence check
+		BlockCG(SmartPtr<ILinearIterator<vector_type> > spPrecond,
+		        SmartPtr<IConvergenceCheck<vector_type> > spConvCheck)
+			: m_spPrecond(spPrecond), m_spConvCheck(spConvCheck), m_step(0)
+		{}
+
+	///	name of solver
+		const char* name() const {return "BlockCG";}
+
+	///	sets the preconditioner
+		void set_preconditioner(SmartPtr<ILinearIterator<vector_type> > spPrecond)
+		{
+			m_spPrecond = spPrecond;
+		}
+
+	///	sets the convergence check
+	/**
+	 * The convergence check is cloned for every right-hand side. The
+	 * iteration of a right-hand side ends, if its clone reports so.
+	 */
+		void set_convergence_check(SmartPtr<IConvergenceCheck<vector_type> > spConvCheck)
+		{
+			m_spConvCheck = spConvCheck;
+			m_spConvCheck->set_offset(3);
+		}
+
+	///	returns the number of iterations of the last solve
+		int step() const {return m_step;}
+
+	///	returns the defect norms of the last solve
+		const std::vector<number>& defects() const {return m_vDefect;}
+
+	///	initializes the solver (and the preconditioner) for a matrix
+		bool init(SmartPtr<matrix_operator_type> spA)
+		{
+			m_spA = spA;
+			if(m_spPrecond.valid())
+				if(!m_spPrecond->init(spA))
+					UG_THROW(name() << "::init: Cannot init Preconditioner.");
+			return true;
+		}
+
+	///	Solve A*X = B, B is left unchanged
+		bool apply(multi_vector_type& X, const multi_vector_type& B)
+		{
+			SmartPtr<multi_vector_type> spR = B.clone();
+			return apply_return_defect(X, *spR);
+		}
+
+	///	Solve A*X = B, on exit B contains the defects
+		bool apply_return_defect(multi_vector_type& X, multi_vector_type& B)
+		{
+			PROFILE_BEGIN_GROUP(BlockCG_apply_return_defect, "CG algebra");
+			UG_COND_THROW(m_spA.invalid(), name() << ": init(A) must be called first.");
+			UG_COND_THROW(m_spConvCheck.invalid(), name() << ": no convergence check set.");
+			UG_COND_THROW(X.num_vectors() != B.num_vectors(),
+			              name() << ": number of solutions and right-hand sides differ.");
+			const size_t k = X.num_vectors();
+			m_step = 0;
+			m_vDefect.clear();
+			if(k == 0) return true;
+
+		//	check parallel storage types
+			#ifdef UG_PARALLEL
+			for(size_t j = 0; j < k; ++j)
+				if(!B[j].has_storage_type(PST_ADDITIVE) || !X[j].has_storage_type(PST_CONSISTENT))
+					UG_THROW(name() << "::apply_return_defect: "
+					         "Inadequate storage format of Vectors.");
+			#endif
+
+			matrix_operator_type& A = *m_spA;
+
+		// 	rename R as B (for convenience), R := B - A*X
+			multi_vector_type& R = B;
+			multi_vector_type AX(X[0], k);
+			MatMultMulti(AX, A, X);
+			for(size_t j = 0; j < k; ++j)
+				VecScaleAdd(R[j], 1.0, R[j], -1.0, AX[j]);
+
+		//	start defects
+			MultiVecNorms(m_vDefect, R);
+			std::vector<SmartPtr<IConvergenceCheck<vector_type> > > vConvCheck;
+			prepare_conv_checks(vConvCheck, k);
+			for(size_t j = 0; j < k; ++j)
+				vConvCheck[j]->start_defect(m_vDefect[j]);
+
+			std::vector<bool> vActive;
+			if(update_active(vActive, vConvCheck))
+			{
+			//	Z := M^{-1} R, P := Z
+				multi_vector_type Z(X[0], k);
+				if(!precondition(Z, R)) return false;
+				multi_vector_type P;
+				for(size_t j = 0; j < k; ++j)
+					if(vActive[j]) P.push_back(Z[j].clone());
+
+				std::vector<number> G, alpha, beta;
+				while(true)
+				{
+					++m_step;
+
+				//	Q := A*P
+					multi_vector_type Q(X[0], P.num_vectors());
+					MatMultMulti(Q, A, P);
+
+				//	A-orthonormalize P (and Q accordingly), drop dependent directions
+					MultiVecProd(G, P, Q);
+					if(!orthonormalize(P, Q, G))
+					{
+						UG_LOG("ERROR in '" << name() << "::apply_return_defect': "
+						       "no search directions left. Aborting solver.\n");
+						return false;
+					}
+
+				//	alpha := P^T R, X := X + P*alpha, R := R - Q*alpha
+					MultiVecProd(alpha, P, R);
+					MultiVecScaleAppend(X, 1.0, P, alpha);
+					MultiVecScaleAppend(R, -1.0, Q, alpha);
+
+				//	check convergence of the active right-hand sides
+					MultiVecNorms(m_vDefect, R);
+					for(size_t j = 0; j < k; ++j)
+						if(vActive[j]) vConvCheck[j]->update_defect(m_vDefect[j]);
+					if(!update_active(vActive, vConvCheck)) break;
+
+				//	Z := M^{-1} R
+					if(!precondition(Z, R)) return false;
+
+				//	beta := Q^T Z, P := Z - P*beta (for the active right-hand sides)
+					MultiVecProd(beta, Q, Z);
+					const size_t s = P.num_vectors();
+					multi_vector_type PNew;
+					std::vector<number> betaActive;
+					for(size_t j = 0; j < k; ++j)
+						if(vActive[j]) PNew.push_back(Z[j].clone());
+					const size_t numActive = PNew.num_vectors();
+					betaActive.resize(s*numActive);
+					for(size_t i = 0; i < s; ++i)
+						for(size_t j = 0, a = 0; j < k; ++j)
+							if(vActive[j]) betaActive[i*numActive + a++] = beta[i*k+j];
+					MultiVecScaleAppend(PNew, -1.0, P, betaActive);
+					P = PNew;
+				}
+			}
+
+		//	post-process the convergence checks
+			bool bConverged = true;
+			for(size_t j = 0; j < k; ++j)
+				if(!vConvCheck[j]->post()) bConverged = false;
+			return bConverged;
+		}
+
+	///	returns information about configuration parameters
+		std::string config_string() const
+		{
+			std::stringstream ss;
+			ss << name() << "\n";
+			ss << " Convergence Check: ";
+			if(m_spConvCheck.valid()) ss << ConfigShift(m_spConvCheck->config_string()) << "\n";
+			else ss << "  NOT SET!\n";
+			ss << " Preconditioner: ";
+			if(m_spPrecond.valid()) ss << ConfigShift(m_spPrecond->config_string()) << "\n";
+			else ss << "  NOT SET!\n";
+			return ss.str();
+		}
+
+	protected:
+	///	creates one convergence check per right-hand side
+		void prepare_conv_checks(std::vector<SmartPtr<IConvergenceCheck<vector_type> > >& vConvCheck,
+		                         size_t k)
+		{
+			std::string precond;
+			if(m_spPrecond.valid())
+				precond = std::string("Precond: ") + m_spPrecond->name();
+			else
+				precond = "No Preconditioner";
+
+			vConvCheck.resize(k);
+			for(size_t j = 0; j < k; ++j)
+			{
+				vConvCheck[j] = m_spConvCheck->clone();
+				vConvCheck[j]->set_name(name());
+				vConvCheck[j]->set_symbol('%');
+				vConvCheck[j]->set_info(mkstr(" (rhs " << j << ", " << precond << ")"));
+			}
+		}
+
+	///	marks the right-hand sides whose iteration did not yet end, returns false if all ended
+		bool update_active(std::vector<bool>& vActive,
+		                   std::vector<SmartPtr<IConvergenceCheck<vector_type> > >& vConvCheck) const
+		{
+			vActive.resize(vConvCheck.size());
+			bool bAny = false;
+			for(size_t j = 0; j < vConvCheck.size(); ++j)
+			{
+				vActive[j] = !vConvCheck[j]->iteration_ended();
+				bAny = bAny || vActive[j];
+			}
+			return bAny;
+		}
+
+	///	computes the consistent corrections Z = M^{-1} R
+		bool precondition(multi_vector_type& Z, multi_vector_type& R)
+		{
+			for(size_t j = 0; j < R.num_vectors(); ++j)
+			{
+				if(m_spPrecond.valid())
+				{
+					if(!m_spPrecond->apply(Z[j], R[j]))
+					{
+						UG_LOG("ERROR in '" << name() << "::apply_return_defect': "
+								"Cannot apply preconditioner. Aborting.\n");
+						return false;
+					}
+				}
+				else Z[j] = R[j];
+
+				#ifdef UG_PARALLEL
+				if(!Z[j].change_storage_type(PST_CONSISTENT))
+					UG_THROW(name() << "::apply_return_defect: "
+							"Cannot convert z to consistent vector.");
+				#endif
+			}
+			return true;
+		}
+
+	///	P := P L^{-T}, Q := Q L^{-T} with P^T A P = L L^T, dependent directions are removed
+		bool orthonormalize(multi_vector_type& P, multi_vector_type& Q, const std::vector<number>& G)
+		{
+			std::vector<number> C, S;
+			const size_t n = CholeskyOrthonormalBasis(C, S, G, P.num_vectors());
+			if(n == 0) return false;
+
+			multi_vector_type PNew(P[0], n), QNew(Q[0], n);
+			for(size_t b = 0; b < n; ++b) {PNew[b].set(0.0); QNew[b].set(0.0);}
+			MultiVecScaleAppend(PNew, 1.0, P, C);
+			MultiVecScaleAppend(QNew, 1.0, Q, C);
+			P = PNew; Q = QNew;
+			return true;
+		}
+
+	protected:
+	///	matrix
+		SmartPtr<matrix_operator_type> m_spA;
+
+	///	preconditioner
+		SmartPtr<ILinearIterator<vector_type> > m_spPrecond;
+
+	///	convergence check (cloned for every right-hand side)
+		SmartPtr<IConvergenceCheck<vector_type> > m_spConvCheck;
+
+	///	number of iterations of last solve
+		int m_step;
+
+	///	defect norms of last solve
+		std::vector<number> m_vDefect;
+};
+
+} // end namespace ug
+
+#endif /* __H__UG__LIB_DISC__OPERATOR__LINEAR_SOLVER__BLOCK_CG__ */
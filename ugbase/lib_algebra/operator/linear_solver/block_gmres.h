@@ -0,0 +1,519 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__LIB_DISC__OPERATOR__LINEAR_SOLVER__BLOCK_GMRES__
+#define __H__UG__LIB_DISC__OPERATOR__LINEAR_SOLVER__BLOCK_GMRES__
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <cmath>
+
+#include "lib_algebra/algebra_common/multi_vector.h"
+#include "lib_algebra/operator/interface/linear_iterator.h"
+#include "lib_algebra/operator/interface/matrix_operator.h"
+#include "lib_algebra/operator/convergence_check.h"
+#include "common/profiler/profiler.h"
+#ifdef UG_PARALLEL
+	#include "lib_algebra/parallelization/parallelization.h"
+#endif
+
+namespace ug{
+
+///	the restarted block GMRES method for several right-hand sides
+/**
+ * This class implements the right preconditioned block GMRES method for
+ * A*X = B, where B contains k right-hand sides of the same (not necessarily
+ * symmetric) matrix A. All right-hand sides share a single block Krylov space
+ * of A M^{-1}, so that each block Arnoldi step
+ *
+ * - applies A to all basis vectors of the new block in one sweep over the
+ *   matrix (SpMM),
+ * - needs three global reductions (two for the block classical Gram-Schmidt
+ *   with reorthogonalization, one for the Cholesky QR of the new block),
+ *   independent of k.
+ *
+ * The block upper Hessenberg matrix is reduced to triangular form by Givens
+ * rotations while it is built, so that the residual norm of every
+ * right-hand side is known in every step without further communication. As
+ * the method is right preconditioned, these are the norms of the true
+ * residuals. The iteration is restarted after 'restart' block steps, where
+ * only the right-hand sides that did not yet converge are continued.
+ * Linearly dependent residuals are removed from the starting block. If a new
+ * block becomes rank deficient, the cycle is finished and restarted.
+ *
+ * The convergence check is cloned for every right-hand side, so that each
+ * right-hand side is checked with the same criteria as in a single solve.
+ *
+ * For detailed description of the algorithm, please refer to:
+ *
+ * - Saad, "Iterative Methods for Sparse Linear Systems", 2nd ed., SIAM (2003),
+ *   section 6.12
+ * - Gutknecht, "Block Krylov space methods for linear systems with multiple
+ *   right-hand sides: an introduction" (2006)
+ *
+ * \tparam 	TAlgebra		algebra type
+ */
+template <typename TAlgebra>
+class BlockGMRES
+{
+	public:
+	///	Algebra type
+		typedef TAlgebra algebra_type;
+
+	///	Vector type
+		typedef typename TAlgebra::vector_type vector_type;
+
+	///	Matrix type
+		typedef typename TAlgebra::matrix_type matrix_type;
+
+	///	Matrix Operator type
+		typedef MatrixOperator<matrix_type, vector_type> matrix_operator_type;
+
+	///	Multi vector type
+		typedef MultiVector<vector_type> multi_vector_type;
+
+	public:
+	///	constructor setting convergence check to (100, 1e-12, 1e-12, true)
+		BlockGMRES(size_t restart)
+			: m_spConvCheck(new StdConvCheck<vector_type>(100, 1e-12, 1e-12, true)),
+			  m_restart(restart), m_step(0)
+		{
+			UG_COND_THROW(restart < 1, name() << ": restart must be at least 1.");
+		}
+
+	///	constructor setting the preconditioner and the convergence check
+		BlockGMRES(size_t restart,
+		           SmartPtr<ILinearIterator<vector_type> > spPrecond,
+		           SmartPtr<IConvergenceCheck<vector_type> > spConvCheck)
+			: m_spPrecond(spPrecond), m_spConvCheck(spConvCheck),
+			  m_restart(restart), m_step(0)
+		{
+			UG_COND_THROW(restart < 1, name() << ": restart must be at least 1.");
+		}
+
+	///	name of solver
+		const char* name() const {return "BlockGMRES";}
+
+	///	sets the preconditioner
+		void set_preconditioner(SmartPtr<ILinearIterator<vector_type> > spPrecond)
+		{
+			m_spPrecond = spPrecond;
+		}
+
+	///	sets the convergence check
+	/**
+	 * The convergence check is cloned for every right-hand side. The
+	 * iteration of a right-hand side ends, if its clone reports so.
+	 */
+		void set_convergence_check(SmartPtr<IConvergenceCheck<vector_type> > spConvCheck)
+		{
+			m_spConvCheck = spConvCheck;
+			m_spConvCheck->set_offset(3);
+		}
+
+	///	returns the number of block Arnoldi steps of the last solve
+		int step() const {return m_step;}
+
+	///	returns the defect norms of the last solve
+		const std::vector<number>& defects() const {return m_vDefect;}
+
+	///	initializes the solver (and the preconditioner) for a matrix
+		bool init(SmartPtr<matrix_operator_type> spA)
+		{
+			m_spA = spA;
+			if(m_spPrecond.valid())
+				if(!m_spPrecond->init(spA))
+					UG_THROW(name() << "::init: Cannot init Preconditioner.");
+			return true;
+		}
+
+	///	Solve A*X = B, B is left unchanged
+		bool apply(multi_vector_type& X, const multi_vector_type& B)
+		{
+			SmartPtr<multi_vector_type> spR = B.clone();
+			return apply_return_defect(X, *spR);
+		}
+
+	///	Solve A*X = B, on exit B contains the defects
+		bool apply_return_defect(multi_vector_type& X, multi_vector_type& B)
+		{
+			PROFILE_BEGIN_GROUP(BlockGMRES_apply_return_defect, "algebra BlockGMRES");
+			UG_COND_THROW(m_spA.invalid(), name() << ": init(A) must be called first.");
+			UG_COND_THROW(m_spConvCheck.invalid(), name() << ": no convergence check set.");
+			UG_COND_THROW(X.num_vectors() != B.num_vectors(),
+			              name() << ": number of solutions and right-hand sides differ.");
+			const size_t k = X.num_vectors();
+			m_step = 0;
+			m_vDefect.clear();
+			if(k == 0) return true;
+
+		//	check parallel storage types
+			#ifdef UG_PARALLEL
+			for(size_t j = 0; j < k; ++j)
+				if(!B[j].has_storage_type(PST_ADDITIVE) || !X[j].has_storage_type(PST_CONSISTENT))
+					UG_THROW(name() << "::apply_return_defect: "
+					         "Inadequate storage format of Vectors.");
+			#endif
+
+		// 	rename R as B (for convenience), R := B - A*X
+			multi_vector_type& R = B;
+			multi_vector_type AX(X[0], k);
+			MatMultMulti(AX, *m_spA, X);
+			for(size_t j = 0; j < k; ++j)
+				VecScaleAdd(R[j], 1.0, R[j], -1.0, AX[j]);
+
+		//	start defects (R is unique afterwards)
+			MultiVecNorms(m_vDefect, R);
+			std::vector<SmartPtr<IConvergenceCheck<vector_type> > > vConvCheck;
+			prepare_conv_checks(vConvCheck, k);
+			for(size_t j = 0; j < k; ++j)
+				vConvCheck[j]->start_defect(m_vDefect[j]);
+
+			std::vector<size_t> vActive;
+			while(update_active(vActive, vConvCheck))
+			{
+				bool bProgress;
+				if(!cycle(X, R, vActive, vConvCheck, bProgress)) return false;
+				if(!bProgress)
+				{
+					UG_LOG("ERROR in '" << name() << "::apply_return_defect': "
+					       "no search directions left. Aborting solver.\n");
+					break;
+				}
+			}
+
+		//	post-process the convergence checks
+			bool bConverged = true;
+			for(size_t j = 0; j < k; ++j)
+				if(!vConvCheck[j]->post()) bConverged = false;
+			return bConverged;
+		}
+
+	///	returns information about configuration parameters
+		std::string config_string() const
+		{
+			std::stringstream ss;
+			ss << name() << " ( restart = " << m_restart << ")\n";
+			ss << " Convergence Check: ";
+			if(m_spConvCheck.valid()) ss << ConfigShift(m_spConvCheck->config_string()) << "\n";
+			else ss << "  NOT SET!\n";
+			ss << " Preconditioner: ";
+			if(m_spPrecond.valid()) ss << ConfigShift(m_spPrecond->config_string()) << "\n";
+			else ss << "  NOT SET!\n";
+			return ss.str();
+		}
+
+	protected:
+	///	performs one cycle of at most m_restart block Arnoldi steps for the active right-hand sides
+	/**
+	 * X and R are updated for the right-hand sides in vActive. bProgress is
+	 * set to false, if no search direction could be built.
+	 */
+		bool cycle(multi_vector_type& X, multi_vector_type& R,
+		           const std::vector<size_t>& vActive,
+		           std::vector<SmartPtr<IConvergenceCheck<vector_type> > >& vConvCheck,
+		           bool& bProgress)
+		{
+			const size_t kc = vActive.size();
+			const size_t m = m_restart;
+
+		//	starting block: orthonormal basis of the active residuals, R_act = V_0 S
+			multi_vector_type RAct;
+			for(size_t l = 0; l < kc; ++l) RAct.push_back(R.vec(vActive[l]));
+			std::vector<number> G, C, S;
+			MultiVecProd(G, RAct, RAct);
+			const size_t s = CholeskyOrthonormalBasis(C, S, G, kc);
+			bProgress = (s > 0);
+			if(!bProgress) return true;
+
+		//	basis V = [V_0, ..., V_j] (unique)
+			multi_vector_type V;
+			append_basis(V, RAct, C, s);
+
+		//	block Hessenberg matrix (reduced by Givens rotations) and right-hand side
+			const size_t numRows = (m+1)*s, numCols = m*s;
+			std::vector<number> H(numRows*numCols, 0.0);
+			std::vector<number> Gs(numRows*kc, 0.0);
+			for(size_t a = 0; a < s; ++a)
+				for(size_t l = 0; l < kc; ++l)
+					Gs[a*kc+l] = S[a*kc+l];
+			std::vector<number> rotC(numCols*s), rotS(numCols*s);
+
+			size_t numSteps = 0;
+			for(size_t j = 0; j < m; ++j)
+			{
+				++m_step;
+				numSteps = j+1;
+
+			//	W := A M^{-1} V_j
+				multi_vector_type Vj, W(R[0], s);
+				for(size_t t = 0; t < s; ++t) Vj.push_back(V.vec(j*s+t));
+				if(!apply_operator(W, Vj)) return false;
+
+			//	block classical Gram-Schmidt with reorthogonalization
+				std::vector<number> Hc;
+				for(int pass = 0; pass < 2; ++pass)
+				{
+					MultiVecProd(Hc, V, W);
+					MultiVecScaleAppend(W, -1.0, V, Hc);
+					for(size_t r = 0; r < V.num_vectors(); ++r)
+						for(size_t t = 0; t < s; ++t)
+							H[r*numCols + j*s+t] += Hc[r*s+t];
+				}
+
+			//	Cholesky QR of the new block, W = V_{j+1} S
+				MultiVecProd(G, W, W);
+				const size_t n = CholeskyOrthonormalBasis(C, S, G, s);
+				for(size_t a = 0; a < n; ++a)
+					for(size_t t = 0; t < s; ++t)
+						H[((j+1)*s+a)*numCols + j*s+t] = S[a*s+t];
+				const bool bBreakdown = (n < s);
+				if(!bBreakdown && j+1 < m)
+					append_basis(V, W, C, s);
+
+			//	reduce the new columns to upper triangular form
+				for(size_t t = 0; t < s; ++t)
+					triangularize_column(H, Gs, rotC, rotS, j*s+t, s, numCols, kc);
+
+			//	the residual norms are the norms of the last block of Gs
+				for(size_t l = 0; l < kc; ++l)
+				{
+					number res = 0.0;
+					for(size_t a = 0; a < s; ++a)
+						res += Gs[((j+1)*s+a)*kc+l]*Gs[((j+1)*s+a)*kc+l];
+					m_vDefect[vActive[l]] = std::sqrt(res);
+				}
+
+			//	update the convergence checks of the right-hand sides still iterating
+				bool bAnyActive = false;
+				for(size_t l = 0; l < kc; ++l)
+				{
+					IConvergenceCheck<vector_type>& cc = *vConvCheck[vActive[l]];
+					if(cc.iteration_ended()) continue;
+					cc.update_defect(m_vDefect[vActive[l]]);
+					if(!cc.iteration_ended()) bAnyActive = true;
+				}
+
+				if(!bAnyActive || bBreakdown) break;
+			}
+
+		//	solve the triangular system, Y = H^{-1} Gs
+			const size_t nc = numSteps*s;
+			std::vector<number> Y(nc*kc, 0.0);
+			number maxDiag = 0.0;
+			for(size_t c = 0; c < nc; ++c)
+				maxDiag = std::max(maxDiag, std::fabs(H[c*numCols+c]));
+			for(size_t l = 0; l < kc; ++l)
+				for(size_t c = nc; c-- > 0; )
+				{
+					const number diag = H[c*numCols+c];
+					if(std::fabs(diag) <= 1e-14*maxDiag) continue;
+					number sum = Gs[c*kc+l];
+					for(size_t b = c+1; b < nc; ++b)
+						sum -= H[c*numCols+b]*Y[b*kc+l];
+					Y[c*kc+l] = sum / diag;
+				}
+
+		//	U := V Y, the correction is M^{-1} U
+			multi_vector_type VUsed, U(R[0], kc);
+			for(size_t c = 0; c < nc; ++c) VUsed.push_back(V.vec(c));
+			for(size_t l = 0; l < kc; ++l) U[l].set(0.0);
+			MultiVecScaleAppend(U, 1.0, VUsed, Y);
+
+			multi_vector_type Corr(R[0], kc), ACorr(R[0], kc);
+			if(!precondition(Corr, U)) return false;
+
+		//	X := X + M^{-1} U, R := R - A M^{-1} U
+			MatMultMulti(ACorr, *m_spA, Corr);
+			for(size_t l = 0; l < kc; ++l)
+			{
+				VecScaleAdd(X[vActive[l]], 1.0, X[vActive[l]], 1.0, Corr[l]);
+				VecScaleAdd(R[vActive[l]], 1.0, R[vActive[l]], -1.0, ACorr[l]);
+
+			//	the next cycle needs unique residuals for the Cholesky QR
+				#ifdef UG_PARALLEL
+				if(!R[vActive[l]].change_storage_type(PST_UNIQUE))
+					UG_THROW(name() << "::apply_return_defect: "
+							"Cannot convert r to unique vector.");
+				#endif
+			}
+			return true;
+		}
+
+	///	appends the orthonormal vectors W C (n columns of C) to the basis V
+		void append_basis(multi_vector_type& V, const multi_vector_type& W,
+		                  const std::vector<number>& C, size_t n)
+		{
+			multi_vector_type VNew(W[0], n);
+			for(size_t b = 0; b < n; ++b) VNew[b].set(0.0);
+			MultiVecScaleAppend(VNew, 1.0, W, C);
+			for(size_t b = 0; b < n; ++b) V.push_back(VNew.vec(b));
+		}
+
+	///	applies the previous Givens rotations to column c and eliminates its subdiagonal entries
+	/**
+	 * Column c of the block Hessenberg matrix has nonzero entries in the rows
+	 * 0, ..., c+s. The entries c+s, ..., c+1 are eliminated from the bottom
+	 * by s rotations of neighboring rows, which are also applied to Gs.
+	 */
+		static void triangularize_column(std::vector<number>& H, std::vector<number>& Gs,
+		                                 std::vector<number>& rotC, std::vector<number>& rotS,
+		                                 size_t c, size_t s, size_t numCols, size_t kc)
+		{
+		//	apply the rotations of the previous columns
+			for(size_t cPrev = 0; cPrev < c; ++cPrev)
+				for(size_t t = 0; t < s; ++t)
+				{
+					const size_t r = cPrev + s - t;
+					const number cs = rotC[cPrev*s+t], sn = rotS[cPrev*s+t];
+					const number x = H[(r-1)*numCols+c], y = H[r*numCols+c];
+					H[(r-1)*numCols+c] = cs*x + sn*y;
+					H[r*numCols+c] = -sn*x + cs*y;
+				}
+
+		//	eliminate the subdiagonal entries
+			for(size_t t = 0; t < s; ++t)
+			{
+				const size_t r = c + s - t;
+				const number x = H[(r-1)*numCols+c], y = H[r*numCols+c];
+				const number rho = std::sqrt(x*x + y*y);
+				number cs = 1.0, sn = 0.0;
+				if(rho > 0.0) {cs = x/rho; sn = y/rho;}
+				rotC[c*s+t] = cs; rotS[c*s+t] = sn;
+				H[(r-1)*numCols+c] = rho;
+				H[r*numCols+c] = 0.0;
+
+				for(size_t l = 0; l < kc; ++l)
+				{
+					const number gx = Gs[(r-1)*kc+l], gy = Gs[r*kc+l];
+					Gs[(r-1)*kc+l] = cs*gx + sn*gy;
+					Gs[r*kc+l] = -sn*gx + cs*gy;
+				}
+			}
+		}
+
+	///	computes W := A M^{-1} V, W is unique afterwards
+		bool apply_operator(multi_vector_type& W, multi_vector_type& V)
+		{
+			multi_vector_type Z(V[0], V.num_vectors());
+			if(!precondition(Z, V)) return false;
+			MatMultMulti(W, *m_spA, Z);
+
+			#ifdef UG_PARALLEL
+			for(size_t t = 0; t < W.num_vectors(); ++t)
+				if(!W[t].change_storage_type(PST_UNIQUE))
+					UG_THROW(name() << "::apply_return_defect: "
+							"Cannot convert A*M^{-1}*v to unique vector.");
+			#endif
+			return true;
+		}
+
+	///	creates one convergence check per right-hand side
+		void prepare_conv_checks(std::vector<SmartPtr<IConvergenceCheck<vector_type> > >& vConvCheck,
+		                         size_t k)
+		{
+			std::string precond;
+			if(m_spPrecond.valid())
+				precond = std::string("Precond: ") + m_spPrecond->name();
+			else
+				precond = "No Preconditioner";
+
+			vConvCheck.resize(k);
+			for(size_t j = 0; j < k; ++j)
+			{
+				vConvCheck[j] = m_spConvCheck->clone();
+				vConvCheck[j]->set_name(name());
+				vConvCheck[j]->set_symbol('%');
+				vConvCheck[j]->set_info(mkstr(" (rhs " << j << ", " << precond << ")"));
+			}
+		}
+
+	///	collects the right-hand sides whose iteration did not yet end, returns false if all ended
+		bool update_active(std::vector<size_t>& vActive,
+		                   std::vector<SmartPtr<IConvergenceCheck<vector_type> > >& vConvCheck) const
+		{
+			vActive.clear();
+			for(size_t j = 0; j < vConvCheck.size(); ++j)
+				if(!vConvCheck[j]->iteration_ended()) vActive.push_back(j);
+			return !vActive.empty();
+		}
+
+	///	computes the consistent vectors Z = M^{-1} R (R must be additive)
+		bool precondition(multi_vector_type& Z, multi_vector_type& R)
+		{
+			for(size_t j = 0; j < R.num_vectors(); ++j)
+			{
+				if(m_spPrecond.valid())
+				{
+					if(!m_spPrecond->apply(Z[j], R[j]))
+					{
+						UG_LOG("ERROR in '" << name() << "::apply_return_defect': "
+								"Cannot apply preconditioner. Aborting.\n");
+						return false;
+					}
+				}
+				else Z[j] = R[j];
+
+				#ifdef UG_PARALLEL
+				if(!Z[j].change_storage_type(PST_CONSISTENT))
+					UG_THROW(name() << "::apply_return_defect: "
+							"Cannot convert z to consistent vector.");
+				#endif
+			}
+			return true;
+		}
+
+	protected:
+	///	matrix
+		SmartPtr<matrix_operator_type> m_spA;
+
+	///	preconditioner
+		SmartPtr<ILinearIterator<vector_type> > m_spPrecond;
+
+	///	convergence check (cloned for every right-hand side)
+		SmartPtr<IConvergenceCheck<vector_type> > m_spConvCheck;
+
+	///	number of block Arnoldi steps per cycle
+		size_t m_restart;
+
+	///	number of block Arnoldi steps of last solve
+		int m_step;
+
+	///	defect norms of last solve
+		std::vector<number> m_vDefect;
+};
+
+} // end namespace ug
+
+#endif /* __H__UG__LIB_DISC__OPERATOR__LINEAR_SOLVER__BLOCK_GMRES__ */
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__LIB_ALGEBRA__OPERATOR__LINEAR_SOLVER__BLOCK_SOLVER_BENCHMARK__
+#define __H__UG__LIB_ALGEBRA__OPERATOR__LINEAR_SOLVER__BLOCK_SOLVER_BENCHMARK__
+
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <cmath>
+#include "common/log.h"
+#include "common/stopwatch.h"
+#include "lib_algebra/cpu_algebra_types.h"
+#include "lib_algebra/operator/convergence_check.h"
+#include "lib_algebra/operator/preconditioner/jacobi.h"
+#include "lib_algebra/operator/linear_solver/cg.h"
+#include "lib_algebra/operator/linear_solver/gmres.h"
+#include "lib_algebra/operator/linear_solver/block_cg.h"
+#include "lib_algebra/operator/linear_solver/block_gmres.h"
+#ifdef UG_PARALLEL
+	#include "lib_algebra/parallelization/parallelization_util.h"
+#endif
+
+namespace ug{
+
+/// \addtogroup lib_algebra
+///	@{
+
+/**
+ * Solves a 2d Laplace problem (5-point stencil on a gridSize x gridSize grid,
+ * Dirichlet boundary) with numRHS right-hand sides, once by separate CG and
+ * GMRES(restart) solves and once by BlockCG and BlockGMRES(restart). All
+ * solvers use a Jacobi preconditioner and reduce the defect of every
+ * right-hand side by 1e-8. The right-hand sides are deterministic, so that the
+ * results are reproducible. Written to the log are the number of sweeps over
+ * the matrix (i.e. the iterations, summed over the right-hand sides for the
+ * separate solves), the runtime and the largest relative true residual.
+ * The system is local to each process.
+ *
+ * \param[in]	gridSize	number of nodes per direction (gridSize^2 unknowns)
+ * \param[in]	numRHS		number of right-hand sides
+ * \param[in]	restart		restart length of GMRES and BlockGMRES
+ */
+inline void BenchmarkMultiRHSSolvers(size_t gridSize, size_t numRHS, size_t restart)
+{
+	typedef CPUAlgebra algebra_type;
+	typedef algebra_type::vector_type vector_type;
+	typedef algebra_type::matrix_type matrix_type;
+	typedef MatrixOperator<matrix_type, vector_type> matrix_operator_type;
+	typedef MultiVector<vector_type> multi_vector_type;
+
+	UG_COND_THROW(gridSize < 2 || numRHS < 1 || restart < 1,
+	              "BenchmarkMultiRHSSolvers: invalid parameters.");
+	const size_t n = gridSize*gridSize;
+	const number reduction = 1e-8;
+	const int maxSteps = 100000;
+
+//	5-point Laplacian
+	SmartPtr<matrix_operator_type> spA(new matrix_operator_type);
+	matrix_type& A = spA->get_matrix();
+	A.resize_and_clear(n, n);
+	for(size_t y = 0; y < gridSize; ++y)
+		for(size_t x = 0; x < gridSize; ++x)
+		{
+			const size_t i = y*gridSize + x;
+			A(i, i) = 4.0;
+			if(y > 0) A(i, i - gridSize) = -1.0;
+			if(x > 0) A(i, i - 1) = -1.0;
+			if(x+1 < gridSize) A(i, i + 1) = -1.0;
+			if(y+1 < gridSize) A(i, i + gridSize) = -1.0;
+		}
+	A.defragment();
+
+//	deterministic right-hand sides
+	vector_type pattern(n);
+#ifdef UG_PARALLEL
+	SmartPtr<AlgebraLayouts> spLayouts = CreateLocalAlgebraLayouts();
+	A.set_layouts(spLayouts);
+	A.set_storage_type(PST_ADDITIVE);
+	pattern.set_layouts(spLayouts);
+#endif
+	multi_vector_type B(pattern, numRHS);
+	for(size_t j = 0; j < numRHS; ++j)
+	{
+		for(size_t i = 0; i < n; ++i)
+			B[j][i] = std::sin(0.37*(j+1)*(i+1)) + (j == 0 ? 1.0 : 0.0);
+		#ifdef UG_PARALLEL
+		B[j].set_storage_type(PST_ADDITIVE);
+		#endif
+	}
+
+	SmartPtr<Jacobi<algebra_type> > spJacobi(new Jacobi<algebra_type>(1.0));
+	SmartPtr<StdConvCheck<vector_type> > spConvCheck(
+			new StdConvCheck<vector_type>(maxSteps, 1e-50, reduction, false));
+
+	const char* names[4] = {"CG", "BlockCG", "GMRES", "BlockGMRES"};
+	int steps[4];
+	double times[4], residuals[4];
+	bool converged[4];
+
+	for(int s = 0; s < 4; ++s)
+	{
+		multi_vector_type X(pattern, numRHS);
+		for(size_t j = 0; j < numRHS; ++j) X[j].set(0.0);
+		steps[s] = 0;
+		converged[s] = true;
+
+		double t = get_clock_s();
+		if(s == 0 || s == 2)
+		{
+		//	separate solves
+			SmartPtr<IPreconditionedLinearOperatorInverse<vector_type> > spSolver;
+			if(s == 0) spSolver = make_sp(new CG<vector_type>(spJacobi, spConvCheck));
+			else spSolver = make_sp(new GMRES<vector_type>(restart, spJacobi, spConvCheck));
+			spSolver->init(spA);
+			for(size_t j = 0; j < numRHS; ++j)
+			{
+				SmartPtr<vector_type> spB = B[j].clone();
+				converged[s] = spSolver->apply_return_defect(X[j], *spB) && converged[s];
+			//	the preconditioned GMRES counts complete restart cycles
+				steps[s] += (s == 0) ? spSolver->step() : spSolver->step() * (int)restart;
+			}
+		}
+		else if(s == 1)
+		{
+			BlockCG<algebra_type> solver(spJacobi, spConvCheck);
+			solver.init(spA);
+			converged[s] = solver.apply(X, B);
+			steps[s] = solver.step();
+		}
+		else
+		{
+			BlockGMRES<algebra_type> solver(restart, spJacobi, spConvCheck);
+			solver.init(spA);
+			converged[s] = solver.apply(X, B);
+			steps[s] = solver.step();
+		}
+		times[s] = get_clock_s() - t;
+
+	//	largest relative true residual
+		residuals[s] = 0.0;
+		for(size_t j = 0; j < numRHS; ++j)
+		{
+			SmartPtr<vector_type> spR = B[j].clone();
+			spA->apply_sub(*spR, X[j]);
+			residuals[s] = std::max(residuals[s], spR->norm() / B[j].norm());
+		}
+	}
+
+	UG_LOG("BenchmarkMultiRHSSolvers: 2d Laplacian on a " << gridSize << "x" << gridSize
+			<< " grid, " << numRHS << " right-hand sides, Jacobi, reduction "
+			<< reduction << ", restart " << restart << "\n");
+	UG_LOG(std::setw(12) << "solver" << std::setw(12) << "sweeps" << std::setw(14) << "time [s]"
+			<< std::setw(16) << "max residual" << std::setw(12) << "converged" << "\n");
+	for(int s = 0; s < 4; ++s)
+		UG_LOG(std::setw(12) << names[s] << std::setw(12) << steps[s] << std::setw(14)
+				<< times[s] << std::setw(16) << residuals[s] << std::setw(12)
+				<< (converged[s] ? "yes" : "no") << "\n");
+}
+
+/// @}
+
+} // end namespace ug
+
+#endif /* __H__UG__LIB_ALGEBRA__OPERATOR__LINEAR_SOLVER__BLOCK_SOLVER_BENCHMARK__ */
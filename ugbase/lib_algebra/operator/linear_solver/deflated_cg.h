@@ -0,0 +1,683 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__LIB_DISC__OPERATOR__LINEAR_SOLVER__DEFLATED_CG__
+#define __H__UG__LIB_DISC__OPERATOR__LINEAR_SOLVER__DEFLATED_CG__
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "lib_algebra/operator/interface/operator.h"
+#include "lib_algebra/operator/interface/preconditioned_linear_operator_inverse.h"
+#include "common/profiler/profiler.h"
+#include "lib_algebra/operator/interface/pprocess.h"
+#ifdef UG_PARALLEL
+	#include "lib_algebra/parallelization/parallelization.h"
+#endif
+
+namespace ug{
+
+///	the deflated CG method with recycling of the deflation space
+/**
+ * This class implements a deflated preconditioned CG method for sequences of
+ * related symmetric positive definite systems A_i*x_i = b_i, as they arise in
+ * time stepping schemes or Newton iterations.
+ *
+ * A deflation space W (k vectors) is kept across calls of apply. Each solve
+ * starts with the Galerkin projection x0 := x0 + W E^{-1} W^T r0, E = W^T A W,
+ * and all search directions are made A-orthogonal to W. The first search
+ * directions of each solve are stored and, after the solve, W is replaced by
+ * the k Ritz vectors of A belonging to the smallest Ritz values in span(W, P).
+ * Thus the eigenvectors slowing down CG are removed from the following solves.
+ *
+ * If the solver is re-initialized (e.g. for a new Newton matrix), W is kept
+ * and only A*W and E are recomputed, so that slowly changing operators
+ * profit as well.
+ *
+ * For detailed description of the algorithm, please refer to:
+ *
+ * - Saad, Yeung, Erhel, Guyomarc'h, "A deflated version of the conjugate
+ *   gradient algorithm", SIAM J. Sci. Comput. 21 (2000), pp. 1909-1926
+ *
+ * \tparam 	TVector		vector type
+ */
+template <typename TVector>
+class DeflatedCG
+	: public IPreconditionedLinearOperatorInverse<TVector>
+{
+	public:
+	///	Vector type
+		typedef TVector vector_type;
+
+	///	Base type
+		typedef IPreconditionedLinearOperatorInverse<vector_type> base_type;
+
+	protected:
+		using base_type::convergence_check;
+		using base_type::linear_operator;
+		using base_type::preconditioner;
+		using base_type::write_debug;
+
+	public:
+	///	constructors
+		DeflatedCG() : base_type() {init_params();}
+
+		DeflatedCG(SmartPtr<ILinearIterator<vector_type,vector_type> > spPrecond)
+			: base_type ( spPrecond )  {init_params();}
+
+		DeflatedCG(SmartPtr<ILinearIterator<vector_type,vector_type> > spPrecond, SmartPtr<IConvergenceCheck<vector_type> > spConvCheck)
+			: base_type ( spPrecond, spConvCheck)  {init_params();}
+
+	///	name of solver
+		virtual const char* name() const {return "DeflatedCG";}
+
+	///	returns if parallel solving is supported
+		virtual bool supports_parallel() const
+		{
+			if(preconditioner().valid())
+				return preconditioner()->supports_parallel();
+			return true;
+		}
+
+	///	initializes the solver for an operator (keeps the deflation space)
+		virtual bool init(SmartPtr<ILinearOperator<vector_type> > J, const vector_type& u)
+		{
+			m_bOperatorChanged = true;
+			return base_type::init(J, u);
+		}
+
+	///	initializes the solver for an operator (keeps the deflation space)
+		virtual bool init(SmartPtr<ILinearOperator<vector_type> > L)
+		{
+			m_bOperatorChanged = true;
+			return base_type::init(L);
+		}
+
+	///	sets the (maximal) number of deflation vectors kept between solves
+		void set_num_deflation_vectors(size_t k) {m_maxDeflation = k;}
+
+	///	sets the number of search directions stored per solve to update the deflation space
+		void set_num_stored_directions(size_t l) {m_maxStored = l;}
+
+	///	sets if the deflation space is updated after each solve (default: true)
+		void set_update_deflation_space(bool bUpdate) {m_bUpdate = bUpdate;}
+
+	///	removes the deflation space, i.e. the next solve is a plain PCG
+		void clear_deflation_space()
+		{
+			m_vW.clear(); m_vAW.clear(); m_vEChol.clear();
+		}
+
+	///	returns the current number of deflation vectors
+		size_t num_deflation_vectors() const {return m_vW.size();}
+
+	///	Solve J(u)*x = b, such that x = J(u)^{-1} b
+		virtual bool apply_return_defect(vector_type& x, vector_type& b)
+		{
+			PROFILE_BEGIN_GROUP(DeflatedCG_apply_return_defect, "CG algebra");
+		//	check parallel storage types
+			#ifdef UG_PARALLEL
+			if(!b.has_storage_type(PST_ADDITIVE) || !x.has_storage_type(PST_CONSISTENT))
+				UG_THROW("DeflatedCG::apply_return_defect:"
+								"Inadequate storage format of Vectors.");
+			#endif
+
+		// 	rename r as b (for convenience)
+			vector_type& r = b;
+
+		// 	Build defect:  r := b - J(u)*x
+			linear_operator()->apply_sub(r, x);
+
+		//	a changed size (e.g. after adaption) invalidates the deflation space
+			if(!m_vW.empty() && m_vW[0]->size() != x.size())
+				clear_deflation_space();
+
+		//	recompute A*W and E for a new operator
+			if(m_bOperatorChanged && !m_vW.empty())
+				update_deflation_operator();
+			m_bOperatorChanged = false;
+
+		//	project start: x := x + W E^{-1} W^T r, r := r - AW E^{-1} W^T r
+			if(!m_vW.empty())
+			{
+				std::vector<number> c(m_vW.size());
+				for(size_t i = 0; i < m_vW.size(); ++i)
+					c[i] = VecProd(*m_vW[i], r);
+				solve_cholesky(m_vEChol, c.size(), c);
+				for(size_t i = 0; i < m_vW.size(); ++i)
+				{
+					VecScaleAdd(x, 1.0, x, c[i], *m_vW[i]);
+					VecScaleAdd(r, 1.0, r, -c[i], *m_vAW[i]);
+				}
+			}
+
+		// 	create help vector (h will be consistent r)
+			SmartPtr<vector_type> spQ = r.clone_without_values(); vector_type& q = *spQ;
+			SmartPtr<vector_type> spZ = x.clone_without_values(); vector_type& z = *spZ;
+			SmartPtr<vector_type> spP = x.clone_without_values(); vector_type& p = *spP;
+
+			write_debugXR(x, r, convergence_check()->step());
+
+		//	compute z = M^-1 r
+			if(!precondition(z, r)) return false;
+
+		//	compute start defect
+			prepare_conv_check();
+			convergence_check()->start(r);
+
+		// 	start search direction, A-orthogonal to W
+			p = z;
+			deflate_direction(p, z);
+
+		// 	start rho
+			number rhoOld = VecProd(z, r), rho;
+
+		//	reset the stored directions
+			m_vP.clear(); m_vAP.clear();
+
+		// 	Iteration loop
+			while(!convergence_check()->iteration_ended())
+			{
+			// 	Build q = A*p (q is additive afterwards)
+				linear_operator()->apply(q, p);
+
+			// 	lambda = (q,p)
+				number lambda = VecProd(q, p);
+
+			//	check lambda
+				if(lambda == 0.0)
+				{
+				    if (p.size())
+				    {
+				        UG_LOG("ERROR in 'DeflatedCG::apply_return_defect': lambda=" <<
+				            lambda<< " is not admitted. Aborting solver.\n");
+				        return false;
+				    }
+				    // in cases where a proc has no geometry, we do not want to fail here
+				    // so we set lambda = 1, this is not harmful
+				    else
+				        lambda = 1.0;
+				}
+
+			//	remember the first directions for the update of W
+				if(m_bUpdate && m_vP.size() < m_maxStored)
+				{
+					m_vP.push_back(p.clone());
+					m_vAP.push_back(q.clone());
+				}
+
+			//	alpha = rho / (q,p)
+				const number alpha = rhoOld/lambda;
+
+			// 	Update x := x + alpha*p
+				VecScaleAdd(x, 1.0, x, alpha, p);
+
+			// 	Update r := r - alpha*t
+				VecScaleAdd(r, 1.0, r, -alpha, q);
+
+				write_debugXR(x, r, convergence_check()->step());
+
+			// 	Check convergence
+				convergence_check()->update(r);
+				if(convergence_check()->iteration_ended()) break;
+
+			//	compute z = M^-1 r
+				if(!precondition(z, r)) return false;
+
+			// 	new rho = (z,r)
+				rho = VecProd(z, r);
+
+			// 	new beta = rho / rhoOld
+				const number beta = rho/rhoOld;
+
+			// 	new direction p := beta * p + z - W E^{-1} (AW)^T z
+				VecScaleAdd(p, beta, p, 1.0, z);
+				deflate_direction(p, z);
+
+			// 	remember old rho
+				rhoOld = rho;
+			}
+
+		//	recycle the Krylov information for the next solve
+			if(m_bUpdate && !m_vP.empty())
+				update_deflation_space();
+			m_vP.clear(); m_vAP.clear();
+
+		//	post output
+			return convergence_check()->post();
+		}
+
+	///	adds a post-process for the iterates
+		void add_postprocess_corr (SmartPtr<IPProcessVector<vector_type> > p)
+		{
+			m_corr_post_process.add (p);
+		}
+
+	///	removes a post-process for the iterates
+		void remove_postprocess_corr (SmartPtr<IPProcessVector<vector_type> > p)
+		{
+			m_corr_post_process.remove (p);
+		}
+
+	///	returns information about configuration parameters
+		virtual std::string config_string() const
+		{
+			std::stringstream ss;
+			ss << name() << " ( max deflation vectors = " << m_maxDeflation
+			   << ", stored directions = " << m_maxStored
+			   << ", update = " << (m_bUpdate ? "true" : "false") << ")\n";
+			ss << base_type::config_string_preconditioner_convergence_check();
+			return ss.str();
+		}
+
+	protected:
+	///	default parameters
+		void init_params()
+		{
+			m_maxDeflation = 8;
+			m_maxStored = 16;
+			m_bUpdate = true;
+			m_bOperatorChanged = true;
+		}
+
+	///	computes the consistent correction z = M^-1 r
+		bool precondition(vector_type& z, vector_type& r)
+		{
+			if(preconditioner().valid())
+			{
+				enter_precond_debug_section(convergence_check()->step());
+				if(!preconditioner()->apply(z, r))
+				{
+					UG_LOG("ERROR in 'DeflatedCG::apply_return_defect': "
+							"Cannot apply preconditioner. Aborting.\n");
+					this->leave_vector_debug_writer_section();
+					return false;
+				}
+				this->leave_vector_debug_writer_section();
+			}
+			else z = r;
+
+		// 	make z consistent
+			#ifdef UG_PARALLEL
+			if(!z.change_storage_type(PST_CONSISTENT))
+				UG_THROW("DeflatedCG::apply_return_defect: "
+								"Cannot convert z to consistent vector.");
+			#endif
+
+		//	post-process the correction
+			m_corr_post_process.apply (z);
+			return true;
+		}
+
+	///	p := p - W E^{-1} (AW)^T z
+		void deflate_direction(vector_type& p, vector_type& z)
+		{
+			if(m_vW.empty()) return;
+			std::vector<number> mu(m_vW.size());
+			for(size_t i = 0; i < m_vW.size(); ++i)
+				mu[i] = VecProd(*m_vAW[i], z);
+			solve_cholesky(m_vEChol, mu.size(), mu);
+			for(size_t i = 0; i < m_vW.size(); ++i)
+				VecScaleAdd(p, 1.0, p, -mu[i], *m_vW[i]);
+		}
+
+	///	recomputes AW = A*W and the factorization of E = W^T A W
+		void update_deflation_operator()
+		{
+			PROFILE_FUNC_GROUP("CG algebra");
+			for(size_t i = 0; i < m_vW.size(); ++i)
+			{
+				m_vAW[i] = m_vW[i]->clone_without_values();
+				linear_operator()->apply(*m_vAW[i], *m_vW[i]);
+			}
+			factorize_E();
+		}
+
+	///	computes and factorizes E = W^T A W, drops the space if E is not spd
+		void factorize_E()
+		{
+			const size_t k = m_vW.size();
+			m_vEChol.resize(k*k);
+			for(size_t i = 0; i < k; ++i)
+				for(size_t j = 0; j < k; ++j)
+					m_vEChol[i*k+j] = VecProd(*m_vW[i], *m_vAW[j]);
+			symmetrize(m_vEChol, k);
+
+			if(cholesky(m_vEChol, k, 0.0) >= 0)
+			{
+				UG_LOG("DeflatedCG: W^T A W not positive definite, "
+						"deflation space removed.\n");
+				clear_deflation_space();
+			}
+		}
+
+	///	replaces W by the Ritz vectors of the smallest Ritz values in span(W, P)
+		void update_deflation_space()
+		{
+			PROFILE_FUNC_GROUP("CG algebra");
+
+		//	Z = [W, P], AZ = [AW, AP]
+			std::vector<SmartPtr<vector_type> > vZ(m_vW), vAZ(m_vAW);
+			vZ.insert(vZ.end(), m_vP.begin(), m_vP.end());
+			vAZ.insert(vAZ.end(), m_vAP.begin(), m_vAP.end());
+			const size_t m = vZ.size();
+
+		//	G = Z^T A Z (consistent * additive)
+			std::vector<number> G(m*m);
+			for(size_t i = 0; i < m; ++i)
+				for(size_t j = 0; j < m; ++j)
+					G[i*m+j] = VecProd(*vZ[i], *vAZ[j]);
+			symmetrize(G, m);
+
+		//	F = Z^T Z (unique * consistent)
+			std::vector<SmartPtr<vector_type> > vU(vZ);
+			#ifdef UG_PARALLEL
+			for(size_t i = 0; i < m; ++i){
+				vU[i] = vZ[i]->clone();
+				vU[i]->change_storage_type(PST_UNIQUE);
+			}
+			#endif
+			std::vector<number> F(m*m);
+			for(size_t i = 0; i < m; ++i)
+				for(size_t j = 0; j < m; ++j)
+					F[i*m+j] = VecProd(*vU[i], *vZ[j]);
+			symmetrize(F, m);
+
+		//	factorize G = L L^T, dropping (numerically) dependent directions
+			std::vector<size_t> vActive(m);
+			for(size_t i = 0; i < m; ++i) vActive[i] = i;
+			std::vector<number> L, C;
+			size_t n;
+			for(;;)
+			{
+				n = vActive.size();
+				L.resize(n*n);
+				for(size_t i = 0; i < n; ++i)
+					for(size_t j = 0; j < n; ++j)
+						L[i*n+j] = G[vActive[i]*m+vActive[j]];
+				const int fail = cholesky(L, n, 1e-12);
+				if(fail < 0) break;
+				vActive.erase(vActive.begin() + fail);
+			}
+			if(n == 0) {clear_deflation_space(); return;}
+
+		//	C = L^{-1} F L^{-T}, the eigenvalues of C are the inverse Ritz values
+			C.resize(n*n);
+			for(size_t i = 0; i < n; ++i)
+				for(size_t j = 0; j < n; ++j)
+					C[i*n+j] = F[vActive[i]*m+vActive[j]];
+			for(size_t j = 0; j < n; ++j) forward_subst(L, n, &C[0], n, j);
+			transpose(C, n);
+			for(size_t j = 0; j < n; ++j) forward_subst(L, n, &C[0], n, j);
+			symmetrize(C, n);
+
+			std::vector<number> vMu, V;
+			jacobi_eigen(C, n, vMu, V);
+
+		//	select the k largest eigenvalues of C (smallest Ritz values)
+			const size_t k = std::min(m_maxDeflation, n);
+			std::vector<size_t> vSel;
+			std::vector<bool> vUsed(n, false);
+			for(size_t s = 0; s < k; ++s)
+			{
+				size_t best = n;
+				for(size_t i = 0; i < n; ++i)
+					if(!vUsed[i] && (best == n || vMu[i] > vMu[best])) best = i;
+				vUsed[best] = true;
+				vSel.push_back(best);
+			}
+
+		//	Y = L^{-T} V_k, W := Z Y, AW := AZ Y
+			std::vector<SmartPtr<vector_type> > vW(k), vAW(k);
+			std::vector<number> y(n);
+			for(size_t s = 0; s < k; ++s)
+			{
+				for(size_t i = 0; i < n; ++i) y[i] = V[i*n+vSel[s]];
+				backward_subst_transposed(L, n, y);
+
+				vW[s] = vZ[vActive[0]]->clone_without_values();
+				vAW[s] = vAZ[vActive[0]]->clone_without_values();
+				VecScaleAssign(*vW[s], y[0], *vZ[vActive[0]]);
+				VecScaleAssign(*vAW[s], y[0], *vAZ[vActive[0]]);
+				for(size_t i = 1; i < n; ++i)
+				{
+					VecScaleAdd(*vW[s], 1.0, *vW[s], y[i], *vZ[vActive[i]]);
+					VecScaleAdd(*vAW[s], 1.0, *vAW[s], y[i], *vAZ[vActive[i]]);
+				}
+			}
+
+			m_vW.swap(vW);
+			m_vAW.swap(vAW);
+			factorize_E();
+		}
+
+	protected:
+	///	a := (a + a^T)/2 for a row-major n x n matrix
+		static void symmetrize(std::vector<number>& a, size_t n)
+		{
+			for(size_t i = 0; i < n; ++i)
+				for(size_t j = 0; j < i; ++j)
+					a[i*n+j] = a[j*n+i] = 0.5*(a[i*n+j] + a[j*n+i]);
+		}
+
+	///	a := a^T for a row-major n x n matrix
+		static void transpose(std::vector<number>& a, size_t n)
+		{
+			for(size_t i = 0; i < n; ++i)
+				for(size_t j = 0; j < i; ++j)
+					std::swap(a[i*n+j], a[j*n+i]);
+		}
+
+	///	in-place Cholesky factorization a = L L^T (lower part)
+	/**
+	 * returns -1 on success, otherwise the index of the first column whose
+	 * pivot is not larger than relTol times the original diagonal entry
+	 */
+		static int cholesky(std::vector<number>& a, size_t n, number relTol)
+		{
+			for(size_t j = 0; j < n; ++j)
+			{
+				number d = a[j*n+j];
+				const number diag = d;
+				for(size_t k = 0; k < j; ++k) d -= a[j*n+k]*a[j*n+k];
+				if(!(d > relTol*diag) || d <= 0.0) return (int)j;
+				d = std::sqrt(d);
+				a[j*n+j] = d;
+				for(size_t i = j+1; i < n; ++i)
+				{
+					number s = a[i*n+j];
+					for(size_t k = 0; k < j; ++k) s -= a[i*n+k]*a[j*n+k];
+					a[i*n+j] = s/d;
+				}
+				for(size_t i = 0; i < j; ++i) a[i*n+j] = 0.0;
+			}
+			return -1;
+		}
+
+	///	solves L y = b for the entries b[i*stride+col] (in place)
+		static void forward_subst(const std::vector<number>& L, size_t n,
+		                          number* b, size_t stride, size_t col)
+		{
+			for(size_t i = 0; i < n; ++i)
+			{
+				number s = b[i*stride+col];
+				for(size_t k = 0; k < i; ++k) s -= L[i*n+k]*b[k*stride+col];
+				b[i*stride+col] = s/L[i*n+i];
+			}
+		}
+
+	///	solves L^T y = b (in place)
+		static void backward_subst_transposed(const std::vector<number>& L, size_t n, std::vector<number>& b)
+		{
+			for(size_t i = n; i-- > 0; )
+			{
+				number s = b[i];
+				for(size_t k = i+1; k < n; ++k) s -= L[k*n+i]*b[k];
+				b[i] = s/L[i*n+i];
+			}
+		}
+
+	///	solves L L^T y = b (in place)
+		static void solve_cholesky(const std::vector<number>& L, size_t n, std::vector<number>& b)
+		{
+			if(n == 0) return;
+			forward_subst(L, n, &b[0], 1, 0);
+			backward_subst_transposed(L, n, b);
+		}
+
+	///	cyclic Jacobi method for the symmetric eigenvalue problem a = V diag(lambda) V^T
+		static void jacobi_eigen(std::vector<number> a, size_t n,
+		                         std::vector<number>& lambda, std::vector<number>& V)
+		{
+			V.assign(n*n, 0.0);
+			for(size_t i = 0; i < n; ++i) V[i*n+i] = 1.0;
+
+			for(int sweep = 0; sweep < 50; ++sweep)
+			{
+				number off = 0.0, total = 0.0;
+				for(size_t i = 0; i < n; ++i)
+					for(size_t j = 0; j < n; ++j){
+						total += a[i*n+j]*a[i*n+j];
+						if(i != j) off += a[i*n+j]*a[i*n+j];
+					}
+				if(off <= 1e-30*total) break;
+
+				for(size_t p = 0; p < n; ++p)
+					for(size_t q = p+1; q < n; ++q)
+					{
+						const number apq = a[p*n+q];
+						if(apq == 0.0) continue;
+						const number theta = (a[q*n+q] - a[p*n+p]) / (2.0*apq);
+						const number t = (theta >= 0 ? 1.0 : -1.0)
+									/ (std::fabs(theta) + std::sqrt(theta*theta + 1.0));
+						const number c = 1.0/std::sqrt(t*t + 1.0), s = t*c;
+
+						for(size_t k = 0; k < n; ++k)
+						{
+							const number akp = a[k*n+p], akq = a[k*n+q];
+							a[k*n+p] = c*akp - s*akq;
+							a[k*n+q] = s*akp + c*akq;
+						}
+						for(size_t k = 0; k < n; ++k)
+						{
+							const number apk = a[p*n+k], aqk = a[q*n+k];
+							a[p*n+k] = c*apk - s*aqk;
+							a[q*n+k] = s*apk + c*aqk;
+						}
+						for(size_t k = 0; k < n; ++k)
+						{
+							const number vkp = V[k*n+p], vkq = V[k*n+q];
+							V[k*n+p] = c*vkp - s*vkq;
+							V[k*n+q] = s*vkp + c*vkq;
+						}
+					}
+			}
+
+			lambda.resize(n);
+			for(size_t i = 0; i < n; ++i) lambda[i] = a[i*n+i];
+		}
+
+	protected:
+	///	adjust output of convergence check
+		void prepare_conv_check()
+		{
+		//	set iteration symbol and name
+			convergence_check()->set_name(name());
+			convergence_check()->set_symbol('%');
+
+		//	set preconditioner string
+			std::stringstream ss;
+			if(preconditioner().valid())
+			  ss << " (Precond: " << preconditioner()->name() << ", ";
+			else
+			  ss << " (No Preconditioner, ";
+			ss << "deflation vectors: " << m_vW.size() << ")";
+			convergence_check()->set_info(ss.str());
+		}
+
+	/// debugger output: solution and residual
+		void write_debugXR(vector_type &x, vector_type &r, int loopCnt)
+		{
+			if(!this->vector_debug_writer_valid()) return;
+			char ext[20]; sprintf(ext, "_iter%03d", loopCnt);
+			write_debug(r, std::string("DeflatedCG_Residual") + ext + ".vec");
+			write_debug(x, std::string("DeflatedCG_Solution") + ext + ".vec");
+		}
+
+	/// debugger section for the preconditioner
+		void enter_precond_debug_section(int loopCnt)
+		{
+			if(!this->vector_debug_writer_valid()) return;
+			char ext[20]; sprintf(ext, "_iter%03d", loopCnt);
+			this->enter_vector_debug_writer_section(std::string("DeflatedCG_Precond_") + ext);
+		}
+
+	protected:
+		number VecProd(vector_type& a, vector_type& b)
+		{
+			return a.dotprod(b);
+		}
+
+	protected:
+	///	postprocessor for the correction in the iterations
+		PProcessChain<vector_type> m_corr_post_process;
+
+	///	deflation space W (consistent) and A*W (additive)
+		std::vector<SmartPtr<vector_type> > m_vW, m_vAW;
+
+	///	Cholesky factor of E = W^T A W (row-major)
+		std::vector<number> m_vEChol;
+
+	///	search directions P (consistent) and A*P (additive) of the current solve
+		std::vector<SmartPtr<vector_type> > m_vP, m_vAP;
+
+	///	maximal number of deflation vectors
+		size_t m_maxDeflation;
+
+	///	maximal number of stored search directions per solve
+		size_t m_maxStored;
+
+	///	flag if the deflation space is updated after each solve
+		bool m_bUpdate;
+
+	///	flag if A*W must be recomputed since the operator has been (re-)initialized
+		bool m_bOperatorChanged;
+};
+
+} // end namespace ug
+
+#endif /* __H__UG__LIB_DISC__OPERATOR__LINEAR_SOLVER__DEFLATED_CG__ */
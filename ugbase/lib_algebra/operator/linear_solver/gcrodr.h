@@ -0,0 +1,857 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ *
+ * This file is part of UG4.
+ *
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ *
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ *
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ *
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__LIB_DISC__OPERATOR__LINEAR_SOLVER__GCRODR__
+#define __H__UG__LIB_DISC__OPERATOR__LINEAR_SOLVER__GCRODR__
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <complex>
+#include <limits>
+#include <cmath>
+
+#include "lib_algebra/operator/interface/operator.h"
+#include "lib_algebra/operator/interface/preconditioned_linear_operator_inverse.h"
+#include "common/profiler/profiler.h"
+#include "lib_algebra/operator/interface/pprocess.h"
+#ifdef UG_PARALLEL
+	#include "lib_algebra/parallelization/parallelization.h"
+#endif
+
+namespace ug{
+
+///	the GCRO-DR method (GMRES with deflated restarting and recycling)
+/**
+ * This class implements the GCRO-DR method for sequences of related linear
+ * systems A_i*x_i = b_i with general (non-symmetric) operators, as they arise
+ * in time stepping schemes or Newton iterations.
+ *
+ * A recycle space U (k vectors) with C = A*U, C^T C = I, is kept across calls
+ * of apply. Each cycle first projects the residual onto range(C) and then
+ * performs restart - k Arnoldi steps with the operator (I - C C^T) A M^{-1}
+ * (right preconditioning, so that the true residual is minimized). After each
+ * cycle U is replaced by the harmonic Ritz vectors of A belonging to the k
+ * harmonic Ritz values of smallest magnitude in span(U, M^{-1} V). Thus the
+ * eigenvectors slowing down GMRES are removed from the following cycles and
+ * solves.
+ *
+ * If the solver is re-initialized (e.g. for a new Newton matrix), U is kept
+ * and C is recomputed and orthonormalized, so that slowly changing operators
+ * profit as well.
+ *
+ * The harmonic Ritz values are computed by a small dense non-symmetric
+ * eigensolver (Hessenberg reduction, shifted QR iteration and inverse
+ * iteration for the selected eigenvectors). For complex pairs the real and
+ * imaginary parts of the eigenvector are recycled.
+ *
+ * For detailed description of the algorithm, please refer to:
+ *
+ * - Parks, de Sturler, Mackey, Johnson, Maiti, "Recycling Krylov subspaces
+ *   for sequences of linear systems", SIAM J. Sci. Comput. 28 (2006),
+ *   pp. 1651-1674
+ *
+ * \tparam 	TVector		vector type
+ */
+template <typename TVector>
+class GCRODR
+	: public IPreconditionedLinearOperatorInverse<TVector>
+{
+	public:
+	///	Vector type
+		typedef TVector vector_type;
+
+	///	Base type
+		typedef IPreconditionedLinearOperatorInverse<vector_type> base_type;
+
+	protected:
+		using base_type::convergence_check;
+		using base_type::linear_operator;
+		using base_type::preconditioner;
+
+		typedef std::complex<number> complex_type;
+
+	public:
+	///	constructor setting the restart length and the number of recycled vectors
+		GCRODR(size_t restart, size_t numRecycle)
+			: m_restart(restart), m_maxRecycle(numRecycle)
+		{init_params();}
+
+	///	constructor setting the preconditioner and the convergence check
+		GCRODR(size_t restart, size_t numRecycle,
+		       SmartPtr<ILinearIterator<vector_type> > spPrecond,
+		       SmartPtr<IConvergenceCheck<vector_type> > spConvCheck)
+			: base_type(spPrecond, spConvCheck),
+			  m_restart(restart), m_maxRecycle(numRecycle)
+		{init_params();}
+
+	///	name of solver
+		virtual const char* name() const {return "GCRODR";}
+
+	///	returns if parallel solving is supported
+		virtual bool supports_parallel() const
+		{
+			if(preconditioner().valid())
+				return preconditioner()->supports_parallel();
+			return true;
+		}
+
+	///	initializes the solver for an operator (keeps the recycle space)
+		virtual bool init(SmartPtr<ILinearOperator<vector_type> > J, const vector_type& u)
+		{
+			m_bOperatorChanged = true;
+			return base_type::init(J, u);
+		}
+
+	///	initializes the solver for an operator (keeps the recycle space)
+		virtual bool init(SmartPtr<ILinearOperator<vector_type> > L)
+		{
+			m_bOperatorChanged = true;
+			return base_type::init(L);
+		}
+
+	///	sets if the recycle space is updated after each cycle (default: true)
+		void set_update_recycle_space(bool bUpdate) {m_bUpdate = bUpdate;}
+
+	///	removes the recycle space, i.e. the next cycle is a plain GMRES cycle
+		void clear_recycle_space()
+		{
+			m_vU.clear(); m_vC.clear();
+		}
+
+	///	returns the current number of recycled vectors
+		size_t num_recycle_vectors() const {return m_vU.size();}
+
+	///	Solve J(u)*x = b, such that x = J(u)^{-1} b
+		virtual bool apply_return_defect(vector_type& x, vector_type& b)
+		{
+			PROFILE_BEGIN_GROUP(GCRODR_apply_return_defect, "algebra GCRODR");
+		//	check correct storage type in parallel
+			#ifdef UG_PARALLEL
+			if(!b.has_storage_type(PST_ADDITIVE) || !x.has_storage_type(PST_CONSISTENT))
+				UG_THROW("GCRODR: Inadequate storage format of Vectors.");
+			#endif
+
+			if(m_maxRecycle >= m_restart)
+				UG_THROW("GCRODR: The number of recycled vectors ("<<m_maxRecycle
+						 <<") has to be smaller than the restart length ("
+						 <<m_restart<<").");
+
+		//	keep the rhs for the fresh defects, r is stored in b
+			SmartPtr<vector_type> spB = b.clone();
+			vector_type& r = b;
+
+		// 	build defect:  r := b - A*x
+			linear_operator()->apply_sub(r, x);
+			make_unique(r);
+
+		//	a changed size (e.g. after adaption) invalidates the recycle space
+			if(!m_vU.empty() && m_vU[0]->size() != x.size())
+				clear_recycle_space();
+
+		//	recompute C = A*U for a new operator
+			if(m_bOperatorChanged && !m_vU.empty())
+				update_recycle_operator();
+			m_bOperatorChanged = false;
+
+		//	prepare convergence check
+			prepare_conv_check();
+
+		//	compute start defect norm
+			convergence_check()->start(r);
+
+		// 	Iteration loop (one cycle per loop)
+			while(!convergence_check()->iteration_ended())
+			{
+				const size_t k = m_vC.size();
+				const size_t p = m_restart - k;
+
+			//	project the defect: x := x + U C^T r, r := r - C C^T r
+				for(size_t i = 0; i < k; ++i)
+				{
+					const number c = VecProd(*m_vC[i], r);
+					VecScaleAdd(x, 1.0, x, c, *m_vU[i]);
+					VecScaleAdd(r, 1.0, r, -c, *m_vC[i]);
+				}
+
+			//	v[0] = r / ||r||
+				const number beta = r.norm();
+				if(beta == 0.0){
+					convergence_check()->update_defect(beta);
+					break;
+				}
+				std::vector<SmartPtr<vector_type> > v(p+1), z(p);
+				v[0] = r.clone();
+				*v[0] *= 1./beta;
+
+			//	arnoldi matrix H (p+1 x p), B = C^T A Z (k x p), rotated copy of H
+				std::vector<number> H((p+1)*p, 0.0), B(k*p, 0.0), R(p*p, 0.0);
+				std::vector<number> gamma(p+1, 0.0), c(p), s(p);
+				gamma[0] = beta;
+
+			//	loop arnoldi steps
+				size_t numIter = 0;
+				while(numIter < p)
+				{
+					const size_t j = numIter;
+
+				//	z[j] = M^-1 v[j]
+					z[j] = x.clone_without_values();
+					if(!precondition(*z[j], *v[j])) return false;
+
+				//	w = A z[j]
+					SmartPtr<vector_type> spW = r.clone_without_values();
+					vector_type& w = *spW;
+					linear_operator()->apply(w, *z[j]);
+					make_unique(w);
+
+				//	orthogonalize against C and v[0], ..., v[j]
+					for(size_t i = 0; i < k; ++i)
+					{
+						B[i*p+j] = VecProd(*m_vC[i], w);
+						VecScaleAdd(w, 1.0, w, -B[i*p+j], *m_vC[i]);
+					}
+					for(size_t i = 0; i <= j; ++i)
+					{
+						H[i*p+j] = VecProd(*v[i], w);
+						VecScaleAdd(w, 1.0, w, -H[i*p+j], *v[i]);
+					}
+					H[(j+1)*p+j] = w.norm();
+
+				//	apply the previous rotations to the new column
+					for(size_t i = 0; i <= j; ++i) R[i*p+j] = H[i*p+j];
+					for(size_t i = 0; i < j; ++i)
+					{
+						const number rij = R[i*p+j], ri1j = R[(i+1)*p+j];
+						R[i*p+j]     =  c[i]*rij + s[i]*ri1j;
+						R[(i+1)*p+j] = -s[i]*rij + c[i]*ri1j;
+					}
+
+				//	new rotation eliminating h_{j+1,j}
+					const number hj1j = H[(j+1)*p+j];
+					const number alpha = std::sqrt(R[j*p+j]*R[j*p+j] + hj1j*hj1j);
+					c[j] = R[j*p+j] / alpha;
+					s[j] = hj1j / alpha;
+					R[j*p+j] = alpha;
+
+				//	compute new norm
+					gamma[j+1] = -s[j]*gamma[j];
+					gamma[j] = c[j]*gamma[j];
+
+				//	v[j+1] = w / h_{j+1,j} (w = 0 for a lucky breakdown)
+					if(hj1j != 0.0) w *= 1./hj1j;
+					v[j+1] = spW;
+
+					++numIter;
+					convergence_check()->update_defect(std::fabs(gamma[j+1]));
+					if(hj1j == 0.0 || convergence_check()->iteration_ended())
+						break;
+				}
+
+			//	solve the least squares problem: R y = gamma
+				std::vector<number> y(numIter);
+				for(size_t i = numIter; i-- > 0; )
+				{
+					number sum = gamma[i];
+					for(size_t l = i+1; l < numIter; ++l) sum -= R[i*p+l]*y[l];
+					y[i] = sum / R[i*p+i];
+				}
+
+			//	x := x + Z y - U B y
+				for(size_t i = 0; i < numIter; ++i)
+					VecScaleAdd(x, 1.0, x, y[i], *z[i]);
+				for(size_t i = 0; i < k; ++i)
+				{
+					number by = 0.0;
+					for(size_t l = 0; l < numIter; ++l) by += B[i*p+l]*y[l];
+					VecScaleAdd(x, 1.0, x, -by, *m_vU[i]);
+				}
+
+			//	recycle the Krylov information for the next cycle and solve
+				if(m_bUpdate && m_maxRecycle > 0)
+					update_recycle_space(v, z, H, B, p, numIter);
+
+			//	compute fresh defect: r := b - A*x
+				r = *spB;
+				linear_operator()->apply_sub(r, x);
+				make_unique(r);
+			}
+
+		//	print ending output
+			return convergence_check()->post();
+		}
+
+	public:
+		virtual std::string config_string() const
+		{
+			std::stringstream ss;
+			ss << name() << " ( restart = " << m_restart
+			   << ", recycled vectors = " << m_maxRecycle
+			   << ", update = " << (m_bUpdate ? "true" : "false") << ")\n";
+			ss << base_type::config_string_preconditioner_convergence_check();
+			return ss.str();
+		}
+
+	///	adds a post-process for the iterates
+		void add_postprocess_corr (SmartPtr<IPProcessVector<vector_type> > p)
+		{
+			m_corr_post_process.add (p);
+		}
+
+	///	removes a post-process for the iterates
+		void remove_postprocess_corr (SmartPtr<IPProcessVector<vector_type> > p)
+		{
+			m_corr_post_process.remove (p);
+		}
+
+	protected:
+	///	default parameters
+		void init_params()
+		{
+			m_bUpdate = true;
+			m_bOperatorChanged = true;
+		}
+
+	///	computes the consistent correction z = M^-1 v
+		bool precondition(vector_type& z, vector_type& v)
+		{
+			if(preconditioner().valid())
+			{
+				if(!preconditioner()->apply(z, v))
+				{
+					UG_LOG("GCRODR: Cannot apply preconditioner.\n");
+					return false;
+				}
+			}
+			else z = v;
+
+		// 	make z consistent
+			#ifdef UG_PARALLEL
+			if(!z.change_storage_type(PST_CONSISTENT))
+				UG_THROW("GCRODR: Cannot convert z to consistent vector.");
+			#endif
+
+		//	post-process the correction
+			m_corr_post_process.apply (z);
+			return true;
+		}
+
+	///	converts a defect to unique storage
+		void make_unique(vector_type& v)
+		{
+			#ifdef UG_PARALLEL
+			if(!v.change_storage_type(PST_UNIQUE))
+				UG_THROW("GCRODR: Cannot convert vector to unique vector.");
+			#endif
+		}
+
+	///	recomputes C = A*U and orthonormalizes C (applying the same operations to U)
+		void update_recycle_operator()
+		{
+			PROFILE_FUNC_GROUP("algebra GCRODR");
+			std::vector<SmartPtr<vector_type> > vU, vC;
+			for(size_t i = 0; i < m_vU.size(); ++i)
+			{
+				SmartPtr<vector_type> spU = m_vU[i];
+				SmartPtr<vector_type> spC = spU->clone_without_values();
+				linear_operator()->apply(*spC, *spU);
+				make_unique(*spC);
+
+				const number origNorm = spC->norm();
+				for(size_t l = 0; l < vC.size(); ++l)
+				{
+					const number rl = VecProd(*vC[l], *spC);
+					VecScaleAdd(*spC, 1.0, *spC, -rl, *vC[l]);
+					VecScaleAdd(*spU, 1.0, *spU, -rl, *vU[l]);
+				}
+				const number nrm = spC->norm();
+				if(!(nrm > 1e-12*origNorm)) continue;
+				*spC *= 1./nrm;
+				*spU *= 1./nrm;
+				vU.push_back(spU);
+				vC.push_back(spC);
+			}
+			m_vU.swap(vU);
+			m_vC.swap(vC);
+		}
+
+	///	replaces U by the harmonic Ritz vectors of smallest magnitude in span(U, Z)
+	/**
+	 * With W = [C, V] (orthonormal) and Y = [U D, Z], D scaling U to unit
+	 * columns, the last cycle provides A Y = W G. The harmonic Ritz pairs
+	 * solve G^T G g = theta G^T W^T Y g. Writing G^T G = L L^T this becomes the
+	 * standard problem L^{-1} G^T W^T Y L^{-T} h = 1/theta h with g = L^{-T} h.
+	 * Then U := Y P R^{-1} and C := W Q for the selected vectors P and the QR
+	 * factorization G P = Q R, so that A U = C with orthonormal C.
+	 */
+		void update_recycle_space(const std::vector<SmartPtr<vector_type> >& v,
+		                          const std::vector<SmartPtr<vector_type> >& z,
+		                          const std::vector<number>& H,
+		                          const std::vector<number>& B,
+		                          size_t p, size_t numIter)
+		{
+			PROFILE_FUNC_GROUP("algebra GCRODR");
+			const size_t k = m_vU.size();
+			const size_t n = k + numIter;
+			if(numIter == 0) return;
+
+		//	scaling of the recycled vectors
+			std::vector<number> d(k);
+			for(size_t i = 0; i < k; ++i)
+			{
+				SmartPtr<vector_type> spTmp = m_vU[i]->clone();
+				d[i] = 1./spTmp->norm();
+			}
+
+		//	G ((n+1) x n)
+			std::vector<number> G((n+1)*n, 0.0);
+			for(size_t i = 0; i < k; ++i)
+			{
+				G[i*n+i] = d[i];
+				for(size_t j = 0; j < numIter; ++j) G[i*n+k+j] = B[i*p+j];
+			}
+			for(size_t i = 0; i <= numIter; ++i)
+				for(size_t j = 0; j < numIter; ++j) G[(k+i)*n+k+j] = H[i*p+j];
+
+		//	W ((n+1) vectors, unique) and Y (n vectors, consistent)
+			std::vector<SmartPtr<vector_type> > vW(m_vC), vY(m_vU);
+			vW.insert(vW.end(), v.begin(), v.begin() + numIter + 1);
+			vY.insert(vY.end(), z.begin(), z.begin() + numIter);
+
+		//	M = W^T Y ((n+1) x n)
+			std::vector<number> M((n+1)*n);
+			for(size_t i = 0; i <= n; ++i)
+				for(size_t j = 0; j < n; ++j)
+					M[i*n+j] = VecProd(*vW[i], *vY[j]) * (j < k ? d[j] : 1.0);
+
+		//	F = G^T G, E = G^T M
+			std::vector<number> L(n*n, 0.0), S(n*n, 0.0);
+			for(size_t i = 0; i < n; ++i)
+				for(size_t j = 0; j < n; ++j)
+					for(size_t l = 0; l <= n; ++l)
+					{
+						L[i*n+j] += G[l*n+i]*G[l*n+j];
+						S[i*n+j] += G[l*n+i]*M[l*n+j];
+					}
+			if(!cholesky(L, n)) return;
+
+		//	S = L^{-1} E L^{-T}
+			for(size_t j = 0; j < n; ++j) forward_subst(L, n, &S[0], j);
+			transpose(S, n);
+			for(size_t j = 0; j < n; ++j) forward_subst(L, n, &S[0], j);
+			transpose(S, n);
+
+			std::vector<complex_type> vMu;
+			if(!eigenvalues(S, n, vMu)) return;
+
+		//	select the eigenvalues of largest magnitude (smallest harmonic Ritz values)
+			std::vector<size_t> vOrder(n);
+			for(size_t i = 0; i < n; ++i) vOrder[i] = i;
+			std::sort(vOrder.begin(), vOrder.end(), CompareMagnitude(vMu));
+
+			const size_t kMax = std::min(m_maxRecycle, n);
+			std::vector<std::vector<number> > vP;
+			std::vector<complex_type> h;
+			for(size_t s = 0; s < n && vP.size() < kMax; ++s)
+			{
+				const complex_type mu = vMu[vOrder[s]];
+				const bool bComplex = std::fabs(mu.imag()) > 1e-10*std::abs(mu);
+			//	only the partner with positive imaginary part is used for pairs
+				if(bComplex && mu.imag() < 0) continue;
+
+				inverse_iteration(S, n, mu, h);
+				std::vector<number> re(n), im(n);
+				for(size_t i = 0; i < n; ++i) {re[i] = h[i].real(); im[i] = h[i].imag();}
+				backward_subst_transposed(L, n, re);
+				vP.push_back(re);
+				if(bComplex && vP.size() < kMax)
+				{
+					backward_subst_transposed(L, n, im);
+					vP.push_back(im);
+				}
+			}
+
+		//	QR factorization of G P (modified Gram-Schmidt), dropping dependent columns
+			std::vector<std::vector<number> > vQ, vT;
+			for(size_t s = 0; s < vP.size(); ++s)
+			{
+				std::vector<number> q(n+1, 0.0);
+				for(size_t i = 0; i <= n; ++i)
+					for(size_t j = 0; j < n; ++j) q[i] += G[i*n+j]*vP[s][j];
+				const number origNorm = norm2(q);
+
+			//	t = P R^{-1}, built up together with q
+				std::vector<number> t(vP[s]);
+				for(size_t l = 0; l < vQ.size(); ++l)
+				{
+					number rl = 0.0;
+					for(size_t i = 0; i <= n; ++i) rl += vQ[l][i]*q[i];
+					for(size_t i = 0; i <= n; ++i) q[i] -= rl*vQ[l][i];
+					for(size_t i = 0; i < n; ++i) t[i] -= rl*vT[l][i];
+				}
+				const number nrm = norm2(q);
+				if(!(nrm > 1e-12*origNorm)) continue;
+				for(size_t i = 0; i <= n; ++i) q[i] /= nrm;
+				for(size_t i = 0; i < n; ++i) t[i] /= nrm;
+				vQ.push_back(q);
+				vT.push_back(t);
+			}
+			if(vQ.empty()) return;
+
+		//	U := Y T, C := W Q
+			std::vector<SmartPtr<vector_type> > vU(vQ.size()), vC(vQ.size());
+			for(size_t s = 0; s < vQ.size(); ++s)
+			{
+				vU[s] = vY[0]->clone_without_values();
+				vC[s] = vW[0]->clone_without_values();
+				VecScaleAssign(*vU[s], vT[s][0] * (k > 0 ? d[0] : 1.0), *vY[0]);
+				VecScaleAssign(*vC[s], vQ[s][0], *vW[0]);
+				for(size_t i = 1; i < n; ++i)
+					VecScaleAdd(*vU[s], 1.0, *vU[s], vT[s][i] * (i < k ? d[i] : 1.0), *vY[i]);
+				for(size_t i = 1; i <= n; ++i)
+					VecScaleAdd(*vC[s], 1.0, *vC[s], vQ[s][i], *vW[i]);
+			}
+
+			m_vU.swap(vU);
+			m_vC.swap(vC);
+		}
+
+	protected:
+	///	orders indices by decreasing magnitude of the referenced values
+		struct CompareMagnitude
+		{
+			CompareMagnitude(const std::vector<complex_type>& v) : m_v(v) {}
+			bool operator()(size_t a, size_t b) const
+			{
+				return std::abs(m_v[a]) > std::abs(m_v[b]);
+			}
+			const std::vector<complex_type>& m_v;
+		};
+
+	///	euclidean norm of a small dense vector
+		static number norm2(const std::vector<number>& a)
+		{
+			number sum = 0.0;
+			for(size_t i = 0; i < a.size(); ++i) sum += a[i]*a[i];
+			return std::sqrt(sum);
+		}
+
+	///	a := a^T for a row-major n x n matrix
+		static void transpose(std::vector<number>& a, size_t n)
+		{
+			for(size_t i = 0; i < n; ++i)
+				for(size_t j = 0; j < i; ++j)
+					std::swap(a[i*n+j], a[j*n+i]);
+		}
+
+	///	in-place Cholesky factorization a = L L^T (lower part), false if not spd
+		static bool cholesky(std::vector<number>& a, size_t n)
+		{
+			for(size_t j = 0; j < n; ++j)
+			{
+				number d = a[j*n+j];
+				for(size_t k = 0; k < j; ++k) d -= a[j*n+k]*a[j*n+k];
+				if(!(d > 0.0)) return false;
+				d = std::sqrt(d);
+				a[j*n+j] = d;
+				for(size_t i = j+1; i < n; ++i)
+				{
+					number s = a[i*n+j];
+					for(size_t k = 0; k < j; ++k) s -= a[i*n+k]*a[j*n+k];
+					a[i*n+j] = s/d;
+				}
+				for(size_t i = 0; i < j; ++i) a[i*n+j] = 0.0;
+			}
+			return true;
+		}
+
+	///	solves L y = b for the column col of the row-major n x n matrix b (in place)
+		static void forward_subst(const std::vector<number>& L, size_t n,
+		                          number* b, size_t col)
+		{
+			for(size_t i = 0; i < n; ++i)
+			{
+				number s = b[i*n+col];
+				for(size_t k = 0; k < i; ++k) s -= L[i*n+k]*b[k*n+col];
+				b[i*n+col] = s/L[i*n+i];
+			}
+		}
+
+	///	solves L^T y = b (in place)
+		static void backward_subst_transposed(const std::vector<number>& L, size_t n, std::vector<number>& b)
+		{
+			for(size_t i = n; i-- > 0; )
+			{
+				number s = b[i];
+				for(size_t k = i+1; k < n; ++k) s -= L[k*n+i]*b[k];
+				b[i] = s/L[i*n+i];
+			}
+		}
+
+	///	eigenvalues of a real row-major n x n matrix
+	/**
+	 * The matrix is reduced to Hessenberg form by Householder reflections.
+	 * The eigenvalues are then computed by the QR iteration with Wilkinson
+	 * shifts in complex arithmetic. Returns false if the iteration does not
+	 * converge.
+	 */
+		static bool eigenvalues(std::vector<number> a, size_t n,
+		                        std::vector<complex_type>& lambda)
+		{
+			lambda.resize(n);
+			if(n == 0) return true;
+
+		//	Householder reduction to Hessenberg form
+			std::vector<number> u(n);
+			for(size_t k = 0; k + 2 < n; ++k)
+			{
+				number alpha = 0.0;
+				for(size_t i = k+1; i < n; ++i) alpha += a[i*n+k]*a[i*n+k];
+				alpha = std::sqrt(alpha);
+				if(alpha == 0.0) continue;
+				if(a[(k+1)*n+k] > 0) alpha = -alpha;
+
+				for(size_t i = k+1; i < n; ++i) u[i] = a[i*n+k];
+				u[k+1] -= alpha;
+				number unorm = 0.0;
+				for(size_t i = k+1; i < n; ++i) unorm += u[i]*u[i];
+				if(unorm == 0.0) continue;
+
+			//	a := (I - 2uu^T/u^Tu) a (I - 2uu^T/u^Tu)
+				for(size_t j = 0; j < n; ++j)
+				{
+					number s = 0.0;
+					for(size_t i = k+1; i < n; ++i) s += u[i]*a[i*n+j];
+					s *= 2.0/unorm;
+					for(size_t i = k+1; i < n; ++i) a[i*n+j] -= s*u[i];
+				}
+				for(size_t i = 0; i < n; ++i)
+				{
+					number s = 0.0;
+					for(size_t j = k+1; j < n; ++j) s += a[i*n+j]*u[j];
+					s *= 2.0/unorm;
+					for(size_t j = k+1; j < n; ++j) a[i*n+j] -= s*u[j];
+				}
+				for(size_t i = k+2; i < n; ++i) a[i*n+k] = 0.0;
+			}
+
+			std::vector<complex_type> h(a.begin(), a.end());
+			number anorm = 0.0;
+			for(size_t i = 0; i < n*n; ++i) anorm = std::max(anorm, std::abs(h[i]));
+			const number eps = std::numeric_limits<number>::epsilon();
+
+			std::vector<number> c(n);
+			std::vector<complex_type> s(n);
+			size_t hi = n-1;
+			int iter = 0;
+			while(hi > 0)
+			{
+			//	find the active block [lo, hi]
+				size_t lo = hi;
+				while(lo > 0)
+				{
+					number tol = std::abs(h[(lo-1)*n+lo-1]) + std::abs(h[lo*n+lo]);
+					if(tol == 0.0) tol = anorm;
+					if(std::abs(h[lo*n+lo-1]) <= eps*tol){
+						h[lo*n+lo-1] = 0.0;
+						break;
+					}
+					--lo;
+				}
+
+			//	deflate a converged eigenvalue
+				if(lo == hi){
+					lambda[hi] = h[hi*n+hi];
+					--hi;
+					iter = 0;
+					continue;
+				}
+
+				if(++iter > 30*(int)n) return false;
+
+			//	Wilkinson shift (exceptional shift after each 10 iterations)
+				const complex_type a11 = h[(hi-1)*n+hi-1], a12 = h[(hi-1)*n+hi];
+				const complex_type a21 = h[hi*n+hi-1], a22 = h[hi*n+hi];
+				complex_type mu;
+				if(iter % 10 == 0)
+					mu = a22 + std::abs(a21);
+				else
+				{
+					const complex_type tr2 = 0.5*(a11 + a22);
+					const complex_type disc = std::sqrt(0.25*(a11-a22)*(a11-a22) + a12*a21);
+					const complex_type mu1 = tr2 + disc, mu2 = tr2 - disc;
+					mu = (std::abs(mu1 - a22) < std::abs(mu2 - a22)) ? mu1 : mu2;
+				}
+
+			//	QR step on the active block: H - mu I = QR, H := RQ + mu I
+				for(size_t i = lo; i <= hi; ++i) h[i*n+i] -= mu;
+				for(size_t i = lo; i < hi; ++i)
+				{
+					const complex_type x = h[i*n+i], y = h[(i+1)*n+i];
+					const number r = std::sqrt(std::norm(x) + std::norm(y));
+					if(r == 0.0) {c[i] = 1.0; s[i] = 0.0; continue;}
+					if(std::abs(x) == 0.0) {c[i] = 0.0; s[i] = std::conj(y) / r;}
+					else{
+						c[i] = std::abs(x) / r;
+						s[i] = (x / std::abs(x)) * std::conj(y) / r;
+					}
+					for(size_t j = i; j <= hi; ++j)
+					{
+						const complex_type hij = h[i*n+j], hi1j = h[(i+1)*n+j];
+						h[i*n+j]     = c[i]*hij + s[i]*hi1j;
+						h[(i+1)*n+j] = -std::conj(s[i])*hij + c[i]*hi1j;
+					}
+				}
+				for(size_t i = lo; i < hi; ++i)
+				{
+					for(size_t l = lo; l <= hi; ++l)
+					{
+						const complex_type hli = h[l*n+i], hli1 = h[l*n+i+1];
+						h[l*n+i]   = c[i]*hli + std::conj(s[i])*hli1;
+						h[l*n+i+1] = -s[i]*hli + c[i]*hli1;
+					}
+				}
+				for(size_t i = lo; i <= hi; ++i) h[i*n+i] += mu;
+			}
+			lambda[0] = h[0];
+			return true;
+		}
+
+	///	eigenvector of the real row-major n x n matrix a for the eigenvalue mu
+	/**	computed by inverse iteration using an LU factorization with partial
+	 * pivoting in complex arithmetic.*/
+		static void inverse_iteration(const std::vector<number>& a, size_t n,
+		                              complex_type mu, std::vector<complex_type>& x)
+		{
+			number anorm = 0.0;
+			for(size_t i = 0; i < n*n; ++i) anorm = std::max(anorm, std::fabs(a[i]));
+			const number eps = std::numeric_limits<number>::epsilon();
+			const number tiny = std::max(anorm, (number)1.0) * eps;
+
+		//	LU factorization of a - mu I
+			std::vector<complex_type> lu(a.begin(), a.end());
+			std::vector<size_t> perm(n);
+			for(size_t i = 0; i < n; ++i){
+				lu[i*n+i] -= mu;
+				perm[i] = i;
+			}
+			for(size_t k = 0; k < n; ++k)
+			{
+				size_t piv = k;
+				for(size_t i = k+1; i < n; ++i)
+					if(std::abs(lu[i*n+k]) > std::abs(lu[piv*n+k])) piv = i;
+				if(piv != k){
+					for(size_t j = 0; j < n; ++j) std::swap(lu[k*n+j], lu[piv*n+j]);
+					std::swap(perm[k], perm[piv]);
+				}
+			//	the matrix is singular up to rounding, perturb the pivot
+				if(std::abs(lu[k*n+k]) < tiny) lu[k*n+k] = tiny;
+				for(size_t i = k+1; i < n; ++i)
+				{
+					const complex_type f = lu[i*n+k] / lu[k*n+k];
+					lu[i*n+k] = f;
+					for(size_t j = k+1; j < n; ++j) lu[i*n+j] -= f*lu[k*n+j];
+				}
+			}
+
+		//	start vector with nonzero components in all directions
+			x.resize(n);
+			for(size_t i = 0; i < n; ++i) x[i] = 1.0 + (number)i / (number)n;
+
+			std::vector<complex_type> b(n);
+			for(int it = 0; it < 3; ++it)
+			{
+				for(size_t i = 0; i < n; ++i) b[i] = x[perm[i]];
+				for(size_t i = 0; i < n; ++i)
+					for(size_t j = 0; j < i; ++j) b[i] -= lu[i*n+j]*b[j];
+				for(size_t i = n; i-- > 0; )
+				{
+					for(size_t j = i+1; j < n; ++j) b[i] -= lu[i*n+j]*b[j];
+					b[i] /= lu[i*n+i];
+				}
+				number nrm = 0.0;
+				for(size_t i = 0; i < n; ++i) nrm += std::norm(b[i]);
+				nrm = std::sqrt(nrm);
+				for(size_t i = 0; i < n; ++i) x[i] = b[i] / nrm;
+			}
+		}
+
+	protected:
+	///	prepares the output of the convergence check
+		void prepare_conv_check()
+		{
+		//	set iteration symbol and name
+			convergence_check()->set_name(name());
+			convergence_check()->set_symbol('%');
+
+		//	set preconditioner string
+			std::stringstream ss;
+			if(preconditioner().valid())
+			  ss << " (Precond: " << preconditioner()->name() << ", ";
+			else
+			  ss << " (No Preconditioner, ";
+			ss << "recycled vectors: " << m_vU.size() << ")";
+			convergence_check()->set_info(ss.str());
+		}
+
+	///	computes the vector product
+		number VecProd(vector_type& a, vector_type& b)
+		{
+			return a.dotprod(b);
+		}
+
+	protected:
+	///	restart parameter
+		size_t m_restart;
+
+	///	maximal number of recycled vectors
+		size_t m_maxRecycle;
+
+	///	postprocessor for the preconditioned vectors z = M^{-1} v
+		PProcessChain<vector_type> m_corr_post_process;
+
+	///	recycle space U (consistent) and C = A*U (unique, orthonormal)
+		std::vector<SmartPtr<vector_type> > m_vU, m_vC;
+
+	///	flag if the recycle space is updated after each cycle
+		bool m_bUpdate;
+
+	///	flag if C must be recomputed since the operator has been (re-)initialized
+		bool m_bOperatorChanged;
+};
+
+} // end namespace ug
+
+#endif /* __H__UG__LIB_DISC__OPERATOR__LINEAR_SOLVER__GCRODR__ */
@@ -0,0 +1,390 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+#ifndef __H__UG__LIB_ALGEBRA__OPERATOR__PRECONDITIONER__CHEBYSHEV__
+#define __H__UG__LIB_ALGEBRA__OPERATOR__PRECONDITIONER__CHEBYSHEV__
+
+#include <sstream>
+#include "lib_algebra/operator/interface/preconditioner.h"
+#include "lib_algebra/small_algebra/additional_math.h"
+#include "lib_algebra/cpu_algebra/vector.h"
+
+#ifdef UG_PARALLEL
+	#include "lib_algebra/parallelization/parallelization.h"
+#endif
+
+namespace ug{
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///		Chebyshev-Iteration
+/**
+ * The Chebyshev smoother applies a fixed polynomial in the Jacobi-preconditioned
+ * operator \f$ D^{-1} A \f$ to the defect. Given the interval
+ * \f$ [\lambda_{min}, \lambda_{max}] \f$ containing the part of the spectrum
+ * of \f$ D^{-1} A \f$ that shall be damped, the correction c = B*d is computed
+ * by 'degree' steps of the three-term Chebyshev recursion (started with c = 0)
+ *
+ * 		\f$ \theta = (\lambda_{max} + \lambda_{min})/2,
+ * 			\delta = (\lambda_{max} - \lambda_{min})/2,
+ * 			\sigma = \theta / \delta \f$
+ *
+ * 		\f$ r_0 = d, \; p_0 = \frac{1}{\theta} D^{-1} r_0, \; \rho_0 = 1/\sigma \f$
+ *
+ * 		\f$ r_k = r_{k-1} - A p_{k-1}, \;
+ * 			\rho_k = 1/(2\sigma - \rho_{k-1}), \;
+ * 			p_k = \rho_k \rho_{k-1} p_{k-1} + \frac{2\rho_k}{\delta} D^{-1} r_k \f$
+ *
+ * 		\f$ c = \sum_k p_k \f$.
+ *
+ * Since c depends linearly on d, this is a consistent linear iteration. The
+ * apply phase only uses matrix-vector products, diagonal scalings and vector
+ * updates. In parallel, one consistency exchange with the neighbor processes
+ * is needed per degree, but no global reduction. This makes the iteration a
+ * well scaling smoother for multigrid methods.
+ *
+ * The largest eigenvalue of \f$ D^{-1} A \f$ is estimated in 'init' by some
+ * steps of the power method (unless it is set explicitly) and enlarged by a
+ * safety factor. The lower bound of the smoothed interval is chosen as
+ * \f$ \lambda_{min} = \lambda_{max} / ratio \f$.
+ *
+ *	References:
+ * <ul>
+ * <li> Y. Saad. Iterative methods for sparse linear systems, 2nd ed. (Alg. 12.1)
+ * <li> M. Adams, M. Brezina, J. Hu, R. Tuminaro. Parallel multigrid smoothing:
+ *      polynomial versus Gauss-Seidel. J. Comput. Phys. 188 (2003), 593-610
+ * </ul>
+ */
+template <typename TAlgebra>
+class Chebyshev : public IPreconditioner<TAlgebra>
+{
+	public:
+	///	Algebra type
+		typedef TAlgebra algebra_type;
+
+	///	Vector type
+		typedef typename TAlgebra::vector_type vector_type;
+
+	///	Matrix type
+		typedef typename TAlgebra::matrix_type matrix_type;
+
+	///	Matrix Operator type
+		typedef typename IPreconditioner<TAlgebra>::matrix_operator_type matrix_operator_type;
+
+	///	Base type
+		typedef IPreconditioner<TAlgebra> base_type;
+
+	protected:
+		using base_type::set_debug;
+		using base_type::debug_writer;
+		using base_type::write_debug;
+		using base_type::damping;
+
+	public:
+	///	default constructor
+		Chebyshev()
+			: m_degree(3), m_eigRatio(30.0), m_safety(1.1), m_numPowerIter(10),
+			  m_bUserMaxEig(false), m_maxEig(0.0), m_bBlock(true)
+		{}
+
+	///	constructor setting the polynomial degree
+		Chebyshev(int degree)
+			: m_degree(3), m_eigRatio(30.0), m_safety(1.1), m_numPowerIter(10),
+			  m_bUserMaxEig(false), m_maxEig(0.0), m_bBlock(true)
+		{
+			set_degree(degree);
+		}
+
+	/// clone constructor
+		Chebyshev(const Chebyshev<TAlgebra> &parent)
+			: base_type(parent),
+			  m_degree(parent.m_degree), m_eigRatio(parent.m_eigRatio),
+			  m_safety(parent.m_safety), m_numPowerIter(parent.m_numPowerIter),
+			  m_bUserMaxEig(parent.m_bUserMaxEig), m_maxEig(parent.m_maxEig),
+			  m_bBlock(parent.m_bBlock)
+		{}
+
+	///	Clone
+		virtual SmartPtr<ILinearIterator<vector_type> > clone()
+		{
+			return make_sp(new Chebyshev<algebra_type>(*this));
+		}
+
+	///	returns if parallel solving is supported
+		virtual bool supports_parallel() const {return true;}
+
+	///	Destructor
+		virtual ~Chebyshev() {}
+
+	///	sets the degree of the Chebyshev polynomial (i.e. the number of matrix-vector products per apply)
+		void set_degree(int degree)
+		{
+			UG_COND_THROW(degree < 1, "Chebyshev: degree must be at least 1, but "
+						  << degree << " was given.");
+			m_degree = degree;
+		}
+
+	///	sets the ratio lambda_max / lambda_min of the smoothed interval
+		void set_eigenvalue_ratio(number ratio)
+		{
+			UG_COND_THROW(ratio <= 1.0, "Chebyshev: eigenvalue ratio must be greater than 1.");
+			m_eigRatio = ratio;
+		}
+
+	///	sets the factor by which the estimated largest eigenvalue is enlarged
+		void set_safety_factor(number safety)
+		{
+			UG_COND_THROW(safety <= 0.0, "Chebyshev: safety factor must be positive.");
+			m_safety = safety;
+		}
+
+	///	sets the number of power iterations used to estimate the largest eigenvalue
+		void set_power_iterations(int numIter)
+		{
+			UG_COND_THROW(numIter < 1, "Chebyshev: at least one power iteration needed.");
+			m_numPowerIter = numIter;
+		}
+
+	///	sets the largest eigenvalue of D^{-1}A explicitly (no estimation is performed)
+		void set_max_eigenvalue(number maxEig)
+		{
+			UG_COND_THROW(maxEig <= 0.0, "Chebyshev: largest eigenvalue must be positive.");
+			m_maxEig = maxEig;
+			m_bUserMaxEig = true;
+		}
+
+	///	returns the largest eigenvalue of D^{-1}A used (estimated or set, without safety factor)
+		number max_eigenvalue() const {return m_maxEig;}
+
+	/// sets if the block diagonal (default) or the scalar diagonal is used for D
+		void set_block(bool b) {m_bBlock = b;}
+
+		virtual std::string config_string() const
+		{
+			std::stringstream ss;
+			ss << name() << "( degree = " << m_degree << ", eigenvalue ratio = "
+			   << m_eigRatio << ", safety = " << m_safety << ", lambda_max = ";
+			if(m_bUserMaxEig) ss << m_maxEig;
+			else ss << "estimated (" << m_numPowerIter << " power iterations)";
+			ss << ", damping = " << this->m_spDamping->config_string() << ")";
+			return ss.str();
+		}
+
+	protected:
+	///	Name of preconditioner
+		virtual const char* name() const {return "Chebyshev";}
+
+	///	Preprocess routine
+		virtual bool preprocess(SmartPtr<MatrixOperator<matrix_type, vector_type> > pOp)
+		{
+			PROFILE_BEGIN_GROUP(Chebyshev_preprocess, "algebra Chebyshev");
+
+			matrix_type &mat = *pOp;
+			const size_t size = mat.num_rows();
+			if(size != mat.num_cols())
+			{
+				UG_LOG("Square Matrix needed for Chebyshev Iteration.\n");
+				return false;
+			}
+
+		//	invert (block) diagonal
+			m_diagInv.resize(size);
+#ifdef UG_PARALLEL
+		//	temporary vector for the diagonal
+			ParallelVector<Vector< typename matrix_type::value_type > > diag;
+			diag.resize(size);
+			diag.set_layouts(mat.layouts());
+
+			for(size_t i = 0; i < diag.size(); ++i)
+				diag[i] = mat(i, i);
+
+		//	make diagonal consistent
+			diag.set_storage_type(PST_ADDITIVE);
+			diag.change_storage_type(PST_CONSISTENT);
+
+			if(diag.size() > 0)
+				if(CheckVectorInvertible(diag) == false)
+					return false;
+#endif
+			typename matrix_type::value_type m;
+			for(size_t i = 0; i < size; ++i)
+			{
+#ifdef UG_PARALLEL
+				typename matrix_type::value_type &d = diag[i];
+#else
+				typename matrix_type::value_type &d = mat(i,i);
+#endif
+				if(!m_bBlock)
+					GetDiag(m, d);
+				else
+					m = d;
+				GetInverse(m_diagInv[i], m);
+			}
+
+		//	estimate largest eigenvalue of D^{-1}A
+			if(!m_bUserMaxEig)
+				m_maxEig = estimate_max_eigenvalue(pOp);
+
+			UG_COND_THROW(!(m_maxEig > 0.0), name() << "::preprocess: Estimated "
+						"largest eigenvalue of D^{-1}A is " << m_maxEig
+						<< ", but must be positive.");
+
+			return true;
+		}
+
+	///	computes c = p(D^{-1}A) D^{-1} d, with the Chebyshev polynomial p
+		virtual bool step(SmartPtr<MatrixOperator<matrix_type, vector_type> > pOp, vector_type& c, const vector_type& d)
+		{
+			PROFILE_BEGIN_GROUP(Chebyshev_step, "algebra Chebyshev");
+
+			const number lmax = m_safety * m_maxEig;
+			const number lmin = lmax / m_eigRatio;
+			const number theta = 0.5 * (lmax + lmin);
+			const number delta = 0.5 * (lmax - lmin);
+			const number sigma = theta / delta;
+			number rho = 1.0 / sigma;
+
+		//	help vectors (r is additive, z and p are consistent)
+			SmartPtr<vector_type> spR = d.clone(); vector_type& r = *spR;
+			SmartPtr<vector_type> spZ = c.clone_without_values(); vector_type& z = *spZ;
+			SmartPtr<vector_type> spP = c.clone_without_values(); vector_type& p = *spP;
+
+		//	p = 1/theta * D^{-1} d, c = p
+			apply_diag_inverse(z, r);
+			VecScaleAssign(p, 1.0 / theta, z);
+			VecAssign(c, p);
+
+			for(int k = 1; k < m_degree; ++k)
+			{
+			//	r := r - A*p (= d - A*c)
+				pOp->apply_sub(r, p);
+
+				const number rhoNew = 1.0 / (2.0 * sigma - rho);
+
+			//	p := rhoNew*rho * p + 2*rhoNew/delta * D^{-1} r
+				apply_diag_inverse(z, r);
+				VecScaleAdd(p, rhoNew * rho, p, 2.0 * rhoNew / delta, z);
+
+			//	c := c + p
+				VecScaleAdd(c, 1.0, c, 1.0, p);
+
+				rho = rhoNew;
+			}
+
+			return true;
+		}
+
+	///	Postprocess routine
+		virtual bool postprocess() {return true;}
+
+	protected:
+	///	computes z = D^{-1} r, z is consistent afterwards
+		void apply_diag_inverse(vector_type& z, const vector_type& r)
+		{
+			for(size_t i = 0; i < m_diagInv.size(); ++i)
+				MatMult(z[i], 1.0, m_diagInv[i], r[i]);
+
+#ifdef UG_PARALLEL
+			z.set_storage_type(PST_ADDITIVE);
+			if(!z.change_storage_type(PST_CONSISTENT))
+				UG_THROW(name() << ": Cannot change parallel storage type "
+						"of scaled defect to consistent.");
+#endif
+		}
+
+	///	estimates the largest eigenvalue of D^{-1}A by the power method
+		number estimate_max_eigenvalue(SmartPtr<MatrixOperator<matrix_type, vector_type> > pOp)
+		{
+			PROFILE_BEGIN_GROUP(Chebyshev_estimate_max_eigenvalue, "algebra Chebyshev");
+
+			const size_t size = pOp->num_rows();
+			vector_type x(size), y(size);
+#ifdef UG_PARALLEL
+			x.set_layouts(pOp->layouts());
+			y.set_layouts(pOp->layouts());
+#endif
+
+		//	random start vector, normalized (consistent)
+			x.set_random(-1.0, 1.0);
+			number norm = x.norm();
+			if(norm == 0.0) return 1.0;
+			x *= 1.0 / norm;
+#ifdef UG_PARALLEL
+			x.change_storage_type(PST_CONSISTENT);
+#endif
+
+			number lambda = 0.0;
+			for(int it = 0; it < m_numPowerIter; ++it)
+			{
+			//	x := D^{-1} A x
+				pOp->apply(y, x);
+				apply_diag_inverse(x, y);
+
+			//	since x had unit length, its new length approximates lambda_max
+				lambda = x.norm();
+				if(lambda == 0.0) break;
+				x *= 1.0 / lambda;
+#ifdef UG_PARALLEL
+				x.change_storage_type(PST_CONSISTENT);
+#endif
+			}
+
+			return lambda;
+		}
+
+	protected:
+	///	degree of the Chebyshev polynomial
+		int m_degree;
+
+	///	ratio lambda_max / lambda_min of the smoothed interval
+		number m_eigRatio;
+
+	///	factor applied to the largest eigenvalue
+		number m_safety;
+
+	///	number of power iterations in preprocess
+		int m_numPowerIter;
+
+	///	largest eigenvalue of D^{-1}A (set by user or estimated)
+		bool m_bUserMaxEig;
+		number m_maxEig;
+
+	///	type of block-inverse
+		typedef typename block_traits<typename matrix_type::value_type>::inverse_type inverse_type;
+
+	///	storage of the inverse diagonal
+		std::vector<inverse_type> m_diagInv;
+		bool m_bBlock;
+};
+
+} // end namespace ug
+
+#endif /* __H__UG__LIB_ALGEBRA__OPERATOR__PRECONDITIONER__CHEBYSHEV__ */
@@ -35,6 +35,9 @@
 #define __H__UG__LIB_DISC__OPERATOR__LINEAR_OPERATOR__ILU__
 
 #include <limits>
+#include <map>
+#include <sstream>
+#include <vector>
 #include "common/error.h"
 #include "common/util/smart_pointer.h"
 #include "lib_algebra/operator/interface/preconditioner.h"
@@ -222,6 +225,58 @@ bool FactorizeILUSorted(Matrix_type &A, const number eps = 1e-50)
 }
 
 
+// ILU(p) pattern, i.e. adds the fill-in of level <= p to the matrix (as zero entries)
+// level(a_ij) = 0 for entries of A, level(a_ij) = min_k level(a_ik)+level(a_kj)+1 for fill-in
+// (cf. Y Saad, Iterative methods for Sparse Linear Systems, p. 278)
+template<typename Matrix_type>
+void AddILUFillIn(Matrix_type &A, int fillLevel)
+{
+	PROFILE_FUNC_GROUP("algebra ILU");
+	typedef typename Matrix_type::row_iterator row_iterator;
+	typedef std::map<size_t, int> level_row_type;
+
+	if(fillLevel <= 0) return;
+
+	// levels of the U part (j > i) of all rows already processed
+	std::vector<std::vector<std::pair<size_t, int> > > vULevel(A.num_rows());
+	std::vector<size_t> vNewCols;
+
+	for(size_t i=0; i < A.num_rows(); i++)
+	{
+		level_row_type row;
+		for(row_iterator it = A.begin_row(i); it != A.end_row(i); ++it)
+			row[it.index()] = 0;
+
+		// eliminate with rows k < i, new entries (with j > k) are visited later
+		for(typename level_row_type::iterator it_k = row.begin();
+				it_k != row.end() && it_k->first < i; ++it_k)
+		{
+			const size_t k = it_k->first;
+			const int lev_ik = it_k->second;
+			for(size_t l = 0; l < vULevel[k].size(); ++l)
+			{
+				const int lev = lev_ik + vULevel[k][l].second + 1;
+				if(lev > fillLevel) continue;
+				typename level_row_type::iterator it_j = row.find(vULevel[k][l].first);
+				if(it_j == row.end()) row[vULevel[k][l].first] = lev;
+				else if(lev < it_j->second) it_j->second = lev;
+			}
+		}
+
+		vNewCols.clear();
+		for(typename level_row_type::iterator it = row.begin(); it != row.end(); ++it)
+		{
+			if(it->first > i) vULevel[i].push_back(*it);
+			if(it->second > 0) vNewCols.push_back(it->first);
+		}
+
+		// add fill-in entries to the pattern
+		for(size_t l = 0; l < vNewCols.size(); ++l)
+			A(i, vNewCols[l]) = 0.0;
+	}
+}
+
+
 // solve x = L^-1 b
 // Returns true on success, or false on issues that lead to some changes in the solution
 // (the solution is computed unless no exceptions are thrown)
@@ -385,7 +440,8 @@ class ILU : public IPreconditioner<TAlgebra>
 			m_bSort(false),
 			m_bDisablePreprocessing(false),
 			m_useConsistentInterfaces(false),
-			m_useOverlap(false) {};
+			m_useOverlap(false),
+			m_fillLevel(0) {};
 
 	/// clone constructor
 		ILU( const ILU<TAlgebra> &parent )
@@ -396,7 +452,8 @@ class ILU : public IPreconditioner<TAlgebra>
 			  m_bSort(parent.m_bSort),
 			  m_bDisablePreprocessing(parent.m_bDisablePreprocessing),
 			  m_useConsistentInterfaces(parent.m_useConsistentInterfaces),
-			  m_useOverlap(parent.m_useOverlap)
+			  m_useOverlap(parent.m_useOverlap),
+			  m_fillLevel(parent.m_fillLevel)
 		{	}
 
 	///	Clone
@@ -436,6 +493,18 @@ class ILU : public IPreconditioner<TAlgebra>
 
 		void enable_overlap (bool enable)				{m_useOverlap = enable;}
 
+	///	sets the level of fill-in, i.e. ILU(p) (default: 0)
+		void set_fill_level(int p)						{m_fillLevel = p;}
+
+		virtual std::string config_string() const
+		{
+			std::stringstream ss;
+			ss << "ILU(fill level = " << m_fillLevel << ", beta = " << m_beta
+			   << ", sort = " << (m_bSort?"true":"false")
+			   << ", damping = " << this->m_spDamping->config_string() << ")";
+			return ss.str();
+		}
+
 	protected:
 	//	Name of preconditioner
 		virtual const char* name() const {return "ILU";}
@@ -539,6 +608,9 @@ class ILU : public IPreconditioner<TAlgebra>
 			#endif
 
 
+		//	extend pattern for ILU(p)
+			if(m_fillLevel > 0) AddILUFillIn(m_ILU, m_fillLevel);
+
 		// 	Compute ILU Factorization
 			if (m_beta!=0.0) FactorizeILUBeta(m_ILU, m_beta);
 			else if(matrix_type::rows_sorted) FactorizeILUSorted(m_ILU, m_sortEps);
@@ -696,6 +768,9 @@ class ILU : public IPreconditioner<TAlgebra>
 
 		bool m_useConsistentInterfaces;
 		bool m_useOverlap;
+
+	///	level of fill-in for ILU(p)
+		int m_fillLevel;
 };
 
 } // end namespace ug
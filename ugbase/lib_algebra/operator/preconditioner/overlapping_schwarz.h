@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__LIB_ALGEBRA__OPERATOR__PRECONDITIONER__OVERLAPPING_SCHWARZ__
+#define __H__UG__LIB_ALGEBRA__OPERATOR__PRECONDITIONER__OVERLAPPING_SCHWARZ__
+
+#include <vector>
+#include <algorithm>
+#include <sstream>
+
+#include "common/error.h"
+#include "common/util/smart_pointer.h"
+#include "lib_algebra/operator/interface/preconditioner.h"
+#include "lib_algebra/cpu_algebra/sparsematrix.h"
+#include "lib_algebra/cpu_algebra/vector.h"
+#include "ilu.h"
+
+#ifdef UG_PARALLEL
+	#include "lib_algebra/parallelization/parallelization_util.h"
+#endif
+
+namespace ug{
+
+///	Overlapping (restricted) additive Schwarz preconditioner with ILU(p) subdomain solves
+/**
+ * The (process local) index set is split into a number of subdomains of
+ * consecutive indices. Each subdomain is extended by a configurable number
+ * of layers of matrix neighbors (the overlap). On each extended subdomain the
+ * local matrix is factorized by ILU(p) and the correction is computed as
+ *
+ * 		c = sum_i R_i^T (L_i U_i)^{-1} R_i d
+ *
+ * For the restricted variant (RAS, default) the subdomain corrections are
+ * only taken on the indices owned by the subdomain, i.e. the prolongation
+ * does not add up the overlap.
+ *
+ * The subdomains are independent, thus factorization and application are
+ * done in parallel by all threads if compiled with OpenMP (UG_OPENMP).
+ *
+ * In parallel (MPI) the process local problem is set up as for the ILU
+ * without overlap (slave rows added to master rows), the overlap within the
+ * process is controlled by set_overlap.
+ *
+ * (cf. Y Saad, Iterative methods for Sparse Linear Systems, Ch. 14)
+ */
+template <typename TAlgebra>
+class OverlappingSchwarz : public IPreconditioner<TAlgebra>
+{
+	public:
+	///	Algebra type
+		typedef TAlgebra algebra_type;
+
+	///	Vector type
+		typedef typename TAlgebra::vector_type vector_type;
+
+	///	Matrix type
+		typedef typename TAlgebra::matrix_type matrix_type;
+
+	///	Matrix Operator type
+		typedef typename IPreconditioner<TAlgebra>::matrix_operator_type matrix_operator_type;
+
+	///	Base type
+		typedef IPreconditioner<TAlgebra> base_type;
+
+	///	types for the subdomain problems (always serial)
+		typedef SparseMatrix<typename matrix_type::value_type> subdomain_matrix_type;
+		typedef Vector<typename vector_type::value_type> subdomain_vector_type;
+
+	protected:
+		using base_type::write_debug;
+		using base_type::print_debugger_message;
+
+	public:
+	//	Constructor
+		OverlappingSchwarz() :
+			m_numSubdomains(4),
+			m_overlap(1),
+			m_bRestricted(true),
+			m_fillLevel(0),
+			m_sortEps(1.e-50),
+			m_invEps(1.e-8) {};
+
+	/// clone constructor
+		OverlappingSchwarz( const OverlappingSchwarz<TAlgebra> &parent )
+			: base_type(parent),
+			  m_numSubdomains(parent.m_numSubdomains),
+			  m_overlap(parent.m_overlap),
+			  m_bRestricted(parent.m_bRestricted),
+			  m_fillLevel(parent.m_fillLevel),
+			  m_sortEps(parent.m_sortEps),
+			  m_invEps(parent.m_invEps)
+		{	}
+
+	///	Clone
+		virtual SmartPtr<ILinearIterator<vector_type> > clone()
+		{
+			return make_sp(new OverlappingSchwarz<algebra_type>(*this));
+		}
+
+	///	Destructor
+		virtual ~OverlappingSchwarz(){}
+
+	///	returns if parallel solving is supported
+		virtual bool supports_parallel() const {return true;}
+
+	///	sets the number of subdomains (per process)
+		void set_num_subdomains(size_t num)	{m_numSubdomains = std::max(num, (size_t)1);}
+
+	///	sets the number of layers of overlap between the subdomains
+		void set_overlap(size_t numLayers)	{m_overlap = numLayers;}
+
+	///	restricted additive Schwarz (true, default) or additive Schwarz (false)
+		void set_restricted(bool bRestricted)	{m_bRestricted = bRestricted;}
+
+	///	sets the level of fill-in of the subdomain ILU(p)
+		void set_fill_level(int p)	{m_fillLevel = p;}
+
+	///	sets the smallest allowed value for sorted factorization
+		void set_sort_eps(number eps)	{m_sortEps = eps;}
+
+	///	sets the smallest allowed value for the Aii/Bi quotient
+		void set_inversion_eps(number eps)	{m_invEps = eps;}
+
+	///	returns information about configuration parameters
+		virtual std::string config_string() const
+		{
+			std::stringstream ss;
+			ss << name() << "( subdomains = " << m_numSubdomains << ", overlap = "
+			   << m_overlap << ", " << (m_bRestricted ? "restricted" : "additive")
+			   << ", ILU(" << m_fillLevel << "), damping = "
+			   << this->m_spDamping->config_string() << ")";
+			return ss.str();
+		}
+
+	protected:
+	//	Name of preconditioner
+		virtual const char* name() const {return "OverlappingSchwarz";}
+
+	///	data of a subdomain
+		struct Subdomain
+		{
+		///	(sorted) process local indices of the extended subdomain
+			std::vector<size_t> vIndex;
+
+		///	factorized subdomain matrix
+			subdomain_matrix_type LU;
+
+		///	local defect, correction and help vector
+			subdomain_vector_type d, c, h;
+		};
+
+	//	Preprocess routine
+		virtual bool preprocess(SmartPtr<MatrixOperator<matrix_type, vector_type> > pOp)
+		{
+			PROFILE_BEGIN_GROUP(OverlappingSchwarz_preprocess, "algebra OverlappingSchwarz");
+
+		//	process local matrix
+			matrix_type A;
+			A = *pOp;
+			#ifdef UG_PARALLEL
+				MatAddSlaveRowsToMasterRowOverlap0(A);
+			//	set dirichlet rows on slaves
+				std::vector<IndexLayout::Element> vIndex;
+				CollectUniqueElements(vIndex, A.layouts()->slave());
+				SetDirichletRow(A, vIndex);
+			#endif
+
+			create_subdomains(A);
+			extract_subdomain_matrices(A);
+
+		// 	factorize all subdomains independently
+			const int numSub = (int)m_vSubdomain.size();
+			#ifdef UG_OPENMP
+			#pragma omp parallel for schedule(dynamic)
+			#endif
+			for(int s = 0; s < numSub; ++s)
+			{
+				Subdomain& sub = *m_vSubdomain[s];
+				if(m_fillLevel > 0) AddILUFillIn(sub.LU, m_fillLevel);
+				FactorizeILUSorted(sub.LU, m_sortEps);
+				sub.LU.defragment();
+			}
+
+			return true;
+		}
+
+	//	Stepping routine
+		virtual bool step(SmartPtr<MatrixOperator<matrix_type, vector_type> > pOp,
+		                  vector_type& c,
+		                  const vector_type& d)
+		{
+			PROFILE_BEGIN_GROUP(OverlappingSchwarz_step, "algebra OverlappingSchwarz");
+
+			#ifdef UG_PARALLEL
+			//	make defect unique
+				SmartPtr<vector_type> spDtmp = d.clone();
+				spDtmp->change_storage_type(PST_UNIQUE);
+				const vector_type& dLocal = *spDtmp;
+			#else
+				const vector_type& dLocal = d;
+			#endif
+
+		//	solve all subdomain problems independently
+			const int numSub = (int)m_vSubdomain.size();
+			bool bSuccess = true;
+			#ifdef UG_OPENMP
+			#pragma omp parallel for schedule(dynamic) reduction(&&:bSuccess)
+			#endif
+			for(int s = 0; s < numSub; ++s)
+			{
+				Subdomain& sub = *m_vSubdomain[s];
+				for(size_t i = 0; i < sub.vIndex.size(); ++i)
+					sub.d[i] = dLocal[sub.vIndex[i]];
+				invert_L(sub.LU, sub.h, sub.d);
+				bSuccess = invert_U(sub.LU, sub.c, sub.h, m_invEps) && bSuccess;
+
+			//	restricted prolongation: every index is owned by one subdomain
+				if(m_bRestricted)
+					for(size_t i = 0; i < sub.vIndex.size(); ++i)
+						if(m_vOwner[sub.vIndex[i]] == s)
+							c[sub.vIndex[i]] = sub.c[i];
+			}
+			if(!bSuccess)
+				print_debugger_message("OverlappingSchwarz: There were issues at inverting U\n");
+
+		//	additive prolongation: sum up the overlap
+			if(!m_bRestricted)
+			{
+				for(size_t i = 0; i < c.size(); ++i) c[i] = 0.0;
+				for(int s = 0; s < numSub; ++s)
+				{
+					const Subdomain& sub = *m_vSubdomain[s];
+					for(size_t i = 0; i < sub.vIndex.size(); ++i)
+						c[sub.vIndex[i]] += sub.c[i];
+				}
+			}
+
+			#ifdef UG_PARALLEL
+				c.set_storage_type(PST_ADDITIVE);
+				c.change_storage_type(PST_CONSISTENT);
+			#endif
+
+			return true;
+		}
+
+	///	Postprocess routine
+		virtual bool postprocess() {return true;}
+
+	protected:
+	///	splits the indices into blocks and extends them by the overlap layers
+		void create_subdomains(const matrix_type& A)
+		{
+			typedef typename matrix_type::const_row_iterator const_row_iterator;
+			const size_t n = A.num_rows();
+			const size_t numSub = std::max(std::min(m_numSubdomains, n), (size_t)1);
+
+			m_vOwner.resize(n);
+			for(size_t i = 0; i < n; ++i)
+				m_vOwner[i] = (int)((i * numSub) / n);
+
+			m_vSubdomain.resize(numSub);
+			for(size_t s = 0; s < numSub; ++s)
+				m_vSubdomain[s] = make_sp(new Subdomain);
+
+		//	mark[i] == s, iff i already in subdomain s
+			std::vector<int> vMark(n, -1);
+			std::vector<size_t> vFront, vNewFront;
+			for(size_t s = 0; s < numSub; ++s)
+			{
+				std::vector<size_t>& vIndex = m_vSubdomain[s]->vIndex;
+				vIndex.clear();
+				const size_t begin = (s * n + numSub - 1) / numSub;
+				const size_t end = ((s+1) * n + numSub - 1) / numSub;
+				for(size_t i = begin; i < end; ++i)
+				{
+					vIndex.push_back(i);
+					vMark[i] = (int)s;
+				}
+
+				vFront = vIndex;
+				for(size_t layer = 0; layer < m_overlap && !vFront.empty(); ++layer)
+				{
+					vNewFront.clear();
+					for(size_t l = 0; l < vFront.size(); ++l)
+						for(const_row_iterator it = A.begin_row(vFront[l]);
+								it != A.end_row(vFront[l]); ++it)
+						{
+							const size_t j = it.index();
+							if(vMark[j] == (int)s || it.value() == 0.0) continue;
+							vMark[j] = (int)s;
+							vNewFront.push_back(j);
+						}
+					vIndex.insert(vIndex.end(), vNewFront.begin(), vNewFront.end());
+					vFront.swap(vNewFront);
+				}
+				std::sort(vIndex.begin(), vIndex.end());
+			}
+		}
+
+	///	copies the matrix entries of each extended subdomain
+		void extract_subdomain_matrices(const matrix_type& A)
+		{
+			typedef typename matrix_type::const_row_iterator const_row_iterator;
+			std::vector<int> vLocal(A.num_rows(), -1);
+			for(size_t s = 0; s < m_vSubdomain.size(); ++s)
+			{
+				Subdomain& sub = *m_vSubdomain[s];
+				const size_t m = sub.vIndex.size();
+				for(size_t i = 0; i < m; ++i) vLocal[sub.vIndex[i]] = (int)i;
+
+				sub.LU.resize_and_clear(m, m);
+				for(size_t i = 0; i < m; ++i)
+					for(const_row_iterator it = A.begin_row(sub.vIndex[i]);
+							it != A.end_row(sub.vIndex[i]); ++it)
+					{
+						const int j = vLocal[it.index()];
+						if(j >= 0) sub.LU(i, j) = it.value();
+					}
+
+				sub.d.resize(m); sub.c.resize(m); sub.h.resize(m);
+				for(size_t i = 0; i < m; ++i) vLocal[sub.vIndex[i]] = -1;
+			}
+		}
+
+	protected:
+	///	subdomains
+		std::vector<SmartPtr<Subdomain> > m_vSubdomain;
+
+	///	subdomain owning an index (for the restricted prolongation)
+		std::vector<int> m_vOwner;
+
+	///	number of subdomains
+		size_t m_numSubdomains;
+
+	///	number of layers of overlap
+		size_t m_overlap;
+
+	///	restricted or plain additive Schwarz
+		bool m_bRestricted;
+
+	///	level of fill-in for ILU(p) on the subdomains
+		int m_fillLevel;
+
+	///	smallest allowed value for sorted factorization
+		number m_sortEps;
+
+	///	smallest allowed value for the Aii/Bi quotient
+		number m_invEps;
+};
+
+} // end namespace ug
+
+#endif /* __H__UG__LIB_ALGEBRA__OPERATOR__PRECONDITIONER__OVERLAPPING_SCHWARZ__ */
@@ -34,9 +34,11 @@
 #define __UG__PRECONDITIONERS_H__
 
 #include "lib_algebra/operator/preconditioner/jacobi.h"
+#include "lib_algebra/operator/preconditioner/chebyshev.h"
 #include "lib_algebra/operator/preconditioner/gauss_seidel.h"
 #include "lib_algebra/operator/preconditioner/ilu.h"
 #include "lib_algebra/operator/preconditioner/ilut.h"
+#include "lib_algebra/operator/preconditioner/overlapping_schwarz.h"
 #include "lib_algebra/operator/preconditioner/iterator_product.h"
 #include "lib_algebra/operator/preconditioner/vanka.h"
 #include "lib_algebra/operator/preconditioner/schur/schur_precond.h"
@@ -392,6 +392,30 @@ struct block_traits< DenseMatrix< FixedArray2<number, 3, 3, TOrdering> > >
 	typedef DenseMatrix< FixedArray2<number, 3, 3, TOrdering> > inverse_type;
 };
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+// fixed 4x4 and 6x6 : inverse is matrix (computed by Gauss-Jordan, see densematrix_inverse.h)
+template<eMatrixOrdering TOrdering>
+struct block_traits< DenseMatrix< FixedArray2<number, 4, 4, TOrdering> > >
+{
+	enum { ordering = DenseMatrix< FixedArray2<number, 4, 4> >::ordering };
+	enum { is_static = true};
+	enum { static_num_rows = 4};
+	enum { static_num_cols = 4};
+
+	typedef DenseMatrix< FixedArray2<number, 4, 4, TOrdering> > inverse_type;
+};
+
+template<eMatrixOrdering TOrdering>
+struct block_traits< DenseMatrix< FixedArray2<number, 6, 6, TOrdering> > >
+{
+	enum { ordering = DenseMatrix< FixedArray2<number, 6, 6> >::ordering };
+	enum { is_static = true};
+	enum { static_num_rows = 6};
+	enum { static_num_cols = 6};
+
+	typedef DenseMatrix< FixedArray2<number, 6, 6, TOrdering> > inverse_type;
+};
+
 
 template<typename T> struct block_multiply_traits<DenseMatrix<T>, DenseMatrix<T> >
 {
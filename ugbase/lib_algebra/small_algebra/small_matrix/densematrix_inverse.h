@@ -39,6 +39,7 @@
 #include "common/common.h"
 #include "lib_algebra/small_algebra/small_algebra.h"  // for InvertNdyn
 #include <algorithm>
+#include <cmath>
 
 //
 namespace ug {
@@ -253,6 +254,139 @@ inline bool InverseMatMult(DenseVector< FixedArray1<double, 3> > &dest, double b
 	return InverseMatMult3(dest, beta, mat, vec);
 }
 //////////////////////
+// NxN (fixed)
+
+//! computes inv = mat^{-1} by Gauss-Jordan elimination with partial pivoting (inv may be mat)
+template<size_t N, eMatrixOrdering TOrdering>
+inline bool GetInverseGaussJordan(DenseMatrix<FixedArray2<double, N, N, TOrdering> > &inv,
+		const DenseMatrix<FixedArray2<double, N, N, TOrdering> > &mat)
+{
+	double a[N][N], b[N][N];
+	for(size_t r = 0; r < N; ++r)
+		for(size_t c = 0; c < N; ++c)
+		{
+			a[r][c] = mat(r,c);
+			b[r][c] = (r == c) ? 1.0 : 0.0;
+		}
+
+	for(size_t k = 0; k < N; ++k)
+	{
+	//	find pivot
+		size_t p = k;
+		double pmax = fabs(a[k][k]);
+		for(size_t r = k+1; r < N; ++r)
+			if(fabs(a[r][k]) > pmax) {pmax = fabs(a[r][k]); p = r;}
+		if(pmax == 0.0) return false;
+
+		if(p != k)
+			for(size_t c = 0; c < N; ++c)
+			{
+				std::swap(a[k][c], a[p][c]);
+				std::swap(b[k][c], b[p][c]);
+			}
+
+	//	scale pivot row and eliminate column k in all other rows
+		const double pivInv = 1.0/a[k][k];
+		for(size_t c = 0; c < N; ++c)
+		{
+			a[k][c] *= pivInv;
+			b[k][c] *= pivInv;
+		}
+
+		for(size_t r = 0; r < N; ++r)
+		{
+			if(r == k) continue;
+			const double f = a[r][k];
+			if(f == 0.0) continue;
+			for(size_t c = 0; c < N; ++c)
+			{
+				a[r][c] -= f * a[k][c];
+				b[r][c] -= f * b[k][c];
+			}
+		}
+	}
+
+	for(size_t r = 0; r < N; ++r)
+		for(size_t c = 0; c < N; ++c)
+			inv(r,c) = b[r][c];
+	return true;
+}
+
+//! calculates dest = beta * mat^{-1} * vec by Gaussian elimination with partial pivoting
+template<size_t N, eMatrixOrdering TOrdering>
+inline bool InverseMatMultGauss(DenseVector<FixedArray1<double, N> > &dest, double beta,
+		const DenseMatrix<FixedArray2<double, N, N, TOrdering> > &mat,
+		const DenseVector<FixedArray1<double, N> > &vec)
+{
+	double a[N][N], x[N];
+	for(size_t r = 0; r < N; ++r)
+	{
+		for(size_t c = 0; c < N; ++c)
+			a[r][c] = mat(r,c);
+		x[r] = vec[r];
+	}
+
+	for(size_t k = 0; k < N; ++k)
+	{
+		size_t p = k;
+		double pmax = fabs(a[k][k]);
+		for(size_t r = k+1; r < N; ++r)
+			if(fabs(a[r][k]) > pmax) {pmax = fabs(a[r][k]); p = r;}
+		if(pmax == 0.0) return false;
+
+		if(p != k)
+		{
+			for(size_t c = k; c < N; ++c)
+				std::swap(a[k][c], a[p][c]);
+			std::swap(x[k], x[p]);
+		}
+
+		for(size_t r = k+1; r < N; ++r)
+		{
+			const double f = a[r][k] / a[k][k];
+			for(size_t c = k+1; c < N; ++c)
+				a[r][c] -= f * a[k][c];
+			x[r] -= f * x[k];
+		}
+	}
+
+	for(size_t r = N; r-- > 0; )
+	{
+		double s = x[r];
+		for(size_t c = r+1; c < N; ++c)
+			s -= a[r][c] * x[c];
+		x[r] = s / a[r][r];
+	}
+
+	for(size_t r = 0; r < N; ++r)
+		dest[r] = beta * x[r];
+	return true;
+}
+
+//////////////////////
+// 4x4 and 6x6: explicit inverse, so that applying the inverse is a block mat-vec
+
+inline bool GetInverse(DenseMatrix<FixedArray2<double, 4, 4> > &inv, const DenseMatrix<FixedArray2<double, 4, 4> > &mat)
+{
+	return GetInverseGaussJordan(inv, mat);
+}
+
+inline bool Invert(DenseMatrix< FixedArray2<double, 4, 4> > &mat)
+{
+	return GetInverseGaussJordan(mat, mat);
+}
+
+inline bool GetInverse(DenseMatrix<FixedArray2<double, 6, 6> > &inv, const DenseMatrix<FixedArray2<double, 6, 6> > &mat)
+{
+	return GetInverseGaussJordan(inv, mat);
+}
+
+inline bool Invert(DenseMatrix< FixedArray2<double, 6, 6> > &mat)
+{
+	return GetInverseGaussJordan(mat, mat);
+}
+
+//////////////////////
 
 
 
@@ -340,6 +474,21 @@ inline bool InverseMatMult(DenseVector<vector_t> &dest, double beta,
 	}
 }
 
+//! calculates dest = beta * mat^{-1} * vec for fixed block sizes without building an inverse
+template<size_t N, eMatrixOrdering TOrdering>
+inline bool InverseMatMult(DenseVector<FixedArray1<double, N> > &dest, double beta,
+		const DenseMatrix<FixedArray2<double, N, N, TOrdering> > &mat,
+		const DenseVector<FixedArray1<double, N> > &vec)
+{
+	switch(N)
+	{
+		case 1: return InverseMatMult1(dest, beta, mat, vec);
+		case 2: return InverseMatMult2(dest, beta, mat, vec);
+		case 3: return InverseMatMult3(dest, beta, mat, vec);
+		default: return InverseMatMultGauss(dest, beta, mat, vec);
+	}
+}
+
 ///////////////////////////////////////////
 
 // end group small_algebra
@@ -93,6 +93,71 @@ inline void MatMultTransposedAdd(DenseVector<vector_t> &dest,
 	}
 }
 
+//////////////////////////////////////////////////////
+// fixed block size
+//
+// The following overloads are selected for the blocks of CPUBlockAlgebra<N>.
+// Since the block size is known at compile time, the loops are unrolled and
+// vectorized by the compiler and the row sums are accumulated in registers
+// instead of being written back to dest for every entry. The input vector is
+// copied first, so dest may alias v1 and w1.
+
+//! calculates dest = beta1 * A1 * w1;
+template<size_t N, eMatrixOrdering TOrdering>
+inline void MatMult(DenseVector<FixedArray1<double, N> > &dest,
+		const number &beta1, const DenseMatrix<FixedArray2<double, N, N, TOrdering> > &A1,
+		const DenseVector<FixedArray1<double, N> > &w1)
+{
+	double w[N];
+	for(size_t c = 0; c < N; ++c) w[c] = w1[c];
+
+	for(size_t r = 0; r < N; ++r)
+	{
+		double s = 0.0;
+		for(size_t c = 0; c < N; ++c)
+			s += A1(r,c) * w[c];
+		dest[r] = beta1 * s;
+	}
+}
+
+//! calculates dest = alpha1*v1 + beta1 * A1 *w1;
+template<size_t N, eMatrixOrdering TOrdering>
+inline void MatMultAdd(DenseVector<FixedArray1<double, N> > &dest,
+		const number &alpha1, const DenseVector<FixedArray1<double, N> > &v1,
+		const number &beta1, const DenseMatrix<FixedArray2<double, N, N, TOrdering> > &A1,
+		const DenseVector<FixedArray1<double, N> > &w1)
+{
+	double w[N];
+	for(size_t c = 0; c < N; ++c) w[c] = w1[c];
+
+	for(size_t r = 0; r < N; ++r)
+	{
+		double s = 0.0;
+		for(size_t c = 0; c < N; ++c)
+			s += A1(r,c) * w[c];
+		dest[r] = alpha1 * v1[r] + beta1 * s;
+	}
+}
+
+//! calculates dest = alpha1*v1 + beta1 * A1^T *w1;
+template<size_t N, eMatrixOrdering TOrdering>
+inline void MatMultTransposedAdd(DenseVector<FixedArray1<double, N> > &dest,
+		const number &alpha1, const DenseVector<FixedArray1<double, N> > &v1,
+		const number &beta1, const DenseMatrix<FixedArray2<double, N, N, TOrdering> > &A1,
+		const DenseVector<FixedArray1<double, N> > &w1)
+{
+	double w[N];
+	for(size_t c = 0; c < N; ++c) w[c] = w1[c];
+
+	for(size_t r = 0; r < N; ++r)
+	{
+		double s = 0.0;
+		for(size_t c = 0; c < N; ++c)
+			s += A1(c,r) * w[c];
+		dest[r] = alpha1 * v1[r] + beta1 * s;
+	}
+}
+
 // end group small_algebra
 /// \}
 
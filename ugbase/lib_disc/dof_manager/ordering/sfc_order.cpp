@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#include "sfc_order.h"
+#include "common/common.h"
+#include "lib_disc/function_spaces/dof_position_util.h"
+#include "lib_disc/domain.h"
+#include <algorithm>
+#include <vector>
+#include <utility>
+
+namespace ug{
+
+namespace{
+struct CompareSFCIndexPair{
+	bool operator()(const std::pair<uint64, size_t>& p1,
+					const std::pair<uint64, size_t>& p2) const
+	{return p1.first < p2.first;}
+};
+}
+
+template<int dim>
+void ComputeSFCOrder(std::vector<size_t>& vNewIndex,
+                     std::vector<std::pair<MathVector<dim>, size_t> >& vPos,
+                     SFCType type)
+{
+	if(vPos.empty()) return;
+
+//	bounding box of all positions
+	MathVector<dim> boxMin = vPos[0].first, boxMax = vPos[0].first;
+	for(size_t i = 1; i < vPos.size(); ++i){
+		for(int d = 0; d < dim; ++d){
+			boxMin[d] = std::min(boxMin[d], vPos[i].first[d]);
+			boxMax[d] = std::max(boxMax[d], vPos[i].first[d]);
+		}
+	}
+
+//	index along the curve
+	std::vector<std::pair<uint64, size_t> > vSFCInd(vPos.size());
+	for(size_t i = 0; i < vPos.size(); ++i){
+		vSFCInd[i].first = SFCIndex(type, vPos[i].first, boxMin, boxMax);
+		vSFCInd[i].second = vPos[i].second;
+	}
+
+//	sort indices based on their index along the curve
+	std::stable_sort(vSFCInd.begin(), vSFCInd.end(), CompareSFCIndexPair());
+
+//	write mapping
+	for(size_t i = 0; i < vNewIndex.size(); ++i)
+		vNewIndex[i] = i;
+
+	if(vNewIndex.size() == vSFCInd.size()){
+		for(size_t i = 0; i < vSFCInd.size(); ++i)
+			vNewIndex[vSFCInd[i].second] = i;
+	}
+//	only some indices are ordered. They are distributed to the slots they
+//	occupied before.
+	else{
+		std::vector<size_t> vSlots(vPos.size());
+		for(size_t i = 0; i < vPos.size(); ++i)
+			vSlots[i] = vPos[i].second;
+		std::sort(vSlots.begin(), vSlots.end());
+
+		for(size_t i = 0; i < vSFCInd.size(); ++i)
+			vNewIndex[vSFCInd[i].second] = vSlots[i];
+	}
+}
+
+template <typename TDomain>
+void OrderSFCForDofDist(SmartPtr<DoFDistribution> dd, ConstSmartPtr<TDomain> domain,
+                        SFCType type)
+{
+	typedef typename std::pair<MathVector<TDomain::dim>, size_t> pos_type;
+
+//	get positions of indices
+	std::vector<pos_type> vPositions;
+	ExtractPositions(domain, dd, vPositions);
+
+//	get mapping: old -> new index
+	std::vector<size_t> vNewIndex(dd->num_indices());
+	ComputeSFCOrder<TDomain::dim>(vNewIndex, vPositions, type);
+
+//	reorder indices
+	dd->permute_indices(vNewIndex);
+}
+
+template <typename TDomain>
+void OrderSFC(ApproximationSpace<TDomain>& approxSpace, const char* type)
+{
+	const SFCType sfc = StringToSFCType(type);
+
+	std::vector<SmartPtr<DoFDistribution> > vDD = approxSpace.dof_distributions();
+	for (size_t i = 0; i < vDD.size(); ++i)
+		OrderSFCForDofDist<TDomain>(vDD[i], approxSpace.domain(), sfc);
+}
+
+#ifdef UG_DIM_1
+template void ComputeSFCOrder<1>(std::vector<size_t>& vNewIndex, std::vector<std::pair<MathVector<1>, size_t> >& vPos, SFCType);
+template void OrderSFCForDofDist<Domain1d>(SmartPtr<DoFDistribution> dd, ConstSmartPtr<Domain1d> domain, SFCType);
+template void OrderSFC<Domain1d>(ApproximationSpace<Domain1d>& approxSpace, const char* type);
+#endif
+#ifdef UG_DIM_2
+template void ComputeSFCOrder<2>(std::vector<size_t>& vNewIndex, std::vector<std::pair<MathVector<2>, size_t> >& vPos, SFCType);
+template void OrderSFCForDofDist<Domain2d>(SmartPtr<DoFDistribution> dd, ConstSmartPtr<Domain2d> domain, SFCType);
+template void OrderSFC<Domain2d>(ApproximationSpace<Domain2d>& approxSpace, const char* type);
+#endif
+#ifdef UG_DIM_3
+template void ComputeSFCOrder<3>(std::vector<size_t>& vNewIndex, std::vector<std::pair<MathVector<3>, size_t> >& vPos, SFCType);
+template void OrderSFCForDofDist<Domain3d>(SmartPtr<DoFDistribution> dd, ConstSmartPtr<Domain3d> domain, SFCType);
+template void OrderSFC<Domain3d>(ApproximationSpace<Domain3d>& approxSpace, const char* type);
+#endif
+
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__LIB_DISC__DOF_MANAGER__SFC_ORDER__
+#define __H__UG__LIB_DISC__DOF_MANAGER__SFC_ORDER__
+
+#include <vector>
+#include <utility> // for pair
+
+#include "lib_disc/function_spaces/approximation_space.h"
+#include "lib_grid/algorithms/space_filling_curve_util.h"
+
+namespace ug{
+
+///	computes the order of the given positions along a space filling curve
+/**	vNewIndex[vPos[i].second] is set to the position of the i-th entry along
+ * the curve. Entries with equal positions keep their relative order.*/
+template<int dim>
+void ComputeSFCOrder(std::vector<size_t>& vNewIndex,
+                     std::vector<std::pair<MathVector<dim>, size_t> >& vPos,
+                     SFCType type);
+
+/// orders the dof distribution along a space filling curve through the dof positions
+/**	In contrast to lexicographic ordering, any combination of trial spaces is
+ * supported. DoFs located at the same position (e.g. several components on
+ * one vertex) stay together and keep their relative order.*/
+template <typename TDomain>
+void OrderSFCForDofDist(SmartPtr<DoFDistribution> dd, ConstSmartPtr<TDomain> domain,
+                        SFCType type);
+
+/// orders all DofDistributions of the ApproximationSpace along a space filling curve
+/**	type has to be "hilbert" or "morton".*/
+template <typename TDomain>
+void OrderSFC(ApproximationSpace<TDomain>& approxSpace, const char* type);
+
+} // end namespace ug
+
+#endif /* __H__UG__LIB_DISC__DOF_MANAGER__SFC_ORDER__ */
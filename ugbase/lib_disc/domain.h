@@ -34,6 +34,7 @@
 #define __H__UG__LIB_DISC__DOMAIN__
 
 #include "lib_grid/algorithms/subset_util.h"
+#include "lib_grid/algorithms/space_filling_curve_util.h"
 #include "lib_grid/refinement/projectors/refinement_projector.h"
 
 #include <map>
@@ -224,6 +225,18 @@ class IDomain
 	///	returns the geometry of the domain
 		virtual SPIGeometry3d geometry3d() const = 0;
 
+	///	reorders the grid elements along a space filling curve after each grid change
+	/**	type has to be "hilbert" or "morton". The elements of the grid and of
+	 * all subset handlers of the domain are reordered immediately and again
+	 * each time the grid has been loaded, adapted or redistributed. Element
+	 * loops and dof numbers then follow the curve, which improves cache reuse.
+	 * Pass "none" to disable the automatic reordering.
+	 * See OrderElementsAlongSFC.*/
+		void set_sfc_order(const char* type);
+
+	///	reorders the grid elements along the given space filling curve
+		virtual void order_elements_along_sfc(SFCType type) = 0;
+
 	protected:
 		#ifdef UG_PARALLEL
 		/// helper method to broadcast ug::RefinementProjectors to different processes
@@ -255,6 +268,16 @@ class IDomain
 
 		bool	m_isAdaptive;
 		bool	m_adaptionIsActive;
+		bool	m_distributionIsActive;
+
+	///	curve along which the elements are ordered after grid changes
+	///	\{
+		bool	m_bSFCOrder;
+		SFCType	m_sfcOrder;
+	///	\}
+
+	///	reorders the elements if requested through set_sfc_order
+		void update_element_order();
 
 	/**	this callback is called by the message hub, when a grid adaption has been
 	 * performed. It will call all necessary actions in order to keep the grid
@@ -337,6 +360,8 @@ class Domain : public IDomain<TGrid, TSubsetHandler>
 
 		virtual SPIGeometry3d geometry3d() const	{return m_geometry3d;}
 
+		virtual void order_elements_along_sfc(SFCType type);
+
 	protected:
 		position_attachment_type m_aPos;	///<Position Attachment
 		position_accessor_type	m_aaPos;		///<Accessor
@@ -36,6 +36,7 @@
 #include "domain.h"
 #include "common/serialization.h"
 #include "common/profiler/profiler.h"
+#include "common/util/string_util.h"
 
 #ifdef UG_PARALLEL
 	#include "lib_grid/refinement/projectors/projectors.h"
@@ -63,7 +64,10 @@ IDomain<TGrid,TSubsetHandler>::IDomain(bool isAdaptive)
 	m_spGrid(new TGrid(GRIDOPT_NONE)),	// Note: actual options are set by the derived class (dimension dependent).
 	m_spSH(new TSubsetHandler(*m_spGrid)),
 	m_isAdaptive(isAdaptive),
-	m_adaptionIsActive(false)
+	m_adaptionIsActive(false),
+	m_distributionIsActive(false),
+	m_bSFCOrder(false),
+	m_sfcOrder(SFC_HILBERT)
 {
 	#ifdef UG_PARALLEL
 	//	the grid has to be prepared for parallelism
@@ -169,6 +173,7 @@ grid_adaption_callback(const GridMessage_Adaption& msg)
 		//if(msg.adaptive()){
 			if(msg.adaption_ends())
 			{
+				update_element_order();
 				update_domain_info();
 				m_adaptionIsActive = false;
 			}
@@ -191,6 +196,10 @@ grid_creation_callback(const GridMessage_Creation& msg)
 	if(msg.msg() == GMCT_CREATION_STOPS){
 		if(msg.proc_id() != -1)
 			update_subset_infos(msg.proc_id());
+	//	during redistribution the elements are reordered once it is done,
+	//	see grid_distribution_callback
+		if(!m_distributionIsActive)
+			update_element_order();
 		update_domain_info();
 	}
 }
@@ -204,6 +213,35 @@ grid_distribution_callback(const GridMessage_Distribution& msg)
 	/*if(msg.msg() == GMDT_DISTRIBUTION_STOPS){
 		update_domain_info();
 	}*/
+	if(msg.msg() == GMDT_DISTRIBUTION_STARTS)
+		m_distributionIsActive = true;
+	else if(msg.msg() == GMDT_DISTRIBUTION_STOPS){
+		m_distributionIsActive = false;
+		update_element_order();
+	}
+}
+
+template <typename TGrid, typename TSubsetHandler>
+void IDomain<TGrid,TSubsetHandler>::
+set_sfc_order(const char* type)
+{
+	const std::string name = ToLower(TrimString(type));
+	if(name.empty() || name == "none"){
+		m_bSFCOrder = false;
+		return;
+	}
+
+	m_sfcOrder = StringToSFCType(name);
+	m_bSFCOrder = true;
+	update_element_order();
+}
+
+template <typename TGrid, typename TSubsetHandler>
+void IDomain<TGrid,TSubsetHandler>::
+update_element_order()
+{
+	if(m_bSFCOrder)
+		order_elements_along_sfc(m_sfcOrder);
 }
 
 
@@ -691,6 +729,25 @@ Domain(bool isAdaptive) : IDomain<TGrid, TSubsetHandler>(isAdaptive)
 	this->m_refinementProjector = make_sp(new RefinementProjector(m_geometry3d));
 }
 
+template <int d, typename TGrid, typename TSubsetHandler>
+void Domain<d,TGrid,TSubsetHandler>::
+order_elements_along_sfc(SFCType type)
+{
+	PROFILE_FUNC();
+
+	std::vector<ISubsetHandler*> vSH;
+	vSH.push_back(this->m_spSH.get());
+
+	typedef typename std::map<std::string, SmartPtr<TSubsetHandler> >::iterator sh_iter_t;
+	for(sh_iter_t iter = this->m_additionalSH.begin();
+		iter != this->m_additionalSH.end(); ++iter)
+	{
+		vSH.push_back(iter->second.get());
+	}
+
+	OrderElementsAlongSFC(*this->m_spGrid, m_aaPos, type, vSH);
+}
+
 
 } // end namespace ug
 
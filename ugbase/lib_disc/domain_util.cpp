@@ -36,14 +36,32 @@
 #include "common/util/file_util.h"
 #include "lib_grid/file_io/file_io.h"
 #include "lib_grid/file_io/file_io_ugx.h"
+#include "lib_grid/file_io/file_io_ugx_stream.h"
+#include "lib_grid/file_io/file_io_ugb.h"
 #include "lib_grid/algorithms/geom_obj_util/misc_util.h"
 #include "lib_grid/refinement/projectors/projection_handler.h"
 #include "common/profiler/profiler.h"
 
+#ifdef UG_PARALLEL
+	#include "lib_grid/parallelization/distributed_loading.h"
+#endif
+
 using namespace std;
 
 namespace ug{
 
+///	returns true for .ugx files and for gzip or zstd compressed .ugx files
+static bool IsUGXFilename(const char* filename)
+{
+	string name(filename);
+	string ext = GetFilenameExtension(name);
+	if(ext == string("ugx"))
+		return true;
+	if(ext == string("gz") || ext == string("zst"))
+		return name.find(".ugx.") != string::npos;
+	return false;
+}
+
 template <typename TDomain>
 void LoadDomain(TDomain& domain, const char* filename)
 {
@@ -56,7 +74,7 @@ template <typename TDomain>
 void LoadDomain(TDomain& domain, const char* filename, int procId)
 {
 	PROFILE_FUNC_GROUP("grid");
-	if(GetFilenameExtension(string(filename)) == string("ugx")){
+	if(IsUGXFilename(filename)){
 		domain.grid()->message_hub()->post_message(GridMessage_Creation(GMCT_CREATION_STARTS, procId));
 
 		bool loadingGrid = true;
@@ -68,38 +86,29 @@ void LoadDomain(TDomain& domain, const char* filename, int procId)
 		if(loadingGrid){
 			string nfilename = FindFileInStandardPaths(filename);
 			if(!nfilename.empty()){
-				GridReaderUGX ugxReader;
-				if(!ugxReader.parse_file(nfilename.c_str())){
-					UG_THROW("An error occured while parsing '" << nfilename << "'");
-				}
-
-				if(ugxReader.num_grids() < 1){
-					UG_THROW("ERROR in LoadGridFromUGX: File contains no grid.");
-				}
-
-				ugxReader.grid(*domain.grid(), 0, domain.position_attachment());
-
-				if(ugxReader.num_subset_handlers(0) > 0)
-					ugxReader.subset_handler(*domain.subset_handler(), 0, 0);
+				GridReaderUGXStream ugxReader;
+				ugxReader.set_subset_handler(*domain.subset_handler());
 
 				vector<string> additionalSHNames = domain.additional_subset_handler_names();
 				for(size_t i_name = 0; i_name < additionalSHNames.size(); ++i_name){
 					string shName = additionalSHNames[i_name];
-					for(size_t i_sh = 0; i_sh < ugxReader.num_subset_handlers(0); ++i_sh){
-						if(shName == ugxReader.get_subset_handler_name(0, i_sh)){
-							ugxReader.subset_handler(*domain.additional_subset_handler(shName), i_sh, 0);
-						}
-					}
+					ugxReader.add_subset_handler(*domain.additional_subset_handler(shName),
+												 shName.c_str());
 				}
 
-				if(ugxReader.num_projection_handlers(0) > 0){
-					SPProjectionHandler ph = make_sp(
-							new ProjectionHandler(domain.geometry3d(), domain.subset_handler()));
-					ugxReader.projection_handler(*ph, 0, 0);
-					size_t shIndex = ugxReader.get_projection_handler_subset_handler_index(0, 0);
-					std::string shName;
-					shName = std::string(ugxReader.get_subset_handler_name(0, shIndex));
-					if (shIndex > 0)
+				SPProjectionHandler ph = make_sp(
+						new ProjectionHandler(domain.geometry3d(), domain.subset_handler()));
+				ugxReader.set_projection_handler(*ph);
+
+				if(!ugxReader.read(nfilename.c_str(), *domain.grid(),
+								   domain.position_attachment()))
+				{
+					UG_THROW("An error occured while parsing '" << nfilename << "'");
+				}
+
+				if(ugxReader.projection_handler_read()){
+					std::string shName = ugxReader.projection_handler_subset_handler_name();
+					if(!shName.empty())
 					{
 						try {ph->set_subset_handler(domain.additional_subset_handler(shName));}
 						UG_CATCH_THROW("Additional subset handler '"<< shName << "' has not been added to the domain.\n"
@@ -114,6 +123,38 @@ void LoadDomain(TDomain& domain, const char* filename, int procId)
 		}
 		domain.grid()->message_hub()->post_message(GridMessage_Creation(GMCT_CREATION_STOPS, procId));
 	}
+	else if(GetFilenameExtension(string(filename)) == string("ugb")){
+		domain.grid()->message_hub()->post_message(GridMessage_Creation(GMCT_CREATION_STARTS, procId));
+
+		bool loadingGrid = true;
+		#ifdef UG_PARALLEL
+			if((procId != -1) && (procId != -2) && (pcl::ProcRank() != procId))
+				loadingGrid = false;
+		#endif
+
+		if(loadingGrid){
+			string nfilename = FindFileInStandardPaths(filename);
+			if(nfilename.empty()){
+				UG_THROW("ERROR in LoadDomain: File not found: " << filename);
+			}
+
+			GridReaderUGB ugbReader;
+			if(!ugbReader.open(nfilename.c_str())
+			   || !ugbReader.load(*domain.grid(), domain.subset_handler().get(),
+			   					  domain.position_attachment()))
+			{
+				UG_THROW("LoadDomain: Could not load file: " << filename);
+			}
+
+			if(ugbReader.has_section(GridReaderUGB::PROJECTION_HANDLER)){
+				SPProjectionHandler ph = make_sp(
+						new ProjectionHandler(domain.geometry3d(), domain.subset_handler()));
+				ugbReader.load_projection_handler(*ph);
+				domain.set_refinement_projector(ph);
+			}
+		}
+		domain.grid()->message_hub()->post_message(GridMessage_Creation(GMCT_CREATION_STOPS, procId));
+	}
 	else if(!LoadGridFromFile(*domain.grid(), *domain.subset_handler(),
 						 filename, domain.position_attachment(), procId))
 	{
@@ -122,6 +163,38 @@ void LoadDomain(TDomain& domain, const char* filename, int procId)
 }
 
 
+template <typename TDomain>
+void LoadAndDistributeDomain(TDomain& domain, const char* filename)
+{
+	PROFILE_FUNC_GROUP("grid");
+#ifdef UG_PARALLEL
+	UG_COND_THROW(GetFilenameExtension(string(filename)) != string("ugb"),
+				  "LoadAndDistributeDomain: Only ugb files are supported: " << filename);
+
+	string nfilename = FindFileInStandardPaths(filename);
+	UG_COND_THROW(nfilename.empty(),
+				  "ERROR in LoadAndDistributeDomain: File not found: " << filename);
+
+	domain.grid()->message_hub()->post_message(GridMessage_Creation(GMCT_CREATION_STARTS, -1));
+	LoadDistributedGridFromUGB(*domain.grid(), domain.subset_handler().get(),
+							   nfilename.c_str(), domain.position_attachment());
+
+	GridReaderUGB ugbReader;
+	if(ugbReader.open(nfilename.c_str())
+	   && ugbReader.has_section(GridReaderUGB::PROJECTION_HANDLER))
+	{
+		SPProjectionHandler ph = make_sp(
+				new ProjectionHandler(domain.geometry3d(), domain.subset_handler()));
+		ugbReader.load_projection_handler(*ph);
+		domain.set_refinement_projector(ph);
+	}
+	domain.grid()->message_hub()->post_message(GridMessage_Creation(GMCT_CREATION_STOPS, -1));
+#else
+	LoadDomain(domain, filename);
+#endif
+}
+
+
 template <typename TDomain>
 void SaveDomain(TDomain& domain, const char* filename)
 {
@@ -141,6 +214,19 @@ void SaveDomain(TDomain& domain, const char* filename)
 			UG_THROW("Couldn't save domain to the specified file: " << filename);
 		}
 	}
+	else if(GetFilenameExtension(string(filename)) == string("ugb")){
+	//	the projection handler is only stored if it operates on the default subset handler
+		ProjectionHandler* ph = dynamic_cast<ProjectionHandler*>(
+										domain.refinement_projector().get());
+		if(ph && ph->subset_handler() != domain.subset_handler().get())
+			ph = NULL;
+
+		if(!SaveGridToUGB(*domain.grid(), domain.subset_handler().get(), filename,
+						  domain.position_attachment(), ph))
+		{
+			UG_THROW("SaveDomain: Could not save to file: " << filename);
+		}
+	}
 	else if(!SaveGridToFile(*domain.grid(), *domain.subset_handler(),
 						  filename, domain.position_attachment()))
 		UG_THROW("SaveDomain: Could not save to file: "<<filename);
@@ -173,6 +259,10 @@ template void LoadDomain<Domain1d>(Domain1d& domain, const char* filename, int p
 template void LoadDomain<Domain2d>(Domain2d& domain, const char* filename, int procId);
 template void LoadDomain<Domain3d>(Domain3d& domain, const char* filename, int procId);
 
+template void LoadAndDistributeDomain<Domain1d>(Domain1d& domain, const char* filename);
+template void LoadAndDistributeDomain<Domain2d>(Domain2d& domain, const char* filename);
+template void LoadAndDistributeDomain<Domain3d>(Domain3d& domain, const char* filename);
+
 template void SaveDomain<Domain1d>(Domain1d& domain, const char* filename);
 template void SaveDomain<Domain2d>(Domain2d& domain, const char* filename);
 template void SaveDomain<Domain3d>(Domain3d& domain, const char* filename);
@@ -54,6 +54,14 @@ template <typename TDomain>
 void LoadDomain(TDomain& domain, const char* filename, int procId);
 /**	\} */
 
+///	Loads a domain from a ugb file and distributes it onto all processes.
+/**	Each process only reads the parts of the file which it requires, so that
+ * no process has to hold the whole grid at any time. The resulting grid is
+ * distributed without vertical interfaces, see LoadDistributedGridFromUGB.
+ * In serial environments this is equivalent to LoadDomain.*/
+template <typename TDomain>
+void LoadAndDistributeDomain(TDomain& domain, const char* filename);
+
 ///	Saves the domain to a grid-file.
 template <typename TDomain>
 void SaveDomain(TDomain& domain, const char* filename);
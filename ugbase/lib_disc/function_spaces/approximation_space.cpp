@@ -41,6 +41,7 @@
 #endif
 
 #include "lib_disc/dof_manager/dof_distribution.h"
+#include "lib_disc/dof_manager/ordering/sfc_order.h"
 #include "grid_function.h"
 
 #include <algorithm> // std::sort
@@ -413,6 +414,7 @@ void IApproximationSpace::reinit()
 	for(size_t i = 0; i < m_vDD.size(); ++i){
 		m_vDD[i]->reinit();
 	}
+	dof_distributions_reinitialized();
 
 //	increase revision counter
 	++m_RevCnt;
@@ -881,7 +883,9 @@ template <typename TDomain>
 ApproximationSpace<TDomain>::
 ApproximationSpace(SmartPtr<domain_type> domain)
 	: IApproximationSpace(domain->subset_handler(), domain->grid()),
-	  m_spDomain(domain)
+	  m_spDomain(domain),
+	  m_bSFCOrder(false),
+	  m_sfcOrder(SFC_HILBERT)
 {
 	if(!m_spDomain.valid())
 		UG_THROW("Domain, passed to ApproximationSpace, is invalid.");
@@ -893,7 +897,9 @@ template <typename TDomain>
 ApproximationSpace<TDomain>::
 ApproximationSpace(SmartPtr<domain_type> domain, const AlgebraType& algebraType)
 	: IApproximationSpace(domain->subset_handler(), domain->grid(), algebraType),
-	  m_spDomain(domain)
+	  m_spDomain(domain),
+	  m_bSFCOrder(false),
+	  m_sfcOrder(SFC_HILBERT)
 {
 	if(!m_spDomain.valid())
 		UG_THROW("Domain, passed to ApproximationSpace, is invalid.");
@@ -901,6 +907,32 @@ ApproximationSpace(SmartPtr<domain_type> domain, const AlgebraType& algebraType)
 		UG_THROW("SubsetHandler, passed to ApproximationSpace, is invalid.");
 };
 
+template <typename TDomain>
+void ApproximationSpace<TDomain>::
+set_sfc_order(const char* type)
+{
+	const std::string name = ToLower(TrimString(type));
+	if(name.empty() || name == "none"){
+		m_bSFCOrder = false;
+		return;
+	}
+
+	m_sfcOrder = StringToSFCType(name);
+	m_bSFCOrder = true;
+	dof_distributions_reinitialized();
+}
+
+template <typename TDomain>
+void ApproximationSpace<TDomain>::
+dof_distributions_reinitialized()
+{
+	if(!m_bSFCOrder)
+		return;
+
+	for(size_t i = 0; i < m_vDD.size(); ++i)
+		OrderSFCForDofDist<TDomain>(m_vDD[i], m_spDomain, m_sfcOrder);
+}
+
 } // end namespace ug
 
 #ifdef UG_DIM_1
@@ -34,6 +34,7 @@
 #define __H__UG__LIB_DISC__FUNCTION_SPACE__APPROXIMATION_SPACE__
 
 #include "lib_disc/common/revision_counter.h"
+#include "lib_grid/algorithms/space_filling_curve_util.h"
 #include "lib_disc/dof_manager/dof_distribution_info.h"
 #include "lib_disc/dof_manager/dof_distribution.h"
 #include "lib_grid/tools/surface_view.h"
@@ -84,7 +85,7 @@ class IApproximationSpace : public DoFDistributionInfoProvider
 
 	public:
 	///	Destructor
-		~IApproximationSpace();
+		virtual ~IApproximationSpace();
 
 	///	clears functions
 		void clear() {m_spDoFDistributionInfo->clear();}
@@ -224,6 +225,10 @@ class IApproximationSpace : public DoFDistributionInfoProvider
 	///	reinits all data after grid adaption
 		void reinit();
 
+	///	called by reinit after the dof distributions have been reinitialized
+	/**	Derived classes may e.g. reorder the dofs here.*/
+		virtual void dof_distributions_reinitialized()	{}
+
 	///	message hub id
 		MessageHub::SPCallbackId m_spGridAdaptionCallbackID;
 		MessageHub::SPCallbackId m_spGridDistributionCallbackID;
@@ -302,9 +307,25 @@ class ApproximationSpace : public IApproximationSpace
 
 		int get_dim() const { return dim; }
 
+	///	orders the dofs along a space filling curve after each grid change
+	/**	type has to be "hilbert" or "morton". The order is applied to all
+	 * existing dof distributions immediately and again each time they are
+	 * reinitialized after grid adaption or redistribution. Pass "none" to
+	 * disable the automatic reordering. See OrderSFC.*/
+		void set_sfc_order(const char* type);
+
+	protected:
+		virtual void dof_distributions_reinitialized();
+
 	protected:
 	///	Domain, where solution lives
 		SmartPtr<TDomain> m_spDomain;
+
+	///	curve along which the dofs are ordered after grid changes
+	///	\{
+		bool m_bSFCOrder;
+		SFCType m_sfcOrder;
+	///	\}
 };
 
 
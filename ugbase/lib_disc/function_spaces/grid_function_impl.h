@@ -237,6 +237,11 @@ resize_values(size_t s, number defaultValue)
 //	resize vector
 	vector_type::resize_sloppy(s);
 
+//	release memory if the number of dofs dropped considerably, e.g. after
+//	coarsening
+	if(vector_type::capacity() > 2 * s)
+		vector_type::reserve_exactly(s, true);
+
 //	set vector to zero-values
 	for(size_t i = oldSize; i < s; ++i)
 		this->operator[](i) = defaultValue;
@@ -1013,6 +1013,13 @@ public:
 	///	sets if data shall be made consistent before printing
 	void set_print_consistent(bool b) {m_printConsistent = b;}
 
+	///	sets the queue depth of asynchronous vtk output (0 = synchronous)
+	/**	see VTKOutput::set_async*/
+	void set_vtk_async(int queueDepth) {m_vtkOut.set_async(queueDepth);}
+
+	///	waits until all asynchronous vtk output is written. Collective.
+	void wait_vtk_output() {m_vtkOut.wait();}
+
 	///	write vector
 	virtual void write_vector(const vector_type& vec, const char* filename) {
 		//	write to conn viewer
@@ -1142,8 +1149,7 @@ protected:
 				m_spApproxSpace->dof_distribution(m_glFrom));
 		vtkFunc.resize_values(vec.size());
 		vtkFunc.assign(vec);
-		VTKOutput<dim> out;
-		out.print(name.c_str(), vtkFunc, m_printConsistent);
+		m_vtkOut.print(name.c_str(), vtkFunc, m_printConsistent);
 	}
 
 protected:
@@ -1160,6 +1166,9 @@ protected:
 	//	flag if data shall be made consistent before printing
 	bool m_printConsistent;
 
+	//	vtk output (kept, since it may own pending asynchronous writes)
+	VTKOutput<dim> m_vtkOut;
+
 	//	current grid level
 	GridLevel m_glFrom, m_glTo;
 };
@@ -0,0 +1,744 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include "checkpoint.h"
+#include "common/log.h"
+#include "common/util/string_util.h"
+#include "lib_grid/algorithms/serialization.h"
+
+#ifdef UG_PARALLEL
+	#include "pcl/pcl_base.h"
+	#include "pcl/pcl_util.h"
+	#include "lib_grid/parallelization/distributed_grid.h"
+#endif
+
+#ifdef UG_ZLIB
+	#include <zlib.h>
+#endif
+
+#ifdef UG_ZSTD
+	#include <zstd.h>
+#endif
+
+using namespace std;
+
+namespace ug{
+
+namespace{
+
+const char CHECKPOINT_MAGIC[4] = {'U', 'G', 'C', 'P'};
+const uint32_t CHECKPOINT_VERSION = 1;
+
+///	header of each checkpoint file
+struct CheckpointHeader{
+	char		magic[4];
+	uint32_t	version;
+	int32_t		numProcs;
+	int32_t		rank;
+	int32_t		compression;
+	int32_t		reserved;
+	uint64_t	rawSize;
+	uint64_t	storedSize;
+};
+
+string CheckpointFilename(const char* filename, int rank)
+{
+	return mkstr(filename << "_p" << rank << ".ugcp");
+}
+
+int LocalRank()
+{
+	#ifdef UG_PARALLEL
+		return pcl::ProcRank();
+	#else
+		return 0;
+	#endif
+}
+
+int NumLocalProcs()
+{
+	#ifdef UG_PARALLEL
+		return pcl::NumProcs();
+	#else
+		return 1;
+	#endif
+}
+
+#ifdef UG_PARALLEL
+///	writes the interfaces of all layouts of the given element type
+/**	Elements are referenced through their index in the serialized grid.*/
+template <class TElem>
+void SerializeLayouts(BinaryBuffer& buf, GridLayoutMap& glm,
+					  MultiElementAttachmentAccessor<AInt>& aaIndex)
+{
+	typedef typename GridLayoutMap::Types<TElem>::Map		map_t;
+	typedef typename GridLayoutMap::Types<TElem>::Layout	layout_t;
+	typedef typename layout_t::Interface					interface_t;
+
+	int numLayouts = 0;
+	for(typename map_t::iterator iter = glm.layouts_begin<TElem>();
+		iter != glm.layouts_end<TElem>(); ++iter)
+	{
+		++numLayouts;
+	}
+	Serialize(buf, numLayouts);
+
+	for(typename map_t::iterator iter = glm.layouts_begin<TElem>();
+		iter != glm.layouts_end<TElem>(); ++iter)
+	{
+		layout_t& layout = iter->second;
+		Serialize(buf, (int)iter->first);
+		Serialize(buf, (int)layout.num_levels());
+		for(size_t lvl = 0; lvl < layout.num_levels(); ++lvl){
+			int numIntfcs = 0;
+			for(typename layout_t::iterator iiter = layout.begin(lvl);
+				iiter != layout.end(lvl); ++iiter)
+			{
+				++numIntfcs;
+			}
+			Serialize(buf, numIntfcs);
+
+			for(typename layout_t::iterator iiter = layout.begin(lvl);
+				iiter != layout.end(lvl); ++iiter)
+			{
+				interface_t& intfc = layout.interface(iiter);
+				Serialize(buf, (int)layout.proc_id(iiter));
+				Serialize(buf, (int)intfc.size());
+				for(typename interface_t::iterator eiter = intfc.begin();
+					eiter != intfc.end(); ++eiter)
+				{
+					Serialize(buf, (int)aaIndex[intfc.get_element(eiter)]);
+				}
+			}
+		}
+	}
+}
+
+///	restores the layouts written by SerializeLayouts
+template <class TElem>
+void DeserializeLayouts(BinaryBuffer& buf, GridLayoutMap& glm,
+						const vector<TElem*>& elems)
+{
+	typedef typename GridLayoutMap::Types<TElem>::Layout	layout_t;
+	typedef typename layout_t::Interface					interface_t;
+
+	const int numLayouts = Deserialize<int>(buf);
+	for(int i_layout = 0; i_layout < numLayouts; ++i_layout){
+		const int key = Deserialize<int>(buf);
+		const int numLvls = Deserialize<int>(buf);
+		layout_t& layout = glm.get_layout<TElem>(key);
+		for(int lvl = 0; lvl < numLvls; ++lvl){
+			const int numIntfcs = Deserialize<int>(buf);
+			for(int i_intfc = 0; i_intfc < numIntfcs; ++i_intfc){
+				const int proc = Deserialize<int>(buf);
+				const int numElems = Deserialize<int>(buf);
+				interface_t& intfc = layout.interface(proc, lvl);
+				for(int i = 0; i < numElems; ++i){
+					const int ind = Deserialize<int>(buf);
+					UG_COND_THROW(ind < 0 || (size_t)ind >= elems.size(),
+								  "Invalid interface element in checkpoint.");
+					intfc.push_back(elems[ind]);
+				}
+			}
+		}
+	}
+}
+#endif
+
+}//	end of unnamed namespace
+
+
+////////////////////////////////////////////////////////////////////////
+//	CheckpointFileWriter
+CheckpointFileWriter::CheckpointFileWriter() :
+	m_fillBuf(0),
+	m_jobPending(false),
+	m_snapshotStarted(false),
+	m_compression(CPC_NONE),
+	m_compressionLevel(-1)
+{
+	#ifdef UG_POSIX
+		m_threadRunning = false;
+	#endif
+}
+
+CheckpointFileWriter::~CheckpointFileWriter()
+{
+//	no collective operations may be performed here.
+	if(m_jobPending){
+		#ifdef UG_POSIX
+			if(m_threadRunning)
+				pthread_join(m_thread, NULL);
+		#endif
+		if(!m_job.success){
+			UG_LOG("WARNING in ~CheckpointFileWriter: " << m_job.errorMsg << "\n");
+		}
+	}
+}
+
+void CheckpointFileWriter::set_compression(const char* method)
+{
+	string m = TrimString(ToLower(method));
+	if(m == "none")
+		m_compression = CPC_NONE;
+	else if(m == "zlib"){
+		#ifdef UG_ZLIB
+			m_compression = CPC_ZLIB;
+		#else
+			UG_THROW("CheckpointFileWriter::set_compression: zlib is not "
+					 "available. Please rebuild ug with -DUSE_ZLIB=ON.");
+		#endif
+	}
+	else if(m == "zstd"){
+		#ifdef UG_ZSTD
+			m_compression = CPC_ZSTD;
+		#else
+			UG_THROW("CheckpointFileWriter::set_compression: zstd is not "
+					 "available. Please rebuild ug with -DUSE_ZSTD=ON.");
+		#endif
+	}
+	else{
+		UG_THROW("CheckpointFileWriter::set_compression: Unknown method '"
+				 << method << "'. Valid methods are 'none', 'zlib' and 'zstd'.");
+	}
+}
+
+void CheckpointFileWriter::start_snapshot(const char* filename)
+{
+	UG_COND_THROW(m_snapshotStarted, "CheckpointFileWriter: The previous "
+				  "checkpoint has not been finished.");
+	m_snapshotFilename = filename;
+	snapshot_buffer().clear();
+	m_snapshotStarted = true;
+}
+
+void CheckpointFileWriter::finish_snapshot()
+{
+	UG_COND_THROW(!m_snapshotStarted, "CheckpointFileWriter: No checkpoint "
+				  "has been started.");
+
+//	the buffer which is not in use as snapshot buffer is owned by the
+//	pending job. We thus have to wait until it is done.
+	wait();
+
+	m_job.buf = &m_buffers[m_fillBuf];
+	m_job.filename = CheckpointFilename(m_snapshotFilename.c_str(), LocalRank());
+	m_job.compression = m_compression;
+	m_job.compressionLevel = m_compressionLevel;
+	m_job.numProcs = NumLocalProcs();
+	m_job.rank = LocalRank();
+	m_job.success = false;
+	m_job.errorMsg.clear();
+
+	m_fillBuf = 1 - m_fillBuf;
+	m_snapshotStarted = false;
+	m_jobPending = true;
+
+	#ifdef UG_POSIX
+		m_threadRunning = (pthread_create(&m_thread, NULL, &write_thread, &m_job) == 0);
+		if(!m_threadRunning)
+			execute_job(m_job);
+	#else
+		execute_job(m_job);
+	#endif
+}
+
+void CheckpointFileWriter::wait()
+{
+	bool success = true;
+	if(m_jobPending){
+		#ifdef UG_POSIX
+			if(m_threadRunning){
+				pthread_join(m_thread, NULL);
+				m_threadRunning = false;
+			}
+		#endif
+		m_jobPending = false;
+		success = m_job.success;
+	}
+
+	#ifdef UG_PARALLEL
+		if(!pcl::AllProcsTrue(success)){
+			if(success){
+				UG_THROW("CheckpointFileWriter: Writing checkpoint failed on "
+						 "another process.");
+			}
+			UG_THROW("CheckpointFileWriter: " << m_job.errorMsg);
+		}
+	#else
+		UG_COND_THROW(!success, "CheckpointFileWriter: " << m_job.errorMsg);
+	#endif
+}
+
+#ifdef UG_POSIX
+void* CheckpointFileWriter::write_thread(void* job)
+{
+	execute_job(*static_cast<WriteJob*>(job));
+	return NULL;
+}
+#endif
+
+void CheckpointFileWriter::execute_job(WriteJob& job)
+{
+//	this method runs on the writer thread. It thus must neither throw nor
+//	log, nor access any data other than job.
+	const char* data = job.buf->buffer();
+	const size_t rawSize = job.buf->write_pos();
+	size_t storedSize = rawSize;
+	int compression = (rawSize > 0) ? job.compression : (int)CPC_NONE;
+
+	vector<char> compressed;
+	#ifdef UG_ZLIB
+		if(compression == CPC_ZLIB){
+			uLongf destLen = compressBound((uLong)rawSize);
+			compressed.resize(destLen);
+			const int level = (job.compressionLevel < 0) ? Z_DEFAULT_COMPRESSION
+													   : job.compressionLevel;
+			if(compress2((Bytef*)&compressed.front(), &destLen,
+						 (const Bytef*)data, (uLong)rawSize, level) != Z_OK)
+			{
+				job.errorMsg = mkstr("zlib compression failed for " << job.filename);
+				return;
+			}
+			data = &compressed.front();
+			storedSize = destLen;
+		}
+	#endif
+	#ifdef UG_ZSTD
+		if(compression == CPC_ZSTD){
+			compressed.resize(ZSTD_compressBound(rawSize));
+			const int level = (job.compressionLevel < 0) ? 0 : job.compressionLevel;
+			const size_t res = ZSTD_compress(&compressed.front(), compressed.size(),
+											 data, rawSize, level);
+			if(ZSTD_isError(res)){
+				job.errorMsg = mkstr("zstd compression failed for " << job.filename
+									 << ": " << ZSTD_getErrorName(res));
+				return;
+			}
+			data = &compressed.front();
+			storedSize = res;
+		}
+	#endif
+
+	CheckpointHeader header;
+	memcpy(header.magic, CHECKPOINT_MAGIC, 4);
+	header.version = CHECKPOINT_VERSION;
+	header.numProcs = job.numProcs;
+	header.rank = job.rank;
+	header.compression = compression;
+	header.reserved = 0;
+	header.rawSize = rawSize;
+	header.storedSize = storedSize;
+
+	const string tmpName = job.filename + ".tmp";
+	FILE* file = fopen(tmpName.c_str(), "wb");
+	if(!file){
+		job.errorMsg = mkstr("Couldn't open file " << tmpName << " for writing.");
+		return;
+	}
+
+	bool ok = (fwrite(&header, sizeof(CheckpointHeader), 1, file) == 1);
+	if(ok && storedSize > 0)
+		ok = (fwrite(data, 1, storedSize, file) == storedSize);
+	ok &= (fclose(file) == 0);
+
+	if(!ok){
+		remove(tmpName.c_str());
+		job.errorMsg = mkstr("Couldn't write file " << tmpName);
+		return;
+	}
+
+	if(rename(tmpName.c_str(), job.filename.c_str()) != 0){
+		job.errorMsg = mkstr("Couldn't rename " << tmpName << " to " << job.filename);
+		return;
+	}
+
+	job.success = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//	CheckpointFileReader
+void CheckpointFileReader::read_file(const char* filename)
+{
+	const string name = CheckpointFilename(filename, LocalRank());
+	FILE* file = fopen(name.c_str(), "rb");
+	UG_COND_THROW(!file, "CheckpointFileReader: Couldn't open file " << name);
+
+	CheckpointHeader header;
+	bool ok = (fread(&header, sizeof(CheckpointHeader), 1, file) == 1)
+			  && (memcmp(header.magic, CHECKPOINT_MAGIC, 4) == 0);
+	if(!ok){
+		fclose(file);
+		UG_THROW("CheckpointFileReader: " << name << " is not a checkpoint file.");
+	}
+
+	if(header.version != CHECKPOINT_VERSION || header.numProcs != NumLocalProcs()
+	   || header.rank != LocalRank())
+	{
+		fclose(file);
+		UG_THROW("CheckpointFileReader: " << name << " was written by process "
+				 << header.rank << " of " << header.numProcs << " (version "
+				 << header.version << "). Checkpoints can only be restarted "
+				 "on the same number of processes (currently "
+				 << NumLocalProcs() << ").");
+	}
+
+//	validate the sizes before any memory is allocated
+	const long dataStart = ftell(file);
+	ok = (dataStart >= 0) && (fseek(file, 0, SEEK_END) == 0);
+	const long fileSize = ok ? ftell(file) : -1;
+	ok = ok && (fileSize >= dataStart) && (fseek(file, dataStart, SEEK_SET) == 0);
+	if(!ok){
+		fclose(file);
+		UG_THROW("CheckpointFileReader: Couldn't determine the size of " << name);
+	}
+
+	if(header.storedSize > (uint64_t)(fileSize - dataStart)){
+		fclose(file);
+		UG_THROW("CheckpointFileReader: " << name << " is truncated. The header "
+				 "announces " << header.storedSize << " bytes of data, but only "
+				 << fileSize - dataStart << " bytes are present.");
+	}
+
+	if((header.compression == CPC_NONE) && (header.storedSize != header.rawSize)){
+		fclose(file);
+		UG_THROW("CheckpointFileReader: Invalid header in " << name << ". The "
+				 "stored size (" << header.storedSize << ") of uncompressed data "
+				 "differs from its raw size (" << header.rawSize << ").");
+	}
+
+	vector<char> stored;
+	m_buffer.clear();
+	m_buffer.reserve(header.rawSize);
+	char* dest = m_buffer.buffer();
+	if(header.compression != CPC_NONE){
+		stored.resize(header.storedSize);
+		dest = stored.empty() ? NULL : &stored.front();
+	}
+
+	if(header.storedSize > 0)
+		ok = (fread(dest, 1, header.storedSize, file) == header.storedSize);
+	fclose(file);
+	UG_COND_THROW(!ok, "CheckpointFileReader: " << name << " is truncated.");
+
+	switch(header.compression){
+		case CPC_NONE:
+			break;
+
+		case CPC_ZLIB:{
+			#ifdef UG_ZLIB
+				uLongf destLen = (uLongf)header.rawSize;
+				ok = (uncompress((Bytef*)m_buffer.buffer(), &destLen,
+								 (const Bytef*)dest, (uLong)header.storedSize) == Z_OK)
+					 && (destLen == header.rawSize);
+			#else
+				UG_THROW("CheckpointFileReader: " << name << " is zlib compressed, "
+						 "but ug was built without zlib support (USE_ZLIB).");
+			#endif
+		}break;
+
+		case CPC_ZSTD:{
+			#ifdef UG_ZSTD
+				const size_t res = ZSTD_decompress(m_buffer.buffer(), header.rawSize,
+												   dest, header.storedSize);
+				ok = !ZSTD_isError(res) && (res == header.rawSize);
+			#else
+				UG_THROW("CheckpointFileReader: " << name << " is zstd compressed, "
+						 "but ug was built without zstd support (USE_ZSTD).");
+			#endif
+		}break;
+
+		default:
+			UG_THROW("CheckpointFileReader: Unknown compression in " << name);
+	}
+
+	UG_COND_THROW(!ok, "CheckpointFileReader: Decompression of " << name << " failed.");
+	m_buffer.set_write_pos(header.rawSize);
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//	CheckpointWriter
+template <typename TDomain>
+CheckpointWriter<TDomain>::
+CheckpointWriter(SmartPtr<TDomain> spDom) :
+	m_spDom(spDom),
+	m_aIndex("checkpoint-index")
+{
+	UG_COND_THROW(spDom.invalid(), "CheckpointWriter: A valid domain is required.");
+}
+
+template <typename TDomain>
+CheckpointWriter<TDomain>::
+~CheckpointWriter()
+{
+	MultiGrid& mg = *m_spDom->grid();
+	if(mg.has_vertex_attachment(m_aIndex))
+		mg.detach_from_all(m_aIndex);
+}
+
+template <typename TDomain>
+void CheckpointWriter<TDomain>::
+begin_checkpoint(const char* filename)
+{
+	PROFILE_FUNC_GROUP("disc");
+	start_snapshot(filename);
+
+	TDomain& dom = *m_spDom;
+	MultiGrid& mg = *dom.grid();
+	BinaryBuffer& buf = snapshot_buffer();
+
+//	the indices assigned during serialization are used to reference
+//	elements in layouts and grid functions.
+	if(!mg.has_vertex_attachment(m_aIndex))
+		mg.attach_to_all(m_aIndex);
+	m_aaIndex.access(mg, m_aIndex);
+
+	GridObjectCollection goc = mg.get_grid_objects();
+	SerializeMultiGridElements(mg, goc, m_aaIndex, buf);
+
+	vector<Vertex*> vrts;
+	vector<Edge*> edges;
+	vector<Face*> faces;
+	vector<Volume*> vols;
+	CollectSerializedElements(vrts, goc);
+	CollectSerializedElements(edges, goc);
+	CollectSerializedElements(faces, goc);
+	CollectSerializedElements(vols, goc);
+
+//	positions and subset handlers
+	const vector<string> shNames = dom.additional_subset_handler_names();
+	Serialize(buf, (int)shNames.size());
+	for(size_t i = 0; i < shNames.size(); ++i)
+		Serialize(buf, shNames[i]);
+
+	GridDataSerializationHandler handler;
+	handler.add(GeomObjAttachmentSerializer<Vertex, typename TDomain::position_attachment_type>
+					::create(mg, dom.position_attachment()));
+	handler.add(SubsetHandlerSerializer::create(*dom.subset_handler()));
+	for(size_t i = 0; i < shNames.size(); ++i)
+		handler.add(SubsetHandlerSerializer::create(*dom.additional_subset_handler(shNames[i])));
+
+	handler.write_infos(buf);
+	handler.serialize_blocks(buf, vrts, edges, faces, vols);
+
+//	layouts
+	#ifdef UG_PARALLEL
+		const int hasLayouts = (pcl::NumProcs() > 1) && mg.distributed_grid_manager();
+		Serialize(buf, hasLayouts);
+		if(hasLayouts){
+			GridLayoutMap& glm = mg.distributed_grid_manager()->grid_layout_map();
+			SerializeLayouts<Vertex>(buf, glm, m_aaIndex);
+			SerializeLayouts<Edge>(buf, glm, m_aaIndex);
+			SerializeLayouts<Face>(buf, glm, m_aaIndex);
+			SerializeLayouts<Volume>(buf, glm, m_aaIndex);
+		}
+	#else
+		Serialize(buf, (int)0);
+	#endif
+}
+
+template <typename TDomain>
+void CheckpointWriter<TDomain>::
+add_number(const char* name, number val)
+{
+	UG_COND_THROW(!snapshot_started(), "CheckpointWriter::add_number: "
+				  "begin_checkpoint has to be called first.");
+	BinaryBuffer& buf = snapshot_buffer();
+	Serialize(buf, (int)CPS_NUMBER);
+	Serialize(buf, string(name));
+	Serialize(buf, val);
+}
+
+template <typename TDomain>
+void CheckpointWriter<TDomain>::
+end_checkpoint()
+{
+	PROFILE_FUNC_GROUP("disc");
+	finish_snapshot();
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//	CheckpointReader
+template <typename TDomain>
+CheckpointReader<TDomain>::
+CheckpointReader(SmartPtr<TDomain> spDom) :
+	m_spDom(spDom)
+{
+	UG_COND_THROW(spDom.invalid(), "CheckpointReader: A valid domain is required.");
+}
+
+template <typename TDomain>
+void CheckpointReader<TDomain>::
+read_domain(const char* filename)
+{
+	PROFILE_FUNC_GROUP("disc");
+	TDomain& dom = *m_spDom;
+	MultiGrid& mg = *dom.grid();
+	UG_COND_THROW(mg.num_vertices() > 0, "CheckpointReader::read_domain: "
+				  "The given domain has to be empty.");
+
+	read_file(filename);
+	BinaryBuffer& buf = checkpoint_buffer();
+
+	mg.message_hub()->post_message(GridMessage_Creation(GMCT_CREATION_STARTS, -1));
+
+	#ifdef UG_PARALLEL
+		DistributedGridManager* distGridMgr = mg.distributed_grid_manager();
+		if(distGridMgr)
+			distGridMgr->enable_interface_management(false);
+	#endif
+
+	DeserializeMultiGridElements(mg, buf, &m_vVrts, &m_vEdges, &m_vFaces, &m_vVols);
+
+//	positions and subset handlers
+	const vector<string> domSHNames = dom.additional_subset_handler_names();
+	const int numSHs = Deserialize<int>(buf);
+	vector<string> shNames(numSHs);
+	for(int i = 0; i < numSHs; ++i){
+		Deserialize(buf, shNames[i]);
+		UG_COND_THROW(find(domSHNames.begin(), domSHNames.end(), shNames[i])
+						== domSHNames.end(),
+					  "CheckpointReader::read_domain: The checkpoint contains the "
+					  "additional subset handler '" << shNames[i] << "', which "
+					  "has to be created in the domain before reading.");
+	}
+
+	GridDataSerializationHandler handler;
+	handler.add(GeomObjAttachmentSerializer<Vertex, typename TDomain::position_attachment_type>
+					::create(mg, dom.position_attachment()));
+	handler.add(SubsetHandlerSerializer::create(*dom.subset_handler()));
+	for(size_t i = 0; i < shNames.size(); ++i)
+		handler.add(SubsetHandlerSerializer::create(*dom.additional_subset_handler(shNames[i])));
+
+	handler.read_infos(buf);
+	handler.deserialize_blocks(buf, m_vVrts, m_vEdges, m_vFaces, m_vVols);
+
+//	layouts
+	const int hasLayouts = Deserialize<int>(buf);
+	#ifdef UG_PARALLEL
+		if(distGridMgr){
+			GridLayoutMap& glm = distGridMgr->grid_layout_map();
+			glm.clear();
+			if(hasLayouts){
+				DeserializeLayouts<Vertex>(buf, glm, m_vVrts);
+				DeserializeLayouts<Edge>(buf, glm, m_vEdges);
+				DeserializeLayouts<Face>(buf, glm, m_vFaces);
+				DeserializeLayouts<Volume>(buf, glm, m_vVols);
+			}
+			glm.remove_empty_interfaces();
+			distGridMgr->enable_interface_management(true);
+			distGridMgr->grid_layouts_changed(false);
+		}
+		else{
+			UG_COND_THROW(hasLayouts, "CheckpointReader::read_domain: "
+						  "A distributed grid manager is required in the given domain.");
+		}
+	#else
+		UG_COND_THROW(hasLayouts, "CheckpointReader::read_domain: "
+					  "The checkpoint contains grid layouts.");
+	#endif
+
+	mg.message_hub()->post_message(GridMessage_Creation(GMCT_CREATION_STOPS, -1));
+
+//	collect the positions of the remaining sections
+	m_gridFunctionPos.clear();
+	m_numbers.clear();
+	while(!buf.eof()){
+		const int type = Deserialize<int>(buf);
+		const string name = Deserialize<string>(buf);
+		switch(type){
+			case CPS_GRID_FUNCTION:{
+				uint64_t size = 0;
+				buf.read((char*)&size, sizeof(uint64_t));
+				m_gridFunctionPos[name] = buf.read_pos();
+				buf.set_read_pos(buf.read_pos() + size);
+			}break;
+
+			case CPS_NUMBER:
+				m_numbers[name] = Deserialize<number>(buf);
+				break;
+
+			default:
+				UG_THROW("CheckpointReader::read_domain: Unknown section in "
+						 "checkpoint " << filename);
+		}
+	}
+}
+
+template <typename TDomain>
+bool CheckpointReader<TDomain>::
+has_grid_function(const char* name) const
+{
+	return m_gridFunctionPos.find(name) != m_gridFunctionPos.end();
+}
+
+template <typename TDomain>
+bool CheckpointReader<TDomain>::
+has_number(const char* name) const
+{
+	return m_numbers.find(name) != m_numbers.end();
+}
+
+template <typename TDomain>
+number CheckpointReader<TDomain>::
+read_number(const char* name)
+{
+	map<string, number>::const_iterator iter = m_numbers.find(name);
+	UG_COND_THROW(iter == m_numbers.end(), "CheckpointReader::read_number: "
+				  "No number '" << name << "' in checkpoint.");
+	return iter->second;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//	explicit template instantiations
+#ifdef UG_DIM_1
+template class CheckpointWriter<Domain1d>;
+template class CheckpointReader<Domain1d>;
+#endif
+#ifdef UG_DIM_2
+template class CheckpointWriter<Domain2d>;
+template class CheckpointReader<Domain2d>;
+#endif
+#ifdef UG_DIM_3
+template class CheckpointWriter<Domain3d>;
+template class CheckpointReader<Domain3d>;
+#endif
+
+}//	end of namespace
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__LIB_DISC__IO__CHECKPOINT__
+#define __H__UG__LIB_DISC__IO__CHECKPOINT__
+
+#include <string>
+#include <vector>
+#include <map>
+
+#ifdef UG_POSIX
+	#include <pthread.h>
+#endif
+
+#include "common/util/binary_buffer.h"
+#include "common/util/smart_pointer.h"
+#include "lib_grid/lib_grid.h"
+#include "lib_disc/domain.h"
+
+namespace ug{
+
+///	compression methods for checkpoint files
+enum CheckpointCompression{
+	CPC_NONE = 0,
+	CPC_ZLIB = 1,
+	CPC_ZSTD = 2
+};
+
+////////////////////////////////////////////////////////////////////////
+///	Writes snapshot buffers to checkpoint files on a background thread.
+/**	Each process writes its own file '<filename>_p<rank>.ugcp'. A file starts
+ * with a small header (magic number, number of processes, rank, compression
+ * method and sizes), followed by the (optionally compressed) snapshot.
+ *
+ * Two buffers are used alternately: while the snapshot in one buffer is
+ * compressed and written by the background thread, the next snapshot can
+ * already be taken into the other one. Only one write is pending at a time.
+ * The background thread never calls into MPI, so no special MPI threading
+ * support is required.
+ *
+ * Files are first written to '<file>.tmp' and renamed afterwards, so that an
+ * interrupted write never destroys an older checkpoint of the same name.
+ *
+ * If UG_POSIX is not defined, files are written synchronously.*/
+class CheckpointFileWriter
+{
+	public:
+		CheckpointFileWriter();
+		virtual ~CheckpointFileWriter();
+
+	///	sets the compression method: "none", "zlib" or "zstd"
+	/**	"zlib" and "zstd" are only available if ug was built with USE_ZLIB
+	 * or USE_ZSTD respectively.*/
+		void set_compression(const char* method);
+
+	///	sets the compression level. A negative value selects the library default.
+		void set_compression_level(int level)	{m_compressionLevel = level;}
+
+	///	blocks until the pending write has finished.
+	/**	This method is collective. It throws on all processes, if the pending
+	 * write failed on any process.*/
+		void wait();
+
+	protected:
+	///	the buffer into which the current snapshot is written
+		BinaryBuffer& snapshot_buffer()			{return m_buffers[m_fillBuf];}
+
+	///	starts a new snapshot for the given file base name
+		void start_snapshot(const char* filename);
+
+	///	waits for the pending write and passes the current snapshot to the writer thread
+		void finish_snapshot();
+
+		bool snapshot_started() const			{return m_snapshotStarted;}
+
+	private:
+		struct WriteJob{
+			BinaryBuffer*	buf;
+			std::string		filename;
+			int				compression;
+			int				compressionLevel;
+			int				numProcs;
+			int				rank;
+			bool			success;
+			std::string		errorMsg;
+		};
+
+		static void execute_job(WriteJob& job);
+
+	#ifdef UG_POSIX
+		static void* write_thread(void* job);
+		pthread_t	m_thread;
+		bool		m_threadRunning;
+	#endif
+
+		BinaryBuffer	m_buffers[2];
+		int				m_fillBuf;
+		WriteJob		m_job;
+		bool			m_jobPending;
+		bool			m_snapshotStarted;
+		std::string		m_snapshotFilename;
+		int				m_compression;
+		int				m_compressionLevel;
+};
+
+////////////////////////////////////////////////////////////////////////
+///	Reads the local checkpoint file of a process and decompresses it.
+class CheckpointFileReader
+{
+	public:
+		virtual ~CheckpointFileReader()	{}
+
+	protected:
+	///	reads '<filename>_p<rank>.ugcp' into checkpoint_buffer().
+	/**	Throws if the file was written by a different number of processes.*/
+		void read_file(const char* filename);
+
+		BinaryBuffer& checkpoint_buffer()		{return m_buffer;}
+
+	private:
+		BinaryBuffer	m_buffer;
+};
+
+////////////////////////////////////////////////////////////////////////
+///	Writes asynchronous checkpoints of a domain and grid functions on it.
+/**	A checkpoint contains the complete local multigrid hierarchy of each
+ * process, the positions of its vertices, the main and all additional subset
+ * handlers of the domain and the grid layouts (horizontal and vertical
+ * interfaces). In addition an arbitrary number of grid functions and numbers
+ * (e.g. the current time or step) can be stored under a name.
+ *
+ * A checkpoint is taken through
+ * \code
+ * writer:begin_checkpoint("chk/step10")
+ * writer:add("u", u)
+ * writer:add_number("time", t)
+ * writer:end_checkpoint()
+ * \endcode
+ * All data is copied into a snapshot buffer on the calling thread. Compression
+ * and file output are then performed by a background thread, so that the
+ * simulation can continue directly after end_checkpoint(). A subsequent call
+ * to end_checkpoint() or wait() blocks until the preceding write has finished.
+ * Call wait() after the last checkpoint to make sure that it was written.
+ *
+ * Checkpoints can only be restarted on the same number of processes, see
+ * CheckpointReader. The refinement projector of the domain is not stored.*/
+template <typename TDomain>
+class CheckpointWriter : public CheckpointFileWriter
+{
+	public:
+		CheckpointWriter(SmartPtr<TDomain> spDom);
+		virtual ~CheckpointWriter();
+
+	///	takes a snapshot of the domain. Has to be called on all processes.
+		void begin_checkpoint(const char* filename);
+
+	///	adds a snapshot of the values of a grid function to the current checkpoint
+		template <typename TGridFunction>
+		void add(const char* name, TGridFunction& u);
+
+	///	adds a number to the current checkpoint
+		void add_number(const char* name, number val);
+
+	///	hands the current checkpoint to the background writer. Collective.
+		void end_checkpoint();
+
+	protected:
+	///	writes the dof values of all elements of type TElem
+		template <class TElem, typename TGridFunction>
+		void write_values(BinaryBuffer& buf, TGridFunction& u);
+
+		SmartPtr<TDomain>	m_spDom;
+		AInt				m_aIndex;
+		MultiElementAttachmentAccessor<AInt>	m_aaIndex;
+};
+
+////////////////////////////////////////////////////////////////////////
+///	Restores a domain and grid functions from a checkpoint.
+/**	The domain passed to the constructor has to be empty. read_domain restores
+ * the grid hierarchy, subset handlers and grid layouts exactly as they were
+ * when the checkpoint was taken, so no redistribution takes place. The
+ * number of processes thus has to match the number of processes which wrote
+ * the checkpoint.
+ *
+ * Grid functions have to be created on an approximation space on the restored
+ * domain, before they can be read through 'read'. The approximation space
+ * has to contain the same functions as the one used for writing.*/
+template <typename TDomain>
+class CheckpointReader : public CheckpointFileReader
+{
+	public:
+		CheckpointReader(SmartPtr<TDomain> spDom);
+
+	///	reads the checkpoint and restores the domain. Has to be called on all processes.
+		void read_domain(const char* filename);
+
+	///	returns true if the checkpoint contains a grid function with the given name
+		bool has_grid_function(const char* name) const;
+
+	///	restores the values of a grid function
+		template <typename TGridFunction>
+		void read(const char* name, TGridFunction& u);
+
+	///	returns true if the checkpoint contains a number with the given name
+		bool has_number(const char* name) const;
+
+	///	returns the number with the given name
+		number read_number(const char* name);
+
+	protected:
+	///	reads the dof values of all elements of type TElem
+		template <class TElem, typename TGridFunction>
+		void read_values(BinaryBuffer& buf, TGridFunction& u,
+						 const std::vector<TElem*>& elems);
+
+		SmartPtr<TDomain>		m_spDom;
+		std::vector<Vertex*>	m_vVrts;
+		std::vector<Edge*>		m_vEdges;
+		std::vector<Face*>		m_vFaces;
+		std::vector<Volume*>	m_vVols;
+
+	///	maps names of grid functions and numbers to their offset in the buffer
+		std::map<std::string, size_t>	m_gridFunctionPos;
+		std::map<std::string, number>	m_numbers;
+};
+
+}//	end of namespace
+
+#include "checkpoint_impl.h"
+
+#endif
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__LIB_DISC__IO__CHECKPOINT_IMPL__
+#define __H__UG__LIB_DISC__IO__CHECKPOINT_IMPL__
+
+#include <cstring>
+#include "common/error.h"
+#include "common/serialization.h"
+#include "common/profiler/profiler.h"
+#include "lib_disc/common/multi_index.h"
+
+namespace ug{
+
+///	section types of a checkpoint following the grid section
+enum CheckpointSectionType{
+	CPS_GRID_FUNCTION = 1,
+	CPS_NUMBER = 2
+};
+
+////////////////////////////////////////////////////////////////////////
+//	CheckpointWriter
+template <typename TDomain>
+template <class TElem, typename TGridFunction>
+void CheckpointWriter<TDomain>::
+write_values(BinaryBuffer& buf, TGridFunction& u)
+{
+	typedef typename TGridFunction::template traits<TElem>::const_iterator iter_t;
+
+//	the number of records is written after all records are known
+	const size_t numRecordsPos = buf.write_pos();
+	uint64_t numRecords = 0;
+	buf.write((char*)&numRecords, sizeof(uint64_t));
+
+	const size_t numFct = u.num_fct();
+	std::vector<DoFIndex> vInd;
+	std::vector<number> vVals;
+	for(iter_t iter = u.template begin<TElem>(); iter != u.template end<TElem>(); ++iter)
+	{
+		TElem* elem = *iter;
+		vInd.clear();
+		for(size_t fct = 0; fct < numFct; ++fct)
+			u.inner_dof_indices(elem, fct, vInd, false);
+
+		if(vInd.empty())
+			continue;
+
+		vVals.resize(vInd.size());
+		for(size_t i = 0; i < vInd.size(); ++i)
+			vVals[i] = DoFRef(u, vInd[i]);
+
+		const int index = m_aaIndex[elem];
+		const int numVals = (int)vVals.size();
+		buf.write((const char*)&index, sizeof(int));
+		buf.write((const char*)&numVals, sizeof(int));
+		buf.write((const char*)&vVals.front(), sizeof(number) * vVals.size());
+		++numRecords;
+	}
+
+	memcpy(buf.buffer() + numRecordsPos, &numRecords, sizeof(uint64_t));
+}
+
+template <typename TDomain>
+template <typename TGridFunction>
+void CheckpointWriter<TDomain>::
+add(const char* name, TGridFunction& u)
+{
+	PROFILE_FUNC_GROUP("disc");
+	UG_COND_THROW(!snapshot_started(), "CheckpointWriter::add: "
+				  "begin_checkpoint has to be called first.");
+	UG_COND_THROW(u.domain().get() != m_spDom.get(), "CheckpointWriter::add: "
+				  "Grid function '" << name << "' is not defined on the "
+				  "domain of the checkpoint.");
+
+	BinaryBuffer& buf = snapshot_buffer();
+	Serialize(buf, (int)CPS_GRID_FUNCTION);
+	Serialize(buf, std::string(name));
+
+	const size_t sizePos = buf.write_pos();
+	uint64_t size = 0;
+	buf.write((char*)&size, sizeof(uint64_t));
+	const size_t dataPos = buf.write_pos();
+
+	int storageMask = 0;
+	#ifdef UG_PARALLEL
+		storageMask = (int)u.get_storage_mask();
+	#endif
+	Serialize(buf, storageMask);
+
+	write_values<Vertex>(buf, u);
+	write_values<Edge>(buf, u);
+	write_values<Face>(buf, u);
+	write_values<Volume>(buf, u);
+
+	size = buf.write_pos() - dataPos;
+	memcpy(buf.buffer() + sizePos, &size, sizeof(uint64_t));
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//	CheckpointReader
+template <typename TDomain>
+template <class TElem, typename TGridFunction>
+void CheckpointReader<TDomain>::
+read_values(BinaryBuffer& buf, TGridFunction& u, const std::vector<TElem*>& elems)
+{
+	uint64_t numRecords = 0;
+	buf.read((char*)&numRecords, sizeof(uint64_t));
+
+	const size_t numFct = u.num_fct();
+	std::vector<DoFIndex> vInd;
+	std::vector<number> vVals;
+	for(uint64_t i_rec = 0; i_rec < numRecords; ++i_rec){
+		int index, numVals;
+		buf.read((char*)&index, sizeof(int));
+		buf.read((char*)&numVals, sizeof(int));
+		UG_COND_THROW(index < 0 || (size_t)index >= elems.size(),
+					  "CheckpointReader::read: Invalid element index in checkpoint.");
+
+		vVals.resize(numVals);
+		if(numVals > 0)
+			buf.read((char*)&vVals.front(), sizeof(number) * numVals);
+
+		TElem* elem = elems[index];
+		vInd.clear();
+		for(size_t fct = 0; fct < numFct; ++fct)
+			u.inner_dof_indices(elem, fct, vInd, false);
+
+		UG_COND_THROW(vInd.size() != (size_t)numVals,
+					  "CheckpointReader::read: Number of dofs on an element does "
+					  "not match the checkpoint (" << vInd.size() << " != "
+					  << numVals << "). Make sure to use the same approximation "
+					  "space as for writing.");
+
+		for(size_t i = 0; i < vInd.size(); ++i)
+			DoFRef(u, vInd[i]) = vVals[i];
+	}
+}
+
+template <typename TDomain>
+template <typename TGridFunction>
+void CheckpointReader<TDomain>::
+read(const char* name, TGridFunction& u)
+{
+	PROFILE_FUNC_GROUP("disc");
+	std::map<std::string, size_t>::const_iterator iter = m_gridFunctionPos.find(name);
+	UG_COND_THROW(iter == m_gridFunctionPos.end(), "CheckpointReader::read: "
+				  "No grid function '" << name << "' in checkpoint.");
+	UG_COND_THROW(u.domain().get() != m_spDom.get(), "CheckpointReader::read: "
+				  "Grid function '" << name << "' is not defined on the "
+				  "domain of the checkpoint.");
+
+	BinaryBuffer& buf = checkpoint_buffer();
+	buf.set_read_pos(iter->second);
+
+	#ifdef UG_PARALLEL
+		const int storageMask = Deserialize<int>(buf);
+	#else
+		Deserialize<int>(buf);
+	#endif
+
+	u.set(0.0);
+	read_values<Vertex>(buf, u, m_vVrts);
+	read_values<Edge>(buf, u, m_vEdges);
+	read_values<Face>(buf, u, m_vFaces);
+	read_values<Volume>(buf, u, m_vVols);
+
+	#ifdef UG_PARALLEL
+		u.set_storage_type(storageMask);
+	#endif
+}
+
+}//	end of namespace
+
+#endif
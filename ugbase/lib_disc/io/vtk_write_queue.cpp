@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+#include "vtk_write_queue.h"
+#include "common/error.h"
+#include "common/log.h"
+
+#ifdef UG_PARALLEL
+	#include "pcl/pcl_util.h"
+#endif
+
+using namespace std;
+
+namespace ug{
+
+VTKWriteQueue::VTKWriteQueue(int maxPending)
+{
+	set_max_pending(maxPending);
+	#ifdef UG_POSIX
+		m_threadRunning = false;
+		m_stopThread = false;
+		pthread_mutex_init(&m_mutex, NULL);
+		pthread_cond_init(&m_condPushed, NULL);
+		pthread_cond_init(&m_condDone, NULL);
+	#endif
+}
+
+VTKWriteQueue::~VTKWriteQueue()
+{
+//	no collective operations may be performed here.
+	#ifdef UG_POSIX
+		if(m_threadRunning){
+			pthread_mutex_lock(&m_mutex);
+			m_stopThread = true;
+			pthread_cond_signal(&m_condPushed);
+			pthread_mutex_unlock(&m_mutex);
+			pthread_join(m_thread, NULL);
+		}
+		pthread_cond_destroy(&m_condDone);
+		pthread_cond_destroy(&m_condPushed);
+		pthread_mutex_destroy(&m_mutex);
+	#endif
+
+	if(!m_errorMsg.empty()){
+		UG_LOG("WARNING in ~VTKWriteQueue: " << m_errorMsg << "\n");
+	}
+}
+
+void VTKWriteQueue::set_max_pending(int maxPending)
+{
+	UG_COND_THROW(maxPending < 1, "VTKWriteQueue: The number of pending "
+				  "files has to be positive, but " << maxPending << " was given.");
+	#ifdef UG_POSIX
+		if(m_threadRunning) pthread_mutex_lock(&m_mutex);
+		m_maxPending = maxPending;
+		if(m_threadRunning) pthread_mutex_unlock(&m_mutex);
+	#else
+		m_maxPending = maxPending;
+	#endif
+}
+
+void VTKWriteQueue::push(const string& filename, Base64FileWriter& file)
+{
+	WriteJob* job = new WriteJob;
+	job->filename = filename;
+	file.take_recording(job->rec);
+
+	#ifdef UG_POSIX
+		if(!m_threadRunning)
+			m_threadRunning = (pthread_create(&m_thread, NULL, &write_thread, this) == 0);
+
+		if(m_threadRunning){
+			pthread_mutex_lock(&m_mutex);
+			while((int)m_jobs.size() >= m_maxPending)
+				pthread_cond_wait(&m_condDone, &m_mutex);
+			m_jobs.push_back(job);
+			pthread_cond_signal(&m_condPushed);
+			pthread_mutex_unlock(&m_mutex);
+			return;
+		}
+	#endif
+
+//	no writer thread available. The file is written directly.
+	string errorMsg = execute_job(*job);
+	if(m_errorMsg.empty())
+		m_errorMsg = errorMsg;
+	delete job;
+}
+
+void VTKWriteQueue::wait()
+{
+	#ifdef UG_POSIX
+		if(m_threadRunning){
+			pthread_mutex_lock(&m_mutex);
+			while(!m_jobs.empty())
+				pthread_cond_wait(&m_condDone, &m_mutex);
+			pthread_mutex_unlock(&m_mutex);
+		}
+	#endif
+
+	string errorMsg;
+	errorMsg.swap(m_errorMsg);
+	bool success = errorMsg.empty();
+
+	#ifdef UG_PARALLEL
+		if(!pcl::AllProcsTrue(success)){
+			if(success){
+				UG_THROW("VTKWriteQueue: Writing vtk output failed on "
+						 "another process.");
+			}
+			UG_THROW("VTKWriteQueue: " << errorMsg);
+		}
+	#else
+		UG_COND_THROW(!success, "VTKWriteQueue: " << errorMsg);
+	#endif
+}
+
+#ifdef UG_POSIX
+void* VTKWriteQueue::write_thread(void* queue)
+{
+	VTKWriteQueue& q = *static_cast<VTKWriteQueue*>(queue);
+
+	pthread_mutex_lock(&q.m_mutex);
+	while(true){
+		while(q.m_jobs.empty() && !q.m_stopThread)
+			pthread_cond_wait(&q.m_condPushed, &q.m_mutex);
+
+	//	pending jobs are written before the thread stops
+		if(q.m_jobs.empty())
+			break;
+
+	//	the job stays in the queue while it is written, so that it counts
+	//	as pending. push() only appends jobs, the front is thus not touched.
+		WriteJob* job = q.m_jobs.front();
+		pthread_mutex_unlock(&q.m_mutex);
+
+		string errorMsg = execute_job(*job);
+
+		pthread_mutex_lock(&q.m_mutex);
+		if(q.m_errorMsg.empty())
+			q.m_errorMsg = errorMsg;
+		q.m_jobs.pop_front();
+		delete job;
+		pthread_cond_broadcast(&q.m_condDone);
+	}
+	pthread_mutex_unlock(&q.m_mutex);
+	return NULL;
+}
+#endif
+
+string VTKWriteQueue::execute_job(const WriteJob& job)
+{
+//	this method runs on the writer thread. It thus must neither throw nor
+//	log, nor access any data other than job.
+	try{
+		Base64FileWriter::write_recording(job.rec, job.filename.c_str());
+	}
+	catch(UGError& err){
+		return err.get_msg();
+	}
+	catch(std::exception& ex){
+		return ex.what();
+	}
+	catch(...){
+		return string("Unknown error while writing ") + job.filename;
+	}
+	return string();
+}
+
+}//	end of namespace
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+#ifndef __H__UG__LIB_DISC__IO__VTK_WRITE_QUEUE__
+#define __H__UG__LIB_DISC__IO__VTK_WRITE_QUEUE__
+
+#include <string>
+#include <deque>
+
+#ifdef UG_POSIX
+	#include <pthread.h>
+#endif
+
+#include "common/util/base64_file_writer.h"
+
+namespace ug{
+
+////////////////////////////////////////////////////////////////////////
+///	Writes recorded vtk files on a background thread.
+/**	The output of a Base64FileWriter, which was opened by open_recording(),
+ * is passed to the queue by push(). The base64 encoding, compression and
+ * file output are then done by a writer thread, while the caller continues.
+ * At most max_pending() files are pending at a time. If the queue is full,
+ * push() blocks until the writer thread has finished a file.
+ *
+ * If ug was built without pthreads, files are written directly by push().
+ */
+class VTKWriteQueue
+{
+	public:
+		VTKWriteQueue(int maxPending = 2);
+
+	///	waits until all pending files are written. Not collective.
+		~VTKWriteQueue();
+
+	///	sets the maximal number of pending files (at least 1)
+		void set_max_pending(int maxPending);
+
+	///	returns the maximal number of pending files
+		int max_pending() const		{return m_maxPending;}
+
+	///	takes the recording of the given writer and queues it for output
+		void push(const std::string& filename, Base64FileWriter& file);
+
+	///	blocks until all pending files are written.
+	/**	This method is collective. It throws on all processes, if writing
+	 * a file failed on any process.*/
+		void wait();
+
+	private:
+		struct WriteJob{
+			std::string					filename;
+			Base64FileWriter::Recording	rec;
+		};
+
+	///	writes the file of the given job. Returns an error message on failure.
+		static std::string execute_job(const WriteJob& job);
+
+	#ifdef UG_POSIX
+		static void* write_thread(void* queue);
+
+		pthread_t		m_thread;
+		bool			m_threadRunning;
+		bool			m_stopThread;
+		pthread_mutex_t	m_mutex;
+	///	signaled when a job is queued or the thread shall stop
+		pthread_cond_t	m_condPushed;
+	///	signaled when a job has been finished
+		pthread_cond_t	m_condDone;
+	#endif
+
+	///	pending jobs. The front job is removed after it has been written.
+		std::deque<WriteJob*>	m_jobs;
+		int						m_maxPending;
+	///	first error since the last call to wait()
+		std::string				m_errorMsg;
+};
+
+}//	end of namespace
+
+#endif
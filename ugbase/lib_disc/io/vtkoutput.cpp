@@ -36,6 +36,10 @@
 
 #include <sstream>
 
+#ifdef UG_PARALLEL
+#include "pcl/pcl_process_communicator.h"
+#endif
+
 namespace ug{
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -76,20 +80,10 @@ print(const char* filename, Domain<TDim>& domain)
 	try
 	{
 	VTKFileWriter File(name.c_str());
+	File.set_compression(m_bBinary && m_bCompress, m_compressionLevel);
 
 //	header
-	File << VTKFileWriter::normal;
-	File << "<?xml version=\"1.0\"?>\n";
-
-	write_comment(File);
-
-	File << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"";
-	if(IsLittleEndian()) File << "LittleEndian";
-	else File << "BigEndian";
-	File << "\">\n";
-
-//	opening the grid
-	File << "  <UnstructuredGrid>\n";
+	write_vtu_header(File, false, 0);
 
 // 	get dimension of grid-piece
 	int dim = DimensionOfSubsets(sh);
@@ -620,6 +614,209 @@ set_user_defined_comment(const char* comment){
 	m_sComment = comment;
 }
 
+template <int TDim>
+void VTKOutput<TDim>::
+set_aggregation(int numProcsPerFile) {
+	UG_COND_THROW(numProcsPerFile < 1, "VTKOutput::set_aggregation: "
+				  "At least one process per file required, but "
+				  << numProcsPerFile << " given.");
+	m_aggregation = numProcsPerFile;
+}
+
+template <int TDim>
+void VTKOutput<TDim>::
+set_compression(const char* method)
+{
+	std::string m = TrimString(ToLower(method));
+	if(m == "none")
+		m_bCompress = false;
+	else if(m == "zlib"){
+		#ifdef UG_ZLIB
+			m_bCompress = true;
+		#else
+			UG_THROW("VTKOutput::set_compression: zlib is not available. "
+					 "Please rebuild ug with -DUSE_ZLIB=ON.");
+		#endif
+	}
+	else{
+		UG_THROW("VTKOutput::set_compression: Unknown method '" << method
+				 << "'. Valid methods are 'none' and 'zlib'.");
+	}
+}
+
+template <int TDim>
+void VTKOutput<TDim>::
+set_compression_level(int level) {
+	UG_COND_THROW(level < 0 || level > 9, "VTKOutput::set_compression_level: "
+				  "Invalid level " << level << ". Valid levels are 0 to 9.");
+	m_compressionLevel = level;
+}
+
+template <int TDim>
+void VTKOutput<TDim>::
+set_async(int queueDepth) {
+	UG_COND_THROW(queueDepth < 0, "VTKOutput::set_async: "
+				  "Invalid queue depth " << queueDepth << ".");
+	if(queueDepth == 0)
+	{
+		wait();
+		m_spWriteQueue = SPNULL;
+	}
+	else if(m_spWriteQueue.valid())
+		m_spWriteQueue->set_max_pending(queueDepth);
+	else
+		m_spWriteQueue = make_sp(new VTKWriteQueue(queueDepth));
+}
+
+template <int TDim>
+void VTKOutput<TDim>::
+wait() {
+	if(m_spWriteQueue.valid())
+		m_spWriteQueue->wait();
+}
+
+template <int TDim>
+void VTKOutput<TDim>::
+set_reuse_grid(bool b) {
+	m_bReuseGrid = b;
+}
+
+template <int TDim>
+bool VTKOutput<TDim>::
+aggregated_output() const
+{
+#ifdef UG_PARALLEL
+	return (m_aggregation > 1) && (pcl::NumProcs() > 1);
+#else
+	return false;
+#endif
+}
+
+template <int TDim>
+void VTKOutput<TDim>::
+write_aggregated_vtu(VTKFileWriter& pieceFile, const std::string& filename,
+                     int si, int maxSi, int step)
+{
+#ifdef UG_PARALLEL
+	PROFILE_FUNC();
+//	tag used for the point to point communication of the pieces
+	const int tag = 3871;
+
+	pieceFile.close();
+	std::string piece = pieceFile.memory_content();
+
+	const int rank = pcl::ProcRank();
+	const int groupFirst = rank - rank % m_aggregation;
+	const int groupEnd = std::min(groupFirst + m_aggregation, pcl::NumProcs());
+	pcl::ProcessCommunicator com;
+
+	if(rank != groupFirst)
+	{
+	//	send the size first, since it is not known at the writing process
+		int size = (int)piece.size();
+		com.send_data(&size, sizeof(int), groupFirst, tag);
+		if(size > 0)
+			com.send_data(&piece[0], size, groupFirst, tag);
+
+	//	the writing process reports whether the file was written, so that
+	//	all processes of the group fail together
+		int success = 0;
+		com.receive_data(&success, sizeof(int), groupFirst, tag);
+		UG_COND_THROW(!success, "VTKOutput: Process " << groupFirst
+					  << " couldn't write the aggregated piece of process "
+					  << rank << ".");
+		return;
+	}
+
+//	errors are only reported after all pieces of the group have been
+//	received. Otherwise the sending processes would block.
+	std::string errorMsg;
+	std::string name;
+	VTKFileWriter File;
+	try{
+		vtu_filename(name, filename, rank, si, maxSi, step);
+		if(async_output()) File.open_recording();
+		else File.open(name.c_str());
+
+	//	in parallel the time point is only written to the *.pvtu file
+		write_vtu_header(File, false, 0);
+		File << piece;
+	}
+	catch(UGError& err){
+		errorMsg = err.get_msg();
+	}
+
+//	receive and write the pieces one after another, so that the writing
+//	process only has to keep one foreign piece in memory at a time
+	for(int src = groupFirst + 1; src < groupEnd; ++src)
+	{
+		int size = 0;
+		com.receive_data(&size, sizeof(int), src, tag);
+		piece.resize(size);
+		if(size > 0)
+			com.receive_data(&piece[0], size, src, tag);
+		if(errorMsg.empty()){
+			try{
+				File << piece;
+			}
+			catch(UGError& err){
+				errorMsg = err.get_msg();
+			}
+		}
+	}
+
+	if(errorMsg.empty()){
+		try{
+			File << "  </UnstructuredGrid>\n";
+			File << "</VTKFile>\n";
+
+		//	in asynchronous mode the recorded file is written in the background
+			if(async_output())
+				m_spWriteQueue->push(name, File);
+		}
+		catch(UGError& err){
+			errorMsg = err.get_msg();
+		}
+	}
+
+	int success = errorMsg.empty() ? 1 : 0;
+	for(int dest = groupFirst + 1; dest < groupEnd; ++dest)
+		com.send_data(&success, sizeof(int), dest, tag);
+
+	UG_COND_THROW(!success, "VTKOutput: Couldn't write the aggregated file "
+				  << name << ": " << errorMsg);
+#endif
+}
+
+template <int TDim>
+void VTKOutput<TDim>::
+write_time_series_step(VTKFileWriter& File, const std::string& filename,
+                       int si, int maxSi, int step, number time)
+{
+	PROFILE_FUNC();
+	Base64FileWriter::Recording rec;
+	File.take_recording(rec);
+
+//	the heavy data is written to a file named like the *.vtu file
+	int rank = 0;
+#ifdef UG_PARALLEL
+	rank = pcl::ProcRank();
+#endif
+	std::string binName;
+	vtu_filename(binName, filename, rank, si, maxSi, step);
+	binName.replace(binName.size() - 4, 4, ".bin");
+
+//	all steps are listed in one *.xmf file
+	std::string xmfName;
+	pvtu_filename(xmfName, filename, si, maxSi, -1);
+	xmfName.replace(xmfName.size() - 5, 5, ".xmf");
+
+	SmartPtr<XDMFTimeSeries>& spSeries = m_mTimeSeries[xmfName];
+	if(spSeries.invalid())
+		spSeries = make_sp(new XDMFTimeSeries(xmfName));
+	spSeries->add_step(rec, binName, step, time);
+}
+
 template <int TDim>
 bool VTKOutput<TDim>::
 vtk_name_used(const char* name) const
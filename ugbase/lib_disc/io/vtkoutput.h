@@ -43,6 +43,8 @@
 // other ug modules
 #include "common/util/string_util.h"
 #include "common/util/base64_file_writer.h"
+#include "lib_disc/io/vtk_write_queue.h"
+#include "lib_disc/io/xdmf_time_series.h"
 #include "lib_disc/common/function_group.h"
 #include "lib_disc/domain.h"
 #include "lib_disc/spatial_disc/user_data/user_data.h"
@@ -547,6 +549,10 @@ protected:
 		void
 		write_comment_printf(FILE* File);
 
+	///	writes the xml header of a *.vtu file, up to the opening UnstructuredGrid tag
+		void
+		write_vtu_header(VTKFileWriter& File, bool bTimeDep, number time);
+
 		template <typename T>
 		void
 		write_points(VTKFileWriter& File,
@@ -968,6 +974,28 @@ protected:
 		void write_pvtu(TFunction& u, const std::string&  filename,
 		                int si, int step, number time);
 
+	///	returns true if the pieces of several processes are written to one file
+		bool aggregated_output() const;
+
+	///	returns true if the *.vtu files are written by a background thread
+		bool async_output() const	{return m_spWriteQueue.valid();}
+
+	///	writes the pieces of a process group into one *.vtu file
+	/**
+	 * The local piece has been written to pieceFile in memory mode. All
+	 * processes of a group send their piece to the first process of the group,
+	 * which writes the *.vtu file named after its own rank, containing one
+	 * <Piece> entry per process.
+	 */
+		void write_aggregated_vtu(VTKFileWriter& pieceFile,
+		                          const std::string& filename,
+		                          int si, int maxSi, int step);
+
+	///	adds the recorded *.vtu file to the XDMF time series of the output
+		void write_time_series_step(VTKFileWriter& File,
+		                            const std::string& filename,
+		                            int si, int maxSi, int step, number time);
+
 	public:
 	///	writes a grouping *.pvd file, grouping all data from different subsets
 		static void write_subset_pvd(int numSubset, const std::string&  filename,
@@ -990,7 +1018,8 @@ protected:
 
 	public:
 	///	default constructor
-		VTKOutput()	: m_bSelectAll(true), m_bBinary(true), m_bWriteGrid(true), m_bWriteSubsetIndices(false), m_bWriteProcRanks(false) {} //TODO: maybe true?
+		VTKOutput()	: m_bSelectAll(true), m_bBinary(true), m_bWriteGrid(true), m_bWriteSubsetIndices(false), m_bWriteProcRanks(false), m_aggregation(1),
+					m_bCompress(false), m_compressionLevel(6), m_bReuseGrid(false) {} //TODO: maybe true?
 
 	/// should values be printed in binary (base64 encoded way ) or plain ascii
 		void set_binary(bool b);
@@ -1001,6 +1030,64 @@ protected:
 
 		void set_write_proc_ranks(bool b);
 
+	///	number of processes whose pieces are collected in one *.vtu file
+	/**
+	 * By default every process writes its own *.vtu file. For large process
+	 * counts this results in a huge number of files. If numProcsPerFile > 1,
+	 * groups of numProcsPerFile consecutive processes send their pieces to the
+	 * first process of the group, which writes them to a single file. The
+	 * *.pvtu file then only references these group files.
+	 */
+		void set_aggregation(int numProcsPerFile);
+
+	///	sets the compression of binary data: "none" or "zlib"
+	/**
+	 * With "zlib" the binary data arrays are compressed in the format of
+	 * vtkZLibDataCompressor. This is only available if ug was built with
+	 * USE_ZLIB and has no effect on ascii output.
+	 */
+		void set_compression(const char* method);
+
+	///	sets the zlib compression level (0-9)
+		void set_compression_level(int level);
+
+	///	enables the asynchronous output mode
+	/**
+	 * If queueDepth > 0, print only records the data of the *.vtu files and
+	 * returns. The base64 encoding, compression and file output are then done
+	 * by a background thread, while the caller continues. At most queueDepth
+	 * files are pending. If the queue is full, print blocks until a file has
+	 * been written. The small *.pvtu and *.pvd files are written directly.
+	 * In aggregated output only the file of the writing process is queued.
+	 *
+	 * queueDepth = 0 (default) switches back to synchronous output. Pending
+	 * files are then waited for, which is collective (see wait).
+	 */
+		void set_async(int queueDepth);
+
+	///	enables the time series mode, in which the grid is only written once
+	/**
+	 * If enabled, time dependent output (step >= 0) is written as an XDMF
+	 * time series instead of *.vtu files: The binary data of each step is
+	 * written uncompressed to a *.bin file, named like the *.vtu file. Points
+	 * and cells are only written to it if they changed since the previous
+	 * step. Otherwise the grid in the file of the earlier step is referenced.
+	 * The steps are indexed by a *.xmf file, named like the *.pvtu file
+	 * without the time index, which can be loaded by ParaView and VisIt.
+	 * The mode requires binary output. Compression, aggregation and the
+	 * asynchronous mode do not apply to time series and write_time_pvd has
+	 * no effect.
+	 */
+		void set_reuse_grid(bool b);
+
+	///	blocks until all pending *.vtu files are written
+	/**
+	 * This method is collective. It throws on all processes, if writing a file
+	 * failed on any process. Pending files are also written when the
+	 * VTKOutput is destroyed, but errors are then only logged.
+	 */
+		void wait();
+
 	protected:
 	///	returns true if name for vtk-component is already used
 		bool vtk_name_used(const char* name) const;
@@ -1057,6 +1144,22 @@ protected:
 
 		bool m_bWriteSubsetIndices;
 		bool m_bWriteProcRanks;
+
+	///	number of processes writing to a common *.vtu file
+		int m_aggregation;
+
+	///	compression of binary data
+		bool m_bCompress;
+		int m_compressionLevel;
+
+	///	writer of the asynchronous output mode (invalid in synchronous mode)
+		SmartPtr<VTKWriteQueue> m_spWriteQueue;
+
+	///	whether time dependent output is written as XDMF time series
+		bool m_bReuseGrid;
+
+	///	XDMF time series (key: name of the *.xmf file)
+		std::map<std::string, SmartPtr<XDMFTimeSeries> > m_mTimeSeries;
 };
 
 } // namespace ug
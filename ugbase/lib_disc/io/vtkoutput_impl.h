@@ -172,11 +172,14 @@ print(const char* filename, TFunction& u, int step, number time, bool makeConsis
 			UG_CATCH_THROW("VTK::print: Can not write Subset "<< si << ".");
 		}
 
-		//	write grouping pvd file
-		try{
-			write_subset_pvd(u.num_subsets(), filename, step, time);
+		//	write grouping pvd file (time series are grouped by their *.xmf file)
+		if(!(m_bReuseGrid && step >= 0))
+		{
+			try{
+				write_subset_pvd(u.num_subsets(), filename, step, time);
+			}
+			UG_CATCH_THROW("VTK::print: Can not write pvd file.");
 		}
-		UG_CATCH_THROW("VTK::print: Can not write pvd file.");
 	}
 	#ifdef UG_PARALLEL
 		PCL_DEBUG_BARRIER_ALL();
@@ -224,7 +227,15 @@ print_subset(const char* filename, TFunction& u, int si, int step, number time,
 //	open the file
 	try
 	{
-	VTKFileWriter File(name.c_str());
+	const bool bTimeSeries = m_bReuseGrid && (step >= 0);
+	UG_COND_THROW(bTimeSeries && !m_bBinary, "VTK::print_subset: The time series "
+				  "mode requires binary output.");
+	const bool bAggregate = aggregated_output() && !bTimeSeries;
+	VTKFileWriter File;
+	if(bAggregate) File.open_memory();
+	else if(async_output() || bTimeSeries) File.open_recording();
+	else File.open(name.c_str());
+	File.set_compression(m_bBinary && m_bCompress, m_compressionLevel);
 
 //	bool if time point should be written to *.vtu file
 //	in parallel we must not (!) write it to the *.vtu file, but to the *.pvtu
@@ -233,25 +244,9 @@ print_subset(const char* filename, TFunction& u, int si, int step, number time,
 	if(pcl::NumProcs() > 1) bTimeDep = false;
 #endif
 
-//	header
-	File << VTKFileWriter::normal;
-	File << "<?xml version=\"1.0\"?>\n";
-
-	write_comment(File);
-
-	File << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"";
-	if(IsLittleEndian()) File << "LittleEndian";
-	else File << "BigEndian";
-	File << "\">\n";
-
-//	writing time point
-	if(bTimeDep)
-	{
-		File << "  <Time timestep=\""<<time<<"\"/>\n";
-	}
-
-//	opening the grid
-	File << "  <UnstructuredGrid>\n";
+//	header (in aggregated output only the piece is written here)
+	if(!bAggregate)
+		write_vtu_header(File, bTimeDep, time);
 
 // 	get dimension of grid-piece
 	int dim = -1;
@@ -281,13 +276,40 @@ print_subset(const char* filename, TFunction& u, int si, int step, number time,
 
 //	write closing xml tags
 	File << VTKFileWriter::normal;
-	File << "  </UnstructuredGrid>\n";
-	File << "</VTKFile>\n";
+	if(!bAggregate)
+	{
+		File << "  </UnstructuredGrid>\n";
+		File << "</VTKFile>\n";
+
+	//	in time series mode the recorded file is converted to the series,
+	//	in asynchronous mode it is written in the background
+		if(bTimeSeries)
+		{
+			try{
+				write_time_series_step(File, filename, si, u.num_subsets()-1, step, time);
+			}
+			UG_CATCH_THROW("VTK::print_subset: Can not write time series step.");
+		}
+		else if(async_output())
+			m_spWriteQueue->push(name, File);
+	}
 
 // 	detach help indices
 	grid.detach_from_vertices(aVrtIndex);
 
+//	the time series replaces the *.pvtu and *.pvd files
+	if(bTimeSeries) return;
+
 #ifdef UG_PARALLEL
+//	collect the pieces of the process group in one *.vtu file
+	if(bAggregate)
+	{
+		try{
+			write_aggregated_vtu(File, filename, si, u.num_subsets()-1, step);
+		}
+		UG_CATCH_THROW("VTK::print_subset: Can not write aggregated vtu - file.");
+	}
+
 //	write grouping *.pvtu file in parallel case
 	try{
 		write_pvtu(u, filename, si, step, time);
@@ -356,7 +378,15 @@ print_subsets(const char* filename, TFunction& u, SubsetGroup& ssGrp, int step,
 //	open the file
 	try
 	{
-	VTKFileWriter File(name.c_str());
+	const bool bTimeSeries = m_bReuseGrid && (step >= 0);
+	UG_COND_THROW(bTimeSeries && !m_bBinary, "VTK::print_subsets: The time series "
+				  "mode requires binary output.");
+	const bool bAggregate = aggregated_output() && !bTimeSeries;
+	VTKFileWriter File;
+	if(bAggregate) File.open_memory();
+	else if(async_output() || bTimeSeries) File.open_recording();
+	else File.open(name.c_str());
+	File.set_compression(m_bBinary && m_bCompress, m_compressionLevel);
 
 //	bool if time point should be written to *.vtu file
 //	in parallel we must not (!) write it to the *.vtu file, but to the *.pvtu
@@ -365,25 +395,9 @@ print_subsets(const char* filename, TFunction& u, SubsetGroup& ssGrp, int step,
 	if(pcl::NumProcs() > 1) bTimeDep = false;
 #endif
 
-//	header
-	File << VTKFileWriter::normal;
-	File << "<?xml version=\"1.0\"?>\n";
-
-	write_comment(File);
-
-	File << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"";
-	if(IsLittleEndian()) File << "LittleEndian";
-	else File << "BigEndian";
-	File << "\">\n";
-
-//	writing time point
-	if(bTimeDep)
-	{
-		File << "  <Time timestep=\""<<time<<"\"/>\n";
-	}
-
-//	opening the grid
-	File << "  <UnstructuredGrid>\n";
+//	header (in aggregated output only the piece is written here)
+	if(!bAggregate)
+		write_vtu_header(File, bTimeDep, time);
 
 // 	get dimension of grid-piece: the highest dimension of the specified subsets
 	int dim = -1;
@@ -410,13 +424,40 @@ print_subsets(const char* filename, TFunction& u, SubsetGroup& ssGrp, int step,
 
 //	write closing xml tags
 	File << VTKFileWriter::normal;
-	File << "  </UnstructuredGrid>\n";
-	File << "</VTKFile>\n";
+	if(!bAggregate)
+	{
+		File << "  </UnstructuredGrid>\n";
+		File << "</VTKFile>\n";
+
+	//	in time series mode the recorded file is converted to the series,
+	//	in asynchronous mode it is written in the background
+		if(bTimeSeries)
+		{
+			try{
+				write_time_series_step(File, filename, -1, u.num_subsets()-1, step, time);
+			}
+			UG_CATCH_THROW("VTK::print_subsets: Can not write time series step.");
+		}
+		else if(async_output())
+			m_spWriteQueue->push(name, File);
+	}
 
 // 	detach help indices
 	grid.detach_from_vertices(aVrtIndex);
 
+//	the time series replaces the *.pvtu and *.pvd files
+	if(bTimeSeries) return;
+
 #ifdef UG_PARALLEL
+//	collect the pieces of the process group in one *.vtu file
+	if(bAggregate)
+	{
+		try{
+			write_aggregated_vtu(File, filename, -1, u.num_subsets()-1, step);
+		}
+		UG_CATCH_THROW("VTK::print_subsets: Can not write aggregated vtu - file.");
+	}
+
 //	write grouping *.pvtu file in parallel case
 	try{
 		write_pvtu(u, filename, -1, step, time); // "-1" because we do not want any subset prefixes!
@@ -815,6 +856,33 @@ write_comment_printf(FILE* File)
 	fprintf(File, "-->\n");
 }
 
+template <int TDim>
+void VTKOutput<TDim>::
+write_vtu_header(VTKFileWriter& File, bool bTimeDep, number time)
+{
+	File << VTKFileWriter::normal;
+	File << "<?xml version=\"1.0\"?>\n";
+
+	write_comment(File);
+
+	File << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"";
+	if(IsLittleEndian()) File << "LittleEndian";
+	else File << "BigEndian";
+	File << "\"";
+	if(m_bBinary && m_bCompress)
+		File << " compressor=\"vtkZLibDataCompressor\"";
+	File << ">\n";
+
+//	writing time point
+	if(bTimeDep)
+	{
+		File << "  <Time timestep=\""<<time<<"\"/>\n";
+	}
+
+//	opening the grid
+	File << "  <UnstructuredGrid>\n";
+}
+
 template <int TDim>
 void VTKOutput<TDim>::
 write_cell_subset_names(VTKFileWriter& File, MGSubsetHandler &sh)
@@ -3054,8 +3122,9 @@ write_pvtu(TFunction& u, const std::string& filename,
 			fprintf(file, "    </PCellData>\n");
 		}
 
-	// 	include files from all procs
-		for (int i = 0; i < numProcs; i++) {
+	// 	include files from all procs (or from the first proc of each
+	//	group, if the pieces are aggregated)
+		for (int i = 0; i < numProcs; i += m_aggregation) {
 			vtu_filename(name, filename, i, si, maxSi, step);
 			name = FilenameWithoutPath(name);
 			fprintf(file, "    <Piece Source=\"%s\"/>\n", name.c_str());
@@ -3077,6 +3146,9 @@ template <typename TFunction>
 void VTKOutput<TDim>::
 write_time_pvd(const char* filename, TFunction& u)
 {
+//	the steps of a time series are listed in its *.xmf file
+	if(m_bReuseGrid) return;
+
 //	File
 	FILE* file;
 
@@ -3172,6 +3244,9 @@ template <typename TFunction>
 void VTKOutput<TDim>::
 write_time_processwise_pvd(const char* filename, TFunction& u)
 {
+//	the steps of a time series are listed in its *.xmf file
+	if(m_bReuseGrid) return;
+
 //	File
 	FILE* file;
 
@@ -3247,6 +3322,9 @@ template <typename TFunction>
 void VTKOutput<TDim>::
 write_time_pvd_subset(const char* filename, TFunction& u, int si)
 {
+//	the steps of a time series are listed in its *.xmf file
+	if(m_bReuseGrid) return;
+
 //	File
 	FILE* file;
 
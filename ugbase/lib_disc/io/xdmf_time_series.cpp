@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+
+#include "xdmf_time_series.h"
+#include "common/error.h"
+#include "common/profiler/profiler.h"
+#include "common/util/string_util.h"
+
+#ifdef UG_PARALLEL
+	#include "pcl/pcl.h"
+	#include "pcl/pcl_util.h"
+#endif
+
+using namespace std;
+
+namespace ug{
+
+///	returns the value of an attribute of an xml tag or an empty string
+static string XMLAttribute(const string& tag, const char* name)
+{
+	const string key = string(" ") + name + "=\"";
+	size_t pos = tag.find(key);
+	if(pos == string::npos) return string();
+	pos += key.size();
+	return tag.substr(pos, tag.find('"', pos) - pos);
+}
+
+///	number type and precision of XDMF for a vtk data type
+static void XDMFNumberType(string& numberTypeOut, int& precisionOut,
+                           const string& vtkType)
+{
+	if(vtkType == "Float32")		{numberTypeOut = "Float"; precisionOut = 4;}
+	else if(vtkType == "Float64")	{numberTypeOut = "Float"; precisionOut = 8;}
+	else if(vtkType == "Int8")		{numberTypeOut = "Char"; precisionOut = 1;}
+	else if(vtkType == "UInt8")		{numberTypeOut = "UChar"; precisionOut = 1;}
+	else if(vtkType == "Int32")		{numberTypeOut = "Int"; precisionOut = 4;}
+	else if(vtkType == "UInt32")	{numberTypeOut = "UInt"; precisionOut = 4;}
+	else if(vtkType == "Int64")		{numberTypeOut = "Int"; precisionOut = 8;}
+	else UG_THROW("XDMFTimeSeries: Unsupported data type '" << vtkType << "'.");
+}
+
+///	reads the i-th value of type T from unaligned memory
+template <typename T>
+static T ReadValue(const char* data, size_t i)
+{
+	T val;
+	memcpy(&val, data + i * sizeof(T), sizeof(T));
+	return val;
+}
+
+
+XDMFTimeSeries::XDMFTimeSeries(const std::string& xmfFilename) :
+	m_xmfFilename(xmfFilename),
+	m_gridStep(-1),
+	m_numPoints(0),
+	m_numCells(0),
+	m_topoSize(0)
+{
+}
+
+void XDMFTimeSeries::
+parse_recording(std::vector<DataArray>& arraysOut,
+                const Base64FileWriter::Recording& rec)
+{
+//	the binary block following the opening tag of a data array holds its data
+	string section, arrayTag;
+	for(size_t i = 0; i < rec.chunks.size(); ++i)
+	{
+		const string& chunk = rec.chunks[i].second;
+		switch(rec.chunks[i].first)
+		{
+			case Base64FileWriter::normal:
+				for(size_t pos = chunk.find('<'); pos != string::npos;
+					pos = chunk.find('<', pos + 1))
+				{
+				//	user defined comments may contain arbitrary text
+					if(chunk.compare(pos, 4, "<!--") == 0){
+						pos = chunk.find("-->", pos);
+						UG_COND_THROW(pos == string::npos, "XDMFTimeSeries: "
+									  "Incomplete comment in recording.");
+						continue;
+					}
+
+					const size_t end = chunk.find('>', pos);
+					UG_COND_THROW(end == string::npos,
+								  "XDMFTimeSeries: Incomplete xml tag in recording.");
+					const string tag = chunk.substr(pos + 1, end - pos - 1);
+					const string tagName = tag.substr(0, tag.find_first_of(" \t\n/", 1));
+
+					if(tagName == "Points" || tagName == "Cells"
+						|| tagName == "PointData" || tagName == "CellData")
+						section = tagName;
+					else if(tagName == "/Points" || tagName == "/Cells"
+						|| tagName == "/PointData" || tagName == "/CellData")
+						section.clear();
+					else if(tagName == "DataArray")
+						arrayTag = tag;
+					else if(tagName == "/DataArray")
+						arrayTag.clear();
+				}
+				break;
+
+			case Base64FileWriter::base64_binary:
+			{
+				UG_COND_THROW(arrayTag.empty(), "XDMFTimeSeries: Binary data "
+							  "outside of a data array in recording.");
+
+			//	the block starts with the size of the data in bytes
+				UG_COND_THROW(chunk.size() < sizeof(int), "XDMFTimeSeries: "
+							  "Binary block without size header in recording.");
+				const int numBytes = ReadValue<int>(chunk.data(), 0);
+				UG_COND_THROW(numBytes < 0 || (size_t)numBytes != chunk.size() - sizeof(int),
+							  "XDMFTimeSeries: Size of binary block does not "
+							  "match its header in recording.");
+
+				DataArray a;
+				a.section = section;
+				a.name = XMLAttribute(arrayTag, "Name");
+				a.type = XMLAttribute(arrayTag, "type");
+				const string numComp = XMLAttribute(arrayTag, "NumberOfComponents");
+				a.numComponents = numComp.empty() ? 1 : atoi(numComp.c_str());
+				a.data = chunk.data() + sizeof(int);
+				a.size = numBytes;
+				arraysOut.push_back(a);
+				arrayTag.clear();
+				break;
+			}
+
+			default:
+				UG_THROW("XDMFTimeSeries: Only binary vtk output is supported.");
+		}
+	}
+}
+
+void XDMFTimeSeries::
+build_topology(std::vector<int>& topoOut, size_t& numCellsOut,
+               const DataArray& connectivity, const DataArray& offsets,
+               const DataArray& types)
+{
+	UG_COND_THROW(connectivity.type != "Int32" || offsets.type != "Int32"
+				  || types.type != "Int8", "XDMFTimeSeries: Unexpected data "
+				  "types of the cells.");
+
+	numCellsOut = types.size;
+	UG_COND_THROW(offsets.size != numCellsOut * sizeof(int),
+				  "XDMFTimeSeries: Number of cell offsets and types differ.");
+
+	topoOut.clear();
+	topoOut.reserve(numCellsOut + connectivity.size / sizeof(int));
+	int begin = 0;
+	for(size_t i = 0; i < numCellsOut; ++i)
+	{
+		const int end = ReadValue<int>(offsets.data, i);
+		UG_COND_THROW(end < begin || (size_t)end * sizeof(int) > connectivity.size,
+					  "XDMFTimeSeries: Invalid cell offsets.");
+
+	//	XDMF topology types have the same corner order as the vtk cell types
+		switch(types.data[i])
+		{
+			case 1:  topoOut.push_back(1); topoOut.push_back(end - begin); break;
+			case 3:  topoOut.push_back(2); topoOut.push_back(end - begin); break;
+			case 5:  topoOut.push_back(4); break;
+			case 9:  topoOut.push_back(5); break;
+			case 10: topoOut.push_back(6); break;
+			case 14: topoOut.push_back(7); break;
+			case 13: topoOut.push_back(8); break;
+			case 12: topoOut.push_back(9); break;
+			default: UG_THROW("XDMFTimeSeries: Unsupported vtk cell type "
+							  << (int)types.data[i] << ".");
+		}
+		for(int j = begin; j < end; ++j)
+			topoOut.push_back(ReadValue<int>(connectivity.data, j));
+		begin = end;
+	}
+}
+
+std::string XDMFTimeSeries::
+data_item(const std::string& type, size_t numTuples, int numComponents,
+          const std::string& file, size_t seek)
+{
+	string numberType;
+	int precision;
+	XDMFNumberType(numberType, precision, type);
+
+	const int one = 1;
+	const bool littleEndian = (*reinterpret_cast<const char*>(&one) == 1);
+
+	stringstream ss;
+	ss << "<DataItem Dimensions=\"" << numTuples;
+	if(numComponents > 1) ss << " " << numComponents;
+	ss << "\" NumberType=\"" << numberType << "\" Precision=\"" << precision
+	   << "\" Format=\"Binary\" Endian=\"" << (littleEndian ? "Little" : "Big")
+	   << "\" Seek=\"" << seek << "\">" << file << "</DataItem>";
+	return ss.str();
+}
+
+void XDMFTimeSeries::
+add_step(const Base64FileWriter::Recording& rec, const std::string& binFilename,
+         int step, number time)
+{
+	PROFILE_FUNC();
+
+//	steps from the given one on are replaced, their grid can not be referenced
+	m_steps.erase(m_steps.lower_bound(step), m_steps.end());
+	if(step <= m_gridStep){
+		m_gridData.clear();
+		m_gridFile.clear();
+		m_gridStep = -1;
+	}
+
+	string piece, errorMsg;
+	try{
+		vector<DataArray> vArray;
+		parse_recording(vArray, rec);
+
+	//	points and cells of this step
+		const DataArray* pPoints = NULL;
+		const DataArray* pConn = NULL;
+		const DataArray* pOffsets = NULL;
+		const DataArray* pTypes = NULL;
+		for(size_t i = 0; i < vArray.size(); ++i)
+		{
+			if(vArray[i].section == "Points") pPoints = &vArray[i];
+			else if(vArray[i].section == "Cells"){
+				if(vArray[i].name == "connectivity") pConn = &vArray[i];
+				else if(vArray[i].name == "offsets") pOffsets = &vArray[i];
+				else if(vArray[i].name == "types") pTypes = &vArray[i];
+			}
+		}
+
+		string gridData;
+		vector<int> vTopo;
+		size_t numCells = 0, numPoints = 0;
+		if(pPoints && pConn && pOffsets && pTypes)
+		{
+			UG_COND_THROW(pPoints->type != "Float32" || pPoints->numComponents != 3,
+						  "XDMFTimeSeries: Unexpected format of the points.");
+			numPoints = pPoints->size / (3 * sizeof(float));
+			build_topology(vTopo, numCells, *pConn, *pOffsets, *pTypes);
+			gridData.assign(pPoints->data, pPoints->size);
+			if(!vTopo.empty())
+				gridData.append(reinterpret_cast<const char*>(&vTopo[0]),
+								vTopo.size() * sizeof(int));
+		}
+		else
+			UG_COND_THROW(m_gridFile.empty(), "XDMFTimeSeries: The first step "
+						  "of '" << m_xmfFilename << "' does not contain the grid.");
+
+	//	empty pieces (processes without elements) are not listed
+		if(!gridData.empty() || (pPoints == NULL && m_numPoints > 0))
+		{
+			ofstream out(binFilename.c_str(), ios::out | ios::binary | ios::trunc);
+			UG_COND_THROW(!out, "XDMFTimeSeries: Can not open '" << binFilename << "'.");
+			const string binName = FilenameWithoutPath(binFilename);
+			size_t seek = 0;
+
+		//	the grid is only written if it has changed
+			if(!gridData.empty() && gridData != m_gridData)
+			{
+				out.write(gridData.data(), gridData.size());
+				m_gridData.swap(gridData);
+				m_gridFile = binName;
+				m_gridStep = step;
+				m_numPoints = numPoints;
+				m_numCells = numCells;
+				m_topoSize = vTopo.size();
+				seek = m_gridData.size();
+			}
+
+			stringstream ss;
+			ss << "        <Topology TopologyType=\"Mixed\" NumberOfElements=\""
+			   << m_numCells << "\">\n          "
+			   << data_item("Int32", m_topoSize, 1, m_gridFile, m_numPoints * 3 * sizeof(float))
+			   << "\n        </Topology>\n";
+			ss << "        <Geometry GeometryType=\"XYZ\">\n          "
+			   << data_item("Float32", m_numPoints, 3, m_gridFile, 0)
+			   << "\n        </Geometry>\n";
+
+		//	point and cell data
+			for(size_t i = 0; i < vArray.size(); ++i)
+			{
+				const DataArray& a = vArray[i];
+				if(a.section != "PointData" && a.section != "CellData") continue;
+
+				string numberType;
+				int precision;
+				XDMFNumberType(numberType, precision, a.type);
+				const size_t numTuples = a.size / (precision * a.numComponents);
+
+				const char* attribType = "Matrix";
+				switch(a.numComponents){
+					case 1: attribType = "Scalar"; break;
+					case 3: attribType = "Vector"; break;
+					case 6: attribType = "Tensor6"; break;
+					case 9: attribType = "Tensor"; break;
+				}
+
+				out.write(a.data, a.size);
+				ss << "        <Attribute Name=\"" << a.name << "\" AttributeType=\""
+				   << attribType << "\" Center=\""
+				   << (a.section == "PointData" ? "Node" : "Cell") << "\">\n          "
+				   << data_item(a.type, numTuples, a.numComponents, binName, seek)
+				   << "\n        </Attribute>\n";
+				seek += a.size;
+			}
+
+			out.close();
+			UG_COND_THROW(out.fail(), "XDMFTimeSeries: Could not write '"
+						  << binFilename << "'.");
+			piece = ss.str();
+		}
+	}
+	catch(UGError& err){
+		errorMsg = err.get_msg();
+	}
+
+	stringstream ssTime;
+	ssTime << setprecision(numeric_limits<number>::digits10 + 1) << time;
+
+#ifdef UG_PARALLEL
+	if(pcl::NumProcs() > 1)
+	{
+		if(!pcl::AllProcsTrue(errorMsg.empty())){
+			if(errorMsg.empty())
+				UG_THROW("XDMFTimeSeries: Writing step " << step << " failed "
+						 "on another process.");
+			UG_THROW(errorMsg);
+		}
+
+	//	process 0 collects the pieces of all processes
+		if(!piece.empty()){
+			stringstream ss;
+			ss << "      <Grid Name=\"p" << pcl::ProcRank() << "\" GridType=\"Uniform\">\n"
+			   << piece << "      </Grid>\n";
+			piece = ss.str();
+		}
+		vector<char> vSend(piece.begin(), piece.end()), vRec;
+		pcl::ProcessCommunicator().gatherv(vRec, vSend, 0);
+		if(pcl::ProcRank() != 0) return;
+
+		stringstream ss;
+		ss << "    <Grid Name=\"t" << step << "\" GridType=\"Collection\" "
+		   << "CollectionType=\"Spatial\">\n"
+		   << "      <Time Value=\"" << ssTime.str() << "\"/>\n";
+		ss.write(vRec.empty() ? NULL : &vRec[0], vRec.size());
+		ss << "    </Grid>\n";
+		m_steps[step] = make_pair(time, ss.str());
+	}
+	else
+#endif
+	{
+		UG_COND_THROW(!errorMsg.empty(), errorMsg);
+		stringstream ss;
+		ss << "    <Grid Name=\"t" << step << "\" GridType=\"Uniform\">\n"
+		   << "      <Time Value=\"" << ssTime.str() << "\"/>\n"
+		   << piece << "    </Grid>\n";
+		m_steps[step] = make_pair(time, ss.str());
+	}
+
+	write_xmf();
+}
+
+void XDMFTimeSeries::
+write_xmf() const
+{
+	ofstream out(m_xmfFilename.c_str(), ios::out | ios::trunc);
+	UG_COND_THROW(!out, "XDMFTimeSeries: Can not open '" << m_xmfFilename << "'.");
+
+	out << "<?xml version=\"1.0\"?>\n";
+	out << "<Xdmf Version=\"2.0\">\n";
+	out << "<Domain>\n";
+	out << "  <Grid Name=\"TimeSeries\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+	for(map<int, pair<number, string> >::const_iterator iter = m_steps.begin();
+		iter != m_steps.end(); ++iter)
+		out << iter->second.second;
+	out << "  </Grid>\n";
+	out << "</Domain>\n";
+	out << "</Xdmf>\n";
+
+	out.close();
+	UG_COND_THROW(out.fail(), "XDMFTimeSeries: Could not write '" << m_xmfFilename << "'.");
+}
+
+}//	end of namespace
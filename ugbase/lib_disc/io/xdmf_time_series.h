@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+#ifndef __H__UG__LIB_DISC__IO__XDMF_TIME_SERIES__
+#define __H__UG__LIB_DISC__IO__XDMF_TIME_SERIES__
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "common/types.h"
+#include "common/util/base64_file_writer.h"
+
+namespace ug{
+
+////////////////////////////////////////////////////////////////////////
+///	Writes a time series of vtu data in the XDMF format, storing the grid only once.
+/**	The data of each time step is passed as the recording of a *.vtu file
+ * (see Base64FileWriter::open_recording), which has to be written in binary
+ * format. The binary data arrays of the step are written uncompressed to a
+ * raw binary file. Points and cells are only written to this file if they
+ * differ from the ones of the previous step. Otherwise the points and cells
+ * in the file of the earlier step are referenced.
+ *
+ * The *.xmf file indexing all steps is rewritten after each step by process 0.
+ * It contains a temporal collection and, in parallel, one spatial collection
+ * of the pieces of all processes per step. XDMF files can be loaded by
+ * ParaView and VisIt.
+ */
+class XDMFTimeSeries
+{
+	public:
+	///	creates a series whose index is written to the given *.xmf file
+		XDMFTimeSeries(const std::string& xmfFilename);
+
+	///	adds the recorded *.vtu file of a time step to the series
+	/**	The heavy data is written to binFilename. Steps with an index greater
+	 * or equal to the given one are replaced. This method is collective.*/
+		void add_step(const Base64FileWriter::Recording& rec,
+		              const std::string& binFilename, int step, number time);
+
+	private:
+	///	binary data array of a recording
+		struct DataArray{
+			std::string section;
+			std::string name;
+			std::string type;
+			int numComponents;
+			const char* data;
+			size_t size;
+		};
+
+	///	extracts the binary data arrays of a recorded *.vtu file
+		static void parse_recording(std::vector<DataArray>& arraysOut,
+		                            const Base64FileWriter::Recording& rec);
+
+	///	converts vtk cells to the mixed topology of XDMF
+		static void build_topology(std::vector<int>& topoOut, size_t& numCellsOut,
+		                           const DataArray& connectivity,
+		                           const DataArray& offsets,
+		                           const DataArray& types);
+
+	///	returns the DataItem element referencing data in a binary file
+		static std::string data_item(const std::string& type, size_t numTuples,
+		                             int numComponents, const std::string& file,
+		                             size_t seek);
+
+	///	writes the *.xmf file (on process 0)
+		void write_xmf() const;
+
+	private:
+		std::string m_xmfFilename;
+
+	///	points and topology of the grid written last and their location
+		std::string m_gridData;
+		std::string m_gridFile;
+		int m_gridStep;
+		size_t m_numPoints, m_numCells, m_topoSize;
+
+	///	time and grid elements of each step (only on process 0)
+		std::map<int, std::pair<number, std::string> > m_steps;
+};
+
+}//	end of namespace
+
+#endif
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ *
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ *
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ *
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ *
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+#ifndef __H__UG__LIB_DISC__SPATIAL_DISC__IMPLICIT_LEVEL_ASSEMBLE__
+#define __H__UG__LIB_DISC__SPATIAL_DISC__IMPLICIT_LEVEL_ASSEMBLE__
+
+#include <vector>
+#include "common/common.h"
+#include "common/math/ugmath.h"
+#include "lib_algebra/common/operations.h"
+#include "lib_grid/refinement/implicit_uniform_refinement.h"
+#include "lib_disc/reference_element/reference_element.h"
+#include "lib_disc/reference_element/reference_mapping_provider.h"
+#include "lib_disc/local_finite_element/local_finite_element_provider.h"
+#include "lib_disc/quadrature/quadrature_provider.h"
+
+#ifdef UG_PARALLEL
+	#include "pcl/pcl_util.h"
+	#include "lib_algebra/parallelization/parallelization_util.h"
+	#include "lib_grid/parallelization/distributed_grid.h"
+#endif
+
+namespace ug{
+
+///	\addtogroup lib_disc_assemble
+///	@{
+
+template <int dim, typename TAlgebra>
+void AssembleDiffusionOnImplicitLevel(typename TAlgebra::matrix_type& A,
+                                      typename TAlgebra::vector_type& b,
+                                      const ImplicitUniformRefinement& iur,
+                                      int lvl, number diffusion,
+                                      number reaction, number source)
+{
+	PROFILE_FUNC_GROUP("discretization");
+
+//	the vertex indices of the level are used as dof indices
+	const size_t numDoFs = iur.num_vertices(lvl);
+	A.resize_and_clear(numDoFs, numDoFs);
+	b.resize(numDoFs);
+	b.set(0.0);
+
+	std::vector<size_t> vChildVrts;
+	std::vector<MathVector<dim> > vCorner;
+	std::vector<number> vShape;
+	std::vector<MathVector<dim> > vLocGrad;
+	std::vector<MathVector<dim> > vGlobGrad;
+	MathMatrix<dim, dim> JTInv;
+
+	for(size_t ce = 0; ce < iur.num_coarse_elements(); ++ce)
+	{
+	//	all children of a coarse element have the type of the coarse element
+		const ReferenceObjectID roid = iur.coarse_element(ce)->reference_object_id();
+		const size_t numCorners = ReferenceElementProvider::get(roid).num(0);
+
+		const QuadratureRule<dim>& rQuadRule = QuadratureRuleProvider<dim>::get(roid, 2);
+		DimReferenceMapping<dim, dim>& mapping = ReferenceMappingProvider::get<dim, dim>(roid);
+		const LocalShapeFunctionSet<dim>& rTrialSpace =
+				LocalFiniteElementProvider::get<dim>(roid, LFEID(LFEID::LAGRANGE, dim, 1));
+
+		vCorner.resize(numCorners);
+		vShape.resize(numCorners);
+		vLocGrad.resize(numCorners);
+		vGlobGrad.resize(numCorners);
+
+		iur.coarse_element_children(vChildVrts, lvl, ce);
+		const size_t* vrts = &vChildVrts.front();
+		for(size_t child = 0; child < vChildVrts.size() / numCorners;
+			++child, vrts += numCorners)
+		{
+			for(size_t i = 0; i < numCorners; ++i){
+				const vector3 pos = iur.vertex_position(lvl, vrts[i]);
+				for(int d = 0; d < dim; ++d)
+					vCorner[i][d] = pos[d];
+			}
+			mapping.update(&vCorner[0]);
+
+			for(size_t ip = 0; ip < rQuadRule.size(); ++ip)
+			{
+				const MathVector<dim>& locIP = rQuadRule.point(ip);
+				const number det = mapping.jacobian_transposed_inverse(JTInv, locIP);
+				const number weight = rQuadRule.weight(ip) * std::fabs(det);
+
+				rTrialSpace.shapes(&vShape[0], locIP);
+				rTrialSpace.grads(&vLocGrad[0], locIP);
+				for(size_t i = 0; i < numCorners; ++i)
+					MatVecMult(vGlobGrad[i], JTInv, vLocGrad[i]);
+
+				for(size_t i = 0; i < numCorners; ++i){
+					for(size_t j = 0; j < numCorners; ++j){
+						BlockRef(A(vrts[i], vrts[j]), 0, 0) += weight
+							* (diffusion * VecDot(vGlobGrad[i], vGlobGrad[j])
+							   + reaction * vShape[i] * vShape[j]);
+					}
+					BlockRef(b[vrts[i]], 0) += weight * source * vShape[i];
+				}
+			}
+		}
+	}
+
+//	the coarse grid is not distributed (see below), the virtual levels are
+//	thus process-local
+	#ifdef UG_PARALLEL
+		SmartPtr<AlgebraLayouts> spLayouts = CreateLocalAlgebraLayouts();
+		A.set_layouts(spLayouts);
+		A.set_storage_type(PST_ADDITIVE);
+		b.set_layouts(spLayouts);
+		b.set_storage_type(PST_ADDITIVE);
+	#endif
+}
+
+///	assembles -div(diffusion*grad u) + reaction*u = source with linear elements on a virtual level
+/**	The system is assembled on level lvl of the given implicit uniform
+ * refinement, without creating the elements of the level. There is one unknown
+ * per vertex, and the vertex indices of the level (see
+ * ImplicitUniformRefinement) are used directly as indices in A and b.
+ * No Dirichlet values are set, i.e. natural boundary conditions hold on the
+ * whole boundary. For a regular system reaction has to be positive.
+ *
+ * The algebra has to have scalar blocks (CPUAlgebra). In parallel, the
+ * coarse grid has to be present as a whole on each process, since the
+ * virtual levels are assembled process-locally.*/
+template <typename TAlgebra>
+void AssembleDiffusionOnImplicitLevel(typename TAlgebra::matrix_type& A,
+                                      typename TAlgebra::vector_type& b,
+                                      const ImplicitUniformRefinement& iur,
+                                      int lvl, number diffusion,
+                                      number reaction, number source)
+{
+	UG_COND_THROW(TAlgebra::blockSize != 1,
+				  "AssembleDiffusionOnImplicitLevel: Only algebras with one "
+				  "unknown per index are supported.");
+
+	#ifdef UG_PARALLEL
+	//	there are no interfaces between the virtual levels of different processes
+		bool bDistributed = false;
+		Grid& grid = *iur.grid();
+		if(DistributedGridManager* dgm = grid.distributed_grid_manager()){
+			for(VertexIterator iter = grid.begin<Vertex>();
+				iter != grid.end<Vertex>(); ++iter)
+			{
+				if(dgm->get_status(*iter) != ES_NONE){
+					bDistributed = true;
+					break;
+				}
+			}
+		}
+		UG_COND_THROW(pcl::OneProcTrue(bDistributed),
+					  "AssembleDiffusionOnImplicitLevel: The coarse grid is "
+					  "distributed. Only coarse grids which are present as a "
+					  "whole on each process are supported.");
+	#endif
+
+	switch(iur.dim()){
+		case 1: AssembleDiffusionOnImplicitLevel<1, TAlgebra>
+					(A, b, iur, lvl, diffusion, reaction, source); break;
+		case 2: AssembleDiffusionOnImplicitLevel<2, TAlgebra>
+					(A, b, iur, lvl, diffusion, reaction, source); break;
+		case 3: AssembleDiffusionOnImplicitLevel<3, TAlgebra>
+					(A, b, iur, lvl, diffusion, reaction, source); break;
+		default: UG_THROW("AssembleDiffusionOnImplicitLevel: Unsupported "
+						  "dimension: " << iur.dim());
+	}
+}
+
+///	writes a vector with one unknown per vertex of a virtual level to a vtu file
+/**	The first component of each entry of u is written as point data with the
+ * given name (see SaveImplicitLevelToVTU).*/
+template <typename TVector>
+bool SaveImplicitLevelVectorToVTU(const char* filename,
+                                  const ImplicitUniformRefinement& iur, int lvl,
+                                  const TVector& u, const char* dataName)
+{
+	UG_COND_THROW(u.size() != iur.num_vertices(lvl),
+				  "SaveImplicitLevelVectorToVTU: The vector has " << u.size()
+				  << " entries, but level " << lvl << " has "
+				  << iur.num_vertices(lvl) << " vertices.");
+
+	std::vector<number> vrtData(u.size());
+	for(size_t i = 0; i < u.size(); ++i)
+		vrtData[i] = BlockRef(u[i], 0);
+
+	return SaveImplicitLevelToVTU(filename, iur, lvl, &vrtData, dataName);
+}
+
+/// @}
+
+}//	end of namespace
+
+#endif
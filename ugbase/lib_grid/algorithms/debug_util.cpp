@@ -146,6 +146,128 @@ void PrintAttachmentInfo(Grid& grid)
 	PrintAttachmentInfo<Volume>(grid);
 }
 
+template <class TGeomObj>
+static size_t PrintAttachmentMemoryUsage(Grid& grid, const char* name)
+{
+	typedef typename Grid::traits<TGeomObj>::AttachmentPipe	AttachmentPipe;
+	typedef typename AttachmentPipe::ConstAttachmentEntryIterator AttIter;
+
+	AttachmentPipe& pipe = grid.get_attachment_pipe<TGeomObj>();
+
+	size_t numAttachments = 0;
+	size_t totalSize = 0;
+	for(AttIter iter = pipe.attachments_begin();
+		iter != pipe.attachments_end(); ++iter, ++numAttachments)
+	{
+		totalSize += iter->m_pContainer->occupied_memory();
+	}
+
+	UG_LOG("  " << name << ":\t" << pipe.num_elements() << " elements, "
+			<< pipe.num_data_entries() - pipe.num_elements() << " unused data entries, "
+			<< numAttachments << " attachments, " << totalSize << " bytes\n");
+	return totalSize;
+}
+
+void PrintGridMemoryUsage(Grid& grid)
+{
+	UG_LOG("grid memory usage:\n");
+	size_t totalSize = 0;
+	totalSize += PrintAttachmentMemoryUsage<Vertex>(grid, "vertices");
+	totalSize += PrintAttachmentMemoryUsage<Edge>(grid, "edges");
+	totalSize += PrintAttachmentMemoryUsage<Face>(grid, "faces");
+	totalSize += PrintAttachmentMemoryUsage<Volume>(grid, "volumes");
+
+	const GridObjectPools& pools = grid.object_pools();
+	const size_t poolSize = pools.memory_reserved();
+	UG_LOG("  grid object pools:\t" << pools.num_allocated()
+			<< " objects, " << poolSize << " bytes\n");
+	totalSize += poolSize;
+
+	if(grid.has_vertex_tuple_hash()){
+		UG_LOG("  vertex tuple hash:\t" << grid.vertex_tuple_hash()->size()
+				<< " entries\n");
+	}
+	if(grid.topology_is_frozen()){
+		UG_LOG("  topology is frozen\n");
+	}
+
+	UG_LOG("  total:\t" << totalSize << " bytes (without heap memory of "
+			"attached containers)\n");
+}
+
+template <class TElem>
+static bool CheckDefragmentImpl(Grid& grid, Attachment<TElem*>& aElem)
+{
+	Grid::AttachmentAccessor<TElem, Attachment<TElem*> > aaElem(grid, aElem);
+
+	if(grid.attachment_container_size<TElem>() != grid.num<TElem>()){
+		UG_LOG("CheckDefragment: attachment container size "
+				<< grid.attachment_container_size<TElem>() << " of "
+				<< TElem::BASE_OBJECT_ID << " does not match the number of "
+				"elements " << grid.num<TElem>() << ".\n");
+		return false;
+	}
+
+	size_t i = 0;
+	for(typename Grid::traits<TElem>::iterator iter = grid.begin<TElem>();
+		iter != grid.end<TElem>(); ++iter, ++i)
+	{
+		TElem* e = *iter;
+		if(grid.get_attachment_data_index(e) != i){
+			UG_LOG("CheckDefragment: element " << i << " of type "
+					<< TElem::BASE_OBJECT_ID << " has data index "
+					<< grid.get_attachment_data_index(e) << ".\n");
+			return false;
+		}
+		if(aaElem[e] != e){
+			UG_LOG("CheckDefragment: attached data of element " << i
+					<< " of type " << TElem::BASE_OBJECT_ID
+					<< " was not moved with the element.\n");
+			return false;
+		}
+	}
+	return true;
+}
+
+template <class TElem>
+static void AttachElementsToThemselves(Grid& grid, Attachment<TElem*>& aElem)
+{
+	grid.attach_to<TElem>(aElem);
+	Grid::AttachmentAccessor<TElem, Attachment<TElem*> > aaElem(grid, aElem);
+	for(typename Grid::traits<TElem>::iterator iter = grid.begin<TElem>();
+		iter != grid.end<TElem>(); ++iter)
+	{
+		aaElem[*iter] = *iter;
+	}
+}
+
+bool CheckDefragment(Grid& grid)
+{
+	Attachment<Vertex*> aVrt;
+	Attachment<Edge*> aEdge;
+	Attachment<Face*> aFace;
+	Attachment<Volume*> aVol;
+
+	AttachElementsToThemselves(grid, aVrt);
+	AttachElementsToThemselves(grid, aEdge);
+	AttachElementsToThemselves(grid, aFace);
+	AttachElementsToThemselves(grid, aVol);
+
+	grid.defragment();
+
+	bool ok = CheckDefragmentImpl(grid, aVrt)
+			&& CheckDefragmentImpl(grid, aEdge)
+			&& CheckDefragmentImpl(grid, aFace)
+			&& CheckDefragmentImpl(grid, aVol);
+
+	grid.detach_from<Vertex>(aVrt);
+	grid.detach_from<Edge>(aEdge);
+	grid.detach_from<Face>(aFace);
+	grid.detach_from<Volume>(aVol);
+
+	return ok;
+}
+
 template <class TElem>
 static void CheckMultiGridConsistencyImpl(MultiGrid& mg)
 {
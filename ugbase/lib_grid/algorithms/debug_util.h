@@ -62,6 +62,20 @@ void PrintGridElementNumbers(GridSubsetHandler& sh);
 ///	prints information on all attachments of the specified grid
 void PrintAttachmentInfo(Grid& grid);
 
+///	prints the memory used by attachments and grid objects of the given grid
+/**	For each element type the number of elements, unused data entries and the
+ * memory of the attachment containers is printed. Unused data entries are
+ * released through Grid::compact_memory.
+ * Note that grid objects of all grids share their pools.*/
+void PrintGridMemoryUsage(Grid& grid);
+
+///	defragments the grid and checks that all attached data was kept
+/**	Attaches the element itself to all vertices, edges, faces and volumes,
+ * calls Grid::defragment and checks for each element that its data is
+ * stored at its position in the element order and that its attached value
+ * was moved with it. Returns false and logs the first failure otherwise.*/
+bool CheckDefragment(Grid& grid);
+
 
 
 ///	Returns the center of the given element (SLOW - for debugging only!)
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__grid_from_arrays__
+#define __H__UG__grid_from_arrays__
+
+#include <vector>
+#include "lib_grid/lg_base.h"
+
+namespace ug
+{
+
+///	Creates vertices and elements of type TElem from coordinate and connectivity arrays
+/**	coords has to hold numVrts consecutive tuples of TAAPos::ValueType::Size
+ * coordinates. elemVrtInds has to hold numElems consecutive tuples of
+ * TElem::NUM_VERTICES indices into the new vertices (0 is the first new
+ * vertex).
+ *
+ * Vertices are created after memory for them was reserved and the elements
+ * are created through Grid::create_bulk, which creates their sides in one
+ * pass. The created vertices and elements are appended to vrtsOut and elemsOut
+ * if those are specified.
+ *
+ * Call this method several times to create grids of mixed element types,
+ * passing the vertices of the first call through Grid::create_bulk in the
+ * following ones.*/
+template <class TElem, class TAAPos>
+void CreateGridFromArrays(Grid& grid, TAAPos aaPos,
+						  const number* coords, size_t numVrts,
+						  const int* elemVrtInds, size_t numElems,
+						  std::vector<Vertex*>* vrtsOut = NULL,
+						  std::vector<typename geometry_traits<TElem>::grid_base_object*>*
+						  	elemsOut = NULL)
+{
+	const size_t dim = TAAPos::ValueType::Size;
+
+	std::vector<Vertex*> tmpVrts;
+	std::vector<Vertex*>& allVrts = vrtsOut ? *vrtsOut : tmpVrts;
+	const size_t firstVrt = allVrts.size();
+
+	grid.reserve<Vertex>(grid.num<Vertex>() + numVrts);
+	allVrts.reserve(firstVrt + numVrts);
+	for(size_t i = 0; i < numVrts; ++i){
+		Vertex* vrt = *grid.create<RegularVertex>();
+		for(size_t j = 0; j < dim; ++j)
+			aaPos[vrt][j] = coords[i * dim + j];
+		allVrts.push_back(vrt);
+	}
+
+	if(firstVrt == 0)
+		grid.create_bulk<TElem>(allVrts, elemVrtInds, numElems, elemsOut);
+	else{
+		std::vector<Vertex*> newVrts(allVrts.begin() + firstVrt, allVrts.end());
+		grid.create_bulk<TElem>(newVrts, elemVrtInds, numElems, elemsOut);
+	}
+}
+
+}//	end of namespace
+
+#endif
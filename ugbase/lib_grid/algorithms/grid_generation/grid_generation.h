@@ -33,6 +33,7 @@
 #ifndef __H__LIB_GRID__GRID_GENERATION__
 #define __H__LIB_GRID__GRID_GENERATION__
 
+#include "grid_from_arrays.h"
 #include "icosahedron.h"
 #include "tetrahedralization.h"
 #include "triangle_fill.h"
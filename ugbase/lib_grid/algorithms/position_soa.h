@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+
+#ifndef __H__UG__LIB_GRID__POSITION_SOA__
+#define __H__UG__LIB_GRID__POSITION_SOA__
+
+#include <vector>
+#include "common/allocators/aligned_allocator.h"
+#include "common/math/ugmath_types.h"
+#include "common/error.h"
+#include "lib_grid/grid/grid.h"
+
+namespace ug{
+
+/// \addtogroup lib_grid_algorithms
+/// @{
+
+///	Structure-of-arrays copy of the vertex positions of a grid
+/**	Vertex positions are attached to a grid as an array of structures, i.e.
+ * the coordinates of one vertex are stored next to each other. Kernels which
+ * process the positions of many vertices at once (bounding boxes,
+ * transformations, distance queries, ...) vectorize better if all x, all y and
+ * all z coordinates are stored in separate arrays. PositionSoA holds such a copy.
+ * Each coordinate array is aligned to a cache line.
+ *
+ * Entries are indexed by the data index of the vertices, i.e. the position of
+ * vertex v is found at coord(d)[index(v)]. Call Grid::defragment before
+ * gather, so that the arrays are dense and ordered like the vertices of
+ * the grid.
+ *
+ * The copy is not kept up to date automatically. Call gather after the
+ * positions or the grid have changed and scatter to write modified
+ * coordinates back to the position attachment.
+ */
+template <int dim>
+class PositionSoA
+{
+	public:
+		typedef std::vector<number, AlignedAllocator<number> >	coord_array_t;
+		typedef Attachment<MathVector<dim> >					position_attachment_t;
+
+		PositionSoA()	{}
+
+	///	copies the positions of all vertices of the grid to the coordinate arrays.
+		void gather(Grid& grid, position_attachment_t& aPos)
+		{
+			UG_COND_THROW(!grid.has_vertex_attachment(aPos),
+						  "PositionSoA::gather: position attachment is missing.");
+
+			typename position_attachment_t::ContainerType* cont
+								= grid.get_attachment_data_container<Vertex>(aPos);
+			const size_t num = grid.attachment_container_size<Vertex>();
+
+			for(int d = 0; d < dim; ++d)
+				m_coords[d].resize(num);
+
+			for(size_t i = 0; i < num; ++i){
+				const MathVector<dim>& p = cont->get_elem(i);
+				for(int d = 0; d < dim; ++d)
+					m_coords[d][i] = p[d];
+			}
+		}
+
+	///	writes the coordinate arrays back to the position attachment.
+	/**	The grid may not have been changed since the last call to gather.*/
+		void scatter(Grid& grid, position_attachment_t& aPos) const
+		{
+			UG_COND_THROW(!grid.has_vertex_attachment(aPos),
+						  "PositionSoA::scatter: position attachment is missing.");
+			UG_COND_THROW(grid.attachment_container_size<Vertex>() != size(),
+						  "PositionSoA::scatter: grid was changed since the last gather.");
+
+			typename position_attachment_t::ContainerType* cont
+								= grid.get_attachment_data_container<Vertex>(aPos);
+			const size_t num = size();
+
+			for(size_t i = 0; i < num; ++i){
+				MathVector<dim>& p = cont->get_elem(i);
+				for(int d = 0; d < dim; ++d)
+					p[d] = m_coords[d][i];
+			}
+		}
+
+	///	number of entries in each coordinate array
+		size_t size() const		{return m_coords[0].size();}
+
+	///	index of the given vertex in the coordinate arrays
+		static size_t index(const Vertex* v)	{return v->grid_data_index();}
+
+	///	aligned array of the d-th coordinates
+	/// \{
+		number* coord(int d)
+		{return m_coords[d].empty() ? NULL : &m_coords[d].front();}
+
+		const number* coord(int d) const
+		{return m_coords[d].empty() ? NULL : &m_coords[d].front();}
+	/// \}
+
+		void clear()
+		{
+			for(int d = 0; d < dim; ++d)
+				coord_array_t().swap(m_coords[d]);
+		}
+
+	private:
+		coord_array_t	m_coords[dim];
+};
+
+/// @}
+
+}//	end of namespace
+
+#endif
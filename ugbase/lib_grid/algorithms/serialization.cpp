@@ -31,6 +31,7 @@
  */
 
 #include <cassert>
+#include <cstring>
 #include <vector>
 #include <algorithm>
 #include "serialization.h"
@@ -151,6 +152,40 @@ deserialize(BinaryBuffer& in, GridObjectCollection goc)
 		deserialize(in, goc.begin<Volume>(lvl), goc.end<Volume>(lvl));
 }
 
+void GridDataSerializationHandler::
+serialize_blocks(BinaryBuffer& out,
+				 const std::vector<Vertex*>& vrts,
+				 const std::vector<Edge*>& edges,
+				 const std::vector<Face*>& faces,
+				 const std::vector<Volume*>& vols) const
+{
+	serialize_blocks(out, vrts, m_vrtSerializers);
+	serialize_blocks(out, vrts, m_gridSerializers);
+	serialize_blocks(out, edges, m_edgeSerializers);
+	serialize_blocks(out, edges, m_gridSerializers);
+	serialize_blocks(out, faces, m_faceSerializers);
+	serialize_blocks(out, faces, m_gridSerializers);
+	serialize_blocks(out, vols, m_volSerializers);
+	serialize_blocks(out, vols, m_gridSerializers);
+}
+
+void GridDataSerializationHandler::
+deserialize_blocks(BinaryBuffer& in,
+				   const std::vector<Vertex*>& vrts,
+				   const std::vector<Edge*>& edges,
+				   const std::vector<Face*>& faces,
+				   const std::vector<Volume*>& vols)
+{
+	deserialize_blocks(in, vrts, m_vrtSerializers);
+	deserialize_blocks(in, vrts, m_gridSerializers);
+	deserialize_blocks(in, edges, m_edgeSerializers);
+	deserialize_blocks(in, edges, m_gridSerializers);
+	deserialize_blocks(in, faces, m_faceSerializers);
+	deserialize_blocks(in, faces, m_gridSerializers);
+	deserialize_blocks(in, vols, m_volSerializers);
+	deserialize_blocks(in, vols, m_gridSerializers);
+}
+
 template<class TSerializers>
 void GridDataSerializationHandler::
 deserialization_starts(TSerializers& serializers)
@@ -278,6 +313,82 @@ read_data(BinaryBuffer& in, Volume* o)
 	m_sh.assign_subset(o, si);
 }
 
+template <class TElem>
+void SubsetHandlerSerializer::
+write_subset_indices(BinaryBuffer& out, TElem* const* objs, size_t num) const
+{
+	const size_t pos = out.write_pos();
+	out.reserve(pos + num * sizeof(int));
+	char* buf = out.buffer() + pos;
+	for(size_t i = 0; i < num; ++i, buf += sizeof(int)){
+		const int si = m_sh.get_subset_index(objs[i]);
+		memcpy(buf, &si, sizeof(int));
+	}
+	out.set_write_pos(pos + num * sizeof(int));
+}
+
+template <class TElem>
+void SubsetHandlerSerializer::
+read_subset_indices(BinaryBuffer& in, TElem* const* objs, size_t num)
+{
+	const size_t pos = in.read_pos();
+	const char* buf = in.buffer() + pos;
+	for(size_t i = 0; i < num; ++i, buf += sizeof(int)){
+		int si;
+		memcpy(&si, buf, sizeof(int));
+		m_sh.assign_subset(objs[i], si);
+	}
+	in.set_read_pos(pos + num * sizeof(int));
+}
+
+void SubsetHandlerSerializer::
+write_data_block(BinaryBuffer& out, Vertex* const* objs, size_t num) const
+{
+	write_subset_indices(out, objs, num);
+}
+
+void SubsetHandlerSerializer::
+write_data_block(BinaryBuffer& out, Edge* const* objs, size_t num) const
+{
+	write_subset_indices(out, objs, num);
+}
+
+void SubsetHandlerSerializer::
+write_data_block(BinaryBuffer& out, Face* const* objs, size_t num) const
+{
+	write_subset_indices(out, objs, num);
+}
+
+void SubsetHandlerSerializer::
+write_data_block(BinaryBuffer& out, Volume* const* objs, size_t num) const
+{
+	write_subset_indices(out, objs, num);
+}
+
+void SubsetHandlerSerializer::
+read_data_block(BinaryBuffer& in, Vertex* const* objs, size_t num)
+{
+	read_subset_indices(in, objs, num);
+}
+
+void SubsetHandlerSerializer::
+read_data_block(BinaryBuffer& in, Edge* const* objs, size_t num)
+{
+	read_subset_indices(in, objs, num);
+}
+
+void SubsetHandlerSerializer::
+read_data_block(BinaryBuffer& in, Face* const* objs, size_t num)
+{
+	read_subset_indices(in, objs, num);
+}
+
+void SubsetHandlerSerializer::
+read_data_block(BinaryBuffer& in, Volume* const* objs, size_t num)
+{
+	read_subset_indices(in, objs, num);
+}
+
 
 
 ////////////////////////////////////////////////////////////////////////
@@ -843,6 +954,67 @@ bool DeserializeGridElements(Grid& grid, BinaryBuffer& in,
 
 
 
+////////////////////////////////////////////////////////////////////////
+//	writes a variable length encoding of val. Small values require few bytes.
+static inline void WriteVarUInt(BinaryBuffer& out, uint64_t val)
+{
+	byte buf[10];
+	int num = 0;
+	while(val >= 0x80){
+		buf[num++] = (byte)(val | 0x80);
+		val >>= 7;
+	}
+	buf[num++] = (byte)val;
+	out.write((char*)buf, num);
+}
+
+static inline uint64_t ReadVarUInt(BinaryBuffer& in)
+{
+	uint64_t val = 0;
+	for(int shift = 0;; shift += 7){
+		byte b;
+		in.read((char*)&b, 1);
+		val |= (uint64_t)(b & 0x7F) << shift;
+		if(!(b & 0x80))
+			break;
+	}
+	return val;
+}
+
+////////////////////////////////////////////////////////////////////////
+//	writes the given ids in compressed form.
+/**	Consecutive ids are usually very similar. Only the differences to the
+ * preceding id are thus written through a variable length encoding.*/
+static void WriteCompressedIDs(BinaryBuffer& out, const vector<GeomObjID>& ids)
+{
+	WriteVarUInt(out, ids.size());
+	int64_t prevProc = 0;
+	uint64_t prevInd = 0;
+	for(size_t i = 0; i < ids.size(); ++i){
+	//	zig-zag encoding of the signed differences
+		const int64_t dProc = (int64_t)ids[i].first - prevProc;
+		const int64_t dInd = (int64_t)(ids[i].second - prevInd);
+		WriteVarUInt(out, ((uint64_t)dProc << 1) ^ (uint64_t)(dProc >> 63));
+		WriteVarUInt(out, ((uint64_t)dInd << 1) ^ (uint64_t)(dInd >> 63));
+		prevProc = ids[i].first;
+		prevInd = ids[i].second;
+	}
+}
+
+static void ReadCompressedIDs(BinaryBuffer& in, vector<GeomObjID>& idsOut)
+{
+	idsOut.resize(ReadVarUInt(in));
+	int64_t prevProc = 0;
+	uint64_t prevInd = 0;
+	for(size_t i = 0; i < idsOut.size(); ++i){
+		const uint64_t zProc = ReadVarUInt(in);
+		const uint64_t zInd = ReadVarUInt(in);
+		prevProc += (int64_t)(zProc >> 1) ^ -(int64_t)(zProc & 1);
+		prevInd += (uint64_t)((int64_t)(zInd >> 1) ^ -(int64_t)(zInd & 1));
+		idsOut[i] = GeomObjID((int)prevProc, (size_t)prevInd);
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////
 //	writes the parent of the given element - with type and index
 //	This method relies on the fact, that mg is in marking mode and
@@ -887,6 +1059,19 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 //	first we'll write the header. we have to enable level- and parent-reads
 	WriteGridHeader(GridHeader(GHRO_READ_LEVELS | GHRO_READ_PARENTS), out);
 
+//	global ids are collected during serialization and written in compressed
+//	form behind the grid section. The relative position of the id section
+//	is written in front of the grid section, so that the ids can be read first.
+	vector<GeomObjID> ids;
+	size_t idSectionOffsetPos = 0;
+	if(paaID){
+		ids.reserve(mgoc.num<Vertex>() + mgoc.num<Edge>() + mgoc.num<Face>()
+					+ mgoc.num<Volume>());
+		idSectionOffsetPos = out.write_pos();
+		uint64_t tmp = 0;
+		out.write((char*)&tmp, sizeof(uint64_t));
+	}
+
 //	iterate through the different levels
 	uint numLevels = mgoc.num_levels();
 	int vrtInd = 0;
@@ -921,7 +1106,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				aaInt[*iter] = vrtInd++;
 				mg.mark(*iter);
 				WriteParent(mg, *iter, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[*iter]);
+				if(paaID)	ids.push_back((*paaID)[*iter]);
 			}
 		}
 
@@ -973,7 +1158,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 						   << ElementDebugInfo(mg, v));
 
 				WriteParent(mg, v, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[*iter]);
+				if(paaID)	ids.push_back((*paaID)[*iter]);
 			}
 		}
 
@@ -999,7 +1184,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				out.write((char*)&aaInt[e->vertex(1)], sizeof(int));
 				aaInt[*iter] = edgeInd++;
 				WriteParent(mg, e, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[*iter]);
+				if(paaID)	ids.push_back((*paaID)[*iter]);
 			}
 		}
 
@@ -1043,7 +1228,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				out.write((char*)&tInt, sizeof(int));
 
 				WriteParent(mg, e, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[*iter]);
+				if(paaID)	ids.push_back((*paaID)[*iter]);
 			}
 		}
 
@@ -1064,7 +1249,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				out.write((char*)&aaInt[e->vertex(1)], sizeof(int));
 				aaInt[*iter] = edgeInd++;
 				WriteParent(mg, e, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[*iter]);
+				if(paaID)	ids.push_back((*paaID)[*iter]);
 			}
 		}
 
@@ -1087,7 +1272,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				out.write((char*)&aaInt[t->vertex(2)], sizeof(int));
 				aaInt[*iter] = faceInd++;
 				WriteParent(mg, t, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[*iter]);
+				if(paaID)	ids.push_back((*paaID)[*iter]);
 			}
 		}
 
@@ -1109,7 +1294,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				out.write((char*)&aaInt[q->vertex(3)], sizeof(int));
 				aaInt[*iter] = faceInd++;
 				WriteParent(mg, q, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[*iter]);
+				if(paaID)	ids.push_back((*paaID)[*iter]);
 			}
 		}
 	
@@ -1147,7 +1332,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				out.write((char*)&tInt, sizeof(int));
 
 				WriteParent(mg, e, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[e]);
+				if(paaID)	ids.push_back((*paaID)[e]);
 			}
 		}
 
@@ -1186,7 +1371,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				out.write((char*)&tInt, sizeof(int));
 
 				WriteParent(mg, e, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[e]);
+				if(paaID)	ids.push_back((*paaID)[e]);
 			}
 		}
 
@@ -1207,7 +1392,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				out.write((char*)&aaInt[e->vertex(2)], sizeof(int));
 				aaInt[e] = faceInd++;
 				WriteParent(mg, e, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[e]);
+				if(paaID)	ids.push_back((*paaID)[e]);
 			}
 		}
 
@@ -1229,7 +1414,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				out.write((char*)&aaInt[e->vertex(3)], sizeof(int));
 				aaInt[e] = faceInd++;
 				WriteParent(mg, e, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[e]);
+				if(paaID)	ids.push_back((*paaID)[e]);
 			}
 		}
 
@@ -1253,7 +1438,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				out.write((char*)&aaInt[t->vertex(3)], sizeof(int));
 				aaInt[*iter] = volInd++;
 				WriteParent(mg, t, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[*iter]);
+				if(paaID)	ids.push_back((*paaID)[*iter]);
 			}
 		}
 		
@@ -1279,7 +1464,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				out.write((char*)&aaInt[h->vertex(7)], sizeof(int));
 				aaInt[*iter] = volInd++;
 				WriteParent(mg, h, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[*iter]);
+				if(paaID)	ids.push_back((*paaID)[*iter]);
 			}
 		}
 		
@@ -1303,7 +1488,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				out.write((char*)&aaInt[p->vertex(5)], sizeof(int));
 				aaInt[*iter] = volInd++;
 				WriteParent(mg, p, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[*iter]);
+				if(paaID)	ids.push_back((*paaID)[*iter]);
 			}
 		}
 		
@@ -1326,7 +1511,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				out.write((char*)&aaInt[p->vertex(4)], sizeof(int));
 				aaInt[*iter] = volInd++;
 				WriteParent(mg, p, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[*iter]);
+				if(paaID)	ids.push_back((*paaID)[*iter]);
 			}
 		}
 
@@ -1350,7 +1535,7 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 				out.write((char*)&aaInt[p->vertex(5)], sizeof(int));
 				aaInt[*iter] = volInd++;
 				WriteParent(mg, p, aaInt, out);
-				if(paaID)	Serialize(out, (*paaID)[*iter]);
+				if(paaID)	ids.push_back((*paaID)[*iter]);
 			}
 		}
 	}
@@ -1361,6 +1546,15 @@ bool SerializeMultiGridElements(MultiGrid& mg,
 	tInt = GSID_END_OF_GRID;
 	out.write((char*)&tInt, sizeof(int));
 
+	if(paaID){
+		const size_t idSectionPos = out.write_pos();
+		const uint64_t offset = idSectionPos - (idSectionOffsetPos + sizeof(uint64_t));
+		out.set_write_pos(idSectionOffsetPos);
+		out.write((char*)&offset, sizeof(uint64_t));
+		out.set_write_pos(idSectionPos);
+		WriteCompressedIDs(out, ids);
+	}
+
 	return true;
 }
 
@@ -1483,6 +1677,21 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 
 	GeomObjID id;
 
+//	the global ids are stored in compressed form behind the grid section.
+//	We read them first and continue with the grid section afterwards.
+	vector<GeomObjID> ids;
+	size_t idInd = 0;
+	size_t idSectionEndPos = 0;
+	if(paaID){
+		uint64_t offset;
+		in.read((char*)&offset, sizeof(uint64_t));
+		const size_t gridSectionPos = in.read_pos();
+		in.set_read_pos(gridSectionPos + offset);
+		ReadCompressedIDs(in, ids);
+		idSectionEndPos = in.read_pos();
+		in.set_read_pos(gridSectionPos);
+	}
+
 	SRLZ_PROFILE(srlz_settingUpHashes);
 //	create hashes for existing geometric objects
 	Hash<GeomObjID, Vertex*>	vrtHash((int)(1.1f * (float)mg.num<Vertex>()));
@@ -1554,7 +1763,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Vertex* oldVrt;
 								if(vrtHash.get_entry(oldVrt, id)){
 									assert(dynamic_cast<RegularVertex*>(oldVrt));
@@ -1608,7 +1817,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Vertex* oldVrt;
 								if(vrtHash.get_entry(oldVrt, id)){
 									assert(dynamic_cast<ConstrainedVertex*>(oldVrt));
@@ -1688,7 +1897,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Edge* oldEdge;
 								if(edgeHash.get_entry(oldEdge, id)){
 									assert(dynamic_cast<RegularEdge*>(oldEdge));
@@ -1726,7 +1935,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Edge* oldEdge;
 								if(edgeHash.get_entry(oldEdge, id)){
 									assert(dynamic_cast<ConstrainingEdge*>(oldEdge));
@@ -1772,7 +1981,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Edge* oldEdge;
 								if(edgeHash.get_entry(oldEdge, id)){
 									assert(dynamic_cast<ConstrainedEdge*>(oldEdge));
@@ -1856,7 +2065,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Face* oldFace;
 								if(faceHash.get_entry(oldFace, id)){
 									assert(dynamic_cast<Triangle*>(oldFace));
@@ -1899,7 +2108,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Face* oldFace;
 								if(faceHash.get_entry(oldFace, id)){
 									assert(dynamic_cast<Quadrilateral*>(oldFace));
@@ -1942,7 +2151,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Face* oldFace;
 								if(faceHash.get_entry(oldFace, id)){
 									assert(dynamic_cast<ConstrainingFace*>(oldFace));
@@ -1990,7 +2199,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Face* oldFace;
 								if(faceHash.get_entry(oldFace, id)){
 									assert(dynamic_cast<ConstrainedFace*>(oldFace));
@@ -2053,7 +2262,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Face* oldFace;
 								if(faceHash.get_entry(oldFace, id)){
 									assert(dynamic_cast<ConstrainingFace*>(oldFace));
@@ -2105,7 +2314,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Face* oldFace;
 								if(faceHash.get_entry(oldFace, id)){
 									UG_ASSERT(dynamic_cast<ConstrainedFace*>(oldFace),
@@ -2171,7 +2380,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Volume* oldVol;
 								if(volHash.get_entry(oldVol, id)){
 									assert(dynamic_cast<Tetrahedron*>(oldVol));
@@ -2220,7 +2429,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Volume* oldVol;
 								if(volHash.get_entry(oldVol, id)){
 									assert(dynamic_cast<Hexahedron*>(oldVol));
@@ -2267,7 +2476,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Volume* oldVol;
 								if(volHash.get_entry(oldVol, id)){
 									assert(dynamic_cast<Prism*>(oldVol));
@@ -2313,7 +2522,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Volume* oldVol;
 								if(volHash.get_entry(oldVol, id)){
 									assert(dynamic_cast<Pyramid*>(oldVol));
@@ -2359,7 +2568,7 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 							GridObject* parent = pInfo.first;
 
 							if(paaID){
-								Deserialize(in, id);
+								id = ids[idInd++];
 								Volume* oldVol;
 								if(volHash.get_entry(oldVol, id)){
 									assert(dynamic_cast<Pyramid*>(oldVol));
@@ -2394,6 +2603,10 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 		}
 	}
 
+//	continue behind the id section
+	if(paaID)
+		in.set_read_pos(idSectionEndPos);
+
 	return true;
 }
 
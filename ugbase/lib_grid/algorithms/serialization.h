@@ -34,8 +34,11 @@
 #define __H__LIB_GRID__SERIALIZATION__
 
 #include <iostream>
+#include <cstring>
+#include <boost/type_traits/is_arithmetic.hpp>
 #include "common/util/smart_pointer.h"
 #include "common/util/binary_buffer.h"
+#include "common/util/metaprogramming_util.h"
 #include "common/serialization.h"
 #include "lib_grid/grid_objects/grid_objects.h"
 #include "lib_grid/tools/subset_handler_interface.h"
@@ -99,6 +102,20 @@ class GeomObjDataSerializer
 	///	read data associated with the given object. Pure virtual.
 		virtual void read_data(BinaryBuffer& in, TGeomObj* o) = 0;
 
+	///	write data associated with the given objects.
+	/**	The default implementation calls write_data for each object.
+	 * Specializations may write the data of all objects at once.
+	 * Data written by this method has to be read through read_data_block.*/
+		virtual void write_data_block(BinaryBuffer& out, TGeomObj* const* objs,
+									  size_t num) const
+		{for(size_t i = 0; i < num; ++i) write_data(out, objs[i]);}
+
+	///	read data associated with the given objects.
+	/**	The default implementation calls read_data for each object.*/
+		virtual void read_data_block(BinaryBuffer& in, TGeomObj* const* objs,
+									 size_t num)
+		{for(size_t i = 0; i < num; ++i) read_data(in, objs[i]);}
+
 	///	this method is called after read_info has been called for all geometric objects.
 		virtual void deserialization_starts()					{}
 
@@ -157,6 +174,33 @@ class GridDataSerializer
 		virtual void read_data(BinaryBuffer& in, Face* o)		{}
 		virtual void read_data(BinaryBuffer& in, Volume* o)		{}
 
+	///	write data associated with the given objects.
+	/**	The default implementations call write_data for each object.
+	 * Data written by these methods has to be read through read_data_block.
+	 * \{ */
+		virtual void write_data_block(BinaryBuffer& out, Vertex* const* objs, size_t num) const
+		{for(size_t i = 0; i < num; ++i) write_data(out, objs[i]);}
+		virtual void write_data_block(BinaryBuffer& out, Edge* const* objs, size_t num) const
+		{for(size_t i = 0; i < num; ++i) write_data(out, objs[i]);}
+		virtual void write_data_block(BinaryBuffer& out, Face* const* objs, size_t num) const
+		{for(size_t i = 0; i < num; ++i) write_data(out, objs[i]);}
+		virtual void write_data_block(BinaryBuffer& out, Volume* const* objs, size_t num) const
+		{for(size_t i = 0; i < num; ++i) write_data(out, objs[i]);}
+	/**	\} */
+
+	///	read data associated with the given objects.
+	/**	The default implementations call read_data for each object.
+	 * \{ */
+		virtual void read_data_block(BinaryBuffer& in, Vertex* const* objs, size_t num)
+		{for(size_t i = 0; i < num; ++i) read_data(in, objs[i]);}
+		virtual void read_data_block(BinaryBuffer& in, Edge* const* objs, size_t num)
+		{for(size_t i = 0; i < num; ++i) read_data(in, objs[i]);}
+		virtual void read_data_block(BinaryBuffer& in, Face* const* objs, size_t num)
+		{for(size_t i = 0; i < num; ++i) read_data(in, objs[i]);}
+		virtual void read_data_block(BinaryBuffer& in, Volume* const* objs, size_t num)
+		{for(size_t i = 0; i < num; ++i) read_data(in, objs[i]);}
+	/**	\} */
+
 	///	this method is called after read_info has been called for all geometric objects.
 		virtual void deserialization_starts()					{}
 
@@ -237,6 +281,27 @@ class GridDataSerializationHandler
 	///	Calls deserialize on all elements in the given geometric object collection
 		void deserialize(BinaryBuffer& in, GridObjectCollection goc);
 
+	///	Serializes the data of the given elements serializer by serializer
+	/**	In contrast to the element-wise serialize methods, each serializer
+	 * writes the data of all given elements of a type at once
+	 * (see GeomObjDataSerializer::write_data_block). This allows to pack
+	 * the values of plain attachments through single memory copies.
+	 * Data written by this method has to be read through deserialize_blocks.*/
+		void serialize_blocks(BinaryBuffer& out,
+							  const std::vector<Vertex*>& vrts,
+							  const std::vector<Edge*>& edges,
+							  const std::vector<Face*>& faces,
+							  const std::vector<Volume*>& vols) const;
+
+	///	Deserializes data written through serialize_blocks
+	/**	The given elements have to correspond to the elements which were
+	 * passed to serialize_blocks.*/
+		void deserialize_blocks(BinaryBuffer& in,
+								const std::vector<Vertex*>& vrts,
+								const std::vector<Edge*>& edges,
+								const std::vector<Face*>& faces,
+								const std::vector<Volume*>& vols);
+
 	///	this method will be called before read_infos is called for the first time
 	///	in a deserialization run.
 		void deserialization_starts();
@@ -246,6 +311,16 @@ class GridDataSerializationHandler
 		void deserialization_done();
 
 	private:
+	///	performs block-wise serialization on all given serializers.
+		template<class TGeomObj, class TSerializers>
+		void serialize_blocks(BinaryBuffer& out, const std::vector<TGeomObj*>& objs,
+							  TSerializers& serializers) const;
+
+	///	performs block-wise deserialization on all given deserializers.
+		template<class TGeomObj, class TDeserializers>
+		void deserialize_blocks(BinaryBuffer& in, const std::vector<TGeomObj*>& objs,
+								TDeserializers& deserializers);
+
 	///	performs serialization on all given serializers.
 		template<class TGeomObj, class TSerializers>
 		void serialize(BinaryBuffer& out, TGeomObj* o,
@@ -277,6 +352,28 @@ class GridDataSerializationHandler
 };
 
 
+////////////////////////////////////////////////////////////////////////
+///	Specifies whether values of type T may be serialized through plain memory copies
+/**	This is the case for arithmetic types (except for bool, whose attachments
+ * are stored in bit-vectors) and for MathVectors of arithmetic types.
+ * GeomObjAttachmentSerializer packs the values of such attachments
+ * block-wise through memcpy. Specialize the template for further trivially
+ * copyable types if required.*/
+template <class T>
+struct block_serialization_traits{
+	enum{bulk_copy = boost::is_arithmetic<T>::value};
+};
+
+template <>
+struct block_serialization_traits<bool>{
+	enum{bulk_copy = false};
+};
+
+template <std::size_t N, class T>
+struct block_serialization_traits<MathVector<N, T> >{
+	enum{bulk_copy = boost::is_arithmetic<T>::value};
+};
+
 ////////////////////////////////////////////////////////////////////////
 ///	Serialization callback for grid attachments
 /**	template class where TGeomObj should be one of the
@@ -304,7 +401,51 @@ class GeomObjAttachmentSerializer :
 		virtual void read_data(BinaryBuffer& in, TGeomObj* o)
 		{Deserialize(in, m_aa[o]);}
 
+		virtual void write_data_block(BinaryBuffer& out, TGeomObj* const* objs,
+									  size_t num) const
+		{write_block(out, objs, num, Int2Type<block_serialization_traits<value_t>::bulk_copy>());}
+
+		virtual void read_data_block(BinaryBuffer& in, TGeomObj* const* objs,
+									 size_t num)
+		{read_block(in, objs, num, Int2Type<block_serialization_traits<value_t>::bulk_copy>());}
+
 	private:
+		typedef typename TAttachment::ValueType	value_t;
+
+		void write_block(BinaryBuffer& out, TGeomObj* const* objs, size_t num,
+						 Int2Type<false>) const
+		{for(size_t i = 0; i < num; ++i) Serialize(out, m_aa[objs[i]]);}
+
+		void read_block(BinaryBuffer& in, TGeomObj* const* objs, size_t num,
+						Int2Type<false>)
+		{for(size_t i = 0; i < num; ++i) Deserialize(in, m_aa[objs[i]]);}
+
+	///	copies the values directly into the buffer
+		void write_block(BinaryBuffer& out, TGeomObj* const* objs, size_t num,
+						 Int2Type<true>) const
+		{
+			const size_t pos = out.write_pos();
+			out.reserve(pos + num * sizeof(value_t));
+			char* buf = out.buffer() + pos;
+			for(size_t i = 0; i < num; ++i, buf += sizeof(value_t))
+				memcpy(buf, &m_aa[objs[i]], sizeof(value_t));
+			out.set_write_pos(pos + num * sizeof(value_t));
+		}
+
+	///	copies the values directly from the buffer
+		void read_block(BinaryBuffer& in, TGeomObj* const* objs, size_t num,
+						Int2Type<true>)
+		{
+			const size_t pos = in.read_pos();
+			const char* buf = in.buffer() + pos;
+			value_t tmp;
+			for(size_t i = 0; i < num; ++i, buf += sizeof(value_t)){
+				memcpy(static_cast<void*>(&tmp), buf, sizeof(value_t));
+				m_aa[objs[i]] = tmp;
+			}
+			in.set_read_pos(pos + num * sizeof(value_t));
+		}
+
 		Grid::AttachmentAccessor<TGeomObj, TAttachment>	m_aa;
 };
 
@@ -332,7 +473,23 @@ class SubsetHandlerSerializer : public GridDataSerializer
 		virtual void read_data(BinaryBuffer& in, Face* o);
 		virtual void read_data(BinaryBuffer& in, Volume* o);
 
+		virtual void write_data_block(BinaryBuffer& out, Vertex* const* objs, size_t num) const;
+		virtual void write_data_block(BinaryBuffer& out, Edge* const* objs, size_t num) const;
+		virtual void write_data_block(BinaryBuffer& out, Face* const* objs, size_t num) const;
+		virtual void write_data_block(BinaryBuffer& out, Volume* const* objs, size_t num) const;
+
+		virtual void read_data_block(BinaryBuffer& in, Vertex* const* objs, size_t num);
+		virtual void read_data_block(BinaryBuffer& in, Edge* const* objs, size_t num);
+		virtual void read_data_block(BinaryBuffer& in, Face* const* objs, size_t num);
+		virtual void read_data_block(BinaryBuffer& in, Volume* const* objs, size_t num);
+
 	private:
+		template <class TElem>
+		void write_subset_indices(BinaryBuffer& out, TElem* const* objs, size_t num) const;
+
+		template <class TElem>
+		void read_subset_indices(BinaryBuffer& in, TElem* const* objs, size_t num);
+
 		ISubsetHandler& m_sh;
 };
 
@@ -429,6 +586,8 @@ bool DeserializeGridElements(Grid& grid, BinaryBuffer& in,
  * Optionally an accessor to global ids in mg can be specified through paaID.
  * Those ids have to be attached and correctly set before the method is called.
  * If you specify those ids, they are serialized together with the grid elements.
+ * The ids are stored in a compressed section behind the grid elements (only
+ * differences to preceding ids are written through a variable length encoding).
  * Make sure to pass a corresponding id-accessor on a call to deserialize.
  *
  * After termination the attachments hold the indices that were
@@ -492,6 +651,15 @@ bool DeserializeMultiGridElements(MultiGrid& mg, BinaryBuffer& in,
 									std::vector<Volume*>* pvVols = NULL,
 									MultiElementAttachmentAccessor<AGeomObjID>* paaID = NULL);
 
+////////////////////////////////////////////////////////////////////////
+///	Collects the elements of goc in the order in which they are serialized
+/**	The order matches the order of the elements which are returned by
+ * DeserializeMultiGridElements, if goc was serialized through
+ * SerializeMultiGridElements.*/
+template <class TElem>
+void CollectSerializedElements(std::vector<TElem*>& elemsOut,
+							   GridObjectCollection goc);
+
 
 
 ////////////////////////////////////////////////////////////////////////
@@ -88,6 +88,19 @@ serialize(BinaryBuffer& out, TGeomObj* o,
 }
 
 
+template<class TGeomObj, class TSerializers>
+void GridDataSerializationHandler::
+serialize_blocks(BinaryBuffer& out, const std::vector<TGeomObj*>& objs,
+				 TSerializers& serializers) const
+{
+	if(objs.empty())
+		return;
+	for(size_t i = 0; i < serializers.size(); ++i){
+		serializers[i]->write_data_block(out, &objs.front(), objs.size());
+	}
+}
+
+
 ////////////////////////////////////////////////////////////////////////
 inline void GridDataSerializationHandler::
 deserialize(BinaryBuffer& in, Vertex* vrt)
@@ -137,6 +150,19 @@ deserialize(BinaryBuffer& in, TGeomObj* o,
 }
 
 
+template<class TGeomObj, class TDeserializers>
+void GridDataSerializationHandler::
+deserialize_blocks(BinaryBuffer& in, const std::vector<TGeomObj*>& objs,
+				   TDeserializers& deserializers)
+{
+	if(objs.empty())
+		return;
+	for(size_t i = 0; i < deserializers.size(); ++i){
+		deserializers[i]->read_data_block(in, &objs.front(), objs.size());
+	}
+}
+
+
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 //	SerializeAttachment
@@ -246,6 +272,21 @@ bool DeserializeAttachment(Grid& grid, TAttachment& attachment,
 
 	return true;
 }
+
+template <class TElem>
+void CollectSerializedElements(std::vector<TElem*>& elemsOut,
+							   GridObjectCollection goc)
+{
+	elemsOut.clear();
+	for(size_t lvl = 0; lvl < goc.num_levels(); ++lvl){
+		for(typename geometry_traits<TElem>::iterator iter = goc.begin<TElem>(lvl);
+			iter != goc.end<TElem>(lvl); ++iter)
+		{
+			elemsOut.push_back(*iter);
+		}
+	}
+}
+
 }
 
 #endif
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+
+#ifndef __H__UG__LIB_GRID__SPACE_FILLING_CURVE_UTIL__
+#define __H__UG__LIB_GRID__SPACE_FILLING_CURVE_UTIL__
+
+#include <string>
+#include <vector>
+#include "common/types.h"
+#include "lib_grid/grid/grid.h"
+#include "lib_grid/tools/subset_handler_interface.h"
+
+namespace ug{
+
+/// \addtogroup lib_grid_algorithms
+/// @{
+
+///	Space filling curves along which points and elements can be ordered
+enum SFCType{
+	SFC_MORTON,		///< Morton (or z-) order. Cheap to compute.
+	SFC_HILBERT		///< Hilbert order. Consecutive indices are always neighbors.
+};
+
+///	returns the curve for the given name ("morton" or "hilbert"). Throws otherwise.
+UG_API SFCType StringToSFCType(const std::string& name);
+
+///	returns the name of the given curve
+UG_API const char* SFCTypeToString(SFCType type);
+
+///	position of the cell with the given integer coordinates along a Morton curve
+/**	Each coordinate may use at most bitsPerDim bits, where bitsPerDim * dim <= 64.*/
+template <int dim>
+uint64 MortonIndex(const uint64 (&coords)[dim], int bitsPerDim);
+
+///	position of the cell with the given integer coordinates along a Hilbert curve
+/**	Each coordinate may use at most bitsPerDim bits, where bitsPerDim * dim <= 64.
+ * Uses the transposition algorithm by J. Skilling, "Programming the Hilbert
+ * curve", AIP Conf. Proc. 707 (2004).*/
+template <int dim>
+uint64 HilbertIndex(const uint64 (&coords)[dim], int bitsPerDim);
+
+///	position of a point in the given box along the given curve
+/**	The box is subdivided into 2^(64/dim) cells in each direction.
+ * Points outside the box are clamped to its boundary.
+ * vector_t has to be a MathVector.*/
+template <class vector_t>
+uint64 SFCIndex(SFCType type, const vector_t& p,
+				const vector_t& boxMin, const vector_t& boxMax);
+
+///	sorts the given elements along a space filling curve through their centers
+/**	The relative order of elements with the same index is preserved.
+ * TAAPos has to be a vertex attachment accessor to MathVector positions.*/
+template <class TElem, class TAAPos>
+void SortElementsAlongSFC(std::vector<TElem*>& elems, TAAPos aaPos,
+						  SFCType type,
+						  const typename TAAPos::ValueType& boxMin,
+						  const typename TAAPos::ValueType& boxMax);
+
+///	reorders the elements of a grid along a space filling curve
+/**	Afterwards the vertices, edges, faces and volumes of the grid (and of each
+ * level, if grid is a MultiGrid) are iterated along the given curve through
+ * their centers. Elements in the given subset handlers are reordered, too.
+ * Elements which are close to each other in space are thus processed close
+ * to each other in time during element loops, which improves cache reuse.
+ *
+ * If defragment is true, Grid::defragment is called afterwards, so that
+ * attached data (e.g. vertex positions) is stored in the same order.
+ *
+ * TAAPos has to be a vertex attachment accessor to MathVector positions.*/
+template <class TAAPos>
+void OrderElementsAlongSFC(Grid& grid, TAAPos aaPos, SFCType type,
+						   const std::vector<ISubsetHandler*>& vSH
+								= std::vector<ISubsetHandler*>(),
+						   bool defragment = true);
+
+/// @}
+
+}//	end of namespace
+
+////////////////////////////////////////
+//	include implementation
+#include "space_filling_curve_util_impl.h"
+
+#endif
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+
+#ifndef __H__UG__LIB_GRID__SPACE_FILLING_CURVE_UTIL_IMPL__
+#define __H__UG__LIB_GRID__SPACE_FILLING_CURVE_UTIL_IMPL__
+
+#include <algorithm>
+#include <utility>
+#include "space_filling_curve_util.h"
+#include "common/error.h"
+#include "lib_grid/multi_grid.h"
+#include "lib_grid/algorithms/geom_obj_util/geom_obj_util.h"
+
+namespace ug{
+
+template <int dim>
+uint64 MortonIndex(const uint64 (&coords)[dim], int bitsPerDim)
+{
+	uint64 ind = 0;
+	for(int b = bitsPerDim - 1; b >= 0; --b){
+		for(int d = dim - 1; d >= 0; --d)
+			ind = (ind << 1) | ((coords[d] >> b) & 1);
+	}
+	return ind;
+}
+
+template <int dim>
+uint64 HilbertIndex(const uint64 (&coords)[dim], int bitsPerDim)
+{
+	if(dim == 1)
+		return coords[0];
+
+	uint64 x[dim];
+	for(int d = 0; d < dim; ++d)
+		x[d] = coords[d];
+
+//	inverse undo
+	const uint64 m = (uint64)1 << (bitsPerDim - 1);
+	for(uint64 q = m; q > 1; q >>= 1){
+		const uint64 p = q - 1;
+		for(int d = 0; d < dim; ++d){
+			if(x[d] & q)
+				x[0] ^= p;
+			else{
+				const uint64 t = (x[0] ^ x[d]) & p;
+				x[0] ^= t;
+				x[d] ^= t;
+			}
+		}
+	}
+
+//	gray encode
+	for(int d = 1; d < dim; ++d)
+		x[d] ^= x[d-1];
+
+	uint64 t = 0;
+	for(uint64 q = m; q > 1; q >>= 1){
+		if(x[dim-1] & q)
+			t ^= q - 1;
+	}
+	for(int d = 0; d < dim; ++d)
+		x[d] ^= t;
+
+//	the transposed index is read bitwise, starting with the highest bits
+	uint64 ind = 0;
+	for(int b = bitsPerDim - 1; b >= 0; --b){
+		for(int d = 0; d < dim; ++d)
+			ind = (ind << 1) | ((x[d] >> b) & 1);
+	}
+	return ind;
+}
+
+template <class vector_t>
+uint64 SFCIndex(SFCType type, const vector_t& p,
+				const vector_t& boxMin, const vector_t& boxMax)
+{
+	static const int dim = (int)vector_t::Size;
+	static const int bitsPerDim = (64 / dim < 63) ? 64 / dim : 63;
+	const uint64 maxCoord = ((uint64)1 << bitsPerDim) - 1;
+
+	uint64 coords[dim];
+	for(int d = 0; d < dim; ++d){
+		const number w = boxMax[d] - boxMin[d];
+		number s = 0;
+		if(w > 0)
+			s = (p[d] - boxMin[d]) / w;
+		if(s <= 0)
+			coords[d] = 0;
+		else if(s >= 1)
+			coords[d] = maxCoord;
+		else
+			coords[d] = std::min<uint64>((uint64)(s * (number)maxCoord), maxCoord);
+	}
+
+	switch(type){
+		case SFC_MORTON:	return MortonIndex<dim>(coords, bitsPerDim);
+		case SFC_HILBERT:	return HilbertIndex<dim>(coords, bitsPerDim);
+		default:
+			UG_THROW("SFCIndex: Unknown space filling curve: " << type);
+	}
+}
+
+
+namespace sfc_detail{
+template <class TElem>
+struct CompareSFCIndex{
+	bool operator()(const std::pair<uint64, TElem*>& e1,
+					const std::pair<uint64, TElem*>& e2) const
+	{return e1.first < e2.first;}
+};
+}//	end of namespace
+
+template <class TElem, class TAAPos>
+void SortElementsAlongSFC(std::vector<TElem*>& elems, TAAPos aaPos,
+						  SFCType type,
+						  const typename TAAPos::ValueType& boxMin,
+						  const typename TAAPos::ValueType& boxMax)
+{
+	std::vector<std::pair<uint64, TElem*> > vInds(elems.size());
+	for(size_t i = 0; i < elems.size(); ++i){
+		vInds[i].first = SFCIndex(type, CalculateCenter(elems[i], aaPos),
+								  boxMin, boxMax);
+		vInds[i].second = elems[i];
+	}
+
+	std::stable_sort(vInds.begin(), vInds.end(),
+					 sfc_detail::CompareSFCIndex<TElem>());
+
+	for(size_t i = 0; i < vInds.size(); ++i)
+		elems[i] = vInds[i].second;
+}
+
+
+namespace sfc_detail{
+template <class TElem, class TAAPos>
+void OrderElementsAlongSFC(Grid& grid, TAAPos aaPos, SFCType type,
+								  const std::vector<ISubsetHandler*>& vSH,
+								  const typename TAAPos::ValueType& boxMin,
+								  const typename TAAPos::ValueType& boxMax)
+{
+	if(grid.num<TElem>() == 0)
+		return;
+
+	std::vector<TElem*> elems;
+	elems.reserve(grid.num<TElem>());
+	for(typename Grid::traits<TElem>::iterator iter = grid.begin<TElem>();
+		iter != grid.end<TElem>(); ++iter)
+	{
+		elems.push_back(*iter);
+	}
+
+	SortElementsAlongSFC(elems, aaPos, type, boxMin, boxMax);
+
+	MultiGrid* mg = dynamic_cast<MultiGrid*>(&grid);
+	if(mg)
+		mg->reorder_elements(elems);
+	else
+		grid.reorder_elements(elems);
+
+	for(size_t i = 0; i < vSH.size(); ++i)
+		vSH[i]->reorder_elements(elems);
+}
+}//	end of namespace
+
+template <class TAAPos>
+void OrderElementsAlongSFC(Grid& grid, TAAPos aaPos, SFCType type,
+						   const std::vector<ISubsetHandler*>& vSH,
+						   bool defragment)
+{
+	typedef typename TAAPos::ValueType	vector_t;
+
+	if(grid.num_vertices() == 0)
+		return;
+
+	vector_t boxMin = aaPos[*grid.vertices_begin()];
+	vector_t boxMax = boxMin;
+	for(VertexIterator iter = grid.vertices_begin();
+		iter != grid.vertices_end(); ++iter)
+	{
+		const vector_t& p = aaPos[*iter];
+		for(size_t d = 0; d < vector_t::Size; ++d){
+			boxMin[d] = std::min(boxMin[d], p[d]);
+			boxMax[d] = std::max(boxMax[d], p[d]);
+		}
+	}
+
+	sfc_detail::OrderElementsAlongSFC<Vertex>(grid, aaPos, type, vSH, boxMin, boxMax);
+	sfc_detail::OrderElementsAlongSFC<Edge>(grid, aaPos, type, vSH, boxMin, boxMax);
+	sfc_detail::OrderElementsAlongSFC<Face>(grid, aaPos, type, vSH, boxMin, boxMax);
+	sfc_detail::OrderElementsAlongSFC<Volume>(grid, aaPos, type, vSH, boxMin, boxMax);
+
+	if(defragment)
+		grid.defragment();
+}
+
+}//	end of namespace
+
+#endif
@@ -30,8 +30,10 @@
  * GNU Lesser General Public License for more details.
  */
 
+#include <vector>
 #include "check_associated_elements.h"
 #include "lib_grid/grid/grid_util.h"
+#include "lib_grid/algorithms/attachment_util.h"
 
 namespace ug{
 namespace grid_unit_tests{
@@ -148,5 +150,157 @@ void CheckAssociatedVolumesOfEdges(Grid& g)
 	g.end_marking();
 }
 
+
+///	creates the volumes of type TElem of src in dest, one by one or in one batch
+template <class TElem>
+static void CopyVolumes(Grid& dest, const std::vector<Vertex*>& vrts, Grid& src,
+						Grid::VertexAttachmentAccessor<AInt>& aaIndSrc, bool bulk)
+{
+	typedef typename geometry_traits<TElem>::iterator iterator;
+	const size_t numVrts = TElem::NUM_VERTICES;
+
+	std::vector<int> inds;
+	for(iterator iter = src.begin<TElem>(); iter != src.end<TElem>(); ++iter){
+		for(size_t i = 0; i < numVrts; ++i)
+			inds.push_back(aaIndSrc[(*iter)->vertex(i)]);
+	}
+
+	if(inds.empty())
+		return;
+
+	if(bulk){
+		dest.create_bulk<TElem>(vrts, &inds.front(), inds.size() / numVrts);
+		return;
+	}
+
+	VolumeDescriptor vd(numVrts);
+	for(size_t i = 0; i < inds.size(); i += numVrts){
+		for(size_t j = 0; j < numVrts; ++j)
+			vd.set_vertex(j, vrts[inds[i + j]]);
+		dest.create<TElem>(typename geometry_traits<TElem>::Descriptor(vd));
+	}
+}
+
+///	creates the volumes of src in a grid with full interconnection
+static void CopyVolumes(Grid& dest, Grid& src, bool bulk)
+{
+	AInt aInd;
+	src.attach_to_vertices(aInd);
+	Grid::VertexAttachmentAccessor<AInt> aaInd(src, aInd);
+	AssignIndices(src.vertices_begin(), src.vertices_end(), aaInd);
+
+	dest.set_options(GRIDOPT_FULL_INTERCONNECTION);
+	std::vector<Vertex*> vrts;
+	vrts.reserve(src.num_vertices());
+	for(size_t i = 0; i < src.num_vertices(); ++i)
+		vrts.push_back(*dest.create<RegularVertex>());
+
+	CopyVolumes<Tetrahedron>(dest, vrts, src, aaInd, bulk);
+	CopyVolumes<Pyramid>(dest, vrts, src, aaInd, bulk);
+	CopyVolumes<Prism>(dest, vrts, src, aaInd, bulk);
+	CopyVolumes<Hexahedron>(dest, vrts, src, aaInd, bulk);
+	CopyVolumes<Octahedron>(dest, vrts, src, aaInd, bulk);
+
+	src.detach_from_vertices(aInd);
+}
+
+///	compares the associated elements of type TAss of e1 in g1 and e2 in g2 by their data indices
+template <class TElem, class TAss>
+static void CompareAssociated(Grid& g1, TElem* e1, Grid& g2, TElem* e2)
+{
+	typename Grid::traits<TAss>::secure_container ass1, ass2;
+	g1.associated_elements(ass1, e1);
+	g2.associated_elements(ass2, e2);
+
+	if(ass1.size() != ass2.size()){
+		UG_THROW("Different numbers of associated elements in bulk created grid!");
+	}
+
+	for(size_t i = 0; i < ass1.size(); ++i){
+		if(g1.get_attachment_data_index(ass1[i])
+		   != g2.get_attachment_data_index(ass2[i]))
+		{
+			UG_THROW("Different associated elements in bulk created grid!");
+		}
+	}
+}
+
+///	compares the elements of type TElem of g1 and g2 and their associated elements
+template <class TElem>
+static void CompareElements(Grid& g1, Grid& g2)
+{
+	typedef typename geometry_traits<TElem>::iterator iterator;
+
+	if(g1.num<TElem>() != g2.num<TElem>()){
+		UG_THROW("Different numbers of elements in bulk created grid!");
+	}
+
+	for(iterator iter1 = g1.begin<TElem>(), iter2 = g2.begin<TElem>();
+		iter1 != g1.end<TElem>(); ++iter1, ++iter2)
+	{
+		TElem* e1 = *iter1;
+		TElem* e2 = *iter2;
+		if(NumVertices(e1) != NumVertices(e2)){
+			UG_THROW("Different element order in bulk created grid!");
+		}
+
+		for(size_t i = 0; i < NumVertices(e1); ++i){
+			if(g1.get_attachment_data_index(GetVertex(e1, i))
+			   != g2.get_attachment_data_index(GetVertex(e2, i)))
+			{
+				UG_THROW("Different element order in bulk created grid!");
+			}
+		}
+
+		if(TElem::dim != 1)
+			CompareAssociated<TElem, Edge>(g1, e1, g2, e2);
+		if(TElem::dim != 2)
+			CompareAssociated<TElem, Face>(g1, e1, g2, e2);
+		if(TElem::dim != 3)
+			CompareAssociated<TElem, Volume>(g1, e1, g2, e2);
+	}
+}
+
+static void CompareGrids(Grid& g1, Grid& g2)
+{
+	CompareElements<Vertex>(g1, g2);
+	CompareElements<Edge>(g1, g2);
+	CompareElements<Face>(g1, g2);
+	CompareElements<Volume>(g1, g2);
+}
+
+void CheckBulkCreation(Grid& g)
+{
+	if(g.num<Volume>() == 0){
+		UG_THROW("CheckBulkCreation: The grid has to contain volumes.");
+	}
+
+	Grid gSeq, gBulk;
+	CopyVolumes(gSeq, g, false);
+	CopyVolumes(gBulk, g, true);
+
+	CompareGrids(gSeq, gBulk);
+	CheckAssociatedEdgesOfVolumes(gBulk);
+	CheckAssociatedVolumesOfEdges(gBulk);
+
+	gBulk.freeze_topology();
+	CompareGrids(gSeq, gBulk);
+	CheckAssociatedEdgesOfVolumes(gBulk);
+	CheckAssociatedVolumesOfEdges(gBulk);
+	if(!gBulk.topology_is_frozen()){
+		UG_THROW("The checks of associated elements thawed the topology!");
+	}
+
+	gBulk.set_vertex_tuple_hash(true);
+	CompareGrids(gSeq, gBulk);
+	CheckAssociatedEdgesOfVolumes(gBulk);
+	CheckAssociatedVolumesOfEdges(gBulk);
+
+	gBulk.freeze_topology();
+	CompareGrids(gSeq, gBulk);
+	CheckAssociatedEdgesOfVolumes(gBulk);
+	CheckAssociatedVolumesOfEdges(gBulk);
+}
+
 }//	end of namespace
 }//	end of namespace
@@ -54,6 +54,19 @@ void CheckAssociatedEdgesOfVolumes(Grid& g);
  * If something is wrong, the method throws an instance of UGError.
  */
 void CheckAssociatedVolumesOfEdges(Grid& g);
+
+/** THIS METHOD USES Grid::mark!
+ * creates the volumes of g a second time in two new grids with full
+ * interconnection, once one by one through Grid::create and once per element
+ * type through Grid::create_bulk. Both grids have to contain the same edges,
+ * faces and volumes in the same order and with the same associated elements.
+ * The associated elements of the bulk created grid are then checked by
+ * CheckAssociatedEdgesOfVolumes and CheckAssociatedVolumesOfEdges, both with
+ * frozen topology and with a vertex tuple hash.
+ *
+ * If something is wrong, the method throws an instance of UGError.
+ */
+void CheckBulkCreation(Grid& g);
 }//	end of namespace
 }//	end of namespace
 
@@ -152,7 +152,7 @@ template <class T> class UG_API AttachmentDataContainer : public IAttachmentData
 				if(iSize > 0)
 					m_vData.resize(iSize, m_defaultValue);
 				else
-					m_vData.clear();
+					DataContainer().swap(m_vData);
 			}
 
 		virtual size_t size()	{return m_vData.size();}
@@ -167,14 +167,14 @@ template <class T> class UG_API AttachmentDataContainer : public IAttachmentData
 		virtual void defragment(size_t* pNewIndices, size_t numValidElements)
 			{
 				size_t numOldElems = size();
-				DataContainer vDataOld = m_vData;
-				m_vData.resize(numValidElements);
+				DataContainer vDataNew(numValidElements, m_defaultValue);
 				for(size_t i = 0; i < numOldElems; ++i)
 				{
 					size_t nInd = pNewIndices[i];
 					if(nInd != INVALID_ATTACHMENT_INDEX)
-						m_vData[nInd] = vDataOld[i];
+						vDataNew[nInd] = m_vData[i];
 				}
+				m_vData.swap(vDataNew);
 			}
 	
 	/**	copies entries from the this-container to the container
@@ -387,9 +387,20 @@ class UG_API AttachmentPipe
 	 */
 		void unregister_element(const TElem& elem);
 
-	/**	Aligns data with elements and removes unused data-memory.*/
+	/**	Aligns data with elements and removes unused data-memory.
+	 * Does nothing if the pipe is not fragmented. See reorder.*/
 		void defragment();
 
+	///	Renumbers the data entries in element iteration order.
+	/**	Unused entries are removed and the data of the i-th element in the
+	 * order given by attachment_traits::elements_begin is afterwards stored
+	 * at the i-th entry of each data container. In contrast to defragment,
+	 * the data is renumbered even if the pipe is not fragmented. This is
+	 * useful if the element order was changed and data of neighboring
+	 * elements shall be stored close to each other in memory. If the data
+	 * is already stored in element order, the containers are not touched.*/
+		void reorder();
+
 	/**\brief attaches a new data-array to the pipe.
 	 *
 	 * Attachs a new attachment and creates a container which holds the
@@ -292,6 +292,14 @@ defragment()
 	if(!is_fragmented())
 		return;
 
+	reorder();
+}
+
+template <class TElem, class TElemHandler>
+void
+AttachmentPipe<TElem, TElemHandler>::
+reorder()
+{
 //	if num_elements == 0, then simply resize all data-containers to 0.
 	if(num_elements() == 0)
 	{
@@ -303,26 +311,45 @@ defragment()
 		}
 		m_stackFreeEntries = UINTStack();
 		m_numDataEntries = 0;
+		m_containerSize = 0;
 	}
 	else
 	{
 	//	calculate the fragmentation array. It has to be of the same size as the fragmented data containers.
-		std::vector<uint> vNewIndices(num_data_entries(), INVALID_ATTACHMENT_INDEX);
+		std::vector<size_t> vNewIndices(get_container_size(), INVALID_ATTACHMENT_INDEX);
 
-	//	iterate through the elements and calculate the new index of each
-		size_t counter = 0;
+	//	collect the elements first. The element container may itself store
+	//	its links in attachments of this pipe, so that the indices must not
+	//	be changed while iterating.
+		std::vector<typename atraits::ElemPtr> vElems;
+		vElems.reserve(num_elements());
 		typename atraits::element_iterator iter = atraits::elements_begin(m_pHandler);
 		typename atraits::element_iterator end = atraits::elements_end(m_pHandler);
+		for(; iter != end; ++iter)
+			vElems.push_back(*iter);
+
+	//	nothing to do if the data is already stored in element order
+		if(get_container_size() == vElems.size()){
+			size_t i = 0;
+			while(i < vElems.size()
+				  && atraits::get_data_index(m_pHandler, vElems[i]) == i)
+				++i;
+			if(i == vElems.size())
+				return;
+		}
 
-		for(; iter != end; ++iter){
-			vNewIndices[atraits::get_data_index(m_pHandler, (*iter))] = counter;
-			atraits::set_data_index(m_pHandler, (*iter), counter);
+	//	calculate the new index of each element
+		size_t counter = 0;
+		for(size_t i = 0; i < vElems.size(); ++i){
+			vNewIndices[atraits::get_data_index(m_pHandler, vElems[i])] = counter;
+			atraits::set_data_index(m_pHandler, vElems[i], counter);
 			++counter;
 		}
 
 	//	after defragmentation there are no free indices.
 		m_stackFreeEntries = UINTStack();
 		m_numDataEntries = counter;
+		m_containerSize = counter;
 
 	//	now iterate through the attached data-containers and defragment each one.
 		{
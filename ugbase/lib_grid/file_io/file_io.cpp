@@ -57,6 +57,7 @@
 #include "file_io_stl.h"
 #include "file_io_tikz.h"
 #include "file_io_vtu.h"
+#include "file_io_ugb.h"
 #include "file_io_swc.h"
 
 #ifdef UG_PARALLEL
@@ -211,6 +212,9 @@ static bool LoadGrid(Grid& grid, ISubsetHandler* psh,
 					retVal = LoadGridFromVTU(grid, shTmp, tfile.c_str(), aPos);
 				}
 			}
+			else if(tfile.find(".ugb") != string::npos){
+				retVal = LoadGridFromUGB(grid, psh, tfile.c_str(), aPos);
+			}
 			else{
 			//	now we'll handle those methods, which only support 3d position types.
 				retVal = LoadGrid3d(grid, psh, tfile.c_str(), aPos);
@@ -356,6 +360,9 @@ static bool SaveGrid(Grid& grid, ISubsetHandler* psh,
 	else if(strName.find(".vtu") != string::npos){
 		return SaveGridToVTU(grid, psh, filename, aPos);
 	}
+	else if(strName.find(".ugb") != string::npos){
+		return SaveGridToUGB(grid, psh, filename, aPos);
+	}
 	else
 		return SaveGrid3d(grid, psh, filename, aPos);
 }
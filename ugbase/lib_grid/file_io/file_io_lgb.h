@@ -37,6 +37,7 @@
 #include "lib_grid/tools/subset_handler_interface.h"
 #include "lib_grid/tools/selector_interface.h"
 #include "lib_grid/common_attachments.h"
+#include "common/util/binary_buffer.h"
 
 namespace ug
 {
@@ -79,6 +80,14 @@ bool LoadGridFromLGB(Grid& grid, const char* filename,
 				   ProjectionHandler* pPH = NULL,
 				   APosition aPos = aPosition);
 
+
+///	writes the projectors of the given projection handler to a binary buffer
+void SerializeProjectionHandler(BinaryBuffer& out, ProjectionHandler& ph);
+
+///	reads projectors written by SerializeProjectionHandler into the given handler
+/**	The subset handler and geometry of ph have to be set before this method is called.*/
+void DeserializeProjectionHandler(BinaryBuffer& in, ProjectionHandler& ph);
+
 }//	end of namespace
 
 #endif
@@ -0,0 +1,1132 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include "file_io_ugb.h"
+#include "file_io_lgb.h"
+#include "common/error.h"
+#include "common/log.h"
+#include "common/util/binary_buffer.h"
+#include "lib_grid/grid_objects/grid_objects.h"
+#include "lib_grid/refinement/projectors/projection_handler.h"
+
+#ifdef UG_POSIX
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace ug
+{
+
+namespace{
+
+const char		UGB_MAGIC[8] = {'U', 'G', 'B', 'G', 'R', 'I', 'D', '\0'};
+const uint32	UGB_VERSION = 1;
+const uint32	UGB_BYTE_ORDER_MARK = 0x01020304;
+const size_t	UGB_ALIGNMENT = 64;
+const size_t	UGB_CHUNK_SIZE = 1 << 16;
+
+const size_t	UGB_NUM_EDGE_CORNERS = 2;
+const size_t	UGB_NUM_FACE_CORNERS = 4;
+const size_t	UGB_NUM_VOLUME_CORNERS = 8;
+
+///	side indices store the dimension of the side in the two highest bits
+const int		UGB_SIDE_DIM_SHIFT = 62;
+const uint64	UGB_SIDE_INDEX_MASK = (uint64(1) << UGB_SIDE_DIM_SHIFT) - 1;
+
+typedef Attachment<uint64>	AUGBIndex;
+
+///	writes sections and records their positions for the section table
+class SectionWriter
+{
+	public:
+		SectionWriter(ofstream& out) : m_out(out)	{}
+
+		void begin(GridReaderUGB::SectionID id, uint32 recordSize)
+		{
+			align();
+			m_cur.id = id;
+			m_cur.recordSize = recordSize;
+			m_cur.offset = (uint64)m_out.tellp();
+			m_cur.numRecords = 0;
+			m_cur.numBytes = 0;
+		}
+
+		void write(const void* data, size_t numBytes)
+		{
+			if(numBytes > 0)
+				m_out.write((const char*)data, numBytes);
+		}
+
+		template <class T>
+		void write_vector(std::vector<T>& v)
+		{
+			if(!v.empty())
+				write(&v.front(), v.size() * sizeof(T));
+			v.clear();
+		}
+
+		void end(uint64 numRecords)
+		{
+			m_cur.numRecords = numRecords;
+			m_cur.numBytes = (uint64)m_out.tellp() - m_cur.offset;
+			m_entries.push_back(m_cur);
+		}
+
+		void align()
+		{
+			uint64 pos = (uint64)m_out.tellp();
+			static const char zeros[UGB_ALIGNMENT] = {0};
+			if(pos % UGB_ALIGNMENT != 0)
+				m_out.write(zeros, UGB_ALIGNMENT - pos % UGB_ALIGNMENT);
+		}
+
+		const std::vector<GridReaderUGB::SectionEntry>& entries() const	{return m_entries;}
+
+	private:
+		ofstream&									m_out;
+		GridReaderUGB::SectionEntry					m_cur;
+		std::vector<GridReaderUGB::SectionEntry>	m_entries;
+};
+
+int HighestElementDimension(Grid& grid)
+{
+	if(grid.num_volumes() > 0)
+		return 3;
+	if(grid.num_faces() > 0)
+		return 2;
+	if(grid.num_edges() > 0)
+		return 1;
+	return 0;
+}
+
+template <class TElem>
+void WriteCorners(SectionWriter& w, Grid& grid,
+				  Grid::VertexAttachmentAccessor<AUGBIndex>& aaInd,
+				  GridReaderUGB::SectionID id, size_t numCorners)
+{
+	typedef typename Grid::traits<TElem>::iterator	iter_t;
+	w.begin(id, (uint32)(numCorners * sizeof(uint64)));
+	std::vector<uint64> buf;
+	buf.reserve(UGB_CHUNK_SIZE * numCorners);
+	for(iter_t iter = grid.begin<TElem>(); iter != grid.end<TElem>(); ++iter){
+		typename TElem::ConstVertexArray vrts = (*iter)->vertices();
+		const size_t numVrts = (*iter)->num_vertices();
+		UG_COND_THROW(numVrts > numCorners, "Element with too many corners encountered.");
+		for(size_t i = 0; i < numVrts; ++i)
+			buf.push_back(aaInd[vrts[i]]);
+		for(size_t i = numVrts; i < numCorners; ++i)
+			buf.push_back(UGB_INVALID_INDEX);
+		if(buf.size() >= UGB_CHUNK_SIZE * numCorners)
+			w.write_vector(buf);
+	}
+	w.write_vector(buf);
+	w.end(grid.num<TElem>());
+}
+
+template <class TElem>
+void WriteTypes(SectionWriter& w, Grid& grid, GridReaderUGB::SectionID id)
+{
+	typedef typename Grid::traits<TElem>::iterator	iter_t;
+	w.begin(id, sizeof(byte));
+	std::vector<byte> buf;
+	buf.reserve(UGB_CHUNK_SIZE);
+	for(iter_t iter = grid.begin<TElem>(); iter != grid.end<TElem>(); ++iter){
+		buf.push_back((byte)(*iter)->reference_object_id());
+		if(buf.size() >= UGB_CHUNK_SIZE)
+			w.write_vector(buf);
+	}
+	w.write_vector(buf);
+	w.end(grid.num<TElem>());
+}
+
+template <class TElem>
+void WriteSubsets(SectionWriter& w, Grid& grid, ISubsetHandler* psh,
+				  GridReaderUGB::SectionID id)
+{
+	typedef typename Grid::traits<TElem>::iterator	iter_t;
+	w.begin(id, sizeof(int));
+	std::vector<int> buf;
+	buf.reserve(UGB_CHUNK_SIZE);
+	for(iter_t iter = grid.begin<TElem>(); iter != grid.end<TElem>(); ++iter){
+		buf.push_back(psh ? psh->get_subset_index(*iter) : -1);
+		if(buf.size() >= UGB_CHUNK_SIZE)
+			w.write_vector(buf);
+	}
+	w.write_vector(buf);
+	w.end(grid.num<TElem>());
+}
+
+template <class TElem>
+void AssignIndices(Grid& grid, AUGBIndex& aInd)
+{
+	typedef typename Grid::traits<TElem>::iterator	iter_t;
+	Grid::AttachmentAccessor<TElem, AUGBIndex> aaInd(grid, aInd);
+	uint64 counter = 0;
+	for(iter_t iter = grid.begin<TElem>(); iter != grid.end<TElem>(); ++iter)
+		aaInd[*iter] = counter++;
+}
+
+inline uint64 EncodeSide(int dim, uint64 index)
+{
+	return (uint64(dim) << UGB_SIDE_DIM_SHIFT) | index;
+}
+
+///	appends the sides of elem (edges and - for volumes - faces) to sidesOut
+template <class TElem>
+void CollectSides(Grid& grid, TElem* elem,
+				  Grid::EdgeAttachmentAccessor<AUGBIndex>& aaEdgeInd,
+				  Grid::FaceAttachmentAccessor<AUGBIndex>& aaFaceInd,
+				  std::vector<uint64>& sidesOut)
+{
+	if(TElem::dim >= 2){
+		Grid::edge_traits::secure_container edges;
+		grid.associated_elements(edges, elem);
+		for(size_t i = 0; i < edges.size(); ++i)
+			sidesOut.push_back(EncodeSide(1, aaEdgeInd[edges[i]]));
+	}
+	if(TElem::dim >= 3){
+		Grid::face_traits::secure_container faces;
+		grid.associated_elements(faces, elem);
+		for(size_t i = 0; i < faces.size(); ++i)
+			sidesOut.push_back(EncodeSide(2, aaFaceInd[faces[i]]));
+	}
+}
+
+///	collects sides of dimension TSide::dim which aren't part of an element of type TElem
+template <class TSide, class TElem>
+void CollectOrphans(Grid& grid,
+					Grid::AttachmentAccessor<TSide, AUGBIndex>& aaInd,
+					std::vector<uint64>& orphansOut)
+{
+	typedef typename Grid::traits<TSide>::iterator	iter_t;
+	typename Grid::traits<TElem>::secure_container elems;
+	for(iter_t iter = grid.begin<TSide>(); iter != grid.end<TSide>(); ++iter){
+		grid.associated_elements(elems, *iter);
+		if(elems.size() == 0)
+			orphansOut.push_back(EncodeSide(TSide::dim, aaInd[*iter]));
+	}
+}
+
+template <class TElem>
+void WriteSideLists(SectionWriter& w, Grid& grid,
+					Grid::EdgeAttachmentAccessor<AUGBIndex>& aaEdgeInd,
+					Grid::FaceAttachmentAccessor<AUGBIndex>& aaFaceInd,
+					const std::vector<uint64>& orphans)
+{
+	typedef typename Grid::traits<TElem>::iterator	iter_t;
+	std::vector<uint64> offsets;
+	offsets.reserve(grid.num<TElem>() + 1);
+	offsets.push_back(0);
+
+	w.begin(GridReaderUGB::SIDE_INDICES, sizeof(uint64));
+	std::vector<uint64> buf = orphans;
+	uint64 numWritten = 0;
+	for(iter_t iter = grid.begin<TElem>(); iter != grid.end<TElem>(); ++iter){
+		CollectSides(grid, *iter, aaEdgeInd, aaFaceInd, buf);
+		offsets.push_back(numWritten + buf.size());
+		if(buf.size() >= UGB_CHUNK_SIZE){
+			numWritten += buf.size();
+			w.write_vector(buf);
+		}
+	}
+	numWritten += buf.size();
+	w.write_vector(buf);
+	w.end(numWritten);
+
+	w.begin(GridReaderUGB::SIDE_OFFSETS, sizeof(uint64));
+	const uint64 numOffsets = offsets.size();
+	w.write_vector(offsets);
+	w.end(numOffsets);
+}
+
+///	appends the indices [first, last) to indsOut
+void AppendRange(std::vector<size_t>& indsOut, uint64 first, uint64 last)
+{
+	for(uint64 i = first; i < last; ++i)
+		indsOut.push_back((size_t)i);
+}
+
+void SortUnique(std::vector<size_t>& v)
+{
+	std::sort(v.begin(), v.end());
+	v.erase(std::unique(v.begin(), v.end()), v.end());
+}
+
+///	returns the index of the file vertex ind among the loaded vertices
+/**	loadedInds holds the sorted file indices of the loaded vertices. If it is
+ * NULL, all numLoaded vertices of the file were loaded in file order.*/
+inline int LocalIndex(const std::vector<size_t>* loadedInds, size_t numLoaded,
+					  uint64 ind, const std::string& filename)
+{
+	if(!loadedInds){
+		UG_COND_THROW(ind >= numLoaded,
+					  "GridReaderUGB: invalid vertex index " << ind << " in "
+					  << filename << ", which contains " << numLoaded
+					  << " vertices.");
+		return (int)ind;
+	}
+	std::vector<size_t>::const_iterator iter =
+			std::lower_bound(loadedInds->begin(), loadedInds->end(), ind);
+	UG_COND_THROW(iter == loadedInds->end() || *iter != ind,
+				  "GridReaderUGB: vertex " << ind << " of " << filename
+				  << " was not loaded.");
+	return (int)(iter - loadedInds->begin());
+}
+
+///	creates the elements of type TElem among the given records through Grid::create_bulk
+/**	corners holds cornersPerRecord file vertex indices per record. If types
+ * is specified, only records of type TElem are considered. The new elements
+ * are written to elemsOut at the positions of their records.*/
+template <class TElem>
+void CreateElementsInBulk(std::vector<typename geometry_traits<TElem>::grid_base_object*>& elemsOut,
+						  Grid& grid, const std::vector<Vertex*>& vrts,
+						  const std::vector<size_t>* loadedInds,
+						  const std::vector<uint64>& corners, size_t cornersPerRecord,
+						  const std::vector<byte>* types, const std::string& filename)
+{
+	typedef typename geometry_traits<TElem>::grid_base_object TBaseObj;
+	const size_t numRecords = corners.size() / cornersPerRecord;
+
+	std::vector<int> inds;
+	std::vector<size_t> records;
+	for(size_t i = 0; i < numRecords; ++i){
+		if(types && (*types)[i] != geometry_traits<TElem>::REFERENCE_OBJECT_ID)
+			continue;
+		const uint64* c = &corners[i * cornersPerRecord];
+		for(size_t j = 0; j < (size_t)TElem::NUM_VERTICES; ++j)
+			inds.push_back(LocalIndex(loadedInds, vrts.size(), c[j], filename));
+		records.push_back(i);
+	}
+
+	if(records.empty())
+		return;
+
+	std::vector<TBaseObj*> newElems;
+	grid.create_bulk<TElem>(vrts, &inds.front(), records.size(), &newElems);
+	for(size_t i = 0; i < records.size(); ++i)
+		elemsOut[records[i]] = newElems[i];
+}
+
+}//	end of anonymous namespace
+
+
+
+////////////////////////////////////////////////////////////////////////
+template <class TAPosition>
+bool SaveGridToUGB(Grid& grid, ISubsetHandler* psh, const char* filename,
+				   TAPosition& aPos, ProjectionHandler* pPH,
+				   const std::vector<int>* partitionMap)
+{
+	typedef typename TAPosition::ValueType	vector_t;
+	const int posDim = vector_t::Size;
+
+	if(!grid.has_vertex_attachment(aPos)){
+		UG_LOG("ERROR in SaveGridToUGB: position attachment missing.\n");
+		return false;
+	}
+
+	UG_COND_THROW(pPH && (!psh || pPH->subset_handler() != psh),
+				  "ERROR in SaveGridToUGB: The subset handler of the projection "
+				  "handler has to be passed to SaveGridToUGB, too.");
+
+	const int elemDim = HighestElementDimension(grid);
+	size_t numElems = 0;
+	switch(elemDim){
+		case 1: numElems = grid.num_edges(); break;
+		case 2: numElems = grid.num_faces(); break;
+		case 3: numElems = grid.num_volumes(); break;
+		default: break;
+	}
+
+	UG_COND_THROW(partitionMap && partitionMap->size() != numElems,
+				  "ERROR in SaveGridToUGB: The partition map has to contain one entry "
+				  "for each of the " << numElems << " elements of dimension "
+				  << elemDim << ", but has " << partitionMap->size() << " entries.");
+
+	ofstream out(filename, ios::binary);
+	if(!out){
+		UG_LOG("ERROR in SaveGridToUGB: couldn't open file: " << filename << endl);
+		return false;
+	}
+
+	GridReaderUGB::Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, UGB_MAGIC, sizeof(header.magic));
+	header.version = UGB_VERSION;
+	header.byteOrderMark = UGB_BYTE_ORDER_MARK;
+	header.posDim = posDim;
+	header.elemDim = elemDim;
+//	the header is written again once the section table is known
+	out.write((const char*)&header, sizeof(header));
+
+	AUGBIndex aInd;
+	grid.attach_to_vertices(aInd);
+	grid.attach_to_edges(aInd);
+	grid.attach_to_faces(aInd);
+	Grid::VertexAttachmentAccessor<AUGBIndex> aaVrtInd(grid, aInd);
+	Grid::EdgeAttachmentAccessor<AUGBIndex> aaEdgeInd(grid, aInd);
+	Grid::FaceAttachmentAccessor<AUGBIndex> aaFaceInd(grid, aInd);
+	AssignIndices<Vertex>(grid, aInd);
+	AssignIndices<Edge>(grid, aInd);
+	AssignIndices<Face>(grid, aInd);
+
+	SectionWriter w(out);
+
+//	vertices
+	{
+		Grid::VertexAttachmentAccessor<TAPosition> aaPos(grid, aPos);
+		w.begin(GridReaderUGB::COORDINATES, posDim * sizeof(double));
+		std::vector<double> buf;
+		buf.reserve(UGB_CHUNK_SIZE * posDim);
+		for(VertexIterator iter = grid.vertices_begin();
+			iter != grid.vertices_end(); ++iter)
+		{
+			const vector_t& p = aaPos[*iter];
+			for(int i = 0; i < posDim; ++i)
+				buf.push_back((double)p[i]);
+			if(buf.size() >= UGB_CHUNK_SIZE * posDim)
+				w.write_vector(buf);
+		}
+		w.write_vector(buf);
+		w.end(grid.num_vertices());
+	}
+	WriteSubsets<Vertex>(w, grid, psh, GridReaderUGB::VERTEX_SUBSETS);
+
+//	edges, faces and volumes
+	WriteCorners<Edge>(w, grid, aaVrtInd, GridReaderUGB::EDGE_CORNERS, UGB_NUM_EDGE_CORNERS);
+	WriteSubsets<Edge>(w, grid, psh, GridReaderUGB::EDGE_SUBSETS);
+
+	WriteTypes<Face>(w, grid, GridReaderUGB::FACE_TYPES);
+	WriteCorners<Face>(w, grid, aaVrtInd, GridReaderUGB::FACE_CORNERS, UGB_NUM_FACE_CORNERS);
+	WriteSubsets<Face>(w, grid, psh, GridReaderUGB::FACE_SUBSETS);
+
+	WriteTypes<Volume>(w, grid, GridReaderUGB::VOLUME_TYPES);
+	WriteCorners<Volume>(w, grid, aaVrtInd, GridReaderUGB::VOLUME_CORNERS, UGB_NUM_VOLUME_CORNERS);
+	WriteSubsets<Volume>(w, grid, psh, GridReaderUGB::VOLUME_SUBSETS);
+
+//	side lists of the elements of highest dimension
+	if(elemDim == 2){
+		std::vector<uint64> orphans;
+		CollectOrphans<Edge, Face>(grid, aaEdgeInd, orphans);
+		WriteSideLists<Face>(w, grid, aaEdgeInd, aaFaceInd, orphans);
+	}
+	else if(elemDim == 3){
+		std::vector<uint64> orphans;
+		CollectOrphans<Edge, Volume>(grid, aaEdgeInd, orphans);
+		CollectOrphans<Face, Volume>(grid, aaFaceInd, orphans);
+		WriteSideLists<Volume>(w, grid, aaEdgeInd, aaFaceInd, orphans);
+	}
+
+	grid.detach_from_vertices(aInd);
+	grid.detach_from_edges(aInd);
+	grid.detach_from_faces(aInd);
+
+//	subset names and colors
+	if(psh){
+		BinaryBuffer tbuf;
+		uint32 numSubsets = (uint32)psh->num_subsets();
+		tbuf.write((const char*)&numSubsets, sizeof(uint32));
+		for(uint32 i = 0; i < numSubsets; ++i){
+			const SubsetInfo& si = psh->subset_info(i);
+			uint32 len = (uint32)si.name.size();
+			tbuf.write((const char*)&len, sizeof(uint32));
+			tbuf.write(si.name.c_str(), len);
+			for(int j = 0; j < 4; ++j){
+				double c = si.color[j];
+				tbuf.write((const char*)&c, sizeof(double));
+			}
+		}
+		w.begin(GridReaderUGB::SUBSET_INFO, 0);
+		w.write(tbuf.buffer(), tbuf.write_pos());
+		w.end(numSubsets);
+	}
+
+//	projection handler
+	if(pPH){
+		BinaryBuffer tbuf;
+		SerializeProjectionHandler(tbuf, *pPH);
+		w.begin(GridReaderUGB::PROJECTION_HANDLER, 0);
+		w.write(tbuf.buffer(), tbuf.write_pos());
+		w.end(1);
+	}
+
+//	partition map
+	if(partitionMap){
+		w.begin(GridReaderUGB::PARTITION_MAP, sizeof(int));
+		if(!partitionMap->empty())
+			w.write(&partitionMap->front(), partitionMap->size() * sizeof(int));
+		w.end(partitionMap->size());
+	}
+
+//	section table and final header
+	w.align();
+	header.sectionTableOffset = (uint64)out.tellp();
+	header.numSections = (uint32)w.entries().size();
+	if(!w.entries().empty()){
+		out.write((const char*)&w.entries().front(),
+				  w.entries().size() * sizeof(GridReaderUGB::SectionEntry));
+	}
+	out.seekp(0);
+	out.write((const char*)&header, sizeof(header));
+
+	if(!out){
+		UG_LOG("ERROR in SaveGridToUGB: couldn't write file: " << filename << endl);
+		return false;
+	}
+	return true;
+}
+
+
+template <class TAPosition>
+bool LoadGridFromUGB(Grid& grid, ISubsetHandler* psh, const char* filename,
+					 TAPosition& aPos, ProjectionHandler* pPH)
+{
+	GridReaderUGB reader;
+	if(!reader.open(filename))
+		return false;
+
+	if(!reader.load(grid, psh, aPos))
+		return false;
+
+	if(pPH)
+		reader.load_projection_handler(*pPH);
+
+	return true;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////
+GridReaderUGB::
+GridReaderUGB() :
+	m_file(NULL),
+	m_mappedData(NULL),
+	m_mappedSize(0),
+	m_posDim(0),
+	m_elemDim(0)
+{
+}
+
+GridReaderUGB::
+~GridReaderUGB()
+{
+	close();
+}
+
+bool GridReaderUGB::
+open(const char* filename)
+{
+	close();
+
+	m_filename = filename;
+	m_file = fopen(filename, "rb");
+	if(!m_file){
+		UG_LOG("ERROR in GridReaderUGB::open: couldn't open file: " << filename << endl);
+		return false;
+	}
+
+	Header header;
+	if(fread(&header, sizeof(header), 1, m_file) != 1
+	   || memcmp(header.magic, UGB_MAGIC, sizeof(header.magic)) != 0)
+	{
+		UG_LOG("ERROR in GridReaderUGB::open: " << filename << " is not a ugb file.\n");
+		close();
+		return false;
+	}
+
+	if(header.byteOrderMark != UGB_BYTE_ORDER_MARK){
+		UG_LOG("ERROR in GridReaderUGB::open: " << filename
+			   << " was written with a different byte order.\n");
+		close();
+		return false;
+	}
+
+	if(header.version != UGB_VERSION){
+		UG_LOG("ERROR in GridReaderUGB::open: unsupported version " << header.version
+			   << " of file " << filename << endl);
+		close();
+		return false;
+	}
+
+	m_posDim = header.posDim;
+	m_elemDim = header.elemDim;
+	m_sections.resize(header.numSections);
+	if(header.numSections > 0){
+		if(fseek(m_file, (long)header.sectionTableOffset, SEEK_SET) != 0
+		   || fread(&m_sections.front(), sizeof(SectionEntry), header.numSections,
+				    m_file) != header.numSections)
+		{
+			UG_LOG("ERROR in GridReaderUGB::open: couldn't read section table of "
+				   << filename << endl);
+			close();
+			return false;
+		}
+	}
+
+//	map the file into memory if possible. Otherwise we read through the file.
+	#ifdef UG_POSIX
+	{
+		int fd = fileno(m_file);
+		struct stat st;
+		if(fstat(fd, &st) == 0 && st.st_size > 0){
+			void* data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			if(data != MAP_FAILED){
+				m_mappedData = (char*)data;
+				m_mappedSize = st.st_size;
+				fclose(m_file);
+				m_file = NULL;
+			}
+		}
+	}
+	#endif
+
+	read_subset_info();
+	return true;
+}
+
+void GridReaderUGB::
+close()
+{
+	#ifdef UG_POSIX
+		if(m_mappedData)
+			munmap(m_mappedData, m_mappedSize);
+	#endif
+	m_mappedData = NULL;
+	m_mappedSize = 0;
+
+	if(m_file)
+		fclose(m_file);
+	m_file = NULL;
+
+	m_posDim = m_elemDim = 0;
+	m_sections.clear();
+	m_subsetNames.clear();
+	m_subsetColors.clear();
+}
+
+size_t GridReaderUGB::
+num_vertices() const
+{
+	const SectionEntry* sec = find_section(COORDINATES);
+	return sec ? (size_t)sec->numRecords : 0;
+}
+
+size_t GridReaderUGB::
+num_elements() const
+{
+	const SectionEntry* sec = NULL;
+	switch(m_elemDim){
+		case 1:	sec = find_section(EDGE_SUBSETS); break;
+		case 2:	sec = find_section(FACE_SUBSETS); break;
+		case 3:	sec = find_section(VOLUME_SUBSETS); break;
+		default: break;
+	}
+	return sec ? (size_t)sec->numRecords : 0;
+}
+
+const GridReaderUGB::SectionEntry* GridReaderUGB::
+find_section(SectionID id) const
+{
+	for(size_t i = 0; i < m_sections.size(); ++i){
+		if(m_sections[i].id == (uint32)id)
+			return &m_sections[i];
+	}
+	return NULL;
+}
+
+const GridReaderUGB::SectionEntry& GridReaderUGB::
+section(SectionID id) const
+{
+	const SectionEntry* sec = find_section(id);
+	UG_COND_THROW(!sec, "GridReaderUGB: section " << (int)id << " doesn't exist.");
+	return *sec;
+}
+
+void GridReaderUGB::
+read_bytes(uint64 offset, uint64 numBytes, void* dest) const
+{
+	if(numBytes == 0)
+		return;
+
+	if(m_mappedData){
+		UG_COND_THROW(offset + numBytes > m_mappedSize,
+					  "GridReaderUGB: read beyond the end of the file.");
+		memcpy(dest, m_mappedData + offset, numBytes);
+	}
+	else{
+		UG_COND_THROW(!m_file, "GridReaderUGB: no file opened.");
+		UG_COND_THROW(fseek(m_file, (long)offset, SEEK_SET) != 0
+					  || fread(dest, 1, numBytes, m_file) != numBytes,
+					  "GridReaderUGB: couldn't read " << numBytes << " bytes at "
+					  "offset " << offset);
+	}
+}
+
+void GridReaderUGB::
+read_records(SectionID id, size_t first, size_t num, void* dest) const
+{
+	const SectionEntry& sec = section(id);
+	UG_COND_THROW(sec.recordSize == 0,
+				  "GridReaderUGB: section " << (int)id << " has no fixed record size.");
+	UG_COND_THROW(first + num > sec.numRecords,
+				  "GridReaderUGB: records [" << first << ", " << first + num
+				  << ") of section " << (int)id << " requested, but only "
+				  << sec.numRecords << " records exist.");
+	read_bytes(sec.offset + (uint64)first * sec.recordSize,
+			   (uint64)num * sec.recordSize, dest);
+}
+
+void GridReaderUGB::
+read_selected_records(SectionID id, const std::vector<size_t>* inds, void* dest) const
+{
+	if(!inds){
+		read_records(id, 0, (size_t)section(id).numRecords, dest);
+		return;
+	}
+
+	const size_t recordSize = section(id).recordSize;
+	char* d = (char*)dest;
+	size_t i = 0;
+	while(i < inds->size()){
+		size_t runEnd = i + 1;
+		while(runEnd < inds->size() && (*inds)[runEnd] == (*inds)[runEnd - 1] + 1)
+			++runEnd;
+		read_records(id, (*inds)[i], runEnd - i, d + i * recordSize);
+		i = runEnd;
+	}
+}
+
+size_t GridReaderUGB::
+read_element_corners(size_t first, size_t num, std::vector<uint64>& cornersOut) const
+{
+	SectionID id;
+	size_t numCorners;
+	switch(m_elemDim){
+		case 1:	id = EDGE_CORNERS; numCorners = UGB_NUM_EDGE_CORNERS; break;
+		case 2:	id = FACE_CORNERS; numCorners = UGB_NUM_FACE_CORNERS; break;
+		case 3:	id = VOLUME_CORNERS; numCorners = UGB_NUM_VOLUME_CORNERS; break;
+		default:
+			UG_THROW("GridReaderUGB: the file contains no elements.");
+	}
+
+	cornersOut.resize(num * numCorners);
+	if(num > 0)
+		read_records(id, first, num, &cornersOut.front());
+	return numCorners;
+}
+
+void GridReaderUGB::
+read_coordinates(const std::vector<size_t>& vrtInds, std::vector<double>& coordsOut) const
+{
+	coordsOut.resize(vrtInds.size() * m_posDim);
+	if(!vrtInds.empty())
+		read_selected_records(COORDINATES, &vrtInds, &coordsOut.front());
+}
+
+void GridReaderUGB::
+read_subset_info()
+{
+	const SectionEntry* sec = find_section(SUBSET_INFO);
+	if(!sec)
+		return;
+
+	BinaryBuffer tbuf;
+	tbuf.reserve(sec->numBytes);
+	read_bytes(sec->offset, sec->numBytes, tbuf.buffer());
+	tbuf.set_write_pos(sec->numBytes);
+
+	uint32 numSubsets;
+	tbuf.read((char*)&numSubsets, sizeof(uint32));
+	m_subsetNames.resize(numSubsets);
+	m_subsetColors.resize(numSubsets);
+	for(uint32 i = 0; i < numSubsets; ++i){
+		uint32 len;
+		tbuf.read((char*)&len, sizeof(uint32));
+		m_subsetNames[i].resize(len);
+		if(len > 0)
+			tbuf.read(&m_subsetNames[i][0], len);
+		for(int j = 0; j < 4; ++j){
+			double c;
+			tbuf.read((char*)&c, sizeof(double));
+			m_subsetColors[i][j] = c;
+		}
+	}
+}
+
+bool GridReaderUGB::
+load_projection_handler(ProjectionHandler& phOut)
+{
+	const SectionEntry* sec = find_section(PROJECTION_HANDLER);
+	if(!sec)
+		return false;
+
+	BinaryBuffer tbuf;
+	tbuf.reserve(sec->numBytes);
+	read_bytes(sec->offset, sec->numBytes, tbuf.buffer());
+	tbuf.set_write_pos(sec->numBytes);
+	DeserializeProjectionHandler(tbuf, phOut);
+	return true;
+}
+
+template <class TAPosition>
+bool GridReaderUGB::
+load(Grid& grid, ISubsetHandler* psh, TAPosition& aPos)
+{
+	return load_impl(grid, psh, aPos, NULL);
+}
+
+template <class TAPosition>
+bool GridReaderUGB::
+load_elements(Grid& grid, ISubsetHandler* psh, TAPosition& aPos,
+			  size_t first, size_t num)
+{
+	std::vector<size_t> elemInds;
+	AppendRange(elemInds, first, first + num);
+	return load_impl(grid, psh, aPos, &elemInds);
+}
+
+template <class TAPosition>
+bool GridReaderUGB::
+load_elements(Grid& grid, ISubsetHandler* psh, TAPosition& aPos,
+			  const std::vector<size_t>& elemInds)
+{
+	return load_impl(grid, psh, aPos, &elemInds);
+}
+
+template <class TAPosition>
+bool GridReaderUGB::
+load_partition(Grid& grid, ISubsetHandler* psh, TAPosition& aPos, int partition)
+{
+	if(!has_partition_map()){
+		UG_LOG("ERROR in GridReaderUGB::load_partition: the file contains no partition map.\n");
+		return false;
+	}
+
+//	read the partition map chunk by chunk
+	std::vector<size_t> elemInds;
+	std::vector<int> chunk;
+	const size_t numElems = (size_t)section(PARTITION_MAP).numRecords;
+	for(size_t first = 0; first < numElems; first += UGB_CHUNK_SIZE){
+		const size_t num = std::min(UGB_CHUNK_SIZE, numElems - first);
+		chunk.resize(num);
+		read_records(PARTITION_MAP, first, num, &chunk.front());
+		for(size_t i = 0; i < num; ++i){
+			if(chunk[i] == partition)
+				elemInds.push_back(first + i);
+		}
+	}
+	return load_impl(grid, psh, aPos, &elemInds);
+}
+
+template <class TAPosition>
+bool GridReaderUGB::
+load_partition(Grid& grid, ISubsetHandler* psh, TAPosition& aPos,
+			   const std::vector<int>& partitionMap, int partition)
+{
+	UG_COND_THROW(partitionMap.size() != num_elements(),
+				  "GridReaderUGB::load_partition: The partition map has to contain "
+				  "one entry for each of the " << num_elements() << " elements.");
+
+	std::vector<size_t> elemInds;
+	for(size_t i = 0; i < partitionMap.size(); ++i){
+		if(partitionMap[i] == partition)
+			elemInds.push_back(i);
+	}
+	return load_impl(grid, psh, aPos, &elemInds);
+}
+
+template <class TAPosition>
+bool GridReaderUGB::
+load_impl(Grid& grid, ISubsetHandler* psh, TAPosition& aPos,
+		  const std::vector<size_t>* elemIndsIn)
+{
+	typedef typename TAPosition::ValueType	vector_t;
+
+	if(!is_open()){
+		UG_LOG("ERROR in GridReaderUGB: no file opened.\n");
+		return false;
+	}
+
+	m_loadedVrts.clear();
+	m_loadedVrtInds.clear();
+
+//	indices of the edges, faces, volumes and vertices which shall be loaded.
+//	NULL means that all elements of the given type are loaded.
+	std::vector<size_t> edgeInds, faceInds, volInds, vrtInds;
+	std::vector<size_t>* pEdgeInds = NULL;
+	std::vector<size_t>* pFaceInds = NULL;
+	std::vector<size_t>* pVolInds = NULL;
+	std::vector<size_t>* pVrtInds = NULL;
+
+	if(elemIndsIn){
+		std::vector<size_t>* elemInds = NULL;
+		switch(m_elemDim){
+			case 1:	elemInds = &edgeInds; break;
+			case 2:	elemInds = &faceInds; break;
+			case 3:	elemInds = &volInds; break;
+			default:
+				UG_LOG("ERROR in GridReaderUGB: the file contains no elements.\n");
+				return false;
+		}
+		*elemInds = *elemIndsIn;
+		SortUnique(*elemInds);
+		UG_COND_THROW(!elemInds->empty() && elemInds->back() >= num_elements(),
+					  "GridReaderUGB: element index " << elemInds->back()
+					  << " out of range.");
+
+	//	collect the sides of the elements from the side lists
+		if(has_section(SIDE_OFFSETS)){
+			std::vector<uint64> offsets, sides;
+			size_t i = 0;
+			while(i < elemInds->size()){
+				size_t runEnd = i + 1;
+				while(runEnd < elemInds->size()
+					  && (*elemInds)[runEnd] == (*elemInds)[runEnd - 1] + 1)
+					++runEnd;
+
+				const size_t first = (*elemInds)[i];
+				const size_t num = runEnd - i;
+				offsets.resize(num + 1);
+				read_records(SIDE_OFFSETS, first, num + 1, &offsets.front());
+				sides.resize(offsets[num] - offsets[0]);
+				if(!sides.empty()){
+					read_records(SIDE_INDICES, (size_t)offsets[0], sides.size(),
+								 &sides.front());
+				}
+				for(size_t j = 0; j < sides.size(); ++j){
+					const size_t ind = (size_t)(sides[j] & UGB_SIDE_INDEX_MASK);
+					switch(sides[j] >> UGB_SIDE_DIM_SHIFT){
+						case 1:	edgeInds.push_back(ind); break;
+						case 2:	faceInds.push_back(ind); break;
+						default:
+							UG_THROW("GridReaderUGB: invalid side index encountered.");
+					}
+				}
+				i = runEnd;
+			}
+			SortUnique(edgeInds);
+			SortUnique(faceInds);
+		}
+
+		pEdgeInds = &edgeInds;
+		pFaceInds = &faceInds;
+		pVolInds = &volInds;
+		pVrtInds = &vrtInds;
+	}
+
+	const size_t numEdges = pEdgeInds ? pEdgeInds->size()
+							: (has_section(EDGE_CORNERS) ? (size_t)section(EDGE_CORNERS).numRecords : 0);
+	const size_t numFaces = pFaceInds ? pFaceInds->size()
+							: (has_section(FACE_CORNERS) ? (size_t)section(FACE_CORNERS).numRecords : 0);
+	const size_t numVols = pVolInds ? pVolInds->size()
+							: (has_section(VOLUME_CORNERS) ? (size_t)section(VOLUME_CORNERS).numRecords : 0);
+
+//	read the connectivity
+	std::vector<uint64> edgeCorners(numEdges * UGB_NUM_EDGE_CORNERS);
+	std::vector<uint64> faceCorners(numFaces * UGB_NUM_FACE_CORNERS);
+	std::vector<uint64> volCorners(numVols * UGB_NUM_VOLUME_CORNERS);
+	std::vector<byte> faceTypes(numFaces), volTypes(numVols);
+	if(numEdges > 0)
+		read_selected_records(EDGE_CORNERS, pEdgeInds, &edgeCorners.front());
+	if(numFaces > 0){
+		read_selected_records(FACE_TYPES, pFaceInds, &faceTypes.front());
+		read_selected_records(FACE_CORNERS, pFaceInds, &faceCorners.front());
+	}
+	if(numVols > 0){
+		read_selected_records(VOLUME_TYPES, pVolInds, &volTypes.front());
+		read_selected_records(VOLUME_CORNERS, pVolInds, &volCorners.front());
+	}
+
+//	collect the required vertices
+	if(pVrtInds){
+		for(size_t i = 0; i < edgeCorners.size(); ++i)
+			vrtInds.push_back((size_t)edgeCorners[i]);
+		for(size_t i = 0; i < faceCorners.size(); ++i){
+			if(faceCorners[i] != UGB_INVALID_INDEX)
+				vrtInds.push_back((size_t)faceCorners[i]);
+		}
+		for(size_t i = 0; i < volCorners.size(); ++i){
+			if(volCorners[i] != UGB_INVALID_INDEX)
+				vrtInds.push_back((size_t)volCorners[i]);
+		}
+		SortUnique(vrtInds);
+	}
+	const size_t numVrts = pVrtInds ? pVrtInds->size() : num_vertices();
+
+//	create the vertices
+	if(!grid.has_vertex_attachment(aPos))
+		grid.attach_to_vertices(aPos);
+	Grid::VertexAttachmentAccessor<TAPosition> aaPos(grid, aPos);
+
+	const int dim = std::min<int>(m_posDim, vector_t::Size);
+	std::vector<double> coords(numVrts * m_posDim);
+	if(numVrts > 0)
+		read_selected_records(COORDINATES, pVrtInds, &coords.front());
+
+	m_loadedVrts.resize(numVrts);
+	for(size_t i = 0; i < numVrts; ++i){
+		Vertex* vrt = *grid.create<RegularVertex>();
+		vector_t& p = aaPos[vrt];
+		p = 0;
+		for(int j = 0; j < dim; ++j)
+			p[j] = coords[i * m_posDim + j];
+		m_loadedVrts[i] = vrt;
+	}
+	coords.clear();
+
+	if(pVrtInds)
+		m_loadedVrtInds.swap(vrtInds);
+	else
+		AppendRange(m_loadedVrtInds, 0, numVrts);
+	const std::vector<size_t>* pLoadedInds = pVrtInds ? &m_loadedVrtInds : NULL;
+
+	std::vector<Vertex*>& vrts = m_loadedVrts;
+
+//	create edges, faces and volumes. Sides are created first, so that they
+//	are found when their elements are created.
+	for(size_t i = 0; i < numFaces; ++i){
+		UG_COND_THROW(faceTypes[i] != ROID_TRIANGLE
+					  && faceTypes[i] != ROID_QUADRILATERAL,
+					  "GridReaderUGB: unsupported face type " << (int)faceTypes[i]
+					  << " in " << m_filename);
+	}
+	for(size_t i = 0; i < numVols; ++i){
+		UG_COND_THROW(volTypes[i] != ROID_TETRAHEDRON
+					  && volTypes[i] != ROID_PYRAMID
+					  && volTypes[i] != ROID_PRISM
+					  && volTypes[i] != ROID_HEXAHEDRON
+					  && volTypes[i] != ROID_OCTAHEDRON,
+					  "GridReaderUGB: unsupported volume type " << (int)volTypes[i]
+					  << " in " << m_filename);
+	}
+
+	std::vector<Edge*> edges(numEdges);
+	CreateElementsInBulk<RegularEdge>(edges, grid, vrts, pLoadedInds, edgeCorners,
+									  UGB_NUM_EDGE_CORNERS, NULL, m_filename);
+
+	std::vector<Face*> faces(numFaces);
+	CreateElementsInBulk<Triangle>(faces, grid, vrts, pLoadedInds, faceCorners,
+								   UGB_NUM_FACE_CORNERS, &faceTypes, m_filename);
+	CreateElementsInBulk<Quadrilateral>(faces, grid, vrts, pLoadedInds, faceCorners,
+										UGB_NUM_FACE_CORNERS, &faceTypes, m_filename);
+
+	std::vector<Volume*> vols(numVols);
+	CreateElementsInBulk<Tetrahedron>(vols, grid, vrts, pLoadedInds, volCorners,
+									  UGB_NUM_VOLUME_CORNERS, &volTypes, m_filename);
+	CreateElementsInBulk<Pyramid>(vols, grid, vrts, pLoadedInds, volCorners,
+								  UGB_NUM_VOLUME_CORNERS, &volTypes, m_filename);
+	CreateElementsInBulk<Prism>(vols, grid, vrts, pLoadedInds, volCorners,
+								UGB_NUM_VOLUME_CORNERS, &volTypes, m_filename);
+	CreateElementsInBulk<Hexahedron>(vols, grid, vrts, pLoadedInds, volCorners,
+									 UGB_NUM_VOLUME_CORNERS, &volTypes, m_filename);
+	CreateElementsInBulk<Octahedron>(vols, grid, vrts, pLoadedInds, volCorners,
+									 UGB_NUM_VOLUME_CORNERS, &volTypes, m_filename);
+
+//	subsets
+	if(psh){
+		for(size_t i = 0; i < m_subsetNames.size(); ++i){
+			SubsetInfo& si = psh->subset_info((int)i);
+			si.name = m_subsetNames[i];
+			si.color = m_subsetColors[i];
+		}
+
+		std::vector<int> subsets;
+		subsets.resize(numVrts);
+		if(numVrts > 0)
+			read_selected_records(VERTEX_SUBSETS, pVrtInds ? &m_loadedVrtInds : NULL,
+								  &subsets.front());
+		for(size_t i = 0; i < numVrts; ++i){
+			if(subsets[i] >= 0)
+				psh->assign_subset(vrts[i], subsets[i]);
+		}
+
+		subsets.resize(numEdges);
+		if(numEdges > 0)
+			read_selected_records(EDGE_SUBSETS, pEdgeInds, &subsets.front());
+		for(size_t i = 0; i < numEdges; ++i){
+			if(subsets[i] >= 0)
+				psh->assign_subset(edges[i], subsets[i]);
+		}
+
+		subsets.resize(numFaces);
+		if(numFaces > 0)
+			read_selected_records(FACE_SUBSETS, pFaceInds, &subsets.front());
+		for(size_t i = 0; i < numFaces; ++i){
+			if(subsets[i] >= 0)
+				psh->assign_subset(faces[i], subsets[i]);
+		}
+
+		subsets.resize(numVols);
+		if(numVols > 0)
+			read_selected_records(VOLUME_SUBSETS, pVolInds, &subsets.front());
+		for(size_t i = 0; i < numVols; ++i){
+			if(subsets[i] >= 0)
+				psh->assign_subset(vols[i], subsets[i]);
+		}
+	}
+
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//	explicit template instantiations
+template bool SaveGridToUGB<APosition1>(Grid&, ISubsetHandler*, const char*, APosition1&, ProjectionHandler*, const std::vector<int>*);
+template bool SaveGridToUGB<APosition2>(Grid&, ISubsetHandler*, const char*, APosition2&, ProjectionHandler*, const std::vector<int>*);
+template bool SaveGridToUGB<APosition3>(Grid&, ISubsetHandler*, const char*, APosition3&, ProjectionHandler*, const std::vector<int>*);
+
+template bool LoadGridFromUGB<APosition1>(Grid&, ISubsetHandler*, const char*, APosition1&, ProjectionHandler*);
+template bool LoadGridFromUGB<APosition2>(Grid&, ISubsetHandler*, const char*, APosition2&, ProjectionHandler*);
+template bool LoadGridFromUGB<APosition3>(Grid&, ISubsetHandler*, const char*, APosition3&, ProjectionHandler*);
+
+#define UGB_INSTANTIATE_READER(TAPos)\
+	template bool GridReaderUGB::load<TAPos>(Grid&, ISubsetHandler*, TAPos&);\
+	template bool GridReaderUGB::load_elements<TAPos>(Grid&, ISubsetHandler*, TAPos&, size_t, size_t);\
+	template bool GridReaderUGB::load_elements<TAPos>(Grid&, ISubsetHandler*, TAPos&, const std::vector<size_t>&);\
+	template bool GridReaderUGB::load_partition<TAPos>(Grid&, ISubsetHandler*, TAPos&, int);\
+	template bool GridReaderUGB::load_partition<TAPos>(Grid&, ISubsetHandler*, TAPos&, const std::vector<int>&, int);
+
+UGB_INSTANTIATE_READER(APosition1)
+UGB_INSTANTIATE_READER(APosition2)
+UGB_INSTANTIATE_READER(APosition3)
+
+#undef UGB_INSTANTIATE_READER
+
+}//	end of namespace
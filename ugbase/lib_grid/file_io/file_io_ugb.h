@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__LIB_GRID__FILE_IO_UGB__
+#define __H__LIB_GRID__FILE_IO_UGB__
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "common/types.h"
+#include "lib_grid/grid/grid.h"
+#include "lib_grid/tools/subset_handler_interface.h"
+#include "lib_grid/common_attachments.h"
+
+namespace ug
+{
+
+class ProjectionHandler;
+
+/**	\page pageUGB UGB - binary grid format
+ *
+ * UGB files store a grid in fixed-width binary sections, which are described
+ * by a section table. All values are stored in the byte order of the writing
+ * machine, which is checked when a file is opened.
+ *
+ * - coordinates: one record of posDim doubles per vertex
+ * - edge, face and volume corners: one record of 2, 4 or 8 uint64 vertex
+ *   indices per element (unused corners are set to UGB_INVALID_INDEX)
+ * - face and volume types: one byte (ReferenceObjectID) per element
+ * - subsets: one int per vertex, edge, face and volume
+ * - side lists: for each element of highest dimension the indices of all
+ *   edges and faces in its closure (compressed row storage). Edges and
+ *   faces which are not contained in an element of highest dimension are
+ *   added to the list of the first element.
+ * - subset names, projection handler: serialized blobs
+ * - partition map (optional): one int per element of highest dimension
+ *
+ * Each record can thus be accessed in constant time. GridReaderUGB maps the
+ * file into memory (where supported) and is able to load the whole grid or
+ * only a range or a partition of the elements of highest dimension, together
+ * with the vertices and sides they require. Only the requested records are
+ * read in that case.
+ *
+ * Constrained elements are stored as their regular counterparts.
+ */
+
+const uint64 UGB_INVALID_INDEX = ~uint64(0);
+
+////////////////////////////////////////////////////////////////////////
+///	Writes a grid to a ugb file.
+/**	Valid position attachments are APosition1, APosition2 and APosition3.
+ * If a projection handler is passed, psh has to be the subset handler which
+ * is used by the projection handler.
+ *
+ * If a partition map is specified, it has to contain one entry for each
+ * element of highest dimension (in the order of iteration). It can be used
+ * to load single partitions through GridReaderUGB::load_partition.*/
+template <class TAPosition>
+bool SaveGridToUGB(Grid& grid, ISubsetHandler* psh, const char* filename,
+				   TAPosition& aPos, ProjectionHandler* pPH = NULL,
+				   const std::vector<int>* partitionMap = NULL);
+
+///	Loads a whole grid from a ugb file.
+/**	Valid position attachments are APosition1, APosition2 and APosition3.*/
+template <class TAPosition>
+bool LoadGridFromUGB(Grid& grid, ISubsetHandler* psh, const char* filename,
+					 TAPosition& aPos, ProjectionHandler* pPH = NULL);
+
+
+////////////////////////////////////////////////////////////////////////
+///	Grants random access to the sections of a ugb file.
+/**	The reader maps the file into memory on POSIX systems and reads the
+ * required byte ranges through a file stream otherwise.
+ *
+ * Elements are loaded into the given grid without clearing it. Vertices
+ * and sides are only created once per call, but loading overlapping element
+ * sets in several calls creates duplicates.
+ *
+ * After a load, loaded_vertices() and loaded_vertex_indices() contain the
+ * created vertices together with their indices in the file.*/
+class GridReaderUGB
+{
+	public:
+		enum SectionID{
+			COORDINATES = 1,
+			VERTEX_SUBSETS = 2,
+			EDGE_CORNERS = 10,
+			EDGE_SUBSETS = 11,
+			FACE_TYPES = 20,
+			FACE_CORNERS = 21,
+			FACE_SUBSETS = 22,
+			VOLUME_TYPES = 30,
+			VOLUME_CORNERS = 31,
+			VOLUME_SUBSETS = 32,
+			SIDE_OFFSETS = 40,
+			SIDE_INDICES = 41,
+			SUBSET_INFO = 50,
+			PROJECTION_HANDLER = 51,
+			PARTITION_MAP = 52
+		};
+
+		GridReaderUGB();
+		~GridReaderUGB();
+
+	///	opens the given file and reads its header and section table
+		bool open(const char* filename);
+		void close();
+
+		bool is_open() const					{return m_file != NULL || m_mappedData != NULL;}
+	///	returns true if the file has been mapped into memory
+		bool is_mapped() const					{return m_mappedData != NULL;}
+
+		int position_dimension() const			{return m_posDim;}
+	///	dimension of the elements of highest dimension
+		int element_dimension() const			{return m_elemDim;}
+
+		size_t num_vertices() const;
+	///	number of elements of highest dimension
+		size_t num_elements() const;
+
+		size_t num_subsets() const					{return m_subsetNames.size();}
+		const std::string& subset_name(size_t i) const	{return m_subsetNames.at(i);}
+
+		bool has_section(SectionID id) const		{return find_section(id) != NULL;}
+		bool has_partition_map() const				{return has_section(PARTITION_MAP);}
+
+	///	reads num consecutive records of the given section, starting at record first
+		void read_records(SectionID id, size_t first, size_t num, void* dest) const;
+
+	///	reads the corners of the elements of highest dimension in [first, first + num)
+	/**	Returns the number of entries per element. Unused corners are set to
+	 * UGB_INVALID_INDEX.*/
+		size_t read_element_corners(size_t first, size_t num,
+									std::vector<uint64>& cornersOut) const;
+
+	///	reads the coordinates of the vertices with the given (sorted) indices
+	/**	coordsOut contains position_dimension() values per vertex afterwards.*/
+		void read_coordinates(const std::vector<size_t>& vrtInds,
+							  std::vector<double>& coordsOut) const;
+
+	///	loads all elements
+		template <class TAPosition>
+		bool load(Grid& grid, ISubsetHandler* psh, TAPosition& aPos);
+
+	///	loads the elements of highest dimension in [first, first + num)
+		template <class TAPosition>
+		bool load_elements(Grid& grid, ISubsetHandler* psh, TAPosition& aPos,
+						   size_t first, size_t num);
+
+	///	loads the elements of highest dimension with the given indices
+		template <class TAPosition>
+		bool load_elements(Grid& grid, ISubsetHandler* psh, TAPosition& aPos,
+						   const std::vector<size_t>& elemInds);
+
+	///	loads all elements which are assigned to the given partition in the partition map of the file
+		template <class TAPosition>
+		bool load_partition(Grid& grid, ISubsetHandler* psh, TAPosition& aPos,
+							int partition);
+
+	///	loads the elements which are assigned to the given partition in the given map
+		template <class TAPosition>
+		bool load_partition(Grid& grid, ISubsetHandler* psh, TAPosition& aPos,
+							const std::vector<int>& partitionMap, int partition);
+
+	///	reads the projection handler. Returns false if the file doesn't contain one.
+		bool load_projection_handler(ProjectionHandler& phOut);
+
+		const std::vector<Vertex*>& loaded_vertices() const		{return m_loadedVrts;}
+		const std::vector<size_t>& loaded_vertex_indices() const	{return m_loadedVrtInds;}
+
+	public:
+	///	on-disk header of a ugb file
+		struct Header{
+			char	magic[8];
+			uint32	version;
+			uint32	byteOrderMark;
+			uint32	posDim;
+			uint32	elemDim;
+			uint32	numSections;
+			uint32	reserved;
+			uint64	sectionTableOffset;
+			uint64	reserved2[3];
+		};
+
+	///	on-disk entry of the section table
+		struct SectionEntry{
+			uint32	id;
+			uint32	recordSize;
+			uint64	offset;
+			uint64	numRecords;
+			uint64	numBytes;
+		};
+
+	private:
+		const SectionEntry* find_section(SectionID id) const;
+		const SectionEntry& section(SectionID id) const;
+
+		void read_bytes(uint64 offset, uint64 numBytes, void* dest) const;
+
+	///	reads the records with the given indices, coalescing consecutive runs.
+	/**	inds has to be sorted. If inds is NULL, all records are read.
+	 * dest has to provide space for all read records.*/
+		void read_selected_records(SectionID id, const std::vector<size_t>* inds,
+								   void* dest) const;
+
+		template <class TAPosition>
+		bool load_impl(Grid& grid, ISubsetHandler* psh, TAPosition& aPos,
+					   const std::vector<size_t>* elemInds);
+
+		void read_subset_info();
+
+	private:
+		std::string					m_filename;
+		std::FILE*					m_file;
+		char*						m_mappedData;
+		size_t						m_mappedSize;
+		int							m_posDim;
+		int							m_elemDim;
+		std::vector<SectionEntry>	m_sections;
+		std::vector<std::string>	m_subsetNames;
+		std::vector<vector4>		m_subsetColors;
+
+		std::vector<Vertex*>		m_loadedVrts;
+		std::vector<size_t>			m_loadedVrtInds;
+};
+
+}//	end of namespace
+
+#endif
@@ -1237,27 +1237,34 @@ size_t GridReaderUGX::get_projection_handler_subset_handler_index(size_t phIndex
 }
 
 
-SPRefinementProjector GridReaderUGX::
-read_projector(xml_node<>* projNode)
+SPRefinementProjector
+DeserializeProjectorUGX(const char* type, const std::string& data)
 {
 	static Factory<RefinementProjector, ProjectorTypes>	projFac;
 	static Archivar<boost::archive::text_iarchive, RefinementProjector, ProjectorTypes>	archivar;
 
+	try {
+		SPRefinementProjector proj = projFac.create(type);
+
+		stringstream ss(data, ios_base::in);
+		boost::archive::text_iarchive ar(ss, boost::archive::no_header);
+		archivar.archive(ar, *proj);
+		return proj;
+	}
+	catch(boost::archive::archive_exception& e){
+		UG_LOG("WARNING: Couldn't read projector of type '" <<
+				type << "'." << std::endl);
+	}
+	return SPRefinementProjector();
+}
+
+SPRefinementProjector GridReaderUGX::
+read_projector(xml_node<>* projNode)
+{
 	xml_attribute<>* attribType = projNode->first_attribute("type");
 	if(attribType){
-		try {
-			SPRefinementProjector proj = projFac.create(attribType->value());
-
-			string str(projNode->value(), projNode->value_size());
-			stringstream ss(str, ios_base::in);
-			boost::archive::text_iarchive ar(ss, boost::archive::no_header);
-			archivar.archive(ar, *proj);
-			return proj;
-		}
-		catch(boost::archive::archive_exception& e){
-			UG_LOG("WARNING: Couldn't read projector of type '" <<
-					attribType->value() << "'." << std::endl);
-		}
+		return DeserializeProjectorUGX(attribType->value(),
+						string(projNode->value(), projNode->value_size()));
 	}
 	return SPRefinementProjector();
 }
@@ -1368,42 +1375,253 @@ new_document_parsed()
 	return true;
 }
 
-bool GridReaderUGX::
-create_edges(std::vector<Edge*>& edgesOut,
-			Grid& grid, rapidxml::xml_node<>* node,
-			std::vector<Vertex*>& vrts)
+void ResolveConstrainingObjectsUGX(
+			Grid& grid, std::vector<Edge*>& edges, std::vector<Face*>& faces,
+			const std::vector<std::pair<int, int> >& constrainingObjsVRT,
+			const std::vector<std::pair<int, int> >& constrainingObjsEDGE,
+			const std::vector<std::pair<int, int> >& constrainingObjsTRI,
+			const std::vector<std::pair<int, int> >& constrainingObjsQUAD)
+{
+	if(!constrainingObjsVRT.empty()){
+		//UG_LOG("num-edges: " << edges.size() << std::endl);
+	//	iterate over the pairs.
+	//	at the same time we'll iterate over the constrained vertices since
+	//	they are synchronized.
+		ConstrainedVertexIterator hvIter = grid.begin<ConstrainedVertex>();
+		for(std::vector<std::pair<int, int> >::const_iterator iter = constrainingObjsVRT.begin();
+			iter != constrainingObjsVRT.end(); ++iter, ++hvIter)
+		{
+			ConstrainedVertex* hv = *hvIter;
+			
+			switch(iter->first){
+				case 1:	// constraining object is an edge
+				{
+				//	make sure that the index is valid
+					if(iter->second >= 0 && iter->second < (int)edges.size()){
+					//	get the edge
+						ConstrainingEdge* edge = dynamic_cast<ConstrainingEdge*>(edges[iter->second]);
+						if(edge){
+							hv->set_constraining_object(edge);
+							edge->add_constrained_object(hv);
+						}
+						else{
+							UG_LOG("WARNING: Type-ID / type mismatch. Ignoring edge " << iter->second << ".\n");
+						}
+					}
+					else{
+						UG_LOG("ERROR in GridReaderUGX: Bad edge index in constrained vertex: " << iter->second << "\n");
+					}
+				}break;
+				
+				case 2:	// constraining object is an face
+				{
+				//	make sure that the index is valid
+					if(iter->second >= 0 && iter->second < (int)faces.size()){
+					//	get the edge
+						ConstrainingFace* face = dynamic_cast<ConstrainingFace*>(faces[iter->second]);
+						if(face){
+							hv->set_constraining_object(face);
+							face->add_constrained_object(hv);
+						}
+						else{
+							UG_LOG("WARNING in GridReaderUGX: Type-ID / type mismatch. Ignoring face " << iter->second << ".\n");
+						}
+					}
+					else{
+						UG_LOG("ERROR in GridReaderUGX: Bad face index in constrained vertex: " << iter->second << "\n");
+					}
+				}break;
+				
+				default:
+				{
+//					UG_LOG("WARNING in GridReaderUGX: unsupported type-id of constraining vertex"
+//							<< " at " << GetGridObjectCenter(grid, hv) << "\n");
+					break;
+				}
+			}
+		}
+	}
+
+	if(!constrainingObjsEDGE.empty()){
+	//	iterate over the pairs.
+	//	at the same time we'll iterate over the constrained vertices since
+	//	they are synchronized.
+		ConstrainedEdgeIterator ceIter = grid.begin<ConstrainedEdge>();
+		for(std::vector<std::pair<int, int> >::const_iterator iter = constrainingObjsEDGE.begin();
+			iter != constrainingObjsEDGE.end(); ++iter, ++ceIter)
+		{
+			ConstrainedEdge* ce = *ceIter;
+			
+			switch(iter->first){
+				case 1:	// constraining object is an edge
+				{
+				//	make sure that the index is valid
+					if(iter->second >= 0 && iter->second < (int)edges.size()){
+					//	get the edge
+						ConstrainingEdge* edge = dynamic_cast<ConstrainingEdge*>(edges[iter->second]);
+						if(edge){
+							ce->set_constraining_object(edge);
+							edge->add_constrained_object(ce);
+						}
+						else{
+							UG_LOG("WARNING in GridReaderUGX: Type-ID / type mismatch. Ignoring edge " << iter->second << ".\n");
+						}
+					}
+					else{
+						UG_LOG("ERROR in GridReaderUGX: Bad edge index in constrained edge.\n");
+					}
+				}break;
+				case 2:	// constraining object is an face
+				{
+				//	make sure that the index is valid
+					if(iter->second >= 0 && iter->second < (int)faces.size()){
+					//	get the edge
+						ConstrainingFace* face = dynamic_cast<ConstrainingFace*>(faces[iter->second]);
+						if(face){
+							ce->set_constraining_object(face);
+							face->add_constrained_object(ce);
+						}
+						else{
+							UG_LOG("WARNING in GridReaderUGX: Type-ID / type mismatch. Ignoring face " << iter->second << ".\n");
+						}
+					}
+					else{
+						UG_LOG("ERROR in GridReaderUGX: Bad face index in constrained edge: " << iter->second << "\n");
+					}
+				}break;
+				
+				default:
+				{
+//					UG_LOG("WARNING in GridReaderUGX: unsupported type-id of constraining edge"
+//							<< " at " << GetGridObjectCenter(grid, ce) << "\n");
+					break;
+				}
+			}
+		}
+	}
+
+	if(!constrainingObjsTRI.empty()){
+	//	iterate over the pairs.
+	//	at the same time we'll iterate over the constrained vertices since
+	//	they are synchronized.
+		ConstrainedTriangleIterator cfIter = grid.begin<ConstrainedTriangle>();
+		for(std::vector<std::pair<int, int> >::const_iterator iter = constrainingObjsTRI.begin();
+			iter != constrainingObjsTRI.end(); ++iter, ++cfIter)
+		{
+			ConstrainedFace* cdf = *cfIter;
+			
+			switch(iter->first){
+				case 2:	// constraining object is an face
+				{
+				//	make sure that the index is valid
+					if(iter->second >= 0 && iter->second < (int)faces.size()){
+					//	get the edge
+						ConstrainingFace* face = dynamic_cast<ConstrainingFace*>(faces[iter->second]);
+						if(face){
+							cdf->set_constraining_object(face);
+							face->add_constrained_object(cdf);
+						}
+						else{
+							UG_LOG("WARNING in GridReaderUGX: Type-ID / type mismatch. Ignoring face " << iter->second << ".\n");
+						}
+					}
+					else{
+						UG_LOG("ERROR in GridReaderUGX: Bad face index in constrained face: " << iter->second << "\n");
+					}
+				}break;
+				
+				default:
+				{
+//					UG_LOG("WARNING in GridReaderUGX: unsupported type-id of constraining triangle"
+//							<< " at " << GetGridObjectCenter(grid, cdf) << "\n");
+					break;
+				}
+			}
+		}
+	}
+
+	if(!constrainingObjsQUAD.empty()){
+	//	iterate over the pairs.
+	//	at the same time we'll iterate over the constrained vertices since
+	//	they are synchronized.
+		ConstrainedQuadrilateralIterator cfIter = grid.begin<ConstrainedQuadrilateral>();
+		for(std::vector<std::pair<int, int> >::const_iterator iter = constrainingObjsQUAD.begin();
+			iter != constrainingObjsQUAD.end(); ++iter, ++cfIter)
+		{
+			ConstrainedFace* cdf = *cfIter;
+			
+			switch(iter->first){
+				case 2:	// constraining object is an face
+				{
+				//	make sure that the index is valid
+					if(iter->second >= 0 && iter->second < (int)faces.size()){
+					//	get the edge
+						ConstrainingFace* face = dynamic_cast<ConstrainingFace*>(faces[iter->second]);
+						if(face){
+							cdf->set_constraining_object(face);
+							face->add_constrained_object(cdf);
+						}
+						else{
+							UG_LOG("WARNING in GridReaderUGX: Type-ID / type mismatch. Ignoring face " << iter->second << ".\n");
+						}
+					}
+					else{
+						UG_LOG("ERROR in GridReaderUGX: Bad face index in constrained face: " << iter->second << "\n");
+					}
+				}break;
+				
+				default:
+				{
+//					UG_LOG("WARNING in GridReaderUGX: unsupported type-id of constraining quadrilateral"
+//							<< " at " << GetGridObjectCenter(grid, cdf) << "\n");
+					break;
+				}
+			}
+		}
+	}
+}
+
+///	reads the vertex index tuples of a node and creates the elements in one batch
+/**	Used for all element types whose nodes only contain corner indices.
+ * See Grid::create_bulk.*/
+template <class TElem>
+static bool
+CreateElementsInBulk(std::vector<typename geometry_traits<TElem>::grid_base_object*>& elemsOut,
+					 Grid& grid, rapidxml::xml_node<>* node,
+					 std::vector<Vertex*>& vrts, const char* funcName)
 {
 //	create a buffer with which we can access the data
 	string str(node->value(), node->value_size());
 	stringstream ss(str, ios_base::in);
 
-//	read the edges
-	int i1, i2;
-	while(!ss.eof()){
-	//	read the indices
-		ss >> i1 >> i2;
-
-	//	make sure that everything went right
-		if(ss.fail())
-			break;
-
-	//	make sure that the indices are valid
-		int maxInd = (int)vrts.size() - 1;
-		if(i1 < 0 || i1 > maxInd ||
-		   i2 < 0 || i2 > maxInd)
-		{
-			UG_LOG("  ERROR in GridReaderUGX::create_edges: invalid vertex index: "
-					"(" << i1 << ", " << i2 << ")\n");
+//	read the indices and make sure that they are valid
+	const int maxInd = (int)vrts.size() - 1;
+	vector<int> inds;
+	int ind;
+	while(ss >> ind){
+		if(ind < 0 || ind > maxInd){
+			UG_LOG("  ERROR in GridReaderUGX::" << funcName << ": invalid vertex index.\n");
 			return false;
 		}
-
-	//	create the edge
-		edgesOut.push_back(*grid.create<RegularEdge>(EdgeDescriptor(vrts[i1], vrts[i2])));
+		inds.push_back(ind);
 	}
 
+//	an incomplete trailing tuple is ignored
+	const size_t numElems = inds.size() / TElem::NUM_VERTICES;
+	if(numElems > 0)
+		grid.create_bulk<TElem>(vrts, &inds.front(), numElems, &elemsOut);
+
 	return true;
 }
 
+bool GridReaderUGX::
+create_edges(std::vector<Edge*>& edgesOut,
+			Grid& grid, rapidxml::xml_node<>* node,
+			std::vector<Vertex*>& vrts)
+{
+	return CreateElementsInBulk<RegularEdge>(edgesOut, grid, node, vrts, "create_edges");
+}
+
 bool GridReaderUGX::
 create_constraining_edges(std::vector<Edge*>& edgesOut,
 						  Grid& grid, rapidxml::xml_node<>* node,
@@ -1491,36 +1709,7 @@ create_triangles(std::vector<Face*>& facesOut,
 				  Grid& grid, rapidxml::xml_node<>* node,
 				  std::vector<Vertex*>& vrts)
 {
-//	create a buffer with which we can access the data
-	string str(node->value(), node->value_size());
-	stringstream ss(str, ios_base::in);
-
-//	read the triangles
-	int i1, i2, i3;
-	while(!ss.eof()){
-	//	read the indices
-		ss >> i1 >> i2 >> i3;
-
-	//	make sure that everything went right
-		if(ss.fail())
-			break;
-
-	//	make sure that the indices are valid
-		int maxInd = (int)vrts.size() - 1;
-		if(i1 < 0 || i1 > maxInd ||
-		   i2 < 0 || i2 > maxInd ||
-		   i3 < 0 || i3 > maxInd)
-		{
-			UG_LOG("  ERROR in GridReaderUGX::create_triangles: invalid vertex index.\n");
-			return false;
-		}
-
-	//	create the triangle
-		facesOut.push_back(
-			*grid.create<Triangle>(TriangleDescriptor(vrts[i1], vrts[i2], vrts[i3])));
-	}
-
-	return true;
+	return CreateElementsInBulk<Triangle>(facesOut, grid, node, vrts, "create_triangles");
 }
 
 bool GridReaderUGX::
@@ -1613,38 +1802,7 @@ create_quadrilaterals(std::vector<Face*>& facesOut,
 					   Grid& grid, rapidxml::xml_node<>* node,
 					   std::vector<Vertex*>& vrts)
 {
-//	create a buffer with which we can access the data
-	string str(node->value(), node->value_size());
-	stringstream ss(str, ios_base::in);
-
-//	read the quadrilaterals
-	int i1, i2, i3, i4;
-	while(!ss.eof()){
-	//	read the indices
-		ss >> i1 >> i2 >> i3 >> i4;
-
-	//	make sure that everything went right
-		if(ss.fail())
-			break;
-
-	//	make sure that the indices are valid
-		int maxInd = (int)vrts.size() - 1;
-		if(i1 < 0 || i1 > maxInd ||
-		   i2 < 0 || i2 > maxInd ||
-		   i3 < 0 || i3 > maxInd ||
-		   i4 < 0 || i4 > maxInd)
-		{
-			UG_LOG("  ERROR in GridReaderUGX::create_quadrilaterals: invalid vertex index.\n");
-			return false;
-		}
-
-	//	create the quad
-		facesOut.push_back(
-			*grid.create<Quadrilateral>(QuadrilateralDescriptor(vrts[i1], vrts[i2],
-															   vrts[i3], vrts[i4])));
-	}
-
-	return true;
+	return CreateElementsInBulk<Quadrilateral>(facesOut, grid, node, vrts, "create_quadrilaterals");
 }
 
 bool GridReaderUGX::
@@ -1744,38 +1902,7 @@ create_tetrahedrons(std::vector<Volume*>& volsOut,
 					 Grid& grid, rapidxml::xml_node<>* node,
 					 std::vector<Vertex*>& vrts)
 {
-//	create a buffer with which we can access the data
-	string str(node->value(), node->value_size());
-	stringstream ss(str, ios_base::in);
-
-//	read the tetrahedrons
-	int i1, i2, i3, i4;
-	while(!ss.eof()){
-	//	read the indices
-		ss >> i1 >> i2 >> i3 >> i4;
-
-	//	make sure that everything went right
-		if(ss.fail())
-			break;
-
-	//	make sure that the indices are valid
-		int maxInd = (int)vrts.size() - 1;
-		if(i1 < 0 || i1 > maxInd ||
-		   i2 < 0 || i2 > maxInd ||
-		   i3 < 0 || i3 > maxInd ||
-		   i4 < 0 || i4 > maxInd)
-		{
-			UG_LOG("  ERROR in GridReaderUGX::create_tetrahedrons: invalid vertex index.\n");
-			return false;
-		}
-
-	//	create the element
-		volsOut.push_back(
-			*grid.create<Tetrahedron>(TetrahedronDescriptor(vrts[i1], vrts[i2],
-														   vrts[i3], vrts[i4])));
-	}
-
-	return true;
+	return CreateElementsInBulk<Tetrahedron>(volsOut, grid, node, vrts, "create_tetrahedrons");
 }
 
 bool GridReaderUGX::
@@ -1783,42 +1910,7 @@ create_hexahedrons(std::vector<Volume*>& volsOut,
 					Grid& grid, rapidxml::xml_node<>* node,
 					std::vector<Vertex*>& vrts)
 {
-//	create a buffer with which we can access the data
-	string str(node->value(), node->value_size());
-	stringstream ss(str, ios_base::in);
-
-//	read the hexahedrons
-	int i1, i2, i3, i4, i5, i6, i7, i8;
-	while(!ss.eof()){
-	//	read the indices
-		ss >> i1 >> i2 >> i3 >> i4 >> i5 >> i6 >> i7 >> i8;
-
-	//	make sure that everything went right
-		if(ss.fail())
-			break;
-
-	//	make sure that the indices are valid
-		int maxInd = (int)vrts.size() - 1;
-		if(i1 < 0 || i1 > maxInd ||
-		   i2 < 0 || i2 > maxInd ||
-		   i3 < 0 || i3 > maxInd ||
-		   i4 < 0 || i4 > maxInd ||
-		   i5 < 0 || i5 > maxInd ||
-		   i6 < 0 || i6 > maxInd ||
-		   i7 < 0 || i7 > maxInd ||
-		   i8 < 0 || i8 > maxInd)
-		{
-			UG_LOG("  ERROR in GridReaderUGX::create_hexahedrons: invalid vertex index.\n");
-			return false;
-		}
-
-	//	create the element
-		volsOut.push_back(
-			*grid.create<Hexahedron>(HexahedronDescriptor(vrts[i1], vrts[i2], vrts[i3], vrts[i4],
-														  vrts[i5], vrts[i6], vrts[i7], vrts[i8])));
-	}
-
-	return true;
+	return CreateElementsInBulk<Hexahedron>(volsOut, grid, node, vrts, "create_hexahedrons");
 }
 
 bool GridReaderUGX::
@@ -1826,40 +1918,7 @@ create_prisms(std::vector<Volume*>& volsOut,
 			  Grid& grid, rapidxml::xml_node<>* node,
 			  std::vector<Vertex*>& vrts)
 {
-//	create a buffer with which we can access the data
-	string str(node->value(), node->value_size());
-	stringstream ss(str, ios_base::in);
-
-//	read the hexahedrons
-	int i1, i2, i3, i4, i5, i6;
-	while(!ss.eof()){
-	//	read the indices
-		ss >> i1 >> i2 >> i3 >> i4 >> i5 >> i6;
-
-	//	make sure that everything went right
-		if(ss.fail())
-			break;
-
-	//	make sure that the indices are valid
-		int maxInd = (int)vrts.size() - 1;
-		if(i1 < 0 || i1 > maxInd ||
-		   i2 < 0 || i2 > maxInd ||
-		   i3 < 0 || i3 > maxInd ||
-		   i4 < 0 || i4 > maxInd ||
-		   i5 < 0 || i5 > maxInd ||
-		   i6 < 0 || i6 > maxInd)
-		{
-			UG_LOG("  ERROR in GridReaderUGX::create_prisms: invalid vertex index.\n");
-			return false;
-		}
-
-	//	create the element
-		volsOut.push_back(
-			*grid.create<Prism>(PrismDescriptor(vrts[i1], vrts[i2], vrts[i3], vrts[i4],
-												vrts[i5], vrts[i6])));
-	}
-
-	return true;
+	return CreateElementsInBulk<Prism>(volsOut, grid, node, vrts, "create_prisms");
 }
 
 bool GridReaderUGX::
@@ -1867,39 +1926,7 @@ create_pyramids(std::vector<Volume*>& volsOut,
 				Grid& grid, rapidxml::xml_node<>* node,
 				std::vector<Vertex*>& vrts)
 {
-//	create a buffer with which we can access the data
-	string str(node->value(), node->value_size());
-	stringstream ss(str, ios_base::in);
-
-//	read the hexahedrons
-	int i1, i2, i3, i4, i5;
-	while(!ss.eof()){
-	//	read the indices
-		ss >> i1 >> i2 >> i3 >> i4 >> i5;
-
-	//	make sure that everything went right
-		if(ss.fail())
-			break;
-
-	//	make sure that the indices are valid
-		int maxInd = (int)vrts.size() - 1;
-		if(i1 < 0 || i1 > maxInd ||
-		   i2 < 0 || i2 > maxInd ||
-		   i3 < 0 || i3 > maxInd ||
-		   i4 < 0 || i4 > maxInd ||
-		   i5 < 0 || i5 > maxInd)
-		{
-			UG_LOG("  ERROR in GridReaderUGX::create_pyramids: invalid vertex index.\n");
-			return false;
-		}
-
-	//	create the element
-		volsOut.push_back(
-			*grid.create<Pyramid>(PyramidDescriptor(vrts[i1], vrts[i2], vrts[i3],
-													vrts[i4], vrts[i5])));
-	}
-
-	return true;
+	return CreateElementsInBulk<Pyramid>(volsOut, grid, node, vrts, "create_pyramids");
 }
 
 bool GridReaderUGX::
@@ -1907,40 +1934,7 @@ create_octahedrons(std::vector<Volume*>& volsOut,
 					Grid& grid, rapidxml::xml_node<>* node,
 					std::vector<Vertex*>& vrts)
 {
-//	create a buffer with which we can access the data
-	string str(node->value(), node->value_size());
-	stringstream ss(str, ios_base::in);
-
-//	read the octahedrons
-	int i1, i2, i3, i4, i5, i6;
-	while(!ss.eof()){
-	//	read the indices
-		ss >> i1 >> i2 >> i3 >> i4 >> i5 >> i6;
-
-	//	make sure that everything went right
-		if(ss.fail())
-			break;
-
-	//	make sure that the indices are valid
-		int maxInd = (int)vrts.size() - 1;
-		if(i1 < 0 || i1 > maxInd ||
-		   i2 < 0 || i2 > maxInd ||
-		   i3 < 0 || i3 > maxInd ||
-		   i4 < 0 || i4 > maxInd ||
-		   i5 < 0 || i5 > maxInd ||
-		   i6 < 0 || i6 > maxInd)
-		{
-			UG_LOG("  ERROR in GridReaderUGX::create_octahedrons: invalid vertex index.\n");
-			return false;
-		}
-
-	//	create the element
-		volsOut.push_back(
-			*grid.create<Octahedron>(OctahedronDescriptor(	vrts[i1], vrts[i2], vrts[i3],
-															vrts[i4], vrts[i5], vrts[i6])));
-	}
-
-	return true;
+	return CreateElementsInBulk<Octahedron>(volsOut, grid, node, vrts, "create_octahedrons");
 }
 
 
@@ -75,7 +75,7 @@ bool SaveGridToUGX(Grid& grid, ISubsetHandler& sh,
 				   const char* filename);
 
 ////////////////////////////////////////////////////////////////////////
-///	Reads a grid to an ugx file. internally uses GridReaderUGX.
+///	Reads a grid to an ugx file. internally uses GridReaderUGXStream.
 /**	The position attachment can be specified. Since the type of the
  *	position attachment is a template parameter, MathVector attachments
  * 	of any dimension are supported. Especially ug::aPosition, ug::aPostion2
@@ -290,6 +290,34 @@ class GridWriterUGX
 };
 
 
+////////////////////////////////////////////////////////////////////////
+//	helpers which are shared by GridReaderUGX and GridReaderUGXStream
+
+///	creates a refinement projector of the given type from its serialized data
+/**	Returns an invalid smart pointer if the data couldn't be read.*/
+SPRefinementProjector
+DeserializeProjectorUGX(const char* type, const std::string& data);
+
+///	links constrained vertices, edges and faces to their constraining objects
+/**	The i-th entry of constrainingObjsVRT holds the type (1: edge, 2: face) and
+ * the index of the constraining object of the i-th ConstrainedVertex in grid.
+ * The other lists are treated analogously. Indices refer to edges and faces.*/
+void ResolveConstrainingObjectsUGX(
+			Grid& grid, std::vector<Edge*>& edges, std::vector<Face*>& faces,
+			const std::vector<std::pair<int, int> >& constrainingObjsVRT,
+			const std::vector<std::pair<int, int> >& constrainingObjsEDGE,
+			const std::vector<std::pair<int, int> >& constrainingObjsTRI,
+			const std::vector<std::pair<int, int> >& constrainingObjsQUAD);
+
+///	reads the values of a global attachment of the given name and type from a stream
+/**	Undeclared global attachments are declared if their type is registered.
+ * Otherwise their values are ignored.*/
+template <class TElem>
+void ReadGlobalAttachmentUGX(Grid& grid, const std::string& name,
+							 const std::string& type, bool global, bool passOn,
+							 std::istream& in);
+
+
 ////////////////////////////////////////////////////////////////////////
 ///	Grants read access to ugx files.
 /**	Before any data can be retrieved using the get_* methods, a file
@@ -37,6 +37,7 @@
 #include <cstring>
 #include "lib_grid/algorithms/debug_util.h"
 #include "lib_grid/global_attachments.h"
+#include "file_io_ugx_stream.h"
 
 namespace ug
 {
@@ -58,23 +59,10 @@ template <class TAPosition>
 bool LoadGridFromUGX(Grid& grid, ISubsetHandler& sh, const char* filename,
 					 TAPosition& aPos)
 {
-	GridReaderUGX ugxReader;
-	if(!ugxReader.parse_file(filename)){
-		UG_LOG("ERROR in LoadGridFromUGX: File not found: " << filename << std::endl);
-		return false;
-	}
-
-	if(ugxReader.num_grids() < 1){
-		UG_LOG("ERROR in LoadGridFromUGX: File contains no grid.\n");
-		return false;
-	}
-
-	ugxReader.grid(grid, 0, aPos);
-
-	if(ugxReader.num_subset_handlers(0) > 0)
-		ugxReader.subset_handler(sh, 0, 0);
-
-	return true;
+//	the streaming reader avoids holding the whole file in memory
+	GridReaderUGXStream ugxReader;
+	ugxReader.set_subset_handler(sh);
+	return ugxReader.read(filename, grid, aPos);
 }
 
 
@@ -477,203 +465,9 @@ grid(Grid& gridOut, size_t index,
 	}
 	
 //	resolve constrained object relations
-	if(!constrainingObjsVRT.empty()){
-		//UG_LOG("num-edges: " << edges.size() << std::endl);
-	//	iterate over the pairs.
-	//	at the same time we'll iterate over the constrained vertices since
-	//	they are synchronized.
-		ConstrainedVertexIterator hvIter = grid.begin<ConstrainedVertex>();
-		for(std::vector<std::pair<int, int> >::iterator iter = constrainingObjsVRT.begin();
-			iter != constrainingObjsVRT.end(); ++iter, ++hvIter)
-		{
-			ConstrainedVertex* hv = *hvIter;
-			
-			switch(iter->first){
-				case 1:	// constraining object is an edge
-				{
-				//	make sure that the index is valid
-					if(iter->second >= 0 && iter->second < (int)edges.size()){
-					//	get the edge
-						ConstrainingEdge* edge = dynamic_cast<ConstrainingEdge*>(edges[iter->second]);
-						if(edge){
-							hv->set_constraining_object(edge);
-							edge->add_constrained_object(hv);
-						}
-						else{
-							UG_LOG("WARNING: Type-ID / type mismatch. Ignoring edge " << iter->second << ".\n");
-						}
-					}
-					else{
-						UG_LOG("ERROR in GridReaderUGX: Bad edge index in constrained vertex: " << iter->second << "\n");
-					}
-				}break;
-				
-				case 2:	// constraining object is an face
-				{
-				//	make sure that the index is valid
-					if(iter->second >= 0 && iter->second < (int)faces.size()){
-					//	get the edge
-						ConstrainingFace* face = dynamic_cast<ConstrainingFace*>(faces[iter->second]);
-						if(face){
-							hv->set_constraining_object(face);
-							face->add_constrained_object(hv);
-						}
-						else{
-							UG_LOG("WARNING in GridReaderUGX: Type-ID / type mismatch. Ignoring face " << iter->second << ".\n");
-						}
-					}
-					else{
-						UG_LOG("ERROR in GridReaderUGX: Bad face index in constrained vertex: " << iter->second << "\n");
-					}
-				}break;
-				
-				default:
-				{
-//					UG_LOG("WARNING in GridReaderUGX: unsupported type-id of constraining vertex"
-//							<< " at " << GetGridObjectCenter(grid, hv) << "\n");
-					break;
-				}
-			}
-		}
-	}
-
-	if(!constrainingObjsEDGE.empty()){
-	//	iterate over the pairs.
-	//	at the same time we'll iterate over the constrained vertices since
-	//	they are synchronized.
-		ConstrainedEdgeIterator ceIter = grid.begin<ConstrainedEdge>();
-		for(std::vector<std::pair<int, int> >::iterator iter = constrainingObjsEDGE.begin();
-			iter != constrainingObjsEDGE.end(); ++iter, ++ceIter)
-		{
-			ConstrainedEdge* ce = *ceIter;
-			
-			switch(iter->first){
-				case 1:	// constraining object is an edge
-				{
-				//	make sure that the index is valid
-					if(iter->second >= 0 && iter->second < (int)edges.size()){
-					//	get the edge
-						ConstrainingEdge* edge = dynamic_cast<ConstrainingEdge*>(edges[iter->second]);
-						if(edge){
-							ce->set_constraining_object(edge);
-							edge->add_constrained_object(ce);
-						}
-						else{
-							UG_LOG("WARNING in GridReaderUGX: Type-ID / type mismatch. Ignoring edge " << iter->second << ".\n");
-						}
-					}
-					else{
-						UG_LOG("ERROR in GridReaderUGX: Bad edge index in constrained edge.\n");
-					}
-				}break;
-				case 2:	// constraining object is an face
-				{
-				//	make sure that the index is valid
-					if(iter->second >= 0 && iter->second < (int)faces.size()){
-					//	get the edge
-						ConstrainingFace* face = dynamic_cast<ConstrainingFace*>(faces[iter->second]);
-						if(face){
-							ce->set_constraining_object(face);
-							face->add_constrained_object(ce);
-						}
-						else{
-							UG_LOG("WARNING in GridReaderUGX: Type-ID / type mismatch. Ignoring face " << iter->second << ".\n");
-						}
-					}
-					else{
-						UG_LOG("ERROR in GridReaderUGX: Bad face index in constrained edge: " << iter->second << "\n");
-					}
-				}break;
-				
-				default:
-				{
-//					UG_LOG("WARNING in GridReaderUGX: unsupported type-id of constraining edge"
-//							<< " at " << GetGridObjectCenter(grid, ce) << "\n");
-					break;
-				}
-			}
-		}
-	}
-
-	if(!constrainingObjsTRI.empty()){
-	//	iterate over the pairs.
-	//	at the same time we'll iterate over the constrained vertices since
-	//	they are synchronized.
-		ConstrainedTriangleIterator cfIter = grid.begin<ConstrainedTriangle>();
-		for(std::vector<std::pair<int, int> >::iterator iter = constrainingObjsTRI.begin();
-			iter != constrainingObjsTRI.end(); ++iter, ++cfIter)
-		{
-			ConstrainedFace* cdf = *cfIter;
-			
-			switch(iter->first){
-				case 2:	// constraining object is an face
-				{
-				//	make sure that the index is valid
-					if(iter->second >= 0 && iter->second < (int)faces.size()){
-					//	get the edge
-						ConstrainingFace* face = dynamic_cast<ConstrainingFace*>(faces[iter->second]);
-						if(face){
-							cdf->set_constraining_object(face);
-							face->add_constrained_object(cdf);
-						}
-						else{
-							UG_LOG("WARNING in GridReaderUGX: Type-ID / type mismatch. Ignoring face " << iter->second << ".\n");
-						}
-					}
-					else{
-						UG_LOG("ERROR in GridReaderUGX: Bad face index in constrained face: " << iter->second << "\n");
-					}
-				}break;
-				
-				default:
-				{
-//					UG_LOG("WARNING in GridReaderUGX: unsupported type-id of constraining triangle"
-//							<< " at " << GetGridObjectCenter(grid, cdf) << "\n");
-					break;
-				}
-			}
-		}
-	}
-
-	if(!constrainingObjsQUAD.empty()){
-	//	iterate over the pairs.
-	//	at the same time we'll iterate over the constrained vertices since
-	//	they are synchronized.
-		ConstrainedQuadrilateralIterator cfIter = grid.begin<ConstrainedQuadrilateral>();
-		for(std::vector<std::pair<int, int> >::iterator iter = constrainingObjsQUAD.begin();
-			iter != constrainingObjsQUAD.end(); ++iter, ++cfIter)
-		{
-			ConstrainedFace* cdf = *cfIter;
-			
-			switch(iter->first){
-				case 2:	// constraining object is an face
-				{
-				//	make sure that the index is valid
-					if(iter->second >= 0 && iter->second < (int)faces.size()){
-					//	get the edge
-						ConstrainingFace* face = dynamic_cast<ConstrainingFace*>(faces[iter->second]);
-						if(face){
-							cdf->set_constraining_object(face);
-							face->add_constrained_object(cdf);
-						}
-						else{
-							UG_LOG("WARNING in GridReaderUGX: Type-ID / type mismatch. Ignoring face " << iter->second << ".\n");
-						}
-					}
-					else{
-						UG_LOG("ERROR in GridReaderUGX: Bad face index in constrained face: " << iter->second << "\n");
-					}
-				}break;
-				
-				default:
-				{
-//					UG_LOG("WARNING in GridReaderUGX: unsupported type-id of constraining quadrilateral"
-//							<< " at " << GetGridObjectCenter(grid, cdf) << "\n");
-					break;
-				}
-			}
-		}
-	}
+	ResolveConstrainingObjectsUGX(grid, edges, faces,
+								  constrainingObjsVRT, constrainingObjsEDGE,
+								  constrainingObjsTRI, constrainingObjsQUAD);
 
 //	reenable the grids options.
 	grid.set_options(gridopts);
@@ -881,13 +675,26 @@ read_attachment(Grid& grid, rapidxml::xml_node<>* node)
 		passOn = bool(atoi(attrib->value()));
 	}
 	
+	string str(node->value(), node->value_size());
+	stringstream ss(str, ios_base::in);
+	ReadGlobalAttachmentUGX<TElem>(grid, name, type, global, passOn, ss);
+
+	return true;
+}
+
+
+template <class TElem>
+void ReadGlobalAttachmentUGX(Grid& grid, const std::string& name,
+							 const std::string& type, bool global, bool passOn,
+							 std::istream& in)
+{
 	if(global && !GlobalAttachments::is_declared(name)){
 		if(GlobalAttachments::type_is_registered(type)){
 			GlobalAttachments::declare_attachment(name, type, passOn);
 			// GlobalAttachments::mark_attachment_as_locally_declared(name);
 		}
 		else
-			return true;
+			return;
 	}
 
 	UG_COND_THROW(type.compare(GlobalAttachments::type_name(name)) != 0,
@@ -895,11 +702,7 @@ read_attachment(Grid& grid, rapidxml::xml_node<>* node)
 				  GlobalAttachments::type_name(name)
 				  << ", but given type is: " << type);
 
-	string str(node->value(), node->value_size());
-	stringstream ss(str, ios_base::in);
-	GlobalAttachments::read_attachment_values<TElem>(ss, grid, name);
-
-	return true;
+	GlobalAttachments::read_attachment_values<TElem>(in, grid, name);
 }
 
 }//	end of namespace
@@ -0,0 +1,1191 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <sstream>
+#include <streambuf>
+#include <istream>
+#include "file_io_ugx_stream.h"
+#include "file_io_ugx.h"
+#include "common/error.h"
+#include "common/log.h"
+#include "lib_grid/grid_objects/grid_objects.h"
+#include "lib_grid/refinement/projectors/projection_handler.h"
+
+#ifdef UG_ZLIB
+	#include <zlib.h>
+#endif
+
+#ifdef UG_ZSTD
+	#include <zstd.h>
+#endif
+
+using namespace std;
+
+namespace ug
+{
+
+namespace{
+
+///	size of the block in which the file is read
+const size_t UGX_STREAM_BUFFER_SIZE = 1 << 20;
+
+///	maximal length of a single number in a ugx file
+const size_t UGX_STREAM_MAX_TOKEN_LENGTH = 128;
+
+///	number of elements which are created through one call to Grid::create_bulk
+const size_t UGX_STREAM_BULK_SIZE = 1 << 16;
+
+////////////////////////////////////////////////////////////////////////
+///	reads plain, gzip or zstd compressed files block by block
+class UGXInputSource
+{
+	public:
+		UGXInputSource() :
+			m_file(NULL),
+			m_type(PLAIN)
+		{
+			#ifdef UG_ZLIB
+				m_gzFile = NULL;
+			#endif
+			#ifdef UG_ZSTD
+				m_zstdStream = NULL;
+				m_zstdLastRet = 0;
+			#endif
+		}
+
+		~UGXInputSource()	{close();}
+
+		bool open(const char* filename)
+		{
+			close();
+
+			m_file = fopen(filename, "rb");
+			if(!m_file){
+				UG_LOG("ERROR in GridReaderUGXStream: couldn't open file: " << filename << endl);
+				return false;
+			}
+
+		//	the compression is recognized by the magic number of the file
+			unsigned char magic[4] = {0, 0, 0, 0};
+			size_t numRead = fread(magic, 1, 4, m_file);
+			rewind(m_file);
+
+			if(numRead >= 2 && magic[0] == 0x1f && magic[1] == 0x8b){
+			#ifdef UG_ZLIB
+				fclose(m_file);
+				m_file = NULL;
+				m_gzFile = gzopen(filename, "rb");
+				if(!m_gzFile){
+					UG_LOG("ERROR in GridReaderUGXStream: couldn't open file: " << filename << endl);
+					return false;
+				}
+				gzbuffer(m_gzFile, 1 << 17);
+				m_type = GZIP;
+			#else
+				UG_LOG("ERROR in GridReaderUGXStream: " << filename << " is compressed "
+					   "with gzip, but ug was built without zlib support. Please "
+					   "reconfigure with -DUSE_ZLIB=ON.\n");
+				close();
+				return false;
+			#endif
+			}
+			else if(numRead == 4 && magic[0] == 0x28 && magic[1] == 0xb5
+					&& magic[2] == 0x2f && magic[3] == 0xfd)
+			{
+			#ifdef UG_ZSTD
+				m_zstdStream = ZSTD_createDStream();
+				UG_COND_THROW(!m_zstdStream, "GridReaderUGXStream: couldn't create zstd stream.");
+				ZSTD_initDStream(m_zstdStream);
+				m_zstdInBuf.resize(ZSTD_DStreamInSize());
+				m_zstdIn.src = &m_zstdInBuf.front();
+				m_zstdIn.size = 0;
+				m_zstdIn.pos = 0;
+				m_zstdLastRet = 0;
+				m_type = ZSTD;
+			#else
+				UG_LOG("ERROR in GridReaderUGXStream: " << filename << " is compressed "
+					   "with zstd, but ug was built without zstd support. Please "
+					   "reconfigure with -DUSE_ZSTD=ON.\n");
+				close();
+				return false;
+			#endif
+			}
+			else
+				m_type = PLAIN;
+
+			return true;
+		}
+
+	///	reads at most maxNumBytes bytes to dest. Returns 0 at the end of the file.
+		size_t read(char* dest, size_t maxNumBytes)
+		{
+			switch(m_type){
+				case PLAIN:
+					return fread(dest, 1, maxNumBytes, m_file);
+
+				case GZIP:{
+				#ifdef UG_ZLIB
+					int numRead = gzread(m_gzFile, dest, (unsigned int)maxNumBytes);
+					UG_COND_THROW(numRead < 0, "GridReaderUGXStream: error while "
+								  "decompressing a gzip file.");
+					if(numRead == 0){
+					//	gzread also returns 0 if the file ends within the stream
+						int err = Z_OK;
+						const char* msg = gzerror(m_gzFile, &err);
+						UG_COND_THROW(err != Z_OK && err != Z_STREAM_END,
+									  "GridReaderUGXStream: error while "
+									  "decompressing a gzip file: " << msg);
+					}
+					return (size_t)numRead;
+				#endif
+				}break;
+
+				case ZSTD:{
+				#ifdef UG_ZSTD
+					ZSTD_outBuffer out;
+					out.dst = dest;
+					out.size = maxNumBytes;
+					out.pos = 0;
+					while(out.pos == 0){
+						if(m_zstdIn.pos == m_zstdIn.size){
+							m_zstdIn.size = fread(&m_zstdInBuf.front(), 1,
+												  m_zstdInBuf.size(), m_file);
+							m_zstdIn.pos = 0;
+						//	at the end of the file the last frame has to be
+						//	complete. Data which didn't fit into the last
+						//	output buffer is flushed first.
+							if(m_zstdIn.size == 0 && m_zstdLastRet == 0)
+								break;
+						}
+						m_zstdLastRet = ZSTD_decompressStream(m_zstdStream, &out, &m_zstdIn);
+						UG_COND_THROW(ZSTD_isError(m_zstdLastRet), "GridReaderUGXStream: "
+									  "error while decompressing a zstd file: "
+									  << ZSTD_getErrorName(m_zstdLastRet));
+						UG_COND_THROW(m_zstdIn.size == 0 && out.pos == 0
+									  && m_zstdLastRet != 0,
+									  "GridReaderUGXStream: the zstd file ends "
+									  "within a frame. It is probably truncated.");
+					}
+					return out.pos;
+				#endif
+				}break;
+			}
+			return 0;
+		}
+
+		void close()
+		{
+			if(m_file)
+				fclose(m_file);
+			m_file = NULL;
+
+			#ifdef UG_ZLIB
+				if(m_gzFile)
+					gzclose(m_gzFile);
+				m_gzFile = NULL;
+			#endif
+
+			#ifdef UG_ZSTD
+				if(m_zstdStream)
+					ZSTD_freeDStream(m_zstdStream);
+				m_zstdStream = NULL;
+			#endif
+
+			m_type = PLAIN;
+		}
+
+	private:
+		enum Type{
+			PLAIN,
+			GZIP,
+			ZSTD
+		};
+
+		FILE*	m_file;
+		Type	m_type;
+
+	#ifdef UG_ZLIB
+		gzFile	m_gzFile;
+	#endif
+
+	#ifdef UG_ZSTD
+		ZSTD_DStream*		m_zstdStream;
+		std::vector<char>	m_zstdInBuf;
+		ZSTD_inBuffer		m_zstdIn;
+	///	last return value of ZSTD_decompressStream. 0 once a frame is complete.
+		size_t				m_zstdLastRet;
+	#endif
+};
+
+
+////////////////////////////////////////////////////////////////////////
+inline bool IsXMLSpace(char c)
+{
+	return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+///	replaces the predefined xml entities and character references in str
+void DecodeXMLEntities(std::string& str)
+{
+	size_t ampPos = str.find('&');
+	if(ampPos == string::npos)
+		return;
+
+	string out;
+	out.reserve(str.size());
+	out.append(str, 0, ampPos);
+	for(size_t i = ampPos; i < str.size();){
+		if(str[i] != '&'){
+			out.push_back(str[i++]);
+			continue;
+		}
+
+		size_t end = str.find(';', i);
+		if(end == string::npos){
+			out.append(str, i, string::npos);
+			break;
+		}
+
+		string ent = str.substr(i + 1, end - i - 1);
+		if(ent == "amp")		out.push_back('&');
+		else if(ent == "lt")	out.push_back('<');
+		else if(ent == "gt")	out.push_back('>');
+		else if(ent == "quot")	out.push_back('"');
+		else if(ent == "apos")	out.push_back('\'');
+		else if(ent.size() > 1 && ent[0] == '#'){
+			long code = (ent[1] == 'x') ? strtol(ent.c_str() + 2, NULL, 16)
+										: strtol(ent.c_str() + 1, NULL, 10);
+			out.push_back((char)code);
+		}
+		else
+			out.append(str, i, end - i + 1);
+		i = end + 1;
+	}
+	str.swap(out);
+}
+
+///	parses an int from [b, e). Returns false if the range doesn't hold a valid int.
+inline bool ParseInt(const char* b, const char* e, int& valOut)
+{
+	bool neg = false;
+	if(b != e && (*b == '-' || *b == '+')){
+		neg = (*b == '-');
+		++b;
+	}
+	if(b == e)
+		return false;
+
+	long long val = 0;
+	for(; b != e; ++b){
+		const unsigned d = (unsigned)(*b - '0');
+		if(d > 9)
+			return false;
+		val = val * 10 + d;
+		if(val > (long long)INT_MAX + 1)
+			return false;
+	}
+
+	if(neg)
+		val = -val;
+	if(val > INT_MAX)
+		return false;
+	valOut = (int)val;
+	return true;
+}
+
+///	parses a double from [b, e). Returns false if the range doesn't hold a valid double.
+/**	Numbers whose decimal mantissa has at most 53 bits and whose decimal
+ * exponent lies in [-22, 22] are converted exactly by a single
+ * multiplication or division. All others are passed to strtod, so that the
+ * result is always correctly rounded.*/
+bool ParseDouble(const char* b, const char* e, double& valOut)
+{
+	static const double pow10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+	const char* p = b;
+	bool neg = false;
+	if(p != e && (*p == '-' || *p == '+')){
+		neg = (*p == '-');
+		++p;
+	}
+
+	uint64 mant = 0;
+	int numDigits = 0;
+	int exp10 = 0;
+	bool anyDigit = false;
+	bool truncated = false;
+
+	for(; p != e && (unsigned)(*p - '0') <= 9; ++p){
+		anyDigit = true;
+		if(numDigits < 19){
+			mant = mant * 10 + (*p - '0');
+			if(mant != 0)
+				++numDigits;
+		}
+		else{
+			++exp10;
+			truncated |= (*p != '0');
+		}
+	}
+
+	if(p != e && *p == '.'){
+		for(++p; p != e && (unsigned)(*p - '0') <= 9; ++p){
+			anyDigit = true;
+			if(numDigits < 19){
+				mant = mant * 10 + (*p - '0');
+				if(mant != 0)
+					++numDigits;
+				--exp10;
+			}
+			else
+				truncated |= (*p != '0');
+		}
+	}
+
+	bool fastPath = anyDigit && !truncated;
+	if(fastPath && p != e && (*p == 'e' || *p == 'E')){
+		++p;
+		bool negExp = false;
+		if(p != e && (*p == '-' || *p == '+')){
+			negExp = (*p == '-');
+			++p;
+		}
+		if(p == e)
+			return false;
+		int exp = 0;
+		for(; p != e && (unsigned)(*p - '0') <= 9; ++p){
+			if(exp < 100000)
+				exp = exp * 10 + (*p - '0');
+		}
+		exp10 += negExp ? -exp : exp;
+	}
+
+	if(fastPath && p == e && mant <= (uint64(1) << 53)
+	   && exp10 >= -22 && exp10 <= 22)
+	{
+		double val = (double)mant;
+		if(exp10 < 0)
+			val /= pow10[-exp10];
+		else
+			val *= pow10[exp10];
+		valOut = neg ? -val : val;
+		return true;
+	}
+
+//	slow path for long mantissas, large exponents and special values
+	char buf[UGX_STREAM_MAX_TOKEN_LENGTH + 1];
+	const size_t len = e - b;
+	if(len == 0 || len > UGX_STREAM_MAX_TOKEN_LENGTH)
+		return false;
+	memcpy(buf, b, len);
+	buf[len] = 0;
+	char* end;
+	valOut = strtod(buf, &end);
+	return end == buf + len;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+///	a minimal pull parser for the xml subset used by ugx files
+/**	The parser works on a buffer of fixed size which is refilled from a
+ * UGXInputSource. Tags are returned through next_tag. The text content of
+ * an element can be read directly after its start tag was returned, either
+ * as numbers through read_int and read_double or as raw text.
+ *
+ * Each element has to be consumed completely before the next sibling is
+ * processed, either through next_child until it returns false or through
+ * skip_element.*/
+class UGXStreamParser
+{
+	public:
+		enum TagType{
+			START_TAG,
+			END_TAG,
+			END_OF_FILE
+		};
+
+		UGXStreamParser(UGXInputSource& src) :
+			m_src(src),
+			m_buf(UGX_STREAM_BUFFER_SIZE),
+			m_pos(0),
+			m_end(0),
+			m_srcEmpty(false),
+			m_emptyElement(false)
+		{}
+
+	///	skips the remaining content and returns the next start or end tag.
+		TagType next_tag()
+		{
+			m_emptyElement = false;
+			for(;;){
+			//	find the next '<'
+				for(;;){
+					if(m_pos == m_end && !fill(1))
+						return END_OF_FILE;
+					const char* b = &m_buf[m_pos];
+					const void* lt = memchr(b, '<', m_end - m_pos);
+					if(lt){
+						m_pos += (const char*)lt - b;
+						break;
+					}
+					m_pos = m_end;
+				}
+				++m_pos;
+
+				int c = peek();
+				if(c == '?'){
+					skip_past("?>");
+					continue;
+				}
+				if(c == '!'){
+					if(fill(3) && m_buf[m_pos + 1] == '-' && m_buf[m_pos + 2] == '-')
+						skip_past("-->");
+					else
+						skip_past(">");
+					continue;
+				}
+				if(c == '/'){
+					++m_pos;
+					read_name(m_tagName);
+					skip_past(">");
+					return END_TAG;
+				}
+
+				read_name(m_tagName);
+				read_attributes();
+				return START_TAG;
+			}
+		}
+
+	///	returns true and the start tag of the next child of the current element
+	/**	If the end of the current element is reached, false is returned.*/
+		bool next_child()
+		{
+			if(m_emptyElement){
+				m_emptyElement = false;
+				return false;
+			}
+			TagType t = next_tag();
+			UG_COND_THROW(t == END_OF_FILE, "GridReaderUGXStream: unexpected end of file.");
+			return t == START_TAG;
+		}
+
+	///	skips the remainder of the element whose start tag was returned last
+		void skip_element()
+		{
+			if(m_emptyElement){
+				m_emptyElement = false;
+				return;
+			}
+			int depth = 1;
+			while(depth > 0){
+				TagType t = next_tag();
+				UG_COND_THROW(t == END_OF_FILE, "GridReaderUGXStream: unexpected end of file.");
+				if(t == END_TAG)
+					--depth;
+				else if(!m_emptyElement)
+					++depth;
+			}
+			m_emptyElement = false;
+		}
+
+		const std::string& tag_name() const		{return m_tagName;}
+
+	///	returns the value of the given attribute of the last start tag or NULL
+		const char* attribute(const char* name) const
+		{
+			for(size_t i = 0; i < m_attribs.size(); ++i){
+				if(m_attribs[i].first == name)
+					return m_attribs[i].second.c_str();
+			}
+			return NULL;
+		}
+
+		bool read_int(int& valOut)
+		{
+			const char* b;
+			const char* e;
+			if(!next_token(b, e))
+				return false;
+			UG_COND_THROW(!ParseInt(b, e, valOut),
+						  "GridReaderUGXStream: invalid integer '" << string(b, e)
+						  << "' in element '" << m_tagName << "'.");
+			return true;
+		}
+
+		bool read_double(double& valOut)
+		{
+			const char* b;
+			const char* e;
+			if(!next_token(b, e))
+				return false;
+			UG_COND_THROW(!ParseDouble(b, e, valOut),
+						  "GridReaderUGXStream: invalid number '" << string(b, e)
+						  << "' in element '" << m_tagName << "'.");
+			return true;
+		}
+
+	///	copies at most maxNumChars characters of the current content to dest
+	/**	Returns the number of copied characters. 0 indicates the end of the content.*/
+		size_t read_content(char* dest, size_t maxNumChars)
+		{
+			if(m_emptyElement)
+				return 0;
+			if(m_pos == m_end && !fill(1))
+				return 0;
+			const char* b = &m_buf[m_pos];
+			size_t num = std::min(maxNumChars, m_end - m_pos);
+			const void* lt = memchr(b, '<', num);
+			if(lt)
+				num = (const char*)lt - b;
+			memcpy(dest, b, num);
+			m_pos += num;
+			return num;
+		}
+
+	///	reads the remaining text of the current content and decodes its entities
+		void read_content(std::string& strOut)
+		{
+			strOut.clear();
+			char buf[4096];
+			size_t num;
+			while((num = read_content(buf, sizeof(buf))) > 0)
+				strOut.append(buf, num);
+			DecodeXMLEntities(strOut);
+		}
+
+	private:
+	///	makes sure that at least minNumChars characters are available in the buffer
+	/**	Returns false if the end of the file is reached before.*/
+		bool fill(size_t minNumChars)
+		{
+			if(m_end - m_pos >= minNumChars)
+				return true;
+
+			if(m_pos > 0){
+				memmove(&m_buf[0], &m_buf[m_pos], m_end - m_pos);
+				m_end -= m_pos;
+				m_pos = 0;
+			}
+
+			while(m_end < minNumChars && !m_srcEmpty){
+				size_t numRead = m_src.read(&m_buf[m_end], m_buf.size() - m_end);
+				if(numRead == 0)
+					m_srcEmpty = true;
+				m_end += numRead;
+			}
+			return m_end >= minNumChars;
+		}
+
+		inline int peek()
+		{
+			if(m_pos == m_end && !fill(1))
+				return EOF;
+			return (unsigned char)m_buf[m_pos];
+		}
+
+		inline int get()
+		{
+			int c = peek();
+			if(c != EOF)
+				++m_pos;
+			return c;
+		}
+
+		void skip_space()
+		{
+			int c;
+			while((c = peek()) != EOF && IsXMLSpace((char)c))
+				++m_pos;
+		}
+
+		void skip_past(const char* pattern)
+		{
+			const size_t len = strlen(pattern);
+			size_t matched = 0;
+			while(matched < len){
+				int c = get();
+				UG_COND_THROW(c == EOF, "GridReaderUGXStream: unexpected end of file.");
+				if(c == pattern[matched])
+					++matched;
+				else
+					matched = (c == pattern[0]) ? 1 : 0;
+			}
+		}
+
+		void read_name(std::string& nameOut)
+		{
+			nameOut.clear();
+			int c;
+			while((c = peek()) != EOF && !IsXMLSpace((char)c)
+				  && c != '/' && c != '>' && c != '=')
+			{
+				nameOut.push_back((char)c);
+				++m_pos;
+			}
+		}
+
+		void read_attributes()
+		{
+			m_attribs.clear();
+			for(;;){
+				skip_space();
+				int c = get();
+				UG_COND_THROW(c == EOF, "GridReaderUGXStream: unexpected end of file.");
+				if(c == '>')
+					return;
+				if(c == '/'){
+					UG_COND_THROW(get() != '>', "GridReaderUGXStream: malformed tag '"
+								  << m_tagName << "'.");
+					m_emptyElement = true;
+					return;
+				}
+				--m_pos;
+
+				m_attribs.push_back(std::make_pair(string(), string()));
+				read_name(m_attribs.back().first);
+				skip_space();
+				UG_COND_THROW(get() != '=', "GridReaderUGXStream: malformed attribute '"
+							  << m_attribs.back().first << "' in tag '" << m_tagName << "'.");
+				skip_space();
+				const int quote = get();
+				UG_COND_THROW(quote != '"' && quote != '\'', "GridReaderUGXStream: "
+							  "malformed attribute '" << m_attribs.back().first
+							  << "' in tag '" << m_tagName << "'.");
+				string& value = m_attribs.back().second;
+				while((c = get()) != quote){
+					UG_COND_THROW(c == EOF, "GridReaderUGXStream: unexpected end of file.");
+					value.push_back((char)c);
+				}
+				DecodeXMLEntities(value);
+			}
+		}
+
+	///	returns the range of the next whitespace separated token in the current content
+		bool next_token(const char*& bOut, const char*& eOut)
+		{
+			if(m_emptyElement)
+				return false;
+
+			for(;;){
+				if(m_pos == m_end && !fill(1))
+					return false;
+				const char c = m_buf[m_pos];
+				if(c == '<')
+					return false;
+				if(!IsXMLSpace(c))
+					break;
+				++m_pos;
+			}
+
+			fill(UGX_STREAM_MAX_TOKEN_LENGTH);
+			const char* b = &m_buf[m_pos];
+			const char* e = b + (m_end - m_pos);
+			const char* p = b;
+			while(p != e && *p != '<' && !IsXMLSpace(*p))
+				++p;
+			UG_COND_THROW(p == e && !m_srcEmpty,
+						  "GridReaderUGXStream: token too long in element '"
+						  << m_tagName << "'.");
+			bOut = b;
+			eOut = p;
+			m_pos += p - b;
+			return true;
+		}
+
+		UGXInputSource&		m_src;
+		std::vector<char>	m_buf;
+		size_t				m_pos;
+		size_t				m_end;
+		bool				m_srcEmpty;
+
+		std::string			m_tagName;
+		std::vector<std::pair<std::string, std::string> >	m_attribs;
+
+	///	true if the last start tag was an empty-element tag, e.g. <vertices/>
+		bool				m_emptyElement;
+};
+
+
+///	gives stream access to the content of the current element of a UGXStreamParser
+class UGXContentStreamBuf : public std::streambuf
+{
+	public:
+		UGXContentStreamBuf(UGXStreamParser& parser) : m_parser(parser)	{}
+
+	protected:
+		virtual int_type underflow()
+		{
+			size_t num = m_parser.read_content(m_buf, sizeof(m_buf));
+			if(num == 0)
+				return traits_type::eof();
+			setg(m_buf, m_buf, m_buf + num);
+			return traits_type::to_int_type(m_buf[0]);
+		}
+
+	private:
+		UGXStreamParser&	m_parser;
+		char				m_buf[4096];
+};
+
+
+////////////////////////////////////////////////////////////////////////
+///	the elements which were read so far and the pending constraint relations
+struct UGXStreamGridData
+{
+	std::vector<Vertex*>	vertices;
+	std::vector<Edge*>		edges;
+	std::vector<Face*>		faces;
+	std::vector<Volume*>	volumes;
+
+	std::vector<std::pair<int, int> >	constrainingObjsVRT;
+	std::vector<std::pair<int, int> >	constrainingObjsEDGE;
+	std::vector<std::pair<int, int> >	constrainingObjsTRI;
+	std::vector<std::pair<int, int> >	constrainingObjsQUAD;
+};
+
+inline int NumSourceCoords(UGXStreamParser& parser)
+{
+	const char* attrib = parser.attribute("coords");
+	int numSrcCoords = attrib ? atoi(attrib) : -1;
+	UG_COND_THROW(numSrcCoords < 1, "GridReaderUGXStream: invalid 'coords' "
+				  "attribute in element '" << parser.tag_name() << "'.");
+	return numSrcCoords;
+}
+
+///	reads the coordinates of one vertex. Returns false if the content ends first.
+/**	Missing coordinates are set to 0, additional ones are ignored.*/
+template <class vector_t>
+bool ReadCoordinates(UGXStreamParser& parser, int numSrcCoords, vector_t& vOut)
+{
+	const int numDestCoords = (int)vector_t::Size;
+	double val;
+	for(int i = 0; i < numSrcCoords; ++i){
+		if(!parser.read_double(val))
+			return false;
+		if(i < numDestCoords)
+			vOut[i] = (number)val;
+	}
+	for(int i = numSrcCoords; i < numDestCoords; ++i)
+		vOut[i] = 0;
+	return true;
+}
+
+template <class TAAPos>
+void ReadVertices(UGXStreamParser& parser, Grid& grid, TAAPos& aaPos,
+				  std::vector<Vertex*>& vrtsOut)
+{
+	typedef typename TAAPos::ValueType	vector_t;
+	const int numSrcCoords = NumSourceCoords(parser);
+
+	vector_t v;
+	while(ReadCoordinates(parser, numSrcCoords, v)){
+		RegularVertex* vrt = *grid.create<RegularVertex>();
+		vrtsOut.push_back(vrt);
+		aaPos[vrt] = v;
+	}
+}
+
+template <class TAAPos>
+void ReadConstrainedVertices(UGXStreamParser& parser, Grid& grid, TAAPos& aaPos,
+							 std::vector<Vertex*>& vrtsOut,
+							 std::vector<std::pair<int, int> >& constrainingObjsOut)
+{
+	typedef typename TAAPos::ValueType	vector_t;
+	const int numSrcCoords = NumSourceCoords(parser);
+
+	vector_t v;
+	while(ReadCoordinates(parser, numSrcCoords, v)){
+	//	the type of the constraining object, its index and the local coordinates
+		int conObjType = -1;
+		int conObjIndex = -1;
+		double localCoords[2] = {0, 0};
+		if(!parser.read_int(conObjType))
+			break;
+		if(conObjType != -1 && !parser.read_int(conObjIndex))
+			break;
+		if(conObjType == 1 && !parser.read_double(localCoords[0]))
+			break;
+		if(conObjType == 2 && !(parser.read_double(localCoords[0])
+								&& parser.read_double(localCoords[1])))
+			break;
+
+		ConstrainedVertex* vrt = *grid.create<ConstrainedVertex>();
+		vrtsOut.push_back(vrt);
+		aaPos[vrt] = v;
+		vrt->set_local_coordinates((number)localCoords[0], (number)localCoords[1]);
+		constrainingObjsOut.push_back(std::make_pair(conObjType, conObjIndex));
+	}
+}
+
+///	reads vertex index tuples and creates the elements in batches.
+/**	If constrainingObjsOut is specified, each tuple is followed by the type and
+ * the index of the constraining object, as for constrained edges and faces.
+ * An incomplete trailing tuple is ignored.*/
+template <class TElem>
+void ReadElements(UGXStreamParser& parser, Grid& grid, std::vector<Vertex*>& vrts,
+				  std::vector<typename geometry_traits<TElem>::grid_base_object*>& elemsOut,
+				  std::vector<std::pair<int, int> >* constrainingObjsOut = NULL)
+{
+	const size_t numCorners = TElem::NUM_VERTICES;
+	const int maxInd = (int)vrts.size() - 1;
+
+	std::vector<int> inds;
+	inds.reserve(UGX_STREAM_BULK_SIZE * numCorners);
+
+	for(;;){
+		size_t i = 0;
+		int ind;
+		for(; i < numCorners; ++i){
+			if(!parser.read_int(ind))
+				break;
+			UG_COND_THROW(ind < 0 || ind > maxInd, "GridReaderUGXStream: invalid "
+						  "vertex index " << ind << " in element '"
+						  << parser.tag_name() << "'.");
+			inds.push_back(ind);
+		}
+
+		bool complete = (i == numCorners);
+		if(complete && constrainingObjsOut){
+			int conObjType = -1;
+			int conObjIndex = -1;
+			if(!parser.read_int(conObjType)
+			   || (conObjType != -1 && !parser.read_int(conObjIndex)))
+			{
+				complete = false;
+			}
+			else
+				constrainingObjsOut->push_back(std::make_pair(conObjType, conObjIndex));
+		}
+
+		if(!complete){
+		//	the content ended. Remove the indices of an incomplete tuple.
+			inds.resize(inds.size() - i);
+			break;
+		}
+
+		if(inds.size() == UGX_STREAM_BULK_SIZE * numCorners){
+			grid.create_bulk<TElem>(vrts, &inds.front(), UGX_STREAM_BULK_SIZE, &elemsOut);
+			inds.clear();
+		}
+	}
+
+	if(!inds.empty())
+		grid.create_bulk<TElem>(vrts, &inds.front(), inds.size() / numCorners, &elemsOut);
+}
+
+template <class TElem>
+void ReadAttachment(UGXStreamParser& parser, Grid& grid)
+{
+	const char* attrib = parser.attribute("name");
+	UG_COND_THROW(!attrib, "Invalid attachment entry: No 'name' attribute was supplied!");
+	string name = attrib;
+
+	attrib = parser.attribute("type");
+	UG_COND_THROW(!attrib, "Invalid attachment entry: No 'type' attribute was supplied!");
+	string type = attrib;
+
+	bool global = false;
+	if((attrib = parser.attribute("global")))
+		global = bool(atoi(attrib));
+
+	bool passOn = false;
+	if((attrib = parser.attribute("passOn")))
+		passOn = bool(atoi(attrib));
+
+	UGXContentStreamBuf buf(parser);
+	istream in(&buf);
+	ReadGlobalAttachmentUGX<TElem>(grid, name, type, global, passOn, in);
+}
+
+template <class TElem>
+void ReadSubsetElements(UGXStreamParser& parser, ISubsetHandler& sh, int subsetIndex,
+						std::vector<TElem*>& elems)
+{
+	int index;
+	while(parser.read_int(index)){
+		if(index >= 0 && index < (int)elems.size())
+			sh.assign_subset(elems[index], subsetIndex);
+		else{
+			UG_LOG("Bad element index in subset-node " << parser.tag_name() <<
+					": " << index << ". Ignoring element.\n");
+			return;
+		}
+	}
+}
+
+void ReadSubsetHandler(UGXStreamParser& parser, ISubsetHandler& sh,
+					   UGXStreamGridData& data)
+{
+	int subsetInd = 0;
+	while(parser.next_child()){
+		if(parser.tag_name() != "subset"){
+			parser.skip_element();
+			continue;
+		}
+
+	//	retrieve an initial subset-info from sh, so that initialised values are kept.
+		SubsetInfo si = sh.subset_info(subsetInd);
+
+		const char* attrib = parser.attribute("name");
+		if(attrib)
+			si.name = attrib;
+
+		attrib = parser.attribute("color");
+		if(attrib){
+			stringstream ss(attrib, ios_base::in);
+			for(size_t i = 0; i < 4; ++i)
+				ss >> si.color[i];
+		}
+
+		attrib = parser.attribute("state");
+		if(attrib){
+			stringstream ss(attrib, ios_base::in);
+			size_t state;
+			ss >> state;
+			si.subsetState = (uint)state;
+		}
+
+		sh.set_subset_info(subsetInd, si);
+
+	//	read elements of this subset
+		while(parser.next_child()){
+			const string& name = parser.tag_name();
+			if(name == "vertices" && sh.elements_are_supported(SHE_VERTEX))
+				ReadSubsetElements(parser, sh, subsetInd, data.vertices);
+			else if(name == "edges" && sh.elements_are_supported(SHE_EDGE))
+				ReadSubsetElements(parser, sh, subsetInd, data.edges);
+			else if(name == "faces" && sh.elements_are_supported(SHE_FACE))
+				ReadSubsetElements(parser, sh, subsetInd, data.faces);
+			else if(name == "volumes" && sh.elements_are_supported(SHE_VOLUME))
+				ReadSubsetElements(parser, sh, subsetInd, data.volumes);
+			parser.skip_element();
+		}
+		++subsetInd;
+	}
+}
+
+void ReadProjectionHandler(UGXStreamParser& parser, ProjectionHandler& ph)
+{
+	string data;
+	while(parser.next_child()){
+		const string& name = parser.tag_name();
+		const char* attribType = parser.attribute("type");
+		if(attribType && (name == "default" || name == "projector")){
+			string type = attribType;
+			const char* attribSI = parser.attribute("subset");
+			const int si = attribSI ? atoi(attribSI) : -1;
+
+			parser.read_content(data);
+			SPRefinementProjector proj = DeserializeProjectorUGX(type.c_str(), data);
+			if(proj.valid()){
+				if(name == "default")
+					ph.set_default_projector(proj);
+				else if(attribSI)
+					ph.set_projector(si, proj);
+			}
+		}
+		parser.skip_element();
+	}
+}
+
+}//	end of anonymous namespace
+
+
+
+////////////////////////////////////////////////////////////////////////
+GridReaderUGXStream::
+GridReaderUGXStream() :
+	m_sh(NULL),
+	m_ph(NULL),
+	m_phRead(false)
+{
+}
+
+void GridReaderUGXStream::
+add_subset_handler(ISubsetHandler& sh, const char* name)
+{
+	m_namedSHs.push_back(NamedSubsetHandler(&sh, name));
+}
+
+template <class TAPosition>
+bool GridReaderUGXStream::
+read(const char* filename, Grid& grid, TAPosition& aPos, size_t gridIndex)
+{
+	typedef UGXStreamParser	Parser;
+
+	m_phRead = false;
+	m_phSHName.clear();
+
+	UGXInputSource src;
+	if(!src.open(filename))
+		return false;
+
+	Parser parser(src);
+
+//	find the requested grid
+	for(size_t curGridInd = 0;;){
+		Parser::TagType t = parser.next_tag();
+		if(t == Parser::END_OF_FILE){
+			UG_LOG("ERROR in GridReaderUGXStream::read: File contains no grid with "
+				   "index " << gridIndex << ": " << filename << endl);
+			return false;
+		}
+		if(t == Parser::START_TAG && parser.tag_name() == "grid"){
+			if(curGridInd == gridIndex)
+				break;
+			parser.skip_element();
+			++curGridInd;
+		}
+	}
+
+//	Since we have to create all elements in the correct order and
+//	since we have to make sure that no elements are created in between,
+//	we'll first disable all grid-options and reenable them later on
+	uint gridopts = grid.get_options();
+	grid.set_options(GRIDOPT_NONE);
+
+	if(!grid.has_vertex_attachment(aPos))
+		grid.attach_to_vertices(aPos);
+	Grid::VertexAttachmentAccessor<TAPosition> aaPos(grid, aPos);
+
+	UGXStreamGridData data;
+	std::vector<string> shNames;
+	int phSHIndex = 0;
+
+	while(parser.next_child()){
+		const string& name = parser.tag_name();
+		if(name == "vertices")
+			ReadVertices(parser, grid, aaPos, data.vertices);
+		else if(name == "constrained_vertices")
+			ReadConstrainedVertices(parser, grid, aaPos, data.vertices,
+									data.constrainingObjsVRT);
+		else if(name == "edges")
+			ReadElements<RegularEdge>(parser, grid, data.vertices, data.edges);
+		else if(name == "constraining_edges")
+			ReadElements<ConstrainingEdge>(parser, grid, data.vertices, data.edges);
+		else if(name == "constrained_edges")
+			ReadElements<ConstrainedEdge>(parser, grid, data.vertices, data.edges,
+										  &data.constrainingObjsEDGE);
+		else if(name == "triangles")
+			ReadElements<Triangle>(parser, grid, data.vertices, data.faces);
+		else if(name == "constraining_triangles")
+			ReadElements<ConstrainingTriangle>(parser, grid, data.vertices, data.faces);
+		else if(name == "constrained_triangles")
+			ReadElements<ConstrainedTriangle>(parser, grid, data.vertices, data.faces,
+											  &data.constrainingObjsTRI);
+		else if(name == "quadrilaterals")
+			ReadElements<Quadrilateral>(parser, grid, data.vertices, data.faces);
+		else if(name == "constraining_quadrilaterals")
+			ReadElements<ConstrainingQuadrilateral>(parser, grid, data.vertices, data.faces);
+		else if(name == "constrained_quadrilaterals")
+			ReadElements<ConstrainedQuadrilateral>(parser, grid, data.vertices, data.faces,
+												   &data.constrainingObjsQUAD);
+		else if(name == "tetrahedrons")
+			ReadElements<Tetrahedron>(parser, grid, data.vertices, data.volumes);
+		else if(name == "hexahedrons")
+			ReadElements<Hexahedron>(parser, grid, data.vertices, data.volumes);
+		else if(name == "prisms")
+			ReadElements<Prism>(parser, grid, data.vertices, data.volumes);
+		else if(name == "pyramids")
+			ReadElements<Pyramid>(parser, grid, data.vertices, data.volumes);
+		else if(name == "octahedrons")
+			ReadElements<Octahedron>(parser, grid, data.vertices, data.volumes);
+
+		else if(name == "vertex_attachment")
+			ReadAttachment<Vertex>(parser, grid);
+		else if(name == "edge_attachment")
+			ReadAttachment<Edge>(parser, grid);
+		else if(name == "face_attachment")
+			ReadAttachment<Face>(parser, grid);
+		else if(name == "volume_attachment")
+			ReadAttachment<Volume>(parser, grid);
+
+		else if(name == "subset_handler"){
+			const char* attrib = parser.attribute("name");
+			shNames.push_back(attrib ? attrib : "");
+
+			ISubsetHandler* sh = (shNames.size() == 1) ? m_sh : NULL;
+			for(size_t i = 0; i < m_namedSHs.size() && !sh; ++i){
+				if(m_namedSHs[i].name == shNames.back())
+					sh = m_namedSHs[i].sh;
+			}
+
+			if(sh){
+				ReadSubsetHandler(parser, *sh, data);
+				continue;
+			}
+		}
+
+		else if(name == "projection_handler" && m_ph && !m_phRead){
+			const char* attrib = parser.attribute("subset_handler");
+			phSHIndex = attrib ? atoi(attrib) : 0;
+			ReadProjectionHandler(parser, *m_ph);
+			m_phRead = true;
+			continue;
+		}
+
+		parser.skip_element();
+	}
+
+	ResolveConstrainingObjectsUGX(grid, data.edges, data.faces,
+								  data.constrainingObjsVRT, data.constrainingObjsEDGE,
+								  data.constrainingObjsTRI, data.constrainingObjsQUAD);
+
+//	reenable the grids options.
+	grid.set_options(gridopts);
+
+	if(m_phRead && phSHIndex > 0){
+		UG_COND_THROW(phSHIndex >= (int)shNames.size(),
+					  "GridReaderUGXStream: projection handler refers to subset "
+					  "handler " << phSHIndex << ", which doesn't exist.");
+		m_phSHName = shNames[phSHIndex];
+	}
+
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//	explicit template instantiations
+template bool GridReaderUGXStream::read<APosition1>(const char*, Grid&, APosition1&, size_t);
+template bool GridReaderUGXStream::read<APosition2>(const char*, Grid&, APosition2&, size_t);
+template bool GridReaderUGXStream::read<APosition3>(const char*, Grid&, APosition3&, size_t);
+
+}//	end of namespace
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__LIB_GRID__FILE_IO_UGX_STREAM__
+#define __H__LIB_GRID__FILE_IO_UGX_STREAM__
+
+#include <string>
+#include <vector>
+#include "lib_grid/grid/grid.h"
+#include "lib_grid/tools/subset_handler_interface.h"
+#include "lib_grid/common_attachments.h"
+
+namespace ug
+{
+
+class ProjectionHandler;
+
+////////////////////////////////////////////////////////////////////////
+///	Reads ugx files in a single pass without building an xml document.
+/**	In contrast to GridReaderUGX, the file is never held in memory as a
+ * whole. It is read in small blocks and the elements of each node are
+ * created while the node is parsed, corner-only elements in batches through
+ * Grid::create_bulk. Numbers are parsed directly from the read buffer.
+ * Peak memory usage thus is dominated by the grid itself.
+ *
+ * Files compressed with gzip or zstd are recognized by their magic numbers
+ * and are decompressed on the fly, if ug was built with USE_ZLIB or
+ * USE_ZSTD respectively.
+ *
+ * Since everything is read in one pass, the targets have to be specified
+ * before read is called: The subset handler at index 0 in the file is read
+ * to the handler specified by set_subset_handler, further subset handlers
+ * are read if a handler with the same name was added through
+ * add_subset_handler. The first projection handler in the file is read to
+ * the handler specified by set_projection_handler. Selectors are ignored.
+ *
+ * Errors in the file result in an exception.*/
+class GridReaderUGXStream
+{
+	public:
+		GridReaderUGXStream();
+
+	///	the subset handler at index 0 in the file is read to the given handler
+		void set_subset_handler(ISubsetHandler& sh)	{m_sh = &sh;}
+
+	///	a subset handler with the given name in the file is read to the given handler
+		void add_subset_handler(ISubsetHandler& sh, const char* name);
+
+	///	the first projection handler in the file is read to the given handler
+	/**	The subset handler of ph is not changed. If the projection handler in
+	 * the file refers to a subset handler other than the one at index 0, the
+	 * name of that handler is returned by projection_handler_subset_handler_name.*/
+		void set_projection_handler(ProjectionHandler& ph)	{m_ph = &ph;}
+
+	///	reads the grid at index gridIndex in the given file.
+	/**	If aPos isn't attached to the vertices of grid yet, it is attached.*/
+		template <class TAPosition>
+		bool read(const char* filename, Grid& grid, TAPosition& aPos,
+				  size_t gridIndex = 0);
+
+	///	returns true if a projection handler was read during the last call to read
+		bool projection_handler_read() const		{return m_phRead;}
+
+	///	name of the subset handler referenced by the projection handler which was read
+	/**	Empty if the projection handler refers to the subset handler at index 0.*/
+		const std::string& projection_handler_subset_handler_name() const
+			{return m_phSHName;}
+
+	private:
+		struct NamedSubsetHandler{
+			NamedSubsetHandler(ISubsetHandler* sh_, const char* name_) :
+				sh(sh_), name(name_)	{}
+			ISubsetHandler*	sh;
+			std::string		name;
+		};
+
+		ISubsetHandler*					m_sh;
+		std::vector<NamedSubsetHandler>	m_namedSHs;
+		ProjectionHandler*				m_ph;
+		bool							m_phRead;
+		std::string						m_phSHName;
+};
+
+}//	end of namespace
+
+#endif
@@ -60,6 +60,8 @@ Grid::Grid() :
 	m_aVolumeContainer("Grid_VolumeContainer", false),
 	m_bMarking(false),
 	m_aMark("Grid_Mark", false),
+	m_vertexTupleHash(NULL),
+	m_frozenTopology(NULL),
 	m_distGridMgr(NULL),
 	m_periodicBndMgr(NULL)
 {
@@ -78,6 +80,8 @@ Grid::Grid(uint options) :
 	m_aVolumeContainer("Grid_VolumeContainer", false),
 	m_bMarking(false),
 	m_aMark("Grid_Mark", false),
+	m_vertexTupleHash(NULL),
+	m_frozenTopology(NULL),
 	m_distGridMgr(NULL),
 	m_periodicBndMgr(NULL)
 {
@@ -96,6 +100,8 @@ Grid::Grid(const Grid& grid) :
 	m_aVolumeContainer("Grid_VolumeContainer", false),
 	m_bMarking(false),
 	m_aMark("Grid_Mark", false),
+	m_vertexTupleHash(NULL),
+	m_frozenTopology(NULL),
 	m_distGridMgr(NULL),
 	m_periodicBndMgr(NULL)
 {
@@ -123,6 +129,7 @@ Grid::~Grid()
 	#endif
 
 	if(m_periodicBndMgr)		delete m_periodicBndMgr;
+	if(m_vertexTupleHash)		delete m_vertexTupleHash;
 }
 
 void Grid::notify_and_clear_observers_on_grid_destruction(GridObserver* initiator)
@@ -201,6 +208,20 @@ void Grid::set_periodic_boundaries(bool is_periodic)
 	}
 }
 
+void Grid::set_vertex_tuple_hash(bool enable)
+{
+	if(enable){
+		if(!m_vertexTupleHash){
+			m_vertexTupleHash = new VertexTupleHash;
+			m_vertexTupleHash->set_grid(this);
+		}
+	}
+	else if(m_vertexTupleHash){
+		delete m_vertexTupleHash;
+		m_vertexTupleHash = NULL;
+	}
+}
+
 bool Grid::has_periodic_boundaries() const
 {
 	return m_periodicBndMgr != NULL;
@@ -225,6 +246,13 @@ void Grid::clear()
 
 void Grid::clear_geometry()
 {
+//	all elements are erased anyways, so the compacted associated elements don't
+//	have to be restored to the per-element containers
+	if(m_frozenTopology){
+		delete m_frozenTopology;
+		m_frozenTopology = NULL;
+	}
+
 //	disable all options to speed it up
 	uint opts = get_options();
 	set_options(GRIDOPT_NONE);
@@ -233,9 +261,12 @@ void Grid::clear_geometry()
 	clear<Face>();
 	clear<Edge>();
 	clear<Vertex>();
-	
+
 //	reset options
 	set_options(opts);
+
+//	all slabs of the pools are empty now and are handed back in one go
+	m_objectPools.release_unused_memory();
 }
 
 template <class TElem>
@@ -418,6 +449,7 @@ void Grid::assign_grid(const Grid& grid)
 
 VertexIterator Grid::create_by_cloning(Vertex* pCloneMe, GridObject* pParent)
 {
+	GridObjectPoolScope poolScope(m_objectPools);
 	Vertex* pNew = reinterpret_cast<Vertex*>(pCloneMe->create_empty_instance());
 	register_vertex(pNew, pParent);
 	return iterator_cast<VertexIterator>(get_iterator(pNew));
@@ -425,6 +457,7 @@ VertexIterator Grid::create_by_cloning(Vertex* pCloneMe, GridObject* pParent)
 
 EdgeIterator Grid::create_by_cloning(Edge* pCloneMe, const IVertexGroup& ev, GridObject* pParent)
 {
+	GridObjectPoolScope poolScope(m_objectPools);
 	Edge* pNew = reinterpret_cast<Edge*>(pCloneMe->create_empty_instance());
 	pNew->set_vertex(0, ev.vertex(0));
 	pNew->set_vertex(1, ev.vertex(1));
@@ -434,6 +467,7 @@ EdgeIterator Grid::create_by_cloning(Edge* pCloneMe, const IVertexGroup& ev, Gri
 
 FaceIterator Grid::create_by_cloning(Face* pCloneMe, const IVertexGroup& fv, GridObject* pParent)
 {
+	GridObjectPoolScope poolScope(m_objectPools);
 	Face* pNew = reinterpret_cast<Face*>(pCloneMe->create_empty_instance());
 	uint numVrts = fv.num_vertices();
 	Face::ConstVertexArray vrts = fv.vertices();
@@ -445,6 +479,7 @@ FaceIterator Grid::create_by_cloning(Face* pCloneMe, const IVertexGroup& fv, Gri
 
 VolumeIterator Grid::create_by_cloning(Volume* pCloneMe, const IVertexGroup& vv, GridObject* pParent)
 {
+	GridObjectPoolScope poolScope(m_objectPools);
 	Volume* pNew = reinterpret_cast<Volume*>(pCloneMe->create_empty_instance());
 	uint numVrts = vv.num_vertices();
 	Volume::ConstVertexArray vrts = vv.vertices();
@@ -626,6 +661,21 @@ size_t Grid::volume_fragmentation()
 	return m_volumeElementStorage.m_attachmentPipe.num_data_entries() - m_volumeElementStorage.m_attachmentPipe.num_elements();
 }
 
+void Grid::defragment()
+{
+	defragment<Vertex>();
+	defragment<Edge>();
+	defragment<Face>();
+	defragment<Volume>();
+}
+
+void Grid::compact_memory()
+{
+	defragment();
+	m_objectPools.release_unused_memory();
+	ReleaseUnusedGridObjectMemory();
+}
+
 
 GridObject* Grid::
 get_opposing_object(Vertex* vrt, Face* elem)
@@ -877,6 +927,80 @@ void Grid::unregister_observer(GridObserver* observer)
 }
 
 
+////////////////////////////////////////////////////////////////////////
+//	frozen topology
+template <class TElem, class TAssElem>
+void Grid::freeze_relation(FrozenRelation<TAssElem>& rel,
+				AttachmentAccessor<TElem, Attachment<std::vector<TAssElem*> > >& aaCon)
+{
+	typedef typename geometry_traits<TElem>::iterator	iterator;
+	typedef std::vector<TAssElem*>						container_t;
+
+//	count the associated elements of each element
+	rel.offsets.assign(get_attachment_pipe<TElem>().num_data_entries() + 1, 0);
+	for(iterator iter = begin<TElem>(); iter != end<TElem>(); ++iter)
+		rel.offsets[(*iter)->grid_data_index() + 1] = aaCon[*iter].size();
+
+	for(size_t i = 1; i < rel.offsets.size(); ++i)
+		rel.offsets[i] += rel.offsets[i - 1];
+
+//	copy them and release the memory of the per-element containers
+	rel.entries.resize(rel.offsets.back());
+	for(iterator iter = begin<TElem>(); iter != end<TElem>(); ++iter){
+		container_t& con = aaCon[*iter];
+		std::copy(con.begin(), con.end(), rel.begin(*iter));
+		container_t().swap(con);
+	}
+}
+
+template <class TElem, class TAssElem>
+void Grid::thaw_relation(FrozenRelation<TAssElem>& rel,
+				AttachmentAccessor<TElem, Attachment<std::vector<TAssElem*> > >& aaCon)
+{
+	typedef typename geometry_traits<TElem>::iterator	iterator;
+
+	if(rel.empty())
+		return;
+
+	for(iterator iter = begin<TElem>(); iter != end<TElem>(); ++iter)
+		aaCon[*iter].assign(rel.begin(*iter), rel.end(*iter));
+}
+
+void Grid::freeze_topology()
+{
+	GRID_PROFILE_FUNC();
+
+	if(m_frozenTopology)
+		return;
+
+	m_frozenTopology = new FrozenTopology;
+	if(option_is_enabled(VRTOPT_STORE_ASSOCIATED_EDGES))
+		freeze_relation(m_frozenTopology->vrtEdges, m_aaEdgeContainerVERTEX);
+	if(option_is_enabled(VRTOPT_STORE_ASSOCIATED_FACES))
+		freeze_relation(m_frozenTopology->vrtFaces, m_aaFaceContainerVERTEX);
+	if(option_is_enabled(VRTOPT_STORE_ASSOCIATED_VOLUMES))
+		freeze_relation(m_frozenTopology->vrtVolumes, m_aaVolumeContainerVERTEX);
+	if(option_is_enabled(FACEOPT_STORE_ASSOCIATED_VOLUMES))
+		freeze_relation(m_frozenTopology->faceVolumes, m_aaVolumeContainerFACE);
+}
+
+void Grid::thaw_topology()
+{
+	GRID_PROFILE_FUNC();
+
+	if(!m_frozenTopology)
+		return;
+
+	thaw_relation(m_frozenTopology->vrtEdges, m_aaEdgeContainerVERTEX);
+	thaw_relation(m_frozenTopology->vrtFaces, m_aaFaceContainerVERTEX);
+	thaw_relation(m_frozenTopology->vrtVolumes, m_aaVolumeContainerVERTEX);
+	thaw_relation(m_frozenTopology->faceVolumes, m_aaVolumeContainerFACE);
+
+	delete m_frozenTopology;
+	m_frozenTopology = NULL;
+}
+
+
 ////////////////////////////////////////////////////////////////////////
 //	associated edge access
 Grid::AssociatedEdgeIterator Grid::associated_edges_begin(Vertex* vrt)
@@ -886,6 +1010,8 @@ Grid::AssociatedEdgeIterator Grid::associated_edges_begin(Vertex* vrt)
 		LOG("WARNING in associated_edges_begin(vrt): auto-enabling VRTOPT_STORE_ASSOCIATED_EDGES." << endl);
 		vertex_store_associated_edges(true);
 	}
+	if(m_frozenTopology)
+		return m_frozenTopology->vrtEdges.begin(vrt);
 	return m_aaEdgeContainerVERTEX[vrt].begin();
 }
 
@@ -896,6 +1022,8 @@ Grid::AssociatedEdgeIterator Grid::associated_edges_end(Vertex* vrt)
 		LOG("WARNING in associated_edges_end(vrt): auto-enabling VRTOPT_STORE_ASSOCIATED_EDGES." << endl);
 		vertex_store_associated_edges(true);
 	}
+	if(m_frozenTopology)
+		return m_frozenTopology->vrtEdges.end(vrt);
 	return m_aaEdgeContainerVERTEX[vrt].end();
 }
 
@@ -948,6 +1076,8 @@ Grid::AssociatedFaceIterator Grid::associated_faces_begin(Vertex* vrt)
 		LOG("WARNING in associated_faces_begin(vrt): auto-enabling VRTOPT_STORE_ASSOCIATED_FACES." << endl);
 		vertex_store_associated_faces(true);
 	}
+	if(m_frozenTopology)
+		return m_frozenTopology->vrtFaces.begin(vrt);
 	return m_aaFaceContainerVERTEX[vrt].begin();
 }
 
@@ -958,6 +1088,8 @@ Grid::AssociatedFaceIterator Grid::associated_faces_end(Vertex* vrt)
 		LOG("WARNING in associated_faces_end(vrt): auto-enabling VRTOPT_STORE_ASSOCIATED_FACES." << endl);
 		vertex_store_associated_faces(true);
 	}
+	if(m_frozenTopology)
+		return m_frozenTopology->vrtFaces.end(vrt);
 	return m_aaFaceContainerVERTEX[vrt].end();
 }
 
@@ -1010,6 +1142,8 @@ Grid::AssociatedVolumeIterator Grid::associated_volumes_begin(Vertex* vrt)
 		LOG("WARNING in associated_volumes_begin(vrt): auto-enabling VRTOPT_STORE_ASSOCIATED_VOLUMES." << endl);
 		vertex_store_associated_volumes(true);
 	}
+	if(m_frozenTopology)
+		return m_frozenTopology->vrtVolumes.begin(vrt);
 	return m_aaVolumeContainerVERTEX[vrt].begin();
 }
 
@@ -1020,6 +1154,8 @@ Grid::AssociatedVolumeIterator Grid::associated_volumes_end(Vertex* vrt)
 		LOG("WARNING in associated_volumes_end(vrt): auto-enabling VRTOPT_STORE_ASSOCIATED_VOLUMES." << endl);
 		vertex_store_associated_volumes(true);
 	}
+	if(m_frozenTopology)
+		return m_frozenTopology->vrtVolumes.end(vrt);
 	return m_aaVolumeContainerVERTEX[vrt].end();
 }
 
@@ -1050,6 +1186,8 @@ Grid::AssociatedVolumeIterator Grid::associated_volumes_begin(Face* face)
 		LOG("WARNING in associated_volumes_begin(face): auto-enabling FACEOPT_STORE_ASSOCIATED_VOLUMES." << endl);
 		face_store_associated_volumes(true);
 	}
+	if(m_frozenTopology)
+		return m_frozenTopology->faceVolumes.begin(face);
 	return m_aaVolumeContainerFACE[face].begin();
 }
 
@@ -1060,6 +1198,8 @@ Grid::AssociatedVolumeIterator Grid::associated_volumes_end(Face* face)
 		LOG("WARNING in associated_volumes_end(face): auto-enabling FACEOPT_STORE_ASSOCIATED_VOLUMES." << endl);
 		face_store_associated_volumes(true);
 	}
+	if(m_frozenTopology)
+		return m_frozenTopology->faceVolumes.end(face);
 	return m_aaVolumeContainerFACE[face].end();
 }
 
@@ -45,6 +45,7 @@
 #include "grid_object_collection.h"
 #include "element_storage.h"
 #include "grid_base_object_traits.h"
+#include "vertex_tuple_hash.h"
 
 //	Define PROFILE_GRID to profile some often used gird-methods
 //#define PROFILE_GRID
@@ -345,12 +346,38 @@ class UG_API Grid
 		const PeriodicBoundaryManager* periodic_boundary_manager() const;
 	/** \} */
 
+	////////////////////////////////////////////////
+	//	object pools
+	///	returns the pools from which the objects of this grid are allocated
+	/**	Objects which are created through methods of the grid come from these
+	 * pools. Use a GridObjectPoolScope to allocate objects which are created
+	 * elsewhere from them, too.*/
+		inline GridObjectPools& object_pools()	{return m_objectPools;}
+		inline const GridObjectPools& object_pools() const	{return m_objectPools;}
+
+	////////////////////////////////////////////////
+	//	vertex tuple hash
+	///	enables or disables a hash index of all edges, faces and volumes by their corners
+	/**	If enabled, get_edge, get_face and get_volume (and thus the automatic
+	 * creation of sides) look up elements in a VertexTupleHash instead of
+	 * searching the associated elements of a corner. This pays off during bulk
+	 * construction and refinement of grids with high vertex valences, at the
+	 * cost of additional memory for the hash.*/
+		void set_vertex_tuple_hash(bool enable);
+
+	///	returns true if a VertexTupleHash is used for element lookups
+		inline bool has_vertex_tuple_hash() const	{return m_vertexTupleHash != NULL;}
+
+	///	returns the VertexTupleHash of the grid or NULL if it is disabled.
+		inline VertexTupleHash* vertex_tuple_hash()	{return m_vertexTupleHash;}
+
 
 	////////////////////////////////////////////////
 	//	clear
 	///	clears the grids geometry and attachments
 		void clear();
 	///	clears the grids geometry. Registered attachments remain.
+	/**	The memory of the grids object pools is returned to the system.*/
 		void clear_geometry();
 	///	clears the grids attachments. The geometry remains.
 		void clear_attachments();
@@ -418,6 +445,38 @@ class UG_API Grid
 		template <class TGeomObj>
 		void reserve(size_t num);
 
+	///	creates a batch of elements of type TGeomObj from vertex index tuples
+	/**	vrtInds has to hold numElems consecutive tuples of
+	 * TGeomObj::NUM_VERTICES indices into vrts, e.g. 4 indices per
+	 * Tetrahedron. The indices are not checked.
+	 * If elemsOut is specified, the new elements are appended to it in the
+	 * order of their tuples.
+	 *
+	 * The resulting grid is the same as if create were called for each
+	 * tuple, including the order of the new sides and of associated elements.
+	 * However, memory for attached data is reserved for the whole batch
+	 * and the sides of the new elements are identified by sorting their
+	 * corners instead of searching the neighborhood of each corner. Missing
+	 * sides are created in one pass if the autogeneration options demand it.
+	 * This is considerably faster when large grids are built, e.g. during
+	 * file input.
+	 *
+	 * Observers are informed once per batch and element type through
+	 * GridObserver::edges_created, faces_created and volumes_created,
+	 * sides first. Code which creates a grid through several calls to
+	 * create_bulk should enclose them by GridMessage_Creation messages
+	 * (see LoadGridFromFile).
+	 *
+	 * \note	If older elements of the grid could contain sides of the new
+	 *			elements which do not yet exist (only possible if sides are not
+	 *			autogenerated), the elements are registered one by one.*/
+		template <class TGeomObj>
+		void create_bulk(const std::vector<Vertex*>& vrts, const int* vrtInds,
+						 size_t numElems,
+						 std::vector<typename geometry_traits<TGeomObj>::grid_base_object*>*
+						 	elemsOut = NULL,
+						 GridObject* pParent = NULL);
+
 	////////////////////////////////////////////////
 	//	element deletion
 		void erase(GridObject* geomObj);
@@ -558,6 +617,50 @@ class UG_API Grid
 		size_t face_fragmentation();		///< returns the number of unused face-data-entries.
 		size_t volume_fragmentation();	///< returns the number of unused volume-data-entries.
 
+	///	removes unused data-entries and stores attached data in element order
+	/**	After this call the attached data of the i-th element of each base
+	 * type (in the order of begin() / end()) is stored at the i-th entry of
+	 * the associated attachment containers. Data of elements that are
+	 * iterated consecutively is thus also stored consecutively in memory.
+	 *
+	 * Note that the data indices of the elements change. Pointers to single
+	 * entries of attachment containers are thus invalidated, while attachment
+	 * accessors and the containers themselves stay valid. A frozen
+	 * topology is thawed, since it is indexed by the data indices.
+	 *
+	 * The data containers are only rebuilt for element types whose data is
+	 * not already stored in element order. Finding out requires a pass over
+	 * the elements, so each call costs O(n) even if nothing has to be done.
+	 * CheckDefragment (debug_util.h) verifies the result.
+	 * \{ */
+		void defragment();
+
+		template <class TGeomObj>
+		void defragment();
+	/**	\} */
+
+	///	releases memory which is held for erased elements
+	/**	Defragments the attachment containers of all element types, which
+	 * also shrinks them to the number of elements, and returns the pool slabs
+	 * of erased grid objects to the system (see GridObjectPools).
+	 * Call this after many elements have been erased, e.g. after coarsening,
+	 * since neither the attachment containers nor the pools shrink on their
+	 * own. The same restrictions as for defragment apply.*/
+		void compact_memory();
+
+	///	changes the order in which the given elements are stored and iterated
+	/**	Each element in elems is moved to the end of the list of elements of
+	 * its type. Elements of the same type are thus afterwards iterated in the
+	 * order in which they appear in elems. Elements which are not contained
+	 * in elems are iterated before them.
+	 *
+	 * Attached data is not moved. Call defragment afterwards to store the
+	 * data in the new order, too. Observers are not notified.
+	 *
+	 * TElem has to be Vertex, Edge, Face, Volume or a derived type.*/
+		template <class TElem>
+		void reorder_elements(const std::vector<TElem*>& elems);
+
 	///	returns the size of the associated attachment containers.
 	/**	valid types for TGeomObj are Vertex, Edge, Face, Volume.*/
 		template <class TGeomObj>
@@ -843,6 +946,33 @@ class UG_API Grid
 		void pass_on_values(Face* objSrc, Face* objDest);
 		void pass_on_values(Volume* objSrc, Volume* objDest);
 
+	////////////////////////////////////////////////
+	//	frozen topology
+	///	compacts the associated elements of vertices and faces into contiguous arrays
+	/**	Once the topology of a grid is final, e.g. after the last refinement,
+	 * this method copies the vertex-edge, vertex-face, vertex-volume and
+	 * face-volume relations (as far as they are enabled by the grid options)
+	 * into compressed row storage, indexed by the attachment data index of
+	 * the vertex or face. The per-element containers are released.
+	 *
+	 * Associated-element queries (get_associated, associated_*_begin/end,
+	 * get_edge, get_face, ...) transparently use the compacted arrays. Any
+	 * change of the topology (creation, erasure or replacement of elements)
+	 * or of the related grid options thaws the topology again, which
+	 * restores the per-element containers.
+	 *
+	 * The compacted arrays save the heap block of each per-element container
+	 * and store the neighbors of consecutive elements next to each other.*/
+		void freeze_topology();
+
+	///	restores the per-element containers of associated elements
+	/**	This is called automatically whenever the topology of a frozen grid
+	 * is about to change. Nothing happens if the topology isn't frozen.*/
+		void thaw_topology();
+
+	///	returns true if associated elements are currently stored in compacted form
+		inline bool topology_is_frozen() const	{return m_frozenTopology != NULL;}
+
 	//	subject to change!
 		AssociatedEdgeIterator associated_edges_begin(Vertex* vrt);///< DO NOT INVOKE! Subject to change.
 		AssociatedEdgeIterator associated_edges_end(Vertex* vrt);///< DO NOT INVOKE! Subject to change.
@@ -957,6 +1087,35 @@ class UG_API Grid
 
 		typedef Attachment<int>	AMark;
 
+	///	associated elements of all elements of one type in compressed row storage
+	/**	The associated elements of the element with data index i are stored in
+	 * entries[offsets[i]], ..., entries[offsets[i+1] - 1].*/
+		template <class TAssElem>
+		struct FrozenRelation
+		{
+			typedef typename std::vector<TAssElem*>::iterator	iterator;
+
+			inline iterator begin(GridObject* o)	{return entries.begin() + offsets[o->grid_data_index()];}
+			inline iterator end(GridObject* o)		{return entries.begin() + offsets[o->grid_data_index() + 1];}
+			inline size_t size(GridObject* o) const	{return offsets[o->grid_data_index() + 1]
+															- offsets[o->grid_data_index()];}
+			inline bool empty() const				{return offsets.empty();}
+			inline TAssElem** array(GridObject* o)	{return entries.empty() ? NULL
+															: &entries.front() + offsets[o->grid_data_index()];}
+
+			std::vector<size_t>		offsets;
+			std::vector<TAssElem*>	entries;
+		};
+
+	///	compacted associated elements of a grid with frozen topology
+		struct FrozenTopology
+		{
+			FrozenRelation<Edge>	vrtEdges;
+			FrozenRelation<Face>	vrtFaces;
+			FrozenRelation<Volume>	vrtVolumes;
+			FrozenRelation<Volume>	faceVolumes;
+		};
+
 	protected:
 	///	unregisters all observers. Call this method in destructors of derived classes.
 	/**	If the derived class is an observer itself and if you don't want it to be
@@ -1006,6 +1165,27 @@ class UG_API Grid
 		void register_volume(Volume* v, GridObject* pParent = NULL);///< pDF specifies the element from which v derives its values
 		void unregister_volume(Volume* v);
 
+	///	registers elements which were created by create_bulk in one pass.
+	/**	Implemented in grid_bulk_creation.cpp. The helpers bulk_store_elements,
+	 * bulk_connect_faces and bulk_connect_edges are only used there.
+	 * \{ */
+		void register_bulk(Edge** edges, size_t numEdges, GridObject* pParent);
+		void register_bulk(Face** faces, size_t numFaces, GridObject* pParent);
+		void register_bulk(Volume** vols, size_t numVols, GridObject* pParent);
+
+		bool bulk_registration_is_possible();
+		template <class TElem, class TAAVrtContainer>
+		void bulk_store_elements(TElem** elems, size_t numElems,
+								 TAAVrtContainer* paaVrtContainer);
+		void bulk_connect_faces(std::vector<Face*>& newFacesOut,
+								std::vector<uint32>& newFaceVolsOut,
+								Volume** vols, size_t numVols);
+		void bulk_connect_edges(std::vector<Edge*>& newEdgesOut,
+								Face** faces, size_t numFaces,
+								const uint32* faceVols,
+								Volume** vols, size_t numVols);
+	/** \} */
+
 		void change_options(uint optsNew);
 
 		void change_vertex_options(uint optsNew);
@@ -1028,6 +1208,16 @@ class UG_API Grid
 
 		void volume_sort_associated_edge_container();
 
+	///	copies the associated elements in aaCon to rel and releases the containers
+		template <class TElem, class TAssElem>
+		void freeze_relation(FrozenRelation<TAssElem>& rel,
+						AttachmentAccessor<TElem, Attachment<std::vector<TAssElem*> > >& aaCon);
+
+	///	restores the containers in aaCon from rel
+		template <class TElem, class TAssElem>
+		void thaw_relation(FrozenRelation<TAssElem>& rel,
+						AttachmentAccessor<TElem, Attachment<std::vector<TAssElem*> > >& aaCon);
+
 		template <class TAttachmentPipe, class TElem>
 		void pass_on_values(TAttachmentPipe& attachmentPipe,
 							TElem* pSrc, TElem* pDest);
@@ -1195,9 +1385,18 @@ class UG_API Grid
 		FaceAttachmentAccessor<AMark>	m_aaMarkFACE;
 		VolumeAttachmentAccessor<AMark>	m_aaMarkVOL;
 
+	//	index of elements by their corners. NULL if disabled.
+		VertexTupleHash*	m_vertexTupleHash;
+
+	//	compacted associated elements. NULL if the topology isn't frozen.
+		FrozenTopology*	m_frozenTopology;
+
 		SPMessageHub 							m_messageHub;
 		DistributedGridManager*		m_distGridMgr;
 		PeriodicBoundaryManager*	m_periodicBndMgr;
+
+	//	memory of the grid objects. All objects are erased before it is destroyed.
+		GridObjectPools				m_objectPools;
 };
 
 /** \} */
@@ -30,8 +30,14 @@
  * GNU Lesser General Public License for more details.
  */
 
+#include <new>
 #include "grid_base_objects.h"
 #include "grid_util.h"
+#include "common/allocators/slab_allocator.h"
+
+#ifdef UG_OPENMP
+	#include <omp.h>
+#endif
 
 namespace ug
 {
@@ -39,6 +45,162 @@ namespace ug
 const char* GRID_BASE_OBJECT_SINGULAR_NAMES[] = {"vertex", "edge", "face", "volume"};
 const char* GRID_BASE_OBJECT_PLURAL_NAMES[] = {"vertices", "edges", "faces", "volume"};
 
+////////////////////////////////////////////////////////////////////////
+//	grid object pools
+namespace{
+///	pools of the innermost GridObjectPoolScope of each thread
+GridObjectPools* g_currentGridObjectPools = NULL;
+#ifdef UG_OPENMP
+#pragma omp threadprivate(g_currentGridObjectPools)
+#endif
+
+///	pools for objects which are created outside of any scope.
+/**	The pools are created on first use and deliberately never destroyed, since
+ * grids in static storage may release their objects after all function-local
+ * statics have been destroyed.*/
+GridObjectPools& SharedGridObjectPools()
+{
+	static GridObjectPools* pools = new GridObjectPools;
+	return *pools;
+}
+}//	end of anonymous namespace
+
+GridObjectPools::~GridObjectPools()
+{
+	for(size_t i = 0; i < m_pools.size(); ++i)
+		delete m_pools[i];
+	for(size_t i = 0; i < m_threadPools.size(); ++i)
+		delete m_threadPools[i];
+}
+
+void* GridObjectPools::allocate(size_t poolIndex, size_t size)
+{
+	if(poolIndex >= m_pools.size())
+		m_pools.resize(poolIndex + 1, NULL);
+	SlabAllocator*& pool = m_pools[poolIndex];
+	if(!pool)
+		pool = new SlabAllocator(size);
+	UG_ASSERT(pool->block_size() >= size, "Pool " << poolIndex
+			  << " can't hold objects of size " << size);
+	return pool->allocate();
+}
+
+void GridObjectPools::release_unused_memory()
+{
+	for(size_t i = 0; i < m_pools.size(); ++i){
+		if(m_pools[i])
+			m_pools[i]->release_unused_slabs();
+	}
+	for(size_t i = 0; i < m_threadPools.size(); ++i)
+		m_threadPools[i]->release_unused_memory();
+}
+
+size_t GridObjectPools::num_allocated() const
+{
+	size_t num = 0;
+	for(size_t i = 0; i < m_pools.size(); ++i){
+		if(m_pools[i])
+			num += m_pools[i]->num_allocated();
+	}
+	for(size_t i = 0; i < m_threadPools.size(); ++i)
+		num += m_threadPools[i]->num_allocated();
+	return num;
+}
+
+size_t GridObjectPools::memory_reserved() const
+{
+	size_t num = 0;
+	for(size_t i = 0; i < m_pools.size(); ++i){
+		if(m_pools[i])
+			num += m_pools[i]->memory_reserved();
+	}
+	for(size_t i = 0; i < m_threadPools.size(); ++i)
+		num += m_threadPools[i]->memory_reserved();
+	return num;
+}
+
+void GridObjectPools::reserve_thread_pools(size_t num)
+{
+	while(m_threadPools.size() < num)
+		m_threadPools.push_back(new GridObjectPools);
+}
+
+GridObjectPools* GridObjectPools::current()
+{
+	return g_currentGridObjectPools;
+}
+
+void GridObjectPools::set_current(GridObjectPools* pools)
+{
+	g_currentGridObjectPools = pools;
+}
+
+size_t GridObjectPools::new_pool_index()
+{
+	size_t index;
+	#ifdef UG_OPENMP
+	#pragma omp critical(ug_grid_object_pool)
+	#endif
+	{
+		static size_t numPools = 0;
+		index = numPools++;
+	}
+	return index;
+}
+
+void* AllocateGridObject(size_t poolIndex, size_t typeSize, size_t size)
+{
+	if(size != typeSize)
+		return ::operator new(size);
+
+	if(GridObjectPools* pools = g_currentGridObjectPools)
+		return pools->allocate(poolIndex, size);
+
+	void* p;
+	#ifdef UG_OPENMP
+	#pragma omp critical(ug_grid_object_pool)
+	#endif
+	{
+		p = SharedGridObjectPools().allocate(poolIndex, size);
+	}
+	return p;
+}
+
+void DeallocateGridObject(size_t typeSize, void* p, size_t size)
+{
+	if(!p)
+		return;
+
+	if(size != typeSize){
+		::operator delete(p);
+		return;
+	}
+
+//	the owning pool can't be identified without races while other threads
+//	allocate from the process wide pools. Inside of parallel regions
+//	deallocation is thus always serialized.
+	#ifdef UG_OPENMP
+		if(omp_in_parallel()){
+			#pragma omp critical(ug_grid_object_pool)
+			{
+				SlabAllocator::owner(p)->deallocate(p);
+			}
+			return;
+		}
+	#endif
+	SlabAllocator::owner(p)->deallocate(p);
+}
+
+void ReleaseUnusedGridObjectMemory()
+{
+	#ifdef UG_OPENMP
+	#pragma omp critical(ug_grid_object_pool)
+	#endif
+	{
+		SharedGridObjectPools().release_unused_memory();
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////
 //	implementation of edge
 bool Edge::get_opposing_side(Vertex* v, Vertex** vrtOut)
@@ -37,6 +37,7 @@
 #include <cassert>
 #include <iostream>
 #include <utility>
+#include <vector>
 #include "common/types.h"
 #include "common/common.h"
 #include "common/assert.h"
@@ -44,6 +45,7 @@
 #include "lib_grid/attachments/attached_list.h"
 #include "common/util/hash_function.h"
 #include "common/allocators/small_object_allocator.h"
+#include "common/allocators/slab_allocator.h"
 #include "common/math/ugmath_types.h"
 #include "common/util/pointer_const_array.h"
 
@@ -144,6 +146,121 @@ template<> class attachment_traits<Volume*, ElementStorage<Volume> >;
  * \defgroup lib_grid_grid_objects geometric objects
  * \ingroup lib_grid
  */
+////////////////////////////////////////////////////////////////////////
+//	GridObjectPools
+///	Pools from which grid objects are allocated, one for each concrete object type
+/**	Each Grid owns an instance. Objects of one type which are created one after
+ * another, e.g. during refinement, are thus stored contiguously. Different
+ * types and different grids don't share memory and creating or deleting an
+ * object does not involve the system allocator. Objects are always returned
+ * to the pool they were allocated from.
+ *
+ * Objects are allocated from the pools of the innermost GridObjectPoolScope of
+ * the calling thread. The methods of Grid which create objects and the
+ * refiners set up such a scope. Objects which are created outside of any
+ * scope come from process wide pools (see ReleaseUnusedGridObjectMemory).
+ *
+ * Only classes which declare UG_GRID_OBJECT_POOLED are allocated from the
+ * pools. Other derivates of GridObject use the global operator new.
+ *
+ * The pools are not thread safe. Threads which create objects concurrently
+ * need pools of their own. Only the process wide pools are synchronized if
+ * UG_OPENMP is defined.
+ */
+class UG_API GridObjectPools
+{
+	public:
+		GridObjectPools()	{}
+	///	releases all slabs. Objects which are still alive become invalid.
+		~GridObjectPools();
+
+	///	allocates size bytes from the pool with the given index
+		void* allocate(size_t poolIndex, size_t size);
+
+	///	returns the memory of slabs without live objects to the system
+		void release_unused_memory();
+
+	///	number of objects which are currently allocated from the pools
+		size_t num_allocated() const;
+
+	///	number of bytes held by the pools (used and unused)
+		size_t memory_reserved() const;
+
+	///	makes sure that pools for at least num worker threads exist
+	/**	Threads which create objects concurrently need pools of their own.
+	 * The pools of the threads are owned by this instance and are included in
+	 * release_unused_memory, num_allocated and memory_reserved. Call this
+	 * before the threads start, since it is not thread safe.*/
+		void reserve_thread_pools(size_t num);
+
+	///	returns the pools of the worker thread with the given index
+		GridObjectPools& thread_pools(size_t i)	{return *m_threadPools[i];}
+
+	///	returns the pools of the innermost GridObjectPoolScope of the calling thread
+	/**	NULL if the calling thread is not inside of any scope.*/
+		static GridObjectPools* current();
+
+	///	returns a new pool index. Used by GridObjectPoolIndex.
+		static size_t new_pool_index();
+
+	private:
+		friend class GridObjectPoolScope;
+		static void set_current(GridObjectPools* pools);
+
+	//	not copyable
+		GridObjectPools(const GridObjectPools&);
+		GridObjectPools& operator=(const GridObjectPools&);
+
+	private:
+		std::vector<SlabAllocator*>		m_pools;
+		std::vector<GridObjectPools*>	m_threadPools;
+};
+
+///	Objects created by the calling thread come from the given pools while the scope exists
+/**	Scopes may be nested. The previous pools are restored on destruction.*/
+class UG_API GridObjectPoolScope
+{
+	public:
+		explicit GridObjectPoolScope(GridObjectPools& pools) :
+			m_prevPools(GridObjectPools::current())
+		{GridObjectPools::set_current(&pools);}
+
+		~GridObjectPoolScope()	{GridObjectPools::set_current(m_prevPools);}
+
+	private:
+		GridObjectPoolScope(const GridObjectPoolScope&);
+		GridObjectPoolScope& operator=(const GridObjectPoolScope&);
+
+		GridObjectPools*	m_prevPools;
+};
+
+///	returns the index of the pool for objects of the concrete type TElem
+template <class TElem>
+inline size_t GridObjectPoolIndex()
+{
+	static const size_t index = GridObjectPools::new_pool_index();
+	return index;
+}
+
+///	allocates an object of typeSize bytes from the pool with the given index
+/**	Uses the pools of the current GridObjectPoolScope and the process wide pools
+ * outside of any scope. If size differs from typeSize (i.e. a derived class
+ * is allocated), the global operator new is used.*/
+UG_API void* AllocateGridObject(size_t poolIndex, size_t typeSize, size_t size);
+
+///	returns an object which was allocated by AllocateGridObject
+UG_API void DeallocateGridObject(size_t typeSize, void* p, size_t size);
+
+///	Declares class specific operator new and delete which use GridObjectPools.
+/**	Use in the class declaration of concrete grid object types.*/
+#define UG_GRID_OBJECT_POOLED(className)\
+	static void* operator new(std::size_t size)\
+	{return ug::AllocateGridObject(ug::GridObjectPoolIndex<className>(),\
+								   sizeof(className), size);}\
+	static void operator delete(void* p, std::size_t size)\
+	{ug::DeallocateGridObject(sizeof(className), p, size);}
+
+
 ////////////////////////////////////////////////////////////////////////
 //	GridObject
 ///	The base class for all geometric objects, such as vertices, edges, faces, volumes, ...
@@ -151,9 +268,12 @@ template<> class attachment_traits<Volume*, ElementStorage<Volume> >;
  * In order to be used by libGrid, all derivatives of GridObject
  * have to specialize geometry_traits<GeomObjectType>.
  *
+ * The built-in concrete types are allocated from the GridObjectPools of the
+ * grid which creates them (see UG_GRID_OBJECT_POOLED).
+ *
  * \ingroup lib_grid_grid_objects
  */
-class UG_API GridObject/* : public SmallObject<>*/
+class UG_API GridObject
 {
 	friend class Grid;
 	friend class attachment_traits<Vertex*, ElementStorage<Vertex> >;
@@ -215,6 +335,13 @@ class UG_API GridObject/* : public SmallObject<>*/
 		uint						m_gridDataIndex;//	index to grid-attached data.
 };
 
+///	returns the memory of slabs without live objects in the process wide pools
+/**	Objects which are created outside of any GridObjectPoolScope come from
+ * process wide pools which are shared by all grids. The free lists of those
+ * pools are traversed, so this is only called by Grid::compact_memory and not
+ * after each erase.*/
+UG_API void ReleaseUnusedGridObjectMemory();
+
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,580 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+/*
+ * In this file the registration of elements which were created through
+ * Grid::create_bulk is implemented.
+ *
+ * Instead of searching the neighborhood of each new element for existing
+ * sides (as register_volume and register_face do), the sides of all new
+ * elements are collected and sorted by their corners. Equal sides are thus
+ * adjacent and each side is looked up or created only once. The connectivity
+ * containers are filled directly afterwards.
+ */
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "grid.h"
+#include "vertex_tuple_hash.h"
+#include "common/common.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////
+///	this macro helps calling callbacks of different observers.
+#define NOTIFY_OBSERVERS(observerContainer, callback)	{for(Grid::ObserverContainer::iterator iter = observerContainer.begin(); iter != observerContainer.end(); iter++) (*iter)->callback;}
+
+namespace ug
+{
+
+namespace
+{
+///	A side of an element of a batch, identified by the sorted corners of the side
+template <int N>
+struct BulkSide
+{
+	VertexTupleKey<N>	key;
+	uint32				elem;	///< index of the element in its batch
+	uint32				rank;	///< position of the element in the order in which create processes them
+	uint16_t			side;	///< local index of the side in the element
+	uint16_t			isVol;	///< 1 if elem is a volume, 0 if it is a face
+
+///	equal sides are ordered as they are visited by a sequential creation
+	bool operator < (const BulkSide& s) const
+	{
+		if(key < s.key)
+			return true;
+		if(s.key < key)
+			return false;
+		if(rank != s.rank)
+			return rank < s.rank;
+		return side < s.side;
+	}
+
+///	position of the side in the order in which create visits the sides
+	uint64 order() const	{return ((uint64)rank << 16) | side;}
+};
+
+///	A side created by a batch, together with the position of its first occurrence
+template <class TSide>
+struct NewBulkSide
+{
+	uint64	order;	///< see BulkSide::order
+	TSide*	side;
+	uint32	elem;	///< element of the first occurrence in its batch
+	uint32	numFaces;	///< number of faces of the batch which contain the side
+	uint32	numVols;	///< number of volumes of the batch which contain the side
+
+	bool operator < (const NewBulkSide& s) const	{return order < s.order;}
+};
+
+///	returns the end of the range of sides which equal sides[first]
+template <int N>
+size_t EndOfEqualSides(const vector<BulkSide<N> >& sides, size_t first)
+{
+	size_t last = first + 1;
+	while(last < sides.size() && sides[last].key == sides[first].key)
+		++last;
+	return last;
+}
+///	sorts sides, so that equal sides are adjacent
+/**	The sides are bucketed by their smallest corner first. Hash values of
+ * vertices are consecutive numbers in most grids, so that this is a counting
+ * sort followed by sorts of very small ranges.*/
+template <int N>
+void SortSides(vector<BulkSide<N> >& sides)
+{
+	if(sides.empty())
+		return;
+
+	uint32 minId = sides[0].key.ids[0];
+	uint32 maxId = minId;
+	for(size_t i = 1; i < sides.size(); ++i){
+		minId = min(minId, sides[i].key.ids[0]);
+		maxId = max(maxId, sides[i].key.ids[0]);
+	}
+
+	const size_t numBuckets = (size_t)(maxId - minId) + 1;
+	if(numBuckets > 4 * sides.size()){
+		sort(sides.begin(), sides.end());
+		return;
+	}
+
+	vector<size_t> bucketBegin(numBuckets + 1, 0);
+	for(size_t i = 0; i < sides.size(); ++i)
+		++bucketBegin[sides[i].key.ids[0] - minId + 1];
+	for(size_t i = 1; i <= numBuckets; ++i)
+		bucketBegin[i] += bucketBegin[i - 1];
+
+	vector<BulkSide<N> > sorted(sides.size());
+	vector<size_t> bucketEnd(bucketBegin.begin(), bucketBegin.end() - 1);
+	for(size_t i = 0; i < sides.size(); ++i)
+		sorted[bucketEnd[sides[i].key.ids[0] - minId]++] = sides[i];
+
+	for(size_t i = 0; i < numBuckets; ++i){
+		if(bucketBegin[i + 1] - bucketBegin[i] > 1)
+			sort(sorted.begin() + bucketBegin[i], sorted.begin() + bucketBegin[i + 1]);
+	}
+
+	sides.swap(sorted);
+}
+}//	end of anonymous namespace
+
+
+////////////////////////////////////////////////////////////////////////
+bool Grid::bulk_registration_is_possible()
+{
+//	new faces could be sides of older volumes
+	if(num<Volume>() > 0
+	   && !option_is_enabled(VOLOPT_AUTOGENERATE_FACES)
+	   && (option_is_enabled(FACEOPT_STORE_ASSOCIATED_VOLUMES)
+		   || option_is_enabled(VOLOPT_STORE_ASSOCIATED_FACES)))
+	{
+		return false;
+	}
+
+//	new edges could be sides of older faces
+	if(num<Face>() > 0
+	   && !option_is_enabled(FACEOPT_AUTOGENERATE_EDGES)
+	   && (option_is_enabled(EDGEOPT_STORE_ASSOCIATED_FACES)
+		   || option_is_enabled(FACEOPT_STORE_ASSOCIATED_EDGES)))
+	{
+		return false;
+	}
+
+//	new edges could be sides of older volumes
+	if(num<Volume>() > 0
+	   && !option_is_enabled(VOLOPT_AUTOGENERATE_EDGES)
+	   && !option_is_enabled(VOLOPT_AUTOGENERATE_FACES | FACEOPT_AUTOGENERATE_EDGES)
+	   && (option_is_enabled(EDGEOPT_STORE_ASSOCIATED_VOLUMES)
+		   || option_is_enabled(VOLOPT_STORE_ASSOCIATED_EDGES)))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////
+template <class TElem, class TAAVrtContainer>
+void Grid::bulk_store_elements(TElem** elems, size_t numElems,
+							   TAAVrtContainer* paaVrtContainer)
+{
+	element_storage<TElem>().m_attachmentPipe.reserve(num<TElem>() + numElems);
+
+	for(size_t i = 0; i < numElems; ++i){
+		TElem* elem = elems[i];
+		element_storage<TElem>().m_attachmentPipe.register_element(elem);
+		element_storage<TElem>().m_sectionContainer.insert(elem, elem->container_section());
+
+		if(paaVrtContainer){
+			typename TElem::ConstVertexArray vrts = elem->vertices();
+			const size_t numVrts = elem->num_vertices();
+			for(size_t j = 0; j < numVrts; ++j)
+				(*paaVrtContainer)[vrts[j]].push_back(elem);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+void Grid::bulk_connect_faces(vector<Face*>& newFacesOut,
+							  vector<uint32>& newFaceVolsOut,
+							  Volume** vols, size_t numVols)
+{
+	const bool createFaces = option_is_enabled(VOLOPT_AUTOGENERATE_FACES);
+	const bool facesStoreVols = option_is_enabled(FACEOPT_STORE_ASSOCIATED_VOLUMES);
+	const bool volsStoreFaces = option_is_enabled(VOLOPT_STORE_ASSOCIATED_FACES);
+
+	if(!(createFaces || facesStoreVols || volsStoreFaces))
+		return;
+
+	const bool searchOldFaces = (num<Face>() > 0);
+
+//	collect the sides of all volumes and sort them, so that equal sides
+//	are adjacent. offsets[i] is the index of the first side of vols[i].
+	vector<size_t> offsets(numVols + 1);
+	offsets[0] = 0;
+	for(size_t i = 0; i < numVols; ++i)
+		offsets[i + 1] = offsets[i] + vols[i]->num_faces();
+
+	vector<BulkSide<4> > sides(offsets[numVols]);
+	FaceDescriptor fd;
+	for(size_t i = 0; i < numVols; ++i){
+		Volume* v = vols[i];
+		for(size_t j = offsets[i]; j < offsets[i + 1]; ++j){
+			v->face_desc((int)(j - offsets[i]), fd);
+			BulkSide<4>& s = sides[j];
+			s.key = VertexTupleKey<4>(fd);
+			s.elem = (uint32)i;
+			s.rank = (uint32)i;
+			s.side = (uint16_t)(j - offsets[i]);
+			s.isVol = 1;
+		}
+	}
+	SortSides(sides);
+
+//	find or create the face of each group of equal sides. The first side of
+//	each group is its first occurrence in the batch.
+	vector<Face*> volFaces(sides.size(), NULL);
+	vector<NewBulkSide<Face> > newFaces;
+	for(size_t first = 0; first < sides.size();){
+		const size_t last = EndOfEqualSides(sides, first);
+		const BulkSide<4>& s = sides[first];
+		Volume* v = vols[s.elem];
+
+		Face* f = NULL;
+		if(searchOldFaces){
+			v->face_desc(s.side, fd);
+			f = find_face_in_associated_faces(fd.vertex(0), fd);
+		}
+
+		if(!f && createFaces){
+			f = v->create_face(s.side);
+			NewBulkSide<Face> nf = {s.order(), f, s.elem, 0, 0};
+			newFaces.push_back(nf);
+		}
+
+		if(f){
+			for(size_t i = first; i < last; ++i)
+				volFaces[offsets[sides[i].elem] + sides[i].side] = f;
+		}
+
+		first = last;
+	}
+
+	vector<BulkSide<4> >().swap(sides);
+
+//	store the new faces in the order in which create would have created them
+	sort(newFaces.begin(), newFaces.end());
+	newFacesOut.reserve(newFacesOut.size() + newFaces.size());
+	newFaceVolsOut.reserve(newFaceVolsOut.size() + newFaces.size());
+	for(size_t i = 0; i < newFaces.size(); ++i){
+		newFacesOut.push_back(newFaces[i].side);
+		newFaceVolsOut.push_back(newFaces[i].elem);
+	}
+	vector<NewBulkSide<Face> >().swap(newFaces);
+
+	if(!newFacesOut.empty()){
+		bulk_store_elements(&newFacesOut.front(), newFacesOut.size(),
+							option_is_enabled(VRTOPT_STORE_ASSOCIATED_FACES) ?
+								&m_aaFaceContainerVERTEX : NULL);
+	}
+
+//	register faces and volumes at each other
+	for(size_t i = 0; i < numVols; ++i){
+		Volume* v = vols[i];
+		if(volsStoreFaces)
+			m_aaFaceContainerVOLUME[v].reserve(offsets[i + 1] - offsets[i]);
+
+		for(size_t j = offsets[i]; j < offsets[i + 1]; ++j){
+			Face* f = volFaces[j];
+			if(!f)
+				continue;
+			if(facesStoreVols)
+				m_aaVolumeContainerFACE[f].push_back(v);
+			if(volsStoreFaces)
+				m_aaFaceContainerVOLUME[v].push_back(f);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+void Grid::bulk_connect_edges(vector<Edge*>& newEdgesOut,
+							  Face** faces, size_t numFaces,
+							  const uint32* faceVols,
+							  Volume** vols, size_t numVols)
+{
+	const bool facesCreateEdges = option_is_enabled(FACEOPT_AUTOGENERATE_EDGES);
+	const bool edgesStoreFaces = option_is_enabled(EDGEOPT_STORE_ASSOCIATED_FACES);
+	const bool facesStoreEdges = option_is_enabled(FACEOPT_STORE_ASSOCIATED_EDGES);
+
+	const bool volsCreateEdges = option_is_enabled(VOLOPT_AUTOGENERATE_EDGES);
+	const bool edgesStoreVols = option_is_enabled(EDGEOPT_STORE_ASSOCIATED_VOLUMES);
+	const bool volsStoreEdges = option_is_enabled(VOLOPT_STORE_ASSOCIATED_EDGES);
+
+	if(!(facesCreateEdges || edgesStoreFaces || facesStoreEdges))
+		numFaces = 0;
+	if(!(volsCreateEdges || edgesStoreVols || volsStoreEdges))
+		numVols = 0;
+
+	if(numFaces == 0 && numVols == 0)
+		return;
+
+	const bool searchOldEdges = (num<Edge>() > 0);
+
+//	collect the sides of all faces and volumes and sort them, so that equal
+//	sides are adjacent. The sides of the volumes follow those of the faces.
+	vector<size_t> offsets(numFaces + numVols + 1);
+	offsets[0] = 0;
+	for(size_t i = 0; i < numFaces; ++i)
+		offsets[i + 1] = offsets[i] + faces[i]->num_edges();
+	for(size_t i = 0; i < numVols; ++i)
+		offsets[numFaces + i + 1] = offsets[numFaces + i] + vols[i]->num_edges();
+
+//	The rank of an element is its position in the order in which create
+//	processes the elements. If the faces were created by the volumes
+//	(faceVols[i] is the volume which created faces[i]), create processes
+//	the new faces of a volume right before the volume itself.
+	vector<uint32> ranks(numFaces + numVols);
+	if(faceVols && numVols > 0){
+		uint32 rank = 0;
+		size_t iFace = 0;
+		for(size_t i = 0; i < numVols; ++i){
+			for(; iFace < numFaces && faceVols[iFace] == i; ++iFace)
+				ranks[iFace] = rank++;
+			ranks[numFaces + i] = rank++;
+		}
+		for(; iFace < numFaces; ++iFace)
+			ranks[iFace] = rank++;
+	}
+	else{
+		for(size_t i = 0; i < ranks.size(); ++i)
+			ranks[i] = (uint32)i;
+	}
+
+	vector<BulkSide<2> > sides(offsets.back());
+	EdgeDescriptor ed;
+	for(size_t i = 0; i < numFaces + numVols; ++i){
+		const bool isVol = (i >= numFaces);
+		for(size_t j = offsets[i]; j < offsets[i + 1]; ++j){
+			const int side = (int)(j - offsets[i]);
+			if(isVol)
+				vols[i - numFaces]->edge_desc(side, ed);
+			else
+				faces[i]->edge_desc(side, ed);
+
+			BulkSide<2>& s = sides[j];
+			s.key = VertexTupleKey<2>(ed);
+			s.elem = (uint32)(isVol ? i - numFaces : i);
+			s.rank = ranks[i];
+			s.side = (uint16_t)side;
+			s.isVol = isVol ? 1 : 0;
+		}
+	}
+	SortSides(sides);
+
+//	find or create the edge of each group of equal sides. Edges are created
+//	by the first element whose options demand it. The number of faces and
+//	volumes of each new edge is recorded in order to reserve memory.
+	vector<Edge*> elemEdges(sides.size(), NULL);
+	vector<NewBulkSide<Edge> > newEdges;
+	for(size_t first = 0; first < sides.size();){
+		const size_t last = EndOfEqualSides(sides, first);
+
+		Edge* e = NULL;
+		if(searchOldEdges){
+			const BulkSide<2>& s = sides[first];
+			if(s.isVol)
+				vols[s.elem]->edge_desc(s.side, ed);
+			else
+				faces[s.elem]->edge_desc(s.side, ed);
+			e = find_edge_in_associated_edges(ed.vertex(0), ed);
+		}
+
+		for(size_t i = first; (!e) && (i < last); ++i){
+			const BulkSide<2>& s = sides[i];
+			if(s.isVol && volsCreateEdges)
+				e = vols[s.elem]->create_edge(s.side);
+			else if(!s.isVol && facesCreateEdges)
+				e = faces[s.elem]->create_edge(s.side);
+
+			if(e){
+				NewBulkSide<Edge> ne = {s.order(), e, s.elem, 0, 0};
+				for(size_t j = first; j < last; ++j){
+					if(!sides[j].isVol)
+						++ne.numFaces;
+				}
+				ne.numVols = (uint32)(last - first) - ne.numFaces;
+				newEdges.push_back(ne);
+			}
+		}
+
+		if(e){
+			for(size_t i = first; i < last; ++i){
+				const BulkSide<2>& s = sides[i];
+				const size_t elemInd = s.isVol ? numFaces + s.elem : s.elem;
+				elemEdges[offsets[elemInd] + s.side] = e;
+			}
+		}
+
+		first = last;
+	}
+
+	vector<BulkSide<2> >().swap(sides);
+
+//	store the new edges in the order in which create would have created them
+	sort(newEdges.begin(), newEdges.end());
+	const size_t firstNewEdge = newEdgesOut.size();
+	newEdgesOut.reserve(firstNewEdge + newEdges.size());
+	for(size_t i = 0; i < newEdges.size(); ++i)
+		newEdgesOut.push_back(newEdges[i].side);
+
+	if(!newEdges.empty()){
+		bulk_store_elements(&newEdgesOut[firstNewEdge], newEdges.size(),
+							option_is_enabled(VRTOPT_STORE_ASSOCIATED_EDGES) ?
+								&m_aaEdgeContainerVERTEX : NULL);
+
+		for(size_t i = 0; i < newEdges.size(); ++i){
+			if(edgesStoreFaces)
+				m_aaFaceContainerEDGE[newEdges[i].side].reserve(newEdges[i].numFaces);
+			if(edgesStoreVols)
+				m_aaVolumeContainerEDGE[newEdges[i].side].reserve(newEdges[i].numVols);
+		}
+	}
+
+//	register edges at faces and volumes and vice versa
+	for(size_t i = 0; i < numFaces; ++i){
+		Face* f = faces[i];
+		if(facesStoreEdges)
+			m_aaEdgeContainerFACE[f].reserve(offsets[i + 1] - offsets[i]);
+
+		for(size_t j = offsets[i]; j < offsets[i + 1]; ++j){
+			Edge* e = elemEdges[j];
+			if(!e)
+				continue;
+			if(edgesStoreFaces)
+				m_aaFaceContainerEDGE[e].push_back(f);
+			if(facesStoreEdges)
+				m_aaEdgeContainerFACE[f].push_back(e);
+		}
+	}
+
+	for(size_t i = 0; i < numVols; ++i){
+		Volume* v = vols[i];
+		const size_t elemInd = numFaces + i;
+		if(volsStoreEdges)
+			m_aaEdgeContainerVOLUME[v].reserve(offsets[elemInd + 1] - offsets[elemInd]);
+
+		for(size_t j = offsets[elemInd]; j < offsets[elemInd + 1]; ++j){
+			Edge* e = elemEdges[j];
+			if(!e)
+				continue;
+			if(edgesStoreVols)
+				m_aaVolumeContainerEDGE[e].push_back(v);
+			if(volsStoreEdges)
+				m_aaEdgeContainerVOLUME[v].push_back(e);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+void Grid::register_bulk(Edge** edges, size_t numEdges, GridObject* pParent)
+{
+	if(m_frozenTopology)
+		thaw_topology();
+
+	if(!bulk_registration_is_possible()){
+		reserve<Edge>(num<Edge>() + numEdges);
+		for(size_t i = 0; i < numEdges; ++i)
+			register_edge(edges[i], pParent);
+		return;
+	}
+
+//	edges have no sides and, since bulk registration is possible, no older
+//	faces or volumes have to be informed about them.
+	bulk_store_elements(edges, numEdges,
+						option_is_enabled(VRTOPT_STORE_ASSOCIATED_EDGES) ?
+							&m_aaEdgeContainerVERTEX : NULL);
+
+	NOTIFY_OBSERVERS(m_edgeObservers, edges_created(this, edges, numEdges, pParent));
+}
+
+void Grid::register_bulk(Face** faces, size_t numFaces, GridObject* pParent)
+{
+	if(m_frozenTopology)
+		thaw_topology();
+
+	UG_COND_THROW(numFaces >= (size_t)(uint32)-1,
+				  "Grid::create_bulk: Too many elements in one batch.");
+
+	if(!bulk_registration_is_possible()){
+		reserve<Face>(num<Face>() + numFaces);
+		for(size_t i = 0; i < numFaces; ++i)
+			register_face(faces[i], pParent);
+		return;
+	}
+
+	bulk_store_elements(faces, numFaces,
+						option_is_enabled(VRTOPT_STORE_ASSOCIATED_FACES) ?
+							&m_aaFaceContainerVERTEX : NULL);
+
+	vector<Edge*> newEdges;
+	bulk_connect_edges(newEdges, faces, numFaces, NULL, NULL, 0);
+
+//	inform observers about the creation. Sides first.
+	if(!newEdges.empty())
+		NOTIFY_OBSERVERS(m_edgeObservers, edges_created(this, &newEdges.front(), newEdges.size(), pParent));
+	NOTIFY_OBSERVERS(m_faceObservers, faces_created(this, faces, numFaces, pParent));
+}
+
+void Grid::register_bulk(Volume** vols, size_t numVols, GridObject* pParent)
+{
+	if(m_frozenTopology)
+		thaw_topology();
+
+	UG_COND_THROW(numVols >= (size_t)(uint32)-1,
+				  "Grid::create_bulk: Too many elements in one batch.");
+
+	if(!bulk_registration_is_possible()){
+		reserve<Volume>(num<Volume>() + numVols);
+		for(size_t i = 0; i < numVols; ++i)
+			register_volume(vols[i], pParent);
+		return;
+	}
+
+	bulk_store_elements(vols, numVols,
+						option_is_enabled(VRTOPT_STORE_ASSOCIATED_VOLUMES) ?
+							&m_aaVolumeContainerVERTEX : NULL);
+
+	vector<Face*> newFaces;
+	vector<uint32> newFaceVols;
+	bulk_connect_faces(newFaces, newFaceVols, vols, numVols);
+
+	vector<Edge*> newEdges;
+	bulk_connect_edges(newEdges, newFaces.empty() ? NULL : &newFaces.front(),
+					   newFaces.size(),
+					   newFaceVols.empty() ? NULL : &newFaceVols.front(),
+					   vols, numVols);
+
+//	inform observers about the creation. Sides first.
+	if(!newEdges.empty())
+		NOTIFY_OBSERVERS(m_edgeObservers, edges_created(this, &newEdges.front(), newEdges.size(), pParent));
+	if(!newFaces.empty())
+		NOTIFY_OBSERVERS(m_faceObservers, faces_created(this, &newFaces.front(), newFaces.size(), pParent));
+	NOTIFY_OBSERVERS(m_volumeObservers, volumes_created(this, vols, numVols, pParent));
+}
+
+}//	end of namespace
@@ -98,6 +98,9 @@ void Grid::register_vertex(Vertex* v, GridObject* pParent)
 {
 	GCM_PROFILE_FUNC();
 
+	if(m_frozenTopology)
+		thaw_topology();
+
 //	store the element and register it at the pipe.
 	m_vertexElementStorage.m_attachmentPipe.register_element(v);
 	m_vertexElementStorage.m_sectionContainer.insert(v, v->container_section());
@@ -113,6 +116,9 @@ void Grid::register_vertex(Vertex* v, GridObject* pParent)
 
 void Grid::register_and_replace_element(Vertex* v, Vertex* pReplaceMe)
 {
+	if(m_frozenTopology)
+		thaw_topology();
+
 	m_vertexElementStorage.m_attachmentPipe.register_element(v);
 	m_vertexElementStorage.m_sectionContainer.insert(v, v->container_section());
 
@@ -218,6 +224,9 @@ void Grid::register_and_replace_element(Vertex* v, Vertex* pReplaceMe)
 
 void Grid::unregister_vertex(Vertex* v)
 {
+	if(m_frozenTopology)
+		thaw_topology();
+
 //	notify observers that the vertex is being erased
 	NOTIFY_OBSERVERS_REVERSE(m_vertexObservers, vertex_to_be_erased(this, v));
 
@@ -378,6 +387,8 @@ void Grid::vertex_store_associated_edges(bool bStoreIt)
 	{
 		if(!option_is_enabled(VRTOPT_STORE_ASSOCIATED_EDGES))
 		{
+			thaw_topology();
+
 		//	store associated edges
 			attach_to_vertices(m_aEdgeContainer);
 			m_aaEdgeContainerVERTEX.access(*this, m_aEdgeContainer);
@@ -397,6 +408,7 @@ void Grid::vertex_store_associated_edges(bool bStoreIt)
 	{
 		if(option_is_enabled(VRTOPT_STORE_ASSOCIATED_EDGES))
 		{
+			thaw_topology();
 			detach_from_vertices(m_aEdgeContainer);
 			m_options &= (~VRTOPT_STORE_ASSOCIATED_EDGES);
 		}
@@ -409,6 +421,8 @@ void Grid::vertex_store_associated_faces(bool bStoreIt)
 	{
 		if(!option_is_enabled(VRTOPT_STORE_ASSOCIATED_FACES))
 		{
+			thaw_topology();
+
 		//	store associated faces
 			attach_to_vertices(m_aFaceContainer);
 			m_aaFaceContainerVERTEX.access(*this, m_aFaceContainer);
@@ -431,6 +445,7 @@ void Grid::vertex_store_associated_faces(bool bStoreIt)
 	{
 		if(option_is_enabled(VRTOPT_STORE_ASSOCIATED_FACES))
 		{
+			thaw_topology();
 			detach_from_vertices(m_aFaceContainer);
 			m_options &= (~VRTOPT_STORE_ASSOCIATED_FACES);
 		}
@@ -443,6 +458,8 @@ void Grid::vertex_store_associated_volumes(bool bStoreIt)
 	{
 		if(!option_is_enabled(VRTOPT_STORE_ASSOCIATED_VOLUMES))
 		{
+			thaw_topology();
+
 		//	store associated volumes
 			attach_to_vertices(m_aVolumeContainer);
 			m_aaVolumeContainerVERTEX.access(*this, m_aVolumeContainer);
@@ -465,6 +482,7 @@ void Grid::vertex_store_associated_volumes(bool bStoreIt)
 	{
 		if(option_is_enabled(VRTOPT_STORE_ASSOCIATED_VOLUMES))
 		{
+			thaw_topology();
 			detach_from_vertices(m_aVolumeContainer);
 			m_options &= (~VRTOPT_STORE_ASSOCIATED_VOLUMES);
 		}
@@ -480,6 +498,9 @@ void Grid::register_edge(Edge* e, GridObject* pParent,
 {
 	GCM_PROFILE_FUNC();
 
+	if(m_frozenTopology)
+		thaw_topology();
+
 //	store the element and register it at the pipe.
 	m_edgeElementStorage.m_attachmentPipe.register_element(e);
 	m_edgeElementStorage.m_sectionContainer.insert(e, e->container_section());
@@ -607,6 +628,9 @@ void Grid::register_edge(Edge* e, GridObject* pParent,
 
 void Grid::register_and_replace_element(Edge* e, Edge* pReplaceMe)
 {
+	if(m_frozenTopology)
+		thaw_topology();
+
 //	store the element and register it at the pipe.
 	m_edgeElementStorage.m_attachmentPipe.register_element(e);
 	m_edgeElementStorage.m_sectionContainer.insert(e, e->container_section());
@@ -677,6 +701,9 @@ void Grid::register_and_replace_element(Edge* e, Edge* pReplaceMe)
 
 void Grid::unregister_edge(Edge* e)
 {
+	if(m_frozenTopology)
+		thaw_topology();
+
 //	notify observers that the edge is being erased
 	NOTIFY_OBSERVERS_REVERSE(m_edgeObservers, edge_to_be_erased(this, e));
 
@@ -923,6 +950,12 @@ void Grid::register_face(Face* f, GridObject* pParent, Volume* createdByVol)
 {
 	GCM_PROFILE_FUNC();
 
+//	sides which are created automatically come from the pools of this grid
+	GridObjectPoolScope poolScope(m_objectPools);
+
+	if(m_frozenTopology)
+		thaw_topology();
+
 //	store the element and register it at the pipe.
 	m_faceElementStorage.m_attachmentPipe.register_element(f);
 	m_faceElementStorage.m_sectionContainer.insert(f, f->container_section());
@@ -1043,6 +1076,9 @@ void Grid::register_face(Face* f, GridObject* pParent, Volume* createdByVol)
 
 void Grid::register_and_replace_element(Face* f, Face* pReplaceMe)
 {
+	if(m_frozenTopology)
+		thaw_topology();
+
 //	check that f and pReplaceMe have the same amount of vertices.
 	if(f->num_vertices() != pReplaceMe->num_vertices())
 	{
@@ -1127,6 +1163,9 @@ void Grid::register_and_replace_element(Face* f, Face* pReplaceMe)
 
 void Grid::unregister_face(Face* f)
 {
+	if(m_frozenTopology)
+		thaw_topology();
+
 //	notify observers that the face is being erased
 	NOTIFY_OBSERVERS_REVERSE(m_faceObservers, face_to_be_erased(this, f));
 
@@ -1325,6 +1364,8 @@ void Grid::face_store_associated_volumes(bool bStoreIt)
 	{
 		if(!option_is_enabled(FACEOPT_STORE_ASSOCIATED_VOLUMES))
 		{
+			thaw_topology();
+
 		//	store associated faces
 			attach_to_faces(m_aVolumeContainer);
 			m_aaVolumeContainerFACE.access(*this, m_aVolumeContainer);
@@ -1362,6 +1403,7 @@ void Grid::face_store_associated_volumes(bool bStoreIt)
 	{
 		if(option_is_enabled(FACEOPT_STORE_ASSOCIATED_VOLUMES))
 		{
+			thaw_topology();
 		//	remove face-edge connections
 			detach_from_faces(m_aVolumeContainer);
 			m_options &= (~FACEOPT_STORE_ASSOCIATED_VOLUMES);
@@ -1371,6 +1413,8 @@ void Grid::face_store_associated_volumes(bool bStoreIt)
 
 void Grid::face_autogenerate_edges(bool bAutogen)
 {
+	GridObjectPoolScope poolScope(m_objectPools);
+
 	if(bAutogen)
 	{
 		if(!option_is_enabled(FACEOPT_AUTOGENERATE_EDGES))
@@ -1441,6 +1485,12 @@ void Grid::register_volume(Volume* v, GridObject* pParent)
 {
 	GCM_PROFILE_FUNC();
 
+//	sides which are created automatically come from the pools of this grid
+	GridObjectPoolScope poolScope(m_objectPools);
+
+	if(m_frozenTopology)
+		thaw_topology();
+
 //	store the element and register it at the pipe.
 	m_volumeElementStorage.m_attachmentPipe.register_element(v);
 	m_volumeElementStorage.m_sectionContainer.insert(v, v->container_section());
@@ -1575,6 +1625,9 @@ void Grid::register_volume(Volume* v, GridObject* pParent)
 
 void Grid::register_and_replace_element(Volume* v, Volume* pReplaceMe)
 {
+	if(m_frozenTopology)
+		thaw_topology();
+
 //	check that v and pReplaceMe have the same number of vertices.
 	if(v->num_vertices() != pReplaceMe->num_vertices())
 	{
@@ -1656,6 +1709,9 @@ void Grid::register_and_replace_element(Volume* v, Volume* pReplaceMe)
 
 void Grid::unregister_volume(Volume* v)
 {
+	if(m_frozenTopology)
+		thaw_topology();
+
 //	notify observers that the face is being erased
 	NOTIFY_OBSERVERS_REVERSE(m_volumeObservers, volume_to_be_erased(this, v));
 
@@ -1928,6 +1984,8 @@ void Grid::volume_store_associated_faces(bool bStoreIt)
 
 void Grid::volume_autogenerate_edges(bool bAutogen)
 {
+	GridObjectPoolScope poolScope(m_objectPools);
+
 	if(bAutogen)
 	{
 		if(!option_is_enabled(VOLOPT_AUTOGENERATE_EDGES))
@@ -1981,6 +2039,8 @@ void Grid::volume_autogenerate_edges(bool bAutogen)
 
 void Grid::volume_autogenerate_faces(bool bAutogen)
 {
+	GridObjectPoolScope poolScope(m_objectPools);
+
 	if(bAutogen)
 	{
 		if(!option_is_enabled(VOLOPT_AUTOGENERATE_FACES))
@@ -2083,8 +2143,44 @@ void Grid::volume_sort_associated_edge_container()
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 //	replace_vertex
+///	inserts or erases all edges, faces and volumes of vrt into / from the given hash
+static void UpdateVertexTupleHash(Grid& g, VertexTupleHash& vth, Vertex* vrt, bool insert)
+{
+	Grid::edge_traits::secure_container		edges;
+	Grid::face_traits::secure_container		faces;
+	Grid::volume_traits::secure_container	vols;
+	g.associated_elements(edges, vrt);
+	g.associated_elements(faces, vrt);
+	g.associated_elements(vols, vrt);
+
+	for(size_t i = 0; i < edges.size(); ++i){
+		if(insert)	vth.insert(edges[i]);
+		else		vth.erase(edges[i]);
+	}
+	for(size_t i = 0; i < faces.size(); ++i){
+		if(insert)	vth.insert(faces[i]);
+		else		vth.erase(faces[i]);
+	}
+	for(size_t i = 0; i < vols.size(); ++i){
+		if(insert)	vth.insert(vols[i]);
+		else		vth.erase(vols[i]);
+	}
+}
+
 bool Grid::replace_vertex(Vertex* vrtOld, Vertex* vrtNew)
 {
+	if(m_frozenTopology)
+		thaw_topology();
+
+//	elements are changed in place below, which would corrupt lookups through
+//	the vertex tuple hash. It is thus bypassed and the elements of vrtOld are
+//	removed from it. They are reinserted through vrtNew at the end.
+	VertexTupleHash* vrtTupleHash = m_vertexTupleHash;
+	if(vrtTupleHash){
+		m_vertexTupleHash = NULL;
+		UpdateVertexTupleHash(*this, *vrtTupleHash, vrtOld, false);
+	}
+
 //	this bool should be a parameter. However one first would have
 //	to add connectivity updates for double-elements in this method,
 //	to handle the case when eraseDoubleElements is set to false.
@@ -2530,6 +2626,11 @@ bool Grid::replace_vertex(Vertex* vrtOld, Vertex* vrtNew)
 	m_vertexElementStorage.m_attachmentPipe.unregister_element(vrtOld);
 	delete vrtOld;
 
+	if(vrtTupleHash){
+		UpdateVertexTupleHash(*this, *vrtTupleHash, vrtNew, true);
+		m_vertexTupleHash = vrtTupleHash;
+	}
+
 	return true;
 }
 
@@ -2639,6 +2740,12 @@ void Grid::get_associated(SecureEdgeContainer& edges, Vertex* v)
 		vertex_store_associated_edges(true);
 	}
 
+	if(m_frozenTopology){
+		FrozenRelation<Edge>& rel = m_frozenTopology->vrtEdges;
+		edges.set_external_array(rel.array(v), rel.size(v));
+		return;
+	}
+
 	EdgeContainer& assEdges = m_aaEdgeContainerVERTEX[v];
 	if(assEdges.empty())
 		edges.clear();
@@ -2725,6 +2832,12 @@ void Grid::get_associated(SecureFaceContainer& faces, Vertex* v)
 		vertex_store_associated_faces(true);
 	}
 
+	if(m_frozenTopology){
+		FrozenRelation<Face>& rel = m_frozenTopology->vrtFaces;
+		faces.set_external_array(rel.array(v), rel.size(v));
+		return;
+	}
+
 	FaceContainer& assFaces = m_aaFaceContainerVERTEX[v];
 	if(assFaces.empty())
 		faces.clear();
@@ -2769,10 +2882,12 @@ void Grid::get_associated(SecureFaceContainer& faces, Edge* e)
 		}
 */
 
-		FaceContainer& assFaces = m_aaFaceContainerVERTEX[vrt];
-		for(size_t i = 0; i < assFaces.size(); ++i){
-			if(FaceContains(assFaces[i], e))
-				faces.push_back(assFaces[i]);
+		AssociatedFaceIterator iterEnd = associated_faces_end(vrt);
+		for(AssociatedFaceIterator iter = associated_faces_begin(vrt);
+			iter != iterEnd; ++iter)
+		{
+			if(FaceContains(*iter, e))
+				faces.push_back(*iter);
 		}
 	}
 }
@@ -2826,6 +2941,12 @@ void Grid::get_associated(SecureVolumeContainer& vols, Vertex* v)
 		vertex_store_associated_volumes(true);
 	}
 
+	if(m_frozenTopology){
+		FrozenRelation<Volume>& rel = m_frozenTopology->vrtVolumes;
+		vols.set_external_array(rel.array(v), rel.size(v));
+		return;
+	}
+
 	VolumeContainer& assVols = m_aaVolumeContainerVERTEX[v];
 	if(assVols.empty())
 		vols.clear();
@@ -2870,10 +2991,12 @@ void Grid::get_associated(SecureVolumeContainer& vols, Edge* e)
 		}
 */
 
-		VolumeContainer& assVols = m_aaVolumeContainerVERTEX[vrt];
-		for(size_t i = 0; i < assVols.size(); ++i){
-			if(VolumeContains(assVols[i], e))
-				vols.push_back(assVols[i]);
+		AssociatedVolumeIterator iterEnd = associated_volumes_end(vrt);
+		for(AssociatedVolumeIterator iter = associated_volumes_begin(vrt);
+			iter != iterEnd; ++iter)
+		{
+			if(VolumeContains(*iter, e))
+				vols.push_back(*iter);
 		}
 	}
 }
@@ -2882,6 +3005,12 @@ void Grid::get_associated(SecureVolumeContainer& vols, Face* f)
 {
 //	best option: FACEOPT_STORE_ASSOCIATED_VOLUMES
 	if(option_is_enabled(FACEOPT_STORE_ASSOCIATED_VOLUMES)){
+		if(m_frozenTopology){
+			FrozenRelation<Volume>& rel = m_frozenTopology->faceVolumes;
+			vols.set_external_array(rel.array(f), rel.size(f));
+			return;
+		}
+
 	//	we can output the associated array directly
 		VolumeContainer& assVols = m_aaVolumeContainerFACE[f];
 		if(assVols.empty())
@@ -2914,9 +3043,11 @@ void Grid::get_associated_vols_raw(SecureVolumeContainer& vols, Face* f)
 //	check as few faces as possible
 	Vertex* vrt = f->vertex(0);
 
-	VolumeContainer& assVols = m_aaVolumeContainerVERTEX[vrt];
-	for(size_t i = 0; i < assVols.size(); ++i){
-		Volume* v = assVols[i];
+	AssociatedVolumeIterator iterEnd = associated_volumes_end(vrt);
+	for(AssociatedVolumeIterator iter = associated_volumes_begin(vrt);
+		iter != iterEnd; ++iter)
+	{
+		Volume* v = *iter;
 		if(VolumeContains(v, f->vertex(1))){
 			if(VolumeContains(v, f->vertex(2))){
 				if(VolumeContains(v, f))
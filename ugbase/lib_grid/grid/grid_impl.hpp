@@ -72,6 +72,7 @@ Grid::create(GridObject* pParent)
 		&&	geometry_traits<TGeomObj>::BASE_OBJECT_ID != -1,
 		invalid_geometry_type);
 
+	GridObjectPoolScope poolScope(m_objectPools);
 	TGeomObj* geomObj = new TGeomObj;
 //	int baseObjectType = geometry_traits<GeomObjType>::base_object_type();
 //	geomObj->m_elemHandle = m_elementStorage[baseObjectType].m_sectionContainer.insert_element(geomObj, geometry_traits<GeomObjType>::container_section());
@@ -91,6 +92,7 @@ Grid::create(const typename geometry_traits<TGeomObj>::Descriptor& descriptor,
 			&&	geometry_traits<TGeomObj>::BASE_OBJECT_ID != -1,
 			invalid_geometry_type);
 
+	GridObjectPoolScope poolScope(m_objectPools);
 	TGeomObj* geomObj = new TGeomObj(descriptor);
 
 //	int baseObjectType = geometry_traits<TGeomObj>::base_object_type();
@@ -110,6 +112,7 @@ Grid::create_and_replace(typename geometry_traits<TGeomObj>::grid_base_object* p
 		&&	geometry_traits<TGeomObj>::BASE_OBJECT_ID != -1,
 		invalid_geometry_type);
 
+	GridObjectPoolScope poolScope(m_objectPools);
 	TGeomObj* geomObj = new TGeomObj;
 
 	if(geomObj->reference_object_id() == pReplaceMe->reference_object_id())
@@ -136,6 +139,39 @@ void Grid::reserve(size_t num)
 	element_storage<TGeomObj>().m_attachmentPipe.reserve(num);
 }
 
+////////////////////////////////////////////////////////////////////////
+template <class TGeomObj>
+void Grid::create_bulk(const std::vector<Vertex*>& vrts, const int* vrtInds,
+					   size_t numElems,
+					   std::vector<typename geometry_traits<TGeomObj>::grid_base_object*>*
+					   	elemsOut,
+					   GridObject* pParent)
+{
+	STATIC_ASSERT(geometry_traits<TGeomObj>::CONTAINER_SECTION != -1
+			&&	geometry_traits<TGeomObj>::BASE_OBJECT_ID != -1,
+			invalid_geometry_type);
+
+	typedef typename geometry_traits<TGeomObj>::grid_base_object TBaseObj;
+	const size_t numVrts = TGeomObj::NUM_VERTICES;
+
+	GridObjectPoolScope poolScope(m_objectPools);
+
+	std::vector<TBaseObj*> tmpElems;
+	std::vector<TBaseObj*>& elems = elemsOut ? *elemsOut : tmpElems;
+	const size_t firstElem = elems.size();
+	elems.reserve(firstElem + numElems);
+
+	for(size_t i = 0; i < numElems; ++i){
+		TBaseObj* elem = new TGeomObj;
+		for(size_t j = 0; j < numVrts; ++j)
+			elem->set_vertex(j, vrts[vrtInds[i * numVrts + j]]);
+		elems.push_back(elem);
+	}
+
+	if(numElems > 0)
+		register_bulk(&elems[firstElem], numElems, pParent);
+}
+
 ////////////////////////////////////////////////////////////////////////
 //	erase
 template <class GeomObjIter>
@@ -290,6 +326,31 @@ size_t Grid::attachment_container_size() const
 	return element_storage<TGeomObj>().m_attachmentPipe.num_data_entries();
 }
 
+template <class TGeomObj>
+void Grid::defragment()
+{
+	STATIC_ASSERT(geometry_traits<TGeomObj>::BASE_OBJECT_ID != -1,
+			invalid_GeomObj);
+
+	if(topology_is_frozen())
+		thaw_topology();
+
+	element_storage<TGeomObj>().m_attachmentPipe.reorder();
+}
+
+template <class TElem>
+void Grid::reorder_elements(const std::vector<TElem*>& elems)
+{
+	typename traits<TElem>::SectionContainer& sc
+								= element_storage<TElem>().m_sectionContainer;
+
+	for(size_t i = 0; i < elems.size(); ++i){
+		TElem* e = elems[i];
+		sc.erase(get_iterator(e), e->container_section());
+		sc.insert(e, e->container_section());
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////
 //	attachment handling
 template <class TGeomObjClass>
@@ -545,6 +606,9 @@ Edge* Grid::find_edge_in_associated_edges(TGeomObj* obj, const EdgeVertices& ev)
 {
 	GRID_PROFILE_FUNC();
 
+	if(m_vertexTupleHash)
+		return m_vertexTupleHash->find(ev);
+
 	AssociatedEdgeIterator iterEnd = associated_edges_end(obj);
 	for(AssociatedEdgeIterator iter = associated_edges_begin(obj);
 		iter != iterEnd; ++iter)
@@ -562,6 +626,9 @@ Face* Grid::find_face_in_associated_faces(TGeomObj* obj, const FaceVertices& fv)
 {
 	GRID_PROFILE_FUNC();
 
+	if(m_vertexTupleHash)
+		return m_vertexTupleHash->find(fv);
+
 	unsigned long key = hash_key(&fv);
 	AssociatedFaceIterator iterEnd = associated_faces_end(obj);
 	for(AssociatedFaceIterator iter = associated_faces_begin(obj);
@@ -584,6 +651,9 @@ Volume* Grid::find_volume_in_associated_volumes(TGeomObj* obj,
 {
 	GRID_PROFILE_FUNC();
 
+	if(m_vertexTupleHash)
+		return m_vertexTupleHash->find(vv);
+
 	unsigned long key = hash_key(&vv);
 	AssociatedVolumeIterator iterEnd = associated_volumes_end(obj);
 	for(AssociatedVolumeIterator iter = associated_volumes_begin(obj);
@@ -121,6 +121,33 @@ class UG_API GridObserver
 									bool replacesParent = false)			{}
 	///	\}
 
+	///	Notified once for a batch of new elements of the given type (see Grid::create_bulk)
+	/**	The default implementations call the creation callback of a single
+	 * element for each element of the batch. Observers which can process a
+	 * batch at once, e.g. by resizing their data only once, may override them.
+	 * \{ */
+		virtual void edges_created(Grid* grid, Edge** edges, size_t num,
+								   GridObject* pParent = NULL)
+		{
+			for(size_t i = 0; i < num; ++i)
+				edge_created(grid, edges[i], pParent);
+		}
+
+		virtual void faces_created(Grid* grid, Face** faces, size_t num,
+								   GridObject* pParent = NULL)
+		{
+			for(size_t i = 0; i < num; ++i)
+				face_created(grid, faces[i], pParent);
+		}
+
+		virtual void volumes_created(Grid* grid, Volume** vols, size_t num,
+									 GridObject* pParent = NULL)
+		{
+			for(size_t i = 0; i < num; ++i)
+				volume_created(grid, vols[i], pParent);
+		}
+	/**	\}	*/
+
 
 	//	erase callbacks
 	///	Notified whenever an element of the given type is erased from the given grid.
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#include "vertex_tuple_hash.h"
+#include "grid.h"
+
+namespace ug{
+
+VertexTupleHash::
+VertexTupleHash() :
+	m_pGrid(NULL)
+{
+}
+
+VertexTupleHash::
+~VertexTupleHash()
+{
+	if(m_pGrid)
+		m_pGrid->unregister_observer(this);
+}
+
+void VertexTupleHash::
+set_grid(Grid* grid)
+{
+	if(m_pGrid)
+		m_pGrid->unregister_observer(this);
+
+	m_pGrid = grid;
+	if(m_pGrid){
+		m_pGrid->register_observer(this, OT_GRID_OBSERVER | OT_EDGE_OBSERVER
+										| OT_FACE_OBSERVER | OT_VOLUME_OBSERVER);
+	}
+	rebuild();
+}
+
+void VertexTupleHash::
+rebuild()
+{
+	m_edgeHash.clear();
+	m_faceHash.clear();
+	m_volumeHash.clear();
+
+	if(!m_pGrid)
+		return;
+
+	Grid& g = *m_pGrid;
+	m_edgeHash.resize_hash(g.num<Edge>());
+	m_faceHash.resize_hash(g.num<Face>());
+	m_volumeHash.resize_hash(g.num<Volume>());
+
+	for(EdgeIterator iter = g.begin<Edge>(); iter != g.end<Edge>(); ++iter)
+		insert_into(m_edgeHash, *iter);
+	for(FaceIterator iter = g.begin<Face>(); iter != g.end<Face>(); ++iter)
+		insert_into(m_faceHash, *iter);
+	for(VolumeIterator iter = g.begin<Volume>(); iter != g.end<Volume>(); ++iter)
+		insert_into(m_volumeHash, *iter);
+}
+
+template <class TKey, class TElem>
+void VertexTupleHash::
+insert_into(Hash<TKey, TElem*>& hash, TElem* elem)
+{
+	TKey key(*elem);
+	TElem* oldElem;
+	if(hash.get_entry(oldElem, key)){
+		hash.get_entry(key) = elem;
+		return;
+	}
+
+//	keep the average length of the hash chains below one
+	if(hash.size() >= hash.hash_size())
+		hash.resize_hash(2 * hash.hash_size() + 1);
+
+	hash.insert(key, elem);
+}
+
+template <class TKey, class TElem>
+void VertexTupleHash::
+erase_from(Hash<TKey, TElem*>& hash, TElem* elem)
+{
+	TKey key(*elem);
+	TElem* entry;
+	if(hash.get_entry(entry, key) && entry == elem)
+		hash.erase(key);
+}
+
+void VertexTupleHash::insert(Edge* e)		{insert_into(m_edgeHash, e);}
+void VertexTupleHash::insert(Face* f)		{insert_into(m_faceHash, f);}
+void VertexTupleHash::insert(Volume* vol)	{insert_into(m_volumeHash, vol);}
+
+void VertexTupleHash::erase(Edge* e)		{erase_from(m_edgeHash, e);}
+void VertexTupleHash::erase(Face* f)		{erase_from(m_faceHash, f);}
+void VertexTupleHash::erase(Volume* vol)	{erase_from(m_volumeHash, vol);}
+
+void VertexTupleHash::
+grid_to_be_destroyed(Grid* grid)
+{
+	m_pGrid = NULL;
+	elements_to_be_cleared(grid);
+}
+
+void VertexTupleHash::
+elements_to_be_cleared(Grid*)
+{
+	m_edgeHash.clear();
+	m_faceHash.clear();
+	m_volumeHash.clear();
+}
+
+void VertexTupleHash::
+edge_created(Grid*, Edge* e, GridObject*, bool)
+{
+	insert(e);
+}
+
+void VertexTupleHash::
+face_created(Grid*, Face* f, GridObject*, bool)
+{
+	insert(f);
+}
+
+void VertexTupleHash::
+volume_created(Grid*, Volume* vol, GridObject*, bool)
+{
+	insert(vol);
+}
+
+void VertexTupleHash::
+edge_to_be_erased(Grid*, Edge* e, Edge*)
+{
+	erase(e);
+}
+
+void VertexTupleHash::
+face_to_be_erased(Grid*, Face* f, Face*)
+{
+	erase(f);
+}
+
+void VertexTupleHash::
+volume_to_be_erased(Grid*, Volume* vol, Volume*)
+{
+	erase(vol);
+}
+
+}//	end of namespace
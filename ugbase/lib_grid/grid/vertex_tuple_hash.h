@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__LIB_GRID__VERTEX_TUPLE_HASH__
+#define __H__UG__LIB_GRID__VERTEX_TUPLE_HASH__
+
+#include <algorithm>
+#include "common/util/hash.h"
+#include "grid_base_objects.h"
+#include "grid_observer.h"
+
+namespace ug{
+
+/// \addtogroup lib_grid_grid
+/// @{
+
+///	Sorted hash values of the corners of an element. Unused entries are set to -1.
+template <int N>
+struct VertexTupleKey
+{
+	VertexTupleKey()	{}
+
+	explicit VertexTupleKey(const IVertexGroup& vg)
+	{
+		IVertexGroup::ConstVertexArray vrts = vg.vertices();
+		const size_t numVrts = vg.num_vertices();
+		UG_ASSERT(numVrts <= (size_t)N, "Too many vertices for VertexTupleKey<" << N << ">");
+		for(size_t i = 0; i < numVrts; ++i)
+			ids[i] = vrts[i]->get_hash_value();
+		for(size_t i = numVrts; i < (size_t)N; ++i)
+			ids[i] = (uint32)-1;
+		std::sort(ids, ids + numVrts);
+	}
+
+	bool operator == (const VertexTupleKey& k) const
+	{
+		for(int i = 0; i < N; ++i){
+			if(ids[i] != k.ids[i])
+				return false;
+		}
+		return true;
+	}
+
+	///	lexicographic order, e.g. to sort keys of sides
+	bool operator < (const VertexTupleKey& k) const
+	{
+		for(int i = 0; i < N; ++i){
+			if(ids[i] != k.ids[i])
+				return ids[i] < k.ids[i];
+		}
+		return false;
+	}
+
+	uint32	ids[N];
+};
+
+template <int N>
+size_t hash_key(const VertexTupleKey<N>& key)
+{
+	size_t h = 0;
+	for(int i = 0; i < N; ++i)
+		h = h * 1000003 + key.ids[i];
+	return h;
+}
+
+
+///	Index of edges, faces and volumes of a grid keyed by their sorted corner vertices
+/**	A grid normally finds an element with given corners by searching the
+ * associated elements of one of the corners, see Grid::get_edge, Grid::get_face
+ * and Grid::get_volume. The cost of such a search grows with the valence of the
+ * vertex, which makes grid construction and refinement expensive on meshes with
+ * high vertex valences.
+ *
+ * Once enabled through Grid::set_vertex_tuple_hash, the hash is kept up to date
+ * through the GridObserver callbacks and Grid uses it to answer those queries in
+ * constant time.
+ *
+ * Note that the hash is not updated if the vertices of an element are changed
+ * directly (e.g. through Edge::set_vertex). Use erase and insert or rebuild
+ * in such a case. Grid::replace_vertex takes care of this automatically.
+ */
+class UG_API VertexTupleHash : public GridObserver
+{
+	public:
+		VertexTupleHash();
+		virtual ~VertexTupleHash();
+
+	///	registers the hash at the given grid and inserts all of its elements
+		void set_grid(Grid* grid);
+		Grid* grid()	{return m_pGrid;}
+
+	///	clears the hash and inserts all edges, faces and volumes of the grid
+		void rebuild();
+
+	///	returns the element with the given corners or NULL if no such element exists
+	/// \{
+		inline Edge* find(const EdgeVertices& ev) const		{return find_entry(m_edgeHash, EdgeKey(ev));}
+		inline Face* find(const FaceVertices& fv) const		{return find_entry(m_faceHash, FaceKey(fv));}
+		inline Volume* find(const VolumeVertices& vv) const	{return find_entry(m_volumeHash, VolumeKey(vv));}
+	/// \}
+
+	///	inserts the element. An element with the same corners is replaced.
+	/// \{
+		void insert(Edge* e);
+		void insert(Face* f);
+		void insert(Volume* vol);
+	/// \}
+
+	///	removes the element, if it is contained in the hash
+	/// \{
+		void erase(Edge* e);
+		void erase(Face* f);
+		void erase(Volume* vol);
+	/// \}
+
+	///	total number of indexed elements
+		size_t size() const	{return m_edgeHash.size() + m_faceHash.size() + m_volumeHash.size();}
+
+	//	grid callbacks
+		virtual void grid_to_be_destroyed(Grid* grid);
+		virtual void elements_to_be_cleared(Grid* grid);
+
+		virtual void edge_created(Grid* grid, Edge* e, GridObject* pParent = NULL,
+								  bool replacesParent = false);
+		virtual void face_created(Grid* grid, Face* f, GridObject* pParent = NULL,
+								  bool replacesParent = false);
+		virtual void volume_created(Grid* grid, Volume* vol, GridObject* pParent = NULL,
+									bool replacesParent = false);
+
+		virtual void edge_to_be_erased(Grid* grid, Edge* e, Edge* replacedBy = NULL);
+		virtual void face_to_be_erased(Grid* grid, Face* f, Face* replacedBy = NULL);
+		virtual void volume_to_be_erased(Grid* grid, Volume* vol, Volume* replacedBy = NULL);
+
+	private:
+		typedef VertexTupleKey<2>						EdgeKey;
+		typedef VertexTupleKey<MAX_FACE_VERTICES>		FaceKey;
+		typedef VertexTupleKey<MAX_VOLUME_VERTICES>		VolumeKey;
+
+		template <class TKey, class TElem>
+		static inline TElem* find_entry(const Hash<TKey, TElem*>& hash, const TKey& key)
+		{
+			TElem* e;
+			if(hash.get_entry(e, key))
+				return e;
+			return NULL;
+		}
+
+		template <class TKey, class TElem>
+		static void insert_into(Hash<TKey, TElem*>& hash, TElem* elem);
+
+		template <class TKey, class TElem>
+		static void erase_from(Hash<TKey, TElem*>& hash, TElem* elem);
+
+	private:
+		Grid*						m_pGrid;
+		Hash<EdgeKey, Edge*>		m_edgeHash;
+		Hash<FaceKey, Face*>		m_faceHash;
+		Hash<VolumeKey, Volume*>	m_volumeHash;
+};
+
+/// @}
+
+}//	end of namespace
+
+#endif
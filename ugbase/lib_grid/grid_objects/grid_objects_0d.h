@@ -66,6 +66,8 @@ class UG_API RegularVertex : public Vertex
 
 		virtual ~RegularVertex()	{}
 
+		UG_GRID_OBJECT_POOLED(RegularVertex)
+
 		virtual GridObject* create_empty_instance() const	{return new RegularVertex;}
 
 		virtual int container_section() const	{return CSVRT_REGULAR_VERTEX;}
@@ -119,6 +121,8 @@ class UG_API ConstrainedVertex : public Vertex
 				m_constrainingObj->remove_constraint_link(this);
 		}
 
+		UG_GRID_OBJECT_POOLED(ConstrainedVertex)
+
 		virtual GridObject* create_empty_instance() const	{return new ConstrainedVertex;}
 
 		virtual int container_section() const	{return CSVRT_CONSTRAINED_VERTEX;}
@@ -83,6 +83,8 @@ class UG_API RegularEdge : public Edge
 
 		virtual ~RegularEdge()	{}
 
+		UG_GRID_OBJECT_POOLED(RegularEdge)
+
 		virtual GridObject* create_empty_instance() const	{return new RegularEdge;}
 
 		virtual int container_section() const	{return CSEDGE_REGULAR_EDGE;}
@@ -171,6 +173,8 @@ class UG_API ConstrainedEdge : public Edge
 				m_pConstrainingObject->remove_constraint_link(this);
 		}
 
+		UG_GRID_OBJECT_POOLED(ConstrainedEdge)
+
 		virtual GridObject* create_empty_instance() const	{return new ConstrainedEdge;}
 
 		virtual int container_section() const	{return CSEDGE_CONSTRAINED_EDGE;}
@@ -309,6 +313,8 @@ class UG_API ConstrainingEdge : public Edge
 			}
 		}
 
+		UG_GRID_OBJECT_POOLED(ConstrainingEdge)
+
 		virtual GridObject* create_empty_instance() const	{return new ConstrainingEdge;}
 
 		virtual int container_section() const	{return CSEDGE_CONSTRAINING_EDGE;}
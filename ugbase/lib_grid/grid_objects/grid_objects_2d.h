@@ -114,6 +114,8 @@ class UG_API CustomTriangle : public BaseClass
 		CustomTriangle(const TriangleDescriptor& td);
 		CustomTriangle(Vertex* v1, Vertex* v2, Vertex* v3);
 
+		UG_GRID_OBJECT_POOLED(ConcreteTriangleType)
+
 		virtual GridObject* create_empty_instance() const	{return new ConcreteTriangleType;}
 		virtual ReferenceObjectID reference_object_id() const {return ROID_TRIANGLE;}
 
@@ -259,6 +261,8 @@ class UG_API CustomQuadrilateral : public BaseClass
 		CustomQuadrilateral(Vertex* v1, Vertex* v2,
 							Vertex* v3, Vertex* v4);
 
+		UG_GRID_OBJECT_POOLED(ConcreteQuadrilateralType)
+
 		virtual GridObject* create_empty_instance() const	{return new ConcreteQuadrilateralType;}
 		virtual ReferenceObjectID reference_object_id() const {return ROID_QUADRILATERAL;}
 
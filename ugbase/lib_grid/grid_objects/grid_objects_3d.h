@@ -101,6 +101,8 @@ class UG_API Tetrahedron : public Volume
 		Tetrahedron(const TetrahedronDescriptor& td);
 		Tetrahedron(Vertex* v1, Vertex* v2, Vertex* v3, Vertex* v4);
 
+		UG_GRID_OBJECT_POOLED(Tetrahedron)
+
 		virtual GridObject* create_empty_instance() const	{return new Tetrahedron;}
 
 		virtual Vertex* vertex(size_t index) const	{return m_vertices[index];}
@@ -238,6 +240,8 @@ class UG_API Hexahedron : public Volume
 		Hexahedron(Vertex* v1, Vertex* v2, Vertex* v3, Vertex* v4,
 					Vertex* v5, Vertex* v6, Vertex* v7, Vertex* v8);
 
+		UG_GRID_OBJECT_POOLED(Hexahedron)
+
 		virtual GridObject* create_empty_instance() const	{return new Hexahedron;}
 
 		virtual Vertex* vertex(size_t index) const	{return m_vertices[index];}
@@ -371,6 +375,8 @@ class UG_API Prism : public Volume
 		Prism(Vertex* v1, Vertex* v2, Vertex* v3,
 				Vertex* v4, Vertex* v5, Vertex* v6);
 
+		UG_GRID_OBJECT_POOLED(Prism)
+
 		virtual GridObject* create_empty_instance() const	{return new Prism;}
 
 		virtual Vertex* vertex(size_t index) const	{return m_vertices[index];}
@@ -504,6 +510,8 @@ class UG_API Pyramid : public Volume
 		Pyramid(Vertex* v1, Vertex* v2, Vertex* v3,
 				Vertex* v4, Vertex* v5);
 
+		UG_GRID_OBJECT_POOLED(Pyramid)
+
 		virtual GridObject* create_empty_instance() const	{return new Pyramid;}
 
 		virtual Vertex* vertex(size_t index) const	{return m_vertices[index];}
@@ -636,6 +644,8 @@ class UG_API Octahedron : public Volume
 		Octahedron(const OctahedronDescriptor& td);
 		Octahedron(Vertex* v1, Vertex* v2, Vertex* v3, Vertex* v4, Vertex* v5, Vertex* v6);
 
+		UG_GRID_OBJECT_POOLED(Octahedron)
+
 		virtual GridObject* create_empty_instance() const	{return new Octahedron;}
 
 		virtual Vertex* vertex(size_t index) const	{return m_vertices[index];}
@@ -206,6 +206,12 @@ class MultiGrid : public Grid, public GridObserver
 		int get_level(TElem* elem) const
 		{return m_hierarchy.get_subset_index(elem);}
 
+	///	changes the order in which the given elements are stored and iterated
+	/**	The elements are reordered in the grid and in their levels.
+	 * See Grid::reorder_elements for details.*/
+		template <class TElem>
+		void reorder_elements(const std::vector<TElem*>& elems);
+
 		GridObject* get_parent(GridObject* parent) const;
 		inline GridObject* get_parent(Vertex* o) const	{return get_info(o).m_pParent;}
 		inline GridObject* get_parent(Edge* o) const	{return get_info(o).m_pParent;}
@@ -103,6 +103,14 @@ num_children_total(TElem* elem)	const
 }
 
 
+template <class TElem>
+void MultiGrid::
+reorder_elements(const std::vector<TElem*>& elems)
+{
+	Grid::reorder_elements(elems);
+	m_hierarchy.reorder_elements(elems);
+}
+
 template<class TGeomObj>
 typename geometry_traits<TGeomObj>::iterator
 MultiGrid::create(size_t level)
@@ -0,0 +1,623 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#include <algorithm>
+#include <limits>
+#include "distributed_loading.h"
+#include "distributed_grid.h"
+#include "lib_grid/file_io/file_io_ugb.h"
+#include "lib_grid/algorithms/space_filling_curve_util.h"
+#include "common/profiler/profiler.h"
+
+using namespace std;
+
+namespace ug{
+
+namespace{
+
+const size_t NUM_KEY_ENTRIES = 4;
+
+///	identifies a vertex, edge or face through the sorted file indices of its corners
+/**	Unused entries are set to UGB_INVALID_INDEX.*/
+struct EntityKey{
+	uint64	inds[NUM_KEY_ENTRIES];
+
+	bool operator<(const EntityKey& k) const
+	{
+		for(size_t i = 0; i < NUM_KEY_ENTRIES; ++i){
+			if(inds[i] != k.inds[i])
+				return inds[i] < k.inds[i];
+		}
+		return false;
+	}
+
+	bool operator==(const EntityKey& k) const
+	{
+		for(size_t i = 0; i < NUM_KEY_ENTRIES; ++i){
+			if(inds[i] != k.inds[i])
+				return false;
+		}
+		return true;
+	}
+};
+
+///	an entity key together with a process (index in the process communicator)
+struct KeyRecord{
+	EntityKey	key;
+	uint64		proc;
+
+	bool operator<(const KeyRecord& r) const
+	{
+		if(key == r.key)
+			return proc < r.proc;
+		return key < r.key;
+	}
+};
+
+///	a local entity which is shared with another process
+struct InterfaceEntry{
+	uint64		proc;
+	EntityKey	key;
+	GridObject*	obj;
+
+	bool operator<(const InterfaceEntry& e) const
+	{
+		if(proc == e.proc)
+			return key < e.key;
+		return proc < e.proc;
+	}
+};
+
+struct LocalEntity{
+	EntityKey	key;
+	GridObject*	obj;
+
+	bool operator<(const LocalEntity& e) const	{return key < e.key;}
+};
+
+typedef Attachment<uint64>	AFileIndex;
+
+
+///	first element of the slice of the given process
+size_t SliceBegin(size_t numElems, size_t numProcs, size_t proc)
+{
+	return (size_t)((uint64)numElems * proc / numProcs);
+}
+
+///	sends sendVecs[i] to the i-th process of procComm and collects all received records
+/**	Send sizes are exchanged through a single alltoall. Records for the local
+ * process are copied directly. T has to be a POD type.*/
+template <class T>
+void ExchangeRecords(const pcl::ProcessCommunicator& procComm,
+					 vector<vector<T> >& sendVecs, vector<T>& recvOut)
+{
+	pcl::ProcessCommunicator com = procComm;
+	const int numProcs = (int)com.size();
+	const int localProc = com.get_local_proc_id();
+
+	vector<int> sendSizes(numProcs, 0), recvSizes(numProcs, 0);
+	for(int i = 0; i < numProcs; ++i){
+		if(i != localProc)
+			sendSizes[i] = (int)(sendVecs[i].size() * sizeof(T));
+	}
+	com.alltoall(&sendSizes.front(), 1, PCL_DT_INT, &recvSizes.front(), 1, PCL_DT_INT);
+
+	vector<int> sendToRanks, sendSegSizes, recvFromRanks, recvSegSizes;
+	size_t totalSendSize = 0, totalRecvSize = 0;
+	for(int i = 0; i < numProcs; ++i){
+		if(sendSizes[i] > 0){
+			sendToRanks.push_back(i);
+			sendSegSizes.push_back(sendSizes[i]);
+			totalSendSize += sendSizes[i];
+		}
+		if(recvSizes[i] > 0){
+			recvFromRanks.push_back(i);
+			recvSegSizes.push_back(recvSizes[i]);
+			totalRecvSize += recvSizes[i];
+		}
+	}
+
+	vector<T> sendBuf;
+	sendBuf.reserve(totalSendSize / sizeof(T));
+	for(size_t i = 0; i < sendToRanks.size(); ++i){
+		vector<T>& v = sendVecs[sendToRanks[i]];
+		sendBuf.insert(sendBuf.end(), v.begin(), v.end());
+	}
+
+	const size_t numLocal = sendVecs[localProc].size();
+	recvOut.resize(numLocal + totalRecvSize / sizeof(T));
+	if(numLocal > 0)
+		copy(sendVecs[localProc].begin(), sendVecs[localProc].end(), recvOut.begin());
+
+	com.distribute_data(recvOut.empty() ? NULL : &recvOut[numLocal],
+						recvSegSizes.empty() ? NULL : &recvSegSizes.front(),
+						recvFromRanks.empty() ? NULL : &recvFromRanks.front(),
+						(int)recvFromRanks.size(),
+						sendBuf.empty() ? NULL : &sendBuf.front(),
+						sendSegSizes.empty() ? NULL : &sendSegSizes.front(),
+						sendToRanks.empty() ? NULL : &sendToRanks.front(),
+						(int)sendToRanks.size());
+}
+
+///	reads the partition map of the file for the given slice
+/**	Returns false on all processes if the file contains no partition map or
+ * if any entry is not a valid process index in procComm.*/
+bool ReadPartitionMap(GridReaderUGB& reader, const pcl::ProcessCommunicator& procComm,
+					  size_t sliceBegin, size_t sliceEnd, vector<int>& targetsOut)
+{
+	if(!reader.has_partition_map())
+		return false;
+
+	const int numProcs = (int)procComm.size();
+	targetsOut.resize(sliceEnd - sliceBegin);
+	if(!targetsOut.empty()){
+		reader.read_records(GridReaderUGB::PARTITION_MAP, sliceBegin,
+							targetsOut.size(), &targetsOut.front());
+	}
+
+	int valid = 1;
+	for(size_t i = 0; i < targetsOut.size(); ++i){
+		if(targetsOut[i] < 0 || targetsOut[i] >= numProcs){
+			valid = 0;
+			break;
+		}
+	}
+
+	if(!procComm.allreduce(valid, PCL_RO_MIN)){
+		UG_LOG("LoadDistributedGridFromUGB: The partition map of the file doesn't "
+			   "match the number of processes. Elements are partitioned along a "
+			   "space filling curve instead.\n");
+		return false;
+	}
+	return true;
+}
+
+///	finds numProcs - 1 keys, which split the global key set into pieces of equal size
+/**	Performs a bisection on the key space for all splitters at once. Each step
+ * requires one reduction of numProcs - 1 counters.*/
+void FindSplitters(const pcl::ProcessCommunicator& procComm,
+				   const vector<uint64>& sortedKeys, size_t numElems,
+				   vector<uint64>& splittersOut)
+{
+	const size_t numProcs = procComm.size();
+	const size_t numSplitters = numProcs - 1;
+
+	uint64 maxKey = sortedKeys.empty() ? 0 : sortedKeys.back();
+	maxKey = procComm.allreduce(maxKey, PCL_RO_MAX);
+
+	vector<uint64> lo(numSplitters, 0), hi(numSplitters, maxKey);
+	vector<uint64> mid(numSplitters), localCounts(numSplitters), globalCounts;
+
+	while(true){
+		bool done = true;
+		for(size_t i = 0; i < numSplitters; ++i){
+			mid[i] = lo[i] + (hi[i] - lo[i]) / 2;
+			localCounts[i] = upper_bound(sortedKeys.begin(), sortedKeys.end(), mid[i])
+							 - sortedKeys.begin();
+			if(lo[i] < hi[i])
+				done = false;
+		}
+
+	//	lo and hi are the same on all processes
+		if(done)
+			break;
+
+		procComm.allreduce(localCounts, globalCounts, PCL_RO_SUM);
+
+		for(size_t i = 0; i < numSplitters; ++i){
+			if(lo[i] == hi[i])
+				continue;
+			const uint64 target = (uint64)numElems * (i + 1) / numProcs;
+			if(globalCounts[i] >= target)
+				hi[i] = mid[i];
+			else
+				lo[i] = mid[i] + 1;
+		}
+	}
+
+	splittersOut.swap(lo);
+}
+
+///	assigns the elements of the given slice to processes along a Morton curve
+template <class vector_t>
+void PartitionAlongSFC(GridReaderUGB& reader, const pcl::ProcessCommunicator& procComm,
+					   size_t sliceBegin, size_t sliceEnd, vector<int>& targetsOut)
+{
+	const size_t numElems = reader.num_elements();
+	const size_t num = sliceEnd - sliceBegin;
+	const int posDim = reader.position_dimension();
+	const int dim = min<int>(posDim, vector_t::Size);
+
+//	read corners and coordinates of the slice
+	vector<uint64> corners;
+	const size_t numCorners = reader.read_element_corners(sliceBegin, num, corners);
+
+	vector<size_t> vrtInds;
+	vrtInds.reserve(corners.size());
+	for(size_t i = 0; i < corners.size(); ++i){
+		if(corners[i] != UGB_INVALID_INDEX)
+			vrtInds.push_back((size_t)corners[i]);
+	}
+	sort(vrtInds.begin(), vrtInds.end());
+	vrtInds.erase(unique(vrtInds.begin(), vrtInds.end()), vrtInds.end());
+
+	vector<double> coords;
+	reader.read_coordinates(vrtInds, coords);
+
+//	element centers and their bounding box
+	vector<vector_t> centers(num);
+	vector<double> boxMin(vector_t::Size, numeric_limits<double>::max());
+	vector<double> boxMax(vector_t::Size, -numeric_limits<double>::max());
+	for(size_t i = 0; i < num; ++i){
+		vector_t& c = centers[i];
+		c = 0;
+		size_t numValid = 0;
+		for(size_t j = 0; j < numCorners; ++j){
+			const uint64 vrtInd = corners[i * numCorners + j];
+			if(vrtInd == UGB_INVALID_INDEX)
+				continue;
+			const size_t lind = lower_bound(vrtInds.begin(), vrtInds.end(),
+											(size_t)vrtInd) - vrtInds.begin();
+			for(int k = 0; k < dim; ++k)
+				c[k] += coords[lind * posDim + k];
+			++numValid;
+		}
+		if(numValid > 0)
+			c *= 1. / (number)numValid;
+
+		for(size_t k = 0; k < vector_t::Size; ++k){
+			boxMin[k] = min<double>(boxMin[k], c[k]);
+			boxMax[k] = max<double>(boxMax[k], c[k]);
+		}
+	}
+	corners.clear();
+	coords.clear();
+
+	vector<double> gBoxMin, gBoxMax;
+	procComm.allreduce(boxMin, gBoxMin, PCL_RO_MIN);
+	procComm.allreduce(boxMax, gBoxMax, PCL_RO_MAX);
+	vector_t vBoxMin, vBoxMax;
+	for(size_t k = 0; k < vector_t::Size; ++k){
+		vBoxMin[k] = gBoxMin[k];
+		vBoxMax[k] = gBoxMax[k];
+	}
+
+	vector<uint64> keys(num);
+	for(size_t i = 0; i < num; ++i)
+		keys[i] = SFCIndex(SFC_MORTON, centers[i], vBoxMin, vBoxMax);
+
+	vector<uint64> sortedKeys = keys;
+	sort(sortedKeys.begin(), sortedKeys.end());
+
+	vector<uint64> splitters;
+	FindSplitters(procComm, sortedKeys, numElems, splitters);
+
+//	an element with key k is assigned to the first process i with k <= splitters[i]
+	targetsOut.resize(num);
+	for(size_t i = 0; i < num; ++i){
+		targetsOut[i] = (int)(lower_bound(splitters.begin(), splitters.end(), keys[i])
+							  - splitters.begin());
+	}
+}
+
+
+///	marks the given element and all elements in its closure
+void MarkClosure(Grid& g, Vertex* v)
+{
+	g.mark(v);
+}
+
+void MarkClosure(Grid& g, Edge* e)
+{
+	g.mark(e);
+	g.mark(e->vertices(), e->vertices() + e->num_vertices());
+}
+
+void MarkClosure(Grid& g, Face* f)
+{
+	g.mark(f);
+	g.mark(f->vertices(), f->vertices() + f->num_vertices());
+	Grid::edge_traits::secure_container edges;
+	g.associated_elements(edges, f);
+	for(size_t i = 0; i < edges.size(); ++i)
+		g.mark(edges[i]);
+}
+
+///	marks all elements of type TElem, which aren't contained in an element of type TTopElem
+template <class TElem, class TTopElem>
+void MarkFreeElements(Grid& g)
+{
+	typedef typename Grid::traits<TElem>::iterator	iter_t;
+	typename Grid::traits<TTopElem>::secure_container	topElems;
+
+	for(iter_t iter = g.begin<TElem>(); iter != g.end<TElem>(); ++iter){
+		if(g.is_marked(*iter))
+			continue;
+		g.associated_elements(topElems, *iter);
+		if(topElems.size() == 0)
+			MarkClosure(g, *iter);
+	}
+}
+
+///	marks all elements which may be shared with other processes
+/**	Those are the elements in the closure of sides of TElem, which are
+ * adjacent to less than two local elements, and the elements which are not
+ * contained in any element of type TElem.*/
+template <class TElem>
+void MarkPotentialInterfaceElements(Grid& g)
+{
+	typedef typename TElem::side	TSide;
+	typedef typename Grid::traits<TSide>::iterator	iter_t;
+	typename Grid::traits<TElem>::secure_container	elems;
+
+	for(iter_t iter = g.begin<TSide>(); iter != g.end<TSide>(); ++iter){
+		g.associated_elements(elems, *iter);
+		if(elems.size() < 2)
+			MarkClosure(g, *iter);
+	}
+
+	if(TElem::dim > 1)
+		MarkFreeElements<Vertex, TElem>(g);
+	if(TElem::dim > 2)
+		MarkFreeElements<Edge, TElem>(g);
+}
+
+///	computes the key of the given element from the file indices of its corners
+void ComputeKey(EntityKey& keyOut, Vertex* v,
+				Grid::VertexAttachmentAccessor<AFileIndex>& aaFileInd)
+{
+	keyOut.inds[0] = aaFileInd[v];
+}
+
+template <class TElem>
+void ComputeKey(EntityKey& keyOut, TElem* e,
+				Grid::VertexAttachmentAccessor<AFileIndex>& aaFileInd)
+{
+	const size_t numVrts = e->num_vertices();
+	UG_COND_THROW(numVrts > NUM_KEY_ENTRIES,
+				  "LoadDistributedGridFromUGB: Sides with more than "
+				  << NUM_KEY_ENTRIES << " corners are not supported.");
+	Vertex* const* vrts = e->vertices();
+	for(size_t i = 0; i < numVrts; ++i)
+		keyOut.inds[i] = aaFileInd[vrts[i]];
+	sort(keyOut.inds, keyOut.inds + numVrts);
+}
+
+template <class TElem>
+void CollectMarkedEntities(Grid& g, Grid::VertexAttachmentAccessor<AFileIndex>& aaFileInd,
+						   vector<LocalEntity>& entitiesOut)
+{
+	typedef typename Grid::traits<TElem>::iterator	iter_t;
+	for(iter_t iter = g.begin<TElem>(); iter != g.end<TElem>(); ++iter){
+		TElem* e = *iter;
+		if(!g.is_marked(e))
+			continue;
+
+		LocalEntity le;
+		le.obj = e;
+		for(size_t i = 0; i < NUM_KEY_ENTRIES; ++i)
+			le.key.inds[i] = UGB_INVALID_INDEX;
+		ComputeKey(le.key, e, aaFileInd);
+		entitiesOut.push_back(le);
+	}
+}
+
+template <class TElem>
+void AddToInterface(GridLayoutMap& glm, int interfaceType, int proc, GridObject* obj)
+{
+	glm.get_layout<TElem>(interfaceType).interface(proc, 0).push_back(static_cast<TElem*>(obj));
+}
+
+///	creates horizontal interfaces for all entities which are shared between processes
+template <class TElem>
+void CreateHorizontalInterfaces(MultiGrid& mg, GridLayoutMap& glm,
+								Grid::VertexAttachmentAccessor<AFileIndex>& aaFileInd,
+								size_t numFileVrts,
+								const pcl::ProcessCommunicator& procComm)
+{
+	const size_t numProcs = procComm.size();
+	const uint64 localProc = procComm.get_local_proc_id();
+
+//	collect entities on the boundary of the local elements
+	vector<LocalEntity> entities;
+	mg.begin_marking();
+	MarkPotentialInterfaceElements<TElem>(mg);
+	CollectMarkedEntities<Vertex>(mg, aaFileInd, entities);
+	if(TElem::dim > 1)
+		CollectMarkedEntities<Edge>(mg, aaFileInd, entities);
+	if(TElem::dim > 2)
+		CollectMarkedEntities<Face>(mg, aaFileInd, entities);
+	mg.end_marking();
+	sort(entities.begin(), entities.end());
+
+//	send the keys to their home processes. The home process of a key is
+//	determined by the smallest vertex index in that key.
+	vector<vector<KeyRecord> > sendVecs(numProcs);
+	for(size_t i = 0; i < entities.size(); ++i){
+		KeyRecord r;
+		r.key = entities[i].key;
+		r.proc = localProc;
+		const size_t home = (size_t)(r.key.inds[0] * numProcs / numFileVrts);
+		sendVecs[home].push_back(r);
+	}
+
+	vector<KeyRecord> homeRecords;
+	ExchangeRecords(procComm, sendVecs, homeRecords);
+	sort(homeRecords.begin(), homeRecords.end());
+
+//	the process with the lowest rank holds the master copy. It is informed
+//	about all slaves, while slaves are only informed about the master.
+	for(size_t i = 0; i < numProcs; ++i)
+		sendVecs[i].clear();
+
+	size_t runBegin = 0;
+	while(runBegin < homeRecords.size()){
+		size_t runEnd = runBegin + 1;
+		while(runEnd < homeRecords.size()
+			  && homeRecords[runEnd].key == homeRecords[runBegin].key)
+			++runEnd;
+
+		const uint64 masterProc = homeRecords[runBegin].proc;
+		for(size_t i = runBegin + 1; i < runEnd; ++i){
+			KeyRecord r = homeRecords[i];
+			sendVecs[(size_t)masterProc].push_back(r);
+			r.proc = masterProc;
+			sendVecs[(size_t)homeRecords[i].proc].push_back(r);
+		}
+		runBegin = runEnd;
+	}
+	homeRecords.clear();
+
+	vector<KeyRecord> partners;
+	ExchangeRecords(procComm, sendVecs, partners);
+	sendVecs.clear();
+
+//	both sides of an interface sort their entries by key
+	vector<InterfaceEntry> ientries(partners.size());
+	for(size_t i = 0; i < partners.size(); ++i){
+		LocalEntity le;
+		le.key = partners[i].key;
+		vector<LocalEntity>::iterator iter = lower_bound(entities.begin(), entities.end(), le);
+		UG_COND_THROW(iter == entities.end() || !(iter->key == le.key),
+					  "LoadDistributedGridFromUGB: Received unknown interface entity.");
+		ientries[i].proc = partners[i].proc;
+		ientries[i].key = le.key;
+		ientries[i].obj = iter->obj;
+	}
+	sort(ientries.begin(), ientries.end());
+
+	for(size_t i = 0; i < ientries.size(); ++i){
+		const InterfaceEntry& ie = ientries[i];
+		const int intfcType = (ie.proc < localProc) ? INT_H_SLAVE : INT_H_MASTER;
+		const int proc = procComm.get_proc_id((size_t)ie.proc);
+		switch(ie.obj->base_object_id()){
+			case VERTEX:	AddToInterface<Vertex>(glm, intfcType, proc, ie.obj); break;
+			case EDGE:		AddToInterface<Edge>(glm, intfcType, proc, ie.obj); break;
+			case FACE:		AddToInterface<Face>(glm, intfcType, proc, ie.obj); break;
+			default:		break;
+		}
+	}
+}
+
+}//	end of unnamed namespace
+
+
+template <class TAPosition>
+void LoadDistributedGridFromUGB(MultiGrid& mg, ISubsetHandler* psh,
+								const char* filename, TAPosition& aPos,
+								const pcl::ProcessCommunicator& procComm)
+{
+	PROFILE_FUNC_GROUP("grid");
+	typedef typename TAPosition::ValueType	vector_t;
+
+	DistributedGridManager* distGridMgr = mg.distributed_grid_manager();
+	UG_COND_THROW(!distGridMgr, "LoadDistributedGridFromUGB: "
+				  "A distributed grid manager is required in the given grid.");
+	UG_COND_THROW(mg.num_vertices() > 0, "LoadDistributedGridFromUGB: "
+				  "The given grid has to be empty.");
+
+	GridReaderUGB reader;
+	UG_COND_THROW(!reader.open(filename), "LoadDistributedGridFromUGB: "
+				  "Couldn't open file " << filename);
+
+	const size_t numProcs = procComm.size();
+	const size_t localProc = (size_t)procComm.get_local_proc_id();
+	const size_t numElems = reader.num_elements();
+	const size_t sliceBegin = SliceBegin(numElems, numProcs, localProc);
+	const size_t sliceEnd = SliceBegin(numElems, numProcs, localProc + 1);
+
+//	assign the elements of the local slice to processes
+	PROFILE_BEGIN_GROUP(ldg_partition, "grid");
+	vector<int> targets;
+	if(!ReadPartitionMap(reader, procComm, sliceBegin, sliceEnd, targets))
+		PartitionAlongSFC<vector_t>(reader, procComm, sliceBegin, sliceEnd, targets);
+	PROFILE_END();
+
+//	send the element indices to their target processes
+	PROFILE_BEGIN_GROUP(ldg_exchange, "grid");
+	vector<vector<uint64> > sendInds(numProcs);
+	for(size_t i = 0; i < targets.size(); ++i)
+		sendInds[targets[i]].push_back(sliceBegin + i);
+	targets.clear();
+
+	vector<uint64> recvInds;
+	ExchangeRecords(procComm, sendInds, recvInds);
+	sendInds.clear();
+	vector<size_t> elemInds(recvInds.begin(), recvInds.end());
+	recvInds.clear();
+	PROFILE_END();
+
+//	load the local elements
+	PROFILE_BEGIN_GROUP(ldg_load, "grid");
+	distGridMgr->enable_interface_management(false);
+	if(!reader.load_elements(mg, psh, aPos, elemInds)){
+		UG_THROW("LoadDistributedGridFromUGB: Couldn't load elements from file "
+				 << filename);
+	}
+	PROFILE_END();
+
+//	create the layouts
+	PROFILE_BEGIN_GROUP(ldg_layouts, "grid");
+	AFileIndex aFileInd;
+	mg.attach_to_vertices(aFileInd);
+	Grid::VertexAttachmentAccessor<AFileIndex> aaFileInd(mg, aFileInd);
+	const vector<Vertex*>& loadedVrts = reader.loaded_vertices();
+	const vector<size_t>& loadedVrtInds = reader.loaded_vertex_indices();
+	for(size_t i = 0; i < loadedVrts.size(); ++i)
+		aaFileInd[loadedVrts[i]] = loadedVrtInds[i];
+
+	GridLayoutMap& glm = distGridMgr->grid_layout_map();
+	glm.clear();
+	const size_t numFileVrts = reader.num_vertices();
+	switch(reader.element_dimension()){
+		case 1:	CreateHorizontalInterfaces<Edge>(mg, glm, aaFileInd, numFileVrts, procComm); break;
+		case 2:	CreateHorizontalInterfaces<Face>(mg, glm, aaFileInd, numFileVrts, procComm); break;
+		case 3:	CreateHorizontalInterfaces<Volume>(mg, glm, aaFileInd, numFileVrts, procComm); break;
+		default: break;
+	}
+	mg.detach_from_vertices(aFileInd);
+
+	glm.remove_empty_interfaces();
+	distGridMgr->enable_interface_management(true);
+	distGridMgr->grid_layouts_changed(false);
+	PROFILE_END();
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//	explicit template instantiations
+template void LoadDistributedGridFromUGB<APosition1>(MultiGrid&, ISubsetHandler*, const char*, APosition1&, const pcl::ProcessCommunicator&);
+template void LoadDistributedGridFromUGB<APosition2>(MultiGrid&, ISubsetHandler*, const char*, APosition2&, const pcl::ProcessCommunicator&);
+template void LoadDistributedGridFromUGB<APosition3>(MultiGrid&, ISubsetHandler*, const char*, APosition3&, const pcl::ProcessCommunicator&);
+
+}//	end of namespace
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG_distributed_loading
+#define __H__UG_distributed_loading
+
+#include "lib_grid/multi_grid.h"
+#include "lib_grid/tools/subset_handler_interface.h"
+#include "pcl/pcl_process_communicator.h"
+
+namespace ug{
+
+///	Loads a ugb file collectively and distributes its elements onto all processes.
+/**	In contrast to loading a grid on one process and distributing it through
+ * DistributeGrid, no process has to hold the whole grid at any time:
+ *
+ * - each process reads a contiguous slice of the elements of highest dimension
+ *   and computes the centers of those elements,
+ * - the elements are assigned to processes by cutting the Morton order of their
+ *   centers into pieces of equal size. The splitters are found by a bisection
+ *   on the key space, which only requires reductions of one value per process.
+ *   If the file contains a partition map whose entries are valid ranks in
+ *   procComm, that map is used instead,
+ * - element indices are exchanged with a single all-to-all step and each
+ *   process loads its elements from the file through GridReaderUGB,
+ * - horizontal interfaces for shared vertices, edges and faces are created by
+ *   sending the keys of entities on the boundary of each local element set to
+ *   a home process, which determines all processes sharing an entity.
+ *
+ * The resulting layouts are the same as those created by DistributeGrid for a
+ * single level without vertical interfaces: the process with the lowest rank
+ * holds the h-master of each shared entity and interface entries are ordered
+ * consistently on both sides.
+ *
+ * mg has to be empty and a distributed grid manager has to be present. All
+ * processes in procComm have to call this method. Valid position attachments
+ * are APosition1, APosition2 and APosition3.*/
+template <class TAPosition>
+void LoadDistributedGridFromUGB(MultiGrid& mg, ISubsetHandler* psh,
+								const char* filename, TAPosition& aPos,
+								const pcl::ProcessCommunicator& procComm =
+													pcl::ProcessCommunicator());
+
+}//	end of namespace
+
+#endif	//__H__UG_distributed_loading
@@ -31,6 +31,8 @@
  */
 
 #include <sstream>
+#include <algorithm>
+#include <limits>
 #include "common/static_assert.h"
 #include "common/util/table.h"
 #include "distribution.h"
@@ -1903,13 +1905,14 @@ bool DistributeGrid(MultiGrid& mg,
 	#endif
 
 ////////////////////////////////
-//	COMMUNICATE INVOLVED PROCESSES
-	GDIST_PROFILE(gdist_CommunicateInvolvedProcs);
-	UG_DLOG(LG_DIST, 2, "dist-DistributeGrid: CommunicateInvolvedProcesses\n");
+//	DETERMINE TARGET PROCESSES
+	GDIST_PROFILE(gdist_DetermineTargetProcs);
+	UG_DLOG(LG_DIST, 2, "dist-DistributeGrid: Determine target processes\n");
 
-//	each process has to know with which other processes it
-//	has to communicate.
-	vector<int> sendToRanks, recvFromRanks, sendPartitionInds;
+//	each process has to know to which other processes it has to send data.
+//	Which processes send data to the local process is determined during the
+//	exchange of the buffer sizes below.
+	vector<int> sendToRanks, sendPartitionInds;
 
 	if(processMap && (shPartition.num_subsets() > (int)processMap->size())){
 		UG_THROW("process-map is too small for the given number of partitions!");
@@ -1917,6 +1920,7 @@ bool DistributeGrid(MultiGrid& mg,
 
 //	for each subset which is not emtpy we'll have to send data to
 //	the associated process.
+	vector<pair<int, int> > targets;
 	for(int si = 0; si < shPartition.num_subsets(); ++si){
 	//	instead of simply querying shPartition.empty(si), we'll check partitionIsEmpty[si],
 	//	since this array tells whether data is actually sent to a partition.
@@ -1928,12 +1932,16 @@ bool DistributeGrid(MultiGrid& mg,
 			if(processMap)
 				toProc = processMap->at(si);
 
-			sendToRanks.push_back(toProc);
-			sendPartitionInds.push_back(si);
+			targets.push_back(make_pair(toProc, si));
 		}
 	}
 
-	pcl::CommunicateInvolvedProcesses(recvFromRanks, sendToRanks, procComm);
+//	packs for the same process have to be adjacent in the send buffer.
+	sort(targets.begin(), targets.end());
+	for(size_t i = 0; i < targets.size(); ++i){
+		sendToRanks.push_back(targets[i].first);
+		sendPartitionInds.push_back(targets[i].second);
+	}
 
 	PCL_DEBUG_BARRIER(procComm);
 	GDIST_PROFILE_END();
@@ -1947,9 +1955,13 @@ bool DistributeGrid(MultiGrid& mg,
 	mg.attach_to_all(aLocalInd);
 	MultiElementAttachmentAccessor<AInt> aaInt(mg, aLocalInd);
 
-//	outBufs will be used to serialize and distribute the grid.
-//	don't resize outBufs later on! Would be expensive!
-	std::vector<BinaryBuffer> outBufs(sendToRanks.size());
+//	All packs are written consecutively into outBuf. sendCounts and sendDispls
+//	describe the segment of outBuf which is sent to each process of procComm,
+//	so that all data can be exchanged through a single alltoallv.
+	const int commSize = procComm.size();
+	BinaryBuffer outBuf;
+	vector<int> sendCounts(commSize, 0);
+	vector<int> sendDispls(commSize, 0);
 
 //	the magic number is used for debugging to make sure that the stream is read correctly
 	int magicNumber1 = 75234587;
@@ -1963,6 +1975,12 @@ bool DistributeGrid(MultiGrid& mg,
 	distInfoSerializer.add(GeomObjAttachmentSerializer<Face, ADistInfo>::create(mg, aDistInfo));
 	distInfoSerializer.add(GeomObjAttachmentSerializer<Volume, ADistInfo>::create(mg, aDistInfo));
 
+//	elements of the current pack in the order in which they are serialized
+	vector<Vertex*>	vrts;
+	vector<Edge*> edges;
+	vector<Face*> faces;
+	vector<Volume*> vols;
+
 //	now perform the serialization
 	int localPartitionInd = -1;
 	for(size_t i_to = 0; i_to < sendPartitionInds.size(); ++i_to){
@@ -1974,10 +1992,15 @@ bool DistributeGrid(MultiGrid& mg,
 	//	don't serialize the local partition since we'll keep it here on the local
 	//	process anyways.
 		if(!localPartition){
-			BinaryBuffer& out = outBufs[i_to];
+			const int commRank = procComm.get_local_proc_id(sendToRanks[i_to]);
+			UG_COND_THROW(commRank < 0, errprefix << "Target process "
+						  << sendToRanks[i_to] << " is not contained in the "
+						  "given process communicator.");
+
+			const size_t packStart = outBuf.write_pos();
 
 		//	write a magic number for debugging purposes
-			out.write((char*)&magicNumber1, sizeof(int));
+			outBuf.write((char*)&magicNumber1, sizeof(int));
 
 		//	select the elements of the current partition
 			msel.clear();
@@ -1985,19 +2008,31 @@ bool DistributeGrid(MultiGrid& mg,
 										 localPartition, createVerticalInterfaces);
 			//AdjustGhostSelection(msel, ISelector::DESELECTED);
 
-			SerializeMultiGridElements(mg, msel.get_grid_objects(), aaInt, out, &aaID);
-
+			GridObjectCollection goc = msel.get_grid_objects();
+			SerializeMultiGridElements(mg, goc, aaInt, outBuf, &aaID);
 
 		//	serialize associated data
-			distInfoSerializer.write_infos(out);
-			distInfoSerializer.serialize(out, msel.get_grid_objects());
-			serializer.write_infos(out);
-			serializer.serialize(out, msel.get_grid_objects());
-			userDataSerializer.write_infos(out);
-			userDataSerializer.serialize(out, msel.get_grid_objects());
+			CollectSerializedElements(vrts, goc);
+			CollectSerializedElements(edges, goc);
+			CollectSerializedElements(faces, goc);
+			CollectSerializedElements(vols, goc);
+
+			distInfoSerializer.write_infos(outBuf);
+			distInfoSerializer.serialize_blocks(outBuf, vrts, edges, faces, vols);
+			serializer.write_infos(outBuf);
+			serializer.serialize_blocks(outBuf, vrts, edges, faces, vols);
+			userDataSerializer.write_infos(outBuf);
+			userDataSerializer.serialize_blocks(outBuf, vrts, edges, faces, vols);
 
 		//	write a magic number for debugging purposes
-			out.write((char*)&magicNumber2, sizeof(int));
+			outBuf.write((char*)&magicNumber2, sizeof(int));
+
+			UG_COND_THROW(outBuf.write_pos() > (size_t)numeric_limits<int>::max(),
+						  errprefix << "Too much data to send (more than 2GB).");
+
+			if(sendCounts[commRank] == 0)
+				sendDispls[commRank] = (int)packStart;
+			sendCounts[commRank] += (int)(outBuf.write_pos() - packStart);
 		}
 	}
 	PCL_DEBUG_BARRIER(procComm);
@@ -2009,17 +2044,30 @@ bool DistributeGrid(MultiGrid& mg,
 //	COMMUNICATE SERIALIZED DATA
 	GDIST_PROFILE(gdist_CommunicateSerializedData);
 	UG_DLOG(LG_DIST, 2, "dist-DistributeGrid: Distribute data\n");
-//	now distribute the packs between involved processes
-	std::vector<BinaryBuffer> inBufs(recvFromRanks.size());
+//	exchange the sizes of all packs first, then the packs themselves.
+	vector<int> recvCounts(commSize, 0);
+	vector<int> recvDispls(commSize, 0);
+	pcl::ProcessCommunicator com = procComm;
+	com.alltoall(GetDataPtr(sendCounts), 1, PCL_DT_INT,
+				 GetDataPtr(recvCounts), 1, PCL_DT_INT);
+
+	size_t totalRecvSize = 0;
+	for(int i = 0; i < commSize; ++i){
+		recvDispls[i] = (int)totalRecvSize;
+		totalRecvSize += recvCounts[i];
+		UG_COND_THROW(totalRecvSize > (size_t)numeric_limits<int>::max(),
+					  errprefix << "Too much data to receive (more than 2GB).");
+	}
 
-	procComm.distribute_data(GetDataPtr(inBufs), GetDataPtr(recvFromRanks),
-							(int)recvFromRanks.size(),
-							GetDataPtr(outBufs), GetDataPtr(sendToRanks),
-							(int)sendToRanks.size());
+	BinaryBuffer inBuf(totalRecvSize);
+	procComm.alltoallv(outBuf.buffer(), GetDataPtr(sendCounts),
+					   GetDataPtr(sendDispls), PCL_DT_BYTE,
+					   inBuf.buffer(), GetDataPtr(recvCounts),
+					   GetDataPtr(recvDispls), PCL_DT_BYTE);
+	inBuf.set_write_pos(totalRecvSize);
 
-//	clear out-buffers, since they are no longer needed
-	for(size_t i = 0; i < outBufs.size(); ++i)
-		outBufs[i] = BinaryBuffer();
+//	clear the out-buffer, since it is no longer needed
+	outBuf = BinaryBuffer();
 
 	PCL_DEBUG_BARRIER(procComm);
 	GDIST_PROFILE_END();
@@ -2217,63 +2265,51 @@ bool DistributeGrid(MultiGrid& mg,
 	serializer.deserialization_starts();
 	userDataSerializer.deserialization_starts();
 
-	vector<Vertex*>	vrts;
-	vector<Edge*> edges;
-	vector<Face*> faces;
-	vector<Volume*> vols;
-
-	for(size_t i = 0; i < recvFromRanks.size(); ++i){
-	//	there is nothing to serialize from the local rank
-		if(recvFromRanks[i] == pcl::ProcRank())
+	for(int commRank = 0; commRank < commSize; ++commRank){
+	//	there is nothing to deserialize from the local rank
+		if(recvCounts[commRank] == 0)
 			continue;
 
-		BinaryBuffer& in = inBufs[i];
+		UG_DLOG(LG_DIST, 2, "Deserializing from rank " << procComm.get_proc_id(commRank) << "\n");
+
+	//	several packs may have been sent by the same process
+		const size_t segEnd = recvDispls[commRank] + recvCounts[commRank];
+		inBuf.set_read_pos(recvDispls[commRank]);
+		while(inBuf.read_pos() < segEnd){
+		//	read the magic number and make sure that it matches our magicNumber
+			int tmp = 0;
+			inBuf.read((char*)&tmp, sizeof(int));
+			if(tmp != magicNumber1){
+				UG_THROW("ERROR in RedistributeGrid: "
+						 "Magic number mismatch before deserialization.\n");
+			}
 
-		UG_DLOG(LG_DIST, 2, "Deserializing from rank " << recvFromRanks[i] << "\n");
+			DeserializeMultiGridElements(mg, inBuf, &vrts, &edges, &faces, &vols, &aaID);
 
-	//	read the magic number and make sure that it matches our magicNumber
-		int tmp = 0;
-		in.read((char*)&tmp, sizeof(int));
-		if(tmp != magicNumber1){
-			UG_THROW("ERROR in RedistributeGrid: "
-					 "Magic number mismatch before deserialization.\n");
-		}
+		//	deserialize the associated data (global ids have already been deserialized)
+			distInfoSerializer.read_infos(inBuf);
+			distInfoSerializer.deserialize_blocks(inBuf, vrts, edges, faces, vols);
+
+			serializer.read_infos(inBuf);
+			serializer.deserialize_blocks(inBuf, vrts, edges, faces, vols);
 
-		DeserializeMultiGridElements(mg, in, &vrts, &edges, &faces, &vols, &aaID);
-
-	//	deserialize the associated data (global ids have already been deserialized)
-		distInfoSerializer.read_infos(in);
-		distInfoSerializer.deserialize(in, vrts.begin(), vrts.end());
-		distInfoSerializer.deserialize(in, edges.begin(), edges.end());
-		distInfoSerializer.deserialize(in, faces.begin(), faces.end());
-		distInfoSerializer.deserialize(in, vols.begin(), vols.end());
-
-		serializer.read_infos(in);
-		serializer.deserialize(in, vrts.begin(), vrts.end());
-		serializer.deserialize(in, edges.begin(), edges.end());
-		serializer.deserialize(in, faces.begin(), faces.end());
-		serializer.deserialize(in, vols.begin(), vols.end());
-
-		userDataSerializer.read_infos(in);
-		userDataSerializer.deserialize(in, vrts.begin(), vrts.end());
-		userDataSerializer.deserialize(in, edges.begin(), edges.end());
-		userDataSerializer.deserialize(in, faces.begin(), faces.end());
-		userDataSerializer.deserialize(in, vols.begin(), vols.end());
-
-	//	read the magic number and make sure that it matches our magicNumber
-		tmp = 0;
-		in.read((char*)&tmp, sizeof(int));
-		if(tmp != magicNumber2){
-			UG_THROW("ERROR in RedistributeGrid: "
-					 "Magic number mismatch after deserialization.\n");
+			userDataSerializer.read_infos(inBuf);
+			userDataSerializer.deserialize_blocks(inBuf, vrts, edges, faces, vols);
+
+		//	read the magic number and make sure that it matches our magicNumber
+			tmp = 0;
+			inBuf.read((char*)&tmp, sizeof(int));
+			if(tmp != magicNumber2){
+				UG_THROW("ERROR in RedistributeGrid: "
+						 "Magic number mismatch after deserialization.\n");
+			}
 		}
 
-		UG_DLOG(LG_DIST, 2, "Deserialization from rank " << recvFromRanks[i] << " done\n");
+		UG_DLOG(LG_DIST, 2, "Deserialization from rank " << procComm.get_proc_id(commRank) << " done\n");
 	}
 
-	//	clear in-buffers, since they are no longer needed
-	for(size_t i = 0; i < inBufs.size(); ++i)
-		inBufs[i] = BinaryBuffer();
+//	clear the in-buffer, since it is no longer needed
+	inBuf = BinaryBuffer();
 
 	PCL_DEBUG_BARRIER(procComm);
 	GDIST_PROFILE_END();
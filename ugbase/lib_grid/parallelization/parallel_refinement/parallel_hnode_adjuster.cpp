@@ -34,11 +34,18 @@
 #include "lib_grid/parallelization/distributed_grid.h"
 #include "lib_grid/algorithms/debug_util.h"
 #include "common/error.h"
+#include <algorithm>
 
 namespace ug{
 
+///	Communicates the refinement marks of newly marked interface elements only.
+/**	Instead of sending the mark of each interface element, the policy only sends
+ * (interface-index, mark) pairs for those elements which were handed to it
+ * through add_delta, followed by a terminating -1. Elements whose marks are
+ * raised during extract are added to the delta, so that a subsequent
+ * MASTER -> SLAVE communication forwards them to the remaining copies.*/
 template <class TLayout>
-class ComPol_BroadcastRefineMarks : public pcl::ICommunicationPolicy<TLayout>
+class ComPol_BroadcastRefineMarkDeltas : public pcl::ICommunicationPolicy<TLayout>
 {
 	public:
 		typedef TLayout								Layout;
@@ -47,28 +54,57 @@ class ComPol_BroadcastRefineMarks : public pcl::ICommunicationPolicy<TLayout>
 		typedef typename Layout::Interface			Interface;
 		typedef typename Interface::const_iterator	InterfaceIter;
 
-		ComPol_BroadcastRefineMarks(IRefiner& ref, byte consideredMarks)
-			 :	m_ref(ref), m_consideredMarks(consideredMarks)
+		ComPol_BroadcastRefineMarkDeltas(IRefiner& ref, byte consideredMarks,
+										 DistributedGridManager& distGridMgr)
+			 :	m_ref(ref), m_consideredMarks(consideredMarks),
+				m_distGridMgr(distGridMgr), m_deltaSorted(true)
 		{}
 
-		virtual ~ComPol_BroadcastRefineMarks()	{}
+		virtual ~ComPol_BroadcastRefineMarkDeltas()	{}
+
+	///	adds those elements of the given vector which are interface elements
+		template <class TElem>
+		void add_delta(const std::vector<TElem*>& elems)
+		{
+			for(size_t i = 0; i < elems.size(); ++i){
+				if(m_distGridMgr.is_interface_element(elems[i])){
+					m_delta.push_back(elems[i]);
+					m_deltaSorted = false;
+				}
+			}
+		}
+
+		bool delta_empty() const	{return m_delta.empty();}
+
 		virtual int
 		get_required_buffer_size(const Interface& interface)
-		{return interface.size() * sizeof(byte);}
+		{return -1;}
 
-	///	writes writes the selection states of the interface entries
+	///	writes the interface indices and marks of newly marked interface entries
 		virtual bool
 		collect(ug::BinaryBuffer& buff, const Interface& interface)
 		{
-		//	write the entry indices of marked elements.
-			for(InterfaceIter iter = interface.begin();
-				iter != interface.end(); ++iter)
-			{
-				Element elem = interface.get_element(iter);
-				byte refMark = m_ref.get_mark(elem);
-				buff.write((char*)&refMark, sizeof(byte));
+			sort_delta();
+
+			if(!m_delta.empty()){
+				int index = 0;
+				for(InterfaceIter iter = interface.begin();
+					iter != interface.end(); ++iter, ++index)
+				{
+					Element elem = interface.get_element(iter);
+					if(!std::binary_search(m_delta.begin(), m_delta.end(), elem))
+						continue;
+
+					byte refMark = m_ref.get_mark(elem) & m_consideredMarks;
+					if(refMark){
+						buff.write((char*)&index, sizeof(int));
+						buff.write((char*)&refMark, sizeof(byte));
+					}
+				}
 			}
 
+			int terminator = -1;
+			buff.write((char*)&terminator, sizeof(int));
 			return true;
 		}
 
@@ -76,13 +112,26 @@ class ComPol_BroadcastRefineMarks : public pcl::ICommunicationPolicy<TLayout>
 		virtual bool
 		extract(ug::BinaryBuffer& buff, const Interface& interface)
 		{
+			InterfaceIter iter = interface.begin();
+			int curIndex = 0;
+			int index;
 			byte val;
-			for(InterfaceIter iter = interface.begin();
-				iter != interface.end(); ++iter)
-			{
-				Element elem = interface.get_element(iter);
+
+			while(1){
+				buff.read((char*)&index, sizeof(int));
+				if(index < 0)
+					break;
 				buff.read((char*)&val, sizeof(byte));
 
+				UG_COND_THROW(index < curIndex,
+							  "Interface indices have to be received in ascending order.");
+				for(; curIndex < index && iter != interface.end(); ++curIndex)
+					++iter;
+				UG_COND_THROW(iter == interface.end(),
+							  "Received interface index " << index << " exceeds "
+							  "interface size " << interface.size());
+
+				Element elem = interface.get_element(iter);
 				val &= m_consideredMarks;
 
 			//	check the current status and adjust the mark accordingly
@@ -97,13 +146,30 @@ class ComPol_BroadcastRefineMarks : public pcl::ICommunicationPolicy<TLayout>
 						m_ref.mark(elem, RM_ANISOTROPIC);
 					if(val & RM_REFINE)
 						m_ref.mark(elem, RM_REFINE);
+
+					m_delta.push_back(elem);
+					m_deltaSorted = false;
 				}
 			}
 			return true;
 		}
 
-		IRefiner& m_ref;
-		byte m_consideredMarks;
+	private:
+		void sort_delta()
+		{
+			if(!m_deltaSorted){
+				std::sort(m_delta.begin(), m_delta.end());
+				m_delta.erase(std::unique(m_delta.begin(), m_delta.end()),
+							  m_delta.end());
+				m_deltaSorted = true;
+			}
+		}
+
+		IRefiner&				m_ref;
+		byte					m_consideredMarks;
+		DistributedGridManager&	m_distGridMgr;
+		std::vector<Element>	m_delta;
+		bool					m_deltaSorted;
 };
 
 
@@ -143,25 +209,28 @@ ref_marks_changed(IRefiner& ref,
 	DistributedGridManager& distGridMgr = *grid.distributed_grid_manager();
 	GridLayoutMap& layoutMap = distGridMgr.grid_layout_map();
 
-//	check whether new interface elements have been selected
-	bool newInterfaceVrtsMarked = ContainsInterfaceElem(vrts, distGridMgr);
-	bool newInterfaceEdgeMarked = ContainsInterfaceElem(edges, distGridMgr);
-	bool newInterfaceFacesMarked = ContainsInterfaceElem(faces, distGridMgr);
-	bool newInterfaceVolsMarked = ContainsInterfaceElem(vols, distGridMgr);
-
-	bool newlyMarkedElems = newInterfaceVrtsMarked ||
-							newInterfaceEdgeMarked ||
-							newInterfaceFacesMarked ||
-							newInterfaceVolsMarked;
+//	only newly marked interface elements are communicated. Those are collected
+//	in the communication policies.
+	const byte consideredMarks = RM_REFINE | RM_ANISOTROPIC;
+	ComPol_BroadcastRefineMarkDeltas<VertexLayout>
+		compolRefVRT(ref, consideredMarks, distGridMgr);
+	ComPol_BroadcastRefineMarkDeltas<EdgeLayout>
+		compolRefEDGE(ref, consideredMarks, distGridMgr);
+	ComPol_BroadcastRefineMarkDeltas<FaceLayout>
+		compolRefFACE(ref, consideredMarks, distGridMgr);
+
+	compolRefVRT.add_delta(vrts);
+	compolRefEDGE.add_delta(edges);
+	compolRefFACE.add_delta(faces);
+
+	bool newlyMarkedElems = !compolRefVRT.delta_empty() ||
+							!compolRefEDGE.delta_empty() ||
+							!compolRefFACE.delta_empty() ||
+							ContainsInterfaceElem(vols, distGridMgr);
 
 	bool exchangeFlag = pcl::OneProcTrue(newlyMarkedElems);
 
 	if(exchangeFlag){
-		const byte consideredMarks = RM_REFINE | RM_ANISOTROPIC;
-		ComPol_BroadcastRefineMarks<VertexLayout> compolRefVRT(ref, consideredMarks);
-		ComPol_BroadcastRefineMarks<EdgeLayout> compolRefEDGE(ref, consideredMarks);
-		ComPol_BroadcastRefineMarks<FaceLayout> compolRefFACE(ref, consideredMarks);
-
 	//	send data SLAVE -> MASTER
 		m_intfComVRT.exchange_data(layoutMap, INT_H_SLAVE, INT_H_MASTER,
 									compolRefVRT);
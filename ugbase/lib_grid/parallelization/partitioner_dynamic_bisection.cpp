@@ -31,6 +31,7 @@
  */
 
 #include "partitioner_dynamic_bisection.h"
+#include "partitioner_hierarchical.h"
 #include "load_balancer_util.h"
 #include "distributed_grid.h"
 #include "lib_grid/parallelization/util/compol_copy_attachment.h"
@@ -354,7 +355,7 @@ partition(size_t baseLvl, size_t elementThreshold)
 		perform_bisection(numPartitions, minLvl, maxLvl, partitionLvl, aWeight, com);
 
 		for(int i = minLvl; i < maxLvl; ++i){
-			copy_partitions_to_children(sh, i);
+			CopyPartitionsToChildren<elem_t>(mg, sh, i, m_intfcCom);
 		}
 
 		if(static_partitioning_enabled()){
@@ -525,7 +526,7 @@ perform_bisection(int numTargetProcs, int minLvl, int maxLvl, int partitionLvl,
 
 	//	copy subset indices from partition-level to minLvl
 		for(int i = partitionLvl; i < minLvl; ++i){
-			copy_partitions_to_children(sh, i);
+			CopyPartitionsToChildren<elem_t>(mg, sh, i, m_intfcCom);
 		}
 
 	//	reset partitions in the specified partition-level
@@ -900,41 +901,6 @@ get_next_split_axis(int lastAxis) const
 }
 
 
-template <class TElem, int dim>
-void Partitioner_DynamicBisection<TElem, dim>::
-copy_partitions_to_children(ISubsetHandler& partitionSH, int lvl)
-{
-	GDIST_PROFILE_FUNC();
-	typedef typename Grid::traits<elem_t>::iterator ElemIter;
-	MultiGrid& mg = *m_mg;
-
-//	assign partitions to all children in this hierarchy level
-	for(ElemIter iter = mg.begin<elem_t>(lvl); iter != mg.end<elem_t>(lvl); ++iter)
-	{
-		size_t numChildren = mg.num_children<elem_t>(*iter);
-		int si = partitionSH.get_subset_index(*iter);
-		for(size_t i = 0; i < numChildren; ++i)
-			partitionSH.assign_subset(mg.get_child<elem_t>(*iter, i), si);
-	}
-
-	if(mg.is_parallel()){
-		GridLayoutMap& glm = mg.distributed_grid_manager()->grid_layout_map();
-	//	communicate partitions from v-masters to v-slaves, since v-slaves
-	//	havn't got no parents on their procs.
-		ComPol_Subset<layout_t>	compolSHCopy(partitionSH, true);
-		if(glm.has_layout<elem_t>(INT_V_MASTER)){
-			m_intfcCom.send_data(glm.get_layout<elem_t>(INT_V_MASTER).layout_on_level(lvl+1),
-								 compolSHCopy);
-		}
-		if(glm.has_layout<elem_t>(INT_V_SLAVE)){
-			m_intfcCom.receive_data(glm.get_layout<elem_t>(INT_V_SLAVE).layout_on_level(lvl+1),
-									compolSHCopy);
-		}
-		m_intfcCom.communicate();
-	}
-}
-
-
 template <class TElem, int dim>
 void Partitioner_DynamicBisection<TElem, dim>::
 gather_weights_from_level(int baseLvl, int childLvl, ANumber aWeight,
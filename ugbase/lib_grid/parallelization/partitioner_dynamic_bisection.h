@@ -235,8 +235,6 @@ class Partitioner_DynamicBisection : public IPartitioner{
 		int get_next_split_axis(int lastAxis) const;
 
 
-		void copy_partitions_to_children(ISubsetHandler& partitionSH, int lvl);
-
 		void calculate_global_dimensions(std::vector<TreeNode>& treeNodes,
 										 number maxChildWeight, ANumber aWeight,
 										 pcl::ProcessCommunicator& com);
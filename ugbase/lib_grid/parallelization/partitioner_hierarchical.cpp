@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+
+#include "partitioner_hierarchical.h"
+#include "distributed_grid.h"
+#include "parallelization_util.h"
+#include "lib_grid/parallelization/util/compol_copy_attachment.h"
+#include "lib_grid/parallelization/util/compol_subset.h"
+
+using namespace std;
+
+namespace ug{
+
+template <class TElem>
+void CopyPartitionsToChildren(
+		MultiGrid& mg,
+		ISubsetHandler& partitionSH,
+		int lvl,
+		pcl::InterfaceCommunicator<typename GridLayoutMap::Types<TElem>::Layout::LevelLayout>& intfcCom)
+{
+	GDIST_PROFILE_FUNC();
+	typedef typename Grid::traits<TElem>::iterator ElemIter;
+	typedef typename GridLayoutMap::Types<TElem>::Layout::LevelLayout layout_t;
+
+//	assign partitions to all children in this hierarchy level
+	for(ElemIter iter = mg.begin<TElem>(lvl); iter != mg.end<TElem>(lvl); ++iter)
+	{
+		size_t numChildren = mg.num_children<TElem>(*iter);
+		int si = partitionSH.get_subset_index(*iter);
+		for(size_t i = 0; i < numChildren; ++i)
+			partitionSH.assign_subset(mg.get_child<TElem>(*iter, i), si);
+	}
+
+	if(mg.is_parallel()){
+		GridLayoutMap& glm = mg.distributed_grid_manager()->grid_layout_map();
+	//	communicate partitions from v-masters to v-slaves, since v-slaves
+	//	havn't got no parents on their procs.
+		ComPol_Subset<layout_t>	compolSHCopy(partitionSH, true);
+		if(glm.has_layout<TElem>(INT_V_MASTER)){
+			intfcCom.send_data(glm.get_layout<TElem>(INT_V_MASTER).layout_on_level(lvl+1),
+							   compolSHCopy);
+		}
+		if(glm.has_layout<TElem>(INT_V_SLAVE)){
+			intfcCom.receive_data(glm.get_layout<TElem>(INT_V_SLAVE).layout_on_level(lvl+1),
+								  compolSHCopy);
+		}
+		intfcCom.communicate();
+	}
+}
+
+
+template <class TElem>
+Partitioner_Hierarchical<TElem>::
+Partitioner_Hierarchical() :
+	m_mg(NULL)
+{
+	m_processHierarchy = SPProcessHierarchy(new ProcessHierarchy);
+	m_processHierarchy->add_hierarchy_level(0, 1);
+
+	m_balanceWeights = make_sp(new IBalanceWeights());
+}
+
+template <class TElem>
+Partitioner_Hierarchical<TElem>::
+~Partitioner_Hierarchical()
+{
+}
+
+////////////////////////////////
+//	SETTERS AND GETTERS
+////////////////////////////////
+template <class TElem>
+void Partitioner_Hierarchical<TElem>::
+set_next_process_hierarchy(SPProcessHierarchy procHierarchy)
+{
+	m_nextProcessHierarchy = procHierarchy;
+}
+
+template <class TElem>
+void Partitioner_Hierarchical<TElem>::
+set_balance_weights(SPBalanceWeights balanceWeights)
+{
+	m_balanceWeights = balanceWeights;
+}
+
+template <class TElem>
+void Partitioner_Hierarchical<TElem>::
+set_partition_pre_processor(SPPartitionPreProcessor ppp)
+{
+	m_partitionPreProcessor = ppp;
+}
+
+template <class TElem>
+void Partitioner_Hierarchical<TElem>::
+set_partition_post_processor(SPPartitionPostProcessor ppp)
+{
+	m_partitionPostProcessor = ppp;
+}
+
+template <class TElem>
+ConstSPProcessHierarchy Partitioner_Hierarchical<TElem>::
+current_process_hierarchy() const
+{
+	return m_processHierarchy;
+}
+
+template <class TElem>
+ConstSPProcessHierarchy Partitioner_Hierarchical<TElem>::
+next_process_hierarchy() const
+{
+	return m_nextProcessHierarchy;
+}
+
+template <class TElem>
+SubsetHandler& Partitioner_Hierarchical<TElem>::
+get_partitions()
+{
+	if(m_sh.invalid()){
+		if(m_mg)
+			m_sh = make_sp(new SubsetHandler(*m_mg));
+		else
+			m_sh = make_sp(new SubsetHandler());
+	}
+	return *m_sh;
+}
+
+
+////////////////////////////////
+//	PARTITIONING
+////////////////////////////////
+template <class TElem>
+bool Partitioner_Hierarchical<TElem>::
+partition(size_t baseLvl, size_t elementThreshold)
+{
+	GDIST_PROFILE_FUNC();
+
+	UG_COND_THROW(m_mg == NULL,
+			"No grid was specified for the partitioner. "
+			"partitioning can't be executed without a specified grid.");
+
+	if(m_balanceWeights.invalid())
+		m_balanceWeights = make_sp(new IBalanceWeights());
+
+	MultiGrid& mg = *m_mg;
+	if(m_sh.invalid())
+		m_sh = make_sp(new SubsetHandler(mg));
+	SubsetHandler& sh = *m_sh;
+	sh.clear();
+
+	ANumber aWeight;
+	mg.attach_to<elem_t>(aWeight);
+
+	if(m_partitionPreProcessor.valid())
+		m_partitionPreProcessor->partitioning_starts(m_mg, this);
+
+	if(m_partitionPostProcessor.valid())
+		m_partitionPostProcessor->init_post_processing(m_mg, m_sh.get());
+
+//	assign all elements below baseLvl to the local process
+	for(int i = 0; i < (int)baseLvl; ++i)
+		sh.assign_subset(mg.begin<elem_t>(i), mg.end<elem_t>(i), 0);
+
+	const ProcessHierarchy* procH;
+	if(m_nextProcessHierarchy.valid())
+		procH = m_nextProcessHierarchy.get();
+	else
+		procH = m_processHierarchy.get();
+
+	m_problemsOccurred = false;
+
+//	iterate over all hierarchy levels and perform rebalancing for all
+//	hierarchy-sections which contain levels higher than baseLvl
+	for(size_t hlevel = 0; hlevel < procH->num_hierarchy_levels(); ++ hlevel)
+	{
+		int numProcs = procH->num_global_procs_involved(hlevel);
+
+		int minLvl = procH->grid_base_level(hlevel);
+		int maxLvl = (int)mg.top_level();
+
+		if(m_balanceWeights->has_level_offsets()){
+			if(mg.top_level() < procH->grid_base_level(hlevel)){
+				if((hlevel == 0) ||
+					((int)procH->num_global_procs_involved(hlevel - 1) != numProcs))
+				{
+					UG_LOG("Partitioner: Ignoring hierarchy level "
+						<< hlevel << " since it doesn't contain any elements yet\n");
+					m_problemsOccurred = true;
+				}
+				continue;
+			}
+		}
+
+		if(hlevel + 1 < procH->num_hierarchy_levels()){
+			maxLvl = min<int>(maxLvl,
+						(int)procH->grid_base_level(hlevel + 1) - 1);
+		}
+
+		if(minLvl < (int)baseLvl)
+			minLvl = (int)baseLvl;
+
+		if(maxLvl < minLvl)
+			continue;
+
+		if(numProcs <= 1){
+			for(int i = minLvl; i <= maxLvl; ++i)
+				sh.assign_subset(mg.begin<elem_t>(i), mg.end<elem_t>(i), 0);
+			continue;
+		}
+
+	//	if clustered siblings are enabled, we'll perform partitioning on the level
+	//	below minLvl (if such a level exists). However, only the partition-map
+	//	of minLvl and levels above will be adjusted.
+		int partitionLvl = minLvl;
+		pcl::ProcessCommunicator com = procH->global_proc_com(hlevel);
+
+		if((minLvl > 0) && base_class::clustered_siblings_enabled()){
+			partitionLvl = minLvl - 1;
+			size_t partitionHLvl = m_processHierarchy->hierarchy_level_from_grid_level(partitionLvl);
+			com = m_processHierarchy->global_proc_com(partitionHLvl);
+		}
+
+		partition_level(numProcs, minLvl, maxLvl, partitionLvl, aWeight, com);
+
+		for(int i = minLvl; i < maxLvl; ++i){
+			CopyPartitionsToChildren<elem_t>(mg, sh, i, m_intfcCom);
+		}
+	}
+
+	if(m_nextProcessHierarchy.valid()){
+		*m_processHierarchy = *m_nextProcessHierarchy;
+		m_nextProcessHierarchy = SPProcessHierarchy(NULL);
+	}
+
+	mg.detach_from<elem_t>(aWeight);
+
+	if(m_partitionPreProcessor.valid())
+		m_partitionPreProcessor->partitioning_done(m_mg, this);
+
+	if(m_partitionPostProcessor.valid())
+		m_partitionPostProcessor->partitioning_done();
+
+	PCL_DEBUG_BARRIER_ALL();
+	return true;
+}
+
+
+template <class TElem>
+void Partitioner_Hierarchical<TElem>::
+partition_level(int numTargetProcs, int minLvl, int maxLvl, int partitionLvl,
+				ANumber aWeight, pcl::ProcessCommunicator com)
+{
+	GDIST_PROFILE_FUNC();
+
+	typedef typename MultiGrid::traits<elem_t>::iterator iter_t;
+
+	MultiGrid&		mg	= *m_mg;
+	SubsetHandler&	sh	= *m_sh;
+	DistributedGridManager* pdgm = mg.distributed_grid_manager();
+
+	vector<int> origSubsetIndices;
+	if(partitionLvl < minLvl){
+		origSubsetIndices.reserve(mg.num<elem_t>(partitionLvl));
+		for(iter_t eiter = mg.begin<elem_t>(partitionLvl);
+			eiter != mg.end<elem_t>(partitionLvl); ++eiter)
+		{
+			origSubsetIndices.push_back(sh.get_subset_index(*eiter));
+		}
+	}
+
+//	invalidate target partitions of all elements in partitionLvl
+	sh.assign_subset(mg.begin<elem_t>(partitionLvl),
+					 mg.end<elem_t>(partitionLvl), -1);
+
+	accumulate_weights(partitionLvl, minLvl, maxLvl, aWeight);
+
+	if(!com.empty())
+		partition_elements(numTargetProcs, partitionLvl, aWeight, com);
+
+	if(m_partitionPostProcessor.valid())
+		m_partitionPostProcessor->post_process(partitionLvl);
+
+	if(partitionLvl < minLvl){
+	//	copy subset indices from partition-level to minLvl
+		for(int i = partitionLvl; i < minLvl; ++i){
+			CopyPartitionsToChildren<elem_t>(mg, sh, i, m_intfcCom);
+		}
+
+	//	reset partitions in the specified partition-level
+		size_t counter = 0;
+		for(iter_t eiter = mg.begin<elem_t>(partitionLvl);
+			eiter != mg.end<elem_t>(partitionLvl); ++eiter, ++counter)
+		{
+			sh.assign_subset(*eiter, origSubsetIndices[counter]);
+		}
+	}
+	else if(pdgm){
+	//	copy subset indices from vertical slaves to vertical masters,
+	//	since partitioning was only performed on vslaves
+		GridLayoutMap& glm = pdgm->grid_layout_map();
+		ComPol_Subset<layout_t>	compolSHCopy(sh, true);
+
+		if(glm.has_layout<elem_t>(INT_V_SLAVE))
+			m_intfcCom.send_data(glm.get_layout<elem_t>(INT_V_SLAVE).layout_on_level(partitionLvl),
+								 compolSHCopy);
+		if(glm.has_layout<elem_t>(INT_V_MASTER))
+			m_intfcCom.receive_data(glm.get_layout<elem_t>(INT_V_MASTER).layout_on_level(partitionLvl),
+									compolSHCopy);
+		m_intfcCom.communicate();
+	}
+}
+
+
+template <class TElem>
+void Partitioner_Hierarchical<TElem>::
+accumulate_weights(int partitionLvl, int minLvl, int maxLvl, ANumber aWeight)
+{
+	GDIST_PROFILE_FUNC();
+	typedef typename Grid::traits<elem_t>::iterator ElemIter;
+
+	IBalanceWeights& bw = *m_balanceWeights;
+	MultiGrid& mg = *m_mg;
+	DistributedGridManager* pdgm = mg.distributed_grid_manager();
+	Grid::AttachmentAccessor<elem_t, ANumber> aaWeight(mg, aWeight);
+	ComPol_CopyAttachment<layout_t, ANumber> compolCopy(mg, aWeight);
+
+//	each element on partitionLvl receives the weights of all its descendants
+//	in minLvl..maxLvl. Leaves which are marked for refinement are weighted
+//	with their refined weight if the balance weights use level offsets.
+	for(int lvl = maxLvl; lvl >= partitionLvl; --lvl){
+		for(ElemIter iter = mg.begin<elem_t>(lvl); iter != mg.end<elem_t>(lvl); ++iter)
+		{
+			elem_t* e = *iter;
+			const size_t numChildren = mg.num_children<elem_t>(e);
+			number w = 0;
+			if((lvl >= minLvl) && ((!pdgm) || (!pdgm->is_ghost(e)))){
+				if(bw.has_level_offsets() && (numChildren == 0)
+					&& bw.consider_in_level_above(e))
+				{
+					w = bw.get_refined_weight(e);
+				}
+				else
+					w = bw.get_weight(e);
+			}
+
+			if(lvl < maxLvl){
+				for(size_t i = 0; i < numChildren; ++i)
+					w += aaWeight[mg.get_child<elem_t>(e, i)];
+			}
+			aaWeight[e] = w;
+		}
+
+	//	copy from v-slaves to v-masters, since v-slaves don't have parents
+	//	on their processes.
+		if(pdgm && (lvl > partitionLvl)){
+			GridLayoutMap& glm = pdgm->grid_layout_map();
+			if(glm.has_layout<elem_t>(INT_V_SLAVE))
+				m_intfcCom.send_data(glm.get_layout<elem_t>(INT_V_SLAVE).layout_on_level(lvl),
+									 compolCopy);
+			if(glm.has_layout<elem_t>(INT_V_MASTER))
+				m_intfcCom.receive_data(glm.get_layout<elem_t>(INT_V_MASTER).layout_on_level(lvl),
+										compolCopy);
+			m_intfcCom.communicate();
+		}
+	}
+}
+
+
+template void CopyPartitionsToChildren<Edge>(
+		MultiGrid&, ISubsetHandler&, int,
+		pcl::InterfaceCommunicator<GridLayoutMap::Types<Edge>::Layout::LevelLayout>&);
+template void CopyPartitionsToChildren<Face>(
+		MultiGrid&, ISubsetHandler&, int,
+		pcl::InterfaceCommunicator<GridLayoutMap::Types<Face>::Layout::LevelLayout>&);
+template void CopyPartitionsToChildren<Volume>(
+		MultiGrid&, ISubsetHandler&, int,
+		pcl::InterfaceCommunicator<GridLayoutMap::Types<Volume>::Layout::LevelLayout>&);
+
+template class Partitioner_Hierarchical<Edge>;
+template class Partitioner_Hierarchical<Face>;
+template class Partitioner_Hierarchical<Volume>;
+
+}// end of namespace
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__partitioner_hierarchical__
+#define __H__UG__partitioner_hierarchical__
+
+#include <vector>
+#include "parallel_grid_layout.h"
+#include "partitioner.h"
+#include "pcl/pcl_interface_communicator.h"
+
+namespace ug{
+
+/// \addtogroup lib_grid_parallelization_distribution
+///	\{
+
+///	Assigns the partitions of all elements in level lvl to their children
+/**	Partitions are afterwards copied from vertical masters to vertical slaves
+ * in level lvl+1, since vertical slaves don't have parents on their process.*/
+template <class TElem>
+void CopyPartitionsToChildren(
+		MultiGrid& mg,
+		ISubsetHandler& partitionSH,
+		int lvl,
+		pcl::InterfaceCommunicator<typename GridLayoutMap::Types<TElem>::Layout::LevelLayout>& intfcCom);
+
+
+///	Base class for partitioners which partition each level of a process hierarchy separately
+/**	The base class walks the hierarchy levels of the (next) process hierarchy.
+ * For each hierarchy level it accumulates the balance weights of the
+ * associated grid levels in the elements of the partition level, calls
+ * partition_elements and copies the resulting partitions to the children.
+ *
+ * Derived classes only have to assign target partitions to the elements of
+ * the partition level in partition_elements.
+ */
+template <class TElem>
+class Partitioner_Hierarchical : public IPartitioner{
+	public:
+		typedef IPartitioner	 						base_class;
+		typedef TElem									elem_t;
+		typedef typename GridLayoutMap::Types<elem_t>::Layout::LevelLayout	layout_t;
+
+		Partitioner_Hierarchical();
+		virtual ~Partitioner_Hierarchical();
+
+		virtual void set_next_process_hierarchy(SPProcessHierarchy procHierarchy);
+		virtual void set_balance_weights(SPBalanceWeights balanceWeights);
+
+		virtual void set_partition_pre_processor(SPPartitionPreProcessor ppp);
+		virtual void set_partition_post_processor(SPPartitionPostProcessor ppp);
+
+		virtual ConstSPProcessHierarchy current_process_hierarchy() const;
+		virtual ConstSPProcessHierarchy next_process_hierarchy() const;
+
+		virtual bool supports_balance_weights() const			{return true;}
+
+		virtual bool partition(size_t baseLvl, size_t elementThreshold);
+
+		virtual SubsetHandler& get_partitions();
+		virtual const std::vector<int>* get_process_map() const	{return NULL;}
+
+	protected:
+	///	assigns target partitions in 0..numTargetProcs-1 to the elements of partitionLvl
+	/**	Ghosts have to be skipped, since their partitions are received from
+	 * their vertical slaves afterwards. aWeight holds the accumulated weights
+	 * of all elements in partitionLvl. The method is only called on the
+	 * processes of com, which is never empty.*/
+		virtual void partition_elements(int numTargetProcs, int partitionLvl,
+										ANumber aWeight,
+										pcl::ProcessCommunicator& com) = 0;
+
+		MultiGrid*								m_mg;
+		SmartPtr<SubsetHandler>					m_sh;
+		SPProcessHierarchy						m_processHierarchy;
+		SPProcessHierarchy						m_nextProcessHierarchy;
+		pcl::InterfaceCommunicator<layout_t>	m_intfcCom;
+
+		SPBalanceWeights						m_balanceWeights;
+		SPPartitionPreProcessor					m_partitionPreProcessor;
+		SPPartitionPostProcessor				m_partitionPostProcessor;
+
+	private:
+		void partition_level(int numTargetProcs, int minLvl, int maxLvl,
+							 int partitionLvl, ANumber aWeight,
+							 pcl::ProcessCommunicator com);
+
+	///	accumulates the weights of all elements in minLvl..maxLvl in their ancestors on partitionLvl
+		void accumulate_weights(int partitionLvl, int minLvl, int maxLvl,
+								ANumber aWeight);
+};
+
+///	\}
+
+}// end of namespace
+
+#endif
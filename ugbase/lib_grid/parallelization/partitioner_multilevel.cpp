@@ -0,0 +1,1029 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <queue>
+#include "partitioner_multilevel.h"
+#include "load_balancer_util.h"
+#include "distributed_grid.h"
+#include "lib_grid/parallelization/util/parallel_dual_graph.h"
+#include "lib_grid/parallelization/parallelization_util.h"
+
+using namespace std;
+
+namespace ug{
+
+namespace{
+
+///	weighted undirected graph in compressed row storage
+struct WeightedGraph{
+	vector<int>		adjStart;
+	vector<int>		adj;
+	vector<number>	adjWgt;
+	vector<number>	vrtWgt;
+
+	int num_vertices() const	{return (int)vrtWgt.size();}
+};
+
+///	an edge from a local graph vertex to a vertex on another process
+struct RemoteEdge{
+	RemoteEdge(int v, int g, number w) : vrt(v), globalVrt(g), wgt(w)	{}
+	int		vrt;
+	int		globalVrt;
+	number	wgt;
+};
+
+///	associates a global fine vertex index with a global coarse vertex index
+struct IndexPair{
+	IndexPair()	{}
+	IndexPair(int f, int c) : fine(f), coarse(c)	{}
+	bool operator<(const IndexPair& ip) const	{return fine < ip.fine;}
+	bool operator==(const IndexPair& ip) const	{return fine == ip.fine;}
+	int fine;
+	int coarse;
+};
+
+struct CoarseEdge{
+	CoarseEdge(int f, int t, number w) : from(f), to(t), wgt(w)	{}
+	bool operator<(const CoarseEdge& e) const
+	{
+		if(from != e.from)
+			return from < e.from;
+		return to < e.to;
+	}
+	int		from;
+	int		to;
+	number	wgt;
+};
+
+number SumOfWeights(const vector<number>& weights)
+{
+	number sum = 0;
+	for(size_t i = 0; i < weights.size(); ++i)
+		sum += weights[i];
+	return sum;
+}
+
+///	a reproducible pseudo random permutation of 0, ..., n-1
+void RandomPermutation(vector<int>& permOut, int n)
+{
+	permOut.resize(n);
+	for(int i = 0; i < n; ++i)
+		permOut[i] = i;
+
+	uint64 state = 0x9E3779B97F4A7C15ULL ^ (uint64)n;
+	for(int i = n - 1; i > 0; --i){
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		swap(permOut[i], permOut[state % (uint64)(i + 1)]);
+	}
+}
+
+///	matches each vertex with its unmatched neighbor across the heaviest edge
+/**	Pairs whose combined weight would exceed maxVrtWgt are not matched.
+ * Returns the number of coarse vertices. cmapOut associates each vertex
+ * with its coarse vertex.*/
+int MatchHeavyEdges(vector<int>& cmapOut, const WeightedGraph& g, number maxVrtWgt)
+{
+	const int n = g.num_vertices();
+	vector<int> match(n, -1);
+	vector<int> order;
+	RandomPermutation(order, n);
+
+	for(int i = 0; i < n; ++i){
+		const int v = order[i];
+		if(match[v] != -1)
+			continue;
+
+		int best = v;
+		number bestWgt = -1;
+		for(int e = g.adjStart[v]; e < g.adjStart[v + 1]; ++e){
+			const int u = g.adj[e];
+			if((match[u] == -1) && (u != v) && (g.adjWgt[e] > bestWgt)
+				&& (g.vrtWgt[v] + g.vrtWgt[u] <= maxVrtWgt))
+			{
+				best = u;
+				bestWgt = g.adjWgt[e];
+			}
+		}
+		match[v] = best;
+		match[best] = v;
+	}
+
+	cmapOut.assign(n, -1);
+	int numCoarse = 0;
+	for(int v = 0; v < n; ++v){
+		if(cmapOut[v] == -1){
+			cmapOut[v] = numCoarse;
+			cmapOut[match[v]] = numCoarse;
+			++numCoarse;
+		}
+	}
+	return numCoarse;
+}
+
+///	creates the coarse graph in which matched vertices are collapsed
+/**	Weights of parallel edges are summed up.*/
+void ContractGraph(WeightedGraph& coarseOut, const WeightedGraph& g,
+				   const vector<int>& cmap, int numCoarse)
+{
+	const int n = g.num_vertices();
+
+//	sort fine vertices by their coarse vertices
+	vector<int> first(numCoarse + 1, 0);
+	for(int v = 0; v < n; ++v)
+		++first[cmap[v] + 1];
+	for(int c = 0; c < numCoarse; ++c)
+		first[c + 1] += first[c];
+
+	vector<int> members(n);
+	vector<int> pos(first.begin(), first.end() - 1);
+	for(int v = 0; v < n; ++v)
+		members[pos[cmap[v]]++] = v;
+
+	coarseOut.vrtWgt.assign(numCoarse, 0);
+	coarseOut.adjStart.resize(numCoarse + 1);
+	coarseOut.adj.clear();
+	coarseOut.adjWgt.clear();
+
+	vector<int> slot(numCoarse, -1);
+	for(int c = 0; c < numCoarse; ++c){
+		const int cBegin = (int)coarseOut.adj.size();
+		coarseOut.adjStart[c] = cBegin;
+		for(int i = first[c]; i < first[c + 1]; ++i){
+			const int v = members[i];
+			coarseOut.vrtWgt[c] += g.vrtWgt[v];
+			for(int e = g.adjStart[v]; e < g.adjStart[v + 1]; ++e){
+				const int cu = cmap[g.adj[e]];
+				if(cu == c)
+					continue;
+				if(slot[cu] == -1){
+					slot[cu] = (int)coarseOut.adj.size();
+					coarseOut.adj.push_back(cu);
+					coarseOut.adjWgt.push_back(g.adjWgt[e]);
+				}
+				else
+					coarseOut.adjWgt[slot[cu]] += g.adjWgt[e];
+			}
+		}
+		for(size_t e = cBegin; e < coarseOut.adj.size(); ++e)
+			slot[coarseOut.adj[e]] = -1;
+	}
+	coarseOut.adjStart[numCoarse] = (int)coarseOut.adj.size();
+}
+
+enum BisectionSide{
+	OUTSIDE = 0,
+	LEFT = 1,
+	RIGHT = 2
+};
+
+///	scratch arrays for the bisection of subsets of a graph
+/**	side holds OUTSIDE for all vertices which are not contained in the current subset.*/
+struct BisectionWorkspace{
+	BisectionWorkspace(int numVrts) :
+		side(numVrts, OUTSIDE), gain(numVrts, 0), locked(numVrts, false)	{}
+	vector<int>		side;
+	vector<number>	gain;
+	vector<bool>	locked;
+};
+
+typedef std::priority_queue<std::pair<number, int> >	GainQueue;
+
+///	a bisection is better than another if it is balanced and has a smaller cut
+bool IsBetterBisection(number cut, number imbalance, number bestCut,
+					   number bestImbalance, number tol)
+{
+	const bool balanced = (imbalance <= tol);
+	const bool bestBalanced = (bestImbalance <= tol);
+	if(balanced != bestBalanced)
+		return balanced;
+	if(!balanced)
+		return imbalance < bestImbalance;
+	return (cut < bestCut) || ((cut == bestCut) && (imbalance < bestImbalance));
+}
+
+number BisectionCut(const WeightedGraph& g, const vector<int>& vrts,
+					const vector<int>& side)
+{
+	number cut = 0;
+	for(size_t i = 0; i < vrts.size(); ++i){
+		const int v = vrts[i];
+		if(side[v] != LEFT)
+			continue;
+		for(int e = g.adjStart[v]; e < g.adjStart[v + 1]; ++e){
+			if(side[g.adj[e]] == RIGHT)
+				cut += g.adjWgt[e];
+		}
+	}
+	return cut;
+}
+
+///	returns the vertex of vrts which is visited last by a breadth first search from start
+int FindPeripheralVertex(BisectionWorkspace& ws, const WeightedGraph& g,
+						 const vector<int>& vrts, int start)
+{
+	vector<int>& side = ws.side;
+	deque<int> queue;
+	queue.push_back(start);
+	side[start] = LEFT;
+	int last = start;
+	while(!queue.empty()){
+		const int v = queue.front();
+		queue.pop_front();
+		last = v;
+		for(int e = g.adjStart[v]; e < g.adjStart[v + 1]; ++e){
+			const int u = g.adj[e];
+			if(side[u] == RIGHT){
+				side[u] = LEFT;
+				queue.push_back(u);
+			}
+		}
+	}
+	for(size_t i = 0; i < vrts.size(); ++i)
+		side[vrts[i]] = RIGHT;
+	return last;
+}
+
+///	grows the LEFT region from seed, until it carries approximately targetWgt
+/**	The frontier vertex whose move reduces the cut the most is added first.
+ * If the region is exhausted, growing continues at the next RIGHT vertex.
+ * All vertices of vrts have to be RIGHT on entry.*/
+void GrowRegion(BisectionWorkspace& ws, const WeightedGraph& g,
+				const vector<int>& vrts, int seed, number targetWgt)
+{
+	vector<int>& side = ws.side;
+	vector<number>& gain = ws.gain;
+
+	for(size_t i = 0; i < vrts.size(); ++i){
+		const int v = vrts[i];
+		gain[v] = 0;
+		for(int e = g.adjStart[v]; e < g.adjStart[v + 1]; ++e){
+			if(side[g.adj[e]] != OUTSIDE)
+				gain[v] -= g.adjWgt[e];
+		}
+	}
+
+	GainQueue queue;
+	queue.push(make_pair(gain[seed], seed));
+	number wgt = 0;
+	size_t nextStart = 0;
+	while(wgt < targetWgt){
+		if(queue.empty()){
+			while((nextStart < vrts.size()) && (side[vrts[nextStart]] != RIGHT))
+				++nextStart;
+			if(nextStart == vrts.size())
+				break;
+			queue.push(make_pair(gain[vrts[nextStart]], vrts[nextStart]));
+		}
+
+		const int v = queue.top().second;
+		const number entryGain = queue.top().first;
+		queue.pop();
+		if((side[v] != RIGHT) || (entryGain != gain[v]))
+			continue;
+
+	//	stop if adding v would overshoot more than stopping undershoots
+		if((wgt > 0) && (wgt + g.vrtWgt[v] - targetWgt > targetWgt - wgt))
+			break;
+
+		side[v] = LEFT;
+		wgt += g.vrtWgt[v];
+		for(int e = g.adjStart[v]; e < g.adjStart[v + 1]; ++e){
+			const int u = g.adj[e];
+			if(side[u] == RIGHT){
+				gain[u] += 2. * g.adjWgt[e];
+				queue.push(make_pair(gain[u], u));
+			}
+		}
+	}
+}
+
+///	Fiduccia-Mattheyses refinement of a bisection of vrts
+/**	Vertices are moved from the heavier side, ordered by their gain. Each
+ * pass is rolled back to the best bisection encountered.*/
+void RefineBisectionFM(BisectionWorkspace& ws, const WeightedGraph& g,
+					   const vector<int>& vrts, number targetLeftWgt,
+					   number tol, int maxPasses)
+{
+	const size_t maxStall = 100;
+	vector<int>& side = ws.side;
+	vector<number>& gain = ws.gain;
+	vector<bool>& locked = ws.locked;
+
+	number leftWgt = 0;
+	for(size_t i = 0; i < vrts.size(); ++i){
+		if(side[vrts[i]] == LEFT)
+			leftWgt += g.vrtWgt[vrts[i]];
+	}
+
+	vector<int> moves;
+	for(int pass = 0; pass < maxPasses; ++pass){
+		GainQueue queues[2];
+		for(size_t i = 0; i < vrts.size(); ++i){
+			const int v = vrts[i];
+			gain[v] = 0;
+			locked[v] = false;
+			for(int e = g.adjStart[v]; e < g.adjStart[v + 1]; ++e){
+				const int s = side[g.adj[e]];
+				if(s == side[v])
+					gain[v] -= g.adjWgt[e];
+				else if(s != OUTSIDE)
+					gain[v] += g.adjWgt[e];
+			}
+			queues[side[v] - 1].push(make_pair(gain[v], v));
+		}
+
+		number cut = BisectionCut(g, vrts, side);
+		number bestCut = cut;
+		number bestImbalance = fabs(leftWgt - targetLeftWgt);
+		size_t numBestMoves = 0;
+		moves.clear();
+
+		while(moves.size() - numBestMoves < maxStall){
+			const int from = (leftWgt > targetLeftWgt) ? LEFT : RIGHT;
+			GainQueue& queue = queues[from - 1];
+			int v = -1;
+			while(!queue.empty()){
+				const int cand = queue.top().second;
+				const number entryGain = queue.top().first;
+				queue.pop();
+				if(!locked[cand] && (side[cand] == from) && (entryGain == gain[cand])){
+					v = cand;
+					break;
+				}
+			}
+			if(v == -1)
+				break;
+
+			const int to = (from == LEFT) ? RIGHT : LEFT;
+			side[v] = to;
+			locked[v] = true;
+			leftWgt += (to == LEFT) ? g.vrtWgt[v] : -g.vrtWgt[v];
+			cut -= gain[v];
+			moves.push_back(v);
+
+			for(int e = g.adjStart[v]; e < g.adjStart[v + 1]; ++e){
+				const int u = g.adj[e];
+				if((side[u] == OUTSIDE) || locked[u])
+					continue;
+				if(side[u] == from)
+					gain[u] += 2. * g.adjWgt[e];
+				else
+					gain[u] -= 2. * g.adjWgt[e];
+				queues[side[u] - 1].push(make_pair(gain[u], u));
+			}
+
+			const number imbalance = fabs(leftWgt - targetLeftWgt);
+			if(IsBetterBisection(cut, imbalance, bestCut, bestImbalance, tol)){
+				bestCut = cut;
+				bestImbalance = imbalance;
+				numBestMoves = moves.size();
+			}
+		}
+
+	//	roll back to the best bisection
+		for(size_t i = moves.size(); i > numBestMoves; --i){
+			const int v = moves[i - 1];
+			side[v] = (side[v] == LEFT) ? RIGHT : LEFT;
+			leftWgt += (side[v] == LEFT) ? g.vrtWgt[v] : -g.vrtWgt[v];
+		}
+
+		if(numBestMoves == 0)
+			break;
+	}
+}
+
+///	bisects the graph such that the LEFT side carries approximately targetLeftWgt
+/**	The bisection is grown from several seeds and refined through
+ * Fiduccia-Mattheyses. The best bisection is returned in ws.side.*/
+void InitialBisection(BisectionWorkspace& ws, const WeightedGraph& g,
+					  const vector<int>& vrts, number targetLeftWgt,
+					  number tol, int numFMPasses)
+{
+	const int numTrials = 4;
+	vector<int>& side = ws.side;
+
+	vector<int> bestSides;
+	number bestCut = 0, bestImbalance = 0;
+	for(int trial = 0; trial < numTrials; ++trial){
+		for(size_t i = 0; i < vrts.size(); ++i)
+			side[vrts[i]] = RIGHT;
+
+		int seed;
+		if(trial == 0)
+			seed = FindPeripheralVertex(ws, g, vrts, vrts.front());
+		else
+			seed = vrts[(trial * vrts.size()) / numTrials];
+
+		GrowRegion(ws, g, vrts, seed, targetLeftWgt);
+		RefineBisectionFM(ws, g, vrts, targetLeftWgt, tol, numFMPasses);
+
+		number leftWgt = 0;
+		for(size_t i = 0; i < vrts.size(); ++i){
+			if(side[vrts[i]] == LEFT)
+				leftWgt += g.vrtWgt[vrts[i]];
+		}
+		const number cut = BisectionCut(g, vrts, side);
+		const number imbalance = fabs(leftWgt - targetLeftWgt);
+		if(bestSides.empty()
+		   || IsBetterBisection(cut, imbalance, bestCut, bestImbalance, tol))
+		{
+			bestCut = cut;
+			bestImbalance = imbalance;
+			bestSides.resize(vrts.size());
+			for(size_t i = 0; i < vrts.size(); ++i)
+				bestSides[i] = side[vrts[i]];
+		}
+	}
+
+	for(size_t i = 0; i < vrts.size(); ++i)
+		side[vrts[i]] = bestSides[i];
+}
+
+///	multilevel bisection of a graph
+/**	The graph is coarsened through heavy edge matching, bisected on the
+ * coarsest level and refined through Fiduccia-Mattheyses on each level
+ * during uncoarsening. The LEFT side receives approximately the fraction
+ * leftFraction of the total weight. Absolute deviations up to minTol are
+ * tolerated.*/
+void BisectGraphMultilevel(vector<int>& sidesOut, const WeightedGraph& g,
+						   number leftFraction, number minTol)
+{
+	const int coarsenTo = 100;
+	const int numFMPasses = 4;
+
+	const number totalWgt = SumOfWeights(g.vrtWgt);
+	const number targetLeftWgt = leftFraction * totalWgt;
+	const number maxVrtWgt = 1.5 * totalWgt / (number)coarsenTo;
+
+//	coarsening. A deque is used, since it doesn't invalidate references on push_back.
+	deque<WeightedGraph> coarseGraphs;
+	vector<vector<int> > cmaps;
+	const WeightedGraph* cur = &g;
+	while(cur->num_vertices() > coarsenTo){
+		vector<int> cmap;
+		const int numCoarse = MatchHeavyEdges(cmap, *cur, maxVrtWgt);
+		if(numCoarse > 0.95 * cur->num_vertices())
+			break;
+		coarseGraphs.push_back(WeightedGraph());
+		ContractGraph(coarseGraphs.back(), *cur, cmap, numCoarse);
+		cmaps.push_back(vector<int>());
+		cmaps.back().swap(cmap);
+		cur = &coarseGraphs.back();
+	}
+
+	vector<int> vrts(cur->num_vertices());
+	for(int i = 0; i < cur->num_vertices(); ++i)
+		vrts[i] = i;
+
+	number tol = max(minTol, *max_element(cur->vrtWgt.begin(), cur->vrtWgt.end()));
+	BisectionWorkspace ws(cur->num_vertices());
+	InitialBisection(ws, *cur, vrts, targetLeftWgt, tol, numFMPasses);
+	vector<int> sides;
+	sides.swap(ws.side);
+
+//	uncoarsening
+	for(int lvl = (int)cmaps.size() - 1; lvl >= 0; --lvl){
+		const WeightedGraph& fine = (lvl == 0) ? g : coarseGraphs[lvl - 1];
+		const vector<int>& cmap = cmaps[lvl];
+		BisectionWorkspace fineWS(fine.num_vertices());
+		vrts.resize(fine.num_vertices());
+		for(int v = 0; v < fine.num_vertices(); ++v){
+			fineWS.side[v] = sides[cmap[v]];
+			vrts[v] = v;
+		}
+
+		tol = max(minTol, *max_element(fine.vrtWgt.begin(), fine.vrtWgt.end()));
+		RefineBisectionFM(fineWS, fine, vrts, targetLeftWgt, tol, numFMPasses);
+		sides.swap(fineWS.side);
+	}
+
+	sidesOut.swap(sides);
+}
+
+///	creates the subgraph induced by vrts
+/**	localInds has to have the size of g and has to be filled with -1.
+ * It is reset to -1 on exit.*/
+void ExtractSubgraph(WeightedGraph& subOut, const WeightedGraph& g,
+					 const vector<int>& vrts, vector<int>& localInds)
+{
+	for(size_t i = 0; i < vrts.size(); ++i)
+		localInds[vrts[i]] = (int)i;
+
+	subOut.vrtWgt.resize(vrts.size());
+	subOut.adjStart.resize(vrts.size() + 1);
+	subOut.adj.clear();
+	subOut.adjWgt.clear();
+	for(size_t i = 0; i < vrts.size(); ++i){
+		const int v = vrts[i];
+		subOut.vrtWgt[i] = g.vrtWgt[v];
+		subOut.adjStart[i] = (int)subOut.adj.size();
+		for(int e = g.adjStart[v]; e < g.adjStart[v + 1]; ++e){
+			const int u = localInds[g.adj[e]];
+			if(u != -1){
+				subOut.adj.push_back(u);
+				subOut.adjWgt.push_back(g.adjWgt[e]);
+			}
+		}
+	}
+	subOut.adjStart[vrts.size()] = (int)subOut.adj.size();
+
+	for(size_t i = 0; i < vrts.size(); ++i)
+		localInds[vrts[i]] = -1;
+}
+
+///	assigns the parts firstPart, ..., firstPart + numParts - 1 through recursive multilevel bisection
+/**	ids associates each vertex of g with an entry in parts.*/
+void PartitionRecursively(vector<int>& parts, const WeightedGraph& g,
+						  const vector<int>& ids, int firstPart, int numParts,
+						  number imbalanceTol)
+{
+	const int n = g.num_vertices();
+	if((numParts == 1) || (n < 2)){
+		for(int i = 0; i < n; ++i)
+			parts[ids[i]] = firstPart;
+		return;
+	}
+
+	const int numLeft = numParts / 2;
+	const number totalWgt = SumOfWeights(g.vrtWgt);
+	vector<int> sides;
+	BisectGraphMultilevel(sides, g, (number)numLeft / (number)numParts,
+						  0.5 * imbalanceTol * totalWgt / (number)numParts);
+
+	vector<int> vrts[2];
+	for(int i = 0; i < n; ++i)
+		vrts[sides[i] - 1].push_back(i);
+	vector<int>().swap(sides);
+
+	vector<int> localInds(n, -1);
+	for(int i = 0; i < 2; ++i){
+		WeightedGraph sub;
+		ExtractSubgraph(sub, g, vrts[i], localInds);
+		vector<int> subIds(vrts[i].size());
+		for(size_t j = 0; j < vrts[i].size(); ++j)
+			subIds[j] = ids[vrts[i][j]];
+
+		if(i == 0)
+			PartitionRecursively(parts, sub, subIds, firstPart, numLeft, imbalanceTol);
+		else{
+			PartitionRecursively(parts, sub, subIds, firstPart + numLeft,
+								 numParts - numLeft, imbalanceTol);
+		}
+	}
+}
+
+///	moves boundary vertices to neighboring parts, if this reduces the edge cut
+/**	A move is only performed if the target part doesn't exceed maxPartWgt
+ * afterwards. Moves which don't change the edge cut are performed if they
+ * improve the balance. Vertices of overweight parts are moved even if the
+ * edge cut grows.*/
+void RefineKWay(vector<int>& parts, const WeightedGraph& g, int numParts,
+				number maxPartWgt, int maxPasses)
+{
+	const int n = g.num_vertices();
+	vector<number> partWgt(numParts, 0);
+	for(int v = 0; v < n; ++v)
+		partWgt[parts[v]] += g.vrtWgt[v];
+
+	vector<number> conn(numParts, 0);
+	vector<bool> touched(numParts, false);
+	vector<int> touchedParts;
+
+	for(int pass = 0; pass < maxPasses; ++pass){
+		int numMoves = 0;
+		for(int v = 0; v < n; ++v){
+			const int own = parts[v];
+			const number w = g.vrtWgt[v];
+
+			touchedParts.clear();
+			for(int e = g.adjStart[v]; e < g.adjStart[v + 1]; ++e){
+				const int p = parts[g.adj[e]];
+				if(!touched[p]){
+					touched[p] = true;
+					touchedParts.push_back(p);
+				}
+				conn[p] += g.adjWgt[e];
+			}
+
+			const bool overweight = (partWgt[own] > maxPartWgt);
+			int best = -1;
+			number bestGain = 0;
+			for(size_t i = 0; i < touchedParts.size(); ++i){
+				const int p = touchedParts[i];
+				if((p == own) || (partWgt[p] + w > maxPartWgt))
+					continue;
+
+				const number gain = conn[p] - conn[own];
+				bool accept;
+				if(best == -1){
+					accept = (gain > 0) || overweight
+							 || ((gain == 0) && (partWgt[p] + w < partWgt[own]));
+				}
+				else{
+					accept = (gain > bestGain)
+							 || ((gain == bestGain) && (partWgt[p] < partWgt[best]));
+				}
+
+				if(accept){
+					best = p;
+					bestGain = gain;
+				}
+			}
+
+			for(size_t i = 0; i < touchedParts.size(); ++i){
+				conn[touchedParts[i]] = 0;
+				touched[touchedParts[i]] = false;
+			}
+
+			if(best != -1){
+				parts[v] = best;
+				partWgt[own] -= w;
+				partWgt[best] += w;
+				++numMoves;
+			}
+		}
+
+		if(numMoves == 0)
+			break;
+	}
+}
+
+///	k-way partitioning of a serial graph
+/**	The graph is partitioned through recursive multilevel bisection. The
+ * resulting partition is smoothed and balanced through greedy k-way
+ * refinement.*/
+void PartitionGraphMultilevel(vector<int>& partsOut, const WeightedGraph& g,
+							  int numParts, number imbalanceTol, int numPasses)
+{
+	const int n = g.num_vertices();
+	partsOut.assign(n, 0);
+	if((numParts <= 1) || (n == 0))
+		return;
+
+	vector<int> ids(n);
+	for(int i = 0; i < n; ++i)
+		ids[i] = i;
+	PartitionRecursively(partsOut, g, ids, 0, numParts, imbalanceTol);
+
+	const number maxPartWgt = (1. + imbalanceTol) * SumOfWeights(g.vrtWgt) / (number)numParts;
+	RefineKWay(partsOut, g, numParts, maxPartWgt, numPasses);
+}
+
+///	sends sendVecs[i] to process i of procComm and collects all received records in recvOut
+/**	Send sizes are exchanged through a single alltoall. Records for the local
+ * process are copied directly. T has to be a POD type.*/
+template <class T>
+void ExchangeRecords(const pcl::ProcessCommunicator& procComm,
+					 vector<vector<T> >& sendVecs, vector<T>& recvOut)
+{
+	pcl::ProcessCommunicator com = procComm;
+	const int numProcs = (int)com.size();
+	const int localProc = com.get_local_proc_id();
+
+	vector<int> sendSizes(numProcs, 0), recvSizes(numProcs, 0);
+	for(int i = 0; i < numProcs; ++i){
+		if(i != localProc)
+			sendSizes[i] = (int)(sendVecs[i].size() * sizeof(T));
+	}
+	com.alltoall(&sendSizes.front(), 1, PCL_DT_INT, &recvSizes.front(), 1, PCL_DT_INT);
+
+	vector<int> sendToRanks, sendSegSizes, recvFromRanks, recvSegSizes;
+	size_t totalSendSize = 0, totalRecvSize = 0;
+	for(int i = 0; i < numProcs; ++i){
+		if(sendSizes[i] > 0){
+			sendToRanks.push_back(i);
+			sendSegSizes.push_back(sendSizes[i]);
+			totalSendSize += sendSizes[i];
+		}
+		if(recvSizes[i] > 0){
+			recvFromRanks.push_back(i);
+			recvSegSizes.push_back(recvSizes[i]);
+			totalRecvSize += recvSizes[i];
+		}
+	}
+
+	vector<T> sendBuf;
+	sendBuf.reserve(totalSendSize / sizeof(T));
+	for(size_t i = 0; i < sendToRanks.size(); ++i){
+		vector<T>& v = sendVecs[sendToRanks[i]];
+		sendBuf.insert(sendBuf.end(), v.begin(), v.end());
+	}
+
+	const size_t numLocal = sendVecs[localProc].size();
+	recvOut.resize(numLocal + totalRecvSize / sizeof(T));
+	if(numLocal > 0)
+		copy(sendVecs[localProc].begin(), sendVecs[localProc].end(), recvOut.begin());
+
+	com.distribute_data(recvOut.empty() ? NULL : &recvOut[numLocal],
+						recvSegSizes.empty() ? NULL : &recvSegSizes.front(),
+						recvFromRanks.empty() ? NULL : &recvFromRanks.front(),
+						(int)recvFromRanks.size(),
+						sendBuf.empty() ? NULL : &sendBuf.front(),
+						sendSegSizes.empty() ? NULL : &sendSegSizes.front(),
+						sendToRanks.empty() ? NULL : &sendToRanks.front(),
+						(int)sendToRanks.size());
+}
+
+///	partitions a distributed graph
+/**	localGraph contains the local vertices and the edges between them,
+ * remoteEdges the edges to vertices on other processes. vrtOffsets holds
+ * the first global vertex index of each process of com and the total number
+ * of vertices as last entry.
+ *
+ * The local graphs are coarsened independently, until the global coarse
+ * graph contains at most maxGathered vertices. The coarse graph is then
+ * gathered and partitioned on the first process of com.*/
+void PartitionDistributedGraph(vector<int>& partsOut,
+							   const WeightedGraph& localGraph,
+							   const vector<RemoteEdge>& remoteEdges,
+							   const vector<int>& vrtOffsets,
+							   int numParts, number imbalanceTol,
+							   int maxGathered, int numPasses,
+							   pcl::ProcessCommunicator& com)
+{
+	const int numProcs = (int)com.size();
+	const int localProc = com.get_local_proc_id();
+	const int numLocal = localGraph.num_vertices();
+	const int numGlobal = vrtOffsets[numProcs];
+	const int localOffset = vrtOffsets[localProc];
+
+	const number totalWgt = com.allreduce(SumOfWeights(localGraph.vrtWgt), PCL_RO_SUM);
+	const int coarsenTo = max(20 * numParts, 100);
+	const number maxVrtWgt = 1.5 * totalWgt / (number)coarsenTo;
+
+//	coarsen the local graph. Edges to other processes are not contracted.
+	vector<int> fineToCoarse(numLocal);
+	for(int i = 0; i < numLocal; ++i)
+		fineToCoarse[i] = i;
+
+	WeightedGraph cur = localGraph;
+	if(numGlobal > maxGathered){
+		const int localTarget = max<int>(1, (int)((number)maxGathered * (number)numLocal
+												  / (number)numGlobal));
+		WeightedGraph tmp;
+		vector<int> cmap;
+		while(cur.num_vertices() > localTarget){
+			const int numCoarse = MatchHeavyEdges(cmap, cur, maxVrtWgt);
+			if(numCoarse > 0.95 * cur.num_vertices())
+				break;
+			ContractGraph(tmp, cur, cmap, numCoarse);
+			swap(cur, tmp);
+			for(int i = 0; i < numLocal; ++i)
+				fineToCoarse[i] = cmap[fineToCoarse[i]];
+		}
+	}
+
+	const int numCoarse = cur.num_vertices();
+	vector<int> coarseCounts(numProcs);
+	com.allgather(&numCoarse, 1, PCL_DT_INT, &coarseCounts.front(), 1, PCL_DT_INT);
+	int coarseOffset = 0;
+	int numCoarseGlobal = 0;
+	for(int i = 0; i < numProcs; ++i){
+		if(i == localProc)
+			coarseOffset = numCoarseGlobal;
+		numCoarseGlobal += coarseCounts[i];
+	}
+
+//	inform neighbor processes about the coarse vertices of local boundary vertices
+	vector<vector<IndexPair> > sendVecs(numProcs);
+	for(size_t i = 0; i < remoteEdges.size(); ++i){
+		const RemoteEdge& re = remoteEdges[i];
+		const int proc = int(upper_bound(vrtOffsets.begin(), vrtOffsets.end(), re.globalVrt)
+							 - vrtOffsets.begin()) - 1;
+		sendVecs[proc].push_back(IndexPair(localOffset + re.vrt,
+										   coarseOffset + fineToCoarse[re.vrt]));
+	}
+	for(int i = 0; i < numProcs; ++i){
+		sort(sendVecs[i].begin(), sendVecs[i].end());
+		sendVecs[i].erase(unique(sendVecs[i].begin(), sendVecs[i].end()), sendVecs[i].end());
+	}
+
+	vector<IndexPair> remoteCoarse;
+	ExchangeRecords(com, sendVecs, remoteCoarse);
+	sort(remoteCoarse.begin(), remoteCoarse.end());
+
+//	collect the edges of the coarse graph with global indices
+	vector<CoarseEdge> edges;
+	edges.reserve(cur.adj.size() + remoteEdges.size());
+	for(int c = 0; c < numCoarse; ++c){
+		for(int e = cur.adjStart[c]; e < cur.adjStart[c + 1]; ++e)
+			edges.push_back(CoarseEdge(c, coarseOffset + cur.adj[e], cur.adjWgt[e]));
+	}
+	for(size_t i = 0; i < remoteEdges.size(); ++i){
+		const RemoteEdge& re = remoteEdges[i];
+		vector<IndexPair>::iterator iter = lower_bound(remoteCoarse.begin(),
+								remoteCoarse.end(), IndexPair(re.globalVrt, -1));
+		UG_COND_THROW((iter == remoteCoarse.end()) || (iter->fine != re.globalVrt),
+					  "Coarse vertex of remote graph vertex " << re.globalVrt
+					  << " is unknown.");
+		edges.push_back(CoarseEdge(fineToCoarse[re.vrt], iter->coarse, re.wgt));
+	}
+	sort(edges.begin(), edges.end());
+
+	vector<int> degrees(numCoarse, 0);
+	vector<int> adj;
+	vector<number> adjWgt;
+	for(size_t i = 0; i < edges.size(); ++i){
+		if((i > 0) && (edges[i].from == edges[i-1].from) && (edges[i].to == edges[i-1].to))
+			adjWgt.back() += edges[i].wgt;
+		else{
+			++degrees[edges[i].from];
+			adj.push_back(edges[i].to);
+			adjWgt.push_back(edges[i].wgt);
+		}
+	}
+	vector<CoarseEdge>().swap(edges);
+
+//	gather and partition the coarse graph
+	WeightedGraph g;
+	vector<int> gDegrees;
+	com.gatherv(g.vrtWgt, cur.vrtWgt, 0);
+	com.gatherv(gDegrees, degrees, 0);
+	com.gatherv(g.adj, adj, 0);
+	com.gatherv(g.adjWgt, adjWgt, 0);
+
+	vector<int> coarseParts(numCoarseGlobal, 0);
+	if(localProc == 0){
+		g.adjStart.resize(numCoarseGlobal + 1);
+		g.adjStart[0] = 0;
+		for(int i = 0; i < numCoarseGlobal; ++i)
+			g.adjStart[i + 1] = g.adjStart[i] + gDegrees[i];
+		PartitionGraphMultilevel(coarseParts, g, numParts, imbalanceTol, numPasses);
+	}
+
+	if(numCoarseGlobal > 0)
+		com.broadcast(&coarseParts.front(), numCoarseGlobal, 0);
+
+	partsOut.resize(numLocal);
+	for(int i = 0; i < numLocal; ++i)
+		partsOut[i] = coarseParts[coarseOffset + fineToCoarse[i]];
+}
+
+}//	end of anonymous namespace
+
+template <class TElem, int dim>
+Partitioner_Multilevel<TElem, dim>::
+Partitioner_Multilevel() :
+	m_imbalanceTolerance(0.03),
+	m_maxGatheredVertices(10000),
+	m_numRefinementPasses(8)
+{
+}
+
+template <class TElem, int dim>
+Partitioner_Multilevel<TElem, dim>::
+~Partitioner_Multilevel()
+{
+}
+
+////////////////////////////////
+//	SETTERS AND GETTERS
+////////////////////////////////
+template <class TElem, int dim>
+void Partitioner_Multilevel<TElem, dim>::
+set_grid(MultiGrid* mg, Attachment<MathVector<dim> > aPos)
+{
+	m_mg = mg;
+	if(m_sh.valid())
+		m_sh->assign_grid(m_mg);
+	m_aPos = aPos;
+}
+
+template <class TElem, int dim>
+void Partitioner_Multilevel<TElem, dim>::
+set_subset_handler(SmartPtr<SubsetHandler> sh)
+{
+	m_sh = sh;
+	if(m_mg)
+		m_sh->assign_grid(m_mg);
+}
+
+template <class TElem, int dim>
+void Partitioner_Multilevel<TElem, dim>::
+set_communication_weights(SPCommunicationWeights commWeights)
+{
+	m_communicationWeights = commWeights;
+}
+
+
+////////////////////////////////
+//	PARTITIONING
+////////////////////////////////
+template <class TElem, int dim>
+bool Partitioner_Multilevel<TElem, dim>::
+partition(size_t baseLvl, size_t elementThreshold)
+{
+	UG_COND_THROW(m_mg && !m_mg->is_parallel(),
+			"Partitioner_Multilevel requires a parallel multigrid.");
+	return base_class::partition(baseLvl, elementThreshold);
+}
+
+
+template <class TElem, int dim>
+void Partitioner_Multilevel<TElem, dim>::
+partition_elements(int numTargetProcs, int partitionLvl, ANumber aWeight,
+				   pcl::ProcessCommunicator& com)
+{
+	GDIST_PROFILE_FUNC();
+
+	MultiGrid&		mg	= *m_mg;
+	SubsetHandler&	sh	= *m_sh;
+	Grid::AttachmentAccessor<elem_t, ANumber> aaWeight(mg, aWeight);
+
+//	the dual graph doesn't contain ghosts. Their partition is received
+//	from their vertical slaves later on.
+	ParallelDualGraph<elem_t, int> pdg(&mg);
+	pdg.generate_graph(partitionLvl, com);
+	pcl::ProcessCommunicator graphCom = pdg.process_communicator();
+
+	if(!graphCom.empty()){
+		const int numVrts = pdg.num_graph_vertices();
+		const int* offsetMap = pdg.parallel_offset_map();
+		vector<int> vrtOffsets(offsetMap, offsetMap + graphCom.size() + 1);
+		const int localOffset = vrtOffsets[graphCom.get_local_proc_id()];
+
+	//	split the dual graph into local and remote edges
+		WeightedGraph localGraph;
+		vector<RemoteEdge> remoteEdges;
+		localGraph.vrtWgt.resize(numVrts);
+		localGraph.adjStart.resize(numVrts + 1);
+		const int* adjStruct = pdg.adjacency_map_structure();
+		const int* adjMap = (pdg.num_graph_edges() > 0) ? pdg.adjacency_map() : NULL;
+
+		for(int i = 0; i < numVrts; ++i){
+			localGraph.vrtWgt[i] = aaWeight[pdg.get_element(i)];
+			localGraph.adjStart[i] = (int)localGraph.adj.size();
+			for(int e = adjStruct[i]; e < adjStruct[i + 1]; ++e){
+				number wgt = 1;
+				if(m_communicationWeights.valid()){
+					side_t* conn = pdg.get_connection(e);
+					if(m_communicationWeights->reweigh(conn))
+						wgt = m_communicationWeights->get_weight(conn);
+				}
+
+				const int globalVrt = adjMap[e];
+				if((globalVrt >= localOffset) && (globalVrt < localOffset + numVrts)){
+					localGraph.adj.push_back(globalVrt - localOffset);
+					localGraph.adjWgt.push_back(wgt);
+				}
+				else
+					remoteEdges.push_back(RemoteEdge(i, globalVrt, wgt));
+			}
+		}
+		localGraph.adjStart[numVrts] = (int)localGraph.adj.size();
+
+		vector<int> parts;
+		PartitionDistributedGraph(parts, localGraph, remoteEdges, vrtOffsets,
+								  numTargetProcs, m_imbalanceTolerance,
+								  max(m_maxGatheredVertices, 100 * numTargetProcs),
+								  m_numRefinementPasses, graphCom);
+
+		for(int i = 0; i < numVrts; ++i)
+			sh.assign_subset(pdg.get_element(i), parts[i]);
+	}
+}
+
+
+template class Partitioner_Multilevel<Edge, 1>;
+template class Partitioner_Multilevel<Edge, 2>;
+template class Partitioner_Multilevel<Face, 2>;
+template class Partitioner_Multilevel<Edge, 3>;
+template class Partitioner_Multilevel<Face, 3>;
+template class Partitioner_Multilevel<Volume, 3>;
+
+}// end of namespace
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__partitioner_multilevel__
+#define __H__UG__partitioner_multilevel__
+
+#include <vector>
+#include "parallel_grid_layout.h"
+#include "partitioner_hierarchical.h"
+
+namespace ug{
+
+/// \addtogroup lib_grid_parallelization_distribution
+///	\{
+
+///	Multilevel k-way graph partitioner operating on the parallel dual graph
+/**	The dual graph of the partition level is created through ParallelDualGraph.
+ * Graph vertices are weighted by the balance weights of the associated
+ * elements and their descendants, graph edges by the communication weights
+ * of the connecting sides (1 by default). The partitioner minimizes the
+ * weighted edge cut, i.e. the size of the resulting process interfaces.
+ *
+ * Partitioning is performed in three phases:
+ *	- Each process coarsens its local part of the graph through heavy edge
+ *	  matching, until the global graph is small enough to be gathered.
+ *	- The coarse graph is gathered on one process, where it is partitioned
+ *	  through recursive multilevel bisection (heavy edge matching, greedy
+ *	  graph growing and Fiduccia-Mattheyses refinement on each level). The
+ *	  result is smoothed through greedy k-way boundary refinement.
+ *	- The resulting partition is projected back onto the local graphs.
+ *
+ * The partitioner can be used inside a LoadBalancer or separately. It
+ * requires a parallel multigrid.
+ */
+template <class TElem, int dim>
+class Partitioner_Multilevel : public Partitioner_Hierarchical<TElem>{
+	public:
+		typedef Partitioner_Hierarchical<TElem>			base_class;
+		typedef TElem									elem_t;
+		typedef typename TElem::side					side_t;
+		typedef MathVector<dim>							vector_t;
+		typedef Attachment<vector_t>					apos_t;
+
+		Partitioner_Multilevel();
+		virtual ~Partitioner_Multilevel();
+
+		void set_grid(MultiGrid* mg, Attachment<MathVector<dim> > aPos);
+
+	///	allows to optionally specify a subset-handler on which the balancer shall operate
+		void set_subset_handler(SmartPtr<SubsetHandler> sh);
+
+	///	the tolerated relative excess of the weight of a partition over the average weight
+	/**	0.03 by default.*/
+		void set_imbalance_tolerance(number tol)	{m_imbalanceTolerance = tol;}
+		number imbalance_tolerance() const			{return m_imbalanceTolerance;}
+
+	///	the maximum number of vertices of the coarse graph which is gathered on one process
+	/**	The actual limit is at least 100 vertices per partition. 10000 by default.*/
+		void set_max_gathered_vertices(int num)		{m_maxGatheredVertices = num;}
+		int max_gathered_vertices() const			{return m_maxGatheredVertices;}
+
+	///	the maximum number of greedy k-way refinement passes. 8 by default.
+		void set_num_refinement_passes(int num)		{m_numRefinementPasses = num;}
+		int num_refinement_passes() const			{return m_numRefinementPasses;}
+
+		virtual void set_communication_weights(SPCommunicationWeights commWeights);
+
+		virtual bool supports_communication_weights() const		{return true;}
+		virtual bool supports_repartitioning() const			{return false;}
+
+		virtual bool partition(size_t baseLvl, size_t elementThreshold);
+
+	protected:
+		virtual void partition_elements(int numTargetProcs, int partitionLvl,
+										ANumber aWeight,
+										pcl::ProcessCommunicator& com);
+
+	private:
+		using base_class::m_mg;
+		using base_class::m_sh;
+
+		apos_t									m_aPos;
+		SPCommunicationWeights					m_communicationWeights;
+
+		number	m_imbalanceTolerance;
+		int		m_maxGatheredVertices;
+		int		m_numRefinementPasses;
+};
+
+///	\}
+
+}// end of namespace
+
+#endif
@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#include <algorithm>
+#include <limits>
+#include "partitioner_sfc.h"
+#include "load_balancer_util.h"
+#include "distributed_grid.h"
+#include "lib_grid/parallelization/parallelization_util.h"
+#include "lib_grid/algorithms/attachment_util.h"
+#include "lib_grid/algorithms/geom_obj_util/geom_obj_util.h"
+
+using namespace std;
+
+namespace ug{
+
+namespace{
+
+///	sorts indices of elements by their curve keys
+struct CompareKeys{
+	CompareKeys(const vector<uint64>& keys) : m_keys(keys)	{}
+	bool operator()(size_t i1, size_t i2) const
+	{
+		if(m_keys[i1] != m_keys[i2])
+			return m_keys[i1] < m_keys[i2];
+		return i1 < i2;
+	}
+	const vector<uint64>& m_keys;
+};
+
+///	sorts pieces by decreasing weight
+struct CompareWeightsDesc{
+	CompareWeightsDesc(const vector<number>& weights) : m_weights(weights)	{}
+	bool operator()(int i1, int i2) const
+	{
+		if(m_weights[i1] != m_weights[i2])
+			return m_weights[i1] > m_weights[i2];
+		return i1 < i2;
+	}
+	const vector<number>& m_weights;
+};
+
+///	finds numParts - 1 splitters which cut the curve into pieces of equal weight
+/**	sortedKeys and prefixWeights describe the local elements: prefixWeights[i]
+ * holds the accumulated weight of all elements with a key smaller than
+ * sortedKeys[i], prefixWeights.back() the total local weight.
+ *
+ * An element with key k belongs to piece i if splitters[i-1] < k <= splitters[i].
+ * All splitters are refined simultaneously, evaluating a histogram with
+ * 2^r bins around each splitter per global reduction.*/
+void FindWeightedSplitters(vector<uint64>& splittersOut,
+						   const vector<uint64>& sortedKeys,
+						   const vector<number>& prefixWeights,
+						   int numParts,
+						   pcl::ProcessCommunicator& com)
+{
+	const size_t numSplitters = (size_t)numParts - 1;
+	splittersOut.assign(numSplitters, 0);
+	if(numSplitters == 0)
+		return;
+
+	const number totalWeight = com.allreduce(prefixWeights.back(), PCL_RO_SUM);
+	if(totalWeight <= 0){
+		for(size_t i = 0; i < numSplitters; ++i)
+			splittersOut[i] = (numeric_limits<uint64>::max() / (uint64)numParts) * (i + 1);
+		return;
+	}
+
+	vector<number> targets(numSplitters);
+	for(size_t i = 0; i < numSplitters; ++i)
+		targets[i] = totalWeight * (number)(i + 1) / (number)numParts;
+
+//	the number of bits which are resolved per reduction. The size of the
+//	reduced buffers is bounded by 2^16 entries.
+	int bitsPerRound = 1;
+	while((bitsPerRound < 8) && ((numSplitters << (bitsPerRound + 1)) <= 65536))
+		++bitsPerRound;
+
+//	invariant: C(lo) < target <= C(lo + 2^numBits), where C(x) is the global
+//	weight of all elements with a key smaller than x.
+	vector<uint64>& lo = splittersOut;
+	vector<number> localHist, globalHist;
+	int numBits = 64;
+	while(numBits > 0){
+		const int r = min(bitsPerRound, numBits);
+		const size_t numProbes = ((size_t)1 << r) - 1;
+		const uint64 step = (uint64)1 << (numBits - r);
+
+		localHist.resize(numSplitters * numProbes);
+		for(size_t i = 0; i < numSplitters; ++i){
+			vector<uint64>::const_iterator first = sortedKeys.begin();
+			for(size_t j = 0; j < numProbes; ++j){
+				const uint64 probe = lo[i] + (uint64)(j + 1) * step;
+				first = lower_bound(first, sortedKeys.end(), probe);
+				localHist[i * numProbes + j] = prefixWeights[first - sortedKeys.begin()];
+			}
+		}
+
+		com.allreduce(localHist, globalHist, PCL_RO_SUM);
+
+		for(size_t i = 0; i < numSplitters; ++i){
+			size_t j = 0;
+			while((j < numProbes) && (globalHist[i * numProbes + j] < targets[i]))
+				++j;
+			lo[i] += (uint64)j * step;
+		}
+		numBits -= r;
+	}
+}
+
+}//	end of anonymous namespace
+
+
+template <class TElem, int dim>
+Partitioner_SFC<TElem, dim>::
+Partitioner_SFC() :
+	m_curve(SFC_HILBERT),
+	m_minimizeMigration(true)
+{
+}
+
+template <class TElem, int dim>
+Partitioner_SFC<TElem, dim>::
+~Partitioner_SFC()
+{
+}
+
+////////////////////////////////
+//	SETTERS AND GETTERS
+////////////////////////////////
+template <class TElem, int dim>
+void Partitioner_SFC<TElem, dim>::
+set_grid(MultiGrid* mg, Attachment<MathVector<dim> > aPos)
+{
+	m_mg = mg;
+	if(m_sh.valid())
+		m_sh->assign_grid(m_mg);
+	m_aPos = aPos;
+	m_aaPos.access(*m_mg, m_aPos);
+}
+
+template <class TElem, int dim>
+void Partitioner_SFC<TElem, dim>::
+set_subset_handler(SmartPtr<SubsetHandler> sh)
+{
+	m_sh = sh;
+	if(m_mg)
+		m_sh->assign_grid(m_mg);
+}
+
+
+////////////////////////////////
+//	PARTITIONING
+////////////////////////////////
+template <class TElem, int dim>
+void Partitioner_SFC<TElem, dim>::
+partition_elements(int numTargetProcs, int partitionLvl, ANumber aWeight,
+				   pcl::ProcessCommunicator& com)
+{
+	GDIST_PROFILE_FUNC();
+
+	typedef typename MultiGrid::traits<elem_t>::iterator iter_t;
+
+	MultiGrid&		mg	= *m_mg;
+	SubsetHandler&	sh	= *m_sh;
+	DistributedGridManager* pdgm = mg.distributed_grid_manager();
+	Grid::AttachmentAccessor<elem_t, ANumber> aaWeight(mg, aWeight);
+
+//	collect the elements which are to be partitioned. Ghosts are skipped, since
+//	their partition is received from their vertical slaves later on.
+	vector<elem_t*> elems;
+	elems.reserve(mg.num<elem_t>(partitionLvl));
+	for(iter_t eiter = mg.begin<elem_t>(partitionLvl);
+		eiter != mg.end<elem_t>(partitionLvl); ++eiter)
+	{
+		if((!pdgm) || (!pdgm->is_ghost(*eiter)))
+			elems.push_back(*eiter);
+	}
+
+//	global bounding box of all element centers
+	vector<number> boxMin(dim, numeric_limits<number>::max());
+	vector<number> boxMax(dim, -numeric_limits<number>::max());
+	vector<vector_t> centers(elems.size());
+	for(size_t i = 0; i < elems.size(); ++i){
+		centers[i] = CalculateCenter(elems[i], m_aaPos);
+		for(int d = 0; d < dim; ++d){
+			boxMin[d] = min(boxMin[d], centers[i][d]);
+			boxMax[d] = max(boxMax[d], centers[i][d]);
+		}
+	}
+
+	vector<number> gBoxMin, gBoxMax;
+	com.allreduce(boxMin, gBoxMin, PCL_RO_MIN);
+	com.allreduce(boxMax, gBoxMax, PCL_RO_MAX);
+	vector_t vBoxMin, vBoxMax;
+	for(int d = 0; d < dim; ++d){
+		vBoxMin[d] = gBoxMin[d];
+		vBoxMax[d] = gBoxMax[d];
+	}
+
+	vector<uint64> keys(elems.size());
+	for(size_t i = 0; i < elems.size(); ++i)
+		keys[i] = SFCIndex(m_curve, centers[i], vBoxMin, vBoxMax);
+
+	vector<size_t> order(elems.size());
+	for(size_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+	sort(order.begin(), order.end(), CompareKeys(keys));
+
+	vector<uint64> sortedKeys(elems.size());
+	vector<number> prefixWeights(elems.size() + 1, 0);
+	for(size_t i = 0; i < order.size(); ++i){
+		sortedKeys[i] = keys[order[i]];
+		prefixWeights[i + 1] = prefixWeights[i] + aaWeight[elems[order[i]]];
+	}
+
+	vector<uint64> splitters;
+	FindWeightedSplitters(splitters, sortedKeys, prefixWeights,
+						  numTargetProcs, com);
+
+//	pieces of the curve. Since sortedKeys is sorted, the pieces are ascending.
+	vector<int> pieces(elems.size());
+	vector<number> pieceWeights(numTargetProcs, 0);
+	size_t curPiece = 0;
+	for(size_t i = 0; i < order.size(); ++i){
+		while((curPiece < splitters.size()) && (splitters[curPiece] < sortedKeys[i]))
+			++curPiece;
+		pieces[order[i]] = (int)curPiece;
+		pieceWeights[curPiece] += aaWeight[elems[order[i]]];
+	}
+
+	vector<int> procs(numTargetProcs);
+	if(m_minimizeMigration)
+		map_pieces_to_processes(procs, pieceWeights, com);
+	else{
+		for(int i = 0; i < numTargetProcs; ++i)
+			procs[i] = i;
+	}
+
+	for(size_t i = 0; i < elems.size(); ++i)
+		sh.assign_subset(elems[i], procs[pieces[i]]);
+}
+
+
+template <class TElem, int dim>
+void Partitioner_SFC<TElem, dim>::
+map_pieces_to_processes(std::vector<int>& procsOut,
+						const std::vector<number>& localPieceWeights,
+						pcl::ProcessCommunicator& com)
+{
+	GDIST_PROFILE_FUNC();
+	const int numPieces = (int)localPieceWeights.size();
+	const int localProc = pcl::ProcRank();
+
+//	for each piece find the process which currently holds most of its weight.
+//	Only processes which are valid targets are considered.
+	vector<number> weights = localPieceWeights;
+	if(localProc >= numPieces)
+		weights.assign(numPieces, 0);
+
+	vector<number> maxWeights;
+	com.allreduce(weights, maxWeights, PCL_RO_MAX);
+
+	vector<int> candidates(numPieces, numPieces);
+	for(int i = 0; i < numPieces; ++i){
+		if((maxWeights[i] > 0) && (weights[i] == maxWeights[i]))
+			candidates[i] = localProc;
+	}
+
+	vector<int> gCandidates;
+	com.allreduce(candidates, gCandidates, PCL_RO_MIN);
+
+//	greedily assign the heaviest overlaps first. Remaining pieces are assigned
+//	to the remaining processes in ascending order. This is performed
+//	identically on all processes.
+	vector<int> pieceOrder(numPieces);
+	for(int i = 0; i < numPieces; ++i)
+		pieceOrder[i] = i;
+	sort(pieceOrder.begin(), pieceOrder.end(), CompareWeightsDesc(maxWeights));
+
+	procsOut.assign(numPieces, -1);
+	vector<bool> procUsed(numPieces, false);
+	for(int i = 0; i < numPieces; ++i){
+		const int piece = pieceOrder[i];
+		const int proc = gCandidates[piece];
+		if((proc < numPieces) && !procUsed[proc]){
+			procsOut[piece] = proc;
+			procUsed[proc] = true;
+		}
+	}
+
+	int nextFree = 0;
+	for(int i = 0; i < numPieces; ++i){
+		if(procsOut[i] != -1)
+			continue;
+		while(procUsed[nextFree])
+			++nextFree;
+		procsOut[i] = nextFree;
+		procUsed[nextFree] = true;
+	}
+}
+
+
+template class Partitioner_SFC<Edge, 1>;
+template class Partitioner_SFC<Edge, 2>;
+template class Partitioner_SFC<Face, 2>;
+template class Partitioner_SFC<Edge, 3>;
+template class Partitioner_SFC<Face, 3>;
+template class Partitioner_SFC<Volume, 3>;
+
+}// end of namespace
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__partitioner_sfc__
+#define __H__UG__partitioner_sfc__
+
+#include <string>
+#include <vector>
+#include "parallel_grid_layout.h"
+#include "partitioner_hierarchical.h"
+#include "lib_grid/algorithms/space_filling_curve_util.h"
+
+namespace ug{
+
+/// \addtogroup lib_grid_parallelization_distribution
+///	\{
+
+///	Parallel k-way partitioner which cuts a space filling curve into weighted pieces
+/**	The centers of all elements of the partition level are mapped onto a
+ * space filling curve (Hilbert by default) through the global bounding box.
+ * The curve is then cut into as many pieces as there are target processes,
+ * such that each piece carries the same accumulated balance weight. Splitters
+ * are found by a distributed histogram refinement which only requires a few
+ * global reductions, regardless of the number of elements.
+ *
+ * Since the curve is fixed in space, small changes in the weights only move
+ * the splitters slightly. This makes the partitioner well suited for cheap
+ * incremental repartitioning of adaptive grids. If migration minimization is
+ * enabled (default), the pieces are additionally assigned to those processes
+ * which already hold most of their weight.
+ *
+ * The partitioner can be used inside a LoadBalancer or separately. It can
+ * operate on serial and parallel multigrids and supports hierarchical
+ * redistribution through ProcessHierarchy.
+ */
+template <class TElem, int dim>
+class Partitioner_SFC : public Partitioner_Hierarchical<TElem>{
+	public:
+		typedef Partitioner_Hierarchical<TElem>			base_class;
+		typedef TElem									elem_t;
+		typedef MathVector<dim>							vector_t;
+		typedef Attachment<vector_t>					apos_t;
+		typedef Grid::VertexAttachmentAccessor<apos_t>	aapos_t;
+
+		Partitioner_SFC();
+		virtual ~Partitioner_SFC();
+
+		void set_grid(MultiGrid* mg, Attachment<MathVector<dim> > aPos);
+
+	///	allows to optionally specify a subset-handler on which the balancer shall operate
+		void set_subset_handler(SmartPtr<SubsetHandler> sh);
+
+	///	sets the space filling curve ("hilbert" or "morton"). Default is "hilbert".
+		void set_curve(const std::string& name)		{m_curve = StringToSFCType(name);}
+		std::string curve() const					{return SFCTypeToString(m_curve);}
+
+	///	assigns the pieces of the curve to the processes which already hold most of their weight
+	/**	enabled by default. If disabled, piece i is always sent to process i.*/
+		void enable_migration_minimization(bool enable)	{m_minimizeMigration = enable;}
+		bool migration_minimization_enabled() const		{return m_minimizeMigration;}
+
+		virtual bool supports_connection_weights() const		{return false;}
+		virtual bool supports_repartitioning() const			{return true;}
+
+	protected:
+		virtual void partition_elements(int numTargetProcs, int partitionLvl,
+										ANumber aWeight,
+										pcl::ProcessCommunicator& com);
+
+	private:
+	///	returns for each piece of the curve the process to which it shall be sent
+		void map_pieces_to_processes(std::vector<int>& procsOut,
+									 const std::vector<number>& localPieceWeights,
+									 pcl::ProcessCommunicator& com);
+
+		using base_class::m_mg;
+		using base_class::m_sh;
+
+		apos_t									m_aPos;
+		aapos_t									m_aaPos;
+
+		SFCType	m_curve;
+		bool	m_minimizeMigration;
+};
+
+///	\}
+
+}// end of namespace
+
+#endif
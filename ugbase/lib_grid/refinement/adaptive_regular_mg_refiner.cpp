@@ -97,6 +97,9 @@ create_closure_elements()
 
 	MultiGrid& mg = *multi_grid();
 
+//	new elements are allocated from the pools of the grid
+	GridObjectPoolScope poolScope(mg.object_pools());
+
 	if(mg.num<Volume>() > 0)
 		create_closure_elements_3d();
 	else if(mg.num<Face>() > 0)
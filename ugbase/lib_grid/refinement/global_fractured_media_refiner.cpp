@@ -200,6 +200,9 @@ perform_refinement()
 
 	MultiGrid& mg = *m_pMG;
 
+//	new elements are allocated from the pools of the grid
+	GridObjectPoolScope poolScope(mg.object_pools());
+
 //	adjust marks for refinement
 	adjust_marks();
 
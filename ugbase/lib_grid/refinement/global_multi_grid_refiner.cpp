@@ -30,12 +30,17 @@
  * GNU Lesser General Public License for more details.
  */
 
+#include <algorithm>
 #include <cassert>
 #include "common/profiler/profiler.h"
 #include "global_multi_grid_refiner.h"
 #include "lib_grid/algorithms/algorithms.h"
 #include "lib_grid/file_io/file_io.h"
 
+#ifdef UG_OPENMP
+	#include <omp.h>
+#endif
+
 //define PROFILE_GLOBAL_MULTI_GRID_REFINER if you want to profile
 //the refinement code.
 #define PROFILE_GLOBAL_MULTI_GRID_REFINER
@@ -57,13 +62,15 @@ namespace ug
 GlobalMultiGridRefiner::
 GlobalMultiGridRefiner(SPRefinementProjector projector) :
 	IRefiner(projector),
-	m_pMG(NULL)
+	m_pMG(NULL),
+	m_bThreaded(true)
 {
 }
 
 GlobalMultiGridRefiner::
 GlobalMultiGridRefiner(MultiGrid& mg, SPRefinementProjector projector) :
-	IRefiner(projector)
+	IRefiner(projector),
+	m_bThreaded(true)
 {
 	m_pMG = NULL;
 	assign_grid(mg);
@@ -145,6 +152,9 @@ void GlobalMultiGridRefiner::perform_refinement()
 //	the multi-grid
 	MultiGrid& mg = *m_pMG;
 
+//	new elements are allocated from the pools of the grid
+	GridObjectPoolScope poolScope(mg.object_pools());
+
 //	make sure that the required options are enabled.
 	if(mg.num_volumes() > 0){
 		if(!mg.option_is_enabled(VOLOPT_AUTOGENERATE_FACES))
@@ -231,19 +241,6 @@ void GlobalMultiGridRefiner::perform_refinement()
 		mg.enable_hierarchical_insertion(true);
 
 
-//	some buffers
-	vector<Vertex*> vVrts;
-	vector<Vertex*> vEdgeVrts;
-	vector<Vertex*> vFaceVrts;
-	vector<Edge*>	vEdges;
-	vector<Face*>		vFaces;
-	vector<Volume*>		vVols;
-	
-//	some repeatedly used objects
-	EdgeDescriptor ed;
-	FaceDescriptor fd;
-	VolumeDescriptor vd;
-
 	UG_DLOG(LIB_GRID, 1, "  creating new vertices\n");
 
 //	create new vertices from marked vertices
@@ -266,6 +263,43 @@ void GlobalMultiGridRefiner::perform_refinement()
 	}
 
 
+	bool bThreaded = false;
+	#ifdef UG_OPENMP
+		bThreaded = m_bThreaded && (omp_get_max_threads() > 1);
+	#endif
+
+	if(bThreaded){
+		UG_DLOG(LIB_GRID, 1, "  creating new edges, faces and volumes (threaded)\n");
+		refine_edges_threaded(oldTopLevel);
+		refine_faces_threaded(oldTopLevel);
+		refine_volumes_threaded(oldTopLevel);
+	}
+	else{
+		refine_edges(oldTopLevel);
+		refine_faces(oldTopLevel);
+		refine_volumes(oldTopLevel);
+	}
+
+//	done - clean up
+	if(!bHierarchicalInsertionWasEnabled)
+		mg.enable_hierarchical_insertion(false);
+
+//	notify derivates that refinement ends
+	refinement_step_ends();
+
+	projector()->refinement_ends();
+	m_messageHub->post_message(GridMessage_Adaption(GMAT_GLOBAL_REFINEMENT_ENDS,
+													mg.get_grid_objects(oldTopLevel)));
+
+	UG_DLOG(LIB_GRID, 1, "  refinement done.");
+}
+
+void GlobalMultiGridRefiner::refine_edges(int oldTopLevel)
+{
+	GMGR_PROFILE_FUNC();
+	MultiGrid& mg = *m_pMG;
+	vector<Edge*>	vEdges;
+
 	UG_DLOG(LIB_GRID, 1, "  creating new edges\n");
 
 //	create new vertices and edges from marked edges
@@ -325,7 +359,15 @@ void GlobalMultiGridRefiner::perform_refinement()
 		mg.register_element(vEdges[1], e);
 		//GMGR_PROFILE_END();
 	}
+}
 
+void GlobalMultiGridRefiner::refine_faces(int oldTopLevel)
+{
+	GMGR_PROFILE_FUNC();
+	MultiGrid& mg = *m_pMG;
+	vector<Vertex*> vVrts;
+	vector<Vertex*> vEdgeVrts;
+	vector<Face*>		vFaces;
 
 	UG_DLOG(LIB_GRID, 1, "  creating new faces\n");
 
@@ -370,7 +412,16 @@ void GlobalMultiGridRefiner::perform_refinement()
 		}
 		//GMGR_PROFILE_END();
 	}
+}
 
+void GlobalMultiGridRefiner::refine_volumes(int oldTopLevel)
+{
+	GMGR_PROFILE_FUNC();
+	MultiGrid& mg = *m_pMG;
+	vector<Vertex*> vVrts;
+	vector<Vertex*> vEdgeVrts;
+	vector<Vertex*> vFaceVrts;
+	vector<Volume*>		vVols;
 
 	UG_DLOG(LIB_GRID, 1, "  creating new volumes\n");
 
@@ -446,19 +497,283 @@ void GlobalMultiGridRefiner::perform_refinement()
 		}
 		//GMGR_PROFILE_END();
 	}
+}
 
-//	done - clean up
-	if(!bHierarchicalInsertionWasEnabled)
-		mg.enable_hierarchical_insertion(false);
+////////////////////////////////////////////////////////////////////////
+//	threaded refinement
+namespace{
 
-//	notify derivates that refinement ends
-	refinement_step_ends();
+///	a refined parent and the range of its children in the arena of its chunk
+template <class TElem>
+struct RefinedParentInfo
+{
+	TElem*		parent;
+	Vertex*		newVrt;
+	size_t		firstChild;
+	size_t		numChildren;
+	bool		success;
+};
+
+///	children which were created for a contiguous range of parents of the same base type
+template <class TElem>
+struct RefinementArena
+{
+	std::vector<TElem*>				children;
+	std::vector<RefinedParentInfo<TElem> >	infos;
+};
+
+///	Splits the parents into contiguous chunks and refines each chunk in a separate task.
+/**	TRefineFunc has to provide
+ * \code
+ * bool operator()(std::vector<TElem*>& childrenOut, Vertex*& newVrtOut, TElem* parent)
+ * \endcode
+ * It may only read from the grid. Each chunk works on its own copy of
+ * refineFunc, so that buffers of the functor are not shared between threads.
+ * The functor must thus not hold smart pointers: copying them in the worker
+ * threads would modify their reference counts, which are not thread safe.
+ * Each thread allocates the new elements from its own thread pools of the
+ * given grid object pools, so that allocation needs no synchronization.
+ * numChildrenPerParent is only used to reserve memory in the arenas.*/
+template <class TElem, class TRefineFunc>
+void RefineInChunks(std::vector<RefinementArena<TElem> >& arenasOut,
+					const std::vector<TElem*>& parents,
+					const TRefineFunc& refineFunc,
+					size_t numChildrenPerParent,
+					GridObjectPools& pools)
+{
+	const size_t numParents = parents.size();
+	size_t numThreads = 1;
+	#ifdef UG_OPENMP
+		numThreads = (size_t)omp_get_max_threads();
+	#endif
+//	more chunks than threads for a better load balance
+	size_t numChunks = 4 * numThreads;
+	numChunks = std::max<size_t>(1, std::min(numChunks, numParents));
+	pools.reserve_thread_pools(numThreads);
+
+	arenasOut.clear();
+	arenasOut.resize(numChunks);
+
+	#ifdef UG_OPENMP
+	#pragma omp parallel for schedule(dynamic)
+	#endif
+	for(int c = 0; c < (int)numChunks; ++c)
+	{
+		const size_t iBegin = (size_t)c * numParents / numChunks;
+		const size_t iEnd = (size_t)(c + 1) * numParents / numChunks;
+
+		int thread = 0;
+		#ifdef UG_OPENMP
+			thread = omp_get_thread_num();
+		#endif
+		GridObjectPoolScope poolScope(pools.thread_pools(thread));
+
+		RefinementArena<TElem>& arena = arenasOut[c];
+		arena.children.reserve((iEnd - iBegin) * numChildrenPerParent);
+		arena.infos.reserve(iEnd - iBegin);
+
+		TRefineFunc func(refineFunc);
+		std::vector<TElem*> vChildren;
+		for(size_t i = iBegin; i < iEnd; ++i){
+			RefinedParentInfo<TElem> info;
+			info.parent = parents[i];
+			info.newVrt = NULL;
+			info.firstChild = arena.children.size();
+			vChildren.clear();
+			info.success = func(vChildren, info.newVrt, parents[i]);
+			info.numChildren = vChildren.size();
+			arena.children.insert(arena.children.end(),
+								  vChildren.begin(), vChildren.end());
+			arena.infos.push_back(info);
+		}
+	}
+}
 
-	projector()->refinement_ends();
-	m_messageHub->post_message(GridMessage_Adaption(GMAT_GLOBAL_REFINEMENT_ENDS,
-													mg.get_grid_objects(oldTopLevel)));
+///	registers new vertices and children of all arenas in the order of their parents
+template <class TElem>
+void RegisterRefinedChildren(MultiGrid& mg, SPRefinementProjector projector,
+							 std::vector<RefinementArena<TElem> >& arenas,
+							 const char* warning)
+{
+	for(size_t c = 0; c < arenas.size(); ++c){
+		RefinementArena<TElem>& arena = arenas[c];
+		for(size_t i = 0; i < arena.infos.size(); ++i){
+			const RefinedParentInfo<TElem>& info = arena.infos[i];
+			if(!info.success){
+				LOG(warning);
+				continue;
+			}
 
-	UG_DLOG(LIB_GRID, 1, "  refinement done.");
+			if(info.newVrt){
+				mg.register_element(info.newVrt, info.parent);
+			//	allow refCallback to calculate a new position
+				if(projector.valid())
+					projector->new_vertex(info.newVrt, info.parent);
+			}
+
+			for(size_t j = 0; j < info.numChildren; ++j)
+				mg.register_element(arena.children[info.firstChild + j], info.parent);
+		}
+
+	//	release the memory of the arena early
+		std::vector<TElem*>().swap(arena.children);
+		std::vector<RefinedParentInfo<TElem> >().swap(arena.infos);
+	}
+}
+
+struct RefineEdgeFunc
+{
+	RefineEdgeFunc(MultiGrid& mg) : m_mg(mg)	{}
+
+	bool operator()(std::vector<Edge*>& childrenOut, Vertex*& newVrtOut, Edge* e)
+	{
+		newVrtOut = new RegularVertex;
+		Vertex* substituteVrts[2];
+		substituteVrts[0] = m_mg.get_child_vertex(e->vertex(0));
+		substituteVrts[1] = m_mg.get_child_vertex(e->vertex(1));
+		if(e->refine(childrenOut, newVrtOut, substituteVrts))
+			return true;
+
+		delete newVrtOut;
+		newVrtOut = NULL;
+		return false;
+	}
+
+	MultiGrid&	m_mg;
+};
+
+struct RefineFaceFunc
+{
+	RefineFaceFunc(MultiGrid& mg) : m_mg(mg)	{}
+
+	bool operator()(std::vector<Face*>& childrenOut, Vertex*& newVrtOut, Face* f)
+	{
+		m_vVrts.clear();
+		for(size_t j = 0; j < f->num_vertices(); ++j)
+			m_vVrts.push_back(m_mg.get_child_vertex(f->vertex(j)));
+
+		m_vEdgeVrts.clear();
+		for(size_t j = 0; j < f->num_edges(); ++j)
+			m_vEdgeVrts.push_back(m_mg.get_child_vertex(m_mg.get_edge(f, j)));
+
+		return f->refine(childrenOut, &newVrtOut, &m_vEdgeVrts.front(),
+						 NULL, &m_vVrts.front());
+	}
+
+	MultiGrid&				m_mg;
+	std::vector<Vertex*>	m_vVrts;
+	std::vector<Vertex*>	m_vEdgeVrts;
+};
+
+struct RefineVolumeFunc
+{
+	RefineVolumeFunc(MultiGrid& mg, const IGeometry3d* geom) :
+		m_mg(mg), m_geom(geom), m_corners(6, vector3(0, 0, 0))	{}
+
+	bool operator()(std::vector<Volume*>& childrenOut, Vertex*& newVrtOut, Volume* v)
+	{
+		m_vVrts.clear();
+		for(size_t j = 0; j < v->num_vertices(); ++j)
+			m_vVrts.push_back(m_mg.get_child_vertex(v->vertex(j)));
+
+		m_vEdgeVrts.clear();
+		for(size_t j = 0; j < v->num_edges(); ++j)
+			m_vEdgeVrts.push_back(m_mg.get_child_vertex(m_mg.get_edge(v, j)));
+
+		m_vFaceVrts.clear();
+		for(size_t j = 0; j < v->num_faces(); ++j)
+			m_vFaceVrts.push_back(m_mg.get_child_vertex(m_mg.get_face(v, j)));
+
+	//	tetrahedral and octahedral refinement choose the best interior diagonal
+	//	based on the corner coordinates.
+		vector3* pCorners = NULL;
+		if(m_geom
+		   && ((v->num_vertices() == 4)
+			   || (v->reference_object_id() == ROID_OCTAHEDRON)))
+		{
+			for(size_t i = 0; i < v->num_vertices(); ++i)
+				m_corners[i] = m_geom->pos(v->vertex(i));
+			pCorners = &m_corners.front();
+		}
+
+		return v->refine(childrenOut, &newVrtOut, &m_vEdgeVrts.front(),
+						 &m_vFaceVrts.front(), NULL, RegularVertex(),
+						 &m_vVrts.front(), pCorners);
+	}
+
+	MultiGrid&				m_mg;
+	const IGeometry3d*		m_geom;
+	std::vector<vector3>	m_corners;
+	std::vector<Vertex*>	m_vVrts;
+	std::vector<Vertex*>	m_vEdgeVrts;
+	std::vector<Vertex*>	m_vFaceVrts;
+};
+
+}//	end of anonymous namespace
+
+
+void GlobalMultiGridRefiner::refine_edges_threaded(int lvl)
+{
+	GMGR_PROFILE_FUNC();
+	MultiGrid& mg = *m_pMG;
+
+//	refinement_is_allowed is not required to be thread safe
+	vector<Edge*> vParents;
+	vParents.reserve(mg.num<Edge>(lvl));
+	for(EdgeIterator iter = mg.begin<Edge>(lvl); iter != mg.end<Edge>(lvl); ++iter){
+		if(refinement_is_allowed(*iter))
+			vParents.push_back(*iter);
+	}
+
+	vector<RefinementArena<Edge> > arenas;
+	RefineInChunks(arenas, vParents, RefineEdgeFunc(mg), 2, mg.object_pools());
+	RegisterRefinedChildren(mg, m_projector, arenas,
+							"  WARNING in Refine: could not refine edge.\n");
+}
+
+void GlobalMultiGridRefiner::refine_faces_threaded(int lvl)
+{
+	GMGR_PROFILE_FUNC();
+	MultiGrid& mg = *m_pMG;
+
+//	refinement_is_allowed is not required to be thread safe
+	vector<Face*> vParents;
+	vParents.reserve(mg.num<Face>(lvl));
+	for(FaceIterator iter = mg.begin<Face>(lvl); iter != mg.end<Face>(lvl); ++iter){
+		if(refinement_is_allowed(*iter))
+			vParents.push_back(*iter);
+	}
+
+	vector<RefinementArena<Face> > arenas;
+	RefineInChunks(arenas, vParents, RefineFaceFunc(mg), 4, mg.object_pools());
+	RegisterRefinedChildren(mg, m_projector, arenas,
+							"  WARNING in Refine: could not refine face.\n");
+}
+
+void GlobalMultiGridRefiner::refine_volumes_threaded(int lvl)
+{
+	GMGR_PROFILE_FUNC();
+	MultiGrid& mg = *m_pMG;
+
+//	refinement_is_allowed is not required to be thread safe
+	vector<Volume*> vParents;
+	vParents.reserve(mg.num<Volume>(lvl));
+	for(VolumeIterator iter = mg.begin<Volume>(lvl); iter != mg.end<Volume>(lvl); ++iter){
+		if(refinement_is_allowed(*iter))
+			vParents.push_back(*iter);
+	}
+
+//	the workers only read corner positions through a raw pointer. The smart
+//	pointer to the geometry is held here, on the calling thread.
+	SPIGeometry3d geom;
+	if(m_projector.valid())
+		geom = m_projector->geometry();
+
+	vector<RefinementArena<Volume> > arenas;
+	RefineInChunks(arenas, vParents, RefineVolumeFunc(mg, geom.get()), 8,
+				   mg.object_pools());
+	RegisterRefinedChildren(mg, m_projector, arenas,
+							"  WARNING in Refine: could not refine volume.\n");
 }
 
 bool GlobalMultiGridRefiner::save_marks_to_file(const char* filename)
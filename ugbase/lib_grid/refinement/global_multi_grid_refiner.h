@@ -67,6 +67,19 @@ class GlobalMultiGridRefiner : public IRefiner, public GridObserver
 
 		virtual bool save_marks_to_file(const char* filename);
 
+	///	enables or disables the threaded refinement path.
+	/**	If enabled and if ug was compiled with OpenMP, the children of the
+	 * edges, faces and volumes of the top level are created by several threads.
+	 * Each thread stores the children of a contiguous range of parents in its
+	 * own buffer and allocates them from its own pools of the multi-grid
+	 * (see GridObjectPools::thread_pools). Registration at the multi-grid,
+	 * calls to the refinement projector and calls to refinement_is_allowed
+	 * are performed by the calling thread in the order of the parent
+	 * elements, so that the resulting grid is the same as with serial
+	 * refinement, independent of the number of threads. Enabled by default.*/
+		void enable_threaded_refinement(bool enable)	{m_bThreaded = enable;}
+		bool threaded_refinement_enabled() const		{return m_bThreaded;}
+
 	protected:
 	///	returns the number of (globally) marked edges on this level of the hierarchy
 		virtual void num_marked_edges_local(std::vector<int>& numMarkedEdgesOut);
@@ -104,9 +117,25 @@ class GlobalMultiGridRefiner : public IRefiner, public GridObserver
 	 *	start a new iteration, if new elements had been marked during refine.
 	 *	Default implementation is empty.*/
 		virtual void refinement_step_ends()		{};
-		
+
+	///	creates the children of the edges, faces and volumes of the given level.
+	/**	\{ */
+		void refine_edges(int oldTopLevel);
+		void refine_faces(int oldTopLevel);
+		void refine_volumes(int oldTopLevel);
+	/** \} */
+
+	///	creates the children of the edges, faces and volumes of the given level in parallel.
+	/**	The new elements are registered in the order of their parents.
+	 * \{ */
+		void refine_edges_threaded(int lvl);
+		void refine_faces_threaded(int lvl);
+		void refine_volumes_threaded(int lvl);
+	/** \} */
+
 	protected:
 		MultiGrid*	m_pMG;
+		bool		m_bThreaded;
 };
 
 /// @}
@@ -653,6 +653,9 @@ void HangingNodeRefinerBase<TSelector>::perform_refinement()
 
 	Grid& grid = *m_pGrid;
 
+//	new elements are allocated from the pools of the grid
+	GridObjectPoolScope poolScope(grid.object_pools());
+
 //	check grid options.
 	if(!grid.option_is_enabled(GRIDOPT_AUTOGENERATE_SIDES))
 	{
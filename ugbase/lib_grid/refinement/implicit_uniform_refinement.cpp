@@ -0,0 +1,775 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#include <algorithm>
+#include <fstream>
+#include "implicit_uniform_refinement.h"
+#include "global_multi_grid_refiner.h"
+#include "projectors/refinement_projector.h"
+#include "common/error.h"
+#include "common/log.h"
+#include "lib_grid/multi_grid.h"
+#include "lib_grid/grid_objects/grid_objects.h"
+
+using namespace std;
+
+namespace ug{
+
+namespace{
+
+///	corners of the reference elements in the corner order of the grid objects
+size_t GetReferenceCorners(vector3* cornersOut, ReferenceObjectID roid)
+{
+	static const number edge[2][3] = {{0, 0, 0}, {1, 0, 0}};
+	static const number tri[3][3] = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}};
+	static const number quad[4][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+	static const number tet[4][3] = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+	static const number hex[8][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+									 {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}};
+
+	const number (*c)[3];
+	size_t num;
+	switch(roid){
+		case ROID_EDGE:				c = edge; num = 2; break;
+		case ROID_TRIANGLE:			c = tri; num = 3; break;
+		case ROID_QUADRILATERAL:	c = quad; num = 4; break;
+		case ROID_TETRAHEDRON:		c = tet; num = 4; break;
+		case ROID_HEXAHEDRON:		c = hex; num = 8; break;
+		default:
+			UG_THROW("ImplicitUniformRefinement: Unsupported element type: " << roid);
+	}
+
+	for(size_t i = 0; i < num; ++i)
+		cornersOut[i] = vector3(c[i][0], c[i][1], c[i][2]);
+	return num;
+}
+
+inline size_t NumReferenceCorners(ReferenceObjectID roid)
+{
+	vector3 corners[MAX_VOLUME_VERTICES];
+	return GetReferenceCorners(corners, roid);
+}
+
+///	interpolation weights of the corners at the lattice point x (in units of 1/n)
+/**	The weights of simplices sum up to n, the weights of tensor product
+ * elements to n^dim.*/
+void LatticeWeights(int64* wOut, ReferenceObjectID roid, const int64* x, int64 n)
+{
+	switch(roid){
+		case ROID_EDGE:
+			wOut[0] = n - x[0];	wOut[1] = x[0];
+			break;
+		case ROID_TRIANGLE:
+			wOut[0] = n - x[0] - x[1];	wOut[1] = x[0];	wOut[2] = x[1];
+			break;
+		case ROID_TETRAHEDRON:
+			wOut[0] = n - x[0] - x[1] - x[2];
+			wOut[1] = x[0];	wOut[2] = x[1];	wOut[3] = x[2];
+			break;
+		case ROID_QUADRILATERAL:
+		case ROID_HEXAHEDRON:
+		{
+			wOut[0] = (n - x[0]) * (n - x[1]);
+			wOut[1] = x[0] * (n - x[1]);
+			wOut[2] = x[0] * x[1];
+			wOut[3] = (n - x[0]) * x[1];
+			if(roid == ROID_HEXAHEDRON){
+				for(int i = 0; i < 4; ++i){
+					wOut[i + 4] = wOut[i] * x[2];
+					wOut[i] *= n - x[2];
+				}
+			}
+		}break;
+		default:
+			UG_THROW("ImplicitUniformRefinement: Unsupported element type: " << roid);
+	}
+}
+
+///	index of the inner lattice point (a, b, n - a - b) of a triangle
+inline size_t InnerTriangleIndex(int64 a, int64 b, int64 n)
+{
+	return (size_t)((a - 1) * (n - 1) - ((a - 1) * a) / 2 + b - 1);
+}
+
+template <class TElem>
+void CollectCoarseElements(std::vector<TElem*>& elemsOut, Grid& g)
+{
+	elemsOut.clear();
+	if(MultiGrid* mg = dynamic_cast<MultiGrid*>(&g)){
+		if(mg->num_levels() == 0)
+			return;
+		const int lvl = mg->top_level();
+		elemsOut.assign(mg->begin<TElem>(lvl), mg->end<TElem>(lvl));
+	}
+	else
+		elemsOut.assign(g.begin<TElem>(), g.end<TElem>());
+}
+
+///	index of the given vertex in the corner array
+inline int LocalCornerIndex(Vertex* const* corners, int numCorners, Vertex* v)
+{
+	for(int i = 0; i < numCorners; ++i){
+		if(corners[i] == v)
+			return i;
+	}
+	UG_THROW("ImplicitUniformRefinement: Vertex is not a corner of the element.");
+}
+
+///	appends the corners of all elements on the given level to childCornersOut
+template <class TElem>
+void CollectTemplateChildren(std::vector<int>& childCornersOut, MultiGrid& mg,
+							 int lvl, ReferenceObjectID roid,
+							 Grid::VertexAttachmentAccessor<AInt>& aaIndex)
+{
+	typedef typename geometry_traits<TElem>::iterator	iter_t;
+	for(iter_t iter = mg.begin<TElem>(lvl); iter != mg.end<TElem>(lvl); ++iter){
+		TElem* e = *iter;
+		UG_COND_THROW(e->reference_object_id() != roid,
+					  "ImplicitUniformRefinement: Refinement of element type " << roid
+					  << " produced children of type " << e->reference_object_id());
+		for(size_t i = 0; i < e->num_vertices(); ++i)
+			childCornersOut.push_back(aaIndex[e->vertex(i)]);
+	}
+}
+
+}//	end of anonymous namespace
+
+
+ImplicitUniformRefinement::
+ImplicitUniformRefinement() :
+	m_pGrid(NULL),
+	m_dim(0)
+{
+}
+
+ImplicitUniformRefinement::
+ImplicitUniformRefinement(SPIGeometry3d geom, int numLevels) :
+	m_pGrid(NULL),
+	m_dim(0)
+{
+	init(geom, numLevels);
+}
+
+ImplicitUniformRefinement::
+~ImplicitUniformRefinement()
+{
+	clear();
+}
+
+void ImplicitUniformRefinement::
+clear()
+{
+	if(m_pGrid){
+		m_aaVrtIndex.invalidate();
+		m_aaEdgeIndex.invalidate();
+		m_aaFaceIndex.invalidate();
+		if(m_pGrid->has_vertex_attachment(m_aIndex))
+			m_pGrid->detach_from_vertices(m_aIndex);
+		if(m_pGrid->has_edge_attachment(m_aIndex))
+			m_pGrid->detach_from_edges(m_aIndex);
+		if(m_pGrid->has_face_attachment(m_aIndex))
+			m_pGrid->detach_from_faces(m_aIndex);
+	}
+
+	m_geom = SPNULL;
+	m_pGrid = NULL;
+	m_dim = 0;
+	m_levels.clear();
+	m_coarseVrts.clear();
+	m_coarseEdges.clear();
+	m_coarseFaces.clear();
+	m_coarseVols.clear();
+	m_coarseElems.clear();
+}
+
+void ImplicitUniformRefinement::
+init(SPIGeometry3d geom, int numLevels)
+{
+	UG_COND_THROW(geom.invalid(), "ImplicitUniformRefinement: Invalid geometry.");
+	UG_COND_THROW(numLevels < 0 || numLevels > 16,
+				  "ImplicitUniformRefinement: Invalid number of levels: " << numLevels);
+
+	clear();
+	m_geom = geom;
+	m_pGrid = &geom->grid();
+	Grid& g = *m_pGrid;
+
+	CollectCoarseElements(m_coarseVrts, g);
+	CollectCoarseElements(m_coarseEdges, g);
+	CollectCoarseElements(m_coarseFaces, g);
+	CollectCoarseElements(m_coarseVols, g);
+
+	if(!m_coarseVols.empty()){
+		m_dim = 3;
+		m_coarseElems.assign(m_coarseVols.begin(), m_coarseVols.end());
+	}
+	else if(!m_coarseFaces.empty()){
+		m_dim = 2;
+		m_coarseElems.assign(m_coarseFaces.begin(), m_coarseFaces.end());
+	}
+	else if(!m_coarseEdges.empty()){
+		m_dim = 1;
+		m_coarseElems.assign(m_coarseEdges.begin(), m_coarseEdges.end());
+	}
+	else{
+		clear();
+		UG_THROW("ImplicitUniformRefinement: The grid does not contain any elements.");
+	}
+
+//	only sides of elements are shared and thus require a global numbering
+	if(m_dim < 3)
+		m_coarseFaces.clear();
+	if(m_dim < 2)
+		m_coarseEdges.clear();
+
+	g.attach_to_vertices(m_aIndex);
+	m_aaVrtIndex.access(g, m_aIndex);
+	for(size_t i = 0; i < m_coarseVrts.size(); ++i)
+		m_aaVrtIndex[m_coarseVrts[i]] = (int)i;
+
+	if(m_dim >= 2){
+		g.attach_to_edges(m_aIndex);
+		m_aaEdgeIndex.access(g, m_aIndex);
+		for(size_t i = 0; i < m_coarseEdges.size(); ++i)
+			m_aaEdgeIndex[m_coarseEdges[i]] = (int)i;
+	}
+
+	if(m_dim == 3){
+		g.attach_to_faces(m_aIndex);
+		m_aaFaceIndex.access(g, m_aIndex);
+		for(size_t i = 0; i < m_coarseFaces.size(); ++i)
+			m_aaFaceIndex[m_coarseFaces[i]] = (int)i;
+	}
+
+//	create the templates of all element types
+	m_levels.resize(numLevels + 1);
+	vector<bool> roidFound(NUM_REFERENCE_OBJECTS, false);
+	for(size_t i = 0; i < m_coarseElems.size(); ++i)
+		roidFound[m_coarseElems[i]->reference_object_id()] = true;
+	for(int i = 0; i < NUM_REFERENCE_OBJECTS; ++i){
+		if(roidFound[i])
+			create_templates((ReferenceObjectID)i, numLevels);
+	}
+
+//	offsets of the vertices and elements of each level
+	for(int l = 0; l <= numLevels; ++l){
+		Level& lvl = m_levels[l];
+		lvl.n = (int64)1 << l;
+		const size_t numInnerEdgeVrts = (size_t)(lvl.n - 1);
+
+		size_t curVrt = m_coarseVrts.size() + m_coarseEdges.size() * numInnerEdgeVrts;
+
+		lvl.faceOffsets.resize(m_coarseFaces.size() + 1);
+		for(size_t i = 0; i < m_coarseFaces.size(); ++i){
+			lvl.faceOffsets[i] = curVrt;
+			if(m_coarseFaces[i]->num_vertices() == 3)
+				curVrt += numInnerEdgeVrts * (numInnerEdgeVrts - 1) / 2;
+			else
+				curVrt += numInnerEdgeVrts * numInnerEdgeVrts;
+		}
+		lvl.faceOffsets.back() = curVrt;
+
+		size_t curElem = 0;
+		lvl.innerOffsets.resize(m_coarseElems.size() + 1);
+		lvl.elemOffsets.resize(m_coarseElems.size() + 1);
+		for(size_t i = 0; i < m_coarseElems.size(); ++i){
+			const Template& t = lvl.templates[m_coarseElems[i]->reference_object_id()];
+			lvl.innerOffsets[i] = curVrt;
+			lvl.elemOffsets[i] = curElem;
+			curVrt += t.innerVrts.size();
+			curElem += t.num_children();
+		}
+		lvl.innerOffsets.back() = curVrt;
+		lvl.elemOffsets.back() = curElem;
+		lvl.numVertices = curVrt;
+	}
+}
+
+void ImplicitUniformRefinement::
+create_templates(ReferenceObjectID roid, int numLevels)
+{
+//	refine the reference element on a scratch grid
+	MultiGrid mg(GRIDOPT_STANDARD_INTERCONNECTION | GRIDOPT_AUTOGENERATE_SIDES);
+	mg.attach_to_vertices(aPosition);
+	Grid::VertexAttachmentAccessor<APosition> aaPos(mg, aPosition);
+
+	vector3 refCorners[MAX_VOLUME_VERTICES];
+	const int numCorners = (int)GetReferenceCorners(refCorners, roid);
+	Vertex* vrts[MAX_VOLUME_VERTICES];
+	for(int i = 0; i < numCorners; ++i){
+		vrts[i] = *mg.create<RegularVertex>();
+		aaPos[vrts[i]] = refCorners[i];
+	}
+
+	switch(roid){
+		case ROID_EDGE:
+			mg.create<RegularEdge>(EdgeDescriptor(vrts[0], vrts[1]));
+			break;
+		case ROID_TRIANGLE:
+			mg.create<Triangle>(TriangleDescriptor(vrts[0], vrts[1], vrts[2]));
+			break;
+		case ROID_QUADRILATERAL:
+			mg.create<Quadrilateral>(QuadrilateralDescriptor(vrts[0], vrts[1],
+															 vrts[2], vrts[3]));
+			break;
+		case ROID_TETRAHEDRON:
+			mg.create<Tetrahedron>(TetrahedronDescriptor(vrts[0], vrts[1],
+														 vrts[2], vrts[3]));
+			break;
+		case ROID_HEXAHEDRON:
+			mg.create<Hexahedron>(HexahedronDescriptor(vrts[0], vrts[1], vrts[2], vrts[3],
+													   vrts[4], vrts[5], vrts[6], vrts[7]));
+			break;
+		default:
+			UG_THROW("ImplicitUniformRefinement: Unsupported element type: " << roid);
+	}
+
+	GlobalMultiGridRefiner refiner(mg, make_sp(new RefinementProjector(
+												MakeGeometry3d(mg, aPosition))));
+
+	AInt aTmpIndex;
+	mg.attach_to_vertices(aTmpIndex);
+	Grid::VertexAttachmentAccessor<AInt> aaTmpIndex(mg, aTmpIndex);
+
+	for(int l = 0; l <= numLevels; ++l){
+		if(l > 0)
+			refiner.refine();
+
+		const int64 n = (int64)1 << l;
+		Template& t = m_levels[l].templates[roid];
+		t.roid = roid;
+		t.numCorners = numCorners;
+		t.vrtWeights.clear();
+		t.vrtSupport.clear();
+		t.vrtInner.clear();
+		t.innerVrts.clear();
+		t.childCorners.clear();
+
+		const int fullSupport = (1 << numCorners) - 1;
+		int64 w[MAX_VOLUME_VERTICES];
+		int counter = 0;
+		for(VertexIterator iter = mg.begin<Vertex>(l);
+			iter != mg.end<Vertex>(l); ++iter, ++counter)
+		{
+			aaTmpIndex[*iter] = counter;
+
+			int64 x[3];
+			for(int d = 0; d < 3; ++d)
+				x[d] = (int64)(aaPos[*iter][d] * (number)n + 0.5);
+			LatticeWeights(w, roid, x, n);
+
+			int support = 0;
+			for(int i = 0; i < numCorners; ++i){
+				t.vrtWeights.push_back(w[i]);
+				if(w[i] != 0)
+					support |= 1 << i;
+			}
+			t.vrtSupport.push_back(support);
+
+			if(support == fullSupport){
+				t.vrtInner.push_back((int)t.innerVrts.size());
+				t.innerVrts.push_back(counter);
+			}
+			else
+				t.vrtInner.push_back(-1);
+		}
+
+		switch(roid){
+			case ROID_EDGE:
+				CollectTemplateChildren<Edge>(t.childCorners, mg, l, roid, aaTmpIndex);
+				break;
+			case ROID_TRIANGLE:
+			case ROID_QUADRILATERAL:
+				CollectTemplateChildren<Face>(t.childCorners, mg, l, roid, aaTmpIndex);
+				break;
+			default:
+				CollectTemplateChildren<Volume>(t.childCorners, mg, l, roid, aaTmpIndex);
+		}
+	}
+}
+
+const ImplicitUniformRefinement::Level& ImplicitUniformRefinement::
+level(int lvl) const
+{
+	UG_COND_THROW(lvl < 0 || lvl >= (int)m_levels.size(),
+				  "ImplicitUniformRefinement: Invalid level: " << lvl
+				  << " (num levels: " << num_levels() << ")");
+	return m_levels[lvl];
+}
+
+Vertex* const* ImplicitUniformRefinement::
+coarse_corners(size_t coarseElem) const
+{
+	GridObject* elem = m_coarseElems[coarseElem];
+	switch(m_dim){
+		case 1:	return static_cast<Edge*>(elem)->vertices();
+		case 2:	return static_cast<Face*>(elem)->vertices();
+		default: return static_cast<Volume*>(elem)->vertices();
+	}
+}
+
+void ImplicitUniformRefinement::
+canonical_face_corners(Vertex** cornersOut, Face* f) const
+{
+	const size_t numCorners = f->num_vertices();
+	if(numCorners == 3){
+		for(size_t i = 0; i < 3; ++i)
+			cornersOut[i] = f->vertex(i);
+		for(size_t i = 0; i < 2; ++i){
+			for(size_t j = i + 1; j < 3; ++j){
+				if(m_aaVrtIndex[cornersOut[j]] < m_aaVrtIndex[cornersOut[i]])
+					swap(cornersOut[i], cornersOut[j]);
+			}
+		}
+		return;
+	}
+
+	size_t first = 0;
+	for(size_t i = 1; i < 4; ++i){
+		if(m_aaVrtIndex[f->vertex(i)] < m_aaVrtIndex[f->vertex(first)])
+			first = i;
+	}
+
+	Vertex* next = f->vertex((first + 1) % 4);
+	Vertex* prev = f->vertex((first + 3) % 4);
+	cornersOut[0] = f->vertex(first);
+	cornersOut[2] = f->vertex((first + 2) % 4);
+	if(m_aaVrtIndex[next] < m_aaVrtIndex[prev]){
+		cornersOut[1] = next;
+		cornersOut[3] = prev;
+	}
+	else{
+		cornersOut[1] = prev;
+		cornersOut[3] = next;
+	}
+}
+
+size_t ImplicitUniformRefinement::
+global_vertex_index(const Level& lvl, size_t coarseElem,
+					const Template& t, size_t tvrt) const
+{
+	if(t.vrtInner[tvrt] >= 0)
+		return lvl.innerOffsets[coarseElem] + t.vrtInner[tvrt];
+
+	Vertex* const* corners = coarse_corners(coarseElem);
+	const int64* w = &t.vrtWeights[tvrt * t.numCorners];
+	const int support = t.vrtSupport[tvrt];
+
+	int supCorners[MAX_FACE_VERTICES];
+	int numSup = 0;
+	for(int i = 0; i < t.numCorners; ++i){
+		if(support & (1 << i)){
+			UG_ASSERT(numSup < MAX_FACE_VERTICES, "Invalid support of template vertex");
+			supCorners[numSup++] = i;
+		}
+	}
+
+	const int64 n = lvl.n;
+	switch(numSup){
+		case 1:
+			return m_aaVrtIndex[corners[supCorners[0]]];
+
+		case 2:{
+			Vertex* v0 = corners[supCorners[0]];
+			Vertex* v1 = corners[supCorners[1]];
+			Edge* e = m_pGrid->get_edge(v0, v1);
+			UG_COND_THROW(!e, "ImplicitUniformRefinement: Missing edge in coarse grid.");
+			const int64 w0 = w[supCorners[0]];
+			const int64 w1 = w[supCorners[1]];
+		//	inner edge vertices are counted starting at the corner with the lower index
+			const int64 s = (m_aaVrtIndex[v0] < m_aaVrtIndex[v1] ? w1 : w0) * n / (w0 + w1);
+			return m_coarseVrts.size() + (size_t)m_aaEdgeIndex[e] * (size_t)(n - 1)
+				   + (size_t)(s - 1);
+		}
+
+		default:{
+			FaceDescriptor fd(numSup);
+			for(int i = 0; i < numSup; ++i)
+				fd.set_vertex(i, corners[supCorners[i]]);
+			Face* f = m_pGrid->get_face(fd);
+			UG_COND_THROW(!f, "ImplicitUniformRefinement: Missing face in coarse grid.");
+
+			Vertex* fc[MAX_FACE_VERTICES];
+			canonical_face_corners(fc, f);
+			int64 fw[MAX_FACE_VERTICES];
+			int64 wSum = 0;
+			for(int i = 0; i < numSup; ++i){
+				fw[i] = w[LocalCornerIndex(corners, t.numCorners, fc[i])];
+				wSum += fw[i];
+			}
+
+			const size_t offset = lvl.faceOffsets[m_aaFaceIndex[f]];
+			if(numSup == 3)
+				return offset + InnerTriangleIndex(fw[1], fw[2], n);
+
+			const int64 u = (fw[1] + fw[2]) * n / wSum;
+			const int64 v = (fw[3] + fw[2]) * n / wSum;
+			return offset + (size_t)((u - 1) * (n - 1) + v - 1);
+		}
+	}
+}
+
+size_t ImplicitUniformRefinement::
+coarse_element_index(int lvl, size_t elem) const
+{
+	const vector<size_t>& offsets = level(lvl).elemOffsets;
+	UG_COND_THROW(elem >= offsets.back(),
+				  "ImplicitUniformRefinement: Invalid element index: " << elem);
+	return (size_t)(upper_bound(offsets.begin(), offsets.end(), elem)
+					- offsets.begin()) - 1;
+}
+
+ReferenceObjectID ImplicitUniformRefinement::
+element_type(int lvl, size_t elem) const
+{
+	return m_coarseElems[coarse_element_index(lvl, elem)]->reference_object_id();
+}
+
+size_t ImplicitUniformRefinement::
+element_vertices(size_t* vrtsOut, int lvl, size_t elem) const
+{
+	const Level& l = level(lvl);
+	const size_t coarseElem = coarse_element_index(lvl, elem);
+	const Template& t = l.templates[m_coarseElems[coarseElem]->reference_object_id()];
+	const int* childCorners = &t.childCorners[(elem - l.elemOffsets[coarseElem])
+											  * t.numCorners];
+	for(int i = 0; i < t.numCorners; ++i)
+		vrtsOut[i] = global_vertex_index(l, coarseElem, t, childCorners[i]);
+	return t.numCorners;
+}
+
+void ImplicitUniformRefinement::
+coarse_element_children(std::vector<size_t>& vrtsOut, int lvl,
+						size_t coarseElem) const
+{
+	const Level& l = level(lvl);
+	UG_COND_THROW(coarseElem >= m_coarseElems.size(),
+				  "ImplicitUniformRefinement: Invalid coarse element index: " << coarseElem);
+	const Template& t = l.templates[m_coarseElems[coarseElem]->reference_object_id()];
+
+	vector<size_t> vrtIndices(t.num_vertices());
+	for(size_t i = 0; i < vrtIndices.size(); ++i)
+		vrtIndices[i] = global_vertex_index(l, coarseElem, t, i);
+
+	vrtsOut.resize(t.childCorners.size());
+	for(size_t i = 0; i < t.childCorners.size(); ++i)
+		vrtsOut[i] = vrtIndices[t.childCorners[i]];
+}
+
+vector3 ImplicitUniformRefinement::
+vertex_position(int lvl, size_t vrt) const
+{
+	const Level& l = level(lvl);
+	const IGeometry3d& geom = *m_geom;
+	const int64 n = l.n;
+	UG_COND_THROW(vrt >= l.numVertices,
+				  "ImplicitUniformRefinement: Invalid vertex index: " << vrt);
+
+	if(vrt < m_coarseVrts.size())
+		return geom.pos(m_coarseVrts[vrt]);
+
+	vector3 p(0, 0, 0);
+	size_t ind = vrt - m_coarseVrts.size();
+
+//	inner vertex of a shared edge
+	if(ind < m_coarseEdges.size() * (size_t)(n - 1)){
+		Edge* e = m_coarseEdges[ind / (size_t)(n - 1)];
+		const int64 s = (int64)(ind % (size_t)(n - 1)) + 1;
+		Vertex* v0 = e->vertex(0);
+		Vertex* v1 = e->vertex(1);
+		if(m_aaVrtIndex[v1] < m_aaVrtIndex[v0])
+			swap(v0, v1);
+		VecScaleAdd(p, (number)(n - s) / (number)n, geom.pos(v0),
+					(number)s / (number)n, geom.pos(v1));
+		return p;
+	}
+
+//	inner vertex of a shared face
+	if(vrt < l.faceOffsets.back()){
+		const size_t fi = (size_t)(upper_bound(l.faceOffsets.begin(), l.faceOffsets.end(), vrt)
+								   - l.faceOffsets.begin()) - 1;
+		Face* f = m_coarseFaces[fi];
+		int64 local = (int64)(vrt - l.faceOffsets[fi]);
+		Vertex* fc[MAX_FACE_VERTICES];
+		canonical_face_corners(fc, f);
+
+		if(f->num_vertices() == 3){
+			int64 a = 1;
+			while(local >= n - 1 - a){
+				local -= n - 1 - a;
+				++a;
+			}
+			const int64 b = local + 1;
+			const number w[3] = {(number)(n - a - b), (number)a, (number)b};
+			for(int i = 0; i < 3; ++i)
+				VecScaleAppend(p, w[i] / (number)n, geom.pos(fc[i]));
+		}
+		else{
+			const int64 u = local / (n - 1) + 1;
+			const int64 v = local % (n - 1) + 1;
+			const number w[4] = {(number)((n - u) * (n - v)), (number)(u * (n - v)),
+								 (number)(u * v), (number)((n - u) * v)};
+			for(int i = 0; i < 4; ++i)
+				VecScaleAppend(p, w[i] / (number)(n * n), geom.pos(fc[i]));
+		}
+		return p;
+	}
+
+//	inner vertex of a coarse element
+	const size_t ei = (size_t)(upper_bound(l.innerOffsets.begin(), l.innerOffsets.end(), vrt)
+							   - l.innerOffsets.begin()) - 1;
+	const Template& t = l.templates[m_coarseElems[ei]->reference_object_id()];
+	const size_t tvrt = t.innerVrts[vrt - l.innerOffsets[ei]];
+	const int64* w = &t.vrtWeights[tvrt * t.numCorners];
+	Vertex* const* corners = coarse_corners(ei);
+	int64 wSum = 0;
+	for(int i = 0; i < t.numCorners; ++i)
+		wSum += w[i];
+	for(int i = 0; i < t.numCorners; ++i)
+		VecScaleAppend(p, (number)w[i] / (number)wSum, geom.pos(corners[i]));
+	return p;
+}
+
+size_t ImplicitUniformRefinement::
+memory_consumption() const
+{
+	size_t mem = sizeof(*this)
+			+ m_coarseVrts.capacity() * sizeof(Vertex*)
+			+ m_coarseEdges.capacity() * sizeof(Edge*)
+			+ m_coarseFaces.capacity() * sizeof(Face*)
+			+ m_coarseVols.capacity() * sizeof(Volume*)
+			+ m_coarseElems.capacity() * sizeof(GridObject*)
+			+ (m_coarseVrts.size() + m_coarseEdges.size() + m_coarseFaces.size())
+			  * sizeof(int);
+
+	for(size_t i = 0; i < m_levels.size(); ++i){
+		const Level& l = m_levels[i];
+		mem += sizeof(Level)
+			+ (l.faceOffsets.capacity() + l.innerOffsets.capacity()
+			   + l.elemOffsets.capacity()) * sizeof(size_t);
+		for(int j = 0; j < NUM_REFERENCE_OBJECTS; ++j){
+			const Template& t = l.templates[j];
+			mem += t.vrtWeights.capacity() * sizeof(int64)
+				+ (t.vrtSupport.capacity() + t.vrtInner.capacity()
+				   + t.childCorners.capacity()) * sizeof(int)
+				+ t.innerVrts.capacity() * sizeof(size_t);
+		}
+	}
+	return mem;
+}
+
+
+bool SaveImplicitLevelToVTU(const char* filename,
+							const ImplicitUniformRefinement& iur, int lvl,
+							const std::vector<number>* vrtData,
+							const char* dataName)
+{
+	const size_t numVrts = iur.num_vertices(lvl);
+	const size_t numElems = iur.num_elements(lvl);
+	UG_COND_THROW(vrtData && vrtData->size() != numVrts,
+				  "SaveImplicitLevelToVTU: " << numVrts << " values expected but "
+				  << vrtData->size() << " were given.");
+
+	ofstream out(filename);
+	if(!out){
+		UG_LOG("ERROR in SaveImplicitLevelToVTU: Couldn't open file " << filename << "\n");
+		return false;
+	}
+	out.precision(12);
+
+	out << "<?xml version=\"1.0\"?>\n"
+		<< "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">\n"
+		<< "<UnstructuredGrid>\n"
+		<< "<Piece NumberOfPoints=\"" << numVrts << "\" NumberOfCells=\"" << numElems << "\">\n";
+
+	out << "<Points>\n<DataArray type=\"Float64\" NumberOfComponents=\"3\" format=\"ascii\">\n";
+	for(size_t i = 0; i < numVrts; ++i){
+		vector3 p = iur.vertex_position(lvl, i);
+		out << p.x() << " " << p.y() << " " << p.z() << "\n";
+	}
+	out << "</DataArray>\n</Points>\n";
+
+//	the connectivity is created coarse element by coarse element
+	out << "<Cells>\n<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\">\n";
+	vector<size_t> vrts;
+	for(size_t ce = 0; ce < iur.num_coarse_elements(); ++ce){
+		iur.coarse_element_children(vrts, lvl, ce);
+		const size_t numCorners =
+				NumReferenceCorners(iur.coarse_element(ce)->reference_object_id());
+		for(size_t i = 0; i < vrts.size(); ++i)
+			out << vrts[i] << ((i + 1) % numCorners == 0 ? "\n" : " ");
+	}
+	out << "</DataArray>\n";
+
+	out << "<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\">\n";
+	size_t offset = 0;
+	for(size_t ce = 0; ce < iur.num_coarse_elements(); ++ce){
+		const size_t numCorners =
+				NumReferenceCorners(iur.coarse_element(ce)->reference_object_id());
+		const size_t numChildren = iur.first_child(lvl, ce + 1) - iur.first_child(lvl, ce);
+		for(size_t i = 0; i < numChildren; ++i){
+			offset += numCorners;
+			out << offset << "\n";
+		}
+	}
+	out << "</DataArray>\n";
+
+	out << "<DataArray type=\"UInt8\" Name=\"types\" format=\"ascii\">\n";
+	for(size_t ce = 0; ce < iur.num_coarse_elements(); ++ce){
+		int vtkType;
+		switch(iur.coarse_element(ce)->reference_object_id()){
+			case ROID_EDGE:				vtkType = 3; break;
+			case ROID_TRIANGLE:			vtkType = 5; break;
+			case ROID_QUADRILATERAL:	vtkType = 9; break;
+			case ROID_TETRAHEDRON:		vtkType = 10; break;
+			default:					vtkType = 12; break;
+		}
+		const size_t numChildren = iur.first_child(lvl, ce + 1) - iur.first_child(lvl, ce);
+		for(size_t i = 0; i < numChildren; ++i)
+			out << vtkType << "\n";
+	}
+	out << "</DataArray>\n</Cells>\n";
+
+	if(vrtData){
+		out << "<PointData>\n<DataArray type=\"Float64\" Name=\"" << dataName
+			<< "\" NumberOfComponents=\"1\" format=\"ascii\">\n";
+		for(size_t i = 0; i < numVrts; ++i)
+			out << (*vrtData)[i] << "\n";
+		out << "</DataArray>\n</PointData>\n";
+	}
+
+	out << "</Piece>\n</UnstructuredGrid>\n</VTKFile>\n";
+	return true;
+}
+
+}//	end of namespace
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2020:  G-CSC, Goethe University Frankfurt
+ * Author: Stephan Grein
+ * 
+ * This file is part of UG4.
+ * 
+ * UG4 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 3 (as published by the
+ * Free Software Foundation) with the following additional attribution
+ * requirements (according to LGPL/GPL v3 §7):
+ * 
+ * (1) The following notice must be displayed in the Appropriate Legal Notices
+ * of covered and combined works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (2) The following notice must be displayed at a prominent place in the
+ * terminal output of covered works: "Based on UG4 (www.ug4.org/license)".
+ * 
+ * (3) The following bibliography is recommended for citation and must be
+ * preserved in all covered files:
+ * "Reiter, S., Vogel, A., Heppner, I., Rupp, M., and Wittum, G. A massively
+ *   parallel geometric multigrid solver on hierarchically distributed grids.
+ *   Computing and visualization in science 16, 4 (2013), 151-164"
+ * "Vogel, A., Reiter, S., Rupp, M., Nägel, A., and Wittum, G. UG4 -- a novel
+ *   flexible software system for simulating pde based models on high performance
+ *   computers. Computing and visualization in science 16, 4 (2013), 165-179"
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ */
+
+
+#ifndef __H__UG__LIB_GRID__IMPLICIT_UNIFORM_REFINEMENT__
+#define __H__UG__LIB_GRID__IMPLICIT_UNIFORM_REFINEMENT__
+
+#include <vector>
+#include "common/types.h"
+#include "common/math/ugmath_types.h"
+#include "lib_grid/grid/grid.h"
+#include "lib_grid/grid/geometry.h"
+
+namespace ug{
+
+///	\addtogroup lib_grid_algorithms_refinement
+///	@{
+
+///	Uniform refinement levels on top of a coarse grid without explicit element objects
+/**	The elements of a uniformly refined level are not created. Instead the
+ * refinement of each reference element is computed once on a small scratch
+ * grid, using the refinement rules of GlobalMultiGridRefiner. The vertices,
+ * elements and coordinates of a level are then computed on demand from those
+ * templates and from the coarse element in which they lie. Memory use is
+ * therefore independent of the number of virtual elements.
+ *
+ * Vertices of a level are numbered globally and consistently across coarse
+ * elements: first the coarse vertices, followed by the inner vertices of all
+ * coarse edges and faces which are shared by elements, and finally the inner
+ * vertices of the coarse elements. Inner vertices of shared edges and faces are
+ * enumerated in an orientation which only depends on the indices of the coarse
+ * corners, so that neighbouring coarse elements agree on them. The vertex index thus directly provides a
+ * numbering for vertex-based (e.g. linear lagrange) unknowns. This numbering is
+ * used by AssembleDiffusionOnImplicitLevel (lib_disc) to assemble a linear
+ * system on a virtual level.
+ *
+ * Virtual elements are numbered coarse element by coarse element. Only
+ * elements of the highest dimension present in the coarse grid are considered.
+ * Supported are edges, triangles, quadrilaterals, tetrahedra and hexahedra.
+ * Coordinates are interpolated linearly (multilinearly for quadrilaterals and
+ * hexahedra), which is what GlobalMultiGridRefiner produces without a special
+ * projector.
+ *
+ * If the grid passed to init is a MultiGrid, its top level is used as the
+ * coarse grid. The coarse grid may not be changed while the instance is in use.
+ * Level 0 refers to the coarse grid itself.*/
+class ImplicitUniformRefinement
+{
+	public:
+		ImplicitUniformRefinement();
+		ImplicitUniformRefinement(SPIGeometry3d geom, int numLevels);
+		~ImplicitUniformRefinement();
+
+	///	prepares numLevels virtual levels on top of the grid of the given geometry
+		void init(SPIGeometry3d geom, int numLevels);
+
+	///	releases the templates and the attachments at the coarse grid
+		void clear();
+
+	///	number of virtual levels (the coarse level is not counted)
+		int num_levels() const					{return (int)m_levels.size() - 1;}
+
+	///	dimension of the elements
+		int dim() const							{return m_dim;}
+
+	///	the grid which contains the coarse elements
+		Grid* grid() const						{return m_pGrid;}
+
+		size_t num_vertices(int lvl) const		{return level(lvl).numVertices;}
+		size_t num_elements(int lvl) const		{return level(lvl).elemOffsets.back();}
+
+	///	number of coarse elements
+		size_t num_coarse_elements() const		{return m_coarseElems.size();}
+		GridObject* coarse_element(size_t i) const	{return m_coarseElems[i];}
+
+	///	index of the first element in the given coarse element
+	/**	coarseElem may equal num_coarse_elements(), in which case num_elements(lvl)
+	 * is returned.*/
+		size_t first_child(int lvl, size_t coarseElem) const	{return level(lvl).elemOffsets[coarseElem];}
+
+	///	index of the coarse element which contains the given element
+		size_t coarse_element_index(int lvl, size_t elem) const;
+
+	///	reference object id of the given element
+		ReferenceObjectID element_type(int lvl, size_t elem) const;
+
+	///	writes the vertex indices of the given element to vrtsOut and returns their number
+	/**	vrtsOut has to provide space for at least MAX_VOLUME_VERTICES entries.*/
+		size_t element_vertices(size_t* vrtsOut, int lvl, size_t elem) const;
+
+	///	coordinates of the given vertex
+		vector3 vertex_position(int lvl, size_t vrt) const;
+
+	///	vertex indices of all elements in the given coarse element
+	/**	Children are stored one after another, each with as many entries as
+	 * the coarse element has corners. Computing the indices for a whole coarse
+	 * element is considerably faster than calling element_vertices for each
+	 * of its children.*/
+		void coarse_element_children(std::vector<size_t>& vrtsOut,
+									 int lvl, size_t coarseElem) const;
+
+	///	approximate number of bytes used by this instance
+		size_t memory_consumption() const;
+
+	private:
+	///	refinement of a reference element on a given level
+		struct Template{
+			ReferenceObjectID		roid;
+			int						numCorners;
+		//	per template vertex: numCorners integer interpolation weights
+			std::vector<int64>		vrtWeights;
+		//	per template vertex: bitmask of the corners with nonzero weight
+			std::vector<int>		vrtSupport;
+		//	per template vertex: index among the inner vertices or -1
+			std::vector<int>		vrtInner;
+		//	template vertex for each inner vertex
+			std::vector<size_t>		innerVrts;
+		//	corner indices of the children, numCorners per child
+			std::vector<int>		childCorners;
+
+			size_t num_vertices() const	{return vrtSupport.size();}
+			size_t num_children() const	{return numCorners > 0 ? childCorners.size() / numCorners : 0;}
+		};
+
+		struct Level{
+			int64					n;
+			Template				templates[NUM_REFERENCE_OBJECTS];
+		//	first index of the inner vertices of each shared coarse face and of each coarse element
+			std::vector<size_t>		faceOffsets;
+			std::vector<size_t>		innerOffsets;
+		//	first virtual element of each coarse element
+			std::vector<size_t>		elemOffsets;
+			size_t					numVertices;
+		};
+
+		const Level& level(int lvl) const;
+
+		void create_templates(ReferenceObjectID roid, int numLevels);
+
+		size_t global_vertex_index(const Level& lvl, size_t coarseElem,
+								   const Template& t, size_t tvrt) const;
+
+		Vertex* const* coarse_corners(size_t coarseElem) const;
+
+	///	corners of a shared coarse face in the orientation used for its inner vertices
+	/**	For triangles the corners are sorted by their index. For quadrilaterals
+	 * the first corner has the lowest index and the second corner is the
+	 * neighbour of the first one with the lower index.*/
+		void canonical_face_corners(Vertex** cornersOut, Face* f) const;
+
+
+	private:
+		SPIGeometry3d				m_geom;
+		Grid*						m_pGrid;
+		int							m_dim;
+		std::vector<Level>			m_levels;
+
+		std::vector<Vertex*>		m_coarseVrts;
+		std::vector<Edge*>			m_coarseEdges;
+		std::vector<Face*>			m_coarseFaces;
+		std::vector<Volume*>		m_coarseVols;
+		std::vector<GridObject*>	m_coarseElems;
+
+		AInt						m_aIndex;
+		Grid::VertexAttachmentAccessor<AInt>	m_aaVrtIndex;
+		Grid::EdgeAttachmentAccessor<AInt>		m_aaEdgeIndex;
+		Grid::FaceAttachmentAccessor<AInt>		m_aaFaceIndex;
+		Grid::VolumeAttachmentAccessor<AInt>	m_aaVolIndex;
+};
+
+
+///	writes a virtual level of an ImplicitUniformRefinement to a vtu file
+/**	If vrtData is specified, it has to contain one value per vertex of the level.
+ * It is written as point data with the given name.*/
+bool SaveImplicitLevelToVTU(const char* filename,
+							const ImplicitUniformRefinement& iur, int lvl,
+							const std::vector<number>* vrtData = NULL,
+							const char* dataName = "data");
+
+/// @}
+
+}//	end of namespace
+
+#endif
@@ -190,6 +190,10 @@ bool IRefiner::coarsen()
 //	now perform coarsening
 	bool retVal = perform_coarsening();
 
+//	release the memory of removed elements before listeners rebuild their data
+	if(retVal && m_compactAfterCoarsening && grid())
+		grid()->compact_memory();
+
 //	post a message that coarsening has been finished
 //	if(adaptivity_supported())
 //		m_messageHub->post_message(GridMessage_Adaption(GMAT_HNODE_COARSENING_ENDS));
@@ -68,7 +68,8 @@ class IRefiner
 	public:
 		IRefiner(SPRefinementProjector projector = SPNULL) :
 			m_msgIdAdaption(-1), m_projector(projector),
-			m_adaptionIsActive(false), m_debuggingEnabled(false)	{}
+			m_adaptionIsActive(false), m_debuggingEnabled(false),
+			m_compactAfterCoarsening(false)	{}
 
 		virtual ~IRefiner()	{}
 
@@ -244,6 +245,17 @@ class IRefiner
 	 */
 		bool coarsen();
 
+	///	enables compaction of the grid's memory after elements have been coarsened
+	/**	If enabled, coarsen calls Grid::compact_memory after elements have
+	 * been removed and before the end of the adaption is announced. Memory
+	 * of removed elements is thus returned and attached data is stored
+	 * compactly, before e.g. DoF distributions and grid functions are rebuilt.
+	 * Disabled by default.
+	 * \{ */
+		void enable_compaction_after_coarsening(bool enable)	{m_compactAfterCoarsening = enable;}
+		bool compaction_after_coarsening_enabled() const		{return m_compactAfterCoarsening;}
+	/** \} */
+
 
 	///	returns the number of (globally) marked edges on all levels of the hierarchy
 		size_t num_marked_edges(std::vector<int>& numMarkedEdgesOut);
@@ -302,6 +314,7 @@ class IRefiner
 		SPRefinementProjector	m_projector;
 		bool					m_adaptionIsActive;
 		bool					m_debuggingEnabled;
+		bool					m_compactAfterCoarsening;
 		std::string				m_adjustedMarksDebugFilename;
 };
 
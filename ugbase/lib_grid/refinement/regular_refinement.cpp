@@ -115,6 +115,9 @@ bool Refine(Grid& grid, Selector& sel, AInt& aInt,
 		defaultProjector.set_geometry(make_sp(new Geometry<3, 3>(grid, aPosition)));
 		projector = &defaultProjector;
 	}
+
+//	new elements are allocated from the pools of the grid
+	GridObjectPoolScope poolScope(grid.object_pools());
 		
 //	make sure that GRIDOPT_VERTEXCENTRIC_INTERCONNECTION is enabled
 	if(grid.num_edges() && (!grid.option_is_enabled(VRTOPT_STORE_ASSOCIATED_EDGES))){
@@ -205,7 +205,9 @@ class attachment_traits<Volume*, ISubsetHandler>
  * In those methods
  * Derived classes have to store the objects that are selected for
  * a subset in a ISubsetHandler::SectionContainer. Note that multiple
- * SectionContainers per subset may be used.
+ * SectionContainers per subset may be used. An element which is assigned
+ * to a subset has to be appended to the end of the list of that subset,
+ * even if it was already contained in the subset (see reorder_elements).
  *
  * A SubsetHandler also supports subset-attachments.
  * That means that you can attach data to the elements of a subset.
@@ -444,6 +446,18 @@ class UG_API ISubsetHandler : public GridObserver
 	 * (e.g. Vertex, Edge, Face, Volume).*/
 		virtual void assign_subset(GridObject* elem, int subsetIndex);
 
+	///	changes the order in which the given elements are iterated in their subsets
+	/**	Each element is moved to the end of the list of its subset, so that
+	 * elements of the same type and subset are afterwards iterated in the order
+	 * in which they appear in elems. Elements which are not assigned to a
+	 * subset are ignored.
+	 *
+	 * This relies on assign_subset, which in derived classes always appends
+	 * the element to the list of the given subset, even if it was already
+	 * assigned to that subset before.*/
+		template <class TElem>
+		void reorder_elements(const std::vector<TElem*>& elems);
+
 	///	collects all vertices that are in the given subset.
 	/**	Please note: This method should only be used, if the begin and end methods
 	 *	of derived classes are not available.*/
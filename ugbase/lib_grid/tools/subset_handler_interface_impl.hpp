@@ -103,6 +103,17 @@ get_subset_index(Volume* elem) const
 	return -1;
 }
 
+template <class TElem>
+void ISubsetHandler::
+reorder_elements(const std::vector<TElem*>& elems)
+{
+	for(size_t i = 0; i < elems.size(); ++i){
+		int si = get_subset_index(elems[i]);
+		if(si != -1)
+			assign_subset(elems[i], si);
+	}
+}
+
 inline void ISubsetHandler::
 subset_assigned(Vertex* v, int subsetIndex)
 {
@@ -466,6 +466,28 @@ alltoall(const void* sendBuf, int sendCount, DataType sendType,
 	MPI_Alltoall(const_cast<void*>(sendBuf), sendCount, sendType, recBuf, recCount, recType, m_comm->m_mpiComm);
 }
 
+void
+ProcessCommunicator::
+alltoallv(const void* sendBuf, const int* sendCounts, const int* sendDispls,
+		  DataType sendType, void* recBuf, const int* recCounts,
+		  const int* recDispls, DataType recType) const
+{
+	PCL_PROFILE(pcl_ProcCom_alltoallv);
+	if(is_local()){
+		memcpy((byte*)recBuf + recDispls[0] * GetSize(recType),
+			   (const byte*)sendBuf + sendDispls[0] * GetSize(sendType),
+			   recCounts[0] * GetSize(recType));
+		return;
+	}
+
+	UG_COND_THROW(empty(), "ERROR in ProcessCommunicator::alltoallv: empty communicator.");
+
+	MPI_Alltoallv(const_cast<void*>(sendBuf), const_cast<int*>(sendCounts),
+				  const_cast<int*>(sendDispls), sendType, recBuf,
+				  const_cast<int*>(recCounts), const_cast<int*>(recDispls),
+				  recType, m_comm->m_mpiComm);
+}
+
 void
 ProcessCommunicator::
 send_data(void* pBuffer, int bufferSize, int destProc, int tag) const
@@ -229,6 +229,22 @@ class ProcessCommunicator
 		void alltoall(const void* sendBuf, int sendCount, DataType sendType,
 		    		  void* recBuf, int recCount, DataType recType);
 
+	///	performs MPI_Alltoallv on the processes of the communicator.
+	/** All processes send variable amounts of data to all processes.
+	 *  The receive buffer needs to have the appropriate size.
+	 * \param sendBuf     starting address of send buffer (choice)
+	 * \param sendCounts  integer array (of length group size) specifying the number of elements to send to each process
+	 * \param sendDispls  integer array (of length group size). Entry i specifies the displacement (relative to sendBuf) from which to take the outgoing data destined for process i
+	 * \param sendType    data type of send buffer elements (handle)
+	 * \param recBuf      starting address of receive buffer (choice)
+	 * \param recCounts   integer array (of length group size) specifying the number of elements that are received from each process
+	 * \param recDispls   integer array (of length group size). Entry i specifies the displacement (relative to recBuf) at which to place the incoming data from process i
+	 * \param recType     data type of receive buffer elements (handle) */
+		void alltoallv(const void* sendBuf, const int* sendCounts,
+					   const int* sendDispls, DataType sendType,
+					   void* recBuf, const int* recCounts,
+					   const int* recDispls, DataType recType) const;
+
 	///	gathers variable arrays on all processes.
 	/**	The arrays specified in sendBuf will be copied to all processes
 	 * in the ProcessCommunicator. The order of the arrays in recBufOut